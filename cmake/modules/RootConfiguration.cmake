@@ -430,6 +430,11 @@ if(lzma)
 else()
   set(haslzmacompression undef)
 endif()
+if(lz4)
+  set(haslz4 define)
+else()
+  set(haslz4 undef)
+endif()
 if(cocoa)
   set(hascocoa define)
 else()
@@ -120,6 +120,42 @@ if(builtin_lzma)
 endif()
 
 
+#---Check for LZ4--------------------------------------------------------------------
+if(lz4 AND NOT builtin_lz4)
+  message(STATUS "Looking for LZ4")
+  find_package(LZ4)
+  if(NOT LZ4_FOUND)
+    if(fail-on-missing)
+      message(FATAL_ERROR "LZ4 library not found and 'lz4' option is enabled ('fail-on-missing' enabled). "
+                          "Alternatively, you can enable the option 'builtin_lz4' to build the LZ4 library internally.")
+    else()
+      message(STATUS "LZ4 not found. Set variable LZ4_DIR to point to your LZ4 installation")
+      message(STATUS "               Alternatively, you can also enable the option 'builtin_lz4' to build the LZ4 library internally")
+      message(STATUS "               For the time being switching OFF 'lz4' option")
+      set(lz4 OFF CACHE BOOL "" FORCE)
+    endif()
+  endif()
+endif()
+if(builtin_lz4)
+  set(lz4_version r131)
+  message(STATUS "Downloading and building LZ4 version ${lz4_version}")
+  ExternalProject_Add(
+    LZ4
+    # https://github.com/Cyan4973/lz4/archive/${lz4_version}.tar.gz
+    URL ${repository_tarfiles}/lz4-${lz4_version}.tar.gz
+    INSTALL_DIR ${CMAKE_BINARY_DIR}
+    CONFIGURE_COMMAND ""
+    BUILD_COMMAND make -C lib CFLAGS=-fPIC
+    INSTALL_COMMAND ${CMAKE_COMMAND} -E copy lib/liblz4.a <INSTALL_DIR>/lib/
+            COMMAND ${CMAKE_COMMAND} -E copy lib/lz4.h <INSTALL_DIR>/include/
+            COMMAND ${CMAKE_COMMAND} -E copy lib/lz4hc.h <INSTALL_DIR>/include/
+    BUILD_IN_SOURCE 1)
+  set(LZ4_INCLUDE_DIR ${CMAKE_BINARY_DIR}/include)
+  set(LZ4_LIBRARIES ${CMAKE_BINARY_DIR}/lib/${CMAKE_STATIC_LIBRARY_PREFIX}lz4${CMAKE_STATIC_LIBRARY_SUFFIX})
+  set(lz4 ON CACHE BOOL "" FORCE)
+endif()
+
+
 #---Check for X11 which is mandatory lib on Unix--------------------------------------
 if(x11)
   message(STATUS "Looking for X11")
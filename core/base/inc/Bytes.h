@@ -587,4 +587,42 @@ inline Long64_t  net2host(Long64_t x)  { return host2net(x); }
 inline Float_t   net2host(Float_t x)   { return host2net(x); }
 inline Double_t  net2host(Double_t x)  { return host2net(x); }
 
+//______________________________________________________________________________
+// In place conversion of the n values of an array from network to host
+// byte order (the conversion is its own inverse). The loops are written
+// with plain shifts so that the compiler can vectorize them.
+#ifdef R__BYTESWAP
+inline void net2host(UShort_t *x, Long64_t n)
+{
+   for (Long64_t i = 0; i < n; ++i) {
+      UShort_t v = x[i];
+      x[i] = (UShort_t)(((v & 0x00ffU) << 8) | ((v & 0xff00U) >> 8));
+   }
+}
+
+inline void net2host(UInt_t *x, Long64_t n)
+{
+   for (Long64_t i = 0; i < n; ++i) {
+      UInt_t v = x[i];
+      x[i] = ((v & 0x000000ffU) << 24) | ((v & 0x0000ff00U) <<  8) |
+             ((v & 0x00ff0000U) >>  8) | ((v & 0xff000000U) >> 24);
+   }
+}
+
+inline void net2host(ULong64_t *x, Long64_t n)
+{
+   for (Long64_t i = 0; i < n; ++i) {
+      ULong64_t v = x[i];
+      x[i] = ((v & 0x00000000000000ffULL) << 56) | ((v & 0x000000000000ff00ULL) << 40) |
+             ((v & 0x0000000000ff0000ULL) << 24) | ((v & 0x00000000ff000000ULL) <<  8) |
+             ((v & 0x000000ff00000000ULL) >>  8) | ((v & 0x0000ff0000000000ULL) >> 24) |
+             ((v & 0x00ff000000000000ULL) >> 40) | ((v & 0xff00000000000000ULL) >> 56);
+   }
+}
+#else  /* R__BYTESWAP */
+inline void net2host(UShort_t *, Long64_t)  { }
+inline void net2host(UInt_t *, Long64_t)    { }
+inline void net2host(ULong64_t *, Long64_t) { }
+#endif
+
 #endif
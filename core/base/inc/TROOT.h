@@ -326,6 +326,7 @@ public:
 namespace ROOT {
    TROOT *GetROOT();
    R__EXTERN TROOT *gROOTLocal;
+   void EnableThreadSafety();
 }
 #define gROOT (ROOT::GetROOT())
 
@@ -63,8 +63,17 @@ public:
 
    virtual void FileReadEvent(TFile *file, Int_t len, Double_t start) = 0;
 
+   virtual void FileReadVectorEvent(TFile * /*file*/, Int_t /*nrequests*/, Long64_t /*len*/,
+                                    Double_t /*realtime*/, Double_t /*queuetime*/, Int_t /*maxdepth*/) {}
+
    virtual void UnzipEvent(TObject *tree, Long64_t pos, Double_t start, Int_t complen, Int_t objlen) = 0;
 
+   virtual void UnzipClusterEvent(TObject * /*tree*/, Long64_t /*entry*/, Int_t /*nbaskets*/,
+                                  Double_t /*latency*/, Double_t /*unziptime*/) {}
+
+   virtual void BasketSkipEvent(TObject * /*tree*/, Long64_t /*entry*/, Long64_t /*nentries*/,
+                                Int_t /*nbaskets*/, Long64_t /*bytes*/) {}
+
    virtual void RateEvent(Double_t proctime, Double_t deltatime,
                           Long64_t eventsprocessed, Long64_t bytesRead) = 0;
 
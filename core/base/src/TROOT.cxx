@@ -373,6 +373,33 @@ namespace ROOT {
 
 TROOT *ROOT::gROOTLocal = ROOT::GetROOT();
 
+////////////////////////////////////////////////////////////////////////////////
+/// Enable the thread safety of ROOT: this loads libThread and installs the
+/// global mutexes (gROOTMutex, gInterpreterMutex, ...) and makes gDirectory,
+/// gFile and gPerfStats local to each thread, including the threads not
+/// created through TThread (std::thread, TTaskPool workers).
+/// It must be called before starting threads using ROOT.
+/// Once enabled, reading independent files in independent threads (each
+/// thread with its own TFile and TTree) does not require any other lock.
+
+void ROOT::EnableThreadSafety()
+{
+   typedef void (*InitFunc_t)();
+   static InitFunc_t initFunc = 0;
+   if (!initFunc) {
+      if (gSystem->Load("libThread") < 0) {
+         ::Error("ROOT::EnableThreadSafety", "Can not load libThread");
+         return;
+      }
+      initFunc = (InitFunc_t)gSystem->DynFindSymbol("libThread", "ROOT_TThread_Initialize");
+      if (!initFunc) {
+         ::Error("ROOT::EnableThreadSafety", "Can not find the initialization function of libThread");
+         return;
+      }
+   }
+   initFunc();
+}
+
 // Global debug flag (set to > 0 to get debug output).
 // Can be set either via the interpreter (gDebug is exported to CINT),
 // via the rootrc resource "Root.Debug", via the shell environment variable
@@ -0,0 +1,82 @@
+// @(#)root/lz4:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2015, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#include "ZipLZ4.h"
+#include "lz4.h"
+#include "lz4hc.h"
+#include <stdio.h>
+
+static const int kHeaderSize = 9;
+
+/* Compression levels up to this value use the fast LZ4 compressor,
+   higher levels use the LZ4-HC (high compression) variant. */
+static const int kMaxFastLevel = 3;
+
+void R__zipLZ4(int cxlevel, int *srcsize, char *src, int *tgtsize, char *tgt, int *irep)
+{
+   int out_size;                  /* compressed size */
+   unsigned in_size   = (unsigned) (*srcsize);
+   int out_capacity   = *tgtsize - kHeaderSize;
+
+   *irep = 0;
+
+   if (out_capacity <= 0) {
+      return;
+   }
+
+   if (*srcsize > 0xffffff || *srcsize < 0) {
+      return;
+   }
+
+   if (cxlevel > 9) cxlevel = 9;
+   if (cxlevel <= kMaxFastLevel) {
+      out_size = LZ4_compress_default(src, &tgt[kHeaderSize], *srcsize, out_capacity);
+   } else {
+      out_size = LZ4_compress_HC(src, &tgt[kHeaderSize], *srcsize, out_capacity, cxlevel);
+   }
+   if (out_size <= 0) {
+      /* No need to print an error message. We simply abandon the compression
+         the buffer cannot be compressed or compressed buffer would be larger than original buffer
+      */
+      return;
+   }
+
+   tgt[0] = 'L';  /* Signature of LZ4 */
+   tgt[1] = '4';
+   tgt[2] = (char)LZ4_VERSION_MAJOR;
+
+   tgt[3] = (char)(out_size & 0xff);
+   tgt[4] = (char)((out_size >> 8) & 0xff);
+   tgt[5] = (char)((out_size >> 16) & 0xff);
+
+   tgt[6] = (char)(in_size & 0xff);         /* decompressed size */
+   tgt[7] = (char)((in_size >> 8) & 0xff);
+   tgt[8] = (char)((in_size >> 16) & 0xff);
+
+   *irep = out_size + kHeaderSize;
+}
+
+void R__unzipLZ4(int *srcsize, unsigned char *src, int *tgtsize, unsigned char *tgt, int *irep)
+{
+   int out_size;
+
+   *irep = 0;
+
+   out_size = LZ4_decompress_safe((const char *)(&src[kHeaderSize]), (char *)tgt,
+                                  *srcsize - kHeaderSize, *tgtsize);
+   if (out_size < 0) {
+      fprintf(stderr,
+              "R__unzipLZ4: error %d in LZ4_decompress_safe\n",
+              out_size);
+      return;
+   }
+
+   *irep = out_size;
+}
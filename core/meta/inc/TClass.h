@@ -223,6 +223,7 @@ private:
    Int_t               fSizeof;         //Sizeof the class.
 
            Int_t      fCanSplit;          //!Indicates whether this class can be split or not.
+           Int_t      fStreamerActionsMode; //!Optimization of the streamer action sequences, -1 for the default.
    mutable std::atomic<Long_t> fProperty; //!Property
    mutable Long_t     fClassProperty;     //!C++ Property of the class (is abstract, has virtual table, etc.)
 
@@ -441,6 +442,7 @@ public:
    ShowMembersFunc_t  GetShowMembersWrapper() const { return fShowMembers; }
    EState             GetState() const { return fState; }
    TClassStreamer    *GetStreamer() const;
+   Int_t              GetStreamerActionsMode() const;
    ClassStreamerFunc_t GetStreamerFunc() const;
    ClassConvStreamerFunc_t GetConvStreamerFunc() const;
    const TObjArray          *GetStreamerInfos() const { return fStreamerInfo; }
@@ -506,6 +508,7 @@ public:
    void               AdoptStreamer(TClassStreamer *strm);
    void               AdoptMemberStreamer(const char *name, TMemberStreamer *strm);
    void               SetMemberStreamer(const char *name, MemberStreamerFunc_t strm);
+   void               SetStreamerActionsMode(Int_t mode);
    void               SetStreamerFunc(ClassStreamerFunc_t strm);
    void               SetConvStreamerFunc(ClassConvStreamerFunc_t strm);
 
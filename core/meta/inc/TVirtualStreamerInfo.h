@@ -49,6 +49,7 @@ protected:
    static  Bool_t    fgCanDelete;        //True if ReadBuffer can delete object
    static  Bool_t    fgOptimize;         //True if optimization on
    static  Bool_t    fgStreamMemberWise; //True if the collections are to be stream "member-wise" (when possible).
+   static  std::atomic<Int_t> fgActionsMode; //Default optimization of the action sequences, see SetDefaultActionsMode
    static TVirtualStreamerInfo  *fgInfoFactory;
 
    TVirtualStreamerInfo(const TVirtualStreamerInfo& info);
@@ -75,6 +76,14 @@ public:
           kBuildRunning          = BIT(18)
    };
 
+   // Optimization of the action sequences used by TBufferFile to stream
+   // the objects of a class, see TClass::SetStreamerActionsMode.
+   enum EActionsMode {
+      kStandardActions = 0,  // One action per member
+      kBulkActions     = 1,  // One action per run of consecutive members of basic type
+      kCompiledActions = 2   // One function compiled by the interpreter for the whole sequence
+   };
+
    enum EReadWrite {
       kBase        =  0,  kOffsetL = 20,  kOffsetP = 40,  kCounter =  6,  kCharStar = 7,
       kChar        =  1,  kShort   =  2,  kInt     =  3,  kLong    =  4,  kFloat    = 5,
@@ -161,6 +170,7 @@ public:
    virtual void        SetCheckSum(UInt_t checksum) = 0;
    virtual void        SetClass(TClass *cl) = 0;
    virtual void        SetClassVersion(Int_t vers) = 0;
+   virtual void        SetActionsMode(Int_t mode);
    static  Bool_t      SetStreamMemberWise(Bool_t enable = kTRUE);
    virtual void        TagFile(TFile *fFile) = 0;
    virtual void        Update(const TClass *oldClass, TClass *newClass) = 0;
@@ -169,10 +179,12 @@ public:
    static TStreamerBasicType *GetElementCounter(const char *countName, TClass *cl);
 
    static Bool_t       CanOptimize();
+   static Int_t        GetDefaultActionsMode();
    static Bool_t       GetStreamMemberWise();
    static void         Optimize(Bool_t opt=kTRUE);
    static Bool_t       CanDelete();
    static void         SetCanDelete(Bool_t opt=kTRUE);
+   static void         SetDefaultActionsMode(Int_t mode);
    static void         SetFactory(TVirtualStreamerInfo *factory);
 
    virtual TVirtualCollectionProxy *GenEmulatedProxy(const char* class_name, Bool_t silent) = 0;
@@ -21,6 +21,7 @@ Abstract Interface class describing Streamer information for one class.
 #include "TPluginManager.h"
 #include "TStreamerElement.h"
 #include "TError.h"
+#include "TEnv.h"
 
 
 TVirtualStreamerInfo *TVirtualStreamerInfo::fgInfoFactory    = 0;
@@ -28,6 +29,7 @@ TVirtualStreamerInfo *TVirtualStreamerInfo::fgInfoFactory    = 0;
 Bool_t  TVirtualStreamerInfo::fgCanDelete        = kTRUE;
 Bool_t  TVirtualStreamerInfo::fgOptimize         = kTRUE;
 Bool_t  TVirtualStreamerInfo::fgStreamMemberWise = kTRUE;
+std::atomic<Int_t> TVirtualStreamerInfo::fgActionsMode(-1);
 
 ClassImp(TVirtualStreamerInfo)
 
@@ -88,6 +90,18 @@ Bool_t TVirtualStreamerInfo::CanOptimize()
    return fgOptimize;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Static function returning the optimization of the action sequences of
+/// the classes for which TClass::SetStreamerActionsMode was not called.
+/// The default is given by the resource TStreamerInfo.ActionsMode (0, i.e.
+/// kStandardActions, by default).
+
+Int_t TVirtualStreamerInfo::GetDefaultActionsMode()
+{
+   if (fgActionsMode < 0) fgActionsMode = gEnv->GetValue("TStreamerInfo.ActionsMode", 0);
+   return fgActionsMode;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Given a comment/title declaring an array counter, for example:
 /// ~~~ {.cpp}
@@ -221,6 +235,26 @@ void TVirtualStreamerInfo::SetCanDelete(Bool_t opt)
    fgCanDelete = opt;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Optimize the action sequences of this StreamerInfo as requested by mode
+/// (see EActionsMode). The default implementation keeps the sequences as
+/// they are, which is always correct.
+
+void TVirtualStreamerInfo::SetActionsMode(Int_t /* mode */)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Static function setting the optimization of the action sequences of the
+/// classes for which TClass::SetStreamerActionsMode was not called (see
+/// EActionsMode). It applies to the StreamerInfos compiled afterwards.
+
+void TVirtualStreamerInfo::SetDefaultActionsMode(Int_t mode)
+{
+   if (mode < kStandardActions || mode > kCompiledActions) mode = kStandardActions;
+   fgActionsMode = mode;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ///static function: Set the StreamerInfo factory
 
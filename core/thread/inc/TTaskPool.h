@@ -0,0 +1,105 @@
+// @(#)root/thread:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2015, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TTaskPool
+#define ROOT_TTaskPool
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TTaskPool                                                            //
+//                                                                      //
+// Work-stealing pool of worker threads executing short tasks.          //
+// Each worker owns a double ended queue: tasks submitted from a worker //
+// are pushed on its own queue and popped in LIFO order, idle workers   //
+// steal from the other end of the queues of the busy ones.             //
+//                                                                      //
+// TTaskGroup                                                           //
+//                                                                      //
+// Set of tasks submitted to a TTaskPool that can be waited for. The    //
+// waiting thread takes part in the execution of the pending tasks.     //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef ROOT_Rtypes
+#include "Rtypes.h"
+#endif
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+class TTaskPool {
+
+public:
+   typedef std::function<void()> Task_t;
+
+private:
+   struct TWorkQueue {
+      std::mutex         fMutex;   // Protects fTasks
+      std::deque<Task_t> fTasks;   // Owner works at the back, thieves at the front
+   };
+
+   std::vector<TWorkQueue*>  fQueues;     // One queue per worker
+   std::vector<std::thread>  fWorkers;    // Worker threads
+   std::atomic<Long64_t>     fNPending;   // Number of queued tasks not yet started
+   std::atomic<UInt_t>       fNextQueue;  // Round robin index for tasks pushed from outside the pool
+   std::mutex                fSleepMutex; // Used by idle workers to sleep on fSleepCond
+   std::condition_variable   fSleepCond;  // Signalled when tasks are queued or at shutdown
+   Bool_t                    fStop;       // Set (under fSleepMutex) to terminate the workers
+
+   static UInt_t             fgDefaultSize; // Number of workers of the default pool (0: number of cores)
+
+   TTaskPool(const TTaskPool &);             // not implemented
+   TTaskPool &operator=(const TTaskPool &);  // not implemented
+
+   Bool_t Pop(UInt_t idx, Task_t &task);
+   Bool_t Steal(UInt_t idx, Task_t &task);
+   void   WorkerLoop(UInt_t idx);
+
+public:
+   explicit TTaskPool(UInt_t nworkers = 0);
+   ~TTaskPool();
+
+   UInt_t GetPoolSize() const { return fWorkers.size(); }
+   void   Push(const Task_t &task);
+   Bool_t RunOne();
+
+   static TTaskPool &GetDefault();
+   static UInt_t     GetDefaultSize();
+   static void       SetDefaultSize(UInt_t nworkers);
+};
+
+
+class TTaskGroup {
+
+private:
+   TTaskPool               &fPool;     // Pool executing the tasks
+   std::atomic<Int_t>       fNTasks;   // Number of submitted tasks not yet completed
+   std::mutex               fMutex;    // Protects the completion notification
+   std::condition_variable  fDone;     // Signalled when fNTasks drops to 0
+
+   TTaskGroup(const TTaskGroup &);             // not implemented
+   TTaskGroup &operator=(const TTaskGroup &);  // not implemented
+
+public:
+   explicit TTaskGroup(TTaskPool &pool = TTaskPool::GetDefault());
+   ~TTaskGroup();
+
+   Int_t  GetNPending() const { return fNTasks; }
+   void   Run(const TTaskPool::Task_t &task);
+   void   Wait();
+};
+
+#endif
@@ -97,7 +97,6 @@ private:
    VoidFunc_t     fFcnVoid;               // void  start function of thread
    void          *fThreadArg;             // thread start function arguments
    void          *fClean;                 // support of cleanup structure
-   void          *fTsd[ROOT::kMaxThreadSlot]; // thread specific data container
    char           fComment[100];          // thread specific state comment
 
    static TThreadImp      *fgThreadImp;   // static pointer to thread implementation
@@ -119,6 +118,7 @@ private:
    void           ErrorHandler(int level, const char *location, const char *fmt, va_list ap) const;
    static void    Init();
    static void   *Function(void *ptr);
+   static void  **GetTls(Int_t k);
    static Int_t   XARequest(const char *xact, Int_t nb, void **ar, Int_t *iret);
    static void    AfterCancel(TThread *th);
 
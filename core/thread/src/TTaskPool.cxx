@@ -0,0 +1,262 @@
+// @(#)root/thread:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2015, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+/** \class TTaskPool
+
+Work-stealing pool of worker threads.
+
+The pool starts a fixed number of workers (by default one per core).
+Every worker owns a queue of tasks: tasks pushed by a worker (for
+example a task creating sub-tasks) go at the back of its own queue
+and are executed in LIFO order, which keeps the data they use hot in
+the cache of that core. Tasks pushed by threads that do not belong
+to the pool are distributed round robin over the workers' queues.
+A worker whose queue is empty steals the oldest task from the queue
+of another worker; only when there is nothing left to steal it goes
+to sleep until new tasks are pushed.
+
+The pool used by the ROOT libraries is returned by
+TTaskPool::GetDefault(). Its size can be changed with
+TTaskPool::SetDefaultSize() before it is used for the first time.
+
+~~~{.cpp}
+   TTaskGroup group;                    // uses TTaskPool::GetDefault()
+   for (Int_t i = 0; i < n; ++i)
+      group.Run([i, &out, &in]() { out[i] = Process(in[i]); });
+   group.Wait();                        // helps running the tasks
+~~~
+
+\class TTaskGroup
+
+Set of tasks, submitted to a TTaskPool, whose completion can be waited for.
+TTaskGroup::Wait() does not simply block: the calling thread executes
+pending tasks of the pool until all the tasks of the group are done,
+so that waiting from within a task, or from a pool of size 1, can not
+dead-lock. The destructor waits for the completion of the group.
+*/
+
+#include "TTaskPool.h"
+#include "ThreadLocalStorage.h"
+
+#include <chrono>
+
+UInt_t TTaskPool::fgDefaultSize = 0;
+
+namespace {
+   // Pool to which the current thread belongs as a worker (if any) and
+   // the index of its queue.
+   TTHREAD_TLS(TTaskPool*) gCurrentPool = 0;
+   TTHREAD_TLS(UInt_t)     gCurrentQueue = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Start a pool of nworkers threads. If nworkers is 0 the number of
+/// hardware threads of the machine is used.
+
+TTaskPool::TTaskPool(UInt_t nworkers) : fNPending(0), fNextQueue(0), fStop(kFALSE)
+{
+   if (nworkers == 0) nworkers = std::thread::hardware_concurrency();
+   if (nworkers == 0) nworkers = 1;
+
+   fQueues.reserve(nworkers);
+   for (UInt_t i = 0; i < nworkers; ++i)
+      fQueues.push_back(new TWorkQueue);
+   fWorkers.reserve(nworkers);
+   for (UInt_t i = 0; i < nworkers; ++i)
+      fWorkers.push_back(std::thread(&TTaskPool::WorkerLoop, this, i));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Run the tasks still queued and join the workers.
+
+TTaskPool::~TTaskPool()
+{
+   {
+      std::lock_guard<std::mutex> lock(fSleepMutex);
+      fStop = kTRUE;
+   }
+   fSleepCond.notify_all();
+   for (UInt_t i = 0; i < fWorkers.size(); ++i)
+      fWorkers[i].join();
+   for (UInt_t i = 0; i < fQueues.size(); ++i)
+      delete fQueues[i];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Take the most recently queued task of queue idx.
+
+Bool_t TTaskPool::Pop(UInt_t idx, Task_t &task)
+{
+   TWorkQueue &q = *fQueues[idx];
+   std::lock_guard<std::mutex> lock(q.fMutex);
+   if (q.fTasks.empty()) return kFALSE;
+   task = std::move(q.fTasks.back());
+   q.fTasks.pop_back();
+   --fNPending;
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Take the oldest task of any queue but idx (idx may be out of range
+/// to look at all the queues).
+
+Bool_t TTaskPool::Steal(UInt_t idx, Task_t &task)
+{
+   const UInt_t n = fQueues.size();
+   for (UInt_t i = 1; i <= n; ++i) {
+      UInt_t victim = (idx + i) % n;
+      if (victim == idx) continue;
+      TWorkQueue &q = *fQueues[victim];
+      std::unique_lock<std::mutex> lock(q.fMutex, std::try_to_lock);
+      if (!lock.owns_lock() || q.fTasks.empty()) continue;
+      task = std::move(q.fTasks.front());
+      q.fTasks.pop_front();
+      --fNPending;
+      return kTRUE;
+   }
+   return kFALSE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Main loop of the worker owning queue idx.
+
+void TTaskPool::WorkerLoop(UInt_t idx)
+{
+   gCurrentPool = this;
+   gCurrentQueue = idx;
+
+   Task_t task;
+   while (1) {
+      if (Pop(idx, task) || Steal(idx, task)) {
+         task();
+         task = Task_t();
+         continue;
+      }
+      std::unique_lock<std::mutex> lock(fSleepMutex);
+      fSleepCond.wait(lock, [this]() { return fStop || fNPending > 0; });
+      if (fStop && fNPending == 0) break;
+   }
+   gCurrentPool = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Queue a task for execution.
+
+void TTaskPool::Push(const Task_t &task)
+{
+   UInt_t idx;
+   if (gCurrentPool == this)
+      idx = gCurrentQueue;
+   else
+      idx = fNextQueue++ % fQueues.size();
+   {
+      TWorkQueue &q = *fQueues[idx];
+      std::lock_guard<std::mutex> lock(q.fMutex);
+      q.fTasks.push_back(task);
+      ++fNPending;
+   }
+   // Taking the lock guarantees that a worker which just found no work
+   // is either not yet testing the wait predicate or already sleeping.
+   {
+      std::lock_guard<std::mutex> lock(fSleepMutex);
+   }
+   fSleepCond.notify_one();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Execute one queued task in the calling thread. Returns kFALSE if there
+/// was no task to run.
+
+Bool_t TTaskPool::RunOne()
+{
+   Task_t task;
+   UInt_t idx = (gCurrentPool == this) ? gCurrentQueue : fQueues.size();
+   if ((idx < fQueues.size() && Pop(idx, task)) || Steal(idx, task)) {
+      task();
+      return kTRUE;
+   }
+   return kFALSE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the pool shared by the ROOT libraries, starting it if needed.
+/// The pool lives until the end of the process.
+
+TTaskPool &TTaskPool::GetDefault()
+{
+   static TTaskPool *pool = new TTaskPool(fgDefaultSize);
+   return *pool;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the number of workers the default pool has (or will have).
+
+UInt_t TTaskPool::GetDefaultSize()
+{
+   if (fgDefaultSize) return fgDefaultSize;
+   UInt_t ncores = std::thread::hardware_concurrency();
+   return ncores ? ncores : 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Set the number of workers of the default pool; 0 means one per core.
+/// Only effective if called before the first call to GetDefault().
+
+void TTaskPool::SetDefaultSize(UInt_t nworkers)
+{
+   fgDefaultSize = nworkers;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Create an empty group of tasks executed by pool.
+
+TTaskGroup::TTaskGroup(TTaskPool &pool) : fPool(pool), fNTasks(0)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Wait for the completion of the tasks of the group.
+
+TTaskGroup::~TTaskGroup()
+{
+   Wait();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Submit task to the pool as part of this group.
+
+void TTaskGroup::Run(const TTaskPool::Task_t &task)
+{
+   ++fNTasks;
+   fPool.Push([this, task]() {
+      task();
+      // Notify under the lock: as soon as it is released Wait() may
+      // return and the group may be destroyed.
+      std::lock_guard<std::mutex> lock(fMutex);
+      if (--fNTasks == 0) fDone.notify_all();
+   });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Wait for all the tasks submitted so far, executing queued tasks of the
+/// pool in the calling thread in the meanwhile.
+
+void TTaskGroup::Wait()
+{
+   while (fNTasks > 0) {
+      if (fPool.RunOne()) continue;
+      std::unique_lock<std::mutex> lock(fMutex);
+      // Some of our tasks are running on the workers; wake up regularly
+      // to help with the tasks they might have spawned.
+      fDone.wait_for(lock, std::chrono::milliseconds(1), [this]() { return fNTasks == 0; });
+   }
+   // Synchronize with the notification of the last task.
+   std::lock_guard<std::mutex> lock(fMutex);
+}
@@ -291,6 +291,15 @@ void TThread::Initialize()
    Init();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Entry point used by ROOT::EnableThreadSafety(), which can not link
+/// against libThread.
+
+extern "C" void ROOT_TThread_Initialize()
+{
+   TThread::Initialize();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return true, if the TThread objects have been initialize. If false,
 /// the process is (from ROOT's point of view) single threaded.
@@ -356,14 +365,6 @@ void TThread::Constructor()
    SetComment("Constructor: MainInternalMutex Locking");
    ThreadInternalLock();
    SetComment("Constructor: MainInternalMutex Locked");
-   memset(fTsd, 0, ROOT::kMaxThreadSlot*sizeof(void*));
-   // In order for the thread 'gDirectory' value to be properly
-   // initialized we need to set it now (otherwise it default
-   // to zero which is 'unexpected')
-   // We initialize it to gROOT rather than gDirectory, since
-   // TFile are currently expected to not be shared by two threads.
-   fTsd[ROOT::kDirectoryThreadSlot] = gROOT;
-
    if (fgMain) fgMain->fPrev = this;
    fNext = fgMain; fPrev = 0; fgMain = this;
 
@@ -876,18 +877,37 @@ void TThread::Ps()
 /// k should be between 0 and kMaxUserThreadSlot for user application.
 /// (and between kMaxUserThreadSlot and kMaxThreadSlot for ROOT libraries).
 /// See ROOT::EThreadSlotReservation
+///
+/// The main thread uses dflt; any other thread, whether started by a
+/// TThread or not (e.g. a std::thread of a TTaskPool), gets its own slots.
 
 void **TThread::Tsd(void *dflt, Int_t k)
 {
-   TThread *th = TThread::Self();
-
-   if (!th) {   //Main thread
+   if (TThread::SelfId() == fgMainId) {   //Main thread
       return (void**)dflt;
    } else {
-      return &(th->fTsd[k]);
+      return GetTls(k);
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Static method returning a pointer to the slot k of the thread local
+/// storage of the calling thread.
+/// This does not require the lock taken by TThread::Self() and works for
+/// threads not created through TThread.
+
+void **TThread::GetTls(Int_t k)
+{
+   TTHREAD_TLS_ARRAY(void*, ROOT::kMaxThreadSlot, tls);
+
+   // In order for the thread 'gDirectory' value to be properly
+   // initialized we set it now (otherwise it defaults to zero which is
+   // 'unexpected'). We initialize it to gROOT rather than gDirectory,
+   // since TFiles are expected not to be shared by two threads.
+   if (k == ROOT::kDirectoryThreadSlot && tls[k] == 0) tls[k] = gROOT;
+   return &(tls[k]);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Static method providing a thread safe printf. Appends a newline.
 
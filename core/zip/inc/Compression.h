@@ -25,6 +25,12 @@ namespace ROOT {
    // in greater compression factors, but takes more CPU time
    // and memory when compressing.  LZMA memory usage is particularly
    // high for compression levels 8 and 9.
+   // The LZ4 algorithm gives lower compression factors than
+   // ZLIB but decompresses several times faster, which makes it
+   // a good choice for data that is read many times. Levels 1 to 3
+   // use the fast LZ4 compressor, levels 4 to 9 use LZ4-HC. It is
+   // only available if ROOT was built with the lz4 option
+   // (R__HAS_LZ4 in RConfigure.h), otherwise ZLIB is used instead.
    //
    // The current algorithms support level 1 to 9. The higher
    // the level the greater the compression and more CPU time
@@ -34,6 +40,7 @@ namespace ROOT {
                                 kZLIB,
                                 kLZMA,
                                 kOldCompressionAlgo,
+                                kLZ4,
                                 // if adding new algorithm types,
                                 // keep this enum value last
                                 kUndefinedCompressionAlgorithm
@@ -15,6 +15,9 @@
 #include "zlib.h"
 #include "RConfigure.h"
 #include "ZipLZMA.h"
+#ifdef R__HAS_LZ4
+#include "ZipLZ4.h"
+#endif
 
 #include <stdio.h>
 #include <assert.h>
@@ -287,11 +290,16 @@ struct bits_internal_state {
    and when R__zipMultipleAlgorithm is called with its last argument set to 0.
    R__ZipMode = 1 : ZLIB compression algorithm is used (default)
    R__ZipMode = 2 : LZMA compression algorithm is used
+   R__ZipMode = 4 : LZ4 compression algorithm is used
    R__ZipMode = 0 or 3 : a very old compression algorithm is used
    (the very old algorithm is supported for backward compatibility)
    The LZMA algorithm requires the external XZ package be installed when linking
    is done. LZMA typically has significantly higher compression factors, but takes
    more CPU time and memory resources while compressing.
+   The LZ4 algorithm requires the external LZ4 package and ROOT built with the lz4
+   option; otherwise ZLIB is used instead. LZ4 has lower compression factors than
+   ZLIB but decompresses several times faster. Levels 1 to 3 use the fast LZ4
+   compressor, levels 4 to 9 the LZ4-HC (high compression) variant.
 */
 int R__ZipMode = 1;
 
@@ -566,6 +574,7 @@ void R__zipMultipleAlgorithm(int cxlevel, int *srcsize, char *src, int *tgtsize,
      /*                      1 = zlib */
      /*                      2 = lzma */
      /*                      3 = old */
+     /*                      4 = lz4 */
 {
   int err;
   int method   = Z_DEFLATED;
@@ -585,6 +594,14 @@ void R__zipMultipleAlgorithm(int cxlevel, int *srcsize, char *src, int *tgtsize,
     return;
   }
 
+#ifdef R__HAS_LZ4
+  // The LZ4 and LZ4-HC compression algorithms
+  if (compressionAlgorithm == 4) {
+    R__zipLZ4(cxlevel, srcsize, src, tgtsize, tgt, irep);
+    return;
+  }
+#endif
+
   // The very old algorithm for backward compatibility
   // 0 for selecting with R__ZipMode in a backward compatible way
   // 3 for selecting in other cases
@@ -646,7 +663,7 @@ void R__zipMultipleAlgorithm(int cxlevel, int *srcsize, char *src, int *tgtsize,
     return;
 
   // 1 is for ZLIB (which is the default), ZLIB is also used for any illegal
-  // algorithm setting
+  // algorithm setting and for LZ4 when ROOT is built without LZ4 support
   } else {
 
     z_stream stream;
@@ -20,6 +20,9 @@ static const int qflag = 0;
 #include "zlib.h"
 #include "RConfigure.h"
 #include "ZipLZMA.h"
+#ifdef R__HAS_LZ4
+#include "ZipLZ4.h"
+#endif
 
 
 /* inflate.c -- put in the public domain by Mark Adler
@@ -1130,7 +1133,8 @@ int R__unzip_header(int *srcsize, uch *src, int *tgtsize)
   /*   C H E C K   H E A D E R   */
   if (!(src[0] == 'Z' && src[1] == 'L' && src[2] == Z_DEFLATED) &&
       !(src[0] == 'C' && src[1] == 'S' && src[2] == Z_DEFLATED) &&
-      !(src[0] == 'X' && src[1] == 'Z' && src[2] == 0)) {
+      !(src[0] == 'X' && src[1] == 'Z' && src[2] == 0) &&
+      !(src[0] == 'L' && src[1] == '4')) {
     fprintf(stderr, "Error R__unzip_header: error in header\n");
     return 1;
   }
@@ -1159,7 +1163,8 @@ void R__unzip(int *srcsize, uch *src, int *tgtsize, uch *tgt, int *irep)
   /*   C H E C K   H E A D E R   */
   if (!(src[0] == 'Z' && src[1] == 'L' && src[2] == Z_DEFLATED) &&
       !(src[0] == 'C' && src[1] == 'S' && src[2] == Z_DEFLATED) &&
-      !(src[0] == 'X' && src[1] == 'Z' && src[2] == 0)) {
+      !(src[0] == 'X' && src[1] == 'Z' && src[2] == 0) &&
+      !(src[0] == 'L' && src[1] == '4')) {
     fprintf(stderr,"Error R__unzip: error in header\n");
     return;
   }
@@ -1217,6 +1222,14 @@ void R__unzip(int *srcsize, uch *src, int *tgtsize, uch *tgt, int *irep)
     R__unzipLZMA(srcsize, src, tgtsize, tgt, irep);
     return;
   }
+  else if (src[0] == 'L' && src[1] == '4') {
+#ifdef R__HAS_LZ4
+    R__unzipLZ4(srcsize, src, tgtsize, tgt, irep);
+#else
+    fprintf(stderr,"R__unzip: LZ4 compressed buffer but ROOT was built without LZ4 support\n");
+#endif
+    return;
+  }
 
   /* Old zlib format */
   if (R__Inflate(&ibufptr, &ibufcnt, &obufptr, &obufcnt)) {
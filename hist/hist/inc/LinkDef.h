@@ -51,6 +51,8 @@
 #pragma link C++ class TGraphTime+;
 #pragma link C++ class TH1-;
 #pragma link C++ class TH1C+;
+#pragma link C++ class TH1ConcurrentFillManager-;
+#pragma link C++ class TH1ConcurrentFiller-;
 #pragma link C++ class TH1D+;
 #pragma link C++ class TH1F+;
 #pragma link C++ class TH1S+;
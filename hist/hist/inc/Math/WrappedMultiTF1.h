@@ -87,6 +87,11 @@ public:
       return fDim;
    }
 
+   /// the interpreted functions (evaluated through a TMethodCall) are not thread safe
+   bool IsThreadSafe() const {
+      return fFunc->GetMethodCall() == 0;
+   }
+
 
    /** @name interface inherited from IParamFunction */
 
@@ -150,6 +155,20 @@ private:
       return fFunc->EvalPar(x, 0 ); 
    }
 
+   /// evaluate function on a batch of points calling directly TF1::EvalPar
+   /// (interpreted functions are not thread safe, see IsThreadSafe)
+   void DoEvalBatch (unsigned int n, const double * const * x, const double * p, double * f) const {
+      if (fFunc->GetMethodCall() ) {
+         for (unsigned int i = 0; i < n; ++i) {
+            fFunc->InitArgs(x[i],p);
+            f[i] = fFunc->EvalPar(x[i],p);
+         }
+         return;
+      }
+      for (unsigned int i = 0; i < n; ++i)
+         f[i] = fFunc->EvalPar(x[i],p);
+   }
+
 
    /// evaluate the partial derivative with respect to the parameter
    double DoParameterDerivative(const double * x, const double * p, unsigned int ipar) const;
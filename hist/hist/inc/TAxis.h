@@ -109,6 +109,7 @@ public:
    virtual Int_t      FindBin(const char *label);
    virtual Int_t      FindFixBin(Double_t x) const;
    virtual Int_t      FindFixBin(const char *label) const;
+   void               FindFixBins(Int_t n, const Double_t *x, Int_t *bins, Int_t stride = 1) const;
    virtual Double_t   GetBinCenter(Int_t bin) const;
    virtual Double_t   GetBinCenterLog(Int_t bin) const;
    const char        *GetBinLabel(Int_t bin) const;
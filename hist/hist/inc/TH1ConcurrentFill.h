@@ -0,0 +1,99 @@
+// @(#)root/hist:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2015, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TH1ConcurrentFill
+#define ROOT_TH1ConcurrentFill
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TH1ConcurrentFillManager                                             //
+//                                                                      //
+// Serializes the filling of one histogram (TH1, TH2, TH3, TProfile,    //
+// TProfile2D, TProfile3D) by several threads, without a clone of       //
+// the histogram per thread.                                            //
+//                                                                      //
+// TH1ConcurrentFiller                                                  //
+//                                                                      //
+// Buffers the Fill calls of one thread and hands them over in batches  //
+// to its TH1ConcurrentFillManager, which fills the histogram with      //
+// FillN while holding its lock.                                        //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef ROOT_Rtypes
+#include "Rtypes.h"
+#endif
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+class TH1;
+
+class TH1ConcurrentFillManager {
+
+private:
+   TH1                   *fHist;          // Histogram filled
+   Int_t                  fNcoords;       // Number of coordinates of a fill, without the weight
+   Bool_t                 fProfile;       // True if fHist is a TProfile, TProfile2D or TProfile3D
+   std::mutex             fMutex;         // Serializes the fills of fHist
+   std::atomic<Long64_t>  fNFlushes;      // Number of batches filled
+   std::atomic<Long64_t>  fNContended;    // Number of batches that waited for the lock
+
+   TH1ConcurrentFillManager(const TH1ConcurrentFillManager &);            // not implemented
+   TH1ConcurrentFillManager &operator=(const TH1ConcurrentFillManager &); // not implemented
+
+public:
+   explicit TH1ConcurrentFillManager(TH1 &hist);
+
+   void     FillN(Int_t n, const Double_t *const *coords, const Double_t *w);
+   TH1     *GetHist() const { return fHist; }
+   Int_t    GetNcoords() const { return fNcoords; }
+   Long64_t GetNFlushes() const { return fNFlushes; }
+   Long64_t GetNContended() const { return fNContended; }
+};
+
+
+class TH1ConcurrentFiller {
+
+public:
+   enum { kDefaultSize = 512, kMaxCoords = 4 };
+
+private:
+   TH1ConcurrentFillManager &fManager;            // Manager filling the histogram
+   Int_t                     fNcoords;            // Number of coordinates of a fill
+   Int_t                     fSize;               // Number of fills buffered before a flush
+   Int_t                     fN;                  // Number of fills in the buffer
+   Bool_t                    fWeighted;           // True if a fill of the buffer has a weight
+   std::vector<Double_t>     fCoords[kMaxCoords]; // Buffered coordinates
+   std::vector<Double_t>     fW;                  // Buffered weights
+
+   TH1ConcurrentFiller(const TH1ConcurrentFiller &);            // not implemented
+   TH1ConcurrentFiller &operator=(const TH1ConcurrentFiller &); // not implemented
+
+   void Push(Int_t nargs, const Double_t *args);
+
+public:
+   explicit TH1ConcurrentFiller(TH1ConcurrentFillManager &manager, Int_t size = kDefaultSize);
+   ~TH1ConcurrentFiller();
+
+   // The arguments have the meaning of those of the Fill methods of the histogram.
+   void Fill(Double_t a);
+   void Fill(Double_t a, Double_t b);
+   void Fill(Double_t a, Double_t b, Double_t c);
+   void Fill(Double_t a, Double_t b, Double_t c, Double_t d);
+   void Fill(Double_t x, Double_t y, Double_t z, Double_t t, Double_t w);
+   void Flush();
+
+   TH1ConcurrentFillManager &GetManager() const { return fManager; }
+   Int_t GetSize() const { return fSize; }
+};
+
+#endif
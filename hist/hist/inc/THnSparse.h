@@ -48,19 +48,23 @@
 #endif
 
 class THnSparseCompactBinCoord;
+class THnSparseBinIndex;
 
 class THnSparse: public THnBase {
  private:
    Int_t      fChunkSize;    // number of entries for each chunk
    Long64_t   fFilledBins;   // number of filled bins
    TObjArray  fBinContent;   // array of THnSparseArrayChunk
-   TExMap     fBins;         //! filled bins
-   TExMap     fBinsContinued;//! filled bins for non-unique hashes, containing pairs of (bin index 0, bin index 1)
+   THnSparseBinIndex *fBinIndex; //! open addressing hash table of the filled bins
    THnSparseCompactBinCoord *fCompactCoord; //! compact coordinate
 
+   static Int_t fgMergeThreads; // number of threads used by Merge
+
    THnSparse(const THnSparse&); // Not implemented
    THnSparse& operator=(const THnSparse&); // Not implemented
 
+   Long64_t GetBinIndex(ULong64_t hash, const Char_t* buf, Bool_t allocate);
+
  protected:
 
    THnSparse();
@@ -73,7 +77,7 @@ class THnSparse: public THnBase {
 
    THnSparseArrayChunk* AddChunk();
    void Reserve(Long64_t nbins);
-   void FillExMap();
+   void FillBinIndex();
    virtual TArray* GenerateArray() const = 0;
    Long64_t GetBinIndexForCurrentBin(Bool_t allocate);
    void FillBin(Long64_t bin, Double_t w) {
@@ -105,6 +109,7 @@ class THnSparse: public THnBase {
    ROOT::Internal::THnBaseBinIter* CreateIter(Bool_t respectAxisRange) const;
 
    Long64_t GetNbins() const { return fFilledBins; }
+   void FillN(Int_t n, const Double_t* x, const Double_t* w = 0);
    void SetFilledBins(Long64_t nbins) { fFilledBins = nbins; }
 
    Long64_t GetBin(const Int_t* idx) const { return const_cast<THnSparse*>(this)->GetBin(idx, kFALSE); }
@@ -175,9 +180,13 @@ class THnSparse: public THnBase {
       return (THnSparse*) RebinBase(group);
    }
 
+   Long64_t Merge(TCollection* list);
    void Reset(Option_t* option = "");
    void Sumw2();
 
+   static Int_t GetMergeThreads() { return fgMergeThreads; }
+   static void  SetMergeThreads(Int_t nthreads = 0);
+
    ClassDef(THnSparse, 3); // Interfaces of sparse n-dimensional histogram
 };
 
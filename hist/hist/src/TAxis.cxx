@@ -405,6 +405,56 @@ Int_t TAxis::FindFixBin(Double_t x) const
    return bin;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Set bins[i] to FindFixBin(x[i*stride]) for the n values of x.
+///
+/// The loops have no branches, so that the bins of consecutive values are
+/// computed in parallel (by the vector unit for the fix bins, when the
+/// compiler vectorizes the loop). The bin of a value on a bin edge, or
+/// in the underflow or overflow, is the one returned by FindFixBin.
+
+void TAxis::FindFixBins(Int_t n, const Double_t *x, Int_t *bins, Int_t stride) const
+{
+   const Double_t xmin = fXmin;
+   const Double_t xmax = fXmax;
+   if (!fXbins.fN) {        //*-* fix bins
+      const Double_t nbins = fNbins;
+      for (Int_t i = 0; i < n; ++i) {
+         const Double_t v = x[i * stride];
+         // Clamp before the conversion to integer, also for NaN.
+         Double_t t = nbins * (v - xmin) / (xmax - xmin);
+         t = (v < xmin) ? -1. : t;
+         t = !(v < xmax) ? nbins : t;
+         bins[i] = 1 + (Int_t)t;
+      }
+      return;
+   }
+   //*-* variable bin sizes: same result as TMath::BinarySearch
+   const Double_t *edges = fXbins.fArray;
+   const Int_t nedges = fXbins.fN;
+   for (Int_t i = 0; i < n; ++i) {
+      const Double_t v = x[i * stride];
+      if (v < xmin) {
+         bins[i] = 0;
+         continue;
+      }
+      if (!(v < xmax)) {
+         bins[i] = fNbins + 1;
+         continue;
+      }
+      // Position of the first edge not lower than v (std::lower_bound).
+      const Double_t *base = edges;
+      Int_t len = nedges;
+      while (len > 1) {
+         Int_t half = len / 2;
+         base = (base[half] < v) ? base + half : base;
+         len -= half;
+      }
+      Int_t pos = (base - edges) + (*base < v);
+      bins[i] = 1 + ((pos < nedges && edges[pos] == v) ? pos : pos - 1);
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return label for bin
 
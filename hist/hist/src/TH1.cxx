@@ -39,6 +39,7 @@
 #include "TVirtualHistPainter.h"
 #include "TVirtualFFT.h"
 #include "TSystem.h"
+#include "THFillHelper.h"
 
 #include "HFitInterface.h"
 #include "Fit/DataRange.h"
@@ -3283,6 +3284,11 @@ void TH1::FillN(Int_t ntimes, const Double_t *x, const Double_t *w, Int_t stride
 ////////////////////////////////////////////////////////////////////////////////
 /// internal method to fill histogram content from a vector
 /// called directly by TH1::BufferEmpty
+///
+/// When the axis can not be extended, the values are processed by chunks:
+/// the bins of a chunk are found at once (see TAxis::FindFixBins), then
+/// the contents, the sums of squares of weights and the statistics are
+/// updated in separate loops. The results are the same as with Fill.
 
 void TH1::DoFillN(Int_t ntimes, const Double_t *x, const Double_t *w, Int_t stride)
 {
@@ -3291,6 +3297,34 @@ void TH1::DoFillN(Int_t ntimes, const Double_t *x, const Double_t *w, Int_t stri
    fEntries += ntimes;
    Double_t ww = 1;
    Int_t nbins   = fXaxis.GetNbins();
+   if (!fXaxis.CanExtend()) {
+      if (w && !fSumw2.fN && !TestBit(TH1::kIsNotW) && !ROOT::Internal::HasUnitWeights(ntimes, w, stride)) Sumw2();
+      Double_t *arrayD = (IsA() == TH1D::Class()) ? static_cast<TH1D*>(this)->fArray : 0;
+      Float_t  *arrayF = (IsA() == TH1F::Class()) ? static_cast<TH1F*>(this)->fArray : 0;
+      Int_t bins[ROOT::Internal::kFillChunk];
+      for (Int_t first = 0; first < ntimes; first += ROOT::Internal::kFillChunk) {
+         Int_t n = TMath::Min(ROOT::Internal::kFillChunk, ntimes - first);
+         const Double_t *cx = x + first * stride;
+         const Double_t *cw = w ? w + first * stride : 0;
+         fXaxis.FindFixBins(n, cx, bins, stride);
+         if (arrayD)      ROOT::Internal::AddToBins(arrayD, n, bins, cw, stride);
+         else if (arrayF) ROOT::Internal::AddToBins(arrayF, n, bins, cw, stride);
+         else {
+            for (i = 0; i < n; ++i) AddBinContent(bins[i], cw ? cw[i * stride] : 1.);
+         }
+         if (fSumw2.fN) ROOT::Internal::AddSquaresToBins(fSumw2.fArray, n, bins, cw, stride);
+         for (i = 0; i < n; ++i) {
+            if (!fgStatOverflows && (bins[i] == 0 || bins[i] > nbins)) continue;
+            Double_t z = cw ? cw[i * stride] : 1.;
+            Double_t xi = cx[i * stride];
+            fTsumw   += z;
+            fTsumw2  += z*z;
+            fTsumwx  += z*xi;
+            fTsumwx2 += z*xi*xi;
+         }
+      }
+      return;
+   }
    ntimes *= stride;
    for (i=0;i<ntimes;i+=stride) {
       bin =fXaxis.FindBin(x[i]);
@@ -0,0 +1,208 @@
+// @(#)root/hist:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2015, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+/** \class TH1ConcurrentFillManager
+Fill one histogram from several threads.
+
+Each thread fills through its own TH1ConcurrentFiller, which buffers the
+values and hands them over to the manager when its buffer is full (and
+when it is flushed or destructed). The manager fills the histogram with
+FillN (or with Fill for the profiles) while holding a lock, which is
+taken once per buffer rather than once per value. Only the buffers are
+per thread: their size, a few KBytes, does not depend on the number of
+bins, and no Merge is needed at the end.
+
+The contents and statistics are the ones of a serial filling with the
+same values; only the order in which the buffers of the threads are
+added can change the last bits of the sums of weights.
+~~~{.cpp}
+   TH1D h("h", "h", 100, -4, 4);
+   TH1ConcurrentFillManager manager(h);
+   // in each thread:
+   TH1ConcurrentFiller filler(manager);
+   for (...) filler.Fill(x, w);
+   // the filler is flushed when it goes out of scope
+~~~
+The histogram must not be used by other means while it is being filled
+through the manager.
+*/
+
+/** \class TH1ConcurrentFiller
+Buffer the Fill calls of one thread for a TH1ConcurrentFillManager.
+
+A filler must be used by one thread only. Its Fill methods take the
+arguments of the Fill methods of the histogram: the coordinates,
+optionally followed by a weight.
+*/
+
+#include "TH1ConcurrentFill.h"
+#include "TH1.h"
+#include "TH2.h"
+#include "TH3.h"
+#include "TProfile.h"
+#include "TProfile2D.h"
+#include "TProfile3D.h"
+#include "TError.h"
+
+////////////////////////////////////////////////////////////////////////////////
+/// Manage the concurrent filling of hist.
+
+TH1ConcurrentFillManager::TH1ConcurrentFillManager(TH1 &hist) :
+   fHist(&hist), fNcoords(hist.GetDimension()), fProfile(kFALSE), fNFlushes(0), fNContended(0)
+{
+   if (hist.InheritsFrom(TProfile::Class()) || hist.InheritsFrom(TProfile2D::Class()) ||
+       hist.InheritsFrom(TProfile3D::Class())) {
+      fProfile = kTRUE;
+      ++fNcoords;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill the histogram with the n values whose coordinates are in
+/// coords[0..GetNcoords()-1], with the weights w (1 if w is 0).
+/// Can be called concurrently.
+
+void TH1ConcurrentFillManager::FillN(Int_t n, const Double_t *const *coords, const Double_t *w)
+{
+   if (n <= 0) return;
+   if (!fMutex.try_lock()) {
+      ++fNContended;
+      fMutex.lock();
+   }
+   std::lock_guard<std::mutex> lock(fMutex, std::adopt_lock);
+   ++fNFlushes;
+   const Double_t *x = coords[0];
+   const Double_t *y = fNcoords > 1 ? coords[1] : 0;
+   const Double_t *z = fNcoords > 2 ? coords[2] : 0;
+   const Double_t *t = fNcoords > 3 ? coords[3] : 0;
+   if (!fProfile) {
+      if (fNcoords == 1)      fHist->FillN(n, x, w);
+      else if (fNcoords == 2) static_cast<TH2*>(fHist)->FillN(n, x, y, w);
+      else                    static_cast<TH3*>(fHist)->FillN(n, x, y, z, w);
+      return;
+   }
+   // The profiles are filled with Fill, the sums of FillN are not always
+   // the same as those of Fill.
+   Int_t i;
+   if (fNcoords == 2) {
+      TProfile *p = static_cast<TProfile*>(fHist);
+      if (w) for (i = 0; i < n; ++i) p->Fill(x[i], y[i], w[i]);
+      else   for (i = 0; i < n; ++i) p->Fill(x[i], y[i]);
+   } else if (fNcoords == 3) {
+      TProfile2D *p = static_cast<TProfile2D*>(fHist);
+      if (w) for (i = 0; i < n; ++i) p->Fill(x[i], y[i], z[i], w[i]);
+      else   for (i = 0; i < n; ++i) p->Fill(x[i], y[i], z[i]);
+   } else {
+      TProfile3D *p = static_cast<TProfile3D*>(fHist);
+      if (w) for (i = 0; i < n; ++i) p->Fill(x[i], y[i], z[i], t[i], w[i]);
+      else   for (i = 0; i < n; ++i) p->Fill(x[i], y[i], z[i], t[i]);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Buffer up to size fills for manager.
+
+TH1ConcurrentFiller::TH1ConcurrentFiller(TH1ConcurrentFillManager &manager, Int_t size) :
+   fManager(manager), fNcoords(manager.GetNcoords()), fSize(size > 0 ? size : 1), fN(0), fWeighted(kFALSE)
+{
+   for (Int_t c = 0; c < fNcoords; ++c) fCoords[c].resize(fSize);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Flush the fills still in the buffer.
+
+TH1ConcurrentFiller::~TH1ConcurrentFiller()
+{
+   Flush();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Buffer a fill with the nargs arguments args: the coordinates, optionally
+/// followed by a weight.
+
+void TH1ConcurrentFiller::Push(Int_t nargs, const Double_t *args)
+{
+   if (nargs != fNcoords && nargs != fNcoords + 1) {
+      ::Error("TH1ConcurrentFiller::Fill", "%d arguments given for a histogram with %d coordinates - ignored",
+              nargs, fNcoords);
+      return;
+   }
+   for (Int_t c = 0; c < fNcoords; ++c) fCoords[c][fN] = args[c];
+   if (nargs > fNcoords) {
+      if (!fWeighted) {
+         // The previous fills of the buffer have a unit weight.
+         fW.resize(fSize);
+         for (Int_t i = 0; i < fN; ++i) fW[i] = 1.;
+         fWeighted = kTRUE;
+      }
+      fW[fN] = args[fNcoords];
+   } else if (fWeighted) {
+      fW[fN] = 1.;
+   }
+   if (++fN == fSize) Flush();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Buffer the fill Fill(a) of the histogram.
+
+void TH1ConcurrentFiller::Fill(Double_t a)
+{
+   Double_t args[1] = { a };
+   Push(1, args);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Buffer the fill Fill(a,b) of the histogram.
+
+void TH1ConcurrentFiller::Fill(Double_t a, Double_t b)
+{
+   Double_t args[2] = { a, b };
+   Push(2, args);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Buffer the fill Fill(a,b,c) of the histogram.
+
+void TH1ConcurrentFiller::Fill(Double_t a, Double_t b, Double_t c)
+{
+   Double_t args[3] = { a, b, c };
+   Push(3, args);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Buffer the fill Fill(a,b,c,d) of the histogram.
+
+void TH1ConcurrentFiller::Fill(Double_t a, Double_t b, Double_t c, Double_t d)
+{
+   Double_t args[4] = { a, b, c, d };
+   Push(4, args);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Buffer the fill Fill(x,y,z,t,w) of a TProfile3D.
+
+void TH1ConcurrentFiller::Fill(Double_t x, Double_t y, Double_t z, Double_t t, Double_t w)
+{
+   Double_t args[5] = { x, y, z, t, w };
+   Push(5, args);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Hand the buffered fills over to the manager.
+
+void TH1ConcurrentFiller::Flush()
+{
+   if (!fN) return;
+   const Double_t *coords[kMaxCoords];
+   for (Int_t c = 0; c < fNcoords; ++c) coords[c] = &fCoords[c][0];
+   fManager.FillN(fN, coords, fWeighted ? &fW[0] : 0);
+   fN = 0;
+   fWeighted = kFALSE;
+}
@@ -24,6 +24,7 @@
 #include "TMath.h"
 #include "TObjString.h"
 #include "TVirtualHistPainter.h"
+#include "THFillHelper.h"
 
 
 ClassImp(TH2)
@@ -544,6 +545,11 @@ void TH2::FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const Double
          return;
    }
 
+   if (!fXaxis.CanExtend() && !fYaxis.CanExtend()) {
+      DoFillNFixBins((ntimes - ifirst) / stride, x + ifirst, y + ifirst, w ? w + ifirst : 0, stride);
+      return;
+   }
+
    Double_t ww = 1;
    for (i=ifirst;i<ntimes;i+=stride) {
       fEntries++;
@@ -573,6 +579,58 @@ void TH2::FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const Double
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Fill the histogram with the ntimes values x[i*stride],y[i*stride] and
+/// weights w[i*stride] when no axis can be extended, called by TH2::FillN.
+///
+/// The values are processed by chunks: the bins of a chunk are found at
+/// once (see TAxis::FindFixBins), then the contents, the sums of squares of
+/// weights and the statistics are updated in separate loops. The results
+/// are the same as with Fill.
+
+void TH2::DoFillNFixBins(Int_t ntimes, const Double_t *x, const Double_t *y, const Double_t *w, Int_t stride)
+{
+   fEntries += ntimes;
+   if (w && !fSumw2.fN && !TestBit(TH1::kIsNotW) && !ROOT::Internal::HasUnitWeights(ntimes, w, stride)) Sumw2();
+   Double_t *arrayD = (IsA() == TH2D::Class()) ? static_cast<TH2D*>(this)->fArray : 0;
+   Float_t  *arrayF = (IsA() == TH2F::Class()) ? static_cast<TH2F*>(this)->fArray : 0;
+   const Int_t nx = fXaxis.GetNbins();
+   const Int_t ny = fYaxis.GetNbins();
+   Int_t binsx[ROOT::Internal::kFillChunk];
+   Int_t binsy[ROOT::Internal::kFillChunk];
+   Int_t bins[ROOT::Internal::kFillChunk];
+   for (Int_t first = 0; first < ntimes; first += ROOT::Internal::kFillChunk) {
+      Int_t n = TMath::Min(ROOT::Internal::kFillChunk, ntimes - first);
+      const Double_t *cx = x + first * stride;
+      const Double_t *cy = y + first * stride;
+      const Double_t *cw = w ? w + first * stride : 0;
+      fXaxis.FindFixBins(n, cx, binsx, stride);
+      fYaxis.FindFixBins(n, cy, binsy, stride);
+      Int_t i;
+      for (i = 0; i < n; ++i) bins[i] = binsy[i] * (nx + 2) + binsx[i];
+      if (arrayD)      ROOT::Internal::AddToBins(arrayD, n, bins, cw, stride);
+      else if (arrayF) ROOT::Internal::AddToBins(arrayF, n, bins, cw, stride);
+      else {
+         for (i = 0; i < n; ++i) AddBinContent(bins[i], cw ? cw[i * stride] : 1.);
+      }
+      if (fSumw2.fN) ROOT::Internal::AddSquaresToBins(fSumw2.fArray, n, bins, cw, stride);
+      for (i = 0; i < n; ++i) {
+         if (!fgStatOverflows && (binsx[i] == 0 || binsx[i] > nx || binsy[i] == 0 || binsy[i] > ny)) continue;
+         Double_t z = cw ? cw[i * stride] : 1.;
+         Double_t xi = cx[i * stride];
+         Double_t yi = cy[i * stride];
+         fTsumw   += z;
+         fTsumw2  += z*z;
+         fTsumwx  += z*xi;
+         fTsumwx2 += z*xi*xi;
+         fTsumwy  += z*yi;
+         fTsumwy2 += z*yi*yi;
+         fTsumwxy += z*xi*yi;
+      }
+   }
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Fill histogram following distribution in function fname.
 ///
@@ -23,6 +23,7 @@
 #include "TError.h"
 #include "TMath.h"
 #include "TObjString.h"
+#include "THFillHelper.h"
 
 ClassImp(TH3)
 
@@ -371,6 +372,117 @@ Int_t TH3::Fill(Double_t x, Double_t y, Double_t z, Double_t w)
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Fill a 3-D histogram with an array of values and weights.
+///
+/// ntimes:  number of entries in arrays x, y, z and w (array size must be ntimes*stride)
+/// x:       array of x values to be histogrammed
+/// y:       array of y values to be histogrammed
+/// z:       array of z values to be histogrammed
+/// w:       array of weights
+/// stride:  step size through arrays x, y, z and w
+///
+///  If the weight is not equal to 1, the storage of the sum of squares of
+///   weights is automatically triggered and the sum of the squares of weights is incremented
+///   by w[i]^2 in the cell corresponding to x[i],y[i],z[i].
+///  If w is NULL each entry is assumed a weight=1
+///
+/// NB: function only valid for a TH3x object
+
+void TH3::FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const Double_t *z, const Double_t *w, Int_t stride)
+{
+   Int_t i;
+   ntimes *= stride;
+   Int_t ifirst = 0;
+
+   //If a buffer is activated, fill buffer
+   if (fBuffer) {
+      for (i=0;i<ntimes;i+=stride) {
+         if (!fBuffer) break; // buffer can be deleted in BufferFill when is empty
+         if (w) BufferFill(x[i],y[i],z[i],w[i]);
+         else BufferFill(x[i],y[i],z[i],1.);
+      }
+      // fill the remaining entries if the buffer has been deleted
+      if (i < ntimes && fBuffer==0)
+         ifirst = i;
+      else
+         return;
+   }
+
+   if (!fXaxis.CanExtend() && !fYaxis.CanExtend() && !fZaxis.CanExtend()) {
+      DoFillNFixBins((ntimes - ifirst) / stride, x + ifirst, y + ifirst, z + ifirst, w ? w + ifirst : 0, stride);
+      return;
+   }
+   for (i=ifirst;i<ntimes;i+=stride) {
+      if (w) Fill(x[i],y[i],z[i],w[i]);
+      else   Fill(x[i],y[i],z[i]);
+   }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill the histogram with the ntimes values x[i*stride],y[i*stride],
+/// z[i*stride] and weights w[i*stride] when no axis can be extended,
+/// called by TH3::FillN.
+///
+/// The values are processed by chunks: the bins of a chunk are found at
+/// once (see TAxis::FindFixBins), then the contents, the sums of squares of
+/// weights and the statistics are updated in separate loops. The results
+/// are the same as with Fill.
+
+void TH3::DoFillNFixBins(Int_t ntimes, const Double_t *x, const Double_t *y, const Double_t *z, const Double_t *w, Int_t stride)
+{
+   fEntries += ntimes;
+   if (w && !fSumw2.fN && !TestBit(TH1::kIsNotW) && !ROOT::Internal::HasUnitWeights(ntimes, w, stride)) Sumw2();
+   Double_t *arrayD = (IsA() == TH3D::Class()) ? static_cast<TH3D*>(this)->fArray : 0;
+   Float_t  *arrayF = (IsA() == TH3F::Class()) ? static_cast<TH3F*>(this)->fArray : 0;
+   const Int_t nx = fXaxis.GetNbins();
+   const Int_t ny = fYaxis.GetNbins();
+   const Int_t nz = fZaxis.GetNbins();
+   Int_t binsx[ROOT::Internal::kFillChunk];
+   Int_t binsy[ROOT::Internal::kFillChunk];
+   Int_t binsz[ROOT::Internal::kFillChunk];
+   Int_t bins[ROOT::Internal::kFillChunk];
+   for (Int_t first = 0; first < ntimes; first += ROOT::Internal::kFillChunk) {
+      Int_t n = TMath::Min(ROOT::Internal::kFillChunk, ntimes - first);
+      const Double_t *cx = x + first * stride;
+      const Double_t *cy = y + first * stride;
+      const Double_t *cz = z + first * stride;
+      const Double_t *cw = w ? w + first * stride : 0;
+      fXaxis.FindFixBins(n, cx, binsx, stride);
+      fYaxis.FindFixBins(n, cy, binsy, stride);
+      fZaxis.FindFixBins(n, cz, binsz, stride);
+      Int_t i;
+      for (i = 0; i < n; ++i) bins[i] = binsx[i] + (nx + 2) * (binsy[i] + (ny + 2) * binsz[i]);
+      if (arrayD)      ROOT::Internal::AddToBins(arrayD, n, bins, cw, stride);
+      else if (arrayF) ROOT::Internal::AddToBins(arrayF, n, bins, cw, stride);
+      else {
+         for (i = 0; i < n; ++i) AddBinContent(bins[i], cw ? cw[i * stride] : 1.);
+      }
+      if (fSumw2.fN) ROOT::Internal::AddSquaresToBins(fSumw2.fArray, n, bins, cw, stride);
+      for (i = 0; i < n; ++i) {
+         if (!fgStatOverflows && (binsx[i] == 0 || binsx[i] > nx || binsy[i] == 0 || binsy[i] > ny ||
+                                  binsz[i] == 0 || binsz[i] > nz)) continue;
+         Double_t ww = cw ? cw[i * stride] : 1.;
+         Double_t xi = cx[i * stride];
+         Double_t yi = cy[i * stride];
+         Double_t zi = cz[i * stride];
+         fTsumw   += ww;
+         fTsumw2  += ww*ww;
+         fTsumwx  += ww*xi;
+         fTsumwx2 += ww*xi*xi;
+         fTsumwy  += ww*yi;
+         fTsumwy2 += ww*yi*yi;
+         fTsumwxy += ww*xi*yi;
+         fTsumwz  += ww*zi;
+         fTsumwz2 += ww*zi*zi;
+         fTsumwxz += ww*xi*zi;
+         fTsumwyz += ww*yi*zi;
+      }
+   }
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Increment cell defined by namex,namey,namez by a weight w
 ///
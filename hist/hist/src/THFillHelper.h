@@ -0,0 +1,74 @@
+// @(#)root/hist:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2015, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_THFillHelper
+#define ROOT_THFillHelper
+
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// THFillHelper                                                         //
+//                                                                      //
+// Helper functions for the bulk filling of histograms (TH1::FillN,     //
+// TH2::FillN, TH3::FillN): the bins of a chunk of values are found     //
+// first, then the weights are added to the bins in a separate loop.    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#include "Rtypes.h"
+
+namespace ROOT {
+namespace Internal {
+
+   // Number of values whose bins are found at once.
+   const Int_t kFillChunk = 256;
+
+   ////////////////////////////////////////////////////////////////////////////////
+   /// Return true if the n weights w[i*stride] are all equal to 1.
+
+   inline Bool_t HasUnitWeights(Int_t n, const Double_t *w, Int_t stride)
+   {
+      for (Int_t i = 0; i < n; ++i) {
+         if (w[i * stride] != 1.0) return kFALSE;
+      }
+      return kTRUE;
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   /// Add the weights w[i*stride] (1 if w is 0) to array[bins[i]].
+   /// The bins may repeat, hence the scalar loop.
+
+   template <typename T>
+   inline void AddToBins(T *array, Int_t n, const Int_t *bins, const Double_t *w, Int_t stride)
+   {
+      if (w) {
+         for (Int_t i = 0; i < n; ++i) array[bins[i]] += T(w[i * stride]);
+      } else {
+         for (Int_t i = 0; i < n; ++i) ++array[bins[i]];
+      }
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   /// Add the squares of the weights w[i*stride] (1 if w is 0) to
+   /// sumw2[bins[i]].
+
+   inline void AddSquaresToBins(Double_t *sumw2, Int_t n, const Int_t *bins, const Double_t *w, Int_t stride)
+   {
+      if (w) {
+         for (Int_t i = 0; i < n; ++i) sumw2[bins[i]] += w[i * stride] * w[i * stride];
+      } else {
+         for (Int_t i = 0; i < n; ++i) sumw2[bins[i]] += 1.;
+      }
+   }
+
+} // namespace Internal
+} // namespace ROOT
+
+#endif
@@ -16,6 +16,9 @@
 #include "TDataMember.h"
 #include "TDataType.h"
 
+#include <thread>
+#include <vector>
+
 namespace {
 //______________________________________________________________________________
 //
@@ -409,6 +412,121 @@ THnSparseCompactBinCoord::~THnSparseCompactBinCoord()
    delete [] fCurrentBin;
 }
 
+/** \class THnSparseBinIndex
+THnSparseBinIndex is used internally by THnSparse. It maps the hash of the
+compact coordinates of the filled bins to their linear index, in a flat open
+addressing hash table with linear probing: each slot holds a hash and the
+linear index + 1 (0 marks an empty slot), four slots per cache line. Bins
+whose compact coordinates have the same hash (possible only if the compact
+coordinates take more than 8 bytes) are found further in the probe sequence,
+so no chaining is needed. The table is transient: it is rebuilt from the
+coordinates stored in the chunks when the histogram has been read.
+*/
+
+class THnSparseBinIndex {
+public:
+   THnSparseBinIndex(): fSlots(0), fMask(0), fCount(0) {}
+   ~THnSparseBinIndex() { delete [] fSlots; }
+
+   Long64_t GetSize() const { return fCount; }
+   Long64_t GetCapacity() const { return fSlots ? fMask + 1 : 0; }
+   Long64_t GetMemorySize() const { return GetCapacity() * sizeof(TSlot); }
+
+   void Clear() {
+      delete [] fSlots;
+      fSlots = 0;
+      fMask = 0;
+      fCount = 0;
+   }
+
+   void Reserve(Long64_t n) {
+      // Make room for n bins without rehashing.
+      if (4 * n > 3 * GetCapacity()) Rehash(n);
+   }
+
+   const void* GetFirstSlot(ULong64_t hash) const {
+      // Slot where the lookup of hash starts, to prefetch it.
+      return fSlots ? fSlots + (Mix(hash) & fMask) : 0;
+   }
+
+   template <class MATCH>
+   Long64_t Find(ULong64_t hash, MATCH matches) const {
+      // Return the linear index of the bin with hash for which matches(index)
+      // is true, -1 if there is none.
+      if (!fSlots) return -1;
+      for (ULong64_t i = Mix(hash) & fMask; fSlots[i].fIndex; i = (i + 1) & fMask) {
+         if (fSlots[i].fHash == hash && matches(fSlots[i].fIndex - 1))
+            return fSlots[i].fIndex - 1;
+      }
+      return -1;
+   }
+
+   void Insert(ULong64_t hash, Long64_t linidx) {
+      // Add the bin with linear index linidx; it must not be in the table yet.
+      if (4 * (fCount + 1) > 3 * GetCapacity()) Rehash(2 * (fCount + 1));
+      Put(hash, linidx + 1);
+      ++fCount;
+   }
+
+private:
+   struct TSlot {
+      ULong64_t fHash;  // hash of the compact coordinates
+      Long64_t  fIndex; // linear index + 1, 0 if the slot is empty
+   };
+
+   THnSparseBinIndex(const THnSparseBinIndex&); // intentionally not implemented
+   THnSparseBinIndex& operator=(const THnSparseBinIndex&); // intentionally not implemented
+
+   static ULong64_t Mix(ULong64_t h) {
+      // Spread the bits of h: the compact coordinates of neighbouring bins
+      // differ only in a few bits.
+      h ^= h >> 33;
+      h *= 0xff51afd7ed558ccdULL;
+      h ^= h >> 33;
+      return h;
+   }
+
+   void Put(ULong64_t hash, Long64_t index) {
+      ULong64_t i = Mix(hash) & fMask;
+      while (fSlots[i].fIndex) i = (i + 1) & fMask;
+      fSlots[i].fHash = hash;
+      fSlots[i].fIndex = index;
+   }
+
+   void Rehash(Long64_t n) {
+      // Reallocate the table for n bins at a load of at most 3/4.
+      ULong64_t capacity = 1024;
+      while (3 * capacity < 4 * (ULong64_t)n) capacity *= 2;
+      TSlot* old = fSlots;
+      ULong64_t oldCapacity = GetCapacity();
+      fSlots = new TSlot[capacity];
+      memset(fSlots, 0, capacity * sizeof(TSlot));
+      fMask = capacity - 1;
+      for (ULong64_t i = 0; i < oldCapacity; ++i) {
+         if (old[i].fIndex) Put(old[i].fHash, old[i].fIndex);
+      }
+      delete [] old;
+   }
+
+   TSlot*    fSlots; // slots, a power of 2 of them
+   ULong64_t fMask;  // number of slots - 1
+   Long64_t  fCount; // number of bins in the table
+};
+
+namespace {
+////////////////////////////////////////////////////////////////////////////////
+/// Hint the processor that p will be read soon.
+
+inline void Prefetch(const void *p)
+{
+#if defined(__GNUC__) || defined(__clang__)
+   if (p) __builtin_prefetch(p);
+#else
+   (void)p;
+#endif
+}
+}
+
 /** \class THnSparseArrayChunk
 THnSparseArrayChunk is used internally by THnSparse.
 THnSparse stores its (dynamic size) array of bin coordinates and their
@@ -570,24 +688,33 @@ Translation from an n-dimensional bin coordinate to the linear index within
 the chunks is done by GetBin(). It creates a hash from the compacted bin
 coordinates (the hash of a bin coordinate is the compacted coordinate itself
 if it takes less than 8 bytes, the size of a Long64_t.
-This hash is used to lookup the linear index in the TExMap member fBins;
-the coordinates of the entry fBins points to is compared to the coordinates
-passed to GetBin(). If they do not match, these two coordinates have the same
-hash - which is extremely unlikely but (for the case where the compact bin
-coordinates are larger than 4 bytes) possible. In this case, fBinsContinued
-contains a chain of linear indexes with the same hash. Iterating through this
-chain and comparing each bin coordinates with the one passed to GetBin() will
-retrieve the matching bin.
+This hash is used to lookup the linear index in the open addressing hash
+table fBinIndex (see THnSparseBinIndex); the coordinates of each entry with
+that hash are compared to the coordinates passed to GetBin(). They can only
+differ - which is extremely unlikely - if the compact bin coordinates are
+larger than 8 bytes; the matching bin is then further in the probe sequence.
+
+## Batched Filling and Merging
+THnSparse::FillN() fills a batch of entries: the compact coordinates of
+several entries are computed first, and the slots of the hash table where
+their lookups start are prefetched, so that the lookups of several entries
+wait for the memory at the same time.
+
+Merge() adds the histograms of the list in several threads (see
+SetMergeThreads()): each thread adds a part of the list into its own
+partial sum, and the partial sums are added to this histogram.
 */
 
 
 ClassImp(THnSparse);
 
+Int_t THnSparse::fgMergeThreads = 1;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Construct an empty THnSparse.
 
 THnSparse::THnSparse():
-   fChunkSize(1024), fFilledBins(0), fCompactCoord(0)
+   fChunkSize(1024), fFilledBins(0), fBinIndex(new THnSparseBinIndex), fCompactCoord(0)
 {
    fBinContent.SetOwner();
 }
@@ -604,7 +731,7 @@ THnSparse::THnSparse(const char* name, const char* title, Int_t dim,
                      const Int_t* nbins, const Double_t* xmin, const Double_t* xmax,
                      Int_t chunksize):
    THnBase(name, title, dim, nbins, xmin, xmax),
-   fChunkSize(chunksize), fFilledBins(0), fCompactCoord(0)
+   fChunkSize(chunksize), fFilledBins(0), fBinIndex(new THnSparseBinIndex), fCompactCoord(0)
 {
    fCompactCoord = new THnSparseCompactBinCoord(dim, nbins);
    fBinContent.SetOwner();
@@ -614,6 +741,7 @@ THnSparse::THnSparse(const char* name, const char* title, Int_t dim,
 /// Destruct a THnSparse
 
 THnSparse::~THnSparse() {
+   delete fBinIndex;
    delete fCompactCoord;
 }
 
@@ -650,35 +778,22 @@ void THnSparse::InitStorage(Int_t* nbins, Int_t chunkSize)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-///We have been streamed; set up fBins
+///We have been streamed; set up fBinIndex
 
-void THnSparse::FillExMap()
+void THnSparse::FillBinIndex()
 {
    TIter iChunk(&fBinContent);
    THnSparseArrayChunk* chunk = 0;
    THnSparseCoordCompression compactCoord(*GetCompactCoord());
    Long64_t idx = 0;
-   if (2 * GetNbins() > fBins.Capacity())
-      fBins.Expand(3 * GetNbins());
+   fBinIndex->Reserve(GetNbins());
    while ((chunk = (THnSparseArrayChunk*) iChunk())) {
       const Int_t chunkSize = chunk->GetEntries();
       Char_t* buf = chunk->fCoordinates;
       const Int_t singleCoordSize = chunk->fSingleCoordinateSize;
       const Char_t* endbuf = buf + singleCoordSize * chunkSize;
       for (; buf < endbuf; buf += singleCoordSize, ++idx) {
-         Long64_t hash = compactCoord.GetHashFromBuffer(buf);
-         Long64_t linidx = fBins.GetValue(hash);
-         if (linidx) {
-            Long64_t nextidx = linidx;
-            while (nextidx) {
-               // must be a collision, so go to fBinsContinued.
-               linidx = nextidx;
-               nextidx = fBinsContinued.GetValue(linidx);
-            }
-            fBinsContinued.Add(linidx, idx + 1);
-         } else {
-            fBins.Add(hash, idx + 1);
-         }
+         fBinIndex->Insert(compactCoord.GetHashFromBuffer(buf), idx);
       }
    }
 }
@@ -687,12 +802,10 @@ void THnSparse::FillExMap()
 /// Initialize storage for nbins
 
 void THnSparse::Reserve(Long64_t nbins) {
-   if (!fBins.GetSize() && fBinContent.GetSize()) {
-      FillExMap();
-   }
-   if (2 * nbins > fBins.Capacity()) {
-      fBins.Expand(3 * nbins);
+   if (!fBinIndex->GetSize() && GetNbins()) {
+      FillBinIndex();
    }
+   fBinIndex->Reserve(nbins);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -790,21 +903,21 @@ Double_t THnSparse::GetBinError2(Long64_t linidx) const {
 Long64_t THnSparse::GetBinIndexForCurrentBin(Bool_t allocate)
 {
    THnSparseCompactBinCoord* cc = GetCompactCoord();
-   ULong64_t hash = cc->GetHash();
-   if (fBinContent.GetSize() && !fBins.GetSize())
-      FillExMap();
-   Long64_t linidx = (Long64_t) fBins.GetValue(hash);
-   while (linidx) {
-      // fBins stores index + 1!
-      THnSparseArrayChunk* chunk = GetChunk((linidx - 1)/ fChunkSize);
-      if (chunk->Matches((linidx - 1) % fChunkSize, cc->GetBuffer()))
-         return linidx - 1; // we store idx+1, 0 is "TExMap: not found"
+   return GetBinIndex(cc->GetHash(), cc->GetBuffer(), allocate);
+}
 
-      Long64_t nextlinidx = fBinsContinued.GetValue(linidx);
-      if (!nextlinidx) break;
+////////////////////////////////////////////////////////////////////////////////
+/// Return the index of the bin with compact coordinates buf and hash "hash".
+/// If it doesn't exist then return -1, or allocate a new bin if allocate is set
 
-      linidx = nextlinidx;
-   }
+Long64_t THnSparse::GetBinIndex(ULong64_t hash, const Char_t* buf, Bool_t allocate)
+{
+   if (GetNbins() && !fBinIndex->GetSize())
+      FillBinIndex();
+   Long64_t linidx = fBinIndex->Find(hash, [this, buf](Long64_t idx) {
+      return GetChunk(idx / fChunkSize)->Matches(idx % fChunkSize, buf);
+   });
+   if (linidx >= 0) return linidx;
    if (!allocate) return -1;
 
    ++fFilledBins;
@@ -816,23 +929,53 @@ Long64_t THnSparse::GetBinIndexForCurrentBin(Bool_t allocate)
       chunk = AddChunk();
       newidx = 0;
    }
-   chunk->AddBin(newidx, cc->GetBuffer());
+   chunk->AddBin(newidx, buf);
 
    // store translation between hash and bin
    newidx += (fBinContent.GetEntriesFast() - 1) * fChunkSize;
-   if (!linidx) {
-      // fBins didn't find it
-      if (2 * GetNbins() > fBins.Capacity())
-         fBins.Expand(3 * GetNbins());
-      fBins.Add(hash, newidx + 1);
-   } else {
-      // fBins contains one, but it's the wrong one;
-      // add entry to fBinsContinued.
-      fBinsContinued.Add(linidx, newidx + 1);
-   }
+   fBinIndex->Insert(hash, newidx);
    return newidx;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Fill the n entries x[i * GetNdimensions() + d], d = 0..GetNdimensions()-1,
+/// with the weights w[i] (1 if w is 0).
+///
+/// The result is the same as calling Fill(x + i * GetNdimensions(), w[i])
+/// for each entry; the entries are processed by batches, the lookups of the
+/// entries of a batch are started (their first slot in the hash table is
+/// prefetched) before the bins are filled.
+
+void THnSparse::FillN(Int_t n, const Double_t* x, const Double_t* w /*= 0*/)
+{
+   const Int_t kBatch = 16;
+   THnSparseCompactBinCoord* cc = GetCompactCoord();
+   // SetBufferFromCoord writes at least 8 bytes
+   const Int_t bufSize = TMath::Max(cc->GetBufferSize(), (Int_t)sizeof(Long64_t));
+   std::vector<Int_t> coord(fNdimensions);
+   std::vector<Char_t> bufs(kBatch * bufSize);
+   ULong64_t hashes[kBatch];
+   if (GetNbins() && !fBinIndex->GetSize())
+      FillBinIndex();
+
+   for (Int_t first = 0; first < n; first += kBatch) {
+      const Int_t nbatch = TMath::Min(kBatch, n - first);
+      for (Int_t i = 0; i < nbatch; ++i) {
+         const Double_t* xi = x + (Long64_t)(first + i) * fNdimensions;
+         for (Int_t d = 0; d < fNdimensions; ++d)
+            coord[d] = GetAxis(d)->FindBin(xi[d]);
+         hashes[i] = cc->SetBufferFromCoord(&coord[0], &bufs[i * bufSize]);
+         Prefetch(fBinIndex->GetFirstSlot(hashes[i]));
+      }
+      for (Int_t i = 0; i < nbatch; ++i) {
+         const Double_t* xi = x + (Long64_t)(first + i) * fNdimensions;
+         const Double_t wi = w ? w[first + i] : 1.;
+         UpdateXStat(xi, wi);
+         FillBin(GetBinIndex(hashes[i], &bufs[i * bufSize], kTRUE), wi);
+      }
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return THnSparseCompactBinCoord object.
 
@@ -881,7 +1024,7 @@ Double_t THnSparse::GetSparseFractionMem() const {
 
    Double_t size = 0.;
    size += fBinContent.GetEntries() * (GetChunkSize() * sizePerChunkElement + sizeof(THnSparseArrayChunk));
-   size += + 3 * sizeof(Long64_t) * fBins.GetSize() /* TExMap */;
+   size += fBinIndex->GetMemorySize();
 
    Double_t nbinsTotal = 1.;
    for (Int_t d = 0; d < fNdimensions; ++d)
@@ -963,9 +1106,82 @@ void THnSparse::Sumw2()
 void THnSparse::Reset(Option_t *option /*= ""*/)
 {
    fFilledBins = 0;
-   fBins.Delete();
-   fBinsContinued.Clear();
+   fBinIndex->Clear();
    fBinContent.Delete();
    ResetBase(option);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Merge this with a list of THnBase's. All THnBase's provided
+/// in the list must have the same bin layout!
+///
+/// If GetMergeThreads() is larger than 1 and the list holds at least four
+/// histograms, the list is split in as many parts (of at least two
+/// histograms each), which are added in parallel into empty copies of this
+/// histogram; the partial sums are then added to this histogram. The bin
+/// contents are the same as with THnBase::Merge(), up to the order of the
+/// additions.
+
+Long64_t THnSparse::Merge(TCollection* list)
+{
+   if (!list) return 0;
+   if (list->IsEmpty()) return (Long64_t)GetEntries();
+
+   std::vector<const THnBase*> inputs;
+   TIter iter(list);
+   const TObject* addMeObj = 0;
+   while ((addMeObj = iter())) {
+      const THnBase* addMe = dynamic_cast<const THnBase*>(addMeObj);
+      if (addMe) inputs.push_back(addMe);
+   }
+   const Int_t nparts = TMath::Min(fgMergeThreads, (Int_t)inputs.size() / 2);
+   if (nparts < 2)
+      return THnBase::Merge(list);
+
+   iter.Reset();
+   while ((addMeObj = iter())) {
+      if (!dynamic_cast<const THnBase*>(addMeObj))
+         Error("Merge", "Object named %s is not THnBase! Skipping it.",
+               addMeObj->GetName());
+   }
+
+   // The partial sums are created here: TClass::New is not for the threads.
+   std::vector<THnSparse*> sums(nparts);
+   for (Int_t p = 0; p < nparts; ++p)
+      sums[p] = (THnSparse*) CloneEmpty(GetName(), GetTitle(), GetListOfAxes(), kTRUE);
+   std::vector<std::thread> threads;
+   for (Int_t p = 0; p < nparts; ++p) {
+      const size_t first = inputs.size() * p / nparts;
+      const size_t last = inputs.size() * (p + 1) / nparts;
+      THnSparse* sum = sums[p];
+      threads.push_back(std::thread([sum, &inputs, first, last]() {
+         Long64_t nbins = 0;
+         for (size_t i = first; i < last; ++i) nbins += inputs[i]->GetNbins();
+         sum->Reserve(nbins);
+         for (size_t i = first; i < last; ++i) sum->Add(inputs[i]);
+      }));
+   }
+   for (Int_t p = 0; p < nparts; ++p) threads[p].join();
+
+   Long64_t sumNbins = GetNbins();
+   for (Int_t p = 0; p < nparts; ++p) sumNbins += sums[p]->GetNbins();
+   Reserve(sumNbins);
+   for (Int_t p = 0; p < nparts; ++p) {
+      Add(sums[p]);
+      delete sums[p];
+   }
+   return (Long64_t)GetEntries();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Set the number of threads used by Merge() to add the histograms of
+/// its list; 0 means the number of cores, 1 (the default) adds them
+/// sequentially.
+
+void THnSparse::SetMergeThreads(Int_t nthreads /*= 0*/)
+{
+   if (nthreads <= 0)
+      nthreads = std::thread::hardware_concurrency();
+   fgMergeThreads = nthreads > 0 ? nthreads : 1;
+}
+
@@ -318,6 +318,8 @@ public:
    static void    SetGlobalWriteParam(Int_t mapsize);
    static Int_t   GetGlobalReadParam();
    static Int_t   GetGlobalWriteParam();
+   static const char *GetByteSwapKernels();
+   static Bool_t  SetByteSwapKernels(const char *name = "");
 
    ClassDef(TBufferFile,0)  //concrete implementation of TBuffer for writing/reading to/from a ROOT file or socket.
 };
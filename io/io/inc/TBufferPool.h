@@ -0,0 +1,57 @@
+// @(#)root/io:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2015, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TBufferPool
+#define ROOT_TBufferPool
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TBufferPool                                                          //
+//                                                                      //
+// Pool of the I/O buffers of the baskets and of the read caches. The   //
+// buffers are rounded up to size classes; a buffer released is kept   //
+// for a later allocation of the same class, in a small cache of the    //
+// releasing thread or in the pool, as long as the memory kept stays    //
+// below a bound.                                                       //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef ROOT_Rtypes
+#include "Rtypes.h"
+#endif
+
+class TBuffer;
+
+class TBufferPool {
+
+public:
+   static void      Adopt(TBuffer *buffer, char *block, Long64_t size);
+   static char     *Allocate(Long64_t size);
+   static void      Attach(TBuffer *buffer, Long64_t size);
+   static void      Clear();
+   static void      Detach(TBuffer *buffer);
+   static Long64_t  GetAllocatedBytes();
+   static Long64_t  GetCachedBytes();
+   static Long64_t  GetCapacity(const char *buffer);
+   static Long64_t  GetMaxCachedBytes();
+   static Long64_t  GetNhits();
+   static Long64_t  GetNmisses();
+   static Long64_t  GetPeakBytes();
+   static Bool_t    IsPooled(const TBuffer *buffer);
+   static void      Print();
+   static char     *ReAllocChar(char *buffer, size_t newsize, size_t oldsize);
+   static void      Release(char *buffer);
+   static void      ResetStats();
+   static void      SetMaxCachedBytes(Long64_t maxbytes);
+
+   ClassDef(TBufferPool,0)  //Pool of the I/O buffers of the baskets and read caches
+};
+
+#endif
@@ -25,11 +25,19 @@
 #include "TDirectory.h"
 #endif
 
+#include <atomic>
+
 class TList;
 class TBrowser;
 class TKey;
 class TFile;
 
+namespace ROOT {
+namespace Internal {
+   class TKeyIndex;
+}
+}
+
 class TDirectoryFile : public TDirectory {
 
 protected:
@@ -45,9 +53,14 @@ protected:
    Long64_t    fSeekKeys;        ///< Location of Keys record on file
    TFile      *fFile;            ///< Pointer to current file in memory
    TList      *fKeys;            ///< Pointer to keys list in memory
+   ROOT::Internal::TKeyIndex *fKeyIndex; ///<!Index of the keys read from the file, 0 once they are all in fKeys
+
+   static std::atomic<Int_t> fgKeyIndexThreshold; ///<Number of keys from which a directory read from a file is indexed (-1: not yet set)
 
    virtual void         CleanTargets();
    void Init(TClass *cl = 0);
+   void LoadKeys() const;
+   TKey *LookupKey(const char *name, Short_t cycle) const;
 
 private:
    TDirectoryFile(const TDirectoryFile &directory);  //Directories cannot be copied
@@ -88,10 +101,10 @@ public:
    const TDatime      &GetCreationDate() const { return fDatimeC; }
    virtual TFile      *GetFile() const { return fFile; }
    virtual TKey       *GetKey(const char *name, Short_t cycle=9999) const;
-   virtual TList      *GetListOfKeys() const { return fKeys; }
+   virtual TList      *GetListOfKeys() const { if (fKeyIndex) LoadKeys(); return fKeys; }
    const TDatime      &GetModificationDate() const { return fDatimeM; }
    virtual Int_t       GetNbytesKeys() const { return fNbytesKeys; }
-   virtual Int_t       GetNkeys() const { return fKeys->GetSize(); }
+   virtual Int_t       GetNkeys() const;
    virtual Long64_t    GetSeekDir() const { return fSeekDir; }
    virtual Long64_t    GetSeekParent() const { return fSeekParent; }
    virtual Long64_t    GetSeekKeys() const { return fSeekKeys; }
@@ -125,6 +138,9 @@ public:
    virtual void        WriteDirHeader();
    virtual void        WriteKeys();
 
+   static Int_t        GetKeyIndexThreshold();
+   static void         SetKeyIndexThreshold(Int_t nkeys = 10000);
+
    ClassDef(TDirectoryFile,5)  //Describe directory structure in a ROOT file
 };
 
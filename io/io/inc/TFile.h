@@ -86,6 +86,8 @@ protected:
    TMap            *fCacheReadMap;   ///<!Pointer to the read cache (if any)
    TFileCacheWrite *fCacheWrite;     ///<!Pointer to the write cache (if any)
    Long64_t         fArchiveOffset;  ///<!Offset at which file starts in archive
+   char            *fMapped;         ///<!Memory mapping of the file (option MMAP), 0 if not mapped
+   Long64_t         fMappedSize;     ///<!Size of the memory mapping
    Bool_t           fIsArchive : 1;  ///<!True if this is a pure archive file
    Bool_t           fNoAnchorInName : 1; ///<!True if we don't want to force the anchor to be appended to the file name
    Bool_t           fIsRootFile : 1; ///<!True is this is a ROOT file, raw file otherwise
@@ -112,11 +114,15 @@ protected:
    static std::atomic<Long64_t>  fgFileCounter;           ///<Counter for all opened files
    static std::atomic<Int_t>     fgReadCalls;             ///<Number of bytes read from all TFile objects
    static Int_t     fgReadaheadSize;         ///<Readahead buffer size
+   static std::atomic<Int_t>     fgReadQueueDepth;        ///<Number of reads kept in flight by ReadBuffers for local files (-1: not yet set)
    static Bool_t    fgReadInfo;              ///<if true (default) ReadStreamerInfo is called when opening a file
    virtual EAsyncOpenStatus GetAsyncOpenStatus() { return fAsyncOpenStatus; }
    virtual void  Init(Bool_t create);
    Bool_t        FlushWriteCache();
    Int_t         ReadBufferViaCache(char *buf, Int_t len);
+   Bool_t        ReadBuffersParallel(char *buf, Long64_t *pos, Int_t *len, Int_t nbuf);
+   void          MapFile();
+   void          UnmapFile();
    Int_t         WriteBufferViaCache(const char *buf, Int_t len);
 
    // Creating projects
@@ -217,6 +223,7 @@ public:
    virtual void        IncrementProcessIDs() { fNProcessIDs++; }
    virtual Bool_t      IsArchive() const { return fIsArchive; }
            Bool_t      IsBinary() const { return TestBit(kBinaryFile); }
+           Bool_t      IsMapped() const { return fMapped != 0; }
            Bool_t      IsRaw() const { return !fIsRootFile; }
    virtual Bool_t      IsOpen() const;
    virtual void        ls(Option_t *option="") const;
@@ -232,6 +239,7 @@ public:
    virtual Bool_t      ReadBuffer(char *buf, Int_t len);
    virtual Bool_t      ReadBuffer(char *buf, Long64_t pos, Int_t len);
    virtual Bool_t      ReadBuffers(char *buf, Long64_t *pos, Int_t *len, Int_t nbuf);
+   char               *ReadBufferMapped(Long64_t pos, Int_t len);
    virtual void        ReadFree();
    virtual TProcessID *ReadProcessID(UShort_t pidf);
    virtual void        ReadStreamerInfo();
@@ -277,11 +285,13 @@ public:
    static Long64_t     GetFileBytesWritten();
    static Int_t        GetFileReadCalls();
    static Int_t        GetReadaheadSize();
+   static Int_t        GetReadQueueDepth();
 
    static void         SetFileBytesRead(Long64_t bytes = 0);
    static void         SetFileBytesWritten(Long64_t bytes = 0);
    static void         SetFileReadCalls(Int_t readcalls = 0);
    static void         SetReadaheadSize(Int_t bufsize = 256000);
+   static void         SetReadQueueDepth(Int_t depth = 16);
    static void         SetReadStreamerInfo(Bool_t readinfo=kTRUE);
    static Bool_t       GetReadStreamerInfo();
 
@@ -128,10 +128,14 @@ namespace TStreamerInfoActions {
    };
 
    typedef std::vector<TConfiguredAction> ActionContainer_t;
+
+   /// Signature of the functions compiled for a whole sequence, see TActionSequence::JitCompile.
+   typedef Int_t (*TStreamerInfoCompiledAction_t)(TBuffer &buf, void *obj, const TConfiguredAction *actions);
+
    class TActionSequence : public TObject {
-      TActionSequence() {};
+      TActionSequence() : fStreamerInfo(0), fLoopConfig(0), fCompiledAction(0) {};
    public:
-      TActionSequence(TVirtualStreamerInfo *info, UInt_t maxdata) : fStreamerInfo(info), fLoopConfig(0) { fActions.reserve(maxdata); };
+      TActionSequence(TVirtualStreamerInfo *info, UInt_t maxdata) : fStreamerInfo(info), fLoopConfig(0), fCompiledAction(0) { fActions.reserve(maxdata); };
       ~TActionSequence() {
          delete fLoopConfig;
       }
@@ -147,8 +151,13 @@ namespace TStreamerInfoActions {
       TVirtualStreamerInfo *fStreamerInfo; ///< StreamerInfo used to derive these actions.
       TLoopConfiguration   *fLoopConfig;   ///< If this is a bundle of memberwise streaming action, this configures the looping
       ActionContainer_t     fActions;
+      ActionContainer_t     fBulkActions;    ///<! fActions with the runs of basic types fused, used by TBufferFile when not empty (see Fuse)
+      TStreamerInfoCompiledAction_t fCompiledAction; ///<! Function streaming the whole sequence, used by TBufferFile when set (see JitCompile)
 
       void AddToOffset(Int_t delta);
+      Bool_t Fuse();
+      Bool_t JitCompile();
+      void ResetOptimization();
 
       TActionSequence *CreateCopy();
       static TActionSequence *CreateReadMemberWiseActions(TVirtualStreamerInfo *info, TVirtualCollectionProxy &proxy);
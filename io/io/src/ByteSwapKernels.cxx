@@ -0,0 +1,228 @@
+// @(#)root/io:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2015, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// ByteSwapKernels                                                      //
+//                                                                      //
+// Array byte swapping used by TBufferFile, see ByteSwapKernels.h.      //
+//                                                                      //
+// Three sets of kernels are provided: "scalar" (portable loops that    //
+// the compiler may vectorize for the baseline instruction set),        //
+// "ssse3" (16 bytes per PSHUFB) and "avx2" (32 bytes per VPSHUFB).     //
+// The SIMD kernels are compiled with function specific target          //
+// attributes, so that the library still runs on any x86 processor;    //
+// the best set supported by the processor is selected the first time   //
+// a kernel is called.                                                  //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#include "ByteSwapKernels.h"
+
+#include <atomic>
+#include <string.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && !defined(__INTEL_COMPILER) && \
+    ((defined(__clang__) && __clang_major__ >= 4) || \
+     (!defined(__clang__) && defined(__GNUC__) && __GNUC__ >= 5))
+#define R__BSWAP_X86_DISPATCH
+#include <immintrin.h>
+#endif
+
+namespace {
+
+typedef void (*SwapCopy_t)(void *to, const void *from, Long64_t n);
+typedef Long64_t (*Shuffle_t)(unsigned char *to, const unsigned char *from, Long64_t nbytes, const char *pattern);
+
+struct TKernels {
+   const char *fName;
+   SwapCopy_t  fCopy16;
+   SwapCopy_t  fCopy32;
+   SwapCopy_t  fCopy64;
+};
+
+inline UShort_t Swap(UShort_t v)
+{
+   return (UShort_t)((v << 8) | (v >> 8));
+}
+
+inline UInt_t Swap(UInt_t v)
+{
+   return ((v & 0x000000ffU) << 24) | ((v & 0x0000ff00U) <<  8) |
+          ((v & 0x00ff0000U) >>  8) | ((v & 0xff000000U) >> 24);
+}
+
+inline ULong64_t Swap(ULong64_t v)
+{
+   return ((ULong64_t)Swap((UInt_t)v) << 32) | Swap((UInt_t)(v >> 32));
+}
+
+// Position of the source byte for each byte of a 16 bytes vector.
+const char kPattern16[16] = { 1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14 };
+const char kPattern32[16] = { 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12 };
+const char kPattern64[16] = { 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8 };
+
+template <typename T> const char *Pattern();
+template <> const char *Pattern<UShort_t>()  { return kPattern16; }
+template <> const char *Pattern<UInt_t>()    { return kPattern32; }
+template <> const char *Pattern<ULong64_t>() { return kPattern64; }
+
+////////////////////////////////////////////////////////////////////////////////
+/// No vector unit: leave all the work to the scalar loop.
+
+Long64_t ShuffleNone(unsigned char *, const unsigned char *, Long64_t, const char *)
+{
+   return 0;
+}
+
+#ifdef R__BSWAP_X86_DISPATCH
+////////////////////////////////////////////////////////////////////////////////
+/// Shuffle the bytes of from into to, 16 bytes at a time; return the
+/// number of bytes processed.
+
+__attribute__((target("ssse3")))
+Long64_t ShuffleSSSE3(unsigned char *to, const unsigned char *from, Long64_t nbytes, const char *pattern)
+{
+   const __m128i mask = _mm_loadu_si128((const __m128i*)pattern);
+   Long64_t i = 0;
+   for (; i + 16 <= nbytes; i += 16) {
+      __m128i v = _mm_loadu_si128((const __m128i*)(from + i));
+      _mm_storeu_si128((__m128i*)(to + i), _mm_shuffle_epi8(v, mask));
+   }
+   return i;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Shuffle the bytes of from into to, 64 bytes at a time; return the
+/// number of bytes processed. VPSHUFB works within each 128 bits lane,
+/// hence the same pattern is used for both lanes.
+
+__attribute__((target("avx2")))
+Long64_t ShuffleAVX2(unsigned char *to, const unsigned char *from, Long64_t nbytes, const char *pattern)
+{
+   const __m256i mask = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)pattern));
+   Long64_t i = 0;
+   for (; i + 64 <= nbytes; i += 64) {
+      __m256i v0 = _mm256_loadu_si256((const __m256i*)(from + i));
+      __m256i v1 = _mm256_loadu_si256((const __m256i*)(from + i + 32));
+      _mm256_storeu_si256((__m256i*)(to + i), _mm256_shuffle_epi8(v0, mask));
+      _mm256_storeu_si256((__m256i*)(to + i + 32), _mm256_shuffle_epi8(v1, mask));
+   }
+   for (; i + 32 <= nbytes; i += 32) {
+      __m256i v = _mm256_loadu_si256((const __m256i*)(from + i));
+      _mm256_storeu_si256((__m256i*)(to + i), _mm256_shuffle_epi8(v, mask));
+   }
+   return i;
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+/// Byte swap n elements of type T from from to to: the vector kernel
+/// shuffle handles the bulk of the array and a scalar loop the rest.
+
+template <typename T, Shuffle_t shuffle>
+void SwapCopy(void *to, const void *from, Long64_t n)
+{
+   unsigned char *t = (unsigned char*)to;
+   const unsigned char *f = (const unsigned char*)from;
+   Long64_t done = shuffle(t, f, n * (Long64_t)sizeof(T), Pattern<T>()) / sizeof(T);
+   for (Long64_t i = done; i < n; ++i) {
+      T v;
+      memcpy(&v, f + i * sizeof(T), sizeof(T));
+      v = Swap(v);
+      memcpy(t + i * sizeof(T), &v, sizeof(T));
+   }
+}
+
+const TKernels kScalar = { "scalar",
+   SwapCopy<UShort_t, ShuffleNone>, SwapCopy<UInt_t, ShuffleNone>, SwapCopy<ULong64_t, ShuffleNone> };
+
+#ifdef R__BSWAP_X86_DISPATCH
+const TKernels kSSSE3 = { "ssse3",
+   SwapCopy<UShort_t, ShuffleSSSE3>, SwapCopy<UInt_t, ShuffleSSSE3>, SwapCopy<ULong64_t, ShuffleSSSE3> };
+
+const TKernels kAVX2 = { "avx2",
+   SwapCopy<UShort_t, ShuffleAVX2>, SwapCopy<UInt_t, ShuffleAVX2>, SwapCopy<ULong64_t, ShuffleAVX2> };
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the kernels named name if the processor supports them, 0
+/// otherwise. An empty name selects the best kernels available.
+
+const TKernels *FindKernels(const char *name)
+{
+#ifdef R__BSWAP_X86_DISPATCH
+   __builtin_cpu_init();
+   Bool_t best = !name || !name[0];
+   if ((best || !strcmp(name, "avx2")) && __builtin_cpu_supports("avx2")) return &kAVX2;
+   if ((best || !strcmp(name, "ssse3")) && __builtin_cpu_supports("ssse3")) return &kSSSE3;
+   if (best || !strcmp(name, "scalar")) return &kScalar;
+#else
+   if (!name || !name[0] || !strcmp(name, "scalar")) return &kScalar;
+#endif
+   return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// The kernels in use, the best available ones unless changed by
+/// SetByteSwapKernels.
+
+std::atomic<const TKernels*> &Kernels()
+{
+   static std::atomic<const TKernels*> kernels(FindKernels(""));
+   return kernels;
+}
+
+} // unnamed namespace
+
+////////////////////////////////////////////////////////////////////////////////
+/// Copy the n 2 bytes elements of from to to, swapping their bytes.
+
+void ROOT::Internal::ByteSwapCopy16(void *to, const void *from, Long64_t n)
+{
+   Kernels().load(std::memory_order_relaxed)->fCopy16(to, from, n);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Copy the n 4 bytes elements of from to to, swapping their bytes.
+
+void ROOT::Internal::ByteSwapCopy32(void *to, const void *from, Long64_t n)
+{
+   Kernels().load(std::memory_order_relaxed)->fCopy32(to, from, n);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Copy the n 8 bytes elements of from to to, swapping their bytes.
+
+void ROOT::Internal::ByteSwapCopy64(void *to, const void *from, Long64_t n)
+{
+   Kernels().load(std::memory_order_relaxed)->fCopy64(to, from, n);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the name of the kernels in use: "avx2", "ssse3" or "scalar".
+
+const char *ROOT::Internal::GetByteSwapKernels()
+{
+   return Kernels().load(std::memory_order_relaxed)->fName;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Use the kernels named name ("avx2", "ssse3" or "scalar"; an empty name
+/// selects the best ones). Return kFALSE, and keep the current kernels, if
+/// they are unknown or not supported by the processor.
+
+Bool_t ROOT::Internal::SetByteSwapKernels(const char *name)
+{
+   const TKernels *kernels = FindKernels(name);
+   if (!kernels) return kFALSE;
+   Kernels().store(kernels, std::memory_order_relaxed);
+   return kTRUE;
+}
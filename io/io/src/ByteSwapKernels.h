@@ -0,0 +1,48 @@
+// @(#)root/io:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2015, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_ByteSwapKernels
+#define ROOT_ByteSwapKernels
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// ByteSwapKernels                                                      //
+//                                                                      //
+// Copy arrays of n elements of 2, 4 or 8 bytes while reversing the     //
+// order of the bytes of each element, i.e. convert them between the    //
+// network (big endian) byte order of the ROOT files and the byte order //
+// of a little endian host. The source and the destination may be the   //
+// same (in place conversion) but must not otherwise overlap; neither   //
+// has to be aligned.                                                   //
+//                                                                      //
+// On x86 the kernels use the SSSE3 or AVX2 shuffle instructions when   //
+// the processor supports them; the choice is made at run time, the     //
+// code being compiled for the baseline instruction set.                //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef ROOT_Rtypes
+#include "Rtypes.h"
+#endif
+
+namespace ROOT {
+namespace Internal {
+
+   void ByteSwapCopy16(void *to, const void *from, Long64_t n);
+   void ByteSwapCopy32(void *to, const void *from, Long64_t n);
+   void ByteSwapCopy64(void *to, const void *from, Long64_t n);
+
+   const char *GetByteSwapKernels();
+   Bool_t      SetByteSwapKernels(const char *name);
+
+} // namespace Internal
+} // namespace ROOT
+
+#endif
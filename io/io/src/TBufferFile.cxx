@@ -38,16 +38,7 @@ The concrete implementation of TBuffer for writing/reading to/from a ROOT file o
 #include "TInterpreter.h"
 #include "TVirtualMutex.h"
 #include "TArrayC.h"
-
-#if (defined(__linux) || defined(__APPLE__)) && defined(__i386__) && \
-     defined(__GNUC__)
-#define USE_BSWAPCPY
-#endif
-
-#ifdef USE_BSWAPCPY
-#include "Bswapcpy.h"
-#endif
-
+#include "ByteSwapKernels.h"
 
 const UInt_t kNullTag           = 0;
 const UInt_t kNewClassTag       = 0xFFFFFFFF;
@@ -57,6 +48,7 @@ const UInt_t kMaxMapCount       = 0x3FFFFFFE;  // last valid fMapCount and byte
 const Version_t kByteCountVMask = 0x4000;      // OR the version byte count with this
 const Version_t kMaxVersion     = 0x3FFF;      // highest possible version number
 const Int_t  kMapOffset         = 2;   // first 2 map entries are taken by null obj and self obj
+const Int_t  kSwapChunk         = 256; // number of truncated values converted at once
 
 Int_t TBufferFile::fgMapSize   = kMapSize;
 
@@ -234,6 +226,145 @@ static void frombufOld(char *&buf, Long_t *x)
    buf += sizeof(Long_t);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Copy n 4 bytes values from buf to x, converting them from the network
+/// byte order, and advance buf.
+
+static inline void frombuf32(char *&buf, void *x, Int_t n)
+{
+#ifdef R__BYTESWAP
+   ROOT::Internal::ByteSwapCopy32(x, buf, n);
+#else
+   memcpy(x, buf, 4*n);
+#endif
+   buf += 4*n;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Copy n 4 bytes values from x to buf, converting them to the network
+/// byte order, and advance buf.
+
+static inline void tobuf32(char *&buf, const void *x, Int_t n)
+{
+#ifdef R__BYTESWAP
+   ROOT::Internal::ByteSwapCopy32(buf, x, n);
+#else
+   memcpy(buf, x, 4*n);
+#endif
+   buf += 4*n;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read n doubles stored as floats, swapping them kSwapChunk at a time.
+
+static void frombufAsFloat(char *&buf, Double_t *d, Int_t n)
+{
+   Float_t afloat[kSwapChunk];
+   for (Int_t j = 0; j < n; j += kSwapChunk) {
+      Int_t m = n - j < kSwapChunk ? n - j : kSwapChunk;
+      frombuf32(buf, afloat, m);
+      for (Int_t k = 0; k < m; ++k) d[j+k] = (Double_t)afloat[k];
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write n doubles as floats, swapping them kSwapChunk at a time.
+
+static void tobufAsFloat(char *&buf, const Double_t *d, Int_t n)
+{
+   Float_t afloat[kSwapChunk];
+   for (Int_t j = 0; j < n; j += kSwapChunk) {
+      Int_t m = n - j < kSwapChunk ? n - j : kSwapChunk;
+      for (Int_t k = 0; k < m; ++k) afloat[k] = (Float_t)d[j+k];
+      tobuf32(buf, afloat, m);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read n values stored as integers normalized to a range (see
+/// TBufferFile::WriteFloat16), swapping them kSwapChunk at a time.
+
+template <typename T>
+static void frombufWithFactor(char *&buf, T *ptr, Int_t n, Double_t factor, Double_t minvalue)
+{
+   UInt_t aint[kSwapChunk];
+   for (Int_t j = 0; j < n; j += kSwapChunk) {
+      Int_t m = n - j < kSwapChunk ? n - j : kSwapChunk;
+      frombuf32(buf, aint, m);
+      for (Int_t k = 0; k < m; ++k) ptr[j+k] = (T)(aint[k]/factor + minvalue);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read n floats stored as an exponent (UChar_t) and a mantissa truncated
+/// to nbits (UShort_t, holding the sign), see TBufferFile::WriteFloat16.
+/// The bytes are decoded in place, without going through operator>>.
+
+template <typename T>
+static void frombufWithNbits(char *&buf, T *ptr, Int_t n, Int_t nbits)
+{
+   const UChar_t *b = (const UChar_t*)buf;
+   const UInt_t mask = (1<<(nbits+1))-1;
+   const UInt_t sign = 1<<(nbits+1);
+   for (Int_t i = 0; i < n; ++i, b += 3) {
+      UInt_t theMan = (b[1] << 8) | b[2];
+      // Setting the sign bit is the same as negating the float.
+      UInt_t bits = ((UInt_t)b[0] << 23) | ((theMan & mask) << (23-nbits)) | ((theMan & sign) ? 0x80000000U : 0U);
+      Float_t value;
+      memcpy(&value, &bits, sizeof(Float_t));
+      ptr[i] = (T)value;
+   }
+   buf += 3*n;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write n values normalized to the range [xmin,xmax] as integers (see
+/// TBufferFile::WriteFloat16), swapping them kSwapChunk at a time.
+
+template <typename T>
+static void tobufWithFactor(char *&buf, const T *ptr, Int_t n, Double_t factor, Double_t xmin, Double_t xmax)
+{
+   UInt_t aint[kSwapChunk];
+   for (Int_t j = 0; j < n; j += kSwapChunk) {
+      Int_t m = n - j < kSwapChunk ? n - j : kSwapChunk;
+      for (Int_t k = 0; k < m; ++k) {
+         T x = ptr[j+k];
+         if (x < xmin) x = xmin;
+         if (x > xmax) x = xmax;
+         aint[k] = UInt_t(0.5+factor*(x-xmin));
+      }
+      tobuf32(buf, aint, m);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write n floats as an exponent (UChar_t) and a mantissa truncated to
+/// nbits (UShort_t, holding the sign), see TBufferFile::WriteFloat16.
+/// The bytes are encoded in place, without going through operator<<.
+
+template <typename T>
+static void tobufWithNbits(char *&buf, const T *ptr, Int_t n, Int_t nbits)
+{
+   UChar_t *b = (UChar_t*)buf;
+   union {
+      Float_t fFloatValue;
+      Int_t   fIntValue;
+   };
+   for (Int_t i = 0; i < n; ++i, b += 3) {
+      fFloatValue = (Float_t)ptr[i];
+      UChar_t  theExp = (UChar_t)(0x000000ff & ((fIntValue<<1)>>24));
+      UShort_t theMan = ((1<<(nbits+1))-1) & (fIntValue>>(23-nbits-1));
+      theMan++;
+      theMan = theMan>>1;
+      if (theMan&1<<nbits) theMan = (1<<nbits) - 1;
+      if (fFloatValue < 0) theMan |= 1<<(nbits+1);
+      b[0] = theExp;
+      b[1] = (UChar_t)(theMan >> 8);
+      b[2] = (UChar_t)(theMan & 0xff);
+   }
+   buf += 3*n;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Read Long from TBuffer.
 
@@ -789,13 +920,8 @@ Int_t TBufferFile::ReadArray(Short_t *&h)
    if (!h) h = new Short_t[n];
 
 #ifdef R__BYTESWAP
-# ifdef USE_BSWAPCPY
-   bswapcpy16(h, fBufCur, n);
+   ROOT::Internal::ByteSwapCopy16(h, fBufCur, n);
    fBufCur += l;
-# else
-   for (int i = 0; i < n; i++)
-      frombuf(fBufCur, &h[i]);
-# endif
 #else
    memcpy(h, fBufCur, l);
    fBufCur += l;
@@ -822,13 +948,8 @@ Int_t TBufferFile::ReadArray(Int_t *&ii)
    if (!ii) ii = new Int_t[n];
 
 #ifdef R__BYTESWAP
-# ifdef USE_BSWAPCPY
-   bswapcpy32(ii, fBufCur, n);
+   ROOT::Internal::ByteSwapCopy32(ii, fBufCur, n);
    fBufCur += l;
-# else
-   for (int i = 0; i < n; i++)
-      frombuf(fBufCur, &ii[i]);
-# endif
 #else
    memcpy(ii, fBufCur, l);
    fBufCur += l;
@@ -881,8 +1002,8 @@ Int_t TBufferFile::ReadArray(Long64_t *&ll)
    if (!ll) ll = new Long64_t[n];
 
 #ifdef R__BYTESWAP
-   for (int i = 0; i < n; i++)
-      frombuf(fBufCur, &ll[i]);
+   ROOT::Internal::ByteSwapCopy64(ll, fBufCur, n);
+   fBufCur += l;
 #else
    memcpy(ll, fBufCur, l);
    fBufCur += l;
@@ -909,13 +1030,8 @@ Int_t TBufferFile::ReadArray(Float_t *&f)
    if (!f) f = new Float_t[n];
 
 #ifdef R__BYTESWAP
-# ifdef USE_BSWAPCPY
-   bswapcpy32(f, fBufCur, n);
+   ROOT::Internal::ByteSwapCopy32(f, fBufCur, n);
    fBufCur += l;
-# else
-   for (int i = 0; i < n; i++)
-      frombuf(fBufCur, &f[i]);
-# endif
 #else
    memcpy(f, fBufCur, l);
    fBufCur += l;
@@ -942,8 +1058,8 @@ Int_t TBufferFile::ReadArray(Double_t *&d)
    if (!d) d = new Double_t[n];
 
 #ifdef R__BYTESWAP
-   for (int i = 0; i < n; i++)
-      frombuf(fBufCur, &d[i]);
+   ROOT::Internal::ByteSwapCopy64(d, fBufCur, n);
+   fBufCur += l;
 #else
    memcpy(d, fBufCur, l);
    fBufCur += l;
@@ -1062,13 +1178,8 @@ Int_t TBufferFile::ReadStaticArray(Short_t *h)
    if (!h) return 0;
 
 #ifdef R__BYTESWAP
-# ifdef USE_BSWAPCPY
-   bswapcpy16(h, fBufCur, n);
+   ROOT::Internal::ByteSwapCopy16(h, fBufCur, n);
    fBufCur += l;
-# else
-   for (int i = 0; i < n; i++)
-      frombuf(fBufCur, &h[i]);
-# endif
 #else
    memcpy(h, fBufCur, l);
    fBufCur += l;
@@ -1094,13 +1205,8 @@ Int_t TBufferFile::ReadStaticArray(Int_t *ii)
    if (!ii) return 0;
 
 #ifdef R__BYTESWAP
-# ifdef USE_BSWAPCPY
-   bswapcpy32(ii, fBufCur, n);
-   fBufCur += sizeof(Int_t)*n;
-# else
-   for (int i = 0; i < n; i++)
-      frombuf(fBufCur, &ii[i]);
-# endif
+   ROOT::Internal::ByteSwapCopy32(ii, fBufCur, n);
+   fBufCur += l;
 #else
    memcpy(ii, fBufCur, l);
    fBufCur += l;
@@ -1151,8 +1257,8 @@ Int_t TBufferFile::ReadStaticArray(Long64_t *ll)
    if (!ll) return 0;
 
 #ifdef R__BYTESWAP
-   for (int i = 0; i < n; i++)
-      frombuf(fBufCur, &ll[i]);
+   ROOT::Internal::ByteSwapCopy64(ll, fBufCur, n);
+   fBufCur += l;
 #else
    memcpy(ll, fBufCur, l);
    fBufCur += l;
@@ -1178,13 +1284,8 @@ Int_t TBufferFile::ReadStaticArray(Float_t *f)
    if (!f) return 0;
 
 #ifdef R__BYTESWAP
-# ifdef USE_BSWAPCPY
-   bswapcpy32(f, fBufCur, n);
-   fBufCur += sizeof(Float_t)*n;
-# else
-   for (int i = 0; i < n; i++)
-      frombuf(fBufCur, &f[i]);
-# endif
+   ROOT::Internal::ByteSwapCopy32(f, fBufCur, n);
+   fBufCur += l;
 #else
    memcpy(f, fBufCur, l);
    fBufCur += l;
@@ -1210,8 +1311,8 @@ Int_t TBufferFile::ReadStaticArray(Double_t *d)
    if (!d) return 0;
 
 #ifdef R__BYTESWAP
-   for (int i = 0; i < n; i++)
-      frombuf(fBufCur, &d[i]);
+   ROOT::Internal::ByteSwapCopy64(d, fBufCur, n);
+   fBufCur += l;
 #else
    memcpy(d, fBufCur, l);
    fBufCur += l;
@@ -1328,13 +1429,8 @@ void TBufferFile::ReadFastArray(Short_t *h, Int_t n)
    if (n <= 0 || l > fBufSize) return;
 
 #ifdef R__BYTESWAP
-# ifdef USE_BSWAPCPY
-   bswapcpy16(h, fBufCur, n);
-   fBufCur += sizeof(Short_t)*n;
-# else
-   for (int i = 0; i < n; i++)
-      frombuf(fBufCur, &h[i]);
-# endif
+   ROOT::Internal::ByteSwapCopy16(h, fBufCur, n);
+   fBufCur += l;
 #else
    memcpy(h, fBufCur, l);
    fBufCur += l;
@@ -1350,13 +1446,8 @@ void TBufferFile::ReadFastArray(Int_t *ii, Int_t n)
    if (l <= 0 || l > fBufSize) return;
 
 #ifdef R__BYTESWAP
-# ifdef USE_BSWAPCPY
-   bswapcpy32(ii, fBufCur, n);
-   fBufCur += sizeof(Int_t)*n;
-# else
-   for (int i = 0; i < n; i++)
-      frombuf(fBufCur, &ii[i]);
-# endif
+   ROOT::Internal::ByteSwapCopy32(ii, fBufCur, n);
+   fBufCur += l;
 #else
    memcpy(ii, fBufCur, l);
    fBufCur += l;
@@ -1388,8 +1479,8 @@ void TBufferFile::ReadFastArray(Long64_t *ll, Int_t n)
    if (l <= 0 || l > fBufSize) return;
 
 #ifdef R__BYTESWAP
-   for (int i = 0; i < n; i++)
-      frombuf(fBufCur, &ll[i]);
+   ROOT::Internal::ByteSwapCopy64(ll, fBufCur, n);
+   fBufCur += l;
 #else
    memcpy(ll, fBufCur, l);
    fBufCur += l;
@@ -1405,13 +1496,8 @@ void TBufferFile::ReadFastArray(Float_t *f, Int_t n)
    if (l <= 0 || l > fBufSize) return;
 
 #ifdef R__BYTESWAP
-# ifdef USE_BSWAPCPY
-   bswapcpy32(f, fBufCur, n);
-   fBufCur += sizeof(Float_t)*n;
-# else
-   for (int i = 0; i < n; i++)
-      frombuf(fBufCur, &f[i]);
-# endif
+   ROOT::Internal::ByteSwapCopy32(f, fBufCur, n);
+   fBufCur += l;
 #else
    memcpy(f, fBufCur, l);
    fBufCur += l;
@@ -1427,8 +1513,8 @@ void TBufferFile::ReadFastArray(Double_t *d, Int_t n)
    if (l <= 0 || l > fBufSize) return;
 
 #ifdef R__BYTESWAP
-   for (int i = 0; i < n; i++)
-      frombuf(fBufCur, &d[i]);
+   ROOT::Internal::ByteSwapCopy64(d, fBufCur, n);
+   fBufCur += l;
 #else
    memcpy(d, fBufCur, l);
    fBufCur += l;
@@ -1445,33 +1531,14 @@ void TBufferFile::ReadFastArrayFloat16(Float_t *f, Int_t n, TStreamerElement *el
 
    if (ele && ele->GetFactor() != 0) {
       //a range was specified. We read an integer and convert it back to a float
-      Double_t xmin = ele->GetXmin();
-      Double_t factor = ele->GetFactor();
-      for (int j=0;j < n; j++) {
-         UInt_t aint; *this >> aint; f[j] = (Float_t)(aint/factor + xmin);
-      }
+      frombufWithFactor(fBufCur, f, n, ele->GetFactor(), ele->GetXmin());
    } else {
-      Int_t i;
       Int_t nbits = 0;
       if (ele) nbits = (Int_t)ele->GetXmin();
       if (!nbits) nbits = 12;
       //we read the exponent and the truncated mantissa of the float
       //and rebuild the new float.
-      union {
-         Float_t fFloatValue;
-         Int_t   fIntValue;
-      };
-      UChar_t  theExp;
-      UShort_t theMan;
-      for (i = 0; i < n; i++) {
-         *this >> theExp;
-         *this >> theMan;
-         fIntValue = theExp;
-         fIntValue <<= 23;
-         fIntValue |= (theMan & ((1<<(nbits+1))-1)) <<(23-nbits);
-         if(1<<(nbits+1) & theMan) fFloatValue = -fFloatValue;
-         f[i] = fFloatValue;
-      }
+      frombufWithNbits(fBufCur, f, n, nbits);
    }
 }
 
@@ -1484,9 +1551,7 @@ void TBufferFile::ReadFastArrayWithFactor(Float_t *ptr, Int_t n, Double_t factor
    if (n <= 0 || 3*n > fBufSize) return;
 
    //a range was specified. We read an integer and convert it back to a float
-   for (int j=0;j < n; j++) {
-      UInt_t aint; *this >> aint; ptr[j] = (Float_t)(aint/factor + minvalue);
-   }
+   frombufWithFactor(fBufCur, ptr, n, factor, minvalue);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1500,21 +1565,7 @@ void TBufferFile::ReadFastArrayWithNbits(Float_t *ptr, Int_t n, Int_t nbits)
    if (!nbits) nbits = 12;
    //we read the exponent and the truncated mantissa of the float
    //and rebuild the new float.
-   union {
-      Float_t fFloatValue;
-      Int_t   fIntValue;
-   };
-   UChar_t  theExp;
-   UShort_t theMan;
-   for (Int_t i = 0; i < n; i++) {
-      *this >> theExp;
-      *this >> theMan;
-      fIntValue = theExp;
-      fIntValue <<= 23;
-      fIntValue |= (theMan & ((1<<(nbits+1))-1)) <<(23-nbits);
-      if(1<<(nbits+1) & theMan) fFloatValue = -fFloatValue;
-      ptr[i] = fFloatValue;
-   }
+   frombufWithNbits(fBufCur, ptr, n, nbits);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1527,40 +1578,17 @@ void TBufferFile::ReadFastArrayDouble32(Double_t *d, Int_t n, TStreamerElement *
 
    if (ele && ele->GetFactor() != 0) {
       //a range was specified. We read an integer and convert it back to a double.
-      Double_t xmin = ele->GetXmin();
-      Double_t factor = ele->GetFactor();
-      for (int j=0;j < n; j++) {
-         UInt_t aint; *this >> aint; d[j] = (Double_t)(aint/factor + xmin);
-      }
+      frombufWithFactor(fBufCur, d, n, ele->GetFactor(), ele->GetXmin());
    } else {
-      Int_t i;
       Int_t nbits = 0;
       if (ele) nbits = (Int_t)ele->GetXmin();
       if (!nbits) {
          //we read a float and convert it to double
-         Float_t afloat;
-         for (i = 0; i < n; i++) {
-            *this >> afloat;
-            d[i] = (Double_t)afloat;
-         }
+         frombufAsFloat(fBufCur, d, n);
       } else {
          //we read the exponent and the truncated mantissa of the float
          //and rebuild the double.
-         union {
-            Float_t fFloatValue;
-            Int_t   fIntValue;
-         };
-         UChar_t  theExp;
-         UShort_t theMan;
-         for (i = 0; i < n; i++) {
-            *this >> theExp;
-            *this >> theMan;
-            fIntValue = theExp;
-            fIntValue <<= 23;
-            fIntValue |= (theMan & ((1<<(nbits+1))-1)) <<(23-nbits);
-            if (1<<(nbits+1) & theMan) fFloatValue = -fFloatValue;
-            d[i] = (Double_t)fFloatValue;
-         }
+         frombufWithNbits(fBufCur, d, n, nbits);
       }
    }
 }
@@ -1574,9 +1602,7 @@ void TBufferFile::ReadFastArrayWithFactor(Double_t *d, Int_t n, Double_t factor,
    if (n <= 0 || 3*n > fBufSize) return;
 
    //a range was specified. We read an integer and convert it back to a double.
-   for (int j=0;j < n; j++) {
-      UInt_t aint; *this >> aint; d[j] = (Double_t)(aint/factor + minvalue);
-   }
+   frombufWithFactor(fBufCur, d, n, factor, minvalue);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1589,29 +1615,11 @@ void TBufferFile::ReadFastArrayWithNbits(Double_t *d, Int_t n, Int_t nbits)
 
    if (!nbits) {
       //we read a float and convert it to double
-      Float_t afloat;
-      for (Int_t i = 0; i < n; i++) {
-         *this >> afloat;
-         d[i] = (Double_t)afloat;
-      }
+      frombufAsFloat(fBufCur, d, n);
    } else {
       //we read the exponent and the truncated mantissa of the float
       //and rebuild the double.
-      union {
-         Float_t fFloatValue;
-         Int_t   fIntValue;
-      };
-      UChar_t  theExp;
-      UShort_t theMan;
-      for (Int_t i = 0; i < n; i++) {
-         *this >> theExp;
-         *this >> theMan;
-         fIntValue = theExp;
-         fIntValue <<= 23;
-         fIntValue |= (theMan & ((1<<(nbits+1))-1)) <<(23-nbits);
-         if (1<<(nbits+1) & theMan) fFloatValue = -fFloatValue;
-         d[i] = (Double_t)fFloatValue;
-      }
+      frombufWithNbits(fBufCur, d, n, nbits);
    }
 }
 
@@ -1761,13 +1769,8 @@ void TBufferFile::WriteArray(const Short_t *h, Int_t n)
    if (fBufCur + l > fBufMax) AutoExpand(fBufSize+l);
 
 #ifdef R__BYTESWAP
-# ifdef USE_BSWAPCPY
-   bswapcpy16(fBufCur, h, n);
+   ROOT::Internal::ByteSwapCopy16(fBufCur, h, n);
    fBufCur += l;
-# else
-   for (int i = 0; i < n; i++)
-      tobuf(fBufCur, h[i]);
-# endif
 #else
    memcpy(fBufCur, h, l);
    fBufCur += l;
@@ -1791,13 +1794,8 @@ void TBufferFile::WriteArray(const Int_t *ii, Int_t n)
    if (fBufCur + l > fBufMax) AutoExpand(fBufSize+l);
 
 #ifdef R__BYTESWAP
-# ifdef USE_BSWAPCPY
-   bswapcpy32(fBufCur, ii, n);
+   ROOT::Internal::ByteSwapCopy32(fBufCur, ii, n);
    fBufCur += l;
-# else
-   for (int i = 0; i < n; i++)
-      tobuf(fBufCur, ii[i]);
-# endif
 #else
    memcpy(fBufCur, ii, l);
    fBufCur += l;
@@ -1859,8 +1857,8 @@ void TBufferFile::WriteArray(const Long64_t *ll, Int_t n)
    if (fBufCur + l > fBufMax) AutoExpand(fBufSize+l);
 
 #ifdef R__BYTESWAP
-   for (int i = 0; i < n; i++)
-      tobuf(fBufCur, ll[i]);
+   ROOT::Internal::ByteSwapCopy64(fBufCur, ll, n);
+   fBufCur += l;
 #else
    memcpy(fBufCur, ll, l);
    fBufCur += l;
@@ -1884,13 +1882,8 @@ void TBufferFile::WriteArray(const Float_t *f, Int_t n)
    if (fBufCur + l > fBufMax) AutoExpand(fBufSize+l);
 
 #ifdef R__BYTESWAP
-# ifdef USE_BSWAPCPY
-   bswapcpy32(fBufCur, f, n);
+   ROOT::Internal::ByteSwapCopy32(fBufCur, f, n);
    fBufCur += l;
-# else
-   for (int i = 0; i < n; i++)
-      tobuf(fBufCur, f[i]);
-# endif
 #else
    memcpy(fBufCur, f, l);
    fBufCur += l;
@@ -1914,8 +1907,8 @@ void TBufferFile::WriteArray(const Double_t *d, Int_t n)
    if (fBufCur + l > fBufMax) AutoExpand(fBufSize+l);
 
 #ifdef R__BYTESWAP
-   for (int i = 0; i < n; i++)
-      tobuf(fBufCur, d[i]);
+   ROOT::Internal::ByteSwapCopy64(fBufCur, d, n);
+   fBufCur += l;
 #else
    memcpy(fBufCur, d, l);
    fBufCur += l;
@@ -2027,13 +2020,8 @@ void TBufferFile::WriteFastArray(const Short_t *h, Int_t n)
    if (fBufCur + l > fBufMax) AutoExpand(fBufSize+l);
 
 #ifdef R__BYTESWAP
-# ifdef USE_BSWAPCPY
-   bswapcpy16(fBufCur, h, n);
+   ROOT::Internal::ByteSwapCopy16(fBufCur, h, n);
    fBufCur += l;
-# else
-   for (int i = 0; i < n; i++)
-      tobuf(fBufCur, h[i]);
-# endif
 #else
    memcpy(fBufCur, h, l);
    fBufCur += l;
@@ -2051,13 +2039,8 @@ void TBufferFile::WriteFastArray(const Int_t *ii, Int_t n)
    if (fBufCur + l > fBufMax) AutoExpand(fBufSize+l);
 
 #ifdef R__BYTESWAP
-# ifdef USE_BSWAPCPY
-   bswapcpy32(fBufCur, ii, n);
+   ROOT::Internal::ByteSwapCopy32(fBufCur, ii, n);
    fBufCur += l;
-# else
-   for (int i = 0; i < n; i++)
-      tobuf(fBufCur, ii[i]);
-# endif
 #else
    memcpy(fBufCur, ii, l);
    fBufCur += l;
@@ -2103,8 +2086,8 @@ void TBufferFile::WriteFastArray(const Long64_t *ll, Int_t n)
    if (fBufCur + l > fBufMax) AutoExpand(fBufSize+l);
 
 #ifdef R__BYTESWAP
-   for (int i = 0; i < n; i++)
-      tobuf(fBufCur, ll[i]);
+   ROOT::Internal::ByteSwapCopy64(fBufCur, ll, n);
+   fBufCur += l;
 #else
    memcpy(fBufCur, ll, l);
    fBufCur += l;
@@ -2122,13 +2105,8 @@ void TBufferFile::WriteFastArray(const Float_t *f, Int_t n)
    if (fBufCur + l > fBufMax) AutoExpand(fBufSize+l);
 
 #ifdef R__BYTESWAP
-# ifdef USE_BSWAPCPY
-   bswapcpy32(fBufCur, f, n);
+   ROOT::Internal::ByteSwapCopy32(fBufCur, f, n);
    fBufCur += l;
-# else
-   for (int i = 0; i < n; i++)
-      tobuf(fBufCur, f[i]);
-# endif
 #else
    memcpy(fBufCur, f, l);
    fBufCur += l;
@@ -2146,8 +2124,8 @@ void TBufferFile::WriteFastArray(const Double_t *d, Int_t n)
    if (fBufCur + l > fBufMax) AutoExpand(fBufSize+l);
 
 #ifdef R__BYTESWAP
-   for (int i = 0; i < n; i++)
-      tobuf(fBufCur, d[i]);
+   ROOT::Internal::ByteSwapCopy64(fBufCur, d, n);
+   fBufCur += l;
 #else
    memcpy(fBufCur, d, l);
    fBufCur += l;
@@ -2169,39 +2147,16 @@ void TBufferFile::WriteFastArrayFloat16(const Float_t *f, Int_t n, TStreamerElem
       //A range is specified. We normalize the float to the range and
       //convert it to an integer using a scaling factor that is a function of nbits.
       //see TStreamerElement::GetRange.
-      Double_t factor = ele->GetFactor();
-      Double_t xmin = ele->GetXmin();
-      Double_t xmax = ele->GetXmax();
-      for (int j = 0; j < n; j++) {
-         Float_t x = f[j];
-         if (x < xmin) x = xmin;
-         if (x > xmax) x = xmax;
-         UInt_t aint = UInt_t(0.5+factor*(x-xmin)); *this << aint;
-      }
+      tobufWithFactor(fBufCur, f, n, ele->GetFactor(), ele->GetXmin(), ele->GetXmax());
    } else {
       Int_t nbits = 0;
       //number of bits stored in fXmin (see TStreamerElement::GetRange)
       if (ele) nbits = (Int_t)ele->GetXmin();
       if (!nbits) nbits = 12;
-      Int_t i;
       //a range is not specified, but nbits is.
       //In this case we truncate the mantissa to nbits and we stream
       //the exponent as a UChar_t and the mantissa as a UShort_t.
-      union {
-         Float_t fFloatValue;
-         Int_t   fIntValue;
-      };
-      for (i = 0; i < n; i++) {
-         fFloatValue = f[i];
-         UChar_t  theExp = (UChar_t)(0x000000ff & ((fIntValue<<1)>>24));
-         UShort_t theMan = ((1<<(nbits+1))-1) & (fIntValue>>(23-nbits-1));
-         theMan++;
-         theMan = theMan>>1;
-         if (theMan&1<<nbits) theMan = (1<<nbits) - 1;
-         if (fFloatValue < 0) theMan |= 1<<(nbits+1);
-         *this << theExp;
-         *this << theMan;
-      }
+      tobufWithNbits(fBufCur, f, n, nbits);
    }
 }
 
@@ -2220,45 +2175,19 @@ void TBufferFile::WriteFastArrayDouble32(const Double_t *d, Int_t n, TStreamerEl
       //A range is specified. We normalize the double to the range and
       //convert it to an integer using a scaling factor that is a function of nbits.
       //see TStreamerElement::GetRange.
-      Double_t factor = ele->GetFactor();
-      Double_t xmin = ele->GetXmin();
-      Double_t xmax = ele->GetXmax();
-      for (int j = 0; j < n; j++) {
-         Double_t x = d[j];
-         if (x < xmin) x = xmin;
-         if (x > xmax) x = xmax;
-         UInt_t aint = UInt_t(0.5+factor*(x-xmin)); *this << aint;
-      }
+      tobufWithFactor(fBufCur, d, n, ele->GetFactor(), ele->GetXmin(), ele->GetXmax());
    } else {
       Int_t nbits = 0;
       //number of bits stored in fXmin (see TStreamerElement::GetRange)
       if (ele) nbits = (Int_t)ele->GetXmin();
-      Int_t i;
       if (!nbits) {
          //if no range and no bits specified, we convert from double to float
-         for (i = 0; i < n; i++) {
-            Float_t afloat = (Float_t)d[i];
-            *this << afloat;
-         }
+         tobufAsFloat(fBufCur, d, n);
       } else {
          //a range is not specified, but nbits is.
          //In this case we truncate the mantissa to nbits and we stream
          //the exponent as a UChar_t and the mantissa as a UShort_t.
-         union {
-            Float_t fFloatValue;
-            Int_t   fIntValue;
-         };
-         for (i = 0; i < n; i++) {
-            fFloatValue = (Float_t)d[i];
-            UChar_t  theExp = (UChar_t)(0x000000ff & ((fIntValue<<1)>>24));
-            UShort_t theMan = ((1<<(nbits+1))-1) & (fIntValue>>(23-nbits-1));
-            theMan++;
-            theMan = theMan>>1;
-            if(theMan&1<<nbits) theMan = (1<<nbits) - 1;
-            if (fFloatValue < 0) theMan |= 1<<(nbits+1);
-            *this << theExp;
-            *this << theMan;
-         }
+         tobufWithNbits(fBufCur, d, n, nbits);
       }
    }
 }
@@ -3930,9 +3859,18 @@ Int_t TBufferFile::WriteClassBuffer(const TClass *cl, void *pointer)
 ////////////////////////////////////////////////////////////////////////////////
 /// Read one collection of objects from the buffer using the StreamerInfoLoopAction.
 /// The collection needs to be a split TClonesArray or a split vector of pointers.
+///
+/// Unless gDebug is set, the function compiled for the sequence, or else its
+/// fused actions, are used when the sequence was optimized (see
+/// TClass::SetStreamerActionsMode). They call the TBufferFile functions
+/// directly, so that they are only used by a TBufferFile itself: the
+/// classes deriving from it run the actions of the members, which call
+/// the functions they override.
 
 Int_t TBufferFile::ApplySequence(const TStreamerInfoActions::TActionSequence &sequence, void *obj)
 {
+   const Bool_t optimized = (sequence.fCompiledAction || !sequence.fBulkActions.empty())
+                            && typeid(*this) == typeid(TBufferFile);
    if (gDebug) {
       //loop on all active members
       TStreamerInfoActions::ActionContainer_t::const_iterator end = sequence.fActions.end();
@@ -3943,10 +3881,15 @@ Int_t TBufferFile::ApplySequence(const TStreamerInfoActions::TActionSequence &se
          (*iter)(*this,obj);
       }
 
+   } else if (optimized && sequence.fCompiledAction) {
+      return sequence.fCompiledAction(*this, obj, &sequence.fActions[0]);
+
    } else {
+      const TStreamerInfoActions::ActionContainer_t &actions =
+         optimized ? sequence.fBulkActions : sequence.fActions;
       //loop on all active members
-      TStreamerInfoActions::ActionContainer_t::const_iterator end = sequence.fActions.end();
-      for(TStreamerInfoActions::ActionContainer_t::const_iterator iter = sequence.fActions.begin();
+      TStreamerInfoActions::ActionContainer_t::const_iterator end = actions.end();
+      for(TStreamerInfoActions::ActionContainer_t::const_iterator iter = actions.begin();
           iter != end;
           ++iter) {
          (*iter)(*this,obj);
@@ -4068,3 +4011,25 @@ Int_t TBufferFile::GetGlobalWriteParam()
 {
    return fgMapSize;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the name of the kernels used to convert the arrays between the
+/// byte order of the host and the network byte order of the buffer:
+/// "avx2", "ssse3" or "scalar". The best kernels supported by the
+/// processor are selected at run time.
+
+const char *TBufferFile::GetByteSwapKernels()
+{
+   return ROOT::Internal::GetByteSwapKernels();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Select the kernels used to convert the arrays, "avx2", "ssse3" or
+/// "scalar" (the empty string selects the best available ones), for
+/// example to compare their performance. Return kFALSE, and keep the
+/// current kernels, if they are unknown or not supported by the processor.
+
+Bool_t TBufferFile::SetByteSwapKernels(const char *name)
+{
+   return ROOT::Internal::SetByteSwapKernels(name);
+}
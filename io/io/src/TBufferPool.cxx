@@ -0,0 +1,444 @@
+// @(#)root/io:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2015, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+/**
+\class TBufferPool
+\ingroup IO
+
+Pool of the I/O buffers of the baskets (TBasket), of the unzipping cache
+(TTreeCacheUnzip) and of the read caches (TFileCacheRead).
+
+Reading a tree allocates and frees one uncompressed buffer (and often one
+compressed buffer) per basket read, of sizes which vary from branch to
+branch; with thousands of branches this is a lot of allocations of large
+blocks, and fragments the memory. The pool hands out blocks whose size is
+rounded up to a size class (four classes per power of two, from 512 bytes
+to 64 MB, larger blocks are not pooled). A block released is kept for the
+next allocation of the same class:
+
+  - up to 4 blocks per class of at most 1 MB are kept in a cache of the
+    releasing thread, reused without any lock by this thread;
+  - the other ones are kept in the pool, shared by all the threads.
+
+The memory kept (cached) in the pool and the thread caches is bounded by
+SetMaxCachedBytes, by default by the resource TBufferPool.MaxCachedBytes
+(128 MB); a block released beyond the bound is freed. The blocks of a
+thread cache are given back to the pool when the thread ends.
+
+A TBuffer uses a block of the pool through Attach or Adopt: the block is
+not owned by the TBuffer but it is expanded with TBufferPool::ReAllocChar
+(see IsPooled); Detach releases it. GetNhits, GetNmisses and GetPeakBytes
+tell how well the pool works, Print shows all the statistics.
+*/
+
+#include "TBufferPool.h"
+#include "TBuffer.h"
+#include "TEnv.h"
+#include "TError.h"
+#include "TString.h"
+#include "ThreadLocalStorage.h"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <string.h>
+
+ClassImp(TBufferPool)
+
+namespace {
+
+const Int_t    kMinShift = 9;                 // The smallest class holds 512 bytes
+const Int_t    kMaxShift = 26;                // The largest class holds 64 MB
+const Int_t    kNsub = 4;                     // Number of classes per power of two
+const Int_t    kNclasses = (kMaxShift - kMinShift) * kNsub + 1;
+const Long64_t kMaxThreadCachedSize = 1 << 20; // Largest class kept in the thread caches
+const Int_t    kThreadCacheDepth = 4;         // Blocks per class in a thread cache
+const UInt_t   kUsedMagic = 0x7A5B00F1;
+const UInt_t   kFreeMagic = 0x7A5B00F0;
+
+// Header of a block, in front of the memory handed out (keeps it aligned
+// on 16 bytes).
+struct THeader {
+   Long64_t fCapacity;  // Size of the memory handed out
+   Int_t    fClass;     // Size class, -1 if larger than the largest class
+   UInt_t   fMagic;     // kUsedMagic while in use, kFreeMagic while cached
+};
+
+struct TPoolState {
+   std::mutex            fMutex;               // Protects fFree
+   std::vector<char*>    fFree[kNclasses];     // Blocks cached in the pool, by class
+   std::atomic<Long64_t> fMaxCached{-1};       // Bound of fCached, -1 until read from gEnv
+   std::atomic<Long64_t> fAllocated{0};        // Bytes of the blocks in use or cached
+   std::atomic<Long64_t> fCached{0};           // Bytes of the blocks cached
+   std::atomic<Long64_t> fPeak{0};             // Highest fAllocated
+   std::atomic<Long64_t> fNhits{0};            // Allocations of a cached block
+   std::atomic<Long64_t> fNmisses{0};          // Allocations of a new block
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the state of the pool; it is never deleted since baskets and
+/// thread caches may release blocks during the tear down of the process.
+
+TPoolState &GetState()
+{
+   static TPoolState *state = new TPoolState;
+   return *state;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the class of the blocks of size bytes, -1 if too large.
+
+Int_t GetClass(Long64_t size)
+{
+   if (size <= (1LL << kMinShift)) return 0;
+   Int_t e = kMinShift;
+   while ((1LL << (e + 1)) < size) ++e;
+   if (e >= kMaxShift) return -1;
+   // 2^e < size <= 2^(e+1)
+   Long64_t step = (1LL << e) / kNsub;
+   Int_t k = (Int_t)((size - (1LL << e) + step - 1) / step);
+   return (e - kMinShift) * kNsub + k;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the size of the blocks of class cl.
+
+Long64_t GetClassSize(Int_t cl)
+{
+   if (cl == 0) return 1LL << kMinShift;
+   Int_t e = kMinShift + (cl - 1) / kNsub;
+   Int_t k = (cl - 1) % kNsub + 1;
+   return (1LL << e) + k * ((1LL << e) / kNsub);
+}
+
+inline THeader *GetHeader(const char *buffer)
+{
+   return (THeader*)(buffer - sizeof(THeader));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Free the cached block, removing it from the statistics.
+
+void FreeCached(TPoolState &state, char *block)
+{
+   THeader *header = GetHeader(block);
+   state.fCached -= header->fCapacity;
+   state.fAllocated -= header->fCapacity;
+   header->fMagic = 0;
+   delete [] (char*)header;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Put the released block in the pool shared by the threads.
+
+void CacheInPool(TPoolState &state, Int_t cl, char *block)
+{
+   std::lock_guard<std::mutex> lock(state.fMutex);
+   state.fFree[cl].push_back(block);
+}
+
+// Set when the cache of the thread is destroyed, the blocks released by the
+// thread after this go to the pool.
+TTHREAD_TLS(Bool_t) gThreadCacheGone = kFALSE;
+
+struct TThreadCache {
+   char  *fBlocks[kNclasses][kThreadCacheDepth]; // Blocks cached, by class
+   Int_t  fN[kNclasses];                         // Number of blocks cached, by class
+
+   TThreadCache() { memset(fN, 0, sizeof(fN)); }
+   ~TThreadCache() {
+      TPoolState &state = GetState();
+      for (Int_t cl = 0; cl < kNclasses; ++cl) {
+         for (Int_t i = 0; i < fN[cl]; ++i) CacheInPool(state, cl, fBlocks[cl][i]);
+         fN[cl] = 0;
+      }
+      gThreadCacheGone = kTRUE;
+   }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the cache of the current thread, 0 if it is already destroyed.
+
+TThreadCache *GetThreadCache()
+{
+   if (gThreadCacheGone) return 0;
+   TTHREAD_TLS_DECL(TThreadCache, cache);
+   return &cache;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Free cached blocks, the largest first, until at most maxbytes are
+/// cached. The blocks cached by the other threads are not freed.
+
+void Trim(TPoolState &state, Long64_t maxbytes)
+{
+   if (state.fCached <= maxbytes) return;
+   TThreadCache *cache = GetThreadCache();
+   if (cache) {
+      for (Int_t cl = kNclasses - 1; cl >= 0 && state.fCached > maxbytes; --cl) {
+         while (cache->fN[cl] && state.fCached > maxbytes) FreeCached(state, cache->fBlocks[cl][--cache->fN[cl]]);
+      }
+   }
+   std::lock_guard<std::mutex> lock(state.fMutex);
+   for (Int_t cl = kNclasses - 1; cl >= 0 && state.fCached > maxbytes; --cl) {
+      std::vector<char*> &blocks = state.fFree[cl];
+      while (!blocks.empty() && state.fCached > maxbytes) {
+         FreeCached(state, blocks.back());
+         blocks.pop_back();
+      }
+   }
+}
+
+} // unnamed namespace
+
+////////////////////////////////////////////////////////////////////////////////
+/// Release the block used by buffer (if it comes from the pool) and make
+/// buffer use the block of the pool, of size bytes.
+
+void TBufferPool::Adopt(TBuffer *buffer, char *block, Long64_t size)
+{
+   Detach(buffer);
+   buffer->SetBuffer(block, size, kFALSE, &TBufferPool::ReAllocChar);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return a block of at least size bytes, to be given back with Release.
+/// Its content is undefined.
+
+char *TBufferPool::Allocate(Long64_t size)
+{
+   if (size < 0) size = 0;
+   TPoolState &state = GetState();
+   Int_t cl = GetClass(size);
+   if (cl >= 0) {
+      size = GetClassSize(cl);
+      char *block = 0;
+      TThreadCache *cache = size <= kMaxThreadCachedSize ? GetThreadCache() : 0;
+      if (cache && cache->fN[cl]) {
+         block = cache->fBlocks[cl][--cache->fN[cl]];
+      } else {
+         std::lock_guard<std::mutex> lock(state.fMutex);
+         std::vector<char*> &blocks = state.fFree[cl];
+         if (!blocks.empty()) {
+            block = blocks.back();
+            blocks.pop_back();
+         }
+      }
+      if (block) {
+         state.fCached -= size;
+         ++state.fNhits;
+         GetHeader(block)->fMagic = kUsedMagic;
+         return block;
+      }
+   }
+   ++state.fNmisses;
+   THeader *header = (THeader*) new char[sizeof(THeader) + size];
+   header->fCapacity = size;
+   header->fClass = cl;
+   header->fMagic = kUsedMagic;
+   Long64_t allocated = state.fAllocated += size;
+   Long64_t peak = state.fPeak;
+   while (allocated > peak && !state.fPeak.compare_exchange_weak(peak, allocated)) {}
+   return (char*)(header + 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Release the block used by buffer (if it comes from the pool) and make
+/// buffer use a block of the pool of at least size bytes.
+
+void TBufferPool::Attach(TBuffer *buffer, Long64_t size)
+{
+   char *block = Allocate(size);
+   Adopt(buffer, block, GetCapacity(block));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Free the blocks cached in the pool and in the cache of the current
+/// thread.
+
+void TBufferPool::Clear()
+{
+   Trim(GetState(), 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Release the block used by buffer if it comes from the pool; buffer is
+/// then left without memory.
+
+void TBufferPool::Detach(TBuffer *buffer)
+{
+   if (!IsPooled(buffer)) return;
+   char *block = buffer->Buffer();
+   buffer->SetBuffer(0, 0, kFALSE);
+   Release(block);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the number of bytes of the blocks allocated by the pool, in use
+/// or cached.
+
+Long64_t TBufferPool::GetAllocatedBytes()
+{
+   return GetState().fAllocated;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the number of bytes of the blocks cached for reuse.
+
+Long64_t TBufferPool::GetCachedBytes()
+{
+   return GetState().fCached;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the usable size of the block buffer, returned by Allocate.
+
+Long64_t TBufferPool::GetCapacity(const char *buffer)
+{
+   return buffer ? GetHeader(buffer)->fCapacity : 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the maximum number of bytes of the blocks cached for reuse.
+/// Unless set by SetMaxCachedBytes, it is taken from the resource
+/// TBufferPool.MaxCachedBytes (default 128 MB).
+
+Long64_t TBufferPool::GetMaxCachedBytes()
+{
+   TPoolState &state = GetState();
+   if (state.fMaxCached < 0) state.fMaxCached = (Long64_t)gEnv->GetValue("TBufferPool.MaxCachedBytes", 134217728.);
+   return state.fMaxCached;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the number of allocations served with a cached block.
+
+Long64_t TBufferPool::GetNhits()
+{
+   return GetState().fNhits;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the number of allocations which needed a new block.
+
+Long64_t TBufferPool::GetNmisses()
+{
+   return GetState().fNmisses;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the highest number of bytes allocated by the pool (see
+/// GetAllocatedBytes) since the start or the last ResetStats.
+
+Long64_t TBufferPool::GetPeakBytes()
+{
+   return GetState().fPeak;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return whether the memory of buffer is a block of the pool, given by
+/// Attach or Adopt.
+
+Bool_t TBufferPool::IsPooled(const TBuffer *buffer)
+{
+   return buffer && buffer->Buffer() && !buffer->TestBit(TBuffer::kIsOwner) &&
+          buffer->GetReAllocFunc() == &TBufferPool::ReAllocChar;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Print the statistics of the pool.
+
+void TBufferPool::Print()
+{
+   TPoolState &state = GetState();
+   Long64_t nhits = state.fNhits;
+   Long64_t nmisses = state.fNmisses;
+   Printf("TBufferPool: %lld allocations, %lld hits (%.1f%%), %lld misses", nhits + nmisses, nhits,
+          nhits + nmisses ? 100. * nhits / (nhits + nmisses) : 0., nmisses);
+   Printf("TBufferPool: %lld bytes allocated (peak %lld), %lld bytes cached (max %lld)",
+          (Long64_t)state.fAllocated, (Long64_t)state.fPeak, (Long64_t)state.fCached, GetMaxCachedBytes());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Reallocation function of the TBuffers using a block of the pool (see
+/// TBuffer::SetReAllocFunc): return a block of newsize bytes holding the
+/// first oldsize bytes of buffer (0 if the content is not needed) followed
+/// by zeros. The block is kept when newsize is of the same size class.
+
+char *TBufferPool::ReAllocChar(char *buffer, size_t newsize, size_t oldsize)
+{
+   if (!buffer) return Allocate(newsize);
+   THeader *header = GetHeader(buffer);
+   Long64_t capacity = header->fCapacity;
+   if ((Long64_t)oldsize > capacity) oldsize = capacity;
+   if ((Long64_t)newsize <= capacity && GetClass(newsize) == header->fClass) {
+      if (newsize > oldsize) memset(buffer + oldsize, 0, newsize - oldsize);
+      return buffer;
+   }
+   char *block = Allocate(newsize);
+   if (oldsize > newsize) oldsize = newsize;
+   memcpy(block, buffer, oldsize);
+   memset(block + oldsize, 0, newsize - oldsize);
+   Release(buffer);
+   return block;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Give back the block buffer, returned by Allocate. It is cached for reuse
+/// unless the bound of the cached memory would be exceeded.
+
+void TBufferPool::Release(char *buffer)
+{
+   if (!buffer) return;
+   THeader *header = GetHeader(buffer);
+   if (header->fMagic != kUsedMagic) {
+      ::Error("TBufferPool::Release", "The block %p was not allocated by the pool or is already released", buffer);
+      return;
+   }
+   TPoolState &state = GetState();
+   Long64_t capacity = header->fCapacity;
+   Int_t cl = header->fClass;
+   if (cl >= 0) {
+      if (state.fCached.fetch_add(capacity) + capacity <= GetMaxCachedBytes()) {
+         header->fMagic = kFreeMagic;
+         TThreadCache *cache = capacity <= kMaxThreadCachedSize ? GetThreadCache() : 0;
+         if (cache && cache->fN[cl] < kThreadCacheDepth) cache->fBlocks[cl][cache->fN[cl]++] = buffer;
+         else CacheInPool(state, cl, buffer);
+         return;
+      }
+      state.fCached -= capacity;
+   }
+   state.fAllocated -= capacity;
+   header->fMagic = 0;
+   delete [] (char*)header;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Reset the number of hits and misses; the peak is set to the current
+/// number of bytes allocated.
+
+void TBufferPool::ResetStats()
+{
+   TPoolState &state = GetState();
+   state.fNhits = 0;
+   state.fNmisses = 0;
+   state.fPeak = (Long64_t)state.fAllocated;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Set the maximum number of bytes of the blocks cached for reuse (0
+/// disables the reuse), freeing cached blocks if needed.
+
+void TBufferPool::SetMaxCachedBytes(Long64_t maxbytes)
+{
+   TPoolState &state = GetState();
+   state.fMaxCached = maxbytes < 0 ? 0 : maxbytes;
+   Trim(state, state.fMaxCached);
+}
@@ -45,10 +45,14 @@
 #include "TProcessUUID.h"
 #include "TVirtualMutex.h"
 #include "TEmulatedCollectionProxy.h"
+#include "TEnv.h"
+#include "TKeyIndex.h"
 
 const UInt_t kIsBigFile = BIT(16);
 const Int_t  kMaxLen = 2048;
 
+std::atomic<Int_t> TDirectoryFile::fgKeyIndexThreshold{-1};
+
 ClassImp(TDirectoryFile)
 
 
@@ -58,7 +62,7 @@ ClassImp(TDirectoryFile)
 TDirectoryFile::TDirectoryFile() : TDirectory()
    , fModified(kFALSE), fWritable(kFALSE), fNbytesKeys(0), fNbytesName(0)
    , fBufferSize(0), fSeekDir(0), fSeekParent(0), fSeekKeys(0)
-   , fFile(0), fKeys(0)
+   , fFile(0), fKeys(0), fKeyIndex(0)
 {
 }
 
@@ -78,7 +82,7 @@ TDirectoryFile::TDirectoryFile(const char *name, const char *title, Option_t *cl
            : TDirectory()
    , fModified(kFALSE), fWritable(kFALSE), fNbytesKeys(0), fNbytesName(0)
    , fBufferSize(0), fSeekDir(0), fSeekParent(0), fSeekKeys(0)
-   , fFile(0), fKeys(0)
+   , fFile(0), fKeys(0), fKeyIndex(0)
 {
    fName = name;
    fTitle = title;
@@ -166,7 +170,7 @@ void TDirectoryFile::Init(TClass *cl)
 TDirectoryFile::TDirectoryFile(const TDirectoryFile & directory) : TDirectory(directory)
    , fModified(kFALSE), fWritable(kFALSE), fNbytesKeys(0), fNbytesName(0)
    , fBufferSize(0), fSeekDir(0), fSeekParent(0), fSeekKeys(0)
-   , fFile(0), fKeys(0)
+   , fFile(0), fKeys(0), fKeyIndex(0)
 {
    ((TDirectoryFile&)directory).Copy(*this);
 }
@@ -176,6 +180,7 @@ TDirectoryFile::TDirectoryFile(const TDirectoryFile & directory) : TDirectory(di
 
 TDirectoryFile::~TDirectoryFile()
 {
+   SafeDelete(fKeyIndex);
    if (fKeys) {
       fKeys->Delete("slow");
       SafeDelete(fKeys);
@@ -224,6 +229,7 @@ void TDirectoryFile::Append(TObject *obj, Bool_t replace /* = kFALSE */)
 
 Int_t TDirectoryFile::AppendKey(TKey *key)
 {
+   if (fKeyIndex) LoadKeys();
    fModified = kTRUE;
 
    key->SetMotherDir(this);
@@ -260,7 +266,7 @@ void TDirectoryFile::Browse(TBrowser *b)
       TObject *obj = 0;
       TIter nextin(fList);
       TKey *key = 0, *keyo = 0;
-      TIter next(fKeys);
+      TIter next(GetListOfKeys());
 
       cd();
 
@@ -557,6 +563,7 @@ void TDirectoryFile::Close(Option_t *)
    }
 
    // Delete keys from key list (but don't delete the list header)
+   SafeDelete(fKeyIndex);
    if (fKeys) {
       fKeys->Delete("slow");
    }
@@ -910,16 +917,10 @@ TObject *TDirectoryFile::Get(const char *namecycle)
 
 //*-*---------------------Case of Key---------------------
 //                        ===========
-   TKey *key;
-   TIter nextkey(GetListOfKeys());
-   while ((key = (TKey *) nextkey())) {
-      if (strcmp(namobj,key->GetName()) == 0) {
-         if ((cycle == 9999) || (cycle == key->GetCycle())) {
-            TDirectory::TContext ctxt(this);
-            idcur = key->ReadObj();
-            break;
-         }
-      }
+   TKey *key = LookupKey(namobj, cycle);
+   if (key) {
+      TDirectory::TContext ctxt(this);
+      idcur = key->ReadObj();
    }
 
    return idcur;
@@ -1024,16 +1025,10 @@ void *TDirectoryFile::GetObjectChecked(const char *namecycle, const TClass* expe
 //*-*---------------------Case of Key---------------------
 //                        ===========
    void *idcur = 0;
-   TKey *key;
-   TIter nextkey(GetListOfKeys());
-   while ((key = (TKey *) nextkey())) {
-      if (strcmp(namobj,key->GetName()) == 0) {
-         if ((cycle == 9999) || (cycle == key->GetCycle())) {
-            TDirectory::TContext ctxt(this);
-            idcur = key->ReadObjectAny(expectedClass);
-            break;
-         }
-      }
+   TKey *key = LookupKey(namobj, cycle);
+   if (key) {
+      TDirectory::TContext ctxt(this);
+      idcur = key->ReadObjectAny(expectedClass);
    }
 
    return idcur;
@@ -1059,6 +1054,8 @@ Int_t TDirectoryFile::GetBufferSize() const
 
 TKey *TDirectoryFile::GetKey(const char *name, Short_t cycle) const
 {
+   if (fKeyIndex) return fKeyIndex->Find(name, cycle, kFALSE);
+
    // TIter::TIter() already checks for null pointers
    TIter next( ((THashList *)(GetListOfKeys()))->GetListForObject(name) );
 
@@ -1073,6 +1070,81 @@ TKey *TDirectoryFile::GetKey(const char *name, Short_t cycle) const
    return 0;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the number of keys of this directory.
+
+Int_t TDirectoryFile::GetNkeys() const
+{
+   if (fKeyIndex) return fKeyIndex->GetNkeys();
+   return fKeys->GetSize();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Create the keys of the key index and drop the index, so that fKeys
+/// holds all the keys of this directory, in the order of the file.
+
+void TDirectoryFile::LoadKeys() const
+{
+   TDirectoryFile *self = const_cast<TDirectoryFile*>(this);
+   if (!self->fKeyIndex) return;
+   self->fKeyIndex->LoadAll();
+   SafeDelete(self->fKeyIndex);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the key with name and cycle, or the one with the highest cycle
+/// if cycle is 9999; 0 if there is none.
+///
+/// The key is looked up in the key index or in the hash table of the list
+/// of keys; only the keys with the same hash are compared.
+
+TKey *TDirectoryFile::LookupKey(const char *name, Short_t cycle) const
+{
+   if (fKeyIndex) return fKeyIndex->Find(name, cycle, kTRUE);
+
+   TIter next( ((THashList *)(fKeys))->GetListForObject(name) );
+   TKey *key, *found = 0;
+   while (( key = (TKey *)next() )) {
+      if (strcmp(name, key->GetName())) continue;
+      if (cycle == 9999) {
+         if (!found || key->GetCycle() > found->GetCycle()) found = key;
+      } else if (cycle == key->GetCycle()) {
+         return key;
+      }
+   }
+   return found;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Static function returning the number of keys from which ReadKeys indexes
+/// the keys of a directory of a file opened for reading instead of creating
+/// a TKey for each of them, see SetKeyIndexThreshold. Unless set, it is
+/// taken from the resource TFile.KeyIndexThreshold (default 0).
+
+Int_t TDirectoryFile::GetKeyIndexThreshold()
+{
+   if (fgKeyIndexThreshold < 0) fgKeyIndexThreshold = gEnv->GetValue("TFile.KeyIndexThreshold", 0);
+   return fgKeyIndexThreshold;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Static function setting the number of keys from which the keys of a
+/// directory read from a file opened for reading are indexed (0 disables
+/// the index).
+///
+/// Opening a file, or reading a directory, then only reads the record of
+/// the keys and builds a compact table of the hashes of their names (see
+/// ROOT::Internal::TKeyIndex): Get, GetObject, GetKey and FindKey look the
+/// keys up in this table and create only the TKeys they return. The
+/// other TKeys are created, all at once, when the list of keys is needed
+/// (GetListOfKeys, ls, Browse, ...) or when the directory becomes
+/// writable.
+
+void TDirectoryFile::SetKeyIndexThreshold(Int_t nkeys)
+{
+   fgKeyIndexThreshold = nkeys < 0 ? 0 : nkeys;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// List Directory contents
 ///
@@ -1289,6 +1361,7 @@ Int_t TDirectoryFile::ReadKeys(Bool_t forceRead)
 
    char *buffer;
    if (forceRead) {
+      SafeDelete(fKeyIndex);
       fKeys->Delete();
       //In case directory was updated by another process, read new
       //position for the keys
@@ -1331,6 +1404,16 @@ Int_t TDirectoryFile::ReadKeys(Bool_t forceRead)
 
       TKey *key;
       frombuf(buffer, &nkeys);
+      Int_t threshold = GetKeyIndexThreshold();
+      if (!fWritable && !fKeyIndex && fKeys->IsEmpty() && threshold > 0 && nkeys >= threshold) {
+         // Index the keys, the TKeys are created when they are used.
+         Int_t nbytes = fNbytesKeys - (buffer - headerkey->GetBuffer());
+         fKeyIndex = new ROOT::Internal::TKeyIndex(this, fKeys, buffer, nbytes);
+         nkeys = fKeyIndex->Build(nkeys, fsize);
+         delete headerkey;
+         return nkeys;
+      }
+      if (fKeyIndex) LoadKeys();
       for (Int_t i = 0; i < nkeys; i++) {
          key = new TKey(this);
          key->ReadKeyBuffer(buffer);
@@ -1367,12 +1450,9 @@ Int_t TDirectoryFile::ReadKeys(Bool_t forceRead)
 Int_t TDirectoryFile::ReadTObject(TObject *obj, const char *keyname)
 {
    if (!fFile) { Error("Read","No file open"); return 0; }
-   TKey *key = 0;
-   TIter nextkey(GetListOfKeys());
-   while ((key = (TKey *) nextkey())) {
-      if (strcmp(keyname,key->GetName()) == 0) {
-         return key->Read(obj);
-      }
+   TKey *key = LookupKey(keyname, 9999);
+   if (key) {
+      return key->Read(obj);
    }
    Error("Read","Key not found");
    return 0;
@@ -1401,7 +1481,7 @@ void TDirectoryFile::ResetAfterMerge(TFileMergeInfo *info)
    fSeekParent = 0; // updated by Init
    fSeekKeys = 0;   // updated by Init
    // Does not change: fFile
-   TKey *key = (TKey*)fKeys->FindObject(fName);
+   TKey *key = (TKey*)GetListOfKeys()->FindObject(fName);
    TClass *cl = IsA();
    if (key) {
       cl = TClass::GetClass(key->GetClassName());
@@ -1567,6 +1647,8 @@ void TDirectoryFile::SetWritable(Bool_t writable)
 {
    TDirectory::TContext ctxt(this);
 
+   // A writable directory needs all its keys in fKeys.
+   if (writable && fKeyIndex) LoadKeys();
    fWritable = writable;
 
    // recursively set all sub-directories
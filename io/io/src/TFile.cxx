@@ -83,6 +83,7 @@ The structure of a directory is shown in TDirectoryFile::TDirectoryFile
 #include <sys/stat.h>
 #ifndef WIN32
 #   include <unistd.h>
+#   include <sys/mman.h>
 #else
 #   define ssize_t int
 #   include <io.h>
@@ -124,13 +125,16 @@ The structure of a directory is shown in TDirectoryFile::TDirectoryFile
 #include "TMathBase.h"
 #include "TObjString.h"
 #include "TStopwatch.h"
+#include "TTaskPool.h"
 #include "compiledata.h"
+#include <chrono>
 #include <cmath>
 #include <set>
 #include "TSchemaRule.h"
 #include "TSchemaRuleSet.h"
 #include "TThreadSlots.h"
 #include "TGlobal.h"
+#include "TKeyIndex.h"
 
 using std::sqrt;
 
@@ -139,6 +143,7 @@ std::atomic<Long64_t> TFile::fgBytesWrite{0};
 std::atomic<Long64_t> TFile::fgFileCounter{0};
 std::atomic<Int_t>    TFile::fgReadCalls{0};
 Int_t    TFile::fgReadaheadSize = 256000;
+std::atomic<Int_t>    TFile::fgReadQueueDepth{-1};
 Bool_t   TFile::fgReadInfo = kTRUE;
 TList   *TFile::fgAsyncOpenRequests = 0;
 TString  TFile::fgCacheFileDir;
@@ -149,6 +154,23 @@ Bool_t   TFile::fgOnlyStaged = 0;
 
 const Int_t kBEGIN = 100;
 
+namespace {
+   // Bounds of the size of the requests issued by TFile::ReadBuffersParallel.
+   const Long64_t kMinReadRequest =   64*1024;
+   const Long64_t kMaxReadRequest = 1024*1024;
+
+   //////////////////////////////////////////////////////////////////////////
+   /// Pool of threads executing the reads of TFile::ReadBuffersParallel,
+   /// separate from the default pool so that the reads are never queued
+   /// behind computing tasks. The calling thread takes part in the reads.
+
+   TTaskPool &GetReadPool()
+   {
+      static TTaskPool *pool = new TTaskPool(TMath::Max(TFile::GetReadQueueDepth() - 1, 1));
+      return *pool;
+   }
+}
+
 ClassImp(TFile)
 
 //*-*x17 macros/layout_file
@@ -183,6 +205,8 @@ TFile::TFile() : TDirectoryFile(), fInfoCache(0)
    fCacheReadMap    = new TMap();
    fCacheWrite      = 0;
    fArchiveOffset   = 0;
+   fMapped          = 0;
+   fMappedSize      = 0;
    fReadCalls       = 0;
    fInfoCache       = 0;
    fOpenPhases      = 0;
@@ -235,6 +259,7 @@ TFile::TFile() : TDirectoryFile(), fInfoCache(0)
 /// RECREATE      | Create a new file, if the file already exists it will be overwritten.
 /// UPDATE        | Open an existing file for writing. If no file exists, it is created.
 /// READ          | Open an existing file for reading (default).
+/// MMAP          | Open an existing local file for reading through a memory mapping of the file, see ReadBufferMapped.
 /// NET           | Used by derived remote file access classes, not a user callable option.
 /// WEB           | Used by derived remote http access class, not a user callable option.
 ///
@@ -293,6 +318,8 @@ TFile::TFile() : TDirectoryFile(), fInfoCache(0)
 /// will build an integer which will set the compression to use
 /// the LZMA algorithm and compression level 1.  These are defined
 /// in the header file <em>Compression.h</em>.
+/// ROOT::kLZ4 selects the LZ4 algorithm (LZ4-HC for levels 4 and above)
+/// which compresses less than ZLIB but decompresses much faster.
 /// Note that the compression settings may be changed at any time.
 /// The new compression settings will only apply to branches created
 /// or attached after the setting is changed and other objects written
@@ -385,6 +412,8 @@ TFile::TFile(const char *fname1, Option_t *option, const char *ftitle, Int_t com
    fArchiveOffset = 0;
    fIsArchive     = kFALSE;
    fArchive       = 0;
+   fMapped        = 0;
+   fMappedSize    = 0;
    if (fIsRootFile && !fIsPcmFile && fOption != "NEW" && fOption != "CREATE"
        && fOption != "RECREATE") {
       // If !gPluginMgr then we are at startup and cannot handle plugins
@@ -411,6 +440,10 @@ TFile::TFile(const char *fname1, Option_t *option, const char *ftitle, Int_t com
    if (fOption == "NEW")
       fOption = "CREATE";
 
+   Bool_t memmap   = (fOption == "MMAP") ? kTRUE : kFALSE;
+   if (memmap)
+      fOption = "READ";
+
    Bool_t create   = (fOption == "CREATE") ? kTRUE : kFALSE;
    Bool_t recreate = (fOption == "RECREATE") ? kTRUE : kFALSE;
    Bool_t update   = (fOption == "UPDATE") ? kTRUE : kFALSE;
@@ -510,6 +543,7 @@ TFile::TFile(const char *fname1, Option_t *option, const char *ftitle, Int_t com
          goto zombie;
       }
       fWritable = kFALSE;
+      if (memmap) MapFile();
    }
 
    Init(create);
@@ -860,14 +894,16 @@ void TFile::Init(Bool_t create)
    }
 
    // Count number of TProcessIDs in this file
-   {
+   if (fKeyIndex) {
+      fNProcessIDs = fKeyIndex->CountKeys("TProcessID");
+   } else {
       TIter next(fKeys);
       TKey *key;
       while ((key = (TKey*)next())) {
          if (!strcmp(key->GetClassName(),"TProcessID")) fNProcessIDs++;
       }
-      fProcessIDs = new TObjArray(fNProcessIDs+1);
    }
+   fProcessIDs = new TObjArray(fNProcessIDs+1);
    return;
 
 zombie:
@@ -903,6 +939,7 @@ void TFile::Close(Option_t *option)
 
    if (fIsArchive || !fIsRootFile) {
       FlushWriteCache();
+      UnmapFile();
       SysClose(fD);
       fD = -1;
 
@@ -958,6 +995,7 @@ void TFile::Close(Option_t *option)
    }
 
    if (IsOpen()) {
+      UnmapFile();
       SysClose(fD);
       fD = -1;
    }
@@ -1557,6 +1595,11 @@ Bool_t TFile::ReadBuffer(char *buf, Long64_t pos, Int_t len)
          return kFALSE;
       }
 
+      if (const char *mapped = ReadBufferMapped(pos, len)) {
+         memcpy(buf, mapped, len);
+         return kFALSE;
+      }
+
       Seek(pos);
       ssize_t siz;
 
@@ -1654,6 +1697,25 @@ Bool_t TFile::ReadBuffers(char *buf, Long64_t *pos, Int_t *len, Int_t nbuf)
       return kFALSE;
    }
 
+   // Memory mapped file: copy from the mapping.
+   if (IsMapped() && !fWritable) {
+      Int_t k = 0;
+      for (Int_t i = 0; i < nbuf; i++) {
+         const char *mapped = ReadBufferMapped(pos[i], len[i]);
+         if (!mapped) {
+            Error("ReadBuffers", "block at %lld of length %d is outside of file %s", pos[i], len[i], GetName());
+            return kTRUE;
+         }
+         memcpy(&buf[k], mapped, len[i]);
+         k += len[i];
+      }
+      return kFALSE;
+   }
+
+   // Local file opened for reading: keep several reads in flight.
+   if (nbuf > 0 && IsA() == TFile::Class() && !fWritable && fD >= 0 && GetReadQueueDepth() > 1)
+      return ReadBuffersParallel(buf, pos, len, nbuf);
+
    Int_t k = 0;
    Bool_t result = kTRUE;
    TFileCacheRead *old = fCacheRead;
@@ -1704,6 +1766,177 @@ Bool_t TFile::ReadBuffers(char *buf, Long64_t *pos, Int_t *len, Int_t nbuf)
    return result;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Read the nbuf blocks described in arrays pos and len, keeping up to
+/// GetReadQueueDepth() positional reads in flight at the same time.
+///
+/// The blocks are split in requests of 64 KBytes to 1 MBytes, so that even
+/// a single large block fills the queue, and the requests are executed by
+/// a pool of threads dedicated to I/O, the calling thread included. A
+/// single thread issuing one read after the other leaves most of the
+/// queue of a SSD or of a RAID array idle. The file offset is neither
+/// used nor changed by the reads.
+/// The achieved queue depth and bandwidth are reported to gPerfStats with
+/// TVirtualPerfStats::FileReadVectorEvent.
+/// Returns kTRUE in case of failure.
+
+Bool_t TFile::ReadBuffersParallel(char *buf, Long64_t *pos, Int_t *len, Int_t nbuf)
+{
+#ifdef WIN32
+   Error("ReadBuffersParallel", "not supported on Windows");
+   return kTRUE;
+#else
+   Double_t start = 0;
+   if (gPerfStats != 0) start = TTimeStamp();
+   std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+
+   Long64_t total = 0;
+   for (Int_t i = 0; i < nbuf; ++i) total += len[i];
+   Int_t depth = GetReadQueueDepth();
+   Long64_t reqsize = TMath::Min(kMaxReadRequest, TMath::Max(kMinReadRequest, total / depth + 1));
+
+   std::atomic<Int_t>    inflight(0);
+   std::atomic<Int_t>    maxdepth(0);
+   std::atomic<Int_t>    error(0);     // errno of the first failed read, -1 for a short read
+   std::atomic<Long64_t> queuetime(0); // Sum of the durations of the requests, in ns
+   Int_t fd = fD;
+   Long64_t archive = fArchiveOffset;
+   auto readRequest = [fd, archive, &inflight, &maxdepth, &error, &queuetime](char *dest, Long64_t offset, Long64_t nbytes) {
+      Int_t now = ++inflight;
+      Int_t seen = maxdepth;
+      while (now > seen && !maxdepth.compare_exchange_weak(seen, now)) {}
+      std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+      while (nbytes > 0 && !error) {
+         ssize_t siz = ::pread(fd, dest, nbytes, offset + archive);
+         if (siz < 0 && errno == EINTR) continue;
+         if (siz <= 0) {
+            Int_t expected = 0;
+            error.compare_exchange_strong(expected, siz < 0 ? errno : -1);
+            break;
+         }
+         dest   += siz;
+         offset += siz;
+         nbytes -= siz;
+      }
+      queuetime += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count();
+      --inflight;
+   };
+
+   Int_t nrequests = 0;
+   {
+      TTaskGroup group(GetReadPool());
+      Long64_t k = 0;
+      for (Int_t i = 0; i < nbuf; ++i) {
+         for (Long64_t done = 0; done < len[i]; done += reqsize) {
+            Long64_t nbytes = TMath::Min(reqsize, len[i] - done);
+            char *dest = &buf[k + done];
+            Long64_t offset = pos[i] + done;
+            group.Run([&readRequest, dest, offset, nbytes]() { readRequest(dest, offset, nbytes); });
+            ++nrequests;
+         }
+         k += len[i];
+      }
+      group.Wait();
+   }
+
+   if (error) {
+      if (error > 0) {
+         errno = error;
+         SysError("ReadBuffers", "error reading from file %s", GetName());
+      } else {
+         Error("ReadBuffers", "error reading all requested bytes from file %s", GetName());
+      }
+      return kTRUE;
+   }
+
+   fBytesRead  += total;
+   fgBytesRead += total;
+   fReadCalls  += nrequests;
+   fgReadCalls += nrequests;
+
+   if (gMonitoringWriter)
+      gMonitoringWriter->SendFileReadProgress(this);
+   if (gPerfStats != 0) {
+      Double_t elapsed = 1e-9 * std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count();
+      SetOffset(pos[0]);
+      gPerfStats->FileReadEvent(this, (Int_t)total, start);
+      gPerfStats->FileReadVectorEvent(this, nrequests, total, elapsed, 1e-9 * queuetime, maxdepth);
+   }
+   SetOffset(pos[nbuf-1] + len[nbuf-1]);
+   return kFALSE;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the address of the len bytes at position pos in the memory
+/// mapping of the file, or 0 if the file is not mapped (see the option
+/// MMAP of the constructor), is writable or does not contain the block.
+///
+/// The block is not copied: TKey and TBasket decompress their data
+/// straight from the mapped pages and an uncompressed basket is used in
+/// place, so the pages are shared through the page cache by all the
+/// processes reading the file. The mapping is private: writing to it
+/// does not change the file. It remains valid until the file is closed,
+/// the buffers of the baskets pointing to it must not be used after.
+/// The access is accounted as a read of len bytes (see GetBytesRead and
+/// TVirtualPerfStats::FileReadEvent).
+
+char *TFile::ReadBufferMapped(Long64_t pos, Int_t len)
+{
+   if (!fMapped || fWritable || pos < 0 || len < 0 || pos + fArchiveOffset + len > fMappedSize)
+      return 0;
+
+   fBytesRead  += len;
+   fgBytesRead += len;
+   fReadCalls++;
+   fgReadCalls++;
+
+   if (gMonitoringWriter)
+      gMonitoringWriter->SendFileReadProgress(this);
+   if (gPerfStats != 0) {
+      SetOffset(pos);
+      gPerfStats->FileReadEvent(this, len, TTimeStamp());
+   }
+   return fMapped + fArchiveOffset + pos;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Map the whole file in memory, read-only from the point of view of the
+/// file (see ReadBufferMapped). If the mapping fails, the file is read
+/// with system calls.
+
+void TFile::MapFile()
+{
+#ifndef WIN32
+   Long_t id, flags, modtime;
+   Long64_t size;
+   if (SysStat(fD, &id, &size, &flags, &modtime) != 0 || size <= 0)
+      return;
+   void *addr = ::mmap(0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fD, 0);
+   if (addr == MAP_FAILED) {
+      SysError("MapFile", "cannot map file %s in memory, it will be read with system calls", GetName());
+      return;
+   }
+   fMapped     = (char*)addr;
+   fMappedSize = size;
+#else
+   Warning("MapFile", "memory mapped files are not supported on Windows, %s will be read with system calls",
+           GetName());
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Release the memory mapping of the file, if any.
+
+void TFile::UnmapFile()
+{
+#ifndef WIN32
+   if (fMapped) ::munmap(fMapped, fMappedSize);
+#endif
+   fMapped     = 0;
+   fMappedSize = 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Read buffer via cache.
 ///
@@ -4353,9 +4586,31 @@ Int_t TFile::GetReadaheadSize()
    return fgReadaheadSize;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Static function returning the number of reads kept in flight by
+/// ReadBuffers for local files, see SetReadQueueDepth. Unless set, it is
+/// taken from the resource TFile.ReadQueueDepth (default 0).
+
+Int_t TFile::GetReadQueueDepth()
+{
+   if (fgReadQueueDepth < 0) fgReadQueueDepth = gEnv->GetValue("TFile.ReadQueueDepth", 0);
+   return fgReadQueueDepth;
+}
+
 //______________________________________________________________________________
 void TFile::SetReadaheadSize(Int_t bytes) { fgReadaheadSize = bytes; }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Static function setting the number of reads that ReadBuffers, used by
+/// TFileCacheRead and TTreeCache to fill their buffer, keeps in flight at
+/// the same time for local files opened for reading. With a depth of 0 or 1
+/// the blocks are read one after the other.
+/// The number of threads executing the reads is fixed by the depth in use
+/// the first time they are needed; a larger depth set afterwards only
+/// changes the size of the requests.
+
+void TFile::SetReadQueueDepth(Int_t depth) { fgReadQueueDepth = depth < 0 ? 0 : depth; }
+
 //______________________________________________________________________________
 void TFile::SetFileBytesRead(Long64_t bytes) { fgBytesRead = bytes; }
 
@@ -4616,7 +4871,8 @@ TFile::EFileType TFile::GetType(const char *name, Option_t *option, TString *pre
             // If option "READ" test existence and access
             TString opt = option;
             Bool_t read = (opt.IsNull() ||
-                          !opt.CompareTo("READ", TString::kIgnoreCase)) ? kTRUE : kFALSE;
+                          !opt.CompareTo("READ", TString::kIgnoreCase) ||
+                          !opt.CompareTo("MMAP", TString::kIgnoreCase)) ? kTRUE : kFALSE;
             if (read) {
                char *fn;
                if ((fn = gSystem->ExpandPathName(TUrl(lfname).GetFile()))) {
@@ -25,6 +25,7 @@
  derives from this class is automatically created.                
 */
 
+#include "TBufferPool.h"
 #include "TEnv.h"
 #include "TFile.h"
 #include "TFileCacheRead.h"
@@ -135,10 +136,14 @@ TFileCacheRead::TFileCacheRead(TFile *file, Int_t buffersize, TObject *tree)
    fPrefetchedBlocks = 0;
 
    //initialise the prefetch object and set the cache directory
-   // start the thread only if the file is not local
+   // start the thread only if the file is not local, or if the local
+   // reads are issued in parallel (see TFile::SetReadQueueDepth): the
+   // reading of the next block then overlaps with the processing of
+   // the current one.
    fEnablePrefetching = gEnv->GetValue("TFile.AsyncPrefetching", 0);
 
-   if (fEnablePrefetching && strcmp(file->GetEndpointUrl()->GetProtocol(), "file")){
+   if (fEnablePrefetching && (strcmp(file->GetEndpointUrl()->GetProtocol(), "file") ||
+                              TFile::GetReadQueueDepth() > 1)){
       SetEnablePrefetchingImpl(true);
    }
    else { //disable the async pref for local files
@@ -168,7 +173,7 @@ TFileCacheRead::~TFileCacheRead()
    delete [] fSeekPos;
    delete [] fLen;
    if (fBuffer)
-      delete [] fBuffer;
+      TBufferPool::Release(fBuffer);
    delete [] fBSeek;
    delete [] fBSeekIndex;
    delete [] fBSeekSort;
@@ -547,7 +552,7 @@ void TFileCacheRead::SetFile(TFile *file, TFile::ECacheAction action)
       // we use sync primitives, hence we need the local buffer
       if (file && file->ReadBufferAsync(0, 0)) {
          fAsyncReading = kFALSE;
-         fBuffer       = new char[fBufferSize];
+         fBuffer       = TBufferPool::Allocate(fBufferSize);
       }
    }
 
@@ -589,12 +594,12 @@ void TFileCacheRead::Sort()
    fNseek = effectiveNseek;
    if (fNtot > fBufferSizeMin) {
       fBufferSize = fNtot + 100;
-      delete [] fBuffer;
+      TBufferPool::Release(fBuffer);
       fBuffer = 0;
       // If ReadBufferAsync is not supported by this implementation
       // it means that we are using sync primitives, hence we need the local buffer
       if (!fAsyncReading)
-         fBuffer = new char[fBufferSize];
+         fBuffer = TBufferPool::Allocate(fBufferSize);
    }
    fPos[0]  = fSeekSort[0];
    fLen[0]  = fSeekSortLen[0];
@@ -647,12 +652,12 @@ void TFileCacheRead::SecondSort()
    fBNseek = effectiveNseek;
    if (fBNtot > fBufferSizeMin) {
       fBufferSize = fBNtot + 100;
-      delete [] fBuffer;
+      TBufferPool::Release(fBuffer);
       fBuffer = 0;
       // If ReadBufferAsync is not supported by this implementation
       // it means that we are using sync primitives, hence we need the local buffer
       if (!fAsyncReading)
-         fBuffer = new char[fBufferSize];
+         fBuffer = TBufferPool::Allocate(fBufferSize);
    }
    fBPos[0]  = fBSeekSort[0];
    fBLen[0]  = fBSeekSortLen[0];
@@ -733,16 +738,16 @@ Int_t TFileCacheRead::SetBufferSize(Int_t buffersize)
          pres = fBuffer;
          fBuffer = 0;
       }
-      delete [] fBuffer;
+      TBufferPool::Release(fBuffer);
       fBuffer = 0;
-      np = new char[buffersize];
+      np = TBufferPool::Allocate(buffersize);
       if (pres) {
          memcpy(np, pres, fNtot);
       }
-      delete [] pres;
+      TBufferPool::Release(pres);
    }
 
-   delete [] fBuffer;
+   TBufferPool::Release(fBuffer);
    fBuffer = np;
    fBufferSizeMin = buffersize;
    fBufferSize = buffersize;
@@ -808,7 +813,7 @@ void TFileCacheRead::SetEnablePrefetchingImpl(Bool_t setPrefetching)
          }
       if (!fAsyncReading && fBuffer == 0) {
          // we use sync primitives, hence we need the local buffer
-         fBuffer = new char[fBufferSize];
+         fBuffer = TBufferPool::Allocate(fBufferSize);
       }
    }
 }
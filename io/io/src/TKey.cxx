@@ -56,6 +56,7 @@
 #include "TFile.h"
 #include "TKey.h"
 #include "TBufferFile.h"
+#include "TBufferPool.h"
 #include "TFree.h"
 #include "TBrowser.h"
 #include "Bytes.h"
@@ -543,6 +544,8 @@ void TKey::Delete(Option_t *option)
 void TKey::DeleteBuffer()
 {
    if (fBufferRef) {
+      // The buffers of the baskets may use a block of the TBufferPool.
+      TBufferPool::Detach(fBufferRef);
       delete fBufferRef;
       fBufferRef = 0;
    } else {
@@ -745,9 +748,12 @@ TObject *TKey::ReadObj()
    fBufferRef->SetParent(GetFile());
    fBufferRef->SetPidOffset(fPidOffset);
 
+   // With a memory mapped file, unzip straight from the mapped pages.
+   char *mapped = 0;
    if (fObjlen > fNbytes-fKeylen) {
-      fBuffer = new char[fNbytes];
-      if( !ReadFile() )                    //Read object structure from file
+      mapped = GetFile()->ReadBufferMapped(fSeekKey, fNbytes);
+      fBuffer = mapped ? mapped : new char[fNbytes];
+      if( !mapped && !ReadFile() )         //Read object structure from file
       {
         delete fBufferRef;
         delete [] fBuffer;
@@ -808,9 +814,9 @@ TObject *TKey::ReadObj()
       }
       if (nout) {
          tobj->Streamer(*fBufferRef); //does not work with example 2 above
-         delete [] fBuffer;
+         if (!mapped) delete [] fBuffer;
       } else {
-         delete [] fBuffer;
+         if (!mapped) delete [] fBuffer;
          // Even-though we have a TObject, if the class is emulated the virtual
          // table may not be 'right', so let's go via the TClass.
          cl->Destructor(pobj);
@@ -1013,9 +1019,11 @@ void *TKey::ReadObjectAny(const TClass* expectedClass)
    fBufferRef->SetParent(GetFile());
    fBufferRef->SetPidOffset(fPidOffset);
 
+   char *mapped = 0;
    if (fObjlen > fNbytes-fKeylen) {
-      fBuffer = new char[fNbytes];
-      ReadFile();                    //Read object structure from file
+      mapped = GetFile()->ReadBufferMapped(fSeekKey, fNbytes);
+      fBuffer = mapped ? mapped : new char[fNbytes];
+      if (!mapped) ReadFile();       //Read object structure from file
       memcpy(fBufferRef->Buffer(),fBuffer,fKeylen);
    } else {
       fBuffer = fBufferRef->Buffer();
@@ -1086,9 +1094,9 @@ void *TKey::ReadObjectAny(const TClass* expectedClass)
       }
       if (nout) {
          cl->Streamer((void*)pobj, *fBufferRef, clOnfile);    //read object
-         delete [] fBuffer;
+         if (!mapped) delete [] fBuffer;
       } else {
-         delete [] fBuffer;
+         if (!mapped) delete [] fBuffer;
          cl->Destructor(pobj);
          pobj = 0;
          goto CLEAR;
@@ -1151,9 +1159,11 @@ Int_t TKey::Read(TObject *obj)
    if (fVersion > 1)
       fBufferRef->MapObject(obj);  //register obj in map to handle self reference
 
+   char *mapped = 0;
    if (fObjlen > fNbytes-fKeylen) {
-      fBuffer = new char[fNbytes];
-      ReadFile();                    //Read object structure from file
+      mapped = GetFile()->ReadBufferMapped(fSeekKey, fNbytes);
+      fBuffer = mapped ? mapped : new char[fNbytes];
+      if (!mapped) ReadFile();       //Read object structure from file
       memcpy(fBufferRef->Buffer(),fBuffer,fKeylen);
    } else {
       fBuffer = fBufferRef->Buffer();
@@ -1176,7 +1186,7 @@ Int_t TKey::Read(TObject *obj)
          objbuf += nout;
       }
       if (nout) obj->Streamer(*fBufferRef);
-      delete [] fBuffer;
+      if (!mapped) delete [] fBuffer;
    } else {
       obj->Streamer(*fBufferRef);
    }
@@ -1261,6 +1271,10 @@ Bool_t TKey::ReadFile()
    if (f==0) return kFALSE;
 
    Int_t nsize = fNbytes;
+   if (const char *mapped = f->ReadBufferMapped(fSeekKey, nsize)) {
+      memcpy(fBuffer, mapped, nsize);
+      return kTRUE;
+   }
    f->Seek(fSeekKey);
 #if 0
    for (Int_t i = 0; i < nsize; i += kMAXFILEBUFFER) {
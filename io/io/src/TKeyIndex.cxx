@@ -0,0 +1,264 @@
+// @(#)root/io:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2015, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+/**
+\class ROOT::Internal::TKeyIndex
+\ingroup IO
+
+Compact index of the keys of a TDirectoryFile read from a file.
+
+TDirectoryFile::ReadKeys normally creates a TKey for each key of the
+directory. For a directory with many keys (see
+TDirectoryFile::SetKeyIndexThreshold) it builds a TKeyIndex instead: the
+record of the keys is kept as read from the file, and a table holds, for
+each key, the hash of its name and its offset in the record (16 bytes per
+key), sorted by hash and decreasing cycle. A lookup by name is a binary
+search in this table; the TKey is created, and added to the list of keys
+of the directory, only when it is found. All the keys are created, in the
+order of the file, when the list of keys of the directory is needed.
+*/
+
+#include "TKeyIndex.h"
+#include "TKey.h"
+#include "TList.h"
+#include "TString.h"
+#include "TError.h"
+#include "Bytes.h"
+
+#include <algorithm>
+#include <string.h>
+
+namespace {
+
+// Mask of the location of the directory of a key, the highest 16 bits
+// hold the pid offset (see TKey::ReadKeyBuffer).
+const ULong64_t kSeekPdirMask = (((ULong64_t)1) << 48) - 1;
+
+struct TKeyHeader {
+   Short_t     fCycle;     // Cycle of the key
+   Long64_t    fSeekKey;   // Location of the object
+   Long64_t    fSeekPdir;  // Location of the directory of the key
+   const char *fClassName; // Class name, not null terminated
+   Int_t       fClassLen;  // Length of the class name
+   const char *fName;      // Key name, not null terminated
+   Int_t       fNameLen;   // Length of the key name
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read the string at buffer, written by TString::FillBuffer, into str and
+/// len, and move buffer after it. Return false if it goes beyond end.
+
+Bool_t ReadString(char *&buffer, const char *end, const char *&str, Int_t &len)
+{
+   if (buffer >= end) return kFALSE;
+   UChar_t nwh = (UChar_t)*buffer++;
+   if (nwh == 255) {
+      if (end - buffer < 4) return kFALSE;
+      frombuf(buffer, &len);
+   } else {
+      len = nwh;
+   }
+   if (len < 0 || end - buffer < len) return kFALSE;
+   str = buffer;
+   buffer += len;
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read the key at buffer, written by TKey::FillBuffer, into header and
+/// move buffer after it. Return false if it goes beyond end.
+
+Bool_t ReadKeyHeader(char *&buffer, const char *end, TKeyHeader &header)
+{
+   Int_t nbytes, objlen;
+   Version_t version;
+   UInt_t datime;
+   Short_t keylen;
+   if (end - buffer < 18) return kFALSE;
+   frombuf(buffer, &nbytes);
+   frombuf(buffer, &version);
+   frombuf(buffer, &objlen);
+   frombuf(buffer, &datime);
+   frombuf(buffer, &keylen);
+   frombuf(buffer, &header.fCycle);
+   if (version > 1000) {
+      if (end - buffer < 16) return kFALSE;
+      Long64_t pdir;
+      frombuf(buffer, &header.fSeekKey);
+      frombuf(buffer, &pdir);
+      header.fSeekPdir = pdir & kSeekPdirMask;
+   } else {
+      if (end - buffer < 8) return kFALSE;
+      Int_t seekkey, seekpdir;
+      frombuf(buffer, &seekkey);
+      frombuf(buffer, &seekpdir);
+      header.fSeekKey = seekkey;
+      header.fSeekPdir = seekpdir;
+   }
+   const char *title;
+   Int_t titleLen;
+   return ReadString(buffer, end, header.fClassName, header.fClassLen) &&
+          ReadString(buffer, end, header.fName, header.fNameLen) &&
+          ReadString(buffer, end, title, titleLen);
+}
+
+} // unnamed namespace
+
+////////////////////////////////////////////////////////////////////////////////
+/// Index the keys of dir, whose record starts with the first key at record
+/// and takes nbytes; the keys created are added to keys.
+
+ROOT::Internal::TKeyIndex::TKeyIndex(TDirectory *dir, TList *keys, const char *record, Int_t nbytes) :
+   fDir(dir), fKeys(keys), fRecord(record, record + (nbytes > 0 ? nbytes : 0)), fNloaded(0)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Index the nkeys keys of the record, checking that they point inside the
+/// file of size fsize. Return the number of keys indexed.
+
+Int_t ROOT::Internal::TKeyIndex::Build(Int_t nkeys, Long64_t fsize)
+{
+   fEntries.clear();
+   if (fRecord.empty() || nkeys <= 0) return 0;
+   fEntries.reserve(nkeys);
+   char *start = &fRecord[0];
+   const char *end = start + fRecord.size();
+   char *buffer = start;
+   for (Int_t i = 0; i < nkeys; ++i) {
+      TEntry entry;
+      entry.fKey = 0;
+      entry.fOffset = buffer - start;
+      TKeyHeader header;
+      if (!ReadKeyHeader(buffer, end, header) ||
+          header.fSeekKey < 64 || header.fSeekKey > fsize ||
+          header.fSeekPdir < 64 || header.fSeekPdir > fsize) {
+         ::Error("TDirectoryFile::ReadKeys", "reading illegal key, exiting after %d keys", i);
+         break;
+      }
+      entry.fHash = TString::Hash(header.fName, header.fNameLen);
+      fEntries.push_back(entry);
+   }
+   std::sort(fEntries.begin(), fEntries.end(), [this](const TEntry &a, const TEntry &b) {
+      if (a.fHash != b.fHash) return a.fHash < b.fHash;
+      Short_t ca = GetCycle(a), cb = GetCycle(b);
+      if (ca != cb) return ca > cb;
+      return a.fOffset < b.fOffset;
+   });
+   return fEntries.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the number of keys whose class name, as stored in the file, is
+/// classname.
+
+Int_t ROOT::Internal::TKeyIndex::CountKeys(const char *classname) const
+{
+   Int_t len = strlen(classname);
+   Int_t count = 0;
+   char *start = const_cast<char*>(fRecord.data());
+   const char *end = start + fRecord.size();
+   for (size_t i = 0; i < fEntries.size(); ++i) {
+      char *buffer = start + fEntries[i].fOffset;
+      TKeyHeader header;
+      if (ReadKeyHeader(buffer, end, header) && header.fClassLen == len &&
+          !memcmp(header.fClassName, classname, len))
+         ++count;
+   }
+   return count;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the key with name and cycle, the key with the highest cycle if
+/// cycle is 9999. If exactCycle is false, return the key with the highest
+/// cycle lower or equal to cycle instead. Return 0 if there is none.
+
+TKey *ROOT::Internal::TKeyIndex::Find(const char *name, Short_t cycle, Bool_t exactCycle)
+{
+   Int_t len = strlen(name);
+   UInt_t hash = TString::Hash(name, len);
+   std::vector<TEntry>::iterator it =
+      std::lower_bound(fEntries.begin(), fEntries.end(), hash,
+                       [](const TEntry &entry, UInt_t h) { return entry.fHash < h; });
+   for (; it != fEntries.end() && it->fHash == hash; ++it) {
+      Int_t entryLen;
+      const char *entryName = GetName(*it, entryLen);
+      if (entryLen != len || memcmp(entryName, name, len)) continue;
+      Short_t entryCycle = GetCycle(*it);
+      if (cycle == 9999 || (exactCycle ? cycle == entryCycle : cycle >= entryCycle)) {
+         if (!it->fKey) {
+            fKeys->Add(Load(*it));
+         }
+         return it->fKey;
+      }
+   }
+   return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the cycle of the key of entry.
+
+Short_t ROOT::Internal::TKeyIndex::GetCycle(const TEntry &entry) const
+{
+   // fNbytes, version, fObjlen, fDatime and fKeylen come first.
+   char *buffer = const_cast<char*>(fRecord.data()) + entry.fOffset + 16;
+   Short_t cycle;
+   frombuf(buffer, &cycle);
+   return cycle;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the name of the key of entry, not null terminated, and its
+/// length in len.
+
+const char *ROOT::Internal::TKeyIndex::GetName(const TEntry &entry, Int_t &len) const
+{
+   char *buffer = const_cast<char*>(fRecord.data()) + entry.fOffset;
+   TKeyHeader header;
+   ReadKeyHeader(buffer, fRecord.data() + fRecord.size(), header);
+   len = header.fNameLen;
+   return header.fName;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the number of bytes used by the index.
+
+Long64_t ROOT::Internal::TKeyIndex::GetMemorySize() const
+{
+   return sizeof(*this) + fRecord.capacity() + fEntries.capacity() * sizeof(TEntry);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Create the key of entry, which is not yet created.
+
+TKey *ROOT::Internal::TKeyIndex::Load(TEntry &entry)
+{
+   char *buffer = &fRecord[entry.fOffset];
+   entry.fKey = new TKey(fDir);
+   entry.fKey->ReadKeyBuffer(buffer);
+   ++fNloaded;
+   return entry.fKey;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Create the keys not yet created and fill the list of keys with all the
+/// keys, in the order of the file.
+
+void ROOT::Internal::TKeyIndex::LoadAll()
+{
+   std::vector<TEntry*> entries(fEntries.size());
+   for (size_t i = 0; i < fEntries.size(); ++i) entries[i] = &fEntries[i];
+   std::sort(entries.begin(), entries.end(),
+             [](const TEntry *a, const TEntry *b) { return a->fOffset < b->fOffset; });
+   fKeys->Clear("nodelete");
+   for (size_t i = 0; i < entries.size(); ++i) {
+      fKeys->Add(entries[i]->fKey ? entries[i]->fKey : Load(*entries[i]));
+   }
+}
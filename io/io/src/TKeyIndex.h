@@ -0,0 +1,77 @@
+// @(#)root/io:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2015, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TKeyIndex
+#define ROOT_TKeyIndex
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TKeyIndex                                                            //
+//                                                                      //
+// Compact index of the keys of a directory read from a file. It keeps  //
+// the record of the keys as read from the file and a table of the      //
+// hashes of the key names, sorted by hash and decreasing cycle, with   //
+// the offset of each key in the record. A TKey is created only when    //
+// its key is looked up, or for all the keys at once when the list of  //
+// keys of the directory is needed.                                     //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef ROOT_Rtypes
+#include "Rtypes.h"
+#endif
+
+#include <vector>
+
+class TDirectory;
+class TKey;
+class TList;
+
+namespace ROOT {
+namespace Internal {
+
+class TKeyIndex {
+
+private:
+   struct TEntry {
+      TKey   *fKey;      // Key created for this entry, 0 if not yet created
+      UInt_t  fHash;     // Hash of the key name
+      Int_t   fOffset;   // Offset of the key in fRecord
+   };
+
+   TDirectory          *fDir;      // Directory of the keys
+   TList               *fKeys;     // List of keys of the directory, where the created keys are added
+   std::vector<char>    fRecord;   // Record of the keys, as read from the file
+   std::vector<TEntry>  fEntries;  // Keys sorted by hash of their name, then by decreasing cycle
+   Int_t                fNloaded;  // Number of keys created
+
+   TKeyIndex(const TKeyIndex &);            // not implemented
+   TKeyIndex &operator=(const TKeyIndex &); // not implemented
+
+   Short_t     GetCycle(const TEntry &entry) const;
+   const char *GetName(const TEntry &entry, Int_t &len) const;
+   TKey       *Load(TEntry &entry);
+
+public:
+   TKeyIndex(TDirectory *dir, TList *keys, const char *record, Int_t nbytes);
+
+   Int_t    Build(Int_t nkeys, Long64_t fsize);
+   Int_t    CountKeys(const char *classname) const;
+   TKey    *Find(const char *name, Short_t cycle, Bool_t exactCycle);
+   Int_t    GetNkeys() const { return fEntries.size(); }
+   Int_t    GetNloaded() const { return fNloaded; }
+   Long64_t GetMemorySize() const;
+   void     LoadAll();
+};
+
+} // namespace Internal
+} // namespace ROOT
+
+#endif
@@ -23,6 +23,10 @@
 #include "TClassEdit.h"
 #include "TVirtualCollectionIterators.h"
 #include "TProcessID.h"
+#include "TDataType.h"
+
+#include <string>
+#include <unordered_map>
 
 static const Int_t kRegrouped = TStreamerInfo::kOffsetL;
 
@@ -226,6 +230,131 @@ namespace TStreamerInfoActions
       return 0;
    }
 
+   class TConfBulk : public TConfiguration {
+      // Configuration of the actions streaming a run of consecutive members
+      // of basic type (see TActionSequence::Fuse).
+   public:
+      struct TItem {
+         Int_t fDelta;   // Offset of the first value, relative to fOffset
+         Int_t fLength;  // Number of values, contiguous in memory
+         Int_t fSize;    // Size of a value: 1, 2, 4 or 8 bytes
+      };
+      std::vector<TItem> fItems;
+      TConfBulk(TVirtualStreamerInfo *info, UInt_t id, TCompInfo_t *compinfo, Int_t offset) : TConfiguration(info,id,compinfo,offset) {};
+      virtual TConfiguration *Copy() { return new TConfBulk(*this); }
+   };
+
+   Int_t ReadBulk(TBuffer &buf, void *addr, const TConfiguration *config)
+   {
+      // Read a run of members of basic type. TBufferFile::ApplySequence
+      // uses the bulk actions only when buf is exactly a TBufferFile, so
+      // that the TBufferFile functions can be called directly.
+
+      TBufferFile &b = static_cast<TBufferFile&>(buf);
+      char *obj = ((char*)addr) + config->fOffset;
+      const std::vector<TConfBulk::TItem> &items = ((const TConfBulk*)config)->fItems;
+      for (size_t i = 0; i < items.size(); ++i) {
+         char *x = obj + items[i].fDelta;
+         Int_t n = items[i].fLength;
+         switch (items[i].fSize) {
+            case 1: if (n == 1) b.TBufferFile::ReadChar(*(Char_t*)x);     else b.TBufferFile::ReadFastArray((Char_t*)x, n);   break;
+            case 2: if (n == 1) b.TBufferFile::ReadShort(*(Short_t*)x);   else b.TBufferFile::ReadFastArray((Short_t*)x, n);  break;
+            case 4: if (n == 1) b.TBufferFile::ReadInt(*(Int_t*)x);       else b.TBufferFile::ReadFastArray((Int_t*)x, n);    break;
+            case 8: if (n == 1) b.TBufferFile::ReadLong64(*(Long64_t*)x); else b.TBufferFile::ReadFastArray((Long64_t*)x, n); break;
+         }
+      }
+      return 0;
+   }
+
+   Int_t WriteBulk(TBuffer &buf, void *addr, const TConfiguration *config)
+   {
+      // Write a run of members of basic type, see ReadBulk.
+
+      TBufferFile &b = static_cast<TBufferFile&>(buf);
+      const char *obj = ((const char*)addr) + config->fOffset;
+      const std::vector<TConfBulk::TItem> &items = ((const TConfBulk*)config)->fItems;
+      for (size_t i = 0; i < items.size(); ++i) {
+         const char *x = obj + items[i].fDelta;
+         Int_t n = items[i].fLength;
+         switch (items[i].fSize) {
+            case 1: if (n == 1) b.TBufferFile::WriteChar(*(const Char_t*)x);     else b.TBufferFile::WriteFastArray((const Char_t*)x, n);   break;
+            case 2: if (n == 1) b.TBufferFile::WriteShort(*(const Short_t*)x);   else b.TBufferFile::WriteFastArray((const Short_t*)x, n);  break;
+            case 4: if (n == 1) b.TBufferFile::WriteInt(*(const Int_t*)x);       else b.TBufferFile::WriteFastArray((const Int_t*)x, n);    break;
+            case 8: if (n == 1) b.TBufferFile::WriteLong64(*(const Long64_t*)x); else b.TBufferFile::WriteFastArray((const Long64_t*)x, n); break;
+         }
+      }
+      return 0;
+   }
+
+   template <typename T>
+   static Bool_t IsBasicTypeAction(const TConfiguredAction &action, Bool_t &read)
+   {
+      if (action.fAction == ReadBasicType<T>)  { read = kTRUE;  return kTRUE; }
+      if (action.fAction == WriteBasicType<T>) { read = kFALSE; return kTRUE; }
+      return kFALSE;
+   }
+
+   static Int_t GetBulkSize(Int_t type)
+   {
+      // Return the size in memory, which is also the size in the buffer, of
+      // the basic type that a bulk action can stream, 0 for the other types
+      // (Long_t has a different size in the buffer, Float16_t and Double32_t
+      // are compressed, kBits and kCounter have side effects).
+
+      switch (type) {
+         case TStreamerInfo::kBool:    return sizeof(Bool_t) == 1 ? 1 : 0;
+         case TStreamerInfo::kChar:
+         case TStreamerInfo::kUChar:   return 1;
+         case TStreamerInfo::kShort:
+         case TStreamerInfo::kUShort:  return 2;
+         case TStreamerInfo::kInt:
+         case TStreamerInfo::kUInt:
+         case TStreamerInfo::kFloat:   return 4;
+         case TStreamerInfo::kLong64:
+         case TStreamerInfo::kULong64:
+         case TStreamerInfo::kDouble:  return 8;
+         default:                      return 0;
+      }
+   }
+
+   static Int_t GetBulkType(const TConfiguredAction &action, Bool_t &read, Int_t &length)
+   {
+      // Return the basic type (kInt, kFloat, ...) of the member, or fixed size
+      // array, that action streams without conversion and that a bulk action
+      // can stream instead, 0 otherwise. Set read to whether action reads or
+      // writes and length to the number of values.
+
+      const TConfiguration *conf = action.fConfiguration;
+      if (!conf || !conf->fCompInfo) return 0;
+      Int_t type = conf->fCompInfo->fType;
+      length = 1;
+      if (type > TStreamerInfo::kOffsetL && type < TStreamerInfo::kOffsetP) {
+         // Fixed size array, or members regrouped by TStreamerInfo::Compile,
+         // streamed with ReadFastArray/WriteFastArray by the generic actions.
+         if (action.fAction == GenericReadAction) read = kTRUE;
+         else if (action.fAction == GenericWriteAction) read = kFALSE;
+         else return 0;
+         length = conf->fCompInfo->fLength;
+         type -= TStreamerInfo::kOffsetL;
+         return (length > 0 && GetBulkSize(type)) ? type : 0;
+      }
+      Bool_t basic = kFALSE;
+      switch (type) {
+         case TStreamerInfo::kBool:    basic = IsBasicTypeAction<Bool_t>(action, read);    break;
+         case TStreamerInfo::kChar:    basic = IsBasicTypeAction<Char_t>(action, read);    break;
+         case TStreamerInfo::kUChar:   basic = IsBasicTypeAction<UChar_t>(action, read);   break;
+         case TStreamerInfo::kShort:   basic = IsBasicTypeAction<Short_t>(action, read);   break;
+         case TStreamerInfo::kUShort:  basic = IsBasicTypeAction<UShort_t>(action, read);  break;
+         case TStreamerInfo::kInt:     basic = IsBasicTypeAction<Int_t>(action, read);     break;
+         case TStreamerInfo::kUInt:    basic = IsBasicTypeAction<UInt_t>(action, read);    break;
+         case TStreamerInfo::kFloat:   basic = IsBasicTypeAction<Float_t>(action, read);   break;
+         case TStreamerInfo::kLong64:  basic = IsBasicTypeAction<Long64_t>(action, read);  break;
+         case TStreamerInfo::kULong64: basic = IsBasicTypeAction<ULong64_t>(action, read); break;
+         case TStreamerInfo::kDouble:  basic = IsBasicTypeAction<Double_t>(action, read);  break;
+      }
+      return (basic && GetBulkSize(type)) ? type : 0;
+   }
+
    class TConfWithFactor : public TConfiguration {
       // Configuration object for the Float16/Double32 where a factor has been specified.
    public:
@@ -2282,11 +2411,15 @@ void TStreamerInfo::Compile()
    Int_t ndata = fElements->GetEntries();
 
 
-   if (fReadObjectWise) fReadObjectWise->fActions.clear();
-   else fReadObjectWise = new TStreamerInfoActions::TActionSequence(this,ndata);
+   if (fReadObjectWise) {
+      fReadObjectWise->fActions.clear();
+      fReadObjectWise->ResetOptimization();
+   } else fReadObjectWise = new TStreamerInfoActions::TActionSequence(this,ndata);
 
-   if (fWriteObjectWise) fWriteObjectWise->fActions.clear();
-   else fWriteObjectWise = new TStreamerInfoActions::TActionSequence(this,ndata);
+   if (fWriteObjectWise) {
+      fWriteObjectWise->fActions.clear();
+      fWriteObjectWise->ResetOptimization();
+   } else fWriteObjectWise = new TStreamerInfoActions::TActionSequence(this,ndata);
 
    if (fReadMemberWise) fReadMemberWise->fActions.clear();
    else fReadMemberWise = new TStreamerInfoActions::TActionSequence(this,ndata);
@@ -2472,6 +2605,7 @@ void TStreamerInfo::Compile()
       AddWriteMemberWiseVecPtrAction(fWriteMemberWiseVecPtr, i, fCompFull[i]);
    }
    ComputeSize();
+   SetActionsMode(fClass ? fClass->GetStreamerActionsMode() : GetDefaultActionsMode());
 
    fOptimized = isOptimized;
    SetIsCompiled();
@@ -2481,6 +2615,27 @@ void TStreamerInfo::Compile()
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Optimize the object-wise action sequences used by TBufferFile, see
+/// TClass::SetStreamerActionsMode and TVirtualStreamerInfo::EActionsMode:
+/// with kBulkActions the runs of members of basic type are fused (see
+/// TActionSequence::Fuse), with kCompiledActions a function streaming the
+/// whole sequence is also compiled by the interpreter (see
+/// TActionSequence::JitCompile).
+
+void TStreamerInfo::SetActionsMode(Int_t mode)
+{
+   R__LOCKGUARD(gInterpreterMutex);
+
+   TStreamerInfoActions::TActionSequence *sequences[2] = { fReadObjectWise, fWriteObjectWise };
+   for (Int_t i = 0; i < 2; ++i) {
+      if (!sequences[i]) continue;
+      sequences[i]->ResetOptimization();
+      if (mode >= kBulkActions) sequences[i]->Fuse();
+      if (mode >= kCompiledActions) sequences[i]->JitCompile();
+   }
+}
+
 template <typename From>
 static void AddReadConvertAction(TStreamerInfoActions::TActionSequence *sequence, Int_t newtype, TConfiguration *conf)
 {
@@ -3173,17 +3328,165 @@ void TStreamerInfoActions::TActionSequence::AddToOffset(Int_t delta)
 {
    // Add the (potentially negative) delta to all the configuration's offset.  This is used by
    // TBranchElement in the case of split sub-object.
+   // The compiled function, which has the offsets built in, is dropped.
+
+   ActionContainer_t *containers[2] = { &fActions, &fBulkActions };
+   for (Int_t c = 0; c < 2; ++c) {
+      TStreamerInfoActions::ActionContainer_t::iterator end = containers[c]->end();
+      for(TStreamerInfoActions::ActionContainer_t::iterator iter = containers[c]->begin();
+          iter != end;
+          ++iter)
+      {
+         if (!iter->fConfiguration->fInfo->GetElements()->At(iter->fConfiguration->fElemId)->TestBit(TStreamerElement::kCache))
+            iter->fConfiguration->AddToOffset(delta);
+      }
+   }
+   fCompiledAction = 0;
+}
 
-   TStreamerInfoActions::ActionContainer_t::iterator end = fActions.end();
-   for(TStreamerInfoActions::ActionContainer_t::iterator iter = fActions.begin();
-       iter != end;
-       ++iter)
+Bool_t TStreamerInfoActions::TActionSequence::Fuse()
+{
+   // Fill fBulkActions with the actions of the sequence where each run of
+   // consecutive actions reading (or writing) members of basic type, or
+   // fixed size arrays of basic type, without conversion is replaced by a
+   // single action. This action reads (or writes) the values of the same
+   // size that are contiguous in memory as one array, i.e. with a single
+   // memcpy or byte swap of the array, and the other ones one by one, with
+   // the TBufferFile functions called directly.
+   // The byte stream is the same as with the original actions; the fused
+   // actions are used only by TBufferFile::ApplySequence (the XML, SQL and
+   // JSON buffers need one action per member).
+   // Return true if at least one run was fused.
+
+   fBulkActions.clear();
+   if (fLoopConfig) return kFALSE; // The member-wise sequences loop over the collection for each action.
+
+   ActionContainer_t bulk;
+   bulk.reserve(fActions.size());
+   Bool_t fused = kFALSE;
+   size_t i = 0;
+   while (i < fActions.size()) {
+      Bool_t read = kFALSE;
+      Int_t length = 0;
+      Int_t type = GetBulkType(fActions[i], read, length);
+      size_t last = i + 1;
+      if (type) {
+         Bool_t nextRead = kFALSE;
+         Int_t nextLength = 0;
+         while (last < fActions.size() && GetBulkType(fActions[last], nextRead, nextLength) && nextRead == read) {
+            ++last;
+         }
+      }
+      // A single member of basic type gains nothing, a single array avoids the generic action.
+      if (!type || (last == i + 1 && length == 1)) {
+         bulk.push_back(TConfiguredAction(fActions[i].fAction, fActions[i].fConfiguration->Copy()));
+         ++i;
+         continue;
+      }
+      const TConfiguration *first = fActions[i].fConfiguration;
+      TConfBulk *conf = new TConfBulk(first->fInfo, first->fElemId, first->fCompInfo, first->fOffset);
+      for (; i < last; ++i) {
+         TConfBulk::TItem item;
+         item.fDelta = fActions[i].fConfiguration->fOffset - first->fOffset;
+         item.fSize = GetBulkSize(GetBulkType(fActions[i], read, item.fLength));
+         if (!conf->fItems.empty()) {
+            TConfBulk::TItem &prev = conf->fItems.back();
+            if (prev.fSize == item.fSize && prev.fDelta + prev.fLength * prev.fSize == item.fDelta) {
+               prev.fLength += item.fLength;
+               continue;
+            }
+         }
+         conf->fItems.push_back(item);
+      }
+      if (read) bulk.push_back(TConfiguredAction(ReadBulk, conf));
+      else bulk.push_back(TConfiguredAction(WriteBulk, conf));
+      fused = kTRUE;
+   }
+   if (fused) fBulkActions.swap(bulk);
+   return fused;
+}
+
+namespace {
+   // The functions compiled by TActionSequence::JitCompile (0 if the
+   // compilation failed), indexed by their body.
+   std::unordered_map<std::string, void*> &CompiledActions()
    {
-      if (!iter->fConfiguration->fInfo->GetElements()->At(iter->fConfiguration->fElemId)->TestBit(TStreamerElement::kCache))
-         iter->fConfiguration->AddToOffset(delta);
+      static std::unordered_map<std::string, void*> functions;
+      return functions;
    }
 }
 
+Bool_t TStreamerInfoActions::TActionSequence::JitCompile()
+{
+   // Compile with the interpreter a function streaming the whole sequence
+   // with a TBufferFile: the members of basic type, and the fixed size arrays
+   // of basic type, are read (or written) with inline calls to the
+   // TBufferFile functions, at the offsets of the sequence; the function
+   // calls the actions of the other members. TBufferFile::ApplySequence then
+   // calls this function instead of the actions.
+   // The functions are cached by their code, so that the sequences with the
+   // same layout share the same compiled function.
+   // Return false, and keep the actions, if the sequence has no member of
+   // basic type or if the compilation failed.
+
+   fCompiledAction = 0;
+   if (fLoopConfig || fActions.empty() || !gInterpreter) return kFALSE;
+
+   TString body = "(TBuffer &b, void *obj, const TStreamerInfoActions::TConfiguredAction *actions)\n{\n"
+                  "   TBufferFile &buf = static_cast<TBufferFile&>(b);\n"
+                  "   char *addr = (char*)obj;\n";
+   Int_t nbasic = 0;
+   for (size_t i = 0; i < fActions.size(); ++i) {
+      Bool_t read = kFALSE;
+      Int_t length = 0;
+      Int_t type = GetBulkType(fActions[i], read, length);
+      if (!type) {
+         body += TString::Format("   actions[%d](b, obj);\n", (Int_t)i);
+         continue;
+      }
+      ++nbasic;
+      TString typeName = TDataType::GetTypeName((EDataType)type);
+      TString func = typeName(0, typeName.Length() - 2); // Int_t -> Int
+      Int_t offset = fActions[i].fConfiguration->fOffset;
+      if (length == 1) {
+         if (read) body += TString::Format("   buf.TBufferFile::Read%s(*(%s*)(addr + %d));\n", func.Data(), typeName.Data(), offset);
+         else body += TString::Format("   buf.TBufferFile::Write%s(*(%s*)(addr + %d));\n", func.Data(), typeName.Data(), offset);
+      } else {
+         if (read) body += TString::Format("   buf.TBufferFile::ReadFastArray((%s*)(addr + %d), %d);\n", typeName.Data(), offset, length);
+         else body += TString::Format("   buf.TBufferFile::WriteFastArray((const %s*)(addr + %d), %d);\n", typeName.Data(), offset, length);
+      }
+   }
+   body += "   return 0;\n}\n";
+   if (!nbasic) return kFALSE;
+
+   R__LOCKGUARD(gInterpreterMutex);
+   std::unordered_map<std::string, void*> &functions = CompiledActions();
+   auto known = functions.find(body.Data());
+   void *function = 0;
+   if (known != functions.end()) {
+      function = known->second;
+   } else {
+      TString name = TString::Format("R__TStreamerInfoJit_%lu", (unsigned long)functions.size());
+      TString declaration = "#include \"TBufferFile.h\"\n#include \"TStreamerInfoActions.h\"\nInt_t " + name + body;
+      if (gInterpreter->Declare(declaration)) {
+         function = (void*)gInterpreter->Calc(TString::Format("(long)&%s", name.Data()));
+      }
+      // Also remember the failures, not to try again.
+      functions[body.Data()] = function;
+   }
+   fCompiledAction = (TStreamerInfoCompiledAction_t)function;
+   return fCompiledAction != 0;
+}
+
+void TStreamerInfoActions::TActionSequence::ResetOptimization()
+{
+   // Drop the fused actions and the compiled function, TBufferFile then
+   // uses the actions of the sequence.
+
+   fBulkActions.clear();
+   fCompiledAction = 0;
+}
+
 TStreamerInfoActions::TActionSequence *TStreamerInfoActions::TActionSequence::CreateCopy()
 {
    // Create a copy of this sequence.
@@ -3200,6 +3503,7 @@ TStreamerInfoActions::TActionSequence *TStreamerInfoActions::TActionSequence::Cr
       TConfiguration *conf = iter->fConfiguration->Copy();
       sequence->AddAction( iter->fAction, conf );
    }
+   if (!fBulkActions.empty()) sequence->Fuse();
    return sequence;
 }
 
@@ -3238,6 +3542,7 @@ TStreamerInfoActions::TActionSequence *TStreamerInfoActions::TActionSequence::Cr
          }
       }
    }
+   if (!fBulkActions.empty()) sequence->Fuse();
    return sequence;
 }
 
@@ -87,6 +87,10 @@ HADDS        := $(MODDIRS)/hadd.cxx
 HADDO        := $(call stripsrc,$(HADDS:.cxx=.o))
 HADDDEP      := $(HADDO:.o=.d)
 HADD         := bin/hadd$(EXEEXT)
+ifneq ($(PLATFORM),win32)
+HADDLIBS     := -lMultiProc
+HADDLIBSDEP  := $(MULTIPROCLIB)
+endif
 
 ##### h2root #####
 H2ROOTS1     := $(MODDIRS)/h2root.cxx
@@ -169,9 +173,9 @@ $(ROOTSSH):     $(call stripsrc,$(MAINDIRS)/roots.sh)
 		@cp $< $@
 		@chmod 0755 $@
 
-$(HADD):        $(HADDO) $(ROOTLIBSDEP)
+$(HADD):        $(HADDO) $(ROOTLIBSDEP) $(HADDLIBSDEP)
 		$(LD) $(LDFLAGS) -o $@ $(HADDO) $(ROOTULIBS) \
-		   $(RPATH) $(ROOTLIBS) $(SYSLIBS)
+		   $(RPATH) $(ROOTLIBS) $(HADDLIBS) $(SYSLIBS)
 
 $(SSH2RPD):     $(SSH2RPDO) $(SNPRINTFO) $(STRLCPYO)
 		$(LD) $(LDFLAGS) -o $@ $(SSH2RPDO) $(SNPRINTFO) $(STRLCPYO) \
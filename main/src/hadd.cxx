@@ -15,6 +15,8 @@
   level of the target file. By default the compression level is 1, but
   if "-f0" is specified, the target file will not be compressed.
   if "-f6" is specified, the compression level 6 will be used.
+  if "-f404" is specified, the LZ4 algorithm with level 4 will be used
+  (see ROOT::ECompressionAlgorithm in Compression.h).
 
   For example assume 3 files f1, f2, f3 containing histograms hn and Trees Tn
     f1 with h1 h2 h3 T1
@@ -48,6 +50,14 @@
   (i.e. direct copy of the raw byte on disk). The "fast" mode is typically
   5 times faster than the mode unzipping and unstreaming the baskets.
 
+  With the option -j nprocesses, the source files are split in nprocesses
+  consecutive groups which are merged in parallel, by forked processes,
+  into temporary files (in the temporary directory of the system, see
+  TSystem::TempDirectory); the temporary files are then merged, in order,
+  into the target file and removed. Each of these merges uses the fast
+  method when possible. -j 0 uses one process per core.
+       hadd -j 8 result.root myfil*.root
+
   NOTE1: By default histograms are added. However hadd does not support the case where
          histograms have their bit TH1::kIsAverage set.
 
@@ -69,15 +79,75 @@
 #include "TClass.h"
 #include "TSystem.h"
 #include <stdlib.h>
+#include <algorithm>
+#include <numeric>
+#include <vector>
 
 #include "TFileMerger.h"
+#include "Compression.h"
+
+#ifndef R__WIN32
+#include "TPool.h"
+#include <sys/resource.h>
+#endif
+
+struct THaddInput {
+   std::string fName;     // Name of the source file
+   Bool_t      fIndirect; // True if the name was read from an indirect file
+};
+
+// Outcome of the merge of a group of source files by a worker process.
+enum EPartialMerge { kPartialFailed, kPartialDone, kPartialRecompressed };
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add the source files inputs[first,last) to merger. A file given on the
+/// command line that can not be opened is skipped if skip_errors is true.
+
+static Bool_t AddInputs(TFileMerger &merger, const std::vector<THaddInput> &inputs,
+                        size_t first, size_t last, Bool_t skip_errors)
+{
+   for (size_t i = first; i < last; ++i) {
+      if (merger.AddFile(inputs[i].fName.c_str())) continue;
+      if (inputs[i].fIndirect) return kFALSE;
+      if ( skip_errors ) {
+         std::cerr << "hadd skipping file with error: " << inputs[i].fName << std::endl;
+      } else {
+         std::cerr << "hadd exiting due to error in " << inputs[i].fName << std::endl;
+         return kFALSE;
+      }
+   }
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Print the peak resident memory of hadd and, if partial merges were run,
+/// of the largest worker process.
+
+static void PrintPeakMemory(Bool_t parallel)
+{
+#ifndef R__WIN32
+   // ru_maxrss is in kilobytes, except on MacOS X where it is in bytes.
+#ifdef R__MACOSX
+   const Double_t toMB = 1. / (1024 * 1024);
+#else
+   const Double_t toMB = 1. / 1024;
+#endif
+   struct rusage usage;
+   if (getrusage(RUSAGE_SELF, &usage) == 0)
+      std::cout << "hadd peak resident memory: " << usage.ru_maxrss * toMB << " MB" << std::endl;
+   if (parallel && getrusage(RUSAGE_CHILDREN, &usage) == 0)
+      std::cout << "hadd peak resident memory of the partial merges: " << usage.ru_maxrss * toMB << " MB" << std::endl;
+#else
+   (void)parallel;
+#endif
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 
 int main( int argc, char **argv )
 {
    if ( argc < 3 || "-h" == std::string(argv[1]) || "--help" == std::string(argv[1]) ) {
-      std::cout << "Usage: " << argv[0] << " [-f[fk][0-9]] [-k] [-T] [-O] [-a] [-n maxopenedfiles] [-v [verbosity]] targetfile source1 [source2 source3 ...]" << std::endl;
+      std::cout << "Usage: " << argv[0] << " [-f[fk][0-9]] [-k] [-T] [-O] [-a] [-n maxopenedfiles] [-j nprocesses] [-v [verbosity]] targetfile source1 [source2 source3 ...]" << std::endl;
       std::cout << "This program will add histograms from a list of root files and write them" << std::endl;
       std::cout << "to a target root file. The target file is newly created and must not " << std::endl;
       std::cout << "exist, or if -f (\"force\") is given, must not be one of the source files." << std::endl;
@@ -88,6 +158,8 @@ int main( int argc, char **argv )
       std::cout << "If the option -O is used, when merging TTree, the basket size is re-optimized" <<std::endl;
       std::cout << "If the option -v is used, explicitly set the verbosity level; 0 request no output, 99 is the default" <<std::endl;
       std::cout << "If the option -n is used, hadd will open at most 'maxopenedfiles' at once, use 0 to request to use the system maximum." << std::endl;
+      std::cout << "If the option -j is used, the source files are merged in 'nprocesses' groups by parallel processes\n"
+                   "  into temporary files, which are then merged into the target file; use 0 to request one process per core." << std::endl;
       std::cout << "When -the -f option is specified, one can also specify the compression level of the target file.\n"
                    "By default the compression level is 1, but" <<std::endl;
       std::cout << "if \"-fk\" is specified, the target file contain the baskets with the same compression as in the input files \n"
@@ -96,6 +168,7 @@ int main( int argc, char **argv )
       std::cout << "if \"-ff\" is specified, the compression level use is the one specified in the first input." <<std::endl;
       std::cout << "if \"-f0\" is specified, the target file will not be compressed." <<std::endl;
       std::cout << "if \"-f6\" is specified, the compression level 6 will be used.  See  TFile::SetCompressionSettings for the support range of value." <<std::endl;
+      std::cout << "if \"-f404\" is specified, the LZ4 algorithm with compression level 4 will be used." <<std::endl;
       std::cout << "if Target and source files have different compression settings"<<std::endl;
       std::cout << " a slower method is used"<<std::endl;
       return 1;
@@ -109,6 +182,7 @@ int main( int argc, char **argv )
    Bool_t keepCompressionAsIs = kFALSE;
    Bool_t useFirstInputCompression = kFALSE;
    Int_t maxopenedfiles = 0;
+   Int_t nprocesses = 1;
    Int_t verbosity = 99;
 
    int outputPlace = 0;
@@ -144,6 +218,25 @@ int main( int argc, char **argv )
             }
          }
          ++ffirst;
+      } else if ( strcmp(argv[a],"-j") == 0 ) {
+         if (a+1 >= argc) {
+            std::cerr << "Error: no number of processes was provided after -j.\n";
+         } else {
+            Long_t request = strtol(argv[a+1], 0, 10);
+            if (request < kMaxInt && request >= 0) {
+               nprocesses = (Int_t)request;
+               if (nprocesses == 0) {
+                  SysInfo_t info;
+                  gSystem->GetSysInfo(&info);
+                  nprocesses = info.fCpus > 0 ? info.fCpus : 1;
+               }
+               ++a;
+               ++ffirst;
+            } else {
+               std::cerr << "Error: could not parse the number of processes passed after -j: " << argv[a+1] << ". The files will be merged sequentially.\n";
+            }
+         }
+         ++ffirst;
       } else if ( strcmp(argv[a],"-v") == 0 ) {
          if (a+1 == argc || argv[a+1][0] == '-') {
             // Verbosity level was not specified use the default:
@@ -192,7 +285,8 @@ int main( int argc, char **argv )
             }
          }
          char ft[7];
-         for ( int alg = 0; !useFirstInputCompression && alg <= 2; ++alg ) {
+         for ( int alg = 0; !useFirstInputCompression && alg < ROOT::kUndefinedCompressionAlgorithm; ++alg ) {
+            if (alg == ROOT::kOldCompressionAlgo) continue;
             for( int j=0; j<=9; ++j ) {
                const int comp = (alg*100)+j;
                snprintf(ft,7,"-f%s%d",prefix,comp);
@@ -265,18 +359,8 @@ int main( int argc, char **argv )
       else
          std::cout << "hadd compression setting for all ouput: " << newcomp << '\n';
    }
-   if (append) {
-      if (!merger.OutputFile(targetname,"UPDATE",newcomp)) {
-         std::cerr << "hadd error opening target file for update :" << argv[ffirst-1] << "." << std::endl;
-         exit(2);
-      }
-   } else if (!merger.OutputFile(targetname,force,newcomp) ) {
-      std::cerr << "hadd error opening target file (does " << argv[ffirst-1] << " exist?)." << std::endl;
-      if (!force) std::cerr << "Pass \"-f\" argument to force re-creation of output file." << std::endl;
-      exit(1);
-   }
-
 
+   std::vector<THaddInput> inputs;
    for ( int i = ffirst; i < argc; i++ ) {
       if (argv[i] && argv[i][0]=='@') {
          std::ifstream indirect_file(argv[i]+1);
@@ -286,15 +370,92 @@ int main( int argc, char **argv )
          }
          while( indirect_file ){
             std::string line;
-            if( std::getline(indirect_file, line) && line.length() &&  !merger.AddFile(line.c_str()) ) {
-               return 1;
+            if( std::getline(indirect_file, line) && line.length() ) {
+               inputs.push_back({line, kTRUE});
             }
          }
-      } else if( ! merger.AddFile(argv[i]) ) {
-         if ( skip_errors ) {
-            std::cerr << "hadd skipping file with error: " << argv[i] << std::endl;
-         } else {
-            std::cerr << "hadd exiting due to error in " << argv[i] << std::endl;
+      } else {
+         inputs.push_back({argv[i], kFALSE});
+      }
+   }
+
+   // Split the sources in consecutive groups (at least two files each) merged
+   // in parallel into temporary files, which take their place in the final
+   // merge. The target is opened only afterwards, so that the forked
+   // processes do not inherit it.
+   Bool_t compressionChange = kFALSE;
+   std::vector<std::string> partials;
+   Int_t ngroups = std::min<size_t>(nprocesses, inputs.size() / 2);
+#ifndef R__WIN32
+   if (ngroups > 1) {
+      if (!append && !force && !gSystem->AccessPathName(targetname)) {
+         std::cerr << "hadd error opening target file (does " << targetname << " exist?)." << std::endl;
+         std::cerr << "Pass \"-f\" argument to force re-creation of output file." << std::endl;
+         exit(1);
+      }
+      for (Int_t g = 0; g < ngroups; ++g) {
+         partials.push_back(TString::Format("%s/hadd_partial_%d_%d.root", gSystem->TempDirectory(),
+                                            gSystem->GetPid(), g).Data());
+      }
+      auto mergeGroup = [&](Int_t g) -> Int_t {
+         TFileMerger partial(kFALSE,kFALSE);
+         partial.SetMsgPrefix("hadd");
+         partial.SetPrintLevel(verbosity - 2);
+         if (maxopenedfiles > 0) {
+            partial.SetMaxOpenedFiles(maxopenedfiles);
+         }
+         if (!partial.OutputFile(partials[g].c_str(), kTRUE, newcomp)) {
+            std::cerr << "hadd error opening temporary file " << partials[g] << std::endl;
+            return kPartialFailed;
+         }
+         if (!AddInputs(partial, inputs, g * inputs.size() / ngroups, (g + 1) * inputs.size() / ngroups, skip_errors)) {
+            return kPartialFailed;
+         }
+         if (reoptimize) partial.SetFastMethod(kFALSE);
+         partial.SetNotrees(noTrees);
+         if (!partial.Merge()) return kPartialFailed;
+         return partial.HasCompressionChange() ? kPartialRecompressed : kPartialDone;
+      };
+      if (verbosity > 1) {
+         std::cout << "hadd merging " << inputs.size() << " input files in " << ngroups << " parallel processes" << std::endl;
+      }
+      std::vector<Int_t> groups(ngroups);
+      std::iota(groups.begin(), groups.end(), 0);
+      TPool pool(ngroups);
+      std::vector<Int_t> results = pool.Map(mergeGroup, groups);
+      Bool_t failed = results.size() != (size_t)ngroups;
+      for (auto result : results) {
+         if (result == kPartialFailed) failed = kTRUE;
+         if (result == kPartialRecompressed) compressionChange = kTRUE;
+      }
+      if (failed) {
+         std::cerr << "hadd failure during the parallel merge of the input files." << std::endl;
+         for (auto &name : partials) gSystem->Unlink(name.c_str());
+         return 1;
+      }
+   }
+#endif
+
+   if (append) {
+      if (!merger.OutputFile(targetname,"UPDATE",newcomp)) {
+         std::cerr << "hadd error opening target file for update :" << argv[ffirst-1] << "." << std::endl;
+         exit(2);
+      }
+   } else if (!merger.OutputFile(targetname,force,newcomp) ) {
+      std::cerr << "hadd error opening target file (does " << argv[ffirst-1] << " exist?)." << std::endl;
+      if (!force) std::cerr << "Pass \"-f\" argument to force re-creation of output file." << std::endl;
+      exit(1);
+   }
+
+   if (partials.empty()) {
+      if (!AddInputs(merger, inputs, 0, inputs.size(), skip_errors)) {
+         return 1;
+      }
+      compressionChange = merger.HasCompressionChange();
+   } else {
+      for (auto &name : partials) {
+         if (!merger.AddFile(name.c_str())) {
+            for (auto &partial : partials) gSystem->Unlink(partial.c_str());
             return 1;
          }
       }
@@ -302,7 +463,7 @@ int main( int argc, char **argv )
    if (reoptimize) {
       merger.SetFastMethod(kFALSE);
    } else {
-      if (!keepCompressionAsIs && merger.HasCompressionChange()) {
+      if (!keepCompressionAsIs && compressionChange) {
          // Don't warn if the user any request re-optimization.
          std::cout <<"hadd Sources and Target have different compression levels"<<std::endl;
          std::cout <<"hadd merging will be slower"<<std::endl;
@@ -313,14 +474,20 @@ int main( int argc, char **argv )
    if (append) status = merger.PartialMerge(TFileMerger::kIncremental | TFileMerger::kAll);
    else status = merger.Merge();
 
+   Int_t nmerged = partials.empty() ? merger.GetMergeList()->GetEntries() : (Int_t)inputs.size();
+   for (auto &name : partials) gSystem->Unlink(name.c_str());
+   if (verbosity > 1) {
+      PrintPeakMemory(!partials.empty());
+   }
+
    if (status) {
       if (verbosity == 1) {
-         std::cout << "hadd merged " << merger.GetMergeList()->GetEntries() << " input files in " << targetname << ".\n";
+         std::cout << "hadd merged " << nmerged << " input files in " << targetname << ".\n";
       }
       return 0;
    } else {
       if (verbosity == 1) {
-         std::cout << "hadd failure during the merge of " << merger.GetMergeList()->GetEntries() << " input files in " << targetname << ".\n";
+         std::cout << "hadd failure during the merge of " << nmerged << " input files in " << targetname << ".\n";
       }
       return 1;
    }
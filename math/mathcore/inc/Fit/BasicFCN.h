@@ -21,6 +21,14 @@
 #include "Math/IParamFunction.h"
 #endif
 
+#ifndef ROOT_Fit_ExecutionPolicy
+#include "Fit/ExecutionPolicy.h"
+#endif
+
+#ifndef ROOT_Math_Error
+#include "Math/Error.h"
+#endif
+
 
 #include <memory>
 
@@ -56,7 +64,9 @@ protected:
    BasicFCN (const std::shared_ptr<DataType> & data, const std::shared_ptr<IModelFunction> & func) :
       BaseObjFunction(func->NPar(), data->Size() ),
       fData(data),
-      fFunc(func)
+      fFunc(func),
+      fExecutionPolicy(kSerial),
+      fNThreads(0)
    { }
 
 
@@ -81,6 +91,24 @@ public:
    /// access to function pointer 
    std::shared_ptr<IModelFunction> ModelFunctionPtr() const { return fFunc; }
 
+   /// set the policy used to evaluate the function over the data points
+   /// and the number of threads used for kMultiThread (0 means the number of cores).
+   /// kMultiThread is replaced by kVectorized if the model function is not thread safe
+   void SetExecutionPolicy(ExecutionPolicy policy, unsigned int nthreads = 0) {
+      if (policy == kMultiThread && !fFunc->IsThreadSafe()) {
+         MATH_WARN_MSG("BasicFCN::SetExecutionPolicy","The model function is not thread safe - evaluate it in a single thread");
+         policy = kVectorized;
+      }
+      fExecutionPolicy = policy;
+      fNThreads = nthreads;
+   }
+
+   /// return the policy used to evaluate the function over the data points
+   ExecutionPolicy GetExecutionPolicy() const { return fExecutionPolicy; }
+
+   /// return the number of threads used for kMultiThread (0 means the number of cores)
+   unsigned int NThreads() const { return fNThreads; }
+
    
 
 protected:
@@ -96,6 +124,9 @@ protected:
    std::shared_ptr<DataType>  fData;
    std::shared_ptr<IModelFunction>  fFunc;
 
+   ExecutionPolicy fExecutionPolicy;   // policy used to evaluate the function over the data points
+   unsigned int    fNThreads;          // number of threads for kMultiThread (0 means the number of cores)
+
 
 
 };
@@ -26,6 +26,8 @@
 
 #endif
 
+#include <algorithm>
+
 
 namespace ROOT {
 
@@ -230,6 +232,21 @@ public :
       return fDataWrapper->Coords(ipoint);
    }
 
+   /**
+      copy the coordinates of the given fit point in x (of size NDim()).
+      Unlike Coords, it does not use an internal buffer when the data are not copied in,
+      so it can be called concurrently by several threads
+    */
+   void CopyCoords(unsigned int ipoint, double * x) const {
+      if (fDataVector) {
+         const double * c = &((fDataVector->Data())[ ipoint*fPointSize ] );
+         std::copy(c, c + fDim, x);
+         return;
+      }
+      for (unsigned int i = 0; i < fDim; ++i)
+         x[i] = fDataWrapper->Coord(ipoint, i);
+   }
+
    /**
       return the value for the given fit point
     */
@@ -341,6 +358,23 @@ public :
       return fDataWrapper->Coords(ipoint);
    }
 
+   /**
+      copy in x (of size NDim()) the coordinates of the given fit point and retrieve its value and
+      inverse error as GetPoint(ipoint, value, invError).
+      It can be called concurrently by several threads (see CopyCoords)
+   */
+   void CopyPoint(unsigned int ipoint, double * x, double & value, double & invError) const {
+      if (fDataVector) {
+         const double * c = GetPoint(ipoint, value, invError);
+         std::copy(c, c + fDim, x);
+         return;
+      }
+      CopyCoords(ipoint, x);
+      value = fDataWrapper->Value(ipoint);
+      double e = fDataWrapper->Error(ipoint);
+      invError = ( e > 0 ) ? 1.0/e : 1.0;
+   }
+
    /**
       Retrieve the errors on the point (coordinate and value) for the given fit point
       It must be called only when the coordinate errors are stored otherwise it will produce an
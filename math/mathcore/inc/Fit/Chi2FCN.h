@@ -106,7 +106,9 @@ public:
       BaseFCN(f.DataPtr(), f.ModelFunctionPtr() ),
       fNEffPoints( f.fNEffPoints ),
       fGrad( f.fGrad)
-   {  }
+   {
+      this->SetExecutionPolicy(f.GetExecutionPolicy(), f.NThreads() );
+   }
 
    /**
       Assignment operator
@@ -116,6 +118,7 @@ public:
       SetModelFunction(rhs.ModelFunctionPtr() );
       fNEffPoints = rhs.fNEffPoints;
       fGrad = rhs.fGrad; 
+      this->SetExecutionPolicy(rhs.GetExecutionPolicy(), rhs.NThreads() );
    }
 
    /* 
@@ -163,7 +166,8 @@ private:
       return FitUtilParallel::EvaluateChi2(BaseFCN::ModelFunction(), BaseFCN::Data(), x, fNEffPoints);
 #else
       if (!BaseFCN::Data().HaveCoordErrors() )
-         return FitUtil::EvaluateChi2(BaseFCN::ModelFunction(), BaseFCN::Data(), x, fNEffPoints);
+         return FitUtil::EvaluateChi2(BaseFCN::ModelFunction(), BaseFCN::Data(), x, fNEffPoints,
+                                      BaseFCN::GetExecutionPolicy(), BaseFCN::NThreads() );
       else
          return FitUtil::EvaluateChi2Effective(BaseFCN::ModelFunction(), BaseFCN::Data(), x, fNEffPoints);
 #endif
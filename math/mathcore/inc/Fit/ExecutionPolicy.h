@@ -0,0 +1,49 @@
+// @(#)root/mathcore:$Id$
+
+/**********************************************************************
+ *                                                                    *
+ * Copyright (c) 2015  LCG ROOT Math Team, CERN/PH-SFT                *
+ *                                                                    *
+ *                                                                    *
+ **********************************************************************/
+
+// Header file defining the execution policy of the fit method functions
+
+#ifndef ROOT_Fit_ExecutionPolicy
+#define ROOT_Fit_ExecutionPolicy
+
+
+namespace ROOT {
+
+   namespace Fit {
+
+      /**
+         Policy used to evaluate the objective function (chi2 or likelihood) of a fit
+         over the data points.
+
+         - kSerial      : the points are evaluated one at the time (default)
+         - kVectorized  : the model function is evaluated on batches of points
+                          (see ROOT::Math::IParametricFunctionMultiDim::EvalBatch)
+         - kMultiThread : the batches are evaluated in parallel threads.
+                          The model function must be thread safe; the functions which are not
+                          (see ROOT::Math::IParametricFunctionMultiDim::IsThreadSafe, false for
+                          the interpreted TF1) are evaluated as with kVectorized.
+
+         For kVectorized and kMultiThread the points are split in chunks of a fixed size and the
+         partial sums of the chunks are added in the chunk order, so the result does not depend
+         on the number of threads used.
+
+         @ingroup FitMain
+      */
+      enum ExecutionPolicy {
+         kSerial,
+         kVectorized,
+         kMultiThread
+      };
+
+   } // end namespace Fit
+
+} // end namespace ROOT
+
+
+#endif /* ROOT_Fit_ExecutionPolicy */
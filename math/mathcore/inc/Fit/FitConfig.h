@@ -26,6 +26,10 @@
 #include "Math/IParamFunctionfwd.h"
 #endif
 
+#ifndef ROOT_Fit_ExecutionPolicy
+#include "Fit/ExecutionPolicy.h"
+#endif
+
 
 #include <vector>
 
@@ -183,6 +187,12 @@ public:
    bool UseWeightCorrection() const { return fWeightCorr; }
 
 
+   /// return the policy used to evaluate the objective function over the data points
+   ROOT::Fit::ExecutionPolicy GetExecutionPolicy() const { return fExecutionPolicy; }
+
+   /// return the number of threads used with the kMultiThread policy (0 means the number of cores)
+   unsigned int NThreads() const { return fNThreads; }
+
    /// return vector of parameter indeces for which the Minos Error will be computed
    const std::vector<unsigned int> & MinosParams() const { return fMinosParams; }
 
@@ -211,6 +221,17 @@ public:
    ///Update configuration after a fit using the FitResult
    void SetUpdateAfterFit(bool on = true) { fUpdateAfterFit = on; }
 
+   /**
+      set the policy used to evaluate the chi2 or the likelihood over the data points
+      (see ROOT::Fit::ExecutionPolicy) and the number of threads used with the kMultiThread
+      policy (0 means the number of cores).
+      The gradient of the objective function is always evaluated serially
+   */
+   void SetExecutionPolicy(ROOT::Fit::ExecutionPolicy policy, unsigned int nthreads = 0) {
+      fExecutionPolicy = policy;
+      fNThreads = nthreads;
+   }
+
 
    /**
       static function to control default minimizer type and algorithm
@@ -230,6 +251,8 @@ private:
    bool fMinosErrors;      // do full error analysis using Minos
    bool fUpdateAfterFit;   // update the configuration after a fit using the result
    bool fWeightCorr;       // apply correction to errors for weights fits
+   ROOT::Fit::ExecutionPolicy fExecutionPolicy;  // policy used to evaluate the objective function
+   unsigned int fNThreads; // number of threads used with kMultiThread (0 means the number of cores)
 
    std::vector<ROOT::Fit::ParameterSettings> fSettings;  // vector with the parameter settings
    std::vector<unsigned int> fMinosParams;               // vector with the parameter indeces for running Minos
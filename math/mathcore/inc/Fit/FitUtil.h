@@ -21,6 +21,10 @@
 #include "Fit/DataVectorfwd.h"
 #endif
 
+#ifndef ROOT_Fit_ExecutionPolicy
+#include "Fit/ExecutionPolicy.h"
+#endif
+
 
 namespace ROOT {
 
@@ -44,9 +48,12 @@ namespace FitUtil {
 
    /**
        evaluate the Chi2 given a model function and the data at the point x.
-       return also nPoints as the effective number of used points in the Chi2 evaluation
+       return also nPoints as the effective number of used points in the Chi2 evaluation.
+       The points are evaluated according to the given execution policy, using nThreads threads
+       for kMultiThread (0 means the number of cores)
    */
-   double EvaluateChi2(const IModelFunction & func, const BinData & data, const double * x, unsigned int & nPoints);
+   double EvaluateChi2(const IModelFunction & func, const BinData & data, const double * x, unsigned int & nPoints,
+                       ExecutionPolicy executionPolicy = kSerial, unsigned int nThreads = 0);
 
    /**
        evaluate the effective Chi2 given a model function and the data at the point x.
@@ -63,9 +70,11 @@ namespace FitUtil {
 
    /**
        evaluate the LogL given a model function and the data at the point x.
-       return also nPoints as the effective number of used points in the LogL evaluation
+       return also nPoints as the effective number of used points in the LogL evaluation.
+       The points are evaluated according to the given execution policy (see EvaluateChi2)
    */
-   double EvaluateLogL(const IModelFunction & func, const UnBinData & data, const double * x, int iWeight, bool extended, unsigned int & nPoints);
+   double EvaluateLogL(const IModelFunction & func, const UnBinData & data, const double * x, int iWeight, bool extended, unsigned int & nPoints,
+                       ExecutionPolicy executionPolicy = kSerial, unsigned int nThreads = 0);
 
    /**
        evaluate the LogL gradient given a model function and the data at the point x.
@@ -77,8 +86,10 @@ namespace FitUtil {
        evaluate the Poisson LogL given a model function and the data at the point x.
        return also nPoints as the effective number of used points in the LogL evaluation
        By default is extended, pass extedend to false if want to be not extended (MultiNomial)
+       The points are evaluated according to the given execution policy (see EvaluateChi2)
    */
-   double EvaluatePoissonLogL(const IModelFunction & func, const BinData & data, const double * x, int iWeight, bool extended, unsigned int & nPoints);
+   double EvaluatePoissonLogL(const IModelFunction & func, const BinData & data, const double * x, int iWeight, bool extended, unsigned int & nPoints,
+                              ExecutionPolicy executionPolicy = kSerial, unsigned int nThreads = 0);
 
    /**
        evaluate the Poisson LogL given a model function and the data at the point x.
@@ -386,6 +386,18 @@ public:
    */
    FitConfig & Config() { return fConfig; }
 
+   /**
+      set the policy used to evaluate the chi2 or the likelihood over the data points:
+      serially (kSerial, the default), on batches of points (kVectorized) or on batches
+      evaluated in nthreads parallel threads (kMultiThread, 0 means the number of cores).
+      The model function must be thread safe to use kMultiThread, otherwise it is evaluated
+      in a single thread (see ROOT::Math::IParametricFunctionMultiDim::IsThreadSafe).
+      See FitConfig::SetExecutionPolicy
+   */
+   void SetExecutionPolicy(ROOT::Fit::ExecutionPolicy policy, unsigned int nthreads = 0) {
+      fConfig.SetExecutionPolicy(policy, nthreads);
+   }
+
    /**
       query if fit is binned. In cse of false teh fit can be unbinned
       or is not defined (like in case of fitting through a ::FitFCN)
@@ -100,7 +100,9 @@ public:
       fWeight( f.fWeight ),
       fNEffPoints( f.fNEffPoints ),
       fGrad( f.fGrad)
-   {  }
+   {
+      this->SetExecutionPolicy(f.GetExecutionPolicy(), f.NThreads() );
+   }
 
 
    /**
@@ -113,6 +115,7 @@ public:
       fGrad = rhs.fGrad; 
       fIsExtended = rhs.fIsExtended;
       fWeight = rhs.fWeight; 
+      this->SetExecutionPolicy(rhs.GetExecutionPolicy(), rhs.NThreads() );
    }
 
 
@@ -166,7 +169,8 @@ private:
 #ifdef ROOT_FIT_PARALLEL
       return FitUtilParallel::EvaluateLogL(BaseFCN::ModelFunction(), BaseFCN::Data(), x, fNEffPoints);
 #else
-      return FitUtil::EvaluateLogL(BaseFCN::ModelFunction(), BaseFCN::Data(), x, fWeight, fIsExtended, fNEffPoints);
+      return FitUtil::EvaluateLogL(BaseFCN::ModelFunction(), BaseFCN::Data(), x, fWeight, fIsExtended, fNEffPoints,
+                                   BaseFCN::GetExecutionPolicy(), BaseFCN::NThreads() );
 #endif
    }
 
@@ -102,7 +102,9 @@ public:
       fWeight( f.fWeight ),
       fNEffPoints( f.fNEffPoints ),
       fGrad( f.fGrad)
-   {  }
+   {
+      this->SetExecutionPolicy(f.GetExecutionPolicy(), f.NThreads() );
+   }
 
    /**
       Assignment operator
@@ -114,6 +116,7 @@ public:
       fGrad = rhs.fGrad; 
       fIsExtended = rhs.fIsExtended;
       fWeight = rhs.fWeight; 
+      this->SetExecutionPolicy(rhs.GetExecutionPolicy(), rhs.NThreads() );
    }
 
 
@@ -165,7 +168,8 @@ private:
     */
    virtual double DoEval (const double * x) const {
       this->UpdateNCalls();
-      return FitUtil::EvaluatePoissonLogL(BaseFCN::ModelFunction(), BaseFCN::Data(), x, fWeight, fIsExtended, fNEffPoints);
+      return FitUtil::EvaluatePoissonLogL(BaseFCN::ModelFunction(), BaseFCN::Data(), x, fWeight, fIsExtended, fNEffPoints,
+                                          BaseFCN::GetExecutionPolicy(), BaseFCN::NThreads() );
    }
 
    // for derivatives
@@ -21,6 +21,8 @@
 #include "Math/Error.h"
 #endif
 
+#include <algorithm>
+
 
 
 namespace ROOT {
@@ -286,6 +288,21 @@ public:
          return fDataWrapper->Coords(ipoint);
    }
 
+   /**
+      copy the coordinates of the given fit point in x (of size NDim()).
+      Unlike Coords, it does not use an internal buffer when the data are not copied in,
+      so it can be called concurrently by several threads
+    */
+   void CopyCoords(unsigned int ipoint, double * x) const {
+      if (fDataVector) {
+         const double * c = &( (fDataVector->Data()) [ ipoint*fPointSize ] );
+         std::copy(c, c + fDim, x);
+         return;
+      }
+      for (unsigned int i = 0; i < fDim; ++i)
+         x[i] = fDataWrapper->Coord(ipoint, i);
+   }
+
    bool IsWeighted() const {
       return (fPointSize == fDim+1);
    }
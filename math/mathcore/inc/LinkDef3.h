@@ -11,6 +11,8 @@
 
 #pragma link C++ namespace ROOT::Fit;
 
+#pragma link C++ enum ROOT::Fit::ExecutionPolicy;
+
 #pragma link C++ class ROOT::Fit::DataRange;
 #pragma link C++ class ROOT::Fit::DataOptions;
 
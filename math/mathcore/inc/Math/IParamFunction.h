@@ -128,6 +128,24 @@ public:
 
    using BaseFunc::operator();
 
+   /**
+      Evaluate the function at the n points x[0],...,x[n-1] for the given parameters p
+      and store the values in f[0],...,f[n-1].
+      As operator()(x,p) it does not change the internal status of the function and it can be
+      called concurrently by several threads if the function evaluation is thread safe.
+      Use the virtual function DoEvalBatch to implement it
+   */
+   void EvalBatch(unsigned int n, const double * const * x, const double * p, double * f) const {
+      DoEvalBatch(n, x, p, f);
+   }
+
+   /**
+      Return true if the function can be evaluated (operator()(x,p) and EvalBatch) concurrently
+      by several threads. The default is true; functions whose evaluation changes a shared status,
+      as the interpreted ones, must return false and are then not evaluated in parallel by the fits
+   */
+   virtual bool IsThreadSafe() const { return true; }
+
 
 private:
 
@@ -137,6 +155,16 @@ private:
    */
    virtual double DoEvalPar(const double * x, const double * p) const = 0;
 
+   /**
+      Implementation of the evaluation on a batch of points. The default calls DoEvalPar for each point;
+      derived classes can re-implement it to evaluate the points together, for example with a loop
+      the compiler can vectorize, without a virtual call per point
+   */
+   virtual void DoEvalBatch(unsigned int n, const double * const * x, const double * p, double * f) const {
+      for (unsigned int i = 0; i < n; ++i)
+         f[i] = DoEvalPar(x[i], p);
+   }
+
    /**
       Implement the ROOT::Math::IBaseFunctionMultiDim interface DoEval(x) using the cached parameter values
    */
@@ -30,6 +30,8 @@
 #include <cmath>
 #include <cassert>
 #include <algorithm>
+#include <atomic>
+#include <thread>
 //#include <memory>
 
 //#define DEBUG
@@ -325,6 +327,50 @@ namespace ROOT {
 
 
 
+         // number of points of the chunks evaluated with the kVectorized and kMultiThread policies
+         const unsigned int kChunkSize = 1024;
+
+         // evaluate the nsums partial sums of the n data points with the given execution policy.
+         // The points are split in chunks of kChunkSize points and chunkFunc(begin, end, chunkSums)
+         // computes the sums of the points [begin,end). The chunks are shared among the threads
+         // and their sums are then added in the chunk order, so the result does not depend on the
+         // number of threads nor on the order in which the chunks are evaluated.
+         template <class ChunkFunc>
+         void EvaluateChunks(unsigned int n, ExecutionPolicy policy, unsigned int nThreads,
+                             unsigned int nsums, const ChunkFunc & chunkFunc, double * sums) {
+            unsigned int nchunks = (n + kChunkSize - 1) / kChunkSize;
+            std::vector<double> chunkSums(nchunks * nsums);
+            unsigned int nthreads = 1;
+            if (policy == kMultiThread) {
+               nthreads = (nThreads > 0) ? nThreads : std::thread::hardware_concurrency();
+               nthreads = std::min(nthreads, nchunks);
+            }
+            std::atomic<unsigned int> next(0);
+            auto worker = [&]() {
+               for (unsigned int ichunk = next++; ichunk < nchunks; ichunk = next++) {
+                  unsigned int begin = ichunk * kChunkSize;
+                  chunkFunc(begin, std::min(n, begin + kChunkSize), &chunkSums[ichunk * nsums]);
+               }
+            };
+            std::vector<std::thread> threads;
+            for (unsigned int i = 1; i < nthreads; ++i)
+               threads.push_back(std::thread(worker));
+            worker();
+            for (unsigned int i = 0; i < threads.size(); ++i)
+               threads[i].join();
+
+            std::fill(sums, sums + nsums, 0.);
+            for (unsigned int ichunk = 0; ichunk < nchunks; ++ichunk)
+               for (unsigned int k = 0; k < nsums; ++k)
+                  sums[k] += chunkSums[ichunk * nsums + k];
+         }
+
+         // the policy used to evaluate func: the functions which can not be evaluated concurrently
+         // (see IParamMultiFunction::IsThreadSafe) are evaluated in a single thread
+         ExecutionPolicy CheckExecutionPolicy(const IModelFunction & func, ExecutionPolicy policy) {
+            return (policy == kMultiThread && !func.IsThreadSafe()) ? kVectorized : policy;
+         }
+
       } // end namespace  FitUtil
 
 
@@ -333,7 +379,8 @@ namespace ROOT {
 // for chi2 functions
 //___________________________________________________________________________________________________________________________
 
-double FitUtil::EvaluateChi2(const IModelFunction & func, const BinData & data, const double * p, unsigned int & nPoints) {
+double FitUtil::EvaluateChi2(const IModelFunction & func, const BinData & data, const double * p, unsigned int & nPoints,
+                             ExecutionPolicy executionPolicy, unsigned int nThreads) {
    // evaluate the chi2 given a  function reference  , the data and returns the value and also in nPoints
    // the actual number of used points
    // normal chi2 using only error on values (from fitting histogram)
@@ -378,6 +425,57 @@ double FitUtil::EvaluateChi2(const IModelFunction & func, const BinData & data,
       xc.resize(data.NDim() );
    }
 
+   executionPolicy = CheckExecutionPolicy(func, executionPolicy);
+   if (executionPolicy != kSerial && !useBinIntegral) {
+      // evaluate the function on batches of points, possibly in parallel threads
+      unsigned int ndim = data.NDim();
+      auto chunkChi2 = [&](unsigned int begin, unsigned int end, double * sums) {
+         unsigned int m = end - begin;
+         std::vector<double> xbuf(m * ndim);
+         std::vector<const double *> xp(m);
+         std::vector<double> yv(m), invErrors(m), fval(m), binVolumes(m, 1.0);
+         for (unsigned int k = 0; k < m; ++k) {
+            double * x = &xbuf[k * ndim];
+            data.CopyPoint(begin + k, x, yv[k], invErrors[k]);
+            if (useBinVolume) {
+               // use the bin center and normalize the bin volume using the reference value
+               const double * x2 = data.BinUpEdge(begin + k);
+               double binVolume = 1.0;
+               for (unsigned int j = 0; j < ndim; ++j) {
+                  binVolume *= std::abs( x2[j]-x[j] );
+                  x[j] = 0.5*(x2[j]+ x[j]);
+               }
+               binVolumes[k] = binVolume * wrefVolume;
+            }
+            xp[k] = x;
+         }
+         func.EvalBatch(m, &xp.front(), p, &fval.front());
+
+         double chi2Chunk = 0;
+         for (unsigned int k = 0; k < m; ++k) {
+            double y = yv[k];
+            double invError = invErrors[k];
+            double fvalk = (useBinVolume) ? fval[k] * binVolumes[k] : fval[k];
+            if (useExpErrors) {
+               double invWeight = y * invError * invError;
+               if (invError == 0) invWeight = (data.SumOfError2() > 0) ? data.SumOfContent()/ data.SumOfError2() : 1.0;
+               double invError2 = (fvalk > 0) ? invWeight / fvalk : 0.0;
+               invError = std::sqrt(invError2);
+            }
+            if (invError > 0) {
+               double tmp = ( y -fvalk )* invError;
+               double resval = tmp * tmp;
+               // avoid inifinity or nan in chi2 values due to wrong function values
+               chi2Chunk += ( resval < maxResValue ) ? resval : maxResValue;
+            }
+         }
+         sums[0] = chi2Chunk;
+      };
+      EvaluateChunks(n, executionPolicy, nThreads, 1, chunkChi2, &chi2);
+      nPoints = n;
+      return chi2;
+   }
+
    (const_cast<IModelFunction &>(func)).SetParameters(p);
    for (unsigned int i = 0; i < n; ++ i) {
 
@@ -889,7 +987,8 @@ double FitUtil::EvaluatePdf(const IModelFunction & func, const UnBinData & data,
 }
 
 double FitUtil::EvaluateLogL(const IModelFunction & func, const UnBinData & data, const double * p,
-                                   int iWeight,  bool extended, unsigned int &nPoints) {
+                                   int iWeight,  bool extended, unsigned int &nPoints,
+                                   ExecutionPolicy executionPolicy, unsigned int nThreads) {
    // evaluate the LogLikelihood
 
    unsigned int n = data.Size();
@@ -923,39 +1022,84 @@ double FitUtil::EvaluateLogL(const IModelFunction & func, const UnBinData & data
    double sumW = 0;
    double sumW2 = 0;
 
-   for (unsigned int i = 0; i < n; ++ i) {
-      const double * x = data.Coords(i);
+   executionPolicy = CheckExecutionPolicy(func, executionPolicy);
+   if (executionPolicy != kSerial && !normalizeFunc) {
+      // evaluate the function on batches of points, possibly in parallel threads
+      unsigned int ndim = data.NDim();
+      auto chunkLogL = [&](unsigned int begin, unsigned int end, double * sums) {
+         unsigned int m = end - begin;
+         std::vector<double> xbuf(m * ndim);
+         std::vector<const double *> xp(m);
+         std::vector<double> fval(m);
+         for (unsigned int k = 0; k < m; ++k) {
+            data.CopyCoords(begin + k, &xbuf[k * ndim]);
+            xp[k] = &xbuf[k * ndim];
+         }
+         func.EvalBatch(m, &xp.front(), p, &fval.front());
+
+         double loglChunk = 0;
+         double sumWChunk = 0;
+         double sumW2Chunk = 0;
+         for (unsigned int k = 0; k < m; ++k) {
+            double logval =  ROOT::Math::Util::EvalLog( fval[k]);
+            if (iWeight > 0) {
+               double weight = data.Weight(begin + k);
+               logval *= weight;
+               if (iWeight ==2) {
+                  logval *= weight;
+                  if (extended) {
+                     sumWChunk += weight;
+                     sumW2Chunk += weight*weight;
+                  }
+               }
+            }
+            loglChunk += logval;
+         }
+         sums[0] = loglChunk;
+         sums[1] = sumWChunk;
+         sums[2] = sumW2Chunk;
+      };
+      double sums[3];
+      EvaluateChunks(n, executionPolicy, nThreads, 3, chunkLogL, sums);
+      logl = sums[0];
+      sumW = sums[1];
+      sumW2 = sums[2];
+   }
+   else {
+      for (unsigned int i = 0; i < n; ++ i) {
+         const double * x = data.Coords(i);
 #ifdef USE_PARAMCACHE
-       double fval = func ( x );
+          double fval = func ( x );
 #else
-       double fval = func ( x, p );
+          double fval = func ( x, p );
 #endif
-      if (normalizeFunc) fval = fval / norm;
+         if (normalizeFunc) fval = fval / norm;
 
 #ifdef DEBUG
-      std::cout << "x [ " << data.NDim() << " ] = ";
-      for (unsigned int j = 0; j < data.NDim(); ++j)
-         std::cout << x[j] << "\t";
-      std::cout << "\tpar = [ " << func.NPar() << " ] =  ";
-      for (unsigned int ipar = 0; ipar < func.NPar(); ++ipar)
-         std::cout << p[ipar] << "\t";
-      std::cout << "\tfval = " << fval << std::endl;
+         std::cout << "x [ " << data.NDim() << " ] = ";
+         for (unsigned int j = 0; j < data.NDim(); ++j)
+            std::cout << x[j] << "\t";
+         std::cout << "\tpar = [ " << func.NPar() << " ] =  ";
+         for (unsigned int ipar = 0; ipar < func.NPar(); ++ipar)
+            std::cout << p[ipar] << "\t";
+         std::cout << "\tfval = " << fval << std::endl;
 #endif
-      // function EvalLog protects against negative or too small values of fval
-      double logval =  ROOT::Math::Util::EvalLog( fval);
-      if (iWeight > 0) {
-         double weight = data.Weight(i);
-         logval *= weight;
-         if (iWeight ==2) {
-            logval *= weight; // use square of weights in likelihood
-            if (extended) {
-               // needed sum of weights and sum of weight square if likelkihood is extended
-               sumW += weight;
-               sumW2 += weight*weight;
+         // function EvalLog protects against negative or too small values of fval
+         double logval =  ROOT::Math::Util::EvalLog( fval);
+         if (iWeight > 0) {
+            double weight = data.Weight(i);
+            logval *= weight;
+            if (iWeight ==2) {
+               logval *= weight; // use square of weights in likelihood
+               if (extended) {
+                  // needed sum of weights and sum of weight square if likelkihood is extended
+                  sumW += weight;
+                  sumW2 += weight*weight;
+               }
             }
          }
+         logl += logval;
       }
-      logl += logval;
    }
 
    if (extended) {
@@ -1159,7 +1303,8 @@ double FitUtil::EvaluatePoissonBinPdf(const IModelFunction & func, const BinData
 }
 
 double FitUtil::EvaluatePoissonLogL(const IModelFunction & func, const BinData & data,
-                                    const double * p, int iWeight, bool extended,  unsigned int &   nPoints ) {
+                                    const double * p, int iWeight, bool extended,  unsigned int &   nPoints,
+                                    ExecutionPolicy executionPolicy, unsigned int nThreads ) {
    // evaluate the Poisson Log Likelihood
    // for binned likelihood fits
    // this is Sum ( f(x_i)  -  y_i * log( f (x_i) ) )
@@ -1217,6 +1362,65 @@ double FitUtil::EvaluatePoissonLogL(const IModelFunction & func, const BinData &
    // double wTot = 0; // sum of all weights
    // double w2Tot = 0; // sum of weight squared  (these are needed for useW2)
 
+   executionPolicy = CheckExecutionPolicy(func, executionPolicy);
+   if (executionPolicy != kSerial && !useBinIntegral) {
+      // evaluate the function on batches of points, possibly in parallel threads
+      unsigned int ndim = data.NDim();
+      auto chunkLogL = [&](unsigned int begin, unsigned int end, double * sums) {
+         unsigned int m = end - begin;
+         std::vector<double> xbuf(m * ndim);
+         std::vector<const double *> xp(m);
+         std::vector<double> fval(m), binVolumes(m, 1.0);
+         for (unsigned int k = 0; k < m; ++k) {
+            double * x = &xbuf[k * ndim];
+            data.CopyCoords(begin + k, x);
+            if (useBinVolume) {
+               // use the bin center and normalize the bin volume using the reference value
+               const double * x2 = data.BinUpEdge(begin + k);
+               double binVolume = 1.0;
+               for (unsigned int j = 0; j < ndim; ++j) {
+                  binVolume *= std::abs( x2[j]-x[j] );
+                  x[j] = 0.5*(x2[j]+ x[j]);
+               }
+               binVolumes[k] = binVolume * wrefVolume;
+            }
+            xp[k] = x;
+         }
+         func.EvalBatch(m, &xp.front(), p, &fval.front());
+
+         double nloglikeChunk = 0;
+         unsigned int nPointsChunk = 0;
+         for (unsigned int k = 0; k < m; ++k) {
+            double y = data.Value(begin + k);
+            double fvalk = (useBinVolume) ? fval[k] * binVolumes[k] : fval[k];
+            fvalk = std::max(fvalk, 0.0);
+            double tmp = 0;
+            if (useW2) {
+               if (y != 0) {
+                  double error = data.Error(begin + k);
+                  double weight = (error*error)/y;  // this is the bin effective weight
+                  if (extended) tmp = fvalk * weight;
+                  tmp -= weight * y * ROOT::Math::Util::EvalLog( fvalk);
+               }
+            }
+            else {
+               if (extended) tmp = fvalk -y ;
+               if (y >  0) {
+                  tmp +=  y *  (ROOT::Math::Util::EvalLog( y) - ROOT::Math::Util::EvalLog(fvalk));
+                  nPointsChunk++;
+               }
+            }
+            nloglikeChunk += tmp;
+         }
+         sums[0] = nloglikeChunk;
+         sums[1] = nPointsChunk;
+      };
+      double sums[2];
+      EvaluateChunks(n, executionPolicy, nThreads, 2, chunkLogL, sums);
+      nPoints = (unsigned int) sums[1];
+      return sums[0];
+   }
+
 
    for (unsigned int i = 0; i < n; ++ i) {
       const double * x1 = data.Coords(i);
@@ -343,6 +343,7 @@ bool Fitter::DoLeastSquareFit() {
    if (!fUseGradient) {
       // do minimzation without using the gradient
       Chi2FCN<BaseFunc> chi2(data,fFunc);
+      chi2.SetExecutionPolicy(fConfig.GetExecutionPolicy(), fConfig.NThreads() );
       fFitType = chi2.Type();
       return DoMinimization (chi2);
    }
@@ -353,6 +354,7 @@ bool Fitter::DoLeastSquareFit() {
       std::shared_ptr<IGradModelFunction> gradFun = std::dynamic_pointer_cast<IGradModelFunction>(fFunc);
       if (gradFun) {
          Chi2FCN<BaseGradFunc> chi2(data,gradFun);
+         chi2.SetExecutionPolicy(fConfig.GetExecutionPolicy(), fConfig.NThreads() );
          fFitType = chi2.Type();
          return DoMinimization (chi2);
       }
@@ -392,10 +394,12 @@ bool Fitter::DoBinnedLikelihoodFit(bool extended) {
 
    // create a chi2 function to be used for the equivalent chi-square
    Chi2FCN<BaseFunc> chi2(data,fFunc);
+   chi2.SetExecutionPolicy(fConfig.GetExecutionPolicy(), fConfig.NThreads() );
 
    if (!fUseGradient) {
       // do minimization without using the gradient
       PoissonLikelihoodFCN<BaseFunc> logl(data,fFunc, useWeight, extended);
+      logl.SetExecutionPolicy(fConfig.GetExecutionPolicy(), fConfig.NThreads() );
       fFitType = logl.Type();
       // do minimization
       if (!DoMinimization (logl, &chi2) ) return false;
@@ -419,6 +423,7 @@ bool Fitter::DoBinnedLikelihoodFit(bool extended) {
          MATH_WARN_MSG("Fitter::DoLikelihoodFit","Not-extended binned fit with gradient not yet supported - do an extended fit");
       }
       PoissonLikelihoodFCN<BaseGradFunc> logl(data,gradFun, useWeight, true);
+      logl.SetExecutionPolicy(fConfig.GetExecutionPolicy(), fConfig.NThreads() );
       fFitType = logl.Type();
       // do minimization
       if (!DoMinimization (logl, &chi2) ) return false;
@@ -466,6 +471,7 @@ bool Fitter::DoUnbinnedLikelihoodFit(bool extended) {
    if (!fUseGradient) {
       // do minimization without using the gradient
       LogLikelihoodFCN<BaseFunc> logl(data,fFunc, useWeight, extended);
+      logl.SetExecutionPolicy(fConfig.GetExecutionPolicy(), fConfig.NThreads() );
       fFitType = logl.Type();
       if (!DoMinimization (logl) ) return false;
       if (useWeight) {
@@ -484,6 +490,7 @@ bool Fitter::DoUnbinnedLikelihoodFit(bool extended) {
             MATH_WARN_MSG("Fitter::DoLikelihoodFit","Extended unbinned fit with gradient not yet supported - do a not-extended fit");
          }
          LogLikelihoodFCN<BaseGradFunc> logl(data,gradFun,useWeight, extended);
+         logl.SetExecutionPolicy(fConfig.GetExecutionPolicy(), fConfig.NThreads() );
          fFitType = logl.Type();
          if (!DoMinimization (logl) ) return false;
          if (useWeight) {
@@ -21,6 +21,10 @@
 #include "Minuit2/MnUserParameterState.h"
 #endif
 
+#ifndef ROOT_Minuit2_MnExecutor
+#include "Minuit2/MnExecutor.h"
+#endif
+
 #ifndef ROOT_Math_IFunctionfwd
 #include "Math/IFunctionfwd.h"
 #endif
@@ -290,6 +294,13 @@ public:
    ///                     = 0 : store only first and last state to save memory
    void SetStorageLevel(int level);
 
+   /// set the execution of the function calls of the numerical gradient and of Hesse:
+   /// serial (default), in nworkers threads (the function must then be thread safe) or
+   /// in nworkers forked processes (nworkers = 0 means one per core).
+   /// It can also be set with the extra options "Executor" ("serial", "threads" or "processes")
+   /// and "NumWorkers" of the Minuit2 default options
+   void SetExecutor(ROOT::Minuit2::MnExecutor::EType type, unsigned int nworkers = 0);
+
    /// return the minimizer state (containing values, step size , etc..)
    const ROOT::Minuit2::MnUserParameterState & State() { return fState; }
 
@@ -312,6 +323,7 @@ private:
 
    unsigned int fDim;       // dimension of the function to be minimized
    bool fUseFumili;
+   ROOT::Minuit2::MnExecutor fExecutor;  // executor of the function calls of gradient and Hesse
 
    ROOT::Minuit2::MnUserParameterState fState;
    // std::vector<ROOT::Minuit2::MinosError> fMinosErrors;
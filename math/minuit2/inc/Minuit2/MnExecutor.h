@@ -0,0 +1,78 @@
+// @(#)root/minuit2:$Id$
+
+/**********************************************************************
+ *                                                                    *
+ * Copyright (c) 2015 LCG ROOT Math team,  CERN/PH-SFT                *
+ *                                                                    *
+ **********************************************************************/
+
+#ifndef ROOT_Minuit2_MnExecutor
+#define ROOT_Minuit2_MnExecutor
+
+#include <functional>
+
+namespace ROOT {
+
+   namespace Minuit2 {
+
+//_________________________________________________________________________
+/**
+    Class executing a set of independent tasks, used to evaluate in parallel
+    the function calls of the numerical gradient (Numerical2PGradientCalculator)
+    and of the Hessian matrix (MnHesse). The execution can be:
+      kSerial    : the tasks are run one after the other in the calling thread
+      kThreads   : the tasks are shared among nworkers threads of the process;
+                   the FCN must then be thread safe
+      kProcesses : the tasks are shared among nworkers processes forked from the
+                   calling one, which return their results through pipes; any
+                   change made by the FCN to the state of a child process is
+                   lost (not available on Windows, where the tasks run serially).
+                   A forked child only has a copy of the calling thread and could
+                   deadlock on a lock held by another thread at the time of the fork,
+                   so the tasks run serially when the process runs other threads
+                   (as counted in /proc/self/task on Linux or by the Mach kernel on
+                   MacOS; elsewhere the caller must make sure no other thread runs)
+    A number of workers equal to zero means one per available core.
+    The executor is selected at run time with MnStrategy::SetExecutor.
+ */
+
+class MnExecutor {
+
+public:
+
+   enum EType { kSerial, kThreads, kProcesses };
+
+   // a task computes the results of the task of given index in the given array
+   typedef std::function<void(unsigned int, double *)> Task;
+
+   explicit MnExecutor(EType type = kSerial, unsigned int nworkers = 0) :
+      fType(type), fNWorkers(nworkers) {}
+
+   ~MnExecutor() {}
+
+   EType Type() const {return fType;}
+
+   // number of workers used to execute the tasks
+   unsigned int NWorkers() const;
+
+   // true if the tasks are executed by more than one worker
+   bool IsParallel() const {return fType != kSerial && NWorkers() > 1;}
+
+   // run the tasks 0,..,ntasks-1 each computing nresults values;
+   // the results of task i are stored in results[i*nresults],...
+   void Run(unsigned int ntasks, unsigned int nresults, const Task & task, double * results) const;
+
+private:
+
+   void RunThreads(unsigned int ntasks, unsigned int nresults, const Task & task, double * results) const;
+   bool RunProcesses(unsigned int ntasks, unsigned int nresults, const Task & task, double * results) const;
+
+   EType fType;
+   unsigned int fNWorkers;
+};
+
+  }  // namespace Minuit2
+
+}  // namespace ROOT
+
+#endif  // ROOT_Minuit2_MnExecutor
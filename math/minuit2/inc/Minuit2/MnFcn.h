@@ -42,6 +42,11 @@ public:
   virtual double operator()(const MnAlgebraicVector&) const;
   unsigned int NumOfCalls() const {return fNumCall;}
 
+  // evaluate the function without counting the call, used by the tasks run in
+  // parallel (see MnExecutor) which report their number of calls with AddCalls
+  virtual double Eval(const MnAlgebraicVector&) const;
+  void AddCalls(int ncall) const {fNumCall += ncall;}
+
   //
   //forward interface
   //
@@ -10,6 +10,8 @@
 #ifndef ROOT_Minuit2_MnStrategy
 #define ROOT_Minuit2_MnStrategy
 
+#include "Minuit2/MnExecutor.h"
+
 namespace ROOT {
 
    namespace Minuit2 {
@@ -21,7 +23,9 @@ namespace ROOT {
     acts on: Migrad (behavioural),
              Minos (lowers strategy by 1 for Minos-own minimization),
              Hesse (iterations),
-             Numerical2PDerivative (iterations)
+             Numerical2PDerivative (iterations);
+    defines also the executor of the function calls of the numerical
+    gradient and of Hesse (serial by default, see MnExecutor)
  */
 
 class MnStrategy {
@@ -49,6 +53,8 @@ public:
 
    int StorageLevel() const { return fStoreLevel; }
 
+   MnExecutor Executor() const {return MnExecutor(fExecType, fExecNWorkers);}
+
    bool IsLow() const {return fStrategy == 0;}
    bool IsMedium() const {return fStrategy == 1;}
    bool IsHigh() const {return fStrategy >= 2;}
@@ -69,6 +75,10 @@ public:
    // set storage level of iteration quantities
    // 0 = store only last iterations 1 = full storage (default)
    void SetStorageLevel(unsigned int level) { fStoreLevel = level; }
+
+   // set the execution of the function calls of the numerical gradient and of Hesse
+   // (serial, in threads or in processes) with nworkers workers (0 = one per core)
+   void SetExecutor(MnExecutor::EType type, unsigned int nworkers = 0) { fExecType = type; fExecNWorkers = nworkers; }
 private:
 
    unsigned int fStrategy;
@@ -81,6 +91,8 @@ private:
    double fHessTlrG2;
    unsigned int fHessGradNCyc;
    int fStoreLevel;
+   MnExecutor::EType fExecType;
+   unsigned int fExecNWorkers;
 };
 
   }  // namespace Minuit2
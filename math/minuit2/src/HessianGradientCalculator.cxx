@@ -15,8 +15,10 @@
 #include "Minuit2/MinimumParameters.h"
 #include "Minuit2/FunctionGradient.h"
 #include "Minuit2/MnStrategy.h"
+#include "Minuit2/MnExecutor.h"
 
 #include <math.h>
+#include <vector>
 
 //#define DEBUG
 
@@ -66,6 +68,62 @@ double HessianGradientCalculator::GradTolerance() const {
    return Strategy().GradientTolerance();
 }
 
+// refine the first derivative grd of the function for the internal parameter i iterating from the step
+// gstep, which is updated, and return the uncertainty of the derivative in dgrd. The component i of x
+// is changed during the calculation and restored at the end. Return the number of function calls, which
+// are not counted by the function (see MnFcn::Eval)
+static int HessianDerivative(const HessianGradientCalculator& gc, unsigned int i, double dfmin, double g2,
+                             MnAlgebraicVector& x, double& grd, double& gstep, double& dgrd) {
+
+   int ncall = 0;
+   double xtf = x(i);
+   double dmin = 4.*gc.Precision().Eps2()*(xtf + gc.Precision().Eps2());
+   double epspri = gc.Precision().Eps2() + fabs(grd*gc.Precision().Eps2());
+   double optstp = sqrt(dfmin/(fabs(g2)+epspri));
+   double d = 0.2*fabs(gstep);
+   if(d > optstp) d = optstp;
+   if(d < dmin) d = dmin;
+   double chgold = 10000.;
+   double dgmin = 0.;
+   double grdold = 0.;
+   double grdnew = 0.;
+   for(unsigned int j = 0; j < gc.Ncycle(); j++)  {
+      x(i) = xtf + d;
+      double fs1 = gc.Fcn().Eval(x);
+      x(i) = xtf - d;
+      double fs2 = gc.Fcn().Eval(x);
+      x(i) = xtf;
+      ncall += 2;
+      //       double sag = 0.5*(fs1+fs2-2.*fcnmin);
+      //LM: should I calculate also here second derivatives ???
+
+      grdold = grd;
+      grdnew = (fs1-fs2)/(2.*d);
+      dgmin = gc.Precision().Eps()*(fabs(fs1) + fabs(fs2))/d;
+      //if(fabs(grdnew) < Precision().Eps()) break;
+      if (grdnew == 0) break;
+      double change = fabs((grdold-grdnew)/grdnew);
+      if(change > chgold && j > 1) break;
+      chgold = change;
+      grd = grdnew;
+      //LM : update also the step sizes
+      gstep = d;
+
+      if(change < 0.05) break;
+      if(fabs(grdold-grdnew) < dgmin) break;
+      if(d < dmin) break;
+      d *= 0.2;
+   }
+
+   dgrd = std::max(dgmin, fabs(grdold-grdnew));
+
+#ifdef DEBUG
+   std::cout << "HGC Param : " << i << "\t new g1 = " << grd << " gstep = " << d << " dgrd = " << dgrd << std::endl;
+#endif
+
+   return ncall;
+}
+
 std::pair<FunctionGradient, MnAlgebraicVector> HessianGradientCalculator::DeltaGradient(const MinimumParameters& par, const FunctionGradient& Gradient) const {
    // calculate gradient for Hessian
    assert(par.IsValid());
@@ -84,6 +142,34 @@ std::pair<FunctionGradient, MnAlgebraicVector> HessianGradientCalculator::DeltaG
 
    unsigned int n = x.size();
    MnAlgebraicVector dgrd(n);
+   int ncall = 0;
+
+   MnExecutor executor = Strategy().Executor();
+   if (executor.IsParallel()) {
+
+      // refine the derivative of each parameter in a separate task, which returns
+      // the derivative, the step, its uncertainty and the number of function calls
+      std::vector<double> results(4*n);
+      executor.Run(n, 4, [&](unsigned int i, double * res) {
+            MnAlgebraicVector xi = x;
+            double grdi = grd(i);
+            double gstepi = gstep(i);
+            double dgrdi = 0.;
+            res[3] = HessianDerivative(*this, i, dfmin, g2(i), xi, grdi, gstepi, dgrdi);
+            res[0] = grdi;
+            res[1] = gstepi;
+            res[2] = dgrdi;
+         }, &results[0]);
+      for(unsigned int i = 0; i < n; i++) {
+         grd(i) = results[4*i];
+         gstep(i) = results[4*i+1];
+         dgrd(i) = results[4*i+2];
+         ncall += int(results[4*i+3]);
+      }
+      Fcn().AddCalls(ncall);
+
+      return std::pair<FunctionGradient, MnAlgebraicVector>(FunctionGradient(grd, g2, gstep), dgrd);
+   }
 
    MPIProcess mpiproc(n,0);
    // initial starting values
@@ -91,51 +177,9 @@ std::pair<FunctionGradient, MnAlgebraicVector> HessianGradientCalculator::DeltaG
    unsigned int endElementIndex = mpiproc.EndElementIndex();
 
    for(unsigned int i = startElementIndex; i < endElementIndex; i++) {
-      double xtf = x(i);
-      double dmin = 4.*Precision().Eps2()*(xtf + Precision().Eps2());
-      double epspri = Precision().Eps2() + fabs(grd(i)*Precision().Eps2());
-      double optstp = sqrt(dfmin/(fabs(g2(i))+epspri));
-      double d = 0.2*fabs(gstep(i));
-      if(d > optstp) d = optstp;
-      if(d < dmin) d = dmin;
-      double chgold = 10000.;
-      double dgmin = 0.;
-      double grdold = 0.;
-      double grdnew = 0.;
-      for(unsigned int j = 0; j < Ncycle(); j++)  {
-         x(i) = xtf + d;
-         double fs1 = Fcn()(x);
-         x(i) = xtf - d;
-         double fs2 = Fcn()(x);
-         x(i) = xtf;
-         //       double sag = 0.5*(fs1+fs2-2.*fcnmin);
-         //LM: should I calculate also here second derivatives ???
-
-         grdold = grd(i);
-         grdnew = (fs1-fs2)/(2.*d);
-         dgmin = Precision().Eps()*(fabs(fs1) + fabs(fs2))/d;
-         //if(fabs(grdnew) < Precision().Eps()) break;
-         if (grdnew == 0) break;
-         double change = fabs((grdold-grdnew)/grdnew);
-         if(change > chgold && j > 1) break;
-         chgold = change;
-         grd(i) = grdnew;
-         //LM : update also the step sizes
-         gstep(i) = d;
-
-         if(change < 0.05) break;
-         if(fabs(grdold-grdnew) < dgmin) break;
-         if(d < dmin) break;
-         d *= 0.2;
-      }
-
-      dgrd(i) = std::max(dgmin, fabs(grdold-grdnew));
-
-#ifdef DEBUG
-      std::cout << "HGC Param : " << i << "\t new g1 = " << grd(i) << " gstep = " << d << " dgrd = " << dgrd(i) << std::endl;
-#endif
-
+      ncall += HessianDerivative(*this, i, dfmin, g2(i), x, grd(i), gstep(i), dgrd(i));
    }
+   Fcn().AddCalls(ncall);
 
    mpiproc.SyncVector(grd);
    mpiproc.SyncVector(gstep);
@@ -456,6 +456,18 @@ bool Minuit2Minimizer::Minimize() {
       bool ret = minuit2Opt->GetValue("StorageLevel",storageLevel);
       if (ret) SetStorageLevel(storageLevel);
 
+      std::string execName;
+      int nWorkers = fExecutor.NWorkers();
+      bool retWorkers = minuit2Opt->GetValue("NumWorkers",nWorkers);
+      if (minuit2Opt->GetValue("Executor",execName) || retWorkers) {
+         std::transform(execName.begin(), execName.end(), execName.begin(), (int(*)(int)) tolower );
+         ROOT::Minuit2::MnExecutor::EType execType = fExecutor.Type();
+         if (execName == "serial")    execType = ROOT::Minuit2::MnExecutor::kSerial;
+         if (execName == "threads")   execType = ROOT::Minuit2::MnExecutor::kThreads;
+         if (execName == "processes") execType = ROOT::Minuit2::MnExecutor::kProcesses;
+         SetExecutor(execType, nWorkers > 0 ? nWorkers : 0);
+      }
+
       if (printLevel > 0) {
          std::cout << "Minuit2Minimizer::Minuit  - Changing default options" << std::endl;
          minuit2Opt->Print();
@@ -464,6 +476,9 @@ bool Minuit2Minimizer::Minimize() {
 
    }
 
+   // set the executor of the function calls for the gradient and Hesse
+   strategy.SetExecutor(fExecutor.Type(), fExecutor.NWorkers());
+
    // set a minimizer tracer object (default for printlevel=10, from gROOT for printLevel=11)
    // use some special print levels
    MnTraceObject * traceObj = 0;
@@ -800,7 +815,9 @@ bool Minuit2Minimizer::GetMinosError(unsigned int i, double & errLow, double & e
    if (Precision() > 0) fState.SetPrecision(Precision());
 
 
-   ROOT::Minuit2::MnMinos minos( *fMinuitFCN, *fMinimum);
+   ROOT::Minuit2::MnStrategy minosStrategy(1);
+   minosStrategy.SetExecutor(fExecutor.Type(), fExecutor.NWorkers());
+   ROOT::Minuit2::MnMinos minos( *fMinuitFCN, *fMinimum, minosStrategy);
 
    // run MnCross
    MnCross low;
@@ -1037,7 +1054,9 @@ bool Minuit2Minimizer::Hesse( ) {
    // set the precision if needed
    if (Precision() > 0) fState.SetPrecision(Precision());
 
-   ROOT::Minuit2::MnHesse hesse( strategy );
+   ROOT::Minuit2::MnStrategy hesseStrategy(strategy);
+   hesseStrategy.SetExecutor(fExecutor.Type(), fExecutor.NWorkers());
+   ROOT::Minuit2::MnHesse hesse( hesseStrategy );
 
 
    // case when function minimum exists
@@ -1134,6 +1153,11 @@ void Minuit2Minimizer::SetStorageLevel(int level) {
    fMinimizer->Builder().SetStorageLevel(level);
  }
 
+void Minuit2Minimizer::SetExecutor(ROOT::Minuit2::MnExecutor::EType type, unsigned int nworkers) {
+   // set the executor of the function calls of the numerical gradient and of Hesse
+   fExecutor = ROOT::Minuit2::MnExecutor(type, nworkers);
+}
+
 } // end namespace Minuit2
 
 } // end namespace ROOT
@@ -0,0 +1,230 @@
+// @(#)root/minuit2:$Id$
+
+/**********************************************************************
+ *                                                                    *
+ * Copyright (c) 2015 LCG ROOT Math team,  CERN/PH-SFT                *
+ *                                                                    *
+ **********************************************************************/
+
+#include "Minuit2/MnExecutor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
+#include <cstdio>
+#include <iostream>
+
+#ifndef _WIN32
+#include <errno.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <dirent.h>
+#endif
+
+#ifdef __APPLE__
+#include <mach/mach.h>
+#endif
+
+#if defined(DEBUG) || defined(WARNINGMSG)
+#include "Minuit2/MnPrint.h"
+#endif
+
+namespace ROOT {
+
+   namespace Minuit2 {
+
+
+unsigned int MnExecutor::NWorkers() const {
+   // return the number of workers, one per available core if not specified
+   if (fNWorkers > 0) return fNWorkers;
+   unsigned int ncores = std::thread::hardware_concurrency();
+   return (ncores > 0) ? ncores : 1;
+}
+
+void MnExecutor::Run(unsigned int ntasks, unsigned int nresults, const Task & task, double * results) const {
+   // run the tasks with the workers of the executor. The tasks are run serially when there is
+   // only one worker or one task, or when the child processes cannot be created (also when the
+   // process runs other threads)
+   if (ntasks == 0) return;
+   if (IsParallel() && ntasks > 1) {
+      if (fType == kThreads) {
+         RunThreads(ntasks, nresults, task, results);
+         return;
+      }
+      if (fType == kProcesses && RunProcesses(ntasks, nresults, task, results)) return;
+   }
+   for (unsigned int i = 0; i < ntasks; ++i)
+      task(i, results + i*nresults);
+}
+
+void MnExecutor::RunThreads(unsigned int ntasks, unsigned int nresults, const Task & task, double * results) const {
+   // run the tasks in threads, each thread taking the next task to run until all are done.
+   // The calling thread works as well. An exception thrown by a task is rethrown after all threads finished
+   unsigned int nthreads = std::min(NWorkers(), ntasks);
+   std::atomic<unsigned int> next(0);
+   std::vector<std::exception_ptr> errors(nthreads);
+   auto worker = [&](unsigned int ith) {
+      try {
+         for (unsigned int i = next++; i < ntasks; i = next++)
+            task(i, results + i*nresults);
+      }
+      catch (...) {
+         errors[ith] = std::current_exception();
+         next = ntasks;
+      }
+   };
+   std::vector<std::thread> threads;
+   threads.reserve(nthreads-1);
+   for (unsigned int ith = 1; ith < nthreads; ++ith)
+      threads.push_back(std::thread(worker, ith));
+   worker(0);
+   for (unsigned int ith = 0; ith < threads.size(); ++ith)
+      threads[ith].join();
+   for (unsigned int ith = 0; ith < nthreads; ++ith)
+      if (errors[ith]) std::rethrow_exception(errors[ith]);
+}
+
+#ifndef _WIN32
+
+static unsigned int NumberOfThreads() {
+   // return the number of threads of the current process, 0 if it cannot be determined
+   unsigned int nthreads = 0;
+#if defined(__APPLE__)
+   thread_act_array_t threads;
+   mach_msg_type_number_t count;
+   if (task_threads(mach_task_self(), &threads, &count) == KERN_SUCCESS) {
+      for (unsigned int i = 0; i < count; ++i) mach_port_deallocate(mach_task_self(), threads[i]);
+      vm_deallocate(mach_task_self(), (vm_address_t) threads, count*sizeof(thread_act_t));
+      nthreads = count;
+   }
+#else
+   // on Linux each thread has an entry in /proc/self/task
+   DIR * dir = opendir("/proc/self/task");
+   if (dir) {
+      while (struct dirent * entry = readdir(dir)) {
+         if (entry->d_name[0] != '.') ++nthreads;
+      }
+      closedir(dir);
+   }
+#endif
+   return nthreads;
+}
+
+bool MnExecutor::RunProcesses(unsigned int ntasks, unsigned int nresults, const Task & task, double * results) const {
+   // run the tasks in child processes forked from the current one. The child process w runs the tasks
+   // w, w+nworkers, ... and writes their results in a pipe read by the parent process.
+   // The tasks whose results are not received (e.g. because the child process failed) are run in the
+   // current process. Return false if no child process could be created
+   unsigned int nproc = std::min(NWorkers(), ntasks);
+
+   // a child process has only a copy of the calling thread: a lock held by another thread at the
+   // time of the fork (e.g. of malloc or of the output streams) would never be released in the
+   // child, which could then block forever, so the tasks are not forked when other threads run
+   if (NumberOfThreads() > 1) {
+#ifdef WARNINGMSG
+      MN_INFO_MSG("MnExecutor: the process runs other threads, run serially");
+#endif
+      return false;
+   }
+
+   // flush the output buffers, otherwise they would be written by each child process
+   std::cout.flush();
+   std::cerr.flush();
+   fflush(0);
+
+   std::vector<pid_t> pids;
+   std::vector<int> fds;
+   for (unsigned int w = 0; w < nproc; ++w) {
+      int fd[2];
+      if (pipe(fd) != 0) break;
+      pid_t pid = fork();
+      if (pid < 0) {
+         close(fd[0]);
+         close(fd[1]);
+         break;
+      }
+      if (pid == 0) {
+         // child process: run the tasks and send their results to the parent
+         close(fd[0]);
+         for (unsigned int i = 0; i < fds.size(); ++i) close(fds[i]);
+         std::vector<double> buffer(nresults);
+         int status = 0;
+         try {
+            for (unsigned int i = w; i < ntasks && status == 0; i += nproc) {
+               task(i, &buffer[0]);
+               const char * data = reinterpret_cast<const char *>(&buffer[0]);
+               size_t nbytes = nresults*sizeof(double);
+               while (nbytes > 0) {
+                  ssize_t nw = write(fd[1], data, nbytes);
+                  if (nw < 0 && errno == EINTR) continue;
+                  if (nw <= 0) {
+                     status = 1;
+                     break;
+                  }
+                  data += nw;
+                  nbytes -= nw;
+               }
+            }
+         }
+         catch (...) {
+            status = 1;
+         }
+         close(fd[1]);
+         _exit(status);
+      }
+      close(fd[1]);
+      pids.push_back(pid);
+      fds.push_back(fd[0]);
+   }
+
+   if (pids.empty()) {
+#ifdef WARNINGMSG
+      MN_INFO_MSG("MnExecutor: cannot create child processes, run serially");
+#endif
+      return false;
+   }
+
+   // read the results of each child process, which runs the tasks w, w+nworkers, ...
+   unsigned int nused = pids.size();
+   std::vector<bool> done(ntasks, false);
+   for (unsigned int w = 0; w < nused; ++w) {
+      for (unsigned int i = w; i < ntasks; i += nproc) {
+         char * data = reinterpret_cast<char *>(results + i*nresults);
+         size_t nbytes = nresults*sizeof(double);
+         while (nbytes > 0) {
+            ssize_t nr = read(fds[w], data, nbytes);
+            if (nr < 0 && errno == EINTR) continue;
+            if (nr <= 0) break;
+            data += nr;
+            nbytes -= nr;
+         }
+         if (nbytes > 0) break;
+         done[i] = true;
+      }
+      close(fds[w]);
+      int status = 0;
+      while (waitpid(pids[w], &status, 0) < 0 && errno == EINTR) {}
+   }
+
+   // run the tasks left in the current process
+   for (unsigned int i = 0; i < ntasks; ++i) {
+      if (!done[i]) task(i, results + i*nresults);
+   }
+   return true;
+}
+
+#else
+
+bool MnExecutor::RunProcesses(unsigned int, unsigned int, const Task &, double *) const {
+   // child processes are not supported on Windows
+   return false;
+}
+
+#endif
+
+   }  // namespace Minuit2
+
+}  // namespace ROOT
@@ -18,6 +18,9 @@
 #include "Minuit2/MinimumState.h"
 #include "Minuit2/VariableMetricEDMEstimator.h"
 #include "Minuit2/FunctionMinimum.h"
+#include "Minuit2/MnExecutor.h"
+
+#include <vector>
 
 //#define DEBUG
 
@@ -85,6 +88,86 @@ void MnHesse::operator()(const FCNBase& fcn, FunctionMinimum& min, unsigned int
    min.Add(st);
 }
 
+// compute the second derivative of the function for the internal parameter i at the minimum amin,
+// updating the values in g2, grd, gst, dirin and the function value yy at the last step. The component
+// i of x is changed during the calculation and restored at the end. Return the number of function calls,
+// which are not counted by the function (see MnFcn::Eval), and set failed if the second derivative is zero
+static int HessianDiagonal(const MnHesse& hesse, const MnFcn& mfcn, const MnUserTransformation& trafo,
+                           double amin, double aimsag, unsigned int i, MnAlgebraicVector& x, double& g2,
+                           double& grd, double& gst, double& dirin, double& yy, bool& failed) {
+
+   const MnMachinePrecision& prec = trafo.Precision();
+   int ncall = 0;
+   failed = false;
+
+   double xtf = x(i);
+   double dmin = 8.*prec.Eps2()*(fabs(xtf) + prec.Eps2());
+   double d = fabs(gst);
+   if(d < dmin) d = dmin;
+
+#ifdef DEBUG
+   std::cout << "\nDerivative parameter  " << i << " d = " << d << " dmin = " << dmin << std::endl;
+#endif
+
+
+   for(unsigned int icyc = 0; icyc < hesse.Ncycles(); icyc++) {
+      double sag = 0.;
+      double fs1 = 0.;
+      double fs2 = 0.;
+      for(unsigned int multpy = 0; multpy < 5; multpy++) {
+         x(i) = xtf + d;
+         fs1 = mfcn.Eval(x);
+         x(i) = xtf - d;
+         fs2 = mfcn.Eval(x);
+         x(i) = xtf;
+         ncall += 2;
+         sag = 0.5*(fs1+fs2-2.*amin);
+
+#ifdef DEBUG
+         std::cout << "cycle " << icyc << " mul " << multpy << "\t sag = " << sag << " d = " << d << std::endl;
+#endif
+         //  Now as F77 Minuit - check taht sag is not zero
+         if (sag != 0) goto L30; // break
+         if(trafo.Parameter(i).HasLimits()) {
+            if(d > 0.5) goto L26;
+            d *= 10.;
+            if(d > 0.5) d = 0.51;
+            continue;
+         }
+         d *= 10.;
+      }
+
+L26:
+      failed = true;
+      return ncall;
+
+L30:
+      double g2bfor = g2;
+      g2 = 2.*sag/(d*d);
+      grd = (fs1-fs2)/(2.*d);
+      gst = d;
+      dirin = d;
+      yy = fs1;
+      double dlast = d;
+      d = sqrt(2.*aimsag/fabs(g2));
+      if(trafo.Parameter(i).HasLimits()) d = std::min(0.5, d);
+      if(d < dmin) d = dmin;
+
+#ifdef DEBUG
+      std::cout << "\t g1 = " << grd << " g2 = " << g2 << " step = " << gst << " d = " << d
+                << " diffd = " <<  fabs(d-dlast)/d << " diffg2 = " << fabs(g2-g2bfor)/g2 << std::endl;
+#endif
+
+
+      // see if converged
+      if(fabs((d-dlast)/d) < hesse.Tolerstp()) break;
+      if(fabs((g2-g2bfor)/g2) < hesse.TolerG2()) break;
+      d = std::min(d, 10.*dlast);
+      d = std::max(d, 0.1*dlast);
+   }
+   return ncall;
+}
+
 MinimumState MnHesse::operator()(const MnFcn& mfcn, const MinimumState& st, const MnUserTransformation& trafo, unsigned int maxcalls) const {
    // internal interface from MinimumState and MnUserTransformation
    // Function who does the real Hessian calculations
@@ -130,106 +213,102 @@ MinimumState MnHesse::operator()(const MnFcn& mfcn, const MinimumState& st, cons
 #endif
 
 
-   for(unsigned int i = 0; i < n; i++) {
-
-      double xtf = x(i);
-      double dmin = 8.*prec.Eps2()*(fabs(xtf) + prec.Eps2());
-      double d = fabs(gst(i));
-      if(d < dmin) d = dmin;
-
-#ifdef DEBUG
-      std::cout << "\nDerivative parameter  " << i << " d = " << d << " dmin = " << dmin << std::endl;
-#endif
-
-
-      for(unsigned int icyc = 0; icyc < Ncycles(); icyc++) {
-         double sag = 0.;
-         double fs1 = 0.;
-         double fs2 = 0.;
-         for(unsigned int multpy = 0; multpy < 5; multpy++) {
-            x(i) = xtf + d;
-            fs1 = mfcn(x);
-            x(i) = xtf - d;
-            fs2 = mfcn(x);
-            x(i) = xtf;
-            sag = 0.5*(fs1+fs2-2.*amin);
+   // return a diagonal matrix from the second derivatives when Hesse fails
+   auto diagonalState = [&]() {
+      for(unsigned int j = 0; j < n; j++) {
+         double tmp = g2(j) < prec.Eps2() ? 1. : 1./g2(j);
+         vhmat(j,j) = tmp < prec.Eps2() ? 1. : tmp;
+      }
+      return MinimumState(st.Parameters(), MinimumError(vhmat, MinimumError::MnHesseFailed()), st.Gradient(), st.Edm(), mfcn.NumOfCalls());
+   };
 
-#ifdef DEBUG
-            std::cout << "cycle " << icyc << " mul " << multpy << "\t sag = " << sag << " d = " << d << std::endl;
+   // report a zero second derivative for parameter i
+   auto zeroSecondDerivative = [&](unsigned int i) {
+#ifdef WARNINGMSG
+      const char * name = trafo.Name( trafo.ExtOfInt(i));
+      MN_INFO_VAL2("MnHesse: 2nd derivative zero for Parameter ", name);
+      MN_INFO_MSG("MnHesse fails and will return diagonal matrix ");
+#else
+      (void) i;
 #endif
-            //  Now as F77 Minuit - check taht sag is not zero
-            if (sag != 0) goto L30; // break
-            if(trafo.Parameter(i).HasLimits()) {
-               if(d > 0.5) goto L26;
-               d *= 10.;
-               if(d > 0.5) d = 0.51;
-               continue;
-            }
-            d *= 10.;
-         }
+   };
 
-L26:
+   // report that the maximum number of calls is exhausted
+   auto maxCallsExhausted = [&]() {
 #ifdef WARNINGMSG
-
-         // get parameter name for i
-         // (need separate scope for avoiding compl error when declaring name)
-         {
-            const char * name = trafo.Name( trafo.ExtOfInt(i));
-            MN_INFO_VAL2("MnHesse: 2nd derivative zero for Parameter ", name);
-            MN_INFO_MSG("MnHesse fails and will return diagonal matrix ");
-         }
+      //std::cout<<"maxcalls " << maxcalls << " " << mfcn.NumOfCalls() << "  " <<   st.NFcn() << std::endl;
+      MN_INFO_MSG("MnHesse: maximum number of allowed function calls exhausted.");
+      MN_INFO_MSG("MnHesse fails and will return diagonal matrix ");
 #endif
-
-         for(unsigned int j = 0; j < n; j++) {
-            double tmp = g2(j) < prec.Eps2() ? 1. : 1./g2(j);
-            vhmat(j,j) = tmp < prec.Eps2() ? 1. : tmp;
+   };
+
+   MnExecutor executor = fStrategy.Executor();
+   if (executor.IsParallel()) {
+
+      // compute the second derivative of each parameter in a separate task, which returns
+      // g2, grd, gst, dirin, yy, the number of function calls and the failure flag
+      const unsigned int nres = 7;
+      std::vector<double> results(nres*n);
+      executor.Run(n, nres, [&](unsigned int i, double * res) {
+            MnAlgebraicVector xi = x;
+            double g2i = g2(i);
+            double grdi = grd(i);
+            double gsti = gst(i);
+            double dirini = dirin(i);
+            double yyi = 0.;
+            bool failed = false;
+            res[5] = HessianDiagonal(*this, mfcn, trafo, amin, aimsag, i, xi, g2i, grdi, gsti, dirini, yyi, failed);
+            res[0] = g2i;
+            res[1] = grdi;
+            res[2] = gsti;
+            res[3] = dirini;
+            res[4] = yyi;
+            res[6] = failed ? 1. : 0.;
+         }, &results[0]);
+
+      int ncall = 0;
+      for(unsigned int i = 0; i < n; i++) ncall += int(results[nres*i+5]);
+      mfcn.AddCalls(ncall);
+
+      for(unsigned int i = 0; i < n; i++) {
+         if (results[nres*i+6] != 0.) {
+            zeroSecondDerivative(i);
+            return diagonalState();
          }
+         g2(i) = results[nres*i];
+         grd(i) = results[nres*i+1];
+         gst(i) = results[nres*i+2];
+         dirin(i) = results[nres*i+3];
+         yy(i) = results[nres*i+4];
+         vhmat(i,i) = g2(i);
+      }
+      if(mfcn.NumOfCalls()  > maxcalls) {
+         maxCallsExhausted();
+         return diagonalState();
+      }
 
-         return MinimumState(st.Parameters(), MinimumError(vhmat, MinimumError::MnHesseFailed()), st.Gradient(), st.Edm(), mfcn.NumOfCalls());
-
-L30:
-            double g2bfor = g2(i);
-         g2(i) = 2.*sag/(d*d);
-         grd(i) = (fs1-fs2)/(2.*d);
-         gst(i) = d;
-         dirin(i) = d;
-         yy(i) = fs1;
-         double dlast = d;
-         d = sqrt(2.*aimsag/fabs(g2(i)));
-         if(trafo.Parameter(i).HasLimits()) d = std::min(0.5, d);
-         if(d < dmin) d = dmin;
-
-#ifdef DEBUG
-         std::cout << "\t g1 = " << grd(i) << " g2 = " << g2(i) << " step = " << gst(i) << " d = " << d
-                   << " diffd = " <<  fabs(d-dlast)/d << " diffg2 = " << fabs(g2(i)-g2bfor)/g2(i) << std::endl;
-#endif
+   }
+   else {
 
+   for(unsigned int i = 0; i < n; i++) {
 
-         // see if converged
-         if(fabs((d-dlast)/d) < Tolerstp()) break;
-         if(fabs((g2(i)-g2bfor)/g2(i)) < TolerG2()) break;
-         d = std::min(d, 10.*dlast);
-         d = std::max(d, 0.1*dlast);
+      bool failed = false;
+      int ncall = HessianDiagonal(*this, mfcn, trafo, amin, aimsag, i, x, g2(i), grd(i), gst(i), dirin(i), yy(i), failed);
+      mfcn.AddCalls(ncall);
+      if (failed) {
+         zeroSecondDerivative(i);
+         return diagonalState();
       }
       vhmat(i,i) = g2(i);
       if(mfcn.NumOfCalls()  > maxcalls) {
-
-#ifdef WARNINGMSG
-         //std::cout<<"maxcalls " << maxcalls << " " << mfcn.NumOfCalls() << "  " <<   st.NFcn() << std::endl;
-         MN_INFO_MSG("MnHesse: maximum number of allowed function calls exhausted.");
-         MN_INFO_MSG("MnHesse fails and will return diagonal matrix ");
-#endif
-
-         for(unsigned int j = 0; j < n; j++) {
-            double tmp = g2(j) < prec.Eps2() ? 1. : 1./g2(j);
-            vhmat(j,j) = tmp < prec.Eps2() ? 1. : tmp;
-         }
-
-         return MinimumState(st.Parameters(), MinimumError(vhmat, MinimumError::MnHesseFailed()), st.Gradient(), st.Edm(), mfcn.NumOfCalls());
+         maxCallsExhausted();
+         return diagonalState();
       }
 
    }
 
+   }
+
 #ifdef DEBUG
    std::cout << "\n Second derivatives " << g2 << std::endl;
 #endif
@@ -244,6 +323,36 @@ L30:
    }
 
    //off-diagonal Elements
+   if (executor.IsParallel() && n > 1) {
+
+      // compute each element in a separate task, which returns the function value
+      // with both parameters shifted
+      unsigned int nelem = n*(n-1)/2;
+      std::vector<unsigned int> irow(nelem), icol(nelem);
+      for (unsigned int i = 0, in = 0; i < n; i++) {
+         for (unsigned int j = i+1; j < n; j++, in++) {
+            irow[in] = i;
+            icol[in] = j;
+         }
+      }
+      std::vector<double> fs(nelem);
+      executor.Run(nelem, 1, [&](unsigned int in, double * res) {
+            MnAlgebraicVector xij = x;
+            xij(irow[in]) += dirin(irow[in]);
+            xij(icol[in]) += dirin(icol[in]);
+            res[0] = mfcn.Eval(xij);
+         }, &fs[0]);
+      mfcn.AddCalls(nelem);
+
+      for (unsigned int in = 0; in < nelem; in++) {
+         unsigned int i = irow[in];
+         unsigned int j = icol[in];
+         vhmat(i,j) = (fs[in] + amin - yy(i) - yy(j))/(dirin(i)*dirin(j));
+      }
+
+   }
+   else {
+
    // initial starting values
    MPIProcess mpiprocOffDiagonal(n*(n-1)/2,0);
    unsigned int startParIndexOffDiagonal = mpiprocOffDiagonal.StartElementIndex();
@@ -278,6 +387,8 @@ L30:
 
    mpiprocOffDiagonal.SyncSymMatrixOffDiagonal(vhmat);
 
+   }
+
    //verify if matrix pos-def (still 2nd derivative)
 
 #ifdef DEBUG
@@ -15,6 +15,7 @@
 #include "Minuit2/MinimumParameters.h"
 #include "Minuit2/FunctionGradient.h"
 #include "Minuit2/MnStrategy.h"
+#include "Minuit2/MnExecutor.h"
 
 
 //#define DEBUG
@@ -30,6 +31,7 @@
 #endif
 
 #include <math.h>
+#include <vector>
 
 #include "Minuit2/MPIProcess.h"
 
@@ -69,6 +71,78 @@ FunctionGradient Numerical2PGradientCalculator::operator()(const std::vector<dou
 
 
 
+// compute the derivatives of the function for the internal parameter i iterating at most ncycle
+// times from the values in grd, g2 and gstep, which are updated. The component i of x is changed
+// during the calculation and restored at the end. Return the number of function calls, which are
+// not counted by the function (see MnFcn::Eval)
+static int Numerical2PDerivative(const Numerical2PGradientCalculator& gc, unsigned int i, double fcnmin,
+                                 double dfmin, double vrysml, MnAlgebraicVector& x, double& grd, double& g2,
+                                 double& gstep) {
+
+   double eps2 = gc.Precision().Eps2();
+   unsigned int ncycle = gc.Ncycle();
+   int ncall = 0;
+
+   double xtf = x(i);
+   double epspri = eps2 + fabs(grd*eps2);
+   double stepb4 = 0.;
+   for(unsigned int j = 0; j < ncycle; j++)  {
+      double optstp = sqrt(dfmin/(fabs(g2)+epspri));
+      double step = std::max(optstp, fabs(0.1*gstep));
+      //       std::cout<<"step: "<<step;
+      if(gc.Trafo().Parameter(gc.Trafo().ExtOfInt(i)).HasLimits()) {
+         if(step > 0.5) step = 0.5;
+      }
+      double stpmax = 10.*fabs(gstep);
+      if(step > stpmax) step = stpmax;
+      //       std::cout<<" "<<step;
+      double stpmin = std::max(vrysml, 8.*fabs(eps2*x(i)));
+      if(step < stpmin) step = stpmin;
+      //       std::cout<<" "<<step<<std::endl;
+      //       std::cout<<"step: "<<step<<std::endl;
+      if(fabs((step-stepb4)/step) < gc.StepTolerance()) {
+         //    std::cout<<"(step-stepb4)/step"<<std::endl;
+         //    std::cout<<"j= "<<j<<std::endl;
+         //    std::cout<<"step= "<<step<<std::endl;
+         break;
+      }
+      gstep = step;
+      stepb4 = step;
+      //       MnAlgebraicVector pstep(n);
+      //       pstep(i) = step;
+      //       double fs1 = Fcn()(pstate + pstep);
+      //       double fs2 = Fcn()(pstate - pstep);
+
+      x(i) = xtf + step;
+      double fs1 = gc.Fcn().Eval(x);
+      x(i) = xtf - step;
+      double fs2 = gc.Fcn().Eval(x);
+      x(i) = xtf;
+      ncall += 2;
+
+      double grdb4 = grd;
+      grd = 0.5*(fs1 - fs2)/step;
+      g2 = (fs1 + fs2 - 2.*fcnmin)/step/step;
+
+#ifdef DEBUG
+      int pr = std::cout.precision(13);
+      std::cout << "cycle " << j << " x " << x(i) << " step " << step << " f1 " << fs1 << " f2 " << fs2
+                << " grd " << grd << " g2 " << g2 << std::endl;
+      std::cout.precision(pr);
+#endif
+
+      if(fabs(grdb4-grd)/(fabs(grd)+dfmin/step) < gc.GradTolerance())  {
+         //    std::cout<<"j= "<<j<<std::endl;
+         //    std::cout<<"step= "<<step<<std::endl;
+         //    std::cout<<"fs1, fs2: "<<fs1<<" "<<fs2<<std::endl;
+         //    std::cout<<"fs1-fs2: "<<fs1-fs2<<std::endl;
+         break;
+      }
+   }
+   return ncall;
+}
+
+
 FunctionGradient Numerical2PGradientCalculator::operator()(const MinimumParameters& par, const FunctionGradient& Gradient) const {
    // calculate numerical gradient from MinimumParameters object
    // the algorithm takes correctly care when the gradient is approximatly zero
@@ -94,15 +168,11 @@ FunctionGradient Numerical2PGradientCalculator::operator()(const MinimumParamete
    //    std::cout << " ncycle " << Ncycle() << std::endl;
 
    unsigned int n = (par.Vec()).size();
-   unsigned int ncycle = Ncycle();
    //   MnAlgebraicVector vgrd(n), vgrd2(n), vgstp(n);
    MnAlgebraicVector grd = Gradient.Grad();
    MnAlgebraicVector g2 = Gradient.G2();
    MnAlgebraicVector gstep = Gradient.Gstep();
-
-#ifndef _OPENMP
-   MPIProcess mpiproc(n,0);
-#endif
+   int ncall = 0;
 
 #ifdef DEBUG
    std::cout << "Calculating Gradient at x =   " << par.Vec() << std::endl;
@@ -111,7 +181,35 @@ FunctionGradient Numerical2PGradientCalculator::operator()(const MinimumParamete
    std::cout.precision(pr);
 #endif
 
+   MnExecutor executor = Strategy().Executor();
+   if (executor.IsParallel()) {
+
+      // compute the derivatives of each parameter in a separate task, which returns
+      // the derivatives, the step and the number of function calls
+      std::vector<double> results(4*n);
+      executor.Run(n, 4, [&](unsigned int i, double * res) {
+            MnAlgebraicVector x = par.Vec();
+            double grdi = grd(i);
+            double g2i = g2(i);
+            double gstepi = gstep(i);
+            res[3] = Numerical2PDerivative(*this, i, fcnmin, dfmin, vrysml, x, grdi, g2i, gstepi);
+            res[0] = grdi;
+            res[1] = g2i;
+            res[2] = gstepi;
+         }, &results[0]);
+      for (unsigned int i = 0; i < n; i++) {
+         grd(i) = results[4*i];
+         g2(i) = results[4*i+1];
+         gstep(i) = results[4*i+2];
+         ncall += int(results[4*i+3]);
+      }
+
+   }
+   else {
+
 #ifndef _OPENMP
+   MPIProcess mpiproc(n,0);
+
    // for serial execution this can be outside the loop
    MnAlgebraicVector x = par.Vec();
 
@@ -124,8 +222,7 @@ FunctionGradient Numerical2PGradientCalculator::operator()(const MinimumParamete
 
  // parallelize this loop using OpenMP
 //#define N_PARALLEL_PAR 5
-#pragma omp parallel
-#pragma omp for
+#pragma omp parallel for reduction(+:ncall)
 //#pragma omp for schedule (static, N_PARALLEL_PAR)
 
    for(int i = 0; i < int(n); i++) {
@@ -142,62 +239,7 @@ FunctionGradient Numerical2PGradientCalculator::operator()(const MinimumParamete
       MnAlgebraicVector x = par.Vec();
 #endif
 
-      double xtf = x(i);
-      double epspri = eps2 + fabs(grd(i)*eps2);
-      double stepb4 = 0.;
-      for(unsigned int j = 0; j < ncycle; j++)  {
-         double optstp = sqrt(dfmin/(fabs(g2(i))+epspri));
-         double step = std::max(optstp, fabs(0.1*gstep(i)));
-         //       std::cout<<"step: "<<step;
-         if(Trafo().Parameter(Trafo().ExtOfInt(i)).HasLimits()) {
-            if(step > 0.5) step = 0.5;
-         }
-         double stpmax = 10.*fabs(gstep(i));
-         if(step > stpmax) step = stpmax;
-         //       std::cout<<" "<<step;
-         double stpmin = std::max(vrysml, 8.*fabs(eps2*x(i)));
-         if(step < stpmin) step = stpmin;
-         //       std::cout<<" "<<step<<std::endl;
-         //       std::cout<<"step: "<<step<<std::endl;
-         if(fabs((step-stepb4)/step) < StepTolerance()) {
-            //    std::cout<<"(step-stepb4)/step"<<std::endl;
-            //    std::cout<<"j= "<<j<<std::endl;
-            //    std::cout<<"step= "<<step<<std::endl;
-            break;
-         }
-         gstep(i) = step;
-         stepb4 = step;
-         //       MnAlgebraicVector pstep(n);
-         //       pstep(i) = step;
-         //       double fs1 = Fcn()(pstate + pstep);
-         //       double fs2 = Fcn()(pstate - pstep);
-
-         x(i) = xtf + step;
-         double fs1 = Fcn()(x);
-         x(i) = xtf - step;
-         double fs2 = Fcn()(x);
-         x(i) = xtf;
-
-         double grdb4 = grd(i);
-         grd(i) = 0.5*(fs1 - fs2)/step;
-         g2(i) = (fs1 + fs2 - 2.*fcnmin)/step/step;
-
-#ifdef DEBUG
-         pr = std::cout.precision(13);
-         std::cout << "cycle " << j << " x " << x(i) << " step " << step << " f1 " << fs1 << " f2 " << fs2
-                   << " grd " << grd(i) << " g2 " << g2(i) << std::endl;
-         std::cout.precision(pr);
-#endif
-
-         if(fabs(grdb4-grd(i))/(fabs(grd(i))+dfmin/step) < GradTolerance())  {
-            //    std::cout<<"j= "<<j<<std::endl;
-            //    std::cout<<"step= "<<step<<std::endl;
-            //    std::cout<<"fs1, fs2: "<<fs1<<" "<<fs2<<std::endl;
-            //    std::cout<<"fs1-fs2: "<<fs1-fs2<<std::endl;
-            break;
-         }
-      }
-
+      ncall += Numerical2PDerivative(*this, i, fcnmin, dfmin, vrysml, x, grd(i), g2(i), gstep(i));
 
 #ifdef DEBUG_MP
 #pragma omp critical
@@ -210,21 +252,27 @@ FunctionGradient Numerical2PGradientCalculator::operator()(const MinimumParamete
       //     vgrd2(i) = g2;
       //     vgstp(i) = gstep;
 
+   }
+
+#ifndef _OPENMP
+   mpiproc.SyncVector(grd);
+   mpiproc.SyncVector(g2);
+   mpiproc.SyncVector(gstep);
+#endif
+
+   }
 
 #ifdef DEBUG
+   for (unsigned int i = 0; i < n; i++) {
       pr = std::cout.precision(13);
       int iext = Trafo().ExtOfInt(i);
       std::cout << "Parameter " << Trafo().Name(iext) << " Gradient =   " << grd(i) << " g2 = " << g2(i) << " step " << gstep(i) << std::endl;
       std::cout.precision(pr);
-#endif
    }
-
-#ifndef _OPENMP
-   mpiproc.SyncVector(grd);
-   mpiproc.SyncVector(g2);
-   mpiproc.SyncVector(gstep);
 #endif
 
+   Fcn().AddCalls(ncall);
+
    return FunctionGradient(grd, g2, gstep);
 }
 
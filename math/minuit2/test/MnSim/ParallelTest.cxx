@@ -13,12 +13,18 @@
 #include "Minuit2/MnUserParameterState.h"
 #include "Minuit2/MnPrint.h"
 #include "Minuit2/MnMigrad.h"
+#include "Minuit2/MnHesse.h"
+#include "Minuit2/MnStrategy.h"
+#include "Minuit2/VariableMetricMinimizer.h"
 #include "Minuit2/MnMinos.h"
 #include "Minuit2/MnPlot.h"
 #include "Minuit2/MinosError.h"
 #include "Minuit2/FCNBase.h"
 #include <cmath>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <chrono>
 
 // example of a multi dimensional fit where parallelization can be used
 // to speed up the result
@@ -27,6 +33,9 @@
 // The default number of dimension is 20 (fit in 40 parameters) on 1000 data events.
 // One can change the dimension and the number of events by doing:
 // ./test_Minuit2_Parallel    ndim  nevents
+// The fit can also be done with the gradient and Hesse function calls executed in
+// threads or in forked processes (see MnExecutor), and compared with the serial fit:
+// ./test_Minuit2_Parallel    ndim  nevents  threads|processes  [nworkers]
 
 using namespace ROOT::Minuit2;
 
@@ -70,7 +79,7 @@ struct LogLikeFCN  : public FCNBase {
    const Data & fData;
 };
 
-int doFit(int ndim, int ndata) {
+int doFit(int ndim, int ndata, MnExecutor::EType execType, unsigned int nworkers) {
 
   // generate the data (1000 data points) in 100 dimension
 
@@ -111,10 +120,41 @@ int doFit(int ndim, int ndata) {
   VariableMetricMinimizer fMinimizer;
 
   // Minimize
-  FunctionMinimum min = fMinimizer.Minimize(fcn, init_par, init_err);
+  MnStrategy strategy(1);
+  auto t0 = std::chrono::steady_clock::now();
+  FunctionMinimum min = fMinimizer.Minimize(fcn, MnUserParameters(init_par, init_err), strategy);
+  MnHesse hesse(strategy);
+  hesse(fcn, min);
+  auto t1 = std::chrono::steady_clock::now();
 
   // output
   std::cout<<"minimum: "<<min<<std::endl;
+  std::cout << "serial fit time " << std::chrono::duration<double>(t1-t0).count() << " s" << std::endl;
+
+  if (execType == MnExecutor::kSerial) return 0;
+
+  // Minimize with the function calls of gradient and Hesse executed in parallel
+  strategy.SetExecutor(execType, nworkers);
+  t0 = std::chrono::steady_clock::now();
+  FunctionMinimum pmin = fMinimizer.Minimize(fcn, MnUserParameters(init_par, init_err), strategy);
+  MnHesse phesse(strategy);
+  phesse(fcn, pmin);
+  t1 = std::chrono::steady_clock::now();
+  std::cout << "parallel fit time " << std::chrono::duration<double>(t1-t0).count() << " s with "
+            << strategy.Executor().NWorkers() << " workers" << std::endl;
+
+  // the result must be the same as the serial one
+  bool ok = pmin.IsValid() == min.IsValid() && pmin.Fval() == min.Fval() && pmin.NFcn() == min.NFcn();
+  for (unsigned int k = 0; k < init_par.size(); ++k) {
+     ok &= pmin.UserState().Value(k) == min.UserState().Value(k);
+     ok &= pmin.UserState().Error(k) == min.UserState().Error(k);
+  }
+  if (!ok) {
+     std::cout << "Error: parallel fit differs from the serial one" << std::endl;
+     std::cout << "minimum: " << pmin << std::endl;
+     return 1;
+  }
+  std::cout << "parallel fit gives the same result as the serial one" << std::endl;
 
 
 //     // create MINOS Error factory
@@ -147,12 +187,21 @@ int doFit(int ndim, int ndata) {
 int main(int argc, char **argv) {
    int ndim = default_ndim;
    int ndata = default_ndata;
+   MnExecutor::EType execType = MnExecutor::kSerial;
+   unsigned int nworkers = 0;
    if (argc > 1) {
       ndim = atoi(argv[1] );
    }
    if (argc > 2) {
       ndata = atoi(argv[2] );
    }
+   if (argc > 3) {
+      if (strcmp(argv[3], "threads") == 0) execType = MnExecutor::kThreads;
+      if (strcmp(argv[3], "processes") == 0) execType = MnExecutor::kProcesses;
+   }
+   if (argc > 4) {
+      nworkers = atoi(argv[4] );
+   }
    std::cout << "do fit of " << ndim << " dimensional data on " << ndata << " events " << std::endl;
-   doFit(ndim,ndata);
+   return doFit(ndim,ndata,execType,nworkers);
 }
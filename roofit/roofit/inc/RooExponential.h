@@ -39,6 +39,7 @@ protected:
   RooRealProxy c;
 
   Double_t evaluate() const;
+  Bool_t evaluateBatch(Double_t* output, Int_t firstEvent, Int_t nEvents, const RooVectorDataStore& data) const;
 
 private:
   ClassDef(RooExponential,1) // Exponential PDF
@@ -49,6 +49,7 @@ protected:
   mutable std::vector<Double_t> _wksp; //! do not persist
 
   Double_t evaluate() const;
+  Bool_t evaluateBatch(Double_t* output, Int_t firstEvent, Int_t nEvents, const RooVectorDataStore& data) const;
 
   ClassDef(RooPolynomial,1) // Polynomial PDF
 };
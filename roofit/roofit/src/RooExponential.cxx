@@ -29,6 +29,7 @@
 
 #include "RooExponential.h"
 #include "RooRealVar.h"
+#include "RooVectorDataStore.h"
 
 using namespace std;
 
@@ -62,6 +63,24 @@ Double_t RooExponential::evaluate() const{
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Evaluate the exponential on a range of events of data, if x is an
+/// observable of data and the slope does not depend on the observables
+
+Bool_t RooExponential::evaluateBatch(Double_t* output, Int_t firstEvent, Int_t nEvents, const RooVectorDataStore& data) const
+{
+  const Double_t* xData = data.realColumn(x.arg()) ;
+  if (!xData || c.arg().dependsOnValue(*data.get())) return kFALSE ;
+
+  const Double_t slope = c ;
+  xData += firstEvent ;
+  for (Int_t i=0 ; i<nEvents ; i++) {
+    output[i] = exp(slope*xData[i]) ;
+  }
+  return kTRUE ;
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 
 Int_t RooExponential::getAnalyticalIntegral(RooArgSet& allVars, RooArgSet& analVars, const char* /*rangeName*/) const 
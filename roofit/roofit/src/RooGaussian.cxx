@@ -32,6 +32,7 @@
 #include "RooRealVar.h"
 #include "RooRandom.h"
 #include "RooMath.h"
+#include "RooVectorDataStore.h"
 
 using namespace std;
 
@@ -77,6 +78,29 @@ Double_t RooGaussian::evaluate() const
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Evaluate the Gaussian on a range of events of data, if x is an observable
+/// of data and the mean and the width do not depend on the observables
+
+Bool_t RooGaussian::evaluateBatch(Double_t* output, Int_t firstEvent, Int_t nEvents, const RooVectorDataStore& data) const
+{
+  const Double_t* xData = data.realColumn(x.arg()) ;
+  if (!xData || mean.arg().dependsOnValue(*data.get()) || sigma.arg().dependsOnValue(*data.get())) {
+    return kFALSE ;
+  }
+
+  const Double_t m = mean ;
+  const Double_t sig = sigma ;
+  xData += firstEvent ;
+  for (Int_t i=0 ; i<nEvents ; i++) {
+    Double_t arg = xData[i] - m ;
+    output[i] = exp(-0.5*arg*arg/(sig*sig)) ;
+  }
+  return kTRUE ;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// calculate and return the negative log-likelihood of the Poisson                                                                                                                                    
 
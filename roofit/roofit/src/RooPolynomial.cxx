@@ -29,11 +29,13 @@
 
 #include <cmath>
 #include <cassert>
+#include <algorithm>
 
 #include "RooPolynomial.h"
 #include "RooAbsReal.h"
 #include "RooArgList.h"
 #include "RooMsgService.h"
+#include "RooVectorDataStore.h"
 
 #include "TError.h"
 
@@ -138,6 +140,44 @@ Double_t RooPolynomial::evaluate() const
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Evaluate the polynomial on a range of events of data, if x is an
+/// observable of data and the coefficients do not depend on the observables
+
+Bool_t RooPolynomial::evaluateBatch(Double_t* output, Int_t firstEvent, Int_t nEvents, const RooVectorDataStore& data) const
+{
+  const Double_t* xData = data.realColumn(_x.arg()) ;
+  if (!xData) return kFALSE;
+
+  const unsigned sz = _coefList.getSize();
+  const int lowestOrder = _lowestOrder;
+  _wksp.clear();
+  _wksp.reserve(sz);
+  {
+    const RooArgSet* nset = _coefList.nset();
+    RooFIter it = _coefList.fwdIterator();
+    RooAbsReal* c;
+    while ((c = (RooAbsReal*) it.next())) {
+      if (c->dependsOnValue(*data.get())) return kFALSE;
+      _wksp.push_back(c->getVal(nset));
+    }
+  }
+  if (!sz) {
+    std::fill(output, output + nEvents, lowestOrder ? 1. : 0.);
+    return kTRUE;
+  }
+  xData += firstEvent;
+  for (Int_t j = 0; j < nEvents; ++j) {
+    const Double_t x = xData[j];
+    Double_t retVal = _wksp[sz - 1];
+    for (unsigned i = sz - 1; i--; ) retVal = _wksp[i] + x * retVal;
+    output[j] = retVal * std::pow(x, lowestOrder) + (lowestOrder ? 1.0 : 0.0);
+  }
+  return kTRUE;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 
 Int_t RooPolynomial::getAnalyticalIntegral(RooArgSet& allVars, RooArgSet& analVars, const char* /*rangeName*/) const 
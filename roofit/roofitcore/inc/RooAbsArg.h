@@ -550,7 +550,11 @@ public:
 
   // Debug stuff
   static Bool_t _verboseDirty ; // Static flag controlling verbose messaging for dirty state changes
-  static Bool_t _inhibitDirty ; // Static flag controlling global inhibit of dirty state propagation
+  static Bool_t _inhibitDirty ; // Static flag set while the dirty state propagation is inhibited in any thread (see setDirtyInhibit)
+  static Bool_t threadInhibitDirty() ; // True if the dirty state propagation is inhibited in the calling thread
+  // Only the threads which inhibit the dirty state propagation read their
+  // thread local flag, the others only pay for the test of _inhibitDirty
+  static Bool_t inhibitDirtyFlag() { return _inhibitDirty && threadInhibitDirty() ; }
   Bool_t _deleteWatch ; //! Delete watch flag 
 
   Bool_t inhibitDirty() const ;
@@ -64,7 +64,7 @@ public:
   inline Double_t getVal(const RooArgSet* set=0) const { 
 /*     if (_fast && !_inhibitDirty && std::string("RooHistFunc")==IsA()->GetName()) std::cout << "RooAbsReal::getVal(" << GetName() << ") CLEAN value = " << _value << std::endl ;  */
 #ifndef _WIN32
-    return (_fast && !_inhibitDirty) ? _value : getValV(set) ; 
+    return (_fast && !inhibitDirtyFlag()) ? _value : getValV(set) ; 
 #else
     return (_fast && !inhibitDirty()) ? _value : getValV(set) ;     
 #endif
@@ -73,6 +73,9 @@ public:
 
   virtual Double_t getValV(const RooArgSet* set=0) const ;
 
+  // Batch evaluation over a range of events of a vector data store
+  virtual void getValBatch(Double_t* output, Int_t firstEvent, Int_t nEvents, const RooVectorDataStore& data, const RooArgSet* normSet=0) const ;
+
   Double_t getPropagatedError(const RooFitResult& fr) ;
 
   Bool_t operator==(Double_t value) const ;
@@ -371,6 +374,8 @@ protected:
     return kFALSE ;
   }
   virtual Double_t evaluate() const = 0 ;
+  virtual Bool_t evaluateBatch(Double_t* output, Int_t firstEvent, Int_t nEvents, const RooVectorDataStore& data) const ;
+  void getValBatchByEvent(Double_t* output, Int_t firstEvent, Int_t nEvents, const RooVectorDataStore& data, const RooArgSet* normSet) const ;
 
   // Hooks for RooDataSet interface
   friend class RooRealIntegral ;
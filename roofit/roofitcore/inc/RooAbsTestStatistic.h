@@ -64,6 +64,25 @@ public:
   virtual Double_t offset() const { return _offset ; }
   virtual Double_t offsetCarry() const { return _offsetCarry; }
 
+  void setNumThreads(Int_t nThreads) ;
+  Int_t numThreads() const { 
+    // Return number of threads used in the calculation
+    return _nThreads ; 
+  }
+  Int_t numThreadCalls() const { 
+    // Return number of calculations done in parallel threads
+    return _threadCalls ; 
+  }
+  Double_t threadWallTime() const { 
+    // Return total wall time (in seconds) of the calculations done in parallel threads
+    return _threadWallTime ; 
+  }
+  Double_t threadSyncTime() const { 
+    // Return total time (in seconds) the threads spent being started, waiting
+    // for the slowest thread and being joined, averaged over the threads
+    return _threadSyncTime ; 
+  }
+
 protected:
 
   virtual void printCompactTreeHook(std::ostream& os, const char* indent="") ;
@@ -74,6 +93,13 @@ protected:
   virtual Double_t evaluatePartition(Int_t firstEvent, Int_t lastEvent, Int_t stepSize) const = 0 ;
   virtual Double_t getCarry() const;
 
+  virtual Bool_t canSplitEvents() const { 
+    // Return true if the test statistic is a sum of terms of the individual events
+    // that can be calculated on slices of the dataset, the terms that depend on the
+    // whole dataset being calculated on an empty partition of the whole dataset.
+    return kFALSE ; 
+  }
+
   void setMPSet(Int_t setNum, Int_t numSets) ; 
   void setSimCount(Int_t simCount) { 
     // Store total number of components p.d.f. of a RooSimultaneous in this component test statistic
@@ -122,6 +148,9 @@ protected:
   Bool_t initialize() ;
   void initSimMode(RooSimultaneous* pdf, RooAbsData* data, const RooArgSet* projDeps, const char* rangeName, const char* addCoefRangeName) ;    
   void initMPMode(RooAbsReal* real, RooAbsData* data, const RooArgSet* projDeps, const char* rangeName, const char* addCoefRangeName) ;
+  void initThreadMode(RooAbsReal* real, RooAbsData* data, const RooArgSet* projDeps, const char* rangeName, const char* addCoefRangeName) ;
+  void deleteThreadMode() ;
+  void calculateInThreads(pRooAbsTestStatistic* gofArray, Int_t nGof) const ;
 
   mutable Bool_t _init ;          //! Is object initialized  
   GOFOpMode   _gofOpMode ;        // Operation mode of test statistic instance 
@@ -140,13 +169,22 @@ protected:
   Int_t          _nCPU ;      //  Number of processors to use in parallel calculation mode
   pRooRealMPFE*  _mpfeArray ; //! Array of parallel execution frond ends
 
+  // Threaded mode data
+  Int_t          _nThreads ;         //  Number of threads to use in threaded calculation mode
+  Int_t          _nThreadGof ;       //! Number of sub-contexts calculating a slice of the events each
+  pRooAbsTestStatistic* _threadGofArray ; //! Array of sub-contexts calculating a slice of the events each
+  mutable Bool_t   _threadSerial ;   //! Calculate sub-contexts one after the other in the next calculation
+  mutable Int_t    _threadCalls ;    //! Number of calculations done in parallel threads
+  mutable Double_t _threadWallTime ; //! Total wall time of calculations done in parallel threads
+  mutable Double_t _threadSyncTime ; //! Total synchronization time of calculations done in parallel threads
+
   RooFit::MPSplit        _mpinterl ; // Use interleaving strategy rather than N-wise split for partioning of dataset for multiprocessor-split
   Bool_t         _doOffset ; // Apply interval value offset to control numeric precision?
   mutable Double_t _offset ; //! Offset
   mutable Double_t _offsetCarry; //! avoids loss of precision
   mutable Double_t _evalCarry; //! carry of Kahan sum in evaluatePartition
 
-  ClassDef(RooAbsTestStatistic,2) // Abstract base class for real-valued test statistics
+  ClassDef(RooAbsTestStatistic,3) // Abstract base class for real-valued test statistics
 
 };
 
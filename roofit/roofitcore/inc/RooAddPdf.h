@@ -41,6 +41,7 @@ public:
   virtual ~RooAddPdf() ;
 
   Double_t evaluate() const ;
+  Bool_t evaluateBatch(Double_t* output, Int_t firstEvent, Int_t nEvents, const RooVectorDataStore& data) const ;
   virtual Bool_t checkObservables(const RooArgSet* nset) const ;	
 
   virtual Bool_t forceAnalyticalInt(const RooAbsArg& /*dep*/) const { 
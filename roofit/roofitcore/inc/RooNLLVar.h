@@ -22,12 +22,13 @@
 #include <vector>
 
 class RooRealSumPdf ;
+class RooVectorDataStore ;
 
 class RooNLLVar : public RooAbsOptTestStatistic {
 public:
 
   // Constructors, assignment etc
-  RooNLLVar() { _first = kTRUE ; }
+  RooNLLVar() { _first = kTRUE ; _batchMode = kFALSE ; }
   RooNLLVar(const char *name, const char* title, RooAbsPdf& pdf, RooAbsData& data,
 	    const RooCmdArg& arg1=RooCmdArg::none(), const RooCmdArg& arg2=RooCmdArg::none(),const RooCmdArg& arg3=RooCmdArg::none(),
 	    const RooCmdArg& arg4=RooCmdArg::none(), const RooCmdArg& arg5=RooCmdArg::none(),const RooCmdArg& arg6=RooCmdArg::none(),
@@ -49,24 +50,35 @@ public:
   virtual RooAbsTestStatistic* create(const char *name, const char *title, RooAbsReal& pdf, RooAbsData& adata,
 				      const RooArgSet& projDeps, const char* rangeName, const char* addCoefRangeName=0, 
 				      Int_t nCPU=1, RooFit::MPSplit interleave=RooFit::BulkPartition, Bool_t verbose=kTRUE, Bool_t splitRange=kFALSE, Bool_t binnedL=kFALSE) {
-    return new RooNLLVar(name,title,(RooAbsPdf&)pdf,adata,projDeps,_extended,rangeName, addCoefRangeName, nCPU, interleave,verbose,splitRange,kFALSE,binnedL) ;
+    RooNLLVar* nll = new RooNLLVar(name,title,(RooAbsPdf&)pdf,adata,projDeps,_extended,rangeName, addCoefRangeName, nCPU, interleave,verbose,splitRange,kFALSE,binnedL) ;
+    nll->setBatchMode(_batchMode) ;
+    return nll ;
   }
   
   virtual ~RooNLLVar();
 
   void applyWeightSquared(Bool_t flag) ; 
 
+  void setBatchMode(Bool_t flag) ;
+  Bool_t batchMode() const { return _batchMode ; }
+
   virtual Double_t defaultErrorLevel() const { return 0.5 ; }
 
 protected:
 
   virtual Bool_t processEmptyDataSets() const { return _extended ; }
+  virtual Bool_t canSplitEvents() const { 
+    // The bins of a binned likelihood are indexed by their position in the whole dataset
+    return _binnedPdf==0 ; 
+  }
 
   static RooArgSet _emptySet ; // Supports named argument constructor
 
   Bool_t _extended ;
   virtual Double_t evaluatePartition(Int_t firstEvent, Int_t lastEvent, Int_t stepSize) const ;
+  void evaluateBatchPartition(const RooVectorDataStore& store, Int_t firstEvent, Int_t lastEvent, Double_t& result, Double_t& carry) const ;
   Bool_t _weightSq ; // Apply weights squared?
+  Bool_t _batchMode ; // Evaluate the p.d.f on batches of events?
   mutable Bool_t _first ; //!
   Double_t _offsetSaveW2; //!
   Double_t _offsetCarrySaveW2; //!
@@ -74,7 +86,7 @@ protected:
   mutable std::vector<Double_t> _binw ; //!
   mutable RooRealSumPdf* _binnedPdf ; //!
    
-  ClassDef(RooNLLVar,2) // Function representing (extended) -log(L) of p.d.f and dataset
+  ClassDef(RooNLLVar,3) // Function representing (extended) -log(L) of p.d.f and dataset
 };
 
 #endif
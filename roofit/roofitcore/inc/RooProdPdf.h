@@ -54,6 +54,7 @@ public:
   virtual ~RooProdPdf() ;
 
   virtual Double_t getValV(const RooArgSet* set=0) const ;
+  virtual void getValBatch(Double_t* output, Int_t firstEvent, Int_t nEvents, const RooVectorDataStore& data, const RooArgSet* normSet=0) const ;
   Double_t evaluate() const ;
   virtual Bool_t checkObservables(const RooArgSet* nset) const ;	
 
@@ -97,6 +98,7 @@ public:
   
 protected:
 
+  Bool_t evaluateBatch(Double_t* output, Int_t firstEvent, Int_t nEvents, const RooVectorDataStore& data) const ;
 
   RooAbsReal* makeCondPdfRatioCorr(RooAbsReal& term, const RooArgSet& termNset, const RooArgSet& termImpSet, const char* normRange, const char* refRange) const ;
 
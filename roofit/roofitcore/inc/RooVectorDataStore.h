@@ -132,6 +132,9 @@ public:
 
   const RooArgSet& row() { return _varsww ; }
 
+  // Column-wise access for batch evaluation (see RooAbsReal::getValBatch)
+  const Double_t* realColumn(const RooAbsArg& arg) const ;
+
   class RealVector {
   public:
     RealVector(UInt_t initialCapacity=(VECTOR_BUFFER_SIZE / sizeof(Double_t))) : 
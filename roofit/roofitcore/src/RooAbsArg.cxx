@@ -62,12 +62,14 @@ setting/clearing/testing named attributes.
 #include "RooResolutionModel.h"
 #include "RooVectorDataStore.h"
 #include "RooTreeDataStore.h"
+#include "ThreadLocalStorage.h"
 
 #include <string.h>
 #include <iomanip>
 #include <fstream>
 #include <algorithm>
 #include <sstream>
+#include <mutex>
 
 using namespace std ;
 
@@ -80,7 +82,18 @@ ClassImp(RooAbsArg)
 
 Bool_t RooAbsArg::_verboseDirty(kFALSE) ;
 Bool_t RooAbsArg::_inhibitDirty(kFALSE) ;
-Bool_t RooAbsArg::inhibitDirty() const { return _inhibitDirty && !_localNoInhibitDirty; }
+Bool_t RooAbsArg::inhibitDirty() const { return inhibitDirtyFlag() && !_localNoInhibitDirty; }
+
+// Dirty inhibit mode of the calling thread, so that the numeric integrals
+// calculated in parallel threads do not interfere, and number of threads in
+// this mode, from which _inhibitDirty is set
+namespace {
+  TTHREAD_TLS(Bool_t) _threadInhibitDirty = kFALSE ;
+}
+static Int_t _nThreadsInhibitDirty = 0 ;
+static std::mutex _inhibitDirtyMutex ;
+
+Bool_t RooAbsArg::threadInhibitDirty() { return _threadInhibitDirty ; }
 
 std::map<RooAbsArg*,TRefArray*> RooAbsArg::_ioEvoList ;
 std::stack<RooAbsArg*> RooAbsArg::_ioReadStack ;
@@ -234,10 +247,15 @@ RooAbsArg::~RooAbsArg()
 ////////////////////////////////////////////////////////////////////////////////
 /// Control global dirty inhibit mode. When set to true no value or shape dirty
 /// flags are propagated and cache is always considered to be dirty.
+/// The mode applies to the calling thread only.
 
 void RooAbsArg::setDirtyInhibit(Bool_t flag)
 {
-  _inhibitDirty = flag ;
+  if (_threadInhibitDirty == flag) return ;
+  _threadInhibitDirty = flag ;
+  std::lock_guard<std::mutex> lock(_inhibitDirtyMutex) ;
+  _nThreadsInhibitDirty += flag ? 1 : -1 ;
+  _inhibitDirty = (_nThreadsInhibitDirty > 0) ;
 }
 
 
@@ -840,7 +858,7 @@ Bool_t RooAbsArg::observableOverlaps(const RooArgSet* nset, const RooAbsArg& tes
 
 void RooAbsArg::setValueDirty(const RooAbsArg* source) const
 {
-  if (_operMode!=Auto || _inhibitDirty) return ;
+  if (_operMode!=Auto || inhibitDirtyFlag()) return ;
 
   // Handle no-propagation scenarios first
   if (_clientListValue.GetSize()==0) {
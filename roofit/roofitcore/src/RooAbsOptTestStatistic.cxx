@@ -510,6 +510,9 @@ void RooAbsOptTestStatistic::constOptimizeTestStatistic(ConstOpCode opcode, Bool
 
   RooAbsTestStatistic::constOptimizeTestStatistic(opcode,doAlsoTrackingOpt);
   if (operMode()!=Slave) return ;
+
+  // In threaded mode the events are calculated by the component test statistics
+  if (_nThreadGof>0) return ;
   
   if (_dataClone->hasFilledCache() && _dataClone->store()->cacheOwner()!=this) {
     if (opcode==Activate) {
@@ -156,6 +156,7 @@ the proxy holds a function, and will trigger an assert
 #include "RooChi2Var.h"
 #include "RooMinimizer.h"
 #include "RooRealIntegral.h"
+#include "RooVectorDataStore.h"
 #include "Math/CholeskyDecomp.h"
 #include <string>
 
@@ -311,6 +312,40 @@ Double_t RooAbsPdf::getValV(const RooArgSet* nset) const
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Fill output with the values of this p.d.f normalized over the observables
+/// in normSet, for the nEvents events of data starting at firstEvent (see
+/// RooAbsReal::getValBatch()). The unnormalized values are calculated with
+/// evaluateBatch() and divided by the normalization integral, which is
+/// calculated once for all events. The p.d.f is evaluated event by event if
+/// it does not support batch evaluation, if no normalization set is given
+/// or if its normalization depends on the observables of data, as for a
+/// conditional p.d.f. Unlike getVal(), batch evaluation does not check the
+/// values for errors and returns negative and NaN values as calculated
+
+void RooAbsPdf::getValBatch(Double_t* output, Int_t firstEvent, Int_t nEvents, const RooVectorDataStore& data, const RooArgSet* normSet) const
+{
+  if (normSet) {
+    if (normSet!=_normSet || _norm==0) {
+      syncNormalization(normSet) ;
+    }
+
+    if (!_norm->dependsOnValue(*data.get())) {
+      Double_t normVal(_norm->getVal()) ;
+      if (normVal>0. && evaluateBatch(output,firstEvent,nEvents,data)) {
+	for (Int_t i=0 ; i<nEvents ; i++) {
+	  output[i] /= normVal ;
+	}
+	return ;
+      }
+    }
+  }
+
+  getValBatchByEvent(output,firstEvent,nEvents,data,normSet) ;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Analytical integral with normalization (see RooAbsReal::analyticalIntegralWN() for further information)
 ///
@@ -748,6 +783,11 @@ Double_t RooAbsPdf::extendedTerm(Double_t observed, const RooArgSet* nset) const
 /// CloneData(Bool flag)           -- Use clone of dataset in NLL (default is true)
 /// Offset(Bool_t)                  -- Offset likelihood by initial value (so that starting value of FCN in minuit is zero). This
 ///                                    can improve numeric stability in simultaneously fits with components with large likelihood values
+/// BatchMode(Bool_t)               -- Evaluate the p.d.f on batches of events of unweighted datasets stored in a
+///                                    RooVectorDataStore (see RooNLLVar::setBatchMode())
+/// NumThreads(int num)             -- Calculate the NLL in num threads of this process, splitting the events or the
+///                                    components of a RooSimultaneous (see RooAbsTestStatistic::setNumThreads()).
+///                                    Cannot be combined with NumCPU
 /// 
 /// 
 
@@ -797,10 +837,13 @@ RooAbsReal* RooAbsPdf::createNLL(RooAbsData& data, const RooLinkedList& cmdList)
   pc.defineSet("glObs","GlobalObservables",0,0) ;
   pc.defineInt("constrAll","Constrained",0,0) ;
   pc.defineInt("doOffset","OffsetLikelihood",0,0) ;
+  pc.defineInt("batchMode","BatchMode",0,0) ;
+  pc.defineInt("numThreads","NumThreads",0,1) ;
   pc.defineSet("extCons","ExternalConstraints",0,0) ;
   pc.defineMutex("Range","RangeWithName") ;
   pc.defineMutex("Constrain","Constrained") ;
   pc.defineMutex("GlobalObservables","GlobalObservablesTag") ;
+  pc.defineMutex("NumCPU","NumThreads") ;
     
   // Process and check varargs 
   pc.process(cmdList) ;
@@ -821,6 +864,8 @@ RooAbsReal* RooAbsPdf::createNLL(RooAbsData& data, const RooLinkedList& cmdList)
   Int_t optConst = pc.getInt("optConst") ;
   Int_t cloneData = pc.getInt("cloneData") ;
   Int_t doOffset = pc.getInt("doOffset") ;
+  Bool_t batchMode = pc.getInt("batchMode") ;
+  Int_t numThreads = pc.getInt("numThreads") ;
   
   // If no explicit cloneData command is specified, cloneData is set to true if optimization is activated
   if (cloneData==2) {
@@ -899,7 +944,10 @@ RooAbsReal* RooAbsPdf::createNLL(RooAbsData& data, const RooLinkedList& cmdList)
     // Simple case: default range, or single restricted range
     //cout<<"FK: Data test 1: "<<data.sumEntries()<<endl;
 
-    nll = new RooNLLVar(baseName.c_str(),"-log(likelihood)",*this,data,projDeps,ext,rangeName,addCoefRangeName,numcpu,interl,verbose,splitr,cloneData) ;
+    RooNLLVar* nllVar = new RooNLLVar(baseName.c_str(),"-log(likelihood)",*this,data,projDeps,ext,rangeName,addCoefRangeName,numcpu,interl,verbose,splitr,cloneData) ;
+    nllVar->setBatchMode(batchMode) ;
+    nllVar->setNumThreads(numThreads) ;
+    nll = nllVar ;
 
   } else {
     // Composite case: multiple ranges
@@ -909,7 +957,9 @@ RooAbsReal* RooAbsPdf::createNLL(RooAbsData& data, const RooLinkedList& cmdList)
     strlcpy(buf,rangeName,bufSize) ;
     char* token = strtok(buf,",") ;
     while(token) {
-      RooAbsReal* nllComp = new RooNLLVar(Form("%s_%s",baseName.c_str(),token),"-log(likelihood)",*this,data,projDeps,ext,token,addCoefRangeName,numcpu,interl,verbose,splitr,cloneData) ;
+      RooNLLVar* nllComp = new RooNLLVar(Form("%s_%s",baseName.c_str(),token),"-log(likelihood)",*this,data,projDeps,ext,token,addCoefRangeName,numcpu,interl,verbose,splitr,cloneData) ;
+      nllComp->setBatchMode(batchMode) ;
+      nllComp->setNumThreads(numThreads) ;
       nllList.add(*nllComp) ;
       token = strtok(0,",") ;
     }
@@ -1007,6 +1057,11 @@ RooAbsReal* RooAbsPdf::createNLL(RooAbsData& data, const RooLinkedList& cmdList)
 /// ExternalConstraints(const RooArgSet& ) -- Include given external constraints to likelihood
 /// Offset(Bool_t)                  -- Offset likelihood by initial value (so that starting value of FCN in minuit is zero). This
 ///                                    can improve numeric stability in simultaneously fits with components with large likelihood values
+/// BatchMode(Bool_t)               -- Evaluate the p.d.f on batches of events of unweighted datasets stored in a
+///                                    RooVectorDataStore (see RooNLLVar::setBatchMode())
+/// NumThreads(int num)             -- Calculate the NLL in num threads of this process, splitting the events or the
+///                                    components of a RooSimultaneous (see RooAbsTestStatistic::setNumThreads()).
+///                                    Cannot be combined with NumCPU
 ///
 /// Options to control flow of fit procedure
 /// ----------------------------------------
@@ -1083,7 +1138,7 @@ RooFitResult* RooAbsPdf::fitTo(RooAbsData& data, const RooLinkedList& cmdList)
   RooCmdConfig pc(Form("RooAbsPdf::fitTo(%s)",GetName())) ;
 
   RooLinkedList fitCmdList(cmdList) ;
-  RooLinkedList nllCmdList = pc.filterCmdList(fitCmdList,"ProjectedObservables,Extended,Range,RangeWithName,SumCoefRange,NumCPU,SplitRange,Constrained,Constrain,ExternalConstraints,CloneData,GlobalObservables,GlobalObservablesTag,OffsetLikelihood") ;
+  RooLinkedList nllCmdList = pc.filterCmdList(fitCmdList,"ProjectedObservables,Extended,Range,RangeWithName,SumCoefRange,NumCPU,SplitRange,Constrained,Constrain,ExternalConstraints,CloneData,GlobalObservables,GlobalObservablesTag,OffsetLikelihood,BatchMode,NumThreads") ;
 
   pc.defineString("fitOpt","FitOptions",0,"") ;
   pc.defineInt("optConst","Optimize",0,2) ;
@@ -105,6 +105,8 @@
 #include "TVector.h"
 
 #include <sstream>
+#include <algorithm>
+#include <mutex>
 
 using namespace std ;
  
@@ -122,6 +124,9 @@ RooAbsReal::ErrorLoggingMode RooAbsReal::_evalErrorMode = RooAbsReal::PrintError
 Int_t RooAbsReal::_evalErrorCount = 0 ;
 map<const RooAbsArg*,pair<string,list<RooAbsReal::EvalError> > > RooAbsReal::_evalErrorList ;
 
+// Serializes the logging of evaluation errors by test statistics calculated in parallel threads
+static recursive_mutex gEvalErrorMutex ;
+
 
 ////////////////////////////////////////////////////////////////////////////////
 /// coverity[UNINIT_CTOR]
@@ -266,6 +271,71 @@ Double_t RooAbsReal::getValV(const RooArgSet* nset) const
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Fill output with the values of this object for the nEvents events of
+/// the vector data store data starting at firstEvent. Objects stored in
+/// data are copied from their column, objects that implement
+/// evaluateBatch() are evaluated on the whole range of events at once, and
+/// all other objects are evaluated event by event with getVal(normSet).
+///
+/// Batch evaluation does not change the cached value nor the dirty state
+/// of the objects it evaluates, but the event by event evaluation leaves
+/// the observables of data loaded with one of the events of the range
+
+void RooAbsReal::getValBatch(Double_t* output, Int_t firstEvent, Int_t nEvents, const RooVectorDataStore& data, const RooArgSet* normSet) const
+{
+  const Double_t* column = data.realColumn(*this) ;
+  if (column) {
+    std::copy(column+firstEvent,column+firstEvent+nEvents,output) ;
+    return ;
+  }
+
+  if (normSet && normSet!=_lastNSet) {
+    ((RooAbsReal*) this)->setProxyNormSet(normSet) ;    
+    _lastNSet = (RooArgSet*) normSet ;
+  }
+
+  if (!evaluateBatch(output,firstEvent,nEvents,data)) {
+    getValBatchByEvent(output,firstEvent,nEvents,data,normSet) ;
+  }
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Evaluate this object for the nEvents events of data starting at
+/// firstEvent and store the unnormalized values, as returned by
+/// evaluate(), in output. Return kFALSE if batch evaluation is not
+/// supported for the current configuration of the object, in which case
+/// the caller evaluates it event by event.
+///
+/// Implementations read the observables from the columns of data (see
+/// RooVectorDataStore::realColumn()) and must return kFALSE if any other
+/// input depends on the observables of data. The default implementation
+/// does not support batch evaluation
+
+Bool_t RooAbsReal::evaluateBatch(Double_t* /*output*/, Int_t /*firstEvent*/, Int_t /*nEvents*/, const RooVectorDataStore& /*data*/) const
+{
+  return kFALSE ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill output with the values of this object for the nEvents events of
+/// data starting at firstEvent, loading each event in the observables of
+/// data and calling getVal(normSet)
+
+void RooAbsReal::getValBatchByEvent(Double_t* output, Int_t firstEvent, Int_t nEvents, const RooVectorDataStore& data, const RooArgSet* normSet) const
+{
+  for (Int_t i=0 ; i<nEvents ; i++) {
+    data.get(firstEvent+i) ;
+    output[i] = getVal(normSet) ;
+  }
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 
 Int_t RooAbsReal::numEvalErrorItems() 
@@ -3581,6 +3651,8 @@ void RooAbsReal::logEvalError(const RooAbsReal* originator, const char* origName
     return ;
   }
 
+  lock_guard<recursive_mutex> lock(gEvalErrorMutex) ;
+
   if (_evalErrorMode==CountErrors) {
     _evalErrorCount++ ;
     return ;
@@ -3636,6 +3708,8 @@ void RooAbsReal::logEvalError(const char* message, const char* serverValueString
     return ;
   }
 
+  lock_guard<recursive_mutex> lock(gEvalErrorMutex) ;
+
   if (_evalErrorMode==CountErrors) {
     _evalErrorCount++ ;
     return ;
@@ -30,6 +30,10 @@
 // values. For the latter, the test statistic value is calculated in
 // partitions in parallel executing processes and a posteriori
 // combined in the main thread.
+//
+// Alternatively the calculation can be done in parallel threads of
+// the same process (see setNumThreads()), sharing the parameters
+// instead of copying the model and the data to each process.
 // END_HTML
 //
 
@@ -50,8 +54,14 @@
 #include "TTimeStamp.h"
 #include "RooProdPdf.h"
 #include "RooRealSumPdf.h"
+#include "RooGlobalFunc.h"
 
 #include <string>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
 
 using namespace std;
 
@@ -66,6 +76,8 @@ RooAbsTestStatistic::RooAbsTestStatistic() :
   _func(0), _data(0), _projDeps(0), _splitRange(0), _simCount(0),
   _verbose(kFALSE), _init(kFALSE), _gofOpMode(Slave), _nEvents(0), _setNum(0),
   _numSets(0), _extSet(0), _nGof(0), _gofArray(0), _nCPU(1), _mpfeArray(0),
+  _nThreads(1), _nThreadGof(0), _threadGofArray(0), _threadSerial(kTRUE),
+  _threadCalls(0), _threadWallTime(0), _threadSyncTime(0),
   _mpinterl(RooFit::BulkPartition), _doOffset(kFALSE), _offset(0),
   _offsetCarry(0), _evalCarry(0)
 {
@@ -104,6 +116,13 @@ RooAbsTestStatistic::RooAbsTestStatistic(const char *name, const char *title, Ro
   _gofArray(0),
   _nCPU(nCPU),
   _mpfeArray(0),
+  _nThreads(1),
+  _nThreadGof(0),
+  _threadGofArray(0),
+  _threadSerial(kTRUE),
+  _threadCalls(0),
+  _threadWallTime(0),
+  _threadSyncTime(0),
   _mpinterl(interleave),
   _doOffset(kFALSE),
   _offset(0),
@@ -163,6 +182,13 @@ RooAbsTestStatistic::RooAbsTestStatistic(const RooAbsTestStatistic& other, const
   _gofSplitMode(other._gofSplitMode),
   _nCPU(other._nCPU),
   _mpfeArray(0),
+  _nThreads(other._nThreads),
+  _nThreadGof(0),
+  _threadGofArray(0),
+  _threadSerial(kTRUE),
+  _threadCalls(0),
+  _threadWallTime(0),
+  _threadSyncTime(0),
   _mpinterl(other._mpinterl),
   _doOffset(other._doOffset),
   _offset(other._offset),
@@ -218,6 +244,13 @@ RooAbsTestStatistic::~RooAbsTestStatistic()
     delete[] _gofArray ;
   }
 
+  if (_threadCalls>0) {
+    coutI(Eval) << "RooAbsTestStatistic::~RooAbsTestStatistic(" << GetName() << ") " << _threadCalls << " calculations in " 
+		<< _nThreads << " threads, average wall time " << 1e3*_threadWallTime/_threadCalls << " ms of which " 
+		<< 1e3*_threadSyncTime/_threadCalls << " ms synchronization" << endl ;
+  }
+  deleteThreadMode() ;
+
   delete _projDeps ;
 
 }
@@ -230,6 +263,8 @@ RooAbsTestStatistic::~RooAbsTestStatistic()
 /// is performed separately on each simultaneous p.d.f component and associated
 /// data and then combined. If the test statistic calculation is parallelized
 /// partitions are calculated in nCPU processes and a posteriori combined.
+/// In threaded mode the components, or the slices of the events, are calculated
+/// in parallel threads and combined in a fixed order.
 
 Double_t RooAbsTestStatistic::evaluate() const
 {
@@ -242,6 +277,11 @@ Double_t RooAbsTestStatistic::evaluate() const
     // Evaluate array of owned GOF objects
     Double_t ret = 0.;
 
+    // Calculate the components in parallel threads, they are combined below from their cached values
+    if (_nThreads>1 && _nGof>1) {
+      calculateInThreads(_gofArray,_nGof) ;
+    }
+
     if (_mpinterl == RooFit::BulkPartition || _mpinterl == RooFit::Interleave ) {
       ret = combinedValue((RooAbsReal**)_gofArray,_nGof);
     } else {
@@ -318,7 +358,34 @@ Double_t RooAbsTestStatistic::evaluate() const
       break ;
     }
 
-    Double_t ret = evaluatePartition(nFirst,nLast,nStep);
+    Double_t ret ;
+    if (_nThreadGof>0) {
+
+      // Calculate the slices of the events in parallel threads, then the terms that
+      // depend on the whole dataset on an empty partition
+      calculateInThreads(_threadGofArray,_nThreadGof) ;
+
+      Double_t sum(0), carry = 0.;
+      for (Int_t i = 0; i <= _nThreadGof; ++i) {
+	Double_t y ;
+	if (i < _nThreadGof) {
+	  y = _threadGofArray[i]->getValV();
+	  carry += _threadGofArray[i]->getCarry();
+	} else {
+	  y = evaluatePartition(0,0,1);
+	  carry += _evalCarry;
+	}
+	y -= carry;
+	const Double_t t = sum + y;
+	carry = (t - sum) - y;
+	sum = t;
+      }
+      ret = sum ;
+      _evalCarry = carry;
+
+    } else {
+      ret = evaluatePartition(nFirst,nLast,nStep);
+    }
 
     if (numSets()==1) {
       const Double_t norm = globalNormalization();
@@ -346,6 +413,8 @@ Bool_t RooAbsTestStatistic::initialize()
     initMPMode(_func,_data,_projDeps,_rangeName.size()?_rangeName.c_str():0,_addCoefRangeName.size()?_addCoefRangeName.c_str():0) ;
   } else if (SimMaster == _gofOpMode) {
     initSimMode((RooSimultaneous*)_func,_data,_projDeps,_rangeName.size()?_rangeName.c_str():0,_addCoefRangeName.size()?_addCoefRangeName.c_str():0) ;
+  } else if (_nThreads>1) {
+    initThreadMode(_func,_data,_projDeps,_rangeName.size()?_rangeName.c_str():0,_addCoefRangeName.size()?_addCoefRangeName.c_str():0) ;
   }
   _init = kTRUE;
   return kFALSE;
@@ -373,7 +442,13 @@ Bool_t RooAbsTestStatistic::redirectServersHook(const RooAbsCollection& newServe
 // 	cout << "redirecting servers on " << _mpfeArray[i]->GetName() << endl;
       }
     }
+  } else if (_threadGofArray) {
+    // Forward to slaves
+    for (Int_t i = 0; i < _nThreadGof; ++i) {
+      _threadGofArray[i]->recursiveRedirectServers(newServerList,mustReplaceAll,nameChange);
+    }
   }
+  _threadSerial = kTRUE ;
   return kFALSE;
 }
 
@@ -423,7 +498,13 @@ void RooAbsTestStatistic::constOptimizeTestStatistic(ConstOpCode opcode, Bool_t
     for (Int_t i = 0; i < _nCPU; ++i) {
       _mpfeArray[i]->constOptimizeTestStatistic(opcode,doAlsoTrackingOpt);
     }
+  } else if (_threadGofArray) {
+    for (Int_t i = 0; i < _nThreadGof; ++i) {
+      _threadGofArray[i]->constOptimizeTestStatistic(opcode,doAlsoTrackingOpt);
+    }
   }
+  // The new caches are created by the next calculation
+  _threadSerial = kTRUE ;
 }
 
 
@@ -480,6 +561,146 @@ void RooAbsTestStatistic::initMPMode(RooAbsReal* real, RooAbsData* data, const R
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Initialize threaded calculation mode. Split the dataset in _nThreads slices of
+/// consecutive events and create a component test statistic for each slice, to be
+/// calculated in parallel threads. The component test statistics share the
+/// parameters of this instance, and each holds a clone of its slice of the data
+/// only: together they hold one copy of the data whatever the number of threads,
+/// in addition to the clone of the whole dataset held by this instance. The terms
+/// that depend on the whole dataset, like the extended term of the likelihood,
+/// are calculated by this instance.
+
+void RooAbsTestStatistic::initThreadMode(RooAbsReal* real, RooAbsData* data, const RooArgSet* projDeps, const char* rangeName, const char* addCoefRangeName)
+{
+  if (!canSplitEvents()) {
+    coutW(Eval) << "RooAbsTestStatistic::initThreadMode(" << GetName() << ") WARNING: " << ClassName() 
+		<< " cannot be calculated on slices of the dataset, calculation done in a single thread" << endl ;
+    return ;
+  }
+
+  Int_t nEvents = data->numEntries() ;
+  _nThreadGof = min(_nThreads,nEvents) ;
+  if (_nThreadGof<2) {
+    _nThreadGof = 0 ;
+    return ;
+  }
+  _threadGofArray = new pRooAbsTestStatistic[_nThreadGof];
+
+  for (Int_t i = 0; i < _nThreadGof; ++i) {
+    Int_t first = Int_t(Long64_t(nEvents)*i/_nThreadGof) ;
+    Int_t last = Int_t(Long64_t(nEvents)*(i+1)/_nThreadGof) ;
+    RooAbsData* slice = data->reduce(RooFit::EventRange(first,last)) ;
+    _threadGofArray[i] = create(Form("%s_THR%d",GetName(),i),Form("%s_THR%d",GetTitle(),i),*real,*slice,*projDeps,rangeName,addCoefRangeName,1,RooFit::BulkPartition,kFALSE,_splitRange);
+    _threadGofArray[i]->recursiveRedirectServers(_paramSet);
+    // The slice is not kept, the component holds its own clone of it
+    _threadGofArray[i]->_data = data ;
+    delete slice ;
+
+    // The terms depending on the whole dataset are not calculated by the component
+    _threadGofArray[i]->_extSet = -1 ;
+    if (_doOffset) {
+      _threadGofArray[i]->enableOffsetting(kTRUE) ;
+    }
+  }
+  _threadSerial = kTRUE ;
+  coutI(Eval) << "RooAbsTestStatistic::initThreadMode(" << GetName() << ") split " << nEvents << " events in " << _nThreadGof << " slices" << endl;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Delete the component test statistics of the threaded calculation mode
+
+void RooAbsTestStatistic::deleteThreadMode()
+{
+  for (Int_t i = 0; i < _nThreadGof; ++i) delete _threadGofArray[i];
+  delete[] _threadGofArray ;
+  _threadGofArray = 0 ;
+  _nThreadGof = 0 ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Calculate the values of the nGof test statistics of gofArray in up to _nThreads
+/// threads, that take the next test statistic to calculate until all are done.
+/// The values are cached in the test statistics. The first calculation after the
+/// (re)configuration of the test statistics creates their caches and is done in a
+/// single thread. For the other calculations the wall time of the parallel section
+/// and the time the threads did not spend in the calculations, averaged over the
+/// threads, are added to the timing counters.
+
+void RooAbsTestStatistic::calculateInThreads(pRooAbsTestStatistic* gofArray, Int_t nGof) const
+{
+  if (_threadSerial) {
+    for (Int_t i = 0; i < nGof; ++i) gofArray[i]->getValV();
+    _threadSerial = kFALSE ;
+    return ;
+  }
+
+  Int_t nThreads = min(_nThreads,nGof) ;
+  vector<Double_t> busyTime(nThreads) ;
+  atomic<Int_t> next(0) ;
+  chrono::steady_clock::time_point start = chrono::steady_clock::now() ;
+  auto worker = [&](Int_t ithread) {
+    chrono::steady_clock::time_point begin = chrono::steady_clock::now() ;
+    for (Int_t i = next++; i < nGof; i = next++) gofArray[i]->getValV();
+    busyTime[ithread] = chrono::duration<Double_t>(chrono::steady_clock::now() - begin).count() ;
+  } ;
+  vector<thread> threads ;
+  for (Int_t i = 1; i < nThreads; ++i) threads.push_back(thread(worker,i)) ;
+  worker(0) ;
+  for (UInt_t i = 0; i < threads.size(); ++i) threads[i].join() ;
+  Double_t wallTime = chrono::duration<Double_t>(chrono::steady_clock::now() - start).count() ;
+
+  Double_t sumBusyTime(0) ;
+  for (Int_t i = 0; i < nThreads; ++i) sumBusyTime += busyTime[i] ;
+  ++_threadCalls ;
+  _threadWallTime += wallTime ;
+  _threadSyncTime += wallTime - sumBusyTime/nThreads ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Calculate the test statistic in nThreads parallel threads of this process.
+/// The components of a simultaneous p.d.f. are calculated in parallel, and the
+/// events of any other p.d.f are split in nThreads slices calculated in parallel
+/// (see initThreadMode()). The threads share the parameters, and the slices of
+/// the events hold one more copy of the data in total, not one per thread. The
+/// results are combined in a fixed order so that they do not depend on the
+/// scheduling of the threads.
+///
+/// The nodes of the function must not modify shared state when they are evaluated,
+/// beyond the caches created by the first calculation, which is done in a single
+/// thread. The dirty state inhibit used by the numeric integrals (see
+/// RooAbsArg::setDirtyInhibit()) applies to the calling thread only, and the memory
+/// pool of RooArgSet is protected by a mutex. Threaded mode cannot be combined with the
+/// multi-process mode (nCPU>1). The synchronization cost of the parallel
+/// calculations is reported by threadSyncTime().
+
+void RooAbsTestStatistic::setNumThreads(Int_t nThreads)
+{
+  if (nThreads<1) nThreads = 1 ;
+  if (MPMaster == _gofOpMode && nThreads>1) {
+    coutW(Eval) << "RooAbsTestStatistic::setNumThreads(" << GetName() << ") WARNING: calculation in threads cannot be combined with calculation in parallel processes, ignored" << endl ;
+    return ;
+  }
+
+  _nThreads = nThreads ;
+  if (Slave == _gofOpMode && _init) {
+    deleteThreadMode() ;
+    if (_nThreads>1) {
+      initThreadMode(_func,_data,_projDeps,_rangeName.size()?_rangeName.c_str():0,_addCoefRangeName.size()?_addCoefRangeName.c_str():0) ;
+    }
+  }
+  _threadSerial = kTRUE ;
+  setValueDirty() ;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Initialize simultaneous p.d.f processing mode. Strip simultaneous
 /// p.d.f into individual components, split dataset in subset
@@ -631,6 +852,11 @@ Bool_t RooAbsTestStatistic::setData(RooAbsData& indata, Bool_t cloneData)
 
   switch(operMode()) {
   case Slave:
+    // Recreate the slices of the events calculated in threads from the new data
+    if (_nThreadGof>0) {
+      deleteThreadMode() ;
+      initThreadMode(_func,&indata,_projDeps,_rangeName.size()?_rangeName.c_str():0,_addCoefRangeName.size()?_addCoefRangeName.c_str():0) ;
+    }
     // Delegate to implementation
     return setDataSlave(indata, cloneData);
   case SimMaster:
@@ -688,6 +914,9 @@ void RooAbsTestStatistic::enableOffsetting(Bool_t flag)
       _offset = 0 ;
       _offsetCarry = 0;
     }
+    for (Int_t i = 0; i < _nThreadGof; ++i) {
+      _threadGofArray[i]->enableOffsetting(flag);
+    }
     setValueDirty() ;
     break ;
   case SimMaster:
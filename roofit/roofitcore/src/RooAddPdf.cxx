@@ -66,6 +66,7 @@
 #include "RooGlobalFunc.h"
 #include "RooRealIntegral.h"
 #include "RooTrace.h"
+#include "RooVectorDataStore.h"
 
 #include "Riostream.h"
 #include <algorithm>
@@ -851,6 +852,76 @@ Double_t RooAddPdf::evaluate() const
 }
 
 
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if any of the functions in list depends on the value of obs
+
+static Bool_t anyDependsOnValue(const RooAbsCollection& list, const RooArgSet& obs)
+{
+  RooFIter iter = list.fwdIterator() ;
+  RooAbsArg* arg ;
+  while((arg = iter.next())) {
+    if (arg->dependsOnValue(obs)) return kTRUE ;
+  }
+  return kFALSE ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Calculate the sum of the components on a range of events of data, with
+/// the components evaluated in batch where they support it. The
+/// coefficients are calculated once for all events, the sum is evaluated
+/// event by event if they depend on the observables of data
+
+Bool_t RooAddPdf::evaluateBatch(Double_t* output, Int_t firstEvent, Int_t nEvents, const RooVectorDataStore& data) const 
+{
+  const RooArgSet* nset = _normSet ; 
+
+  if (nset==0 || nset->getSize()==0) {
+    if (_refCoefNorm.getSize()!=0) {
+      nset = &_refCoefNorm ;
+    }
+  }
+
+  CacheElem* cache = getProjCache(nset) ;
+
+  const RooArgSet& obs = *data.get() ;
+  if (anyDependsOnValue(_coefList,obs) || anyDependsOnValue(cache->_suppNormList,obs) || 
+      anyDependsOnValue(cache->_projList,obs) || anyDependsOnValue(cache->_suppProjList,obs) ||
+      anyDependsOnValue(cache->_refRangeProjList,obs) || anyDependsOnValue(cache->_rangeProjList,obs)) {
+    return kFALSE ;
+  }
+
+  updateCoefficients(*cache,nset) ;
+
+  // Do running sum of coef/pdf pairs for all events
+  std::fill(output,output+nEvents,0.) ;
+  std::vector<Double_t> pdfVal(nEvents) ;
+  RooAbsPdf* pdf ;
+  Int_t i(0) ;
+  RooFIter pi = _pdfList.fwdIterator() ;
+  while((pdf = (RooAbsPdf*)pi.next())) {
+    if (pdf->isSelectedComp()) {
+      pdf->getValBatch(&pdfVal[0],firstEvent,nEvents,data,nset) ;
+      if (cache->_needSupNorm) {
+	Double_t snormVal = ((RooAbsReal*)cache->_suppNormList.at(i))->getVal() ;
+	for (Int_t j=0 ; j<nEvents ; j++) {
+	  output[j] += pdfVal[j]*_coefCache[i]/snormVal ;
+	}
+      } else {
+	for (Int_t j=0 ; j<nEvents ; j++) {
+	  output[j] += pdfVal[j]*_coefCache[i] ;
+	}
+      }
+    }
+    i++ ;
+  }
+
+  return kTRUE ;
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Reset error counter to given value, limiting the number
 /// of future error messages for this pdf to 'resetValue'
@@ -43,6 +43,7 @@
 #include <iomanip>
 #include <fstream>
 #include <list>
+#include <mutex>
 #include "TClass.h"
 #include "RooErrorHandler.h"
 #include "RooArgSet.h"
@@ -77,11 +78,15 @@ struct POOLDATA
 
 static std::list<POOLDATA> _memPoolList ;
 
+// Serializes the use of the memory pool by RooArgSets created in parallel threads
+static std::recursive_mutex _memPoolMutex ;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Clear memoery pool on exit to avoid reported memory leaks
 
 void RooArgSet::cleanup()
 {
+  std::lock_guard<std::recursive_mutex> lock(_memPoolMutex) ;
   std::list<POOLDATA>::iterator iter = _memPoolList.begin() ;
   while(iter!=_memPoolList.end()) {
     free(iter->_base) ;
@@ -105,6 +110,8 @@ void* RooArgSet::operator new (size_t bytes)
 {
   //cout << " RooArgSet::operator new(" << bytes << ")" << endl ;
 
+  std::lock_guard<std::recursive_mutex> lock(_memPoolMutex) ;
+
   if (!_poolBegin || _poolCur+(sizeof(RooArgSet)) >= _poolEnd) {
 
     if (_poolBegin!=0) {
@@ -180,6 +187,7 @@ void* RooArgSet::operator new (size_t bytes, void* ptr) noexcept
 void RooArgSet::operator delete (void* ptr)
 {
   // Decrease use count in pool that ptr is on
+  std::lock_guard<std::recursive_mutex> lock(_memPoolMutex) ;
   for (std::list<POOLDATA>::iterator poolIter =  _memPoolList.begin() ; poolIter!=_memPoolList.end() ; ++poolIter) {
     if ((char*)ptr > (char*)poolIter->_base && (char*)ptr < (char*)poolIter->_base + POOLSIZE) {
       (*(Int_t*)(poolIter->_base))-- ;
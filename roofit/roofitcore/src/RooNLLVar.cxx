@@ -42,6 +42,7 @@
 #include "RooRealSumPdf.h"
 #include "RooRealVar.h"
 #include "RooProdPdf.h"
+#include "RooVectorDataStore.h"
 
 ClassImp(RooNLLVar)
 ;
@@ -60,6 +61,8 @@ RooArgSet RooNLLVar::_emptySet ;
 ///  ConditionalObservables() -- Define conditional observables 
 ///  Verbose()      -- Verbose output of GOF framework classes
 ///  CloneData()    -- Clone input dataset for internal use (default is kTRUE)
+///  BatchMode()    -- Evaluate the p.d.f on batches of events (see setBatchMode())
+///  NumThreads()   -- Calculate the likelihood in parallel threads (see RooAbsTestStatistic::setNumThreads())
 
 RooNLLVar::RooNLLVar(const char *name, const char* title, RooAbsPdf& pdf, RooAbsData& indata,
 		     const RooCmdArg& arg1, const RooCmdArg& arg2,const RooCmdArg& arg3,
@@ -79,6 +82,8 @@ RooNLLVar::RooNLLVar(const char *name, const char* title, RooAbsPdf& pdf, RooAbs
   RooCmdConfig pc("RooNLLVar::RooNLLVar") ;
   pc.allowUndefined() ;
   pc.defineInt("extended","Extended",0,kFALSE) ;
+  pc.defineInt("batchMode","BatchMode",0,kFALSE) ;
+  pc.defineInt("numThreads","NumThreads",0,1) ;
 
   pc.process(arg1) ;  pc.process(arg2) ;  pc.process(arg3) ;
   pc.process(arg4) ;  pc.process(arg5) ;  pc.process(arg6) ;
@@ -86,6 +91,7 @@ RooNLLVar::RooNLLVar(const char *name, const char* title, RooAbsPdf& pdf, RooAbs
 
   _extended = pc.getInt("extended") ;
   _weightSq = kFALSE ;
+  _batchMode = pc.getInt("batchMode") ;
   _first = kTRUE ;
   _offset = 0.;
   _offsetCarry = 0.;
@@ -93,6 +99,8 @@ RooNLLVar::RooNLLVar(const char *name, const char* title, RooAbsPdf& pdf, RooAbs
   _offsetCarrySaveW2 = 0.;
 
   _binnedPdf = 0 ;
+
+  setNumThreads(pc.getInt("numThreads")) ;
 }
 
 
@@ -107,6 +115,7 @@ RooNLLVar::RooNLLVar(const char *name, const char *title, RooAbsPdf& pdf, RooAbs
   RooAbsOptTestStatistic(name,title,pdf,indata,RooArgSet(),rangeName,addCoefRangeName,nCPU,interleave,verbose,splitRange,cloneData),
   _extended(extended),
   _weightSq(kFALSE),
+  _batchMode(kFALSE),
   _first(kTRUE), _offsetSaveW2(0.), _offsetCarrySaveW2(0.)
 {
   // If binned likelihood flag is set, pdf is a RooRealSumPdf representing a yield vector
@@ -152,6 +161,7 @@ RooNLLVar::RooNLLVar(const char *name, const char *title, RooAbsPdf& pdf, RooAbs
   RooAbsOptTestStatistic(name,title,pdf,indata,projDeps,rangeName,addCoefRangeName,nCPU,interleave,verbose,splitRange,cloneData),
   _extended(extended),
   _weightSq(kFALSE),
+  _batchMode(kFALSE),
   _first(kTRUE), _offsetSaveW2(0.), _offsetCarrySaveW2(0.)
 {
   // If binned likelihood flag is set, pdf is a RooRealSumPdf representing a yield vector
@@ -191,6 +201,7 @@ RooNLLVar::RooNLLVar(const RooNLLVar& other, const char* name) :
   RooAbsOptTestStatistic(other,name),
   _extended(other._extended),
   _weightSq(other._weightSq),
+  _batchMode(other._batchMode),
   _first(kTRUE), _offsetSaveW2(other._offsetSaveW2),
   _offsetCarrySaveW2(other._offsetCarrySaveW2),
   _binw(other._binw) {
@@ -220,6 +231,8 @@ void RooNLLVar::applyWeightSquared(Bool_t flag)
       std::swap(_offset, _offsetSaveW2);
       std::swap(_offsetCarry, _offsetCarrySaveW2);
     }
+    for (Int_t i=0 ; i<_nThreadGof ; i++)
+      ((RooNLLVar*)_threadGofArray[i])->applyWeightSquared(flag);
     setValueDirty();
   } else if ( _gofOpMode==MPMaster) {
     for (Int_t i=0 ; i<_nCPU ; i++)
@@ -232,6 +245,32 @@ void RooNLLVar::applyWeightSquared(Bool_t flag)
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// If flag is true, the unbinned likelihood of an unweighted dataset stored
+/// in a RooVectorDataStore is calculated by evaluating the p.d.f on batches
+/// of events read from the columns of the store (see RooAbsPdf::getValBatch()),
+/// instead of loading each event in the observables and calling getLogVal().
+/// The nodes of the p.d.f that do not support batch evaluation are still
+/// evaluated event by event. In multi-process mode the flag must be set before
+/// the first evaluation of the likelihood.
+
+void RooNLLVar::setBatchMode(Bool_t flag) 
+{
+  _batchMode = flag ;
+  if (_gofOpMode==SimMaster) {
+    for (Int_t i=0 ; i<_nGof ; i++)
+      ((RooNLLVar*)_gofArray[i])->setBatchMode(flag);
+  } else if (_gofOpMode==Slave) {
+    for (Int_t i=0 ; i<_nThreadGof ; i++)
+      ((RooNLLVar*)_threadGofArray[i])->setBatchMode(flag);
+  } else if (_gofOpMode==MPMaster && _mpfeArray) {
+    coutW(Minimization) << "RooNLLVar::setBatchMode(" << GetName() << ") WARNING: batch mode cannot be changed in running parallel processes" << std::endl ;
+  }
+  setValueDirty() ;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Calculate and return likelihood on subset of data from firstEvent to lastEvent
 /// processed with a step size of 'stepSize'. If this an extended likelihood and
@@ -303,28 +342,40 @@ Double_t RooNLLVar::evaluatePartition(Int_t firstEvent, Int_t lastEvent, Int_t s
 
   } else {
 
-    for (i=firstEvent ; i<lastEvent ; i+=stepSize) {
+    // In batch mode the events of an unweighted dataset, all with unit weight, are evaluated in batches
+    const RooVectorDataStore* vstore = _batchMode ? dynamic_cast<const RooVectorDataStore*>(_dataClone->store()) : 0 ;
+    if (vstore && stepSize==1 && !_dataClone->isWeighted()) {
+
+      evaluateBatchPartition(*vstore,firstEvent,lastEvent,result,carry) ;
+      if (lastEvent>firstEvent) {
+	sumWeight = lastEvent - firstEvent ;
+      }
+
+    } else {
+
+      for (i=firstEvent ; i<lastEvent ; i+=stepSize) {
             
-      _dataClone->get(i) ;
+	_dataClone->get(i) ;
       
-      if (!_dataClone->valid()) continue;
+	if (!_dataClone->valid()) continue;
       
-      Double_t eventWeight = _dataClone->weight();
-      if (0. == eventWeight * eventWeight) continue ;
-      if (_weightSq) eventWeight = _dataClone->weightSquared() ;
+	Double_t eventWeight = _dataClone->weight();
+	if (0. == eventWeight * eventWeight) continue ;
+	if (_weightSq) eventWeight = _dataClone->weightSquared() ;
       
-      Double_t term = -eventWeight * pdfClone->getLogVal(_normSet);
+	Double_t term = -eventWeight * pdfClone->getLogVal(_normSet);
       
       
-      Double_t y = eventWeight - sumWeightCarry;
-      Double_t t = sumWeight + y;
-      sumWeightCarry = (t - sumWeight) - y;
-      sumWeight = t;
+	Double_t y = eventWeight - sumWeightCarry;
+	Double_t t = sumWeight + y;
+	sumWeightCarry = (t - sumWeight) - y;
+	sumWeight = t;
       
-      y = term - carry;
-      t = result + y;
-      carry = (t - result) - y;
-      result = t;
+	y = term - carry;
+	t = result + y;
+	carry = (t - result) - y;
+	result = t;
+      }
     }
     
     // include the extended maximum likelihood term, if requested
@@ -422,4 +473,44 @@ Double_t RooNLLVar::evaluatePartition(Int_t firstEvent, Int_t lastEvent, Int_t s
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Add -log(pdf) of the events from firstEvent to lastEvent of store to
+/// result, with Kahan summation as in evaluatePartition(). The p.d.f is
+/// evaluated on batches of events with RooAbsPdf::getValBatch(). Events
+/// with a value that getLogVal() would report as an error or as a warning
+/// are loaded and evaluated again with getLogVal(), so that the likelihood
+/// and the evaluation errors are the same as in the event by event
+/// calculation
+
+void RooNLLVar::evaluateBatchPartition(const RooVectorDataStore& store, Int_t firstEvent, Int_t lastEvent, Double_t& result, Double_t& carry) const
+{
+  const Int_t batchSize = 1024 ;
+  if (lastEvent<=firstEvent) return ;
+
+  RooAbsPdf* pdfClone = (RooAbsPdf*) _funcClone ;
+  std::vector<Double_t> prob(std::min(batchSize,lastEvent-firstEvent)) ;
+
+  for (Int_t begin=firstEvent ; begin<lastEvent ; begin+=batchSize) {
+    Int_t n = std::min(batchSize,lastEvent-begin) ;
+    pdfClone->getValBatch(&prob[0],begin,n,store,_normSet) ;
+
+    for (Int_t i=0 ; i<n ; i++) {
+      Double_t term ;
+      if (prob[i]>0 && prob[i]<=1e6) {
+	term = -log(prob[i]) ;
+      } else {
+	_dataClone->get(begin+i) ;
+	term = -pdfClone->getLogVal(_normSet) ;
+      }
+
+      Double_t y = term - carry;
+      Double_t t = result + y;
+      carry = (t - result) - y;
+      result = t;
+    }
+  }
+}
+
+
+
 
@@ -58,6 +58,7 @@
 #include "RooCustomizer.h"
 #include "RooRealIntegral.h"
 #include "RooTrace.h"
+#include "RooVectorDataStore.h"
 
 #include <cstring>
 #include <sstream>
@@ -521,6 +522,61 @@ Double_t RooProdPdf::evaluate() const
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Calculate values of object on a range of events of data (see RooAbsPdf::getValBatch())
+
+void RooProdPdf::getValBatch(Double_t* output, Int_t firstEvent, Int_t nEvents, const RooVectorDataStore& data, const RooArgSet* normSet) const 
+{
+  _curNormSet = (RooArgSet*)normSet ;
+  RooAbsPdf::getValBatch(output,firstEvent,nEvents,data,normSet) ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Calculate running product of pdf terms on a range of events of data,
+/// with the terms evaluated in batch where they support it. As in
+/// calculate() the terms following the one that brings the product of an
+/// event below the cut-off do not change its value. Rearranged products
+/// are evaluated event by event
+
+Bool_t RooProdPdf::evaluateBatch(Double_t* output, Int_t firstEvent, Int_t nEvents, const RooVectorDataStore& data) const 
+{
+  Int_t code ;
+  CacheElem* cache = (CacheElem*) _cacheMgr.getObj(_curNormSet,0,&code) ;
+
+  // If cache doesn't have our configuration, recalculate here
+  if (!cache) {
+    RooArgList *plist(0) ;
+    RooLinkedList *nlist(0) ;
+    getPartIntList(_curNormSet,0,plist,nlist,code) ;
+    cache = (CacheElem*) _cacheMgr.getObj(_curNormSet,0,&code) ;
+  }
+
+  if (cache->_isRearranged) {
+    return kFALSE ;
+  }
+
+  std::fill(output,output+nEvents,1.0) ;
+  std::vector<Double_t> piVal(nEvents) ;
+  RooAbsReal* partInt;
+  RooArgSet* normSet;
+  RooFIter plIter = cache->_partList.fwdIterator();
+  RooFIter nlIter = cache->_normList.fwdIterator();
+  for (partInt = (RooAbsReal*) plIter.next(),
+      normSet = (RooArgSet*) nlIter.next(); partInt && normSet;
+    partInt = (RooAbsReal*) plIter.next(),
+    normSet = (RooArgSet*) nlIter.next()) {
+    partInt->getValBatch(&piVal[0],firstEvent,nEvents,data,normSet->getSize() > 0 ? normSet : 0) ;
+    for (Int_t i=0 ; i<nEvents ; i++) {
+      if (!(output[i] <= _cutOff)) output[i] *= piVal[i] ;
+    }
+  }
+  return kTRUE ;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Calculate running product of pdfs terms, using the supplied
 /// normalization set in 'normSetList' for each component
@@ -1078,6 +1078,34 @@ Int_t RooVectorDataStore::numEntries() const
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return a pointer to the contiguous column of values stored for the real
+/// valued observable with the same name as arg, or a null pointer if this
+/// store has no such column. Only the observables of the data set are
+/// considered, not the values of the optimization cache. The column holds
+/// numEntries() values and is invalidated when rows are added to the store
+
+const Double_t* RooVectorDataStore::realColumn(const RooAbsArg& arg) const
+{
+  std::vector<RealVector*>::const_iterator iter = _realStoreList.begin() ;
+  for (; iter!=_realStoreList.end() ; ++iter) {
+    if ((*iter)->bufArg()->namePtr()==arg.namePtr()) {
+      return (*iter)->_vec.empty() ? 0 : &(*iter)->_vec.front() ;
+    }
+  }
+
+  std::vector<RealFullVector*>::const_iterator iter2 = _realfStoreList.begin() ;
+  for (; iter2!=_realfStoreList.end() ; ++iter2) {
+    if ((*iter2)->bufArg()->namePtr()==arg.namePtr()) {
+      return (*iter2)->_vec.empty() ? 0 : &(*iter2)->_vec.front() ;
+    }
+  }
+
+  return 0 ;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 
 void RooVectorDataStore::reset() 
@@ -91,6 +91,12 @@ For parallel runs, ToyMCSampler can be given an instance of ProofConfig
 and then run in parallel using proof or proof-lite. Internally, it uses
 ToyMCStudy with the RooStudyManager.
 
+Without PROOF, the toys can be generated in parallel in local processes
+forked with TPool (see SetNWorkers). The toys are then split in tasks of a
+given number of toys, and the random generator is seeded at the start of
+each toy from a seed drawn from the current generator and the index of the
+toy, so that the result does not depend on the number of processes.
+
 \ingroup Roostats
 
 */
@@ -262,6 +268,12 @@ class ToyMCSampler: public TestStatSampler {
       // calling with argument or NULL deactivates proof
       void SetProofConfig(ProofConfig *pc = NULL) { fProofConfig = pc; }
 
+      // generate the toys in nworkers local processes (0 = serial run, the default),
+      // in tasks of toysPerTask toys (0 = default of 100 toys per task).
+      // It is ignored when a ProofConfig is given
+      void SetNWorkers(Int_t nworkers, Int_t toysPerTask = 0) { fNWorkers = nworkers; fToysPerTask = toysPerTask; }
+      Int_t GetNWorkers() const { return fNWorkers; }
+
       void SetProtoData(const RooDataSet* d) { fProtoData = d; }
       
    protected:
@@ -274,6 +286,9 @@ class ToyMCSampler: public TestStatSampler {
       // helper method for clearing  the cache
       virtual void ClearCache();
 
+      // generate the toys in fNWorkers local processes
+      RooDataSet* GetSamplingDistributionsMultiProcess(RooArgSet& paramPoint);
+
 
       // densities, snapshots, and test statistics to reweight to
       RooAbsPdf *fPdf; // model (can be alt or null)
@@ -307,6 +322,10 @@ class ToyMCSampler: public TestStatSampler {
       const RooDataSet *fProtoData; // in dev
       
       ProofConfig *fProofConfig;   //!
+
+      Int_t fNWorkers; // number of local processes generating the toys (0 for a serial run)
+      Int_t fToysPerTask; // number of toys per task of the local processes (0 for the default)
+      ULong_t fToySeed; //! seed of the first toy when the generator is seeded for each toy (0 if not)
       
       mutable NuisanceParametersSampler *fNuisanceParametersSampler; //!
 
@@ -324,7 +343,7 @@ class ToyMCSampler: public TestStatSampler {
       Bool_t fUseMultiGen ; // Use PrepareMultiGen?
 
    protected:
-   ClassDef(ToyMCSampler,3) // A simple implementation of the TestStatSampler interface
+   ClassDef(ToyMCSampler,4) // A simple implementation of the TestStatSampler interface
 };
 }
 
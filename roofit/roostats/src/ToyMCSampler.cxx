@@ -36,6 +36,12 @@
 
 #include "TMath.h"
 
+#ifndef R__WIN32
+#include "TPool.h"
+#endif
+
+#include <algorithm>
+
 
 using namespace RooFit;
 using namespace std;
@@ -157,6 +163,9 @@ ToyMCSampler::ToyMCSampler() : fSamplingDistName("SD"), fNToys(1)
    fProtoData = NULL;
 
    fProofConfig = NULL;
+   fNWorkers = 0;
+   fToysPerTask = 0;
+   fToySeed = 0;
    fNuisanceParametersSampler = NULL;
 
    _allVars = NULL ;
@@ -196,6 +205,9 @@ ToyMCSampler::ToyMCSampler(TestStatistic &ts, Int_t ntoys) :
    fProtoData = NULL;
 
    fProofConfig = NULL;
+   fNWorkers = 0;
+   fToysPerTask = 0;
+   fToySeed = 0;
    fNuisanceParametersSampler = NULL;
 
    _allVars = NULL ;
@@ -302,9 +314,13 @@ RooDataSet* ToyMCSampler::GetSamplingDistributions(RooArgSet& paramPointIn)
    // Use for serial and parallel runs.
 
    // ======= S I N G L E   R U N ? =======
-   if(!fProofConfig)
+   if(!fProofConfig && fNWorkers < 1)
       return GetSamplingDistributionsSingleWorker(paramPointIn);
 
+   // ======= P A R A L L E L   R U N   I N   L O C A L   P R O C E S S E S =======
+   if(!fProofConfig)
+      return GetSamplingDistributionsMultiProcess(paramPointIn);
+
 
    // ======= P A R A L L E L   R U N =======
    if (!CheckConfig()){
@@ -385,6 +401,10 @@ RooDataSet* ToyMCSampler::GetSamplingDistributionsSingleWorker(RooArgSet& paramP
       // need to check at the beginning for case that zero toys are requested
       if (toysInTails >= fToysInTails  &&  i+1 > fNToys) break;
 
+      // seed the generator for each toy when running in parallel processes
+      // (the nuisance parameter sampler then generates one point per toy)
+      if (fToySeed) RooRandom::randomGenerator()->SetSeed(fToySeed + i);
+
       // status update
       if ( i% 500 == 0 && i>0 ) {
          oocoutP((TObject*)0,Generation) << "generated toys: " << i << " / " << fNToys;
@@ -437,6 +457,120 @@ RooDataSet* ToyMCSampler::GetSamplingDistributionsSingleWorker(RooArgSet& paramP
    return detOutAgg.GetAsDataSet(fSamplingDistName, fSamplingDistName);
 }
 
+RooDataSet* ToyMCSampler::GetSamplingDistributionsMultiProcess(RooArgSet& paramPointIn)
+{
+   // Generate the toys in fNWorkers processes forked with TPool. The toys are
+   // split in tasks of fToysPerTask toys, which are given to the processes as
+   // they become free. The generator is seeded at the start of each toy from a
+   // seed drawn from the current generator plus the index of the toy, so that
+   // the toys do not depend on the number of processes. The tasks are run in
+   // batches of a few tasks per process; the datasets of a batch are appended
+   // in the order of the toys as soon as it completes, so that the client
+   // never holds more than one batch of datasets besides the merged one.
+
+   if (!CheckConfig()){
+      oocoutE((TObject*)NULL, InputArguments)
+         << "Bad COnfiguration in ToyMCSampler "
+         << endl;
+      return nullptr;
+   }
+
+   // turn adaptive sampling off if given
+   if(fToysInTails) {
+      fToysInTails = 0;
+      oocoutW((TObject*)NULL, InputArguments)
+         << "Adaptive sampling in ToyMCSampler is not supported for parallel runs."
+         << endl;
+   }
+
+#ifdef R__WIN32
+   oocoutW((TObject*)NULL, InputArguments)
+      << "ToyMCSampler: parallel processes are not supported on Windows, generate the toys serially."
+      << endl;
+   return GetSamplingDistributionsSingleWorker(paramPointIn);
+#else
+   Int_t totToys = fNToys;
+   if (fMaxToys < totToys) totToys = (Int_t)fMaxToys;
+   if (totToys <= 0) return GetSamplingDistributionsSingleWorker(paramPointIn);
+
+   Int_t toysPerTask = (fToysPerTask > 0) ? fToysPerTask : 100;
+   Int_t nTasks = (totToys + toysPerTask - 1) / toysPerTask;
+   ULong_t seed = 1 + RooRandom::randomGenerator()->Integer(TMath::Limits<Int_t>::Max());
+
+   oocoutP((TObject*)0,Generation) << "ToyMCSampler: generating " << totToys << " toys in " << nTasks
+      << " tasks of " << toysPerTask << " toys with " << std::min(fNWorkers, nTasks) << " processes, seed " << seed << endl;
+
+   // task run by the worker processes; the dataset of the previous task, already
+   // sent to the client, is deleted at the start of the next one
+   RooDataSet* previous = NULL;
+   auto runTask = [&](Int_t task) -> RooDataSet* {
+      delete previous;
+      Int_t first = task * toysPerTask;
+      fNToys = std::min(toysPerTask, totToys - first);
+      fToySeed = seed + first;
+      if (fNuisanceParametersSampler) {
+         delete fNuisanceParametersSampler;
+         fNuisanceParametersSampler = NULL;
+      }
+      // seed also the task, for the derived classes not seeding each toy
+      RooRandom::randomGenerator()->SetSeed(fToySeed);
+      RooDataSet* result = GetSamplingDistributionsSingleWorker(paramPointIn);
+      if (!result) {
+         RooRealVar wgt("weight","weight",1.0);
+         result = new RooDataSet(fSamplingDistName.c_str(), fSamplingDistName.c_str(), RooArgSet(wgt), RooFit::WeightVar(wgt));
+      }
+      result->SetUniqueID(task);
+      // tasks are handed out in order, so this is also the progress of the whole run
+      oocoutP((TObject*)0,Generation) << "generated toys: " << first + fNToys << " / " << totToys
+         << " (task " << task + 1 << " / " << nTasks << ")" << endl;
+      previous = result;
+      return result;
+   };
+
+   // number of tasks given to the processes before their datasets are merged
+   const Int_t tasksPerBatch = 4 * fNWorkers;
+   TPool pool(fNWorkers);
+   RooDataSet* output = NULL;
+   Int_t nCompleted = 0;
+   for (Int_t firstTask = 0; firstTask < nTasks; firstTask += tasksPerBatch) {
+      std::vector<Int_t> tasks;
+      for (Int_t i = firstTask; i < std::min(firstTask + tasksPerBatch, nTasks); ++i) tasks.push_back(i);
+      std::vector<RooDataSet*> results = pool.Map(runTask, tasks);
+      nCompleted += results.size();
+
+      // merge the datasets in the order of the toys
+      std::sort(results.begin(), results.end(),
+                [](RooDataSet* a, RooDataSet* b) { return a->GetUniqueID() < b->GetUniqueID(); });
+      for (size_t i = 0; i < results.size(); ++i) {
+         if (!output) {
+            output = results[i];
+            continue;
+         }
+         // tasks without valid toys have no test statistic column
+         if (results[i]->numEntries() > 0) {
+            if (output->numEntries() == 0) std::swap(output, results[i]);
+            else output->append(*results[i]);
+         }
+         delete results[i];
+      }
+   }
+
+   // reset the number of toys
+   fNToys = totToys;
+
+   if (nCompleted != nTasks) {
+      oocoutE((TObject*)NULL, Generation) << "ToyMCSampler: only " << nCompleted << " of " << nTasks
+         << " tasks of toys were completed" << endl;
+   }
+   if (output) {
+      output->SetUniqueID(0);
+      oocoutP((TObject*)0,Generation) << "ToyMCSampler: merged data size is " << output->numEntries() << endl;
+   }
+
+   return output;
+#endif
+}
+
 void ToyMCSampler::GenerateGlobalObservables(RooAbsPdf& pdf) const {
 
    
@@ -521,7 +655,7 @@ RooAbsData* ToyMCSampler::GenerateToyData(RooArgSet& paramPoint, double& weight,
 
    // create nuisance parameter points
    if(!fNuisanceParametersSampler && fPriorNuisance && fNuisancePars) {
-      fNuisanceParametersSampler = new NuisanceParametersSampler(fPriorNuisance, fNuisancePars, fNToys, fExpectedNuisancePar);
+      fNuisanceParametersSampler = new NuisanceParametersSampler(fPriorNuisance, fNuisancePars, fToySeed ? 1 : fNToys, fExpectedNuisancePar);
       if ((fUseMultiGen || fgAlwaysUseMultiGen) &&  fNuisanceParametersSampler )
          oocoutI((TObject*)NULL,InputArguments) << "Cannot use multigen when nuisance parameters vary for every toy" << endl;
    }
@@ -38,6 +38,8 @@
 //  if comp = 1 event is compressed.
 //  if comp = 2 same as 1. In addition branches with floats in the TClonesArray
 //                         are also compressed.
+//  if comp > 99 it is used as the full compression settings
+//               (100 * algorithm + level), e.g. 404 for LZ4 level 4.
 //  The 4th argument fill can be set to 0 if one wants to time
 //     the percentage of time spent in creating the event structure and
 //     not write the event in the file.
@@ -194,7 +196,8 @@ int main(int argc, char **argv)
          hfile = new TNetFile("root://localhost/root/test/EventNet.root","RECREATE","TTree benchmark ROOT file");
       } else
          hfile = new TFile("Event.root","RECREATE","TTree benchmark ROOT file");
-      hfile->SetCompressionLevel(comp);
+      if (comp > 99) hfile->SetCompressionSettings(comp);
+      else           hfile->SetCompressionLevel(comp);
 
      // Create histogram to show write_time in function of time
      Float_t curtime = -0.5;
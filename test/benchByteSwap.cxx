@@ -0,0 +1,209 @@
+// @(#)root/test:$Id$
+
+// This program measures the speed of the fast array overloads of TBuffer
+// (TBufferFile::WriteFastArray and TBufferFile::ReadFastArray for all the
+// basic types, and the Float16_t/Double32_t variants with a range, with a
+// number of bits or without either) which convert the arrays between the
+// byte order of the host and the big endian byte order of ROOT files.
+// Each overload is run with the portable "scalar" kernels and with the
+// best SIMD kernels supported by the processor (see
+// TBufferFile::SetByteSwapKernels); the throughput is given in MBytes of
+// array (in memory) per second.
+// The bytes written by the two kernels are compared, and the values read
+// back are checked against the values written (or, for the truncated
+// types, against the values read with the scalar kernels).
+//
+//  run with
+//     benchByteSwap [nvalues] [nloop]
+//
+// The default is 100000 values per array and 200 loops.
+
+#include "TROOT.h"
+#include "TBufferFile.h"
+#include "TStreamerElement.h"
+#include "TVirtualStreamerInfo.h"
+#include "TRandom3.h"
+#include "TStopwatch.h"
+#include "TString.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <functional>
+#include <vector>
+
+struct TResult {
+   Double_t fWrite;   // MBytes per second written
+   Double_t fRead;    // MBytes per second read
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Run nloop times write then read on buf, return the throughput for an
+/// array of size bytes and leave in buf the bytes written.
+
+static TResult Measure(TBufferFile &buf, Int_t size, Int_t nloop,
+                       const std::function<void(TBuffer&)> &write,
+                       const std::function<void(TBuffer&)> &read)
+{
+   TStopwatch wtimer, rtimer;
+   wtimer.Reset();
+   rtimer.Reset();
+   for (Int_t i = 0; i < nloop; ++i) {
+      buf.SetWriteMode();
+      buf.SetBufferOffset(0);
+      wtimer.Start(kFALSE);
+      write(buf);
+      wtimer.Stop();
+      buf.SetReadMode();
+      buf.SetBufferOffset(0);
+      rtimer.Start(kFALSE);
+      read(buf);
+      rtimer.Stop();
+   }
+   Double_t mbytes = 1e-6 * size * nloop;
+   TResult res;
+   res.fWrite = wtimer.RealTime() > 0 ? mbytes / wtimer.RealTime() : 0;
+   res.fRead = rtimer.RealTime() > 0 ? mbytes / rtimer.RealTime() : 0;
+   return res;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Benchmark one overload with the scalar and the best kernels, print the
+/// result and return whether the content is correct.
+/// If exact, the values read must be the values written; otherwise the
+/// values read with the two kernels must be the same.
+
+template <typename T>
+static Bool_t Bench(const char *name, const char *best, const std::vector<T> &values, Int_t nloop, Bool_t exact,
+                    const std::function<void(TBuffer&, const T*, Int_t)> &write,
+                    const std::function<void(TBuffer&, T*, Int_t)> &read)
+{
+   // Plain arrays, std::vector<Bool_t> does not store Bool_t elements.
+   Int_t n = values.size();
+   T *in = new T[n];
+   T *out = new T[n];
+   T *ref = new T[n];
+   for (Int_t i = 0; i < n; ++i) in[i] = values[i];
+   TBufferFile buf(TBuffer::kWrite, 16 * n + 1024);
+   TResult res[2];
+   TString bytes[2];
+   Bool_t ok = kTRUE;
+   const char *kernels[2] = { "scalar", best };
+   for (Int_t k = 0; k < 2; ++k) {
+      TBufferFile::SetByteSwapKernels(kernels[k]);
+      res[k] = Measure(buf, n * sizeof(T), nloop,
+                       [&](TBuffer &b) { write(b, in, n); },
+                       [&](TBuffer &b) { read(b, out, n); });
+      buf.SetWriteMode();
+      buf.SetBufferOffset(0);
+      write(buf, in, n);
+      bytes[k] = TString(buf.Buffer(), buf.Length());
+      if (k == 0) memcpy(ref, out, n * sizeof(T));
+      if (exact) ok = ok && !memcmp(out, in, n * sizeof(T));
+      else       ok = ok && !memcmp(out, ref, n * sizeof(T));
+   }
+   delete [] in;
+   delete [] out;
+   delete [] ref;
+   ok = ok && bytes[0] == bytes[1];
+   TBufferFile::SetByteSwapKernels();
+   printf("*  %-29s %7.0f %7.0f  %7.0f %7.0f   %-5s    *\n", name,
+          res[0].fWrite, res[0].fRead, res[1].fWrite, res[1].fRead, ok ? "ok" : "WRONG");
+   return ok;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return n random values uniformly distributed in [min,max).
+
+template <typename T>
+static std::vector<T> Values(Int_t n, Double_t min, Double_t max)
+{
+   TRandom3 rnd(4357);
+   std::vector<T> v(n);
+   for (Int_t i = 0; i < n; ++i) v[i] = (T)(min + (max - min) * rnd.Rndm());
+   return v;
+}
+
+#define BENCH_FAST_ARRAY(T, min, max)                                                      \
+   ok = Bench<T>(#T, best, Values<T>(n, min, max), nloop, kTRUE,                          \
+                 [](TBuffer &b, const T *v, Int_t m) { b.WriteFastArray(v, m); },         \
+                 [](TBuffer &b, T *v, Int_t m) { b.ReadFastArray(v, m); }) && ok
+
+int main(int argc, char **argv)
+{
+   Int_t n = 100000;
+   Int_t nloop = 200;
+   if (argc > 1) n = atoi(argv[1]);
+   if (argc > 2) nloop = atoi(argv[2]);
+   if (n < 1) n = 1;
+
+   TBufferFile::SetByteSwapKernels();
+   const char *best = TBufferFile::GetByteSwapKernels();
+
+   // A range of [-10,10] on 16 bits, and a mantissa truncated to 14 bits.
+   TStreamerElement range("range", "[-10,10,16]", 0, TVirtualStreamerInfo::kFloat16, "Float16_t");
+   TStreamerElement nbits("nbits", "[0,0,14]", 0, TVirtualStreamerInfo::kFloat16, "Float16_t");
+   TStreamerElement drange("range", "[-10,10,16]", 0, TVirtualStreamerInfo::kDouble32, "Double32_t");
+   TStreamerElement dnbits("nbits", "[0,0,14]", 0, TVirtualStreamerInfo::kDouble32, "Double32_t");
+
+   printf("\n");
+   printf("******************************************************************************\n");
+   printf("*  TBuffer fast array conversions: %8d values, %5d loops              *\n", n, nloop);
+   printf("******************************************************************************\n");
+   printf("*  Overload                        scalar MB/s      %-6s MB/s     Content  *\n", best);
+   printf("*                                 write    read    write    read             *\n");
+   printf("******************************************************************************\n");
+
+   Bool_t ok = kTRUE;
+   BENCH_FAST_ARRAY(Bool_t, 0, 2);
+   BENCH_FAST_ARRAY(Char_t, -128, 128);
+   BENCH_FAST_ARRAY(UChar_t, 0, 256);
+   BENCH_FAST_ARRAY(Short_t, -32768, 32768);
+   BENCH_FAST_ARRAY(UShort_t, 0, 65536);
+   BENCH_FAST_ARRAY(Int_t, -2e9, 2e9);
+   BENCH_FAST_ARRAY(UInt_t, 0, 4e9);
+   BENCH_FAST_ARRAY(Long_t, -2e9, 2e9);
+   BENCH_FAST_ARRAY(ULong_t, 0, 4e9);
+   BENCH_FAST_ARRAY(Long64_t, -1e18, 1e18);
+   BENCH_FAST_ARRAY(ULong64_t, 0, 1e19);
+   BENCH_FAST_ARRAY(Float_t, -20, 20);
+   BENCH_FAST_ARRAY(Double_t, -20, 20);
+
+   std::vector<Float_t> floats = Values<Float_t>(n, -12, 12);
+   std::vector<Double_t> doubles = Values<Double_t>(n, -12, 12);
+   ok = Bench<Float_t>("Float16_t [-10,10,16]", best, floats, nloop, kFALSE,
+                       [&](TBuffer &b, const Float_t *v, Int_t m) { b.WriteFastArrayFloat16(v, m, &range); },
+                       [&](TBuffer &b, Float_t *v, Int_t m) { b.ReadFastArrayFloat16(v, m, &range); }) && ok;
+   ok = Bench<Float_t>("Float16_t [0,0,14]", best, floats, nloop, kFALSE,
+                       [&](TBuffer &b, const Float_t *v, Int_t m) { b.WriteFastArrayFloat16(v, m, &nbits); },
+                       [&](TBuffer &b, Float_t *v, Int_t m) { b.ReadFastArrayFloat16(v, m, &nbits); }) && ok;
+   ok = Bench<Float_t>("Float16_t WithFactor", best, floats, nloop, kFALSE,
+                       [&](TBuffer &b, const Float_t *v, Int_t m) { b.WriteFastArrayFloat16(v, m, &range); },
+                       [&](TBuffer &b, Float_t *v, Int_t m) {
+                          b.ReadFastArrayWithFactor(v, m, range.GetFactor(), range.GetXmin());
+                       }) && ok;
+   ok = Bench<Float_t>("Float16_t WithNbits", best, floats, nloop, kFALSE,
+                       [&](TBuffer &b, const Float_t *v, Int_t m) { b.WriteFastArrayFloat16(v, m, &nbits); },
+                       [&](TBuffer &b, Float_t *v, Int_t m) { b.ReadFastArrayWithNbits(v, m, 14); }) && ok;
+   ok = Bench<Double_t>("Double32_t", best, doubles, nloop, kFALSE,
+                        [&](TBuffer &b, const Double_t *v, Int_t m) { b.WriteFastArrayDouble32(v, m, 0); },
+                        [&](TBuffer &b, Double_t *v, Int_t m) { b.ReadFastArrayDouble32(v, m, 0); }) && ok;
+   ok = Bench<Double_t>("Double32_t [-10,10,16]", best, doubles, nloop, kFALSE,
+                        [&](TBuffer &b, const Double_t *v, Int_t m) { b.WriteFastArrayDouble32(v, m, &drange); },
+                        [&](TBuffer &b, Double_t *v, Int_t m) { b.ReadFastArrayDouble32(v, m, &drange); }) && ok;
+   ok = Bench<Double_t>("Double32_t [0,0,14]", best, doubles, nloop, kFALSE,
+                        [&](TBuffer &b, const Double_t *v, Int_t m) { b.WriteFastArrayDouble32(v, m, &dnbits); },
+                        [&](TBuffer &b, Double_t *v, Int_t m) { b.ReadFastArrayDouble32(v, m, &dnbits); }) && ok;
+   ok = Bench<Double_t>("Double32_t WithFactor", best, doubles, nloop, kFALSE,
+                        [&](TBuffer &b, const Double_t *v, Int_t m) { b.WriteFastArrayDouble32(v, m, &drange); },
+                        [&](TBuffer &b, Double_t *v, Int_t m) {
+                           b.ReadFastArrayWithFactor(v, m, drange.GetFactor(), drange.GetXmin());
+                        }) && ok;
+   ok = Bench<Double_t>("Double32_t WithNbits", best, doubles, nloop, kFALSE,
+                        [&](TBuffer &b, const Double_t *v, Int_t m) { b.WriteFastArrayDouble32(v, m, &dnbits); },
+                        [&](TBuffer &b, Double_t *v, Int_t m) { b.ReadFastArrayWithNbits(v, m, 14); }) && ok;
+
+   printf("******************************************************************************\n");
+   printf("*  Content: %-5s                                                            *\n", ok ? "ok" : "WRONG");
+   printf("******************************************************************************\n");
+   return ok ? 0 : 1;
+}
@@ -0,0 +1,152 @@
+// @(#)root/test:$Id$
+
+// This program compares the read throughput of the compression
+// algorithms supported by ROOT on the Event tree of test/Event.
+// For each compression setting a file containing the same Event tree
+// (split mode) is written and then read back sequentially with the
+// TTreeCache enabled.
+// The settings compared are ZLIB with levels 1 to 9 (setting 101-109)
+// and LZ4 with levels 1 to 9 (setting 401-409, levels >= 4 use LZ4-HC).
+//
+//  run with
+//     benchCompression [nevent] [ntracks]
+//
+// The program prints a summary table with, for each setting, the file
+// size, the compression factor, the write CPU time and the read
+// throughput in MBytes of uncompressed data per real and CPU second.
+
+#include "TROOT.h"
+#include "TStopwatch.h"
+#include "TFile.h"
+#include "TTree.h"
+#include "TSystem.h"
+#include "TRandom.h"
+#include "Compression.h"
+#include "RConfigure.h"
+
+#include "Event.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+struct TCompressionBenchData {
+   Int_t    fSettings;  // Compression settings (100*algorithm + level)
+   Long64_t fFileSize;  // Size of the file on disk
+   Long64_t fTotBytes;  // Uncompressed size of the tree
+   Double_t fCpuWrite;  // CPU time to fill and write the tree
+   Double_t fRtRead;    // Real time to read the tree back
+   Double_t fCpuRead;   // CPU time to read the tree back
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write nevent events with ntracks tracks in file fname with compression
+/// settings `settings`.
+
+static Double_t WriteEvents(const char *fname, Int_t settings, Int_t nevent, Int_t ntracks)
+{
+   TStopwatch timer;
+   timer.Start();
+
+   gRandom->SetSeed(65539);
+   TFile *hfile = new TFile(fname, "RECREATE", "Compression benchmark ROOT file", settings);
+   TTree *tree = new TTree("T", "Event tree for the compression benchmark");
+   tree->SetAutoSave(1000000000);
+   Event *event = new Event();
+   TBranch *branch = tree->Branch("event", &event, 16000, 99);
+   branch->SetAutoDelete(kFALSE);
+   for (Int_t ev = 0; ev < nevent; ++ev) {
+      event->Build(ev, ntracks, 1);
+      tree->Fill();
+   }
+   hfile->Write();
+   delete hfile;
+   delete event;
+
+   timer.Stop();
+   return timer.CpuTime();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read back all entries of the Event tree in fname and fill the read
+/// timings and tree sizes of data.
+
+static void ReadEvents(const char *fname, TCompressionBenchData &data)
+{
+   TFile *hfile = TFile::Open(fname);
+   if (!hfile || hfile->IsZombie()) {
+      delete hfile;
+      return;
+   }
+   data.fFileSize = hfile->GetSize();
+   TTree *tree = (TTree*)hfile->Get("T");
+   data.fTotBytes = tree->GetTotBytes();
+   Event *event = 0;
+   tree->SetBranchAddress("event", &event);
+   tree->SetCacheSize(-1);
+   tree->SetCacheLearnEntries(1);
+
+   TStopwatch timer;
+   timer.Start();
+   Long64_t nentries = tree->GetEntries();
+   for (Long64_t ev = 0; ev < nentries; ++ev) {
+      tree->GetEntry(ev);
+   }
+   timer.Stop();
+   data.fRtRead = timer.RealTime();
+   data.fCpuRead = timer.CpuTime();
+
+   delete hfile;
+   delete event;
+}
+
+int main(int argc, char **argv)
+{
+   Int_t nevent  = 400;
+   Int_t ntracks = 600;
+   if (argc > 1) nevent  = atoi(argv[1]);
+   if (argc > 2) ntracks = atoi(argv[2]);
+
+   std::vector<Int_t> settings;
+   for (Int_t level = 1; level <= 9; ++level)
+      settings.push_back(ROOT::CompressionSettings(ROOT::kZLIB, level));
+#ifdef R__HAS_LZ4
+   for (Int_t level = 1; level <= 9; ++level)
+      settings.push_back(ROOT::CompressionSettings(ROOT::kLZ4, level));
+#else
+   printf("ROOT was built without LZ4 support, only ZLIB is benchmarked\n");
+#endif
+
+   const char *fname = "benchCompression.root";
+   std::vector<TCompressionBenchData> results;
+   for (size_t i = 0; i < settings.size(); ++i) {
+      TCompressionBenchData data;
+      memset(&data, 0, sizeof(data));
+      data.fSettings = settings[i];
+      data.fCpuWrite = WriteEvents(fname, settings[i], nevent, ntracks);
+      ReadEvents(fname, data);
+      results.push_back(data);
+      gSystem->Unlink(fname);
+   }
+
+   printf("\n");
+   printf("******************************************************************************************\n");
+   printf("*  Read throughput of the Event tree: %5d events, %4d tracks per event                  *\n", nevent, ntracks);
+   printf("******************************************************************************************\n");
+   printf("*  Algo  Level   File size     cx   Cpu write   RT read  Cpu read  MB/RT sec  MB/Cpu sec   *\n");
+   printf("******************************************************************************************\n");
+   for (size_t i = 0; i < results.size(); ++i) {
+      const TCompressionBenchData &d = results[i];
+      Int_t algo  = d.fSettings / 100;
+      Int_t level = d.fSettings % 100;
+      const char *name = (algo == ROOT::kLZ4) ? "LZ4 " : "ZLIB";
+      Double_t mbytes = 1e-6 * d.fTotBytes;
+      Double_t cx = d.fFileSize ? Double_t(d.fTotBytes) / d.fFileSize : 0;
+      printf("*  %s  %5d  %10lld  %5.2f  %8.2f s  %6.2f s  %6.2f s  %9.1f  %10.1f   *\n",
+             name, level, d.fFileSize, cx, d.fCpuWrite, d.fRtRead, d.fCpuRead,
+             d.fRtRead > 0 ? mbytes / d.fRtRead : 0, d.fCpuRead > 0 ? mbytes / d.fCpuRead : 0);
+   }
+   printf("******************************************************************************************\n");
+
+   return 0;
+}
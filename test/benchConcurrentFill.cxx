@@ -0,0 +1,179 @@
+// @(#)root/test:$Id$
+
+// This program measures the filling of a single histogram (TH1D, TH2D and
+// TProfile) by 1 to nthreads threads through a TH1ConcurrentFillManager,
+// each thread filling its share of the values through its own
+// TH1ConcurrentFiller. The reference is the serial filling of the same
+// values with Fill. The fraction of the batches that had to wait for the
+// lock of the manager measures the contention. The entries and contents
+// of the histograms filled concurrently are checked against the reference,
+// the sums of weights up to the rounding errors due to the order of the
+// additions.
+//
+//  run with
+//     benchConcurrentFill [nthreads] [nvalues]
+//
+// The default is 64 threads at most and 10000000 values.
+
+#include "TROOT.h"
+#include "TH1.h"
+#include "TH2.h"
+#include "TProfile.h"
+#include "TH1ConcurrentFill.h"
+#include "TRandom3.h"
+#include "TStopwatch.h"
+#include "TMath.h"
+
+#include <stdlib.h>
+#include <functional>
+#include <thread>
+#include <vector>
+
+struct TValues {
+   std::vector<Double_t> fX;   // Values along x
+   std::vector<Double_t> fY;   // Values along y
+   std::vector<Double_t> fW;   // Weights
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return n gaussian values and weights in [0.5,1.5).
+
+static TValues MakeValues(Int_t n)
+{
+   TRandom3 rnd(4357);
+   TValues v;
+   v.fX.resize(n);
+   v.fY.resize(n);
+   v.fW.resize(n);
+   for (Int_t i = 0; i < n; ++i) {
+      rnd.Rannor(v.fX[i], v.fY[i]);
+      v.fW[i] = 0.5 + rnd.Rndm();
+   }
+   return v;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if a and b are equal up to the rounding errors.
+
+static Bool_t Close(Double_t a, Double_t b)
+{
+   return TMath::Abs(a - b) <= 1e-9 * TMath::Max(1., TMath::Max(TMath::Abs(a), TMath::Abs(b)));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if the two histograms have the same entries, contents,
+/// errors and statistics.
+
+static Bool_t Same(const TH1 *a, const TH1 *b)
+{
+   if (a->GetEntries() != b->GetEntries()) return kFALSE;
+   for (Int_t bin = 0; bin < a->GetNcells(); ++bin) {
+      if (!Close(a->GetBinContent(bin), b->GetBinContent(bin))) return kFALSE;
+      if (!Close(a->GetBinError(bin), b->GetBinError(bin))) return kFALSE;
+   }
+   Double_t sa[13] = { 0 }, sb[13] = { 0 };
+   a->GetStats(sa);
+   b->GetStats(sb);
+   for (Int_t i = 0; i < 13; ++i) {
+      if (!Close(sa[i], sb[i])) return kFALSE;
+   }
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill the values [first,last) in h with Fill, or through filler if not 0.
+
+static void FillValues(TH1 *h, TH1ConcurrentFiller *filler, const TValues &v, Int_t first, Int_t last)
+{
+   Int_t dim = h->GetDimension();
+   Bool_t profile = h->InheritsFrom(TProfile::Class());
+   for (Int_t i = first; i < last; ++i) {
+      if (dim == 2) {
+         if (filler) filler->Fill(v.fX[i], v.fY[i], v.fW[i]);
+         else        ((TH2*)h)->Fill(v.fX[i], v.fY[i], v.fW[i]);
+      } else if (profile) {
+         if (filler) filler->Fill(v.fX[i], v.fY[i], v.fW[i]);
+         else        ((TProfile*)h)->Fill(v.fX[i], v.fY[i], v.fW[i]);
+      } else {
+         if (filler) filler->Fill(v.fX[i], v.fW[i]);
+         else        h->Fill(v.fX[i], v.fW[i]);
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill h with the values shared among nthreads threads, print the result
+/// and return whether h is the same as ref.
+
+static Bool_t Bench(const char *name, TH1 *h, const TH1 *ref, Double_t rtref, const TValues &v, Int_t nthreads)
+{
+   TH1ConcurrentFillManager manager(*h);
+   Int_t n = v.fX.size();
+   TStopwatch timer;
+   timer.Start();
+   std::vector<std::thread> threads;
+   for (Int_t t = 0; t < nthreads; ++t) {
+      Int_t first = (Long64_t)n * t / nthreads;
+      Int_t last = (Long64_t)n * (t + 1) / nthreads;
+      threads.push_back(std::thread([&manager, h, &v, first, last]() {
+         TH1ConcurrentFiller filler(manager);
+         FillValues(h, &filler, v, first, last);
+      }));
+   }
+   for (Int_t t = 0; t < nthreads; ++t) threads[t].join();
+   timer.Stop();
+   Double_t rt = timer.RealTime();
+   Bool_t ok = Same(ref, h);
+   Double_t contended = manager.GetNFlushes() ? 100. * manager.GetNContended() / manager.GetNFlushes() : 0.;
+   printf("*  %-10s %7d %10.3f s %9.2f %12.1f %%     %-5s        *\n", name, nthreads, rt,
+          rt > 0 ? rtref / rt : 0., contended, ok ? "ok" : "WRONG");
+   return ok;
+}
+
+int main(int argc, char **argv)
+{
+   Int_t nthreads = 64;
+   Int_t n = 10000000;
+   if (argc > 1) nthreads = atoi(argv[1]);
+   if (argc > 2) n = atoi(argv[2]);
+   if (nthreads < 1) nthreads = 1;
+
+   TH1::AddDirectory(kFALSE);
+   TValues v = MakeValues(n);
+
+   printf("\n");
+   printf("******************************************************************************\n");
+   printf("*  Concurrent filling: %9d values, %3d threads at most, %3u hardware   *\n", n, nthreads,
+          std::thread::hardware_concurrency());
+   printf("******************************************************************************\n");
+   printf("*  Histogram  Threads         RT   Speedup    Contended    Content           *\n");
+   printf("******************************************************************************\n");
+   std::function<TH1*()> makers[3] = {
+      []() -> TH1* { return new TH1D("h1", "", 1000, -4, 4); },
+      []() -> TH1* { return new TH2D("h2", "", 100, -4, 4, 100, -4, 4); },
+      []() -> TH1* { return new TProfile("hp", "", 1000, -4, 4); }
+   };
+   const char *names[3] = { "TH1D", "TH2D", "TProfile" };
+   Bool_t ok = kTRUE;
+   for (Int_t k = 0; k < 3; ++k) {
+      TH1 *ref = makers[k]();
+      TStopwatch timer;
+      timer.Start();
+      FillValues(ref, 0, v, 0, n);
+      timer.Stop();
+      Double_t rtref = timer.RealTime();
+      printf("*  %-10s  serial %10.3f s                                           *\n", names[k], rtref);
+      // 1, 2, 4, ... threads, up to nthreads.
+      for (Int_t t = 1; ; t = TMath::Min(2 * t, nthreads)) {
+         TH1 *h = makers[k]();
+         ok = Bench(names[k], h, ref, rtref, v, t) && ok;
+         delete h;
+         if (t == nthreads) break;
+      }
+      delete ref;
+   }
+   printf("******************************************************************************\n");
+   printf("*  Content: %-5s                                                            *\n", ok ? "ok" : "WRONG");
+   printf("******************************************************************************\n");
+   return ok ? 0 : 1;
+}
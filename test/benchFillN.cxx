@@ -0,0 +1,173 @@
+// @(#)root/test:$Id$
+
+// This program compares the filling of 1-D, 2-D and 3-D histograms, with
+// fix and with variable bins, one entry at a time with Fill and with the
+// bulk FillN (see TH1::FillN, TH2::FillN and TH3::FillN), which finds the
+// bins of a chunk of values at once (see TAxis::FindFixBins). About one
+// value out of eleven is in the underflow or overflow bins. The contents,
+// the errors and the statistics of the histograms filled both ways are
+// checked to be the same.
+//
+//  run with
+//     benchFillN [nvalues] [nloop]
+//
+// The default is 1000000 values and 20 loops.
+
+#include "TROOT.h"
+#include "TH1.h"
+#include "TH2.h"
+#include "TH3.h"
+#include "TRandom3.h"
+#include "TStopwatch.h"
+
+#include <stdlib.h>
+#include <vector>
+
+struct TValues {
+   std::vector<Double_t> fX;   // Values along x
+   std::vector<Double_t> fY;   // Values along y
+   std::vector<Double_t> fZ;   // Values along z
+   std::vector<Double_t> fW;   // Weights
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return n random values in [-0.05,1.05) and weights in [0.5,1.5).
+
+static TValues MakeValues(Int_t n)
+{
+   TRandom3 rnd(4357);
+   TValues v;
+   v.fX.resize(n);
+   v.fY.resize(n);
+   v.fZ.resize(n);
+   v.fW.resize(n);
+   for (Int_t i = 0; i < n; ++i) {
+      v.fX[i] = -0.05 + 1.1 * rnd.Rndm();
+      v.fY[i] = -0.05 + 1.1 * rnd.Rndm();
+      v.fZ[i] = -0.05 + 1.1 * rnd.Rndm();
+      v.fW[i] = 0.5 + rnd.Rndm();
+   }
+   return v;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the nbins+1 edges of variable bins in [0,1], narrower near 0.
+
+static std::vector<Double_t> MakeEdges(Int_t nbins)
+{
+   std::vector<Double_t> edges(nbins + 1);
+   for (Int_t i = 0; i <= nbins; ++i) edges[i] = (Double_t)(i * i) / (nbins * nbins);
+   return edges;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if the two histograms have the same contents, errors and
+/// statistics.
+
+static Bool_t Same(const TH1 *a, const TH1 *b)
+{
+   if (a->GetEntries() != b->GetEntries()) return kFALSE;
+   Int_t ncells = a->GetNcells();
+   for (Int_t bin = 0; bin < ncells; ++bin) {
+      if (a->GetBinContent(bin) != b->GetBinContent(bin)) return kFALSE;
+      if (a->GetBinError(bin) != b->GetBinError(bin)) return kFALSE;
+   }
+   Double_t sa[13] = { 0 }, sb[13] = { 0 };
+   a->GetStats(sa);
+   b->GetStats(sb);
+   for (Int_t i = 0; i < 13; ++i) {
+      if (sa[i] != sb[i]) return kFALSE;
+   }
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill nloop times hfill with Fill and hfilln with FillN, with the weights
+/// if weighted, print the result and return whether the histograms are the
+/// same.
+
+static Bool_t Bench(const char *name, TH1 *hfill, TH1 *hfilln, const TValues &v, Int_t nloop, Bool_t weighted)
+{
+   Int_t n = v.fX.size();
+   const Double_t *x = &v.fX[0];
+   const Double_t *y = &v.fY[0];
+   const Double_t *z = &v.fZ[0];
+   const Double_t *w = weighted ? &v.fW[0] : 0;
+   Int_t dim = hfill->GetDimension();
+   TStopwatch timer;
+   timer.Start();
+   for (Int_t l = 0; l < nloop; ++l) {
+      if (dim == 1) {
+         TH1 *h = hfill;
+         if (w) for (Int_t i = 0; i < n; ++i) h->Fill(x[i], w[i]);
+         else   for (Int_t i = 0; i < n; ++i) h->Fill(x[i]);
+      } else if (dim == 2) {
+         TH2 *h = (TH2*)hfill;
+         if (w) for (Int_t i = 0; i < n; ++i) h->Fill(x[i], y[i], w[i]);
+         else   for (Int_t i = 0; i < n; ++i) h->Fill(x[i], y[i]);
+      } else {
+         TH3 *h = (TH3*)hfill;
+         if (w) for (Int_t i = 0; i < n; ++i) h->Fill(x[i], y[i], z[i], w[i]);
+         else   for (Int_t i = 0; i < n; ++i) h->Fill(x[i], y[i], z[i]);
+      }
+   }
+   timer.Stop();
+   Double_t rtfill = timer.RealTime();
+   timer.Start();
+   for (Int_t l = 0; l < nloop; ++l) {
+      if (dim == 1)      hfilln->FillN(n, x, w);
+      else if (dim == 2) ((TH2*)hfilln)->FillN(n, x, y, w);
+      else               ((TH3*)hfilln)->FillN(n, x, y, z, w);
+   }
+   timer.Stop();
+   Double_t rtfilln = timer.RealTime();
+   Bool_t ok = Same(hfill, hfilln);
+   printf("*  %-28s %8.3f s  %8.3f s  %8.2f   %-5s     *\n", name, rtfill, rtfilln,
+          rtfilln > 0 ? rtfill / rtfilln : 0., ok ? "ok" : "WRONG");
+   delete hfill;
+   delete hfilln;
+   return ok;
+}
+
+int main(int argc, char **argv)
+{
+   Int_t n = 1000000;
+   Int_t nloop = 20;
+   if (argc > 1) n = atoi(argv[1]);
+   if (argc > 2) nloop = atoi(argv[2]);
+   if (n < 1) n = 1;
+
+   TH1::AddDirectory(kFALSE);
+   TValues v = MakeValues(n);
+   std::vector<Double_t> e100 = MakeEdges(100);
+   std::vector<Double_t> e20 = MakeEdges(20);
+
+   printf("\n");
+   printf("******************************************************************************\n");
+   printf("*  Histogram filling: %9d values, %4d loops                           *\n", n, nloop);
+   printf("******************************************************************************\n");
+   printf("*  Histogram                     RT Fill    RT FillN   Speedup  Content      *\n");
+   printf("******************************************************************************\n");
+   Bool_t ok = kTRUE;
+   for (Int_t weighted = 0; weighted < 2; ++weighted) {
+      const char *suffix = weighted ? ", weights" : "";
+      ok = Bench(Form("TH1D fix%s", suffix), new TH1D("a", "", 100, 0, 1), new TH1D("b", "", 100, 0, 1),
+                 v, nloop, weighted) && ok;
+      ok = Bench(Form("TH1F fix%s", suffix), new TH1F("a", "", 100, 0, 1), new TH1F("b", "", 100, 0, 1),
+                 v, nloop, weighted) && ok;
+      ok = Bench(Form("TH1D variable%s", suffix), new TH1D("a", "", 100, &e100[0]), new TH1D("b", "", 100, &e100[0]),
+                 v, nloop, weighted) && ok;
+      ok = Bench(Form("TH2D fix%s", suffix), new TH2D("a", "", 100, 0, 1, 100, 0, 1),
+                 new TH2D("b", "", 100, 0, 1, 100, 0, 1), v, nloop, weighted) && ok;
+      ok = Bench(Form("TH2D variable%s", suffix), new TH2D("a", "", 100, &e100[0], 100, &e100[0]),
+                 new TH2D("b", "", 100, &e100[0], 100, &e100[0]), v, nloop, weighted) && ok;
+      ok = Bench(Form("TH3D fix%s", suffix), new TH3D("a", "", 20, 0, 1, 20, 0, 1, 20, 0, 1),
+                 new TH3D("b", "", 20, 0, 1, 20, 0, 1, 20, 0, 1), v, nloop, weighted) && ok;
+      ok = Bench(Form("TH3D variable%s", suffix), new TH3D("a", "", 20, &e20[0], 20, &e20[0], 20, &e20[0]),
+                 new TH3D("b", "", 20, &e20[0], 20, &e20[0], 20, &e20[0]), v, nloop, weighted) && ok;
+   }
+   printf("******************************************************************************\n");
+   printf("*  Content: %-5s                                                            *\n", ok ? "ok" : "WRONG");
+   printf("******************************************************************************\n");
+   return ok ? 0 : 1;
+}
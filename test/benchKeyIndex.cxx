@@ -0,0 +1,142 @@
+// @(#)root/test:$Id$
+
+// This program measures the opening of a file with many keys in one
+// directory, and the lookups of objects by name, with one TKey created for
+// each key when the file is opened and with the key index (see
+// TDirectoryFile::SetKeyIndexThreshold), which creates only the TKeys of
+// the objects read. For each mode it reports the time to open the file,
+// the growth of the resident memory of the process when opening it, and
+// the time of nget Get calls by name. The objects found and the list of
+// keys (in the order of the file) are checked to be the same in both modes.
+//
+//  run with
+//     benchKeyIndex [nkeys] [nget]
+//
+// The default is 300000 keys and 10000 lookups.
+
+#include "TROOT.h"
+#include "TFile.h"
+#include "TDirectoryFile.h"
+#include "TKey.h"
+#include "TNamed.h"
+#include "TList.h"
+#include "TRandom3.h"
+#include "TStopwatch.h"
+#include "TSystem.h"
+
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+const char *kFileName = "benchKeyIndex.root";
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write nkeys TNamed objects in the file, the first one with two cycles.
+
+static void WriteFile(Int_t nkeys)
+{
+   TFile f(kFileName, "RECREATE");
+   TNamed first("obj_0", "cycle 1");
+   first.Write();
+   for (Int_t i = 0; i < nkeys; ++i) {
+      TNamed obj(Form("obj_%d", i), Form("title %d", i));
+      obj.Write();
+   }
+   f.Close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the resident memory of the process in MB.
+
+static Double_t ResidentMB()
+{
+   ProcInfo_t info;
+   gSystem->GetProcInfo(&info);
+   return info.fMemResident / 1024.;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Open the file with the key index threshold, get the objects names, then
+/// read the list of keys. Return whether the titles of the objects read and
+/// the list of keys are the ones expected; keys is filled with the key
+/// names if empty, compared with them otherwise.
+
+static Bool_t Bench(const char *mode, Int_t threshold, const std::vector<Int_t> &names,
+                    std::vector<std::string> &keys)
+{
+   TDirectoryFile::SetKeyIndexThreshold(threshold);
+   Double_t rss = ResidentMB();
+   TStopwatch timer;
+   timer.Start();
+   TFile *f = TFile::Open(kFileName);
+   timer.Stop();
+   Double_t rtopen = timer.RealTime();
+   rss = ResidentMB() - rss;
+   if (!f || f->IsZombie()) {
+      printf("*  %-12s cannot open %-48s *\n", mode, kFileName);
+      return kFALSE;
+   }
+
+   Bool_t ok = kTRUE;
+   timer.Start();
+   for (size_t i = 0; i < names.size(); ++i) {
+      TNamed *obj = (TNamed*) f->Get(Form("obj_%d", names[i]));
+      if (!obj || strcmp(obj->GetTitle(), Form("title %d", names[i]))) ok = kFALSE;
+      delete obj;
+   }
+   timer.Stop();
+   Double_t rtget = timer.RealTime();
+
+   // The first cycle and a missing key.
+   TNamed *first = (TNamed*) f->Get("obj_0;1");
+   if (!first || strcmp(first->GetTitle(), "cycle 1")) ok = kFALSE;
+   delete first;
+   if (f->Get("missing")) ok = kFALSE;
+
+   TIter next(f->GetListOfKeys());
+   TKey *key;
+   size_t nlist = 0;
+   Bool_t fill = keys.empty();
+   while ((key = (TKey*) next())) {
+      std::string namecycle = Form("%s;%d", key->GetName(), key->GetCycle());
+      if (fill) keys.push_back(namecycle);
+      else if (nlist >= keys.size() || keys[nlist] != namecycle) ok = kFALSE;
+      ++nlist;
+   }
+   if (nlist != keys.size() || f->GetNkeys() != (Int_t)nlist) ok = kFALSE;
+   delete f;
+
+   printf("*  %-12s %10.3f s %10.1f MB %10.3f s       %-5s          *\n", mode, rtopen, rss, rtget,
+          ok ? "ok" : "WRONG");
+   return ok;
+}
+
+int main(int argc, char **argv)
+{
+   Int_t nkeys = 300000;
+   Int_t nget = 10000;
+   if (argc > 1) nkeys = atoi(argv[1]);
+   if (argc > 2) nget = atoi(argv[2]);
+   if (nkeys < 1) nkeys = 1;
+
+   WriteFile(nkeys);
+   std::vector<Int_t> names(nget);
+   TRandom3 rnd(4357);
+   for (Int_t i = 0; i < nget; ++i) names[i] = (Int_t)(rnd.Rndm() * nkeys);
+
+   printf("\n");
+   printf("******************************************************************************\n");
+   printf("*  Key index: %9d keys, %8d lookups                               *\n", nkeys, nget);
+   printf("******************************************************************************\n");
+   printf("*  Keys            RT open      RSS open       RT Get       Content          *\n");
+   printf("******************************************************************************\n");
+   std::vector<std::string> keys;
+   // The index first: the memory freed when the file is closed is reused.
+   Bool_t ok = Bench("key index", 1, names, keys);
+   ok = Bench("TKeys", 0, names, keys) && ok;
+   printf("******************************************************************************\n");
+   printf("*  Content: %-5s                                                            *\n", ok ? "ok" : "WRONG");
+   printf("******************************************************************************\n");
+   gSystem->Unlink(kFileName);
+   return ok ? 0 : 1;
+}
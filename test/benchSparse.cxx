@@ -0,0 +1,244 @@
+// @(#)root/test:$Id$
+
+// This program measures the filling, the bin lookups and the merging of a
+// 10-dimensional THnSparseD:
+//  - the filling one entry at a time with Fill is compared with the batched
+//    THnSparse::FillN, which prefetches the hash table slots of 16 entries
+//    before filling them; the bins, contents and errors must be the same.
+//  - the lookups of filled bins (hits) and of random bins, mostly empty
+//    (misses), with GetBin(coord, kFALSE) are compared with the lookups in a
+//    TExMap indexed by the linear bin coordinate, the hash map that THnSparse
+//    used before its open addressing bin index. Both must find the same bins.
+//  - the merging of nhist histograms with Merge is done sequentially and
+//    with THnSparse::SetMergeThreads(4); the contents must be the same.
+//
+//  run with
+//     benchSparse [nentries] [nhist]
+//
+// The default is 1000000 entries and 8 histograms to merge.
+
+#include "TROOT.h"
+#include "THnSparse.h"
+#include "TExMap.h"
+#include "TList.h"
+#include "TRandom3.h"
+#include "TStopwatch.h"
+#include "TMath.h"
+
+#include <stdlib.h>
+#include <vector>
+
+const Int_t kNdim = 10;
+const Int_t kNbins = 20;
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return a new empty histogram.
+
+static THnSparseD *MakeHist(const char *name)
+{
+   Int_t bins[kNdim];
+   Double_t xmin[kNdim];
+   Double_t xmax[kNdim];
+   for (Int_t d = 0; d < kNdim; ++d) {
+      bins[d] = kNbins;
+      xmin[d] = -4.;
+      xmax[d] = 4.;
+   }
+   THnSparseD *h = new THnSparseD(name, "", kNdim, bins, xmin, xmax);
+   h->Sumw2();
+   return h;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return n entries of kNdim gaussian values, seed picking the sample.
+
+static std::vector<Double_t> MakeValues(Int_t n, UInt_t seed)
+{
+   TRandom3 rnd(seed);
+   std::vector<Double_t> x((Long64_t)n * kNdim);
+   for (size_t i = 0; i < x.size(); ++i) x[i] = rnd.Gaus(0., 1.);
+   return x;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the linear index of the bin coordinates coord.
+
+static Long64_t Linearize(const Int_t *coord)
+{
+   Long64_t lin = 0;
+   for (Int_t d = 0; d < kNdim; ++d) lin = lin * (kNbins + 2) + coord[d];
+   return lin;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if the two histograms have the same bins, contents and errors.
+
+static Bool_t Same(const THnSparse *a, const THnSparse *b)
+{
+   if (a->GetNbins() != b->GetNbins()) return kFALSE;
+   if (a->GetEntries() != b->GetEntries()) return kFALSE;
+   Int_t coord[kNdim];
+   for (Long64_t i = 0; i < a->GetNbins(); ++i) {
+      Double_t content = a->GetBinContent(i, coord);
+      Long64_t j = b->GetBin(coord);
+      if (j < 0) return kFALSE;
+      Double_t tolerance = 1e-9 * TMath::Max(1., TMath::Abs(content));
+      if (TMath::Abs(content - b->GetBinContent(j)) > tolerance) return kFALSE;
+      if (TMath::Abs(a->GetBinError2(i) - b->GetBinError2(j)) > tolerance) return kFALSE;
+   }
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Print a line of results.
+
+static void Print(const char *name, Double_t rtref, Double_t rt, Bool_t ok)
+{
+   printf("*  %-24s %10.3f s %10.3f s %9.2f  %-5s       *\n", name, rtref, rt,
+          rt > 0 ? rtref / rt : 0., ok ? "ok" : "WRONG");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill a histogram with Fill and one with FillN, return whether they are
+/// the same and the histogram in hfilled.
+
+static Bool_t BenchFill(const std::vector<Double_t> &x, THnSparseD *&hfilled)
+{
+   Int_t n = x.size() / kNdim;
+   THnSparseD *hfill = MakeHist("hfill");
+   THnSparseD *hfilln = MakeHist("hfilln");
+   TStopwatch timer;
+   timer.Start();
+   for (Int_t i = 0; i < n; ++i) hfill->Fill(&x[(Long64_t)i * kNdim]);
+   timer.Stop();
+   Double_t rtfill = timer.RealTime();
+   timer.Start();
+   hfilln->FillN(n, &x[0]);
+   timer.Stop();
+   Double_t rtfilln = timer.RealTime();
+   Bool_t ok = hfill->GetNbins() == hfilln->GetNbins();
+   for (Long64_t i = 0; ok && i < hfill->GetNbins(); ++i) {
+      Int_t c1[kNdim], c2[kNdim];
+      ok = hfill->GetBinContent(i, c1) == hfilln->GetBinContent(i, c2) &&
+           hfill->GetBinError2(i) == hfilln->GetBinError2(i);
+      for (Int_t d = 0; ok && d < kNdim; ++d) ok = c1[d] == c2[d];
+   }
+   Print("Fill / FillN", rtfill, rtfilln, ok);
+   delete hfill;
+   hfilled = hfilln;
+   return ok;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Look up the bins coords (nlook x kNdim) in h with GetBin and in a TExMap;
+/// return whether both find the same bins.
+
+static Bool_t BenchLookup(const char *name, THnSparseD *h, TExMap &map, const std::vector<Int_t> &coords,
+                          Int_t nloop)
+{
+   Int_t nlook = coords.size() / kNdim;
+   std::vector<Long64_t> found(nlook);
+   std::vector<Long64_t> foundref(nlook);
+   TStopwatch timer;
+   timer.Start();
+   for (Int_t l = 0; l < nloop; ++l) {
+      for (Int_t i = 0; i < nlook; ++i) {
+         foundref[i] = (Long64_t)map.GetValue(Linearize(&coords[(Long64_t)i * kNdim])) - 1;
+      }
+   }
+   timer.Stop();
+   Double_t rtref = timer.RealTime();
+   timer.Start();
+   for (Int_t l = 0; l < nloop; ++l) {
+      for (Int_t i = 0; i < nlook; ++i) found[i] = h->GetBin(&coords[(Long64_t)i * kNdim], kFALSE);
+   }
+   timer.Stop();
+   Double_t rt = timer.RealTime();
+   Print(name, rtref, rt, found == foundref);
+   return found == foundref;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Merge nhist histograms sequentially and in 4 threads, return whether the
+/// results are the same.
+
+static Bool_t BenchMerge(Int_t n, Int_t nhist)
+{
+   TList list;
+   list.SetOwner();
+   for (Int_t k = 0; k < nhist; ++k) {
+      THnSparseD *h = MakeHist(Form("h%d", k));
+      std::vector<Double_t> x = MakeValues(n / nhist + 1, 4357 + k);
+      h->FillN(n / nhist + 1, &x[0]);
+      list.Add(h);
+   }
+   THnSparseD *hserial = MakeHist("hserial");
+   THnSparseD *hthreads = MakeHist("hthreads");
+   TStopwatch timer;
+   THnSparse::SetMergeThreads(1);
+   timer.Start();
+   hserial->Merge(&list);
+   timer.Stop();
+   Double_t rtserial = timer.RealTime();
+   THnSparse::SetMergeThreads(4);
+   timer.Start();
+   hthreads->Merge(&list);
+   timer.Stop();
+   Double_t rtthreads = timer.RealTime();
+   THnSparse::SetMergeThreads(1);
+   Bool_t ok = Same(hserial, hthreads);
+   Print("Merge / Merge 4 threads", rtserial, rtthreads, ok);
+   delete hserial;
+   delete hthreads;
+   return ok;
+}
+
+int main(int argc, char **argv)
+{
+   Int_t n = 1000000;
+   Int_t nhist = 8;
+   if (argc > 1) n = atoi(argv[1]);
+   if (argc > 2) nhist = atoi(argv[2]);
+   if (n < 1) n = 1;
+   if (nhist < 1) nhist = 1;
+
+   std::vector<Double_t> x = MakeValues(n, 4357);
+
+   printf("\n");
+   printf("******************************************************************************\n");
+   printf("*  THnSparseD, %2d dimensions: %9d entries, %3d histograms to merge     *\n", kNdim, n, nhist);
+   printf("******************************************************************************\n");
+   printf("*  Operation                   RT before   RT after   Speedup   Content      *\n");
+   printf("******************************************************************************\n");
+   THnSparseD *h = 0;
+   Bool_t ok = BenchFill(x, h);
+
+   // The reference index: linear bin coordinate -> bin index + 1.
+   TExMap map;
+   Int_t coord[kNdim];
+   for (Long64_t i = 0; i < h->GetNbins(); ++i) {
+      h->GetBinContent(i, coord);
+      map.Add(Linearize(coord), i + 1);
+   }
+   // The filled bins, in random order, and random bins.
+   Int_t nlook = TMath::Min((Long64_t)n, h->GetNbins());
+   std::vector<Int_t> hits((Long64_t)nlook * kNdim);
+   std::vector<Int_t> misses((Long64_t)nlook * kNdim);
+   TRandom3 rnd(65539);
+   for (Int_t i = 0; i < nlook; ++i) {
+      h->GetBinContent((Long64_t)(rnd.Rndm() * h->GetNbins()), &hits[(Long64_t)i * kNdim]);
+      for (Int_t d = 0; d < kNdim; ++d) misses[(Long64_t)i * kNdim + d] = 1 + (Int_t)(rnd.Rndm() * kNbins);
+   }
+   Int_t nloop = TMath::Max(1, 1000000 / nlook);
+   ok = BenchLookup("Lookup hits (TExMap)", h, map, hits, nloop) && ok;
+   ok = BenchLookup("Lookup misses (TExMap)", h, map, misses, nloop) && ok;
+   ok = BenchMerge(n, nhist) && ok;
+
+   printf("******************************************************************************\n");
+   printf("*  Filled bins: %10lld, memory fraction of a dense histogram: %9.3g  *\n", h->GetNbins(),
+          h->GetSparseFractionMem());
+   printf("*  Content: %-5s                                                            *\n", ok ? "ok" : "WRONG");
+   printf("******************************************************************************\n");
+   delete h;
+   return ok ? 0 : 1;
+}
@@ -0,0 +1,180 @@
+// @(#)root/test:$Id$
+
+// This program measures the writing and the reading of the Event tree of
+// test/Event, split and unsplit, with the three optimizations of the
+// action sequences used to stream the objects (see
+// TClass::SetStreamerActionsMode), selected for the classes Event,
+// EventHeader and Track:
+//  - standard: one action per data member,
+//  - bulk:     one action per run of data members of basic type,
+//  - compiled: one function compiled by the interpreter per class.
+// For each mode the tree is written and read back, and the tree written in
+// the standard mode is read as well; the content of the events read must
+// be the same in all the cases.
+//
+//  run with
+//     benchStreamerActions [nevent] [ntracks]
+//
+// The default is 400 events with 600 tracks.
+
+#include "TROOT.h"
+#include "TStopwatch.h"
+#include "TFile.h"
+#include "TTree.h"
+#include "TClass.h"
+#include "TClonesArray.h"
+#include "TSystem.h"
+#include "TRandom.h"
+#include "TStreamerInfo.h"
+#include "TStreamerInfoActions.h"
+
+#include "Event.h"
+
+#include <stdlib.h>
+
+const char *kRefFileName = "benchStreamerActionsRef.root";
+const char *kFileName = "benchStreamerActions.root";
+const char *kModeNames[] = { "standard", "bulk", "compiled" };
+
+////////////////////////////////////////////////////////////////////////////////
+/// Select the streamer actions mode of the classes of the Event tree.
+
+static void SetMode(Int_t mode)
+{
+   const char *classes[] = { "Event", "EventHeader", "Track" };
+   for (Int_t i = 0; i < 3; ++i) TClass::GetClass(classes[i])->SetStreamerActionsMode(mode);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write nevent events with ntracks tracks in file fname, return the CPU time.
+
+static Double_t WriteEvents(const char *fname, Int_t split, Int_t nevent, Int_t ntracks)
+{
+   TStopwatch timer;
+   timer.Start();
+
+   gRandom->SetSeed(65539);
+   TFile *hfile = new TFile(fname, "RECREATE", "Streamer actions benchmark ROOT file", 0);
+   TTree *tree = new TTree("T", "Event tree for the streamer actions benchmark");
+   tree->SetAutoSave(1000000000);
+   Event *event = new Event();
+   TBranch *branch = tree->Branch("event", &event, 16000, split);
+   branch->SetAutoDelete(kFALSE);
+   for (Int_t ev = 0; ev < nevent; ++ev) {
+      event->Build(ev, ntracks, 1);
+      tree->Fill();
+   }
+   hfile->Write();
+   delete hfile;
+   delete event;
+
+   timer.Stop();
+   return timer.CpuTime();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return a checksum of the content of event.
+
+static Double_t Checksum(Event *event)
+{
+   Double_t sum = event->GetNtrack() + 3. * event->GetNseg() + 5. * event->GetNvertex() +
+                  7. * event->GetFlag() + 11. * event->GetTemperature() + 13. * event->IsValid();
+   EventHeader *header = event->GetHeader();
+   sum += 17. * header->GetEvtNum() + 19. * header->GetRun() + 23. * header->GetDate();
+   for (Int_t i = 0; i < 10; ++i) sum += (29. + i) * event->GetMeasure(i);
+   for (Int_t i = 0; i < 4; ++i) {
+      for (Int_t j = 0; j < 4; ++j) sum += (41. + 4 * i + j) * event->GetMatrix(i, j);
+   }
+   for (const char *c = event->GetType(); *c; ++c) sum += *c;
+   TClonesArray *tracks = event->GetTracks();
+   for (Int_t i = 0; i < tracks->GetEntriesFast(); ++i) {
+      Track *track = (Track*)tracks->UncheckedAt(i);
+      sum += track->GetPx() + 2. * track->GetPy() + 3. * track->GetPz() + 4. * track->GetRandom() +
+             5. * track->GetMeanCharge() + 6. * track->GetCharge() + 7. * track->GetNpoint() +
+             8. * track->GetValid() + 9. * track->GetN();
+   }
+   return sum;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read all the events of the tree in fname, return the CPU time and the
+/// checksum of their content in sum.
+
+static Double_t ReadEvents(const char *fname, Double_t &sum)
+{
+   sum = 0;
+   TFile *hfile = TFile::Open(fname);
+   if (!hfile || hfile->IsZombie()) {
+      delete hfile;
+      return 0;
+   }
+   TTree *tree = (TTree*)hfile->Get("T");
+   Event *event = 0;
+   tree->SetBranchAddress("event", &event);
+
+   TStopwatch timer;
+   timer.Start();
+   Long64_t nentries = tree->GetEntries();
+   for (Long64_t ev = 0; ev < nentries; ++ev) {
+      tree->GetEntry(ev);
+      sum += Checksum(event);
+   }
+   timer.Stop();
+
+   delete hfile;
+   delete event;
+   return timer.CpuTime();
+}
+
+int main(int argc, char **argv)
+{
+   Int_t nevent  = 400;
+   Int_t ntracks = 600;
+   if (argc > 1) nevent  = atoi(argv[1]);
+   if (argc > 2) ntracks = atoi(argv[2]);
+
+   printf("\n");
+   printf("******************************************************************************\n");
+   printf("*  Streamer actions, Event tree: %5d events, %4d tracks per event         *\n", nevent, ntracks);
+   printf("******************************************************************************\n");
+   printf("*  Split  Actions     Cpu write   Cpu read   Speedup   Content               *\n");
+   printf("******************************************************************************\n");
+   Bool_t ok = kTRUE;
+   Int_t splits[] = { 0, 99 };
+   for (Int_t s = 0; s < 2; ++s) {
+      SetMode(TVirtualStreamerInfo::kStandardActions);
+      WriteEvents(kRefFileName, splits[s], nevent, ntracks);
+      Double_t refsum = 0;
+      Double_t refread = 0;
+      for (Int_t mode = TVirtualStreamerInfo::kStandardActions; mode <= TVirtualStreamerInfo::kCompiledActions; ++mode) {
+         SetMode(mode);
+         Double_t cpuwrite = WriteEvents(kFileName, splits[s], nevent, ntracks);
+         Double_t sum = 0;
+         Double_t cpuread = ReadEvents(kFileName, sum);
+         Double_t sumref = 0;
+         ReadEvents(kRefFileName, sumref);
+         if (mode == TVirtualStreamerInfo::kStandardActions) {
+            refsum = sumref;
+            refread = cpuread;
+         }
+         Bool_t same = sum != 0 && sum == refsum && sumref == refsum;
+         printf("*  %5d  %-9s  %8.2f s  %7.2f s  %8.2f   %-5s                 *\n", splits[s], kModeNames[mode],
+                cpuwrite, cpuread, cpuread > 0 ? refread / cpuread : 0., same ? "ok" : "WRONG");
+         ok = ok && same;
+      }
+   }
+
+   // How the read actions of Event were optimized in the last mode.
+   TStreamerInfo *info = (TStreamerInfo*)TClass::GetClass("Event")->GetStreamerInfo();
+   TStreamerInfoActions::TActionSequence *actions = info->GetReadObjectWiseActions();
+   printf("******************************************************************************\n");
+   printf("*  Event read actions: %3d, fused: %3d, compiled: %-3s                        *\n",
+          (Int_t)actions->fActions.size(), (Int_t)actions->fBulkActions.size(),
+          actions->fCompiledAction ? "yes" : "no");
+   printf("*  Content: %-5s                                                            *\n", ok ? "ok" : "WRONG");
+   printf("******************************************************************************\n");
+   SetMode(-1);
+   gSystem->Unlink(kFileName);
+   gSystem->Unlink(kRefFileName);
+   return ok ? 0 : 1;
+}
@@ -0,0 +1,153 @@
+// @(#)root/test:$Id$
+
+// This program measures the write throughput of the Event tree of
+// test/Event when its baskets are compressed sequentially by
+// TTree::Fill and when the implicit multi-threading of the tree is
+// enabled (see TTree::SetImplicitMT).
+// The same events are written in both modes, the layout of the two
+// files (position and size of every basket) is compared to check that
+// the multi-threaded filling produces the same file.
+//
+//  run with
+//     benchWrite [nevent] [ntracks] [compression] [nthreads]
+//
+// compression is the compression setting of the file (default 1,
+// e.g. 106 for ZLIB level 6 or 404 for LZ4-HC) and nthreads the number
+// of workers of the task pool (default: one per core).
+// The program prints, for each mode, the real and CPU time to fill and
+// write the tree and the throughput in MBytes of uncompressed data per
+// real second.
+
+#include "TROOT.h"
+#include "TStopwatch.h"
+#include "TFile.h"
+#include "TTree.h"
+#include "TBranch.h"
+#include "TLeaf.h"
+#include "TSystem.h"
+#include "TRandom.h"
+#include "TTaskPool.h"
+
+#include "Event.h"
+
+#include <stdlib.h>
+
+struct TWriteBenchData {
+   Long64_t fFileSize;  // Size of the file on disk
+   Long64_t fTotBytes;  // Uncompressed size of the tree
+   Double_t fRtWrite;   // Real time to fill and write the tree
+   Double_t fCpuWrite;  // CPU time to fill and write the tree
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write nevent events with ntracks tracks in file fname with compression
+/// settings `settings`, with or without implicit multi-threading.
+
+static void WriteEvents(const char *fname, Int_t settings, Int_t nevent, Int_t ntracks,
+                        Bool_t imt, TWriteBenchData &data)
+{
+   TStopwatch timer;
+   timer.Start();
+
+   gRandom->SetSeed(65539);
+   TFile *hfile = new TFile(fname, "RECREATE", "Write benchmark ROOT file", settings);
+   TTree *tree = new TTree("T", "Event tree for the write benchmark");
+   tree->SetAutoSave(1000000000);
+   tree->SetImplicitMT(imt);
+   Event *event = new Event();
+   TBranch *branch = tree->Branch("event", &event, 16000, 99);
+   branch->SetAutoDelete(kFALSE);
+   for (Int_t ev = 0; ev < nevent; ++ev) {
+      event->Build(ev, ntracks, 1);
+      tree->Fill();
+   }
+   hfile->Write();
+   data.fTotBytes = tree->GetTotBytes();
+   data.fFileSize = hfile->GetEND();
+   delete hfile;
+   delete event;
+
+   timer.Stop();
+   data.fRtWrite  = timer.RealTime();
+   data.fCpuWrite = timer.CpuTime();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return kTRUE if the baskets of the trees in the two files are at the
+/// same place and have the same size.
+
+static Bool_t CompareLayout(const char *fname1, const char *fname2)
+{
+   TFile *f1 = TFile::Open(fname1);
+   TFile *f2 = TFile::Open(fname2);
+   Bool_t same = f1 && f2 && !f1->IsZombie() && !f2->IsZombie();
+   TTree *t1 = same ? (TTree*)f1->Get("T") : 0;
+   TTree *t2 = same ? (TTree*)f2->Get("T") : 0;
+   same = t1 && t2 && t1->GetEntries() == t2->GetEntries();
+   if (same) {
+      TObjArray *leaves = t1->GetListOfLeaves();
+      for (Int_t i = 0; same && i < leaves->GetEntriesFast(); ++i) {
+         TBranch *b1 = ((TLeaf*)leaves->UncheckedAt(i))->GetBranch();
+         TBranch *b2 = t2->GetBranch(b1->GetName());
+         if (!b2 || b1->GetWriteBasket() != b2->GetWriteBasket()) {
+            same = kFALSE;
+            break;
+         }
+         for (Int_t j = 0; j < b1->GetWriteBasket(); ++j) {
+            if (b1->GetBasketSeek(j) != b2->GetBasketSeek(j) ||
+                b1->GetBasketBytes()[j] != b2->GetBasketBytes()[j]) {
+               same = kFALSE;
+               break;
+            }
+         }
+      }
+   }
+   delete f1;
+   delete f2;
+   return same;
+}
+
+int main(int argc, char **argv)
+{
+   Int_t nevent   = 400;
+   Int_t ntracks  = 600;
+   Int_t settings = 1;
+   Int_t nthreads = 0;
+   if (argc > 1) nevent   = atoi(argv[1]);
+   if (argc > 2) ntracks  = atoi(argv[2]);
+   if (argc > 3) settings = atoi(argv[3]);
+   if (argc > 4) nthreads = atoi(argv[4]);
+   TTaskPool::SetDefaultSize(nthreads);
+
+   const char *fnameSeq = "benchWrite_seq.root";
+   const char *fnameMT  = "benchWrite_mt.root";
+   TWriteBenchData seq, mt;
+   WriteEvents(fnameSeq, settings, nevent, ntracks, kFALSE, seq);
+   WriteEvents(fnameMT,  settings, nevent, ntracks, kTRUE,  mt);
+   Bool_t same = CompareLayout(fnameSeq, fnameMT);
+   gSystem->Unlink(fnameSeq);
+   gSystem->Unlink(fnameMT);
+
+   const char *modes[2] = { "sequential  ", "implicit MT " };
+   TWriteBenchData *results[2] = { &seq, &mt };
+
+   printf("\n");
+   printf("******************************************************************************\n");
+   printf("*  Write throughput of the Event tree: %5d events, %4d tracks per event     *\n", nevent, ntracks);
+   printf("*  Compression setting %4d, %3d worker threads                               *\n", settings, TTaskPool::GetDefaultSize());
+   printf("******************************************************************************\n");
+   printf("*  Mode            File size   RT write  Cpu write  MB/RT sec   Speedup       *\n");
+   printf("******************************************************************************\n");
+   for (Int_t i = 0; i < 2; ++i) {
+      const TWriteBenchData &d = *results[i];
+      Double_t mbytes = 1e-6 * d.fTotBytes;
+      printf("*  %s  %11lld  %7.2f s  %7.2f s  %9.1f  %8.2f       *\n",
+             modes[i], d.fFileSize, d.fRtWrite, d.fCpuWrite,
+             d.fRtWrite > 0 ? mbytes / d.fRtWrite : 0, d.fRtWrite > 0 ? seq.fRtWrite / d.fRtWrite : 0);
+   }
+   printf("******************************************************************************\n");
+   printf("*  Same file layout: %-3s                                                     *\n", same ? "yes" : "NO");
+   printf("******************************************************************************\n");
+
+   return same ? 0 : 1;
+}
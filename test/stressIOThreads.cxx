@@ -0,0 +1,191 @@
+// @(#)root/test:$Id$
+
+// This program checks that independent threads can read independent ROOT
+// files at the same time and measures how the read throughput scales
+// with the number of threads.
+// One file is written per thread; then for 1, 2, 4, ... up to nthreads
+// threads, each thread opens its own file and reads all the entries of
+// its tree (decompression and unstreaming included) with its own TFile
+// and TTree, after ROOT::EnableThreadSafety() was called.
+// The content read by every thread is checked against the content
+// written, and the program prints, for each number of threads, the real
+// time, the throughput in MBytes of uncompressed data per second and the
+// scaling efficiency (throughput relative to n times the single thread
+// throughput). Beyond the number of cores of the machine (printed in the
+// header) the efficiency is expected to drop.
+//
+//  run with
+//     stressIOThreads [nthreads] [nentries] [ntracks]
+//
+// The default is 16 threads, 20000 entries and 50 tracks per entry.
+
+#include "TROOT.h"
+#include "TFile.h"
+#include "TTree.h"
+#include "TRandom3.h"
+#include "TStopwatch.h"
+#include "TSystem.h"
+#include "TString.h"
+#include "TMath.h"
+
+#include <stdlib.h>
+#include <thread>
+#include <vector>
+
+const Int_t kMaxTracks = 1000;
+
+struct TFileSummary {
+   Long64_t fEntries;  // Number of entries of the tree
+   Long64_t fTracks;   // Sum of the number of tracks
+   Double_t fSumPx;    // Sum of the px of all the tracks
+   Long64_t fTotBytes; // Uncompressed size of the tree
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Name of the file read by thread i.
+
+static TString FileName(Int_t i)
+{
+   return TString::Format("stressIOThreads_%d.root", i);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write the file read by thread i and fill its summary.
+
+static void WriteFile(Int_t i, Long64_t nentries, Int_t ntracks, TFileSummary &sum)
+{
+   TRandom3 rnd(i + 1);
+   TFile file(FileName(i), "RECREATE");
+   TTree *tree = new TTree("T", "Tree for the threaded I/O stress test");
+   Int_t n;
+   Int_t run = i;
+   Float_t px[kMaxTracks], py[kMaxTracks], pz[kMaxTracks];
+   Double_t energy;
+   tree->Branch("run", &run, "run/I");
+   tree->Branch("n", &n, "n/I");
+   tree->Branch("px", px, "px[n]/F");
+   tree->Branch("py", py, "py[n]/F");
+   tree->Branch("pz", pz, "pz[n]/F");
+   tree->Branch("energy", &energy, "energy/D");
+
+   sum.fEntries = nentries;
+   sum.fTracks = 0;
+   sum.fSumPx = 0;
+   for (Long64_t entry = 0; entry < nentries; ++entry) {
+      n = rnd.Integer(ntracks + 1);
+      energy = 0;
+      for (Int_t t = 0; t < n; ++t) {
+         rnd.Rannor(px[t], py[t]);
+         pz[t] = rnd.Gaus(0, 10);
+         energy += TMath::Sqrt(px[t]*px[t] + py[t]*py[t] + pz[t]*pz[t]);
+         sum.fSumPx += px[t];
+      }
+      sum.fTracks += n;
+      tree->Fill();
+   }
+   file.Write();
+   sum.fTotBytes = tree->GetTotBytes();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read all the entries of the file of thread i and summarize them.
+
+static void ReadFile(Int_t i, TFileSummary &sum)
+{
+   sum.fEntries = -1;
+   TFile *file = TFile::Open(FileName(i));
+   if (!file || file->IsZombie()) {
+      delete file;
+      return;
+   }
+   TTree *tree = 0;
+   file->GetObject("T", tree);
+   if (tree) {
+      Int_t n, run;
+      Float_t px[kMaxTracks], py[kMaxTracks], pz[kMaxTracks];
+      Double_t energy;
+      tree->SetBranchAddress("run", &run);
+      tree->SetBranchAddress("n", &n);
+      tree->SetBranchAddress("px", px);
+      tree->SetBranchAddress("py", py);
+      tree->SetBranchAddress("pz", pz);
+      tree->SetBranchAddress("energy", &energy);
+
+      sum.fEntries = tree->GetEntries();
+      sum.fTracks = 0;
+      sum.fSumPx = 0;
+      for (Long64_t entry = 0; entry < sum.fEntries; ++entry) {
+         tree->GetEntry(entry);
+         if (run != i) {
+            sum.fEntries = -1;
+            break;
+         }
+         sum.fTracks += n;
+         for (Int_t t = 0; t < n; ++t) sum.fSumPx += px[t];
+      }
+      sum.fTotBytes = tree->GetTotBytes();
+   }
+   delete file;
+}
+
+int main(int argc, char **argv)
+{
+   Int_t nthreads  = 16;
+   Long64_t nentries = 20000;
+   Int_t ntracks   = 50;
+   if (argc > 1) nthreads = atoi(argv[1]);
+   if (argc > 2) nentries = atoll(argv[2]);
+   if (argc > 3) ntracks  = atoi(argv[3]);
+   if (nthreads < 1) nthreads = 1;
+   if (ntracks > kMaxTracks) ntracks = kMaxTracks;
+
+   ROOT::EnableThreadSafety();
+
+   std::vector<TFileSummary> written(nthreads);
+   for (Int_t i = 0; i < nthreads; ++i)
+      WriteFile(i, nentries, ntracks, written[i]);
+
+   printf("\n");
+   printf("******************************************************************************\n");
+   printf("*  Threaded read of independent files: %8lld entries per file              *\n", nentries);
+   printf("*  %3d threads at most, %3u hardware threads                                  *\n",
+          nthreads, std::thread::hardware_concurrency());
+   printf("******************************************************************************\n");
+   printf("*  Threads     RT read    MB/RT sec   Efficiency   Content                    *\n");
+   printf("******************************************************************************\n");
+
+   Bool_t ok = kTRUE;
+   Double_t single = 0;
+   for (Int_t n = 1; n <= nthreads; n = (n < nthreads && 2*n > nthreads) ? nthreads : 2*n) {
+      std::vector<TFileSummary> read(n);
+      std::vector<std::thread> threads;
+      TStopwatch timer;
+      timer.Start();
+      for (Int_t i = 0; i < n; ++i)
+         threads.push_back(std::thread(ReadFile, i, std::ref(read[i])));
+      for (Int_t i = 0; i < n; ++i)
+         threads[i].join();
+      timer.Stop();
+
+      Bool_t same = kTRUE;
+      Double_t mbytes = 0;
+      for (Int_t i = 0; i < n; ++i) {
+         const TFileSummary &r = read[i], &w = written[i];
+         if (r.fEntries != w.fEntries || r.fTracks != w.fTracks || r.fSumPx != w.fSumPx)
+            same = kFALSE;
+         mbytes += 1e-6 * w.fTotBytes;
+      }
+      ok = ok && same;
+      Double_t rt = timer.RealTime();
+      Double_t rate = rt > 0 ? mbytes / rt : 0;
+      if (n == 1) single = rate;
+      printf("*  %5d    %7.2f s   %9.1f    %7.1f %%    %-5s                      *\n",
+             n, rt, rate, single > 0 ? 100. * rate / (n * single) : 0., same ? "ok" : "WRONG");
+   }
+   printf("******************************************************************************\n");
+
+   for (Int_t i = 0; i < nthreads; ++i)
+      gSystem->Unlink(FileName(i));
+
+   return ok ? 0 : 1;
+}
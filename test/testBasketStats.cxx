@@ -0,0 +1,273 @@
+// @(#)root/test:$Id$
+
+// This program checks the statistics of the baskets (see
+// TBranch::SetBasketStats) and the skipping of the entries that cannot pass
+// a range cut (see TBasketStatsCut):
+//  - the smallest and largest values and the number of values recorded for
+//    each basket must be the ones of the entries of the basket;
+//  - TTree::Draw and TTreeReader::SetBasketCut must select the same entries
+//    from a tree with statistics, from a fast clone of it and from a tree
+//    without statistics (as written by an older version), for several
+//    selections, and the same as a plain loop over the entries;
+//  - baskets must be skipped only when the tree has statistics and the
+//    selection has range cuts.
+//
+//  run with
+//     testBasketStats
+
+#include "TFile.h"
+#include "TTree.h"
+#include "TBranch.h"
+#include "TBasketStatsCut.h"
+#include "TTreePerfStats.h"
+#include "TTreeReader.h"
+#include "TTreeReaderValue.h"
+#include "TRandom3.h"
+#include "TSystem.h"
+#include "TError.h"
+
+const Int_t kEntries = 100000;
+const Int_t kMaxValues = 10;
+
+////////////////////////////////////////////////////////////////////////////////
+/// The values of an entry, generated from the same seed for the tree and
+/// the plain loop.
+
+struct TEntryValues {
+   Double_t fPt;
+   Double_t fX;
+   Int_t    fN;
+   Float_t  fA[kMaxValues];
+
+   void Generate(TRandom3 &rnd, Int_t entry)
+   {
+      fPt = entry + rnd.Rndm();
+      fX = rnd.Gaus(0, 1);
+      fN = rnd.Integer(kMaxValues);
+      for (Int_t i = 0; i < fN; ++i) fA[i] = 100 * rnd.Rndm();
+   }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// A selection, evaluated by the plain loop with pass.
+
+struct TSelection {
+   const char *fCut;
+   Bool_t    (*fPass)(const TEntryValues &v);
+   Bool_t      fSkips;   // True if baskets of a tree with statistics must be skipped
+};
+
+static Bool_t PassHigh(const TEntryValues &v) { return v.fPt > 95000 && v.fX > 0; }
+static Bool_t PassWindow(const TEntryValues &v) { return v.fPt >= 20000 && v.fPt < 20500; }
+static Bool_t PassReversed(const TEntryValues &v) { return v.fPt < 300.5 && v.fN == 3; }
+static Bool_t PassOr(const TEntryValues &v) { return v.fPt > 99000 || v.fX > 3; }
+
+static const TSelection kSelections[] = {
+   { "pt > 95000 && x > 0", PassHigh, kTRUE },
+   { "(pt >= 20000) && 20500 > pt", PassWindow, kTRUE },
+   { "pt < 300.5 && n == 3", PassReversed, kTRUE },
+   { "pt > 99000 || x > 3", PassOr, kFALSE }
+};
+const Int_t kNselections = sizeof(kSelections) / sizeof(kSelections[0]);
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write the tree in fname, with the statistics of all the branches if
+/// stats is true.
+
+static void WriteTree(const char *fname, Bool_t stats)
+{
+   TFile f(fname, "RECREATE");
+   TTree tree("T", "Tree for the basket statistics test");
+   TEntryValues v;
+   tree.Branch("pt", &v.fPt, "pt/D", 4000);
+   tree.Branch("x", &v.fX, "x/D", 4000);
+   tree.Branch("n", &v.fN, "n/I", 4000);
+   tree.Branch("a", v.fA, "a[n]/F", 4000);
+   if (stats) tree.SetBasketStats("*");
+   TRandom3 rnd(4357);
+   for (Int_t entry = 0; entry < kEntries; ++entry) {
+      v.Generate(rnd, entry);
+      tree.Fill();
+   }
+   tree.Write();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fast clone the tree of from into to.
+
+static void CloneTree(const char *from, const char *to)
+{
+   TFile *in = TFile::Open(from);
+   TTree *tree = (TTree*)in->Get("T");
+   TFile out(to, "RECREATE");
+   TTree *clone = tree->CloneTree(-1, "fast");
+   clone->Write();
+   out.Close();
+   delete in;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Compare the statistics of each basket of the branches of the tree in
+/// fname with the values of its entries.
+
+static Int_t CheckStats(const char *fname)
+{
+   TFile *f = TFile::Open(fname);
+   TTree *tree = f ? (TTree*)f->Get("T") : 0;
+   if (!tree) {
+      Error("testBasketStats", "can not read the tree from %s", fname);
+      delete f;
+      return 1;
+   }
+   Int_t nerrors = 0;
+   const char *names[] = { "pt", "n", "a" };
+   for (Int_t b = 0; b < 3; ++b) {
+      TBranch *branch = tree->GetBranch(names[b]);
+      if (!branch->HasBasketStats()) {
+         Error("testBasketStats", "%s: the branch %s has no statistics", fname, names[b]);
+         ++nerrors;
+         continue;
+      }
+      TRandom3 rnd(4357);
+      TEntryValues v;
+      Int_t entry = 0;
+      for (Int_t basket = 0; basket < branch->GetWriteBasket(); ++basket) {
+         Double_t min, max;
+         Long64_t nvalues;
+         if (!branch->GetBasketStats(basket, min, max, nvalues)) {
+            Error("testBasketStats", "%s: no statistics for basket %d of %s", fname, basket, names[b]);
+            ++nerrors;
+            break;
+         }
+         Double_t vmin = 1e300, vmax = -1e300;
+         Long64_t n = 0;
+         for (; entry < branch->GetBasketEntry()[basket + 1]; ++entry) {
+            v.Generate(rnd, entry);
+            Double_t values[kMaxValues];
+            Int_t nv = 1;
+            if (b == 0) values[0] = v.fPt;
+            else if (b == 1) values[0] = v.fN;
+            else for (nv = 0; nv < v.fN; ++nv) values[nv] = v.fA[nv];
+            for (Int_t i = 0; i < nv; ++i) {
+               if (values[i] < vmin) vmin = values[i];
+               if (values[i] > vmax) vmax = values[i];
+            }
+            n += nv;
+         }
+         if (n != nvalues || (n && (min != vmin || max != vmax))) {
+            Error("testBasketStats", "%s: wrong statistics for basket %d of %s", fname, basket, names[b]);
+            ++nerrors;
+            break;
+         }
+      }
+   }
+   delete f;
+   return nerrors;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Select the entries of the tree in fname with TTree::Draw or, if reader
+/// is true, with TTreeReader. Return the number of entries selected (-1 in
+/// case of error), in sum the sum of their pt and in nskipped the number of
+/// baskets skipped.
+
+static Long64_t Select(const char *fname, const TSelection &sel, Bool_t reader, Double_t &sum, Int_t &nskipped)
+{
+   sum = 0;
+   nskipped = 0;
+   TFile *f = TFile::Open(fname);
+   TTree *tree = f ? (TTree*)f->Get("T") : 0;
+   if (!tree) {
+      delete f;
+      return -1;
+   }
+   TTreePerfStats *ps = new TTreePerfStats("ioperf", tree);
+   Long64_t nsel = 0;
+   if (reader) {
+      TTreeReader r(tree);
+      TTreeReaderValue<Double_t> pt(r, "pt");
+      TTreeReaderValue<Double_t> x(r, "x");
+      TTreeReaderValue<Int_t> n(r, "n");
+      r.SetBasketCut(sel.fCut);
+      TEntryValues v;
+      while (r.Next()) {
+         v.fPt = *pt;
+         v.fX = *x;
+         v.fN = *n;
+         if (sel.fPass(v)) {
+            ++nsel;
+            sum += *pt;
+         }
+      }
+   } else {
+      tree->SetEstimate(tree->GetEntries());
+      nsel = tree->Draw("pt", sel.fCut, "goff");
+      for (Long64_t i = 0; i < nsel; ++i) sum += tree->GetV1()[i];
+   }
+   nskipped = ps->GetBasketsSkipped();
+   tree->SetPerfStats(0);
+   delete ps;
+   delete f;
+   return nsel;
+}
+
+int main()
+{
+   const char *fstats = "testBasketStats.root";
+   const char *fclone = "testBasketStatsClone.root";
+   const char *fold = "testBasketStatsOld.root";
+   WriteTree(fstats, kTRUE);
+   WriteTree(fold, kFALSE);
+   CloneTree(fstats, fclone);
+
+   Int_t nerrors = CheckStats(fstats) + CheckStats(fclone);
+
+   TBasketStatsCut orcut(kSelections[kNselections - 1].fCut);
+   if (!orcut.IsEmpty()) {
+      Error("testBasketStats", "range cuts taken from the disjunction %s", orcut.GetCut());
+      ++nerrors;
+   }
+
+   const char *files[] = { fold, fstats, fclone };
+   for (Int_t s = 0; s < kNselections; ++s) {
+      const TSelection &sel = kSelections[s];
+      Long64_t nexp = 0;
+      Double_t sumexp = 0;
+      TRandom3 rnd(4357);
+      TEntryValues v;
+      for (Int_t entry = 0; entry < kEntries; ++entry) {
+         v.Generate(rnd, entry);
+         if (sel.fPass(v)) {
+            ++nexp;
+            sumexp += v.fPt;
+         }
+      }
+      if (!nexp) {
+         Error("testBasketStats", "%s: no entry passes the selection", sel.fCut);
+         ++nerrors;
+      }
+      for (Int_t i = 0; i < 3; ++i) {
+         for (Int_t reader = 0; reader < 2; ++reader) {
+            Double_t sum;
+            Int_t nskipped;
+            Long64_t nsel = Select(files[i], sel, reader, sum, nskipped);
+            const char *mode = reader ? "TTreeReader" : "TTree::Draw";
+            if (nsel != nexp || sum != sumexp) {
+               Error("testBasketStats", "%s, %s, %s: %lld entries selected instead of %lld", files[i], mode,
+                     sel.fCut, nsel, nexp);
+               ++nerrors;
+            }
+            Bool_t skips = i > 0 && sel.fSkips;
+            if ((nskipped > 0) != skips) {
+               Error("testBasketStats", "%s, %s, %s: %d baskets skipped", files[i], mode, sel.fCut, nskipped);
+               ++nerrors;
+            }
+         }
+      }
+   }
+
+   gSystem->Unlink(fstats);
+   gSystem->Unlink(fclone);
+   gSystem->Unlink(fold);
+   return nerrors ? 1 : 0;
+}
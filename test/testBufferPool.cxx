@@ -0,0 +1,261 @@
+// @(#)root/test:$Id$
+
+// This program checks TBufferPool, which keeps the I/O buffers released for
+// the next allocations of the same size class:
+//  - a block has at least the size requested, at most a quarter more (or
+//    the smallest class), and a block released is handed out again for
+//    the same class, from the pool, while no block is kept without reuse;
+//  - ReAllocChar keeps the content of a block when it grows or shrinks;
+//  - a TBufferFile using a block of the pool expands it through the pool,
+//    and gives it back when detached;
+//  - blocks allocated, filled and released by several threads at once are
+//    never handed out twice at the same time;
+//  - a tree with branches of various basket sizes read with and without
+//    reuse of the buffers gives back the values written.
+//
+//  run with
+//     testBufferPool
+
+#include "TFile.h"
+#include "TTree.h"
+#include "TBufferFile.h"
+#include "TBufferPool.h"
+#include "TRandom3.h"
+#include "TString.h"
+#include "TSystem.h"
+#include "TError.h"
+
+#include <string.h>
+#include <thread>
+#include <vector>
+
+const char *kFileName  = "testBufferPool.root";
+const Int_t kNbranches = 40;
+const Int_t kNentries  = 5000;
+
+////////////////////////////////////////////////////////////////////////////////
+/// Check the sizes of the blocks and their reuse; return the number of
+/// errors.
+
+static Int_t CheckAllocate()
+{
+   Int_t nerrors = 0;
+   const Long64_t sizes[] = { 0, 1, 512, 513, 1000, 4096, 5000, 100000, 1048577, 3000000 };
+   for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+      Long64_t size = sizes[i];
+      char *block = TBufferPool::Allocate(size);
+      Long64_t capacity = TBufferPool::GetCapacity(block);
+      if (capacity < size || (capacity > 512 && 4 * capacity > 5 * size)) {
+         Error("testBufferPool", "capacity %lld for %lld bytes", capacity, size);
+         ++nerrors;
+      }
+      memset(block, 'x', size);
+      TBufferPool::Release(block);
+
+      // The block released is reused for the same class.
+      Long64_t nhits = TBufferPool::GetNhits();
+      char *again = TBufferPool::Allocate(capacity);
+      if (again != block || TBufferPool::GetNhits() != nhits + 1) {
+         Error("testBufferPool", "the block of %lld bytes released is not reused", capacity);
+         ++nerrors;
+      }
+      TBufferPool::Release(again);
+   }
+
+   // Without reuse, nothing is kept.
+   Long64_t maxcached = TBufferPool::GetMaxCachedBytes();
+   TBufferPool::SetMaxCachedBytes(0);
+   Long64_t allocated = TBufferPool::GetAllocatedBytes();
+   char *block = TBufferPool::Allocate(10000);
+   TBufferPool::Release(block);
+   if (TBufferPool::GetCachedBytes() != 0 || TBufferPool::GetAllocatedBytes() != allocated) {
+      Error("testBufferPool", "blocks kept without reuse: %lld bytes cached", TBufferPool::GetCachedBytes());
+      ++nerrors;
+   }
+   TBufferPool::SetMaxCachedBytes(maxcached);
+   return nerrors;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Check the reallocation of blocks and of a TBufferFile using the pool;
+/// return the number of errors.
+
+static Int_t CheckRealloc()
+{
+   Int_t nerrors = 0;
+   char *block = TBufferPool::Allocate(600);
+   for (Int_t i = 0; i < 600; ++i) block[i] = char(i);
+   block = TBufferPool::ReAllocChar(block, 100000, 600);
+   Bool_t ok = kTRUE;
+   for (Int_t i = 0; i < 600; ++i) ok = ok && block[i] == char(i);
+   for (Int_t i = 600; i < 100000; ++i) ok = ok && block[i] == 0;
+   block = TBufferPool::ReAllocChar(block, 300, 100000);
+   for (Int_t i = 0; i < 300; ++i) ok = ok && block[i] == char(i);
+   if (!ok) {
+      Error("testBufferPool", "ReAllocChar does not keep the content of the block");
+      ++nerrors;
+   }
+   TBufferPool::Release(block);
+
+   TBufferFile buf(TBuffer::kWrite);
+   TBufferPool::Attach(&buf, 1000);
+   for (Int_t i = 0; i < 100000; ++i) buf.WriteInt(i);
+   if (!TBufferPool::IsPooled(&buf) || TBufferPool::GetCapacity(buf.Buffer()) < buf.Length()) {
+      Error("testBufferPool", "the buffer is not expanded through the pool");
+      ++nerrors;
+   }
+   buf.SetReadMode();
+   buf.SetBufferOffset(0);
+   ok = kTRUE;
+   for (Int_t i = 0; i < 100000; ++i) {
+      Int_t v;
+      buf.ReadInt(v);
+      ok = ok && v == i;
+   }
+   if (!ok) {
+      Error("testBufferPool", "the buffer expanded through the pool is wrong");
+      ++nerrors;
+   }
+   TBufferPool::Detach(&buf);
+   if (TBufferPool::IsPooled(&buf)) {
+      Error("testBufferPool", "the buffer still uses the pool after Detach");
+      ++nerrors;
+   }
+   return nerrors;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Allocate, fill with the pattern of the thread, check and release blocks;
+/// set nwrong to the number of blocks overwritten by another thread.
+
+static void UseBlocks(Int_t thread, Int_t &nwrong)
+{
+   TRandom3 rnd(4357 + thread);
+   std::vector<char*> blocks;
+   std::vector<Int_t> sizes;
+   nwrong = 0;
+   for (Int_t i = 0; i < 20000; ++i) {
+      if (blocks.size() < 8) {
+         Int_t size = 1 + rnd.Integer(20000);
+         char *block = TBufferPool::Allocate(size);
+         memset(block, 'a' + thread, size);
+         blocks.push_back(block);
+         sizes.push_back(size);
+         continue;
+      }
+      size_t k = rnd.Integer(blocks.size());
+      for (Int_t j = 0; j < sizes[k]; j += 97) {
+         if (blocks[k][j] != 'a' + thread) {
+            ++nwrong;
+            break;
+         }
+      }
+      TBufferPool::Release(blocks[k]);
+      blocks.erase(blocks.begin() + k);
+      sizes.erase(sizes.begin() + k);
+   }
+   for (size_t k = 0; k < blocks.size(); ++k) TBufferPool::Release(blocks[k]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Use blocks from several threads at once; return the number of errors.
+
+static Int_t CheckThreads()
+{
+   const Int_t nthreads = 4;
+   std::vector<Int_t> nwrong(nthreads);
+   std::vector<std::thread> threads;
+   for (Int_t t = 0; t < nthreads; ++t) threads.push_back(std::thread(UseBlocks, t, std::ref(nwrong[t])));
+   for (Int_t t = 0; t < nthreads; ++t) threads[t].join();
+   Int_t nerrors = 0;
+   for (Int_t t = 0; t < nthreads; ++t) {
+      if (nwrong[t]) {
+         Error("testBufferPool", "%d blocks of thread %d overwritten by another thread", nwrong[t], t);
+         ++nerrors;
+      }
+   }
+   return nerrors;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write a tree with branches of Int_t and Double_t alternately, with basket
+/// sizes from 2 kB to 16 kB.
+
+static void WriteTree()
+{
+   TFile f(kFileName, "RECREATE");
+   TTree tree("T", "Tree for the buffer pool test");
+   std::vector<Double_t> dvalues(kNbranches);
+   std::vector<Int_t> ivalues(kNbranches);
+   for (Int_t i = 0; i < kNbranches; ++i) {
+      Int_t bufsize = 2048 * (1 + i % 8);
+      if (i % 2) tree.Branch(Form("d%d", i), &dvalues[i], Form("d%d/D", i), bufsize);
+      else       tree.Branch(Form("i%d", i), &ivalues[i], Form("i%d/I", i), bufsize);
+   }
+   for (Int_t ev = 0; ev < kNentries; ++ev) {
+      for (Int_t i = 0; i < kNbranches; ++i) {
+         dvalues[i] = 0.5 * ev + i;
+         ivalues[i] = ev * kNbranches + i;
+      }
+      tree.Fill();
+   }
+   tree.Write();
+   f.Close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read the tree with the buffer pool bounded to maxcached bytes; return the
+/// number of values different from the ones written, -1 on error.
+
+static Long64_t ReadTree(Long64_t maxcached)
+{
+   TBufferPool::SetMaxCachedBytes(maxcached);
+   TFile *f = TFile::Open(kFileName);
+   TTree *tree = 0;
+   if (f) f->GetObject("T", tree);
+   if (!tree) {
+      delete f;
+      return -1;
+   }
+   std::vector<Double_t> dvalues(kNbranches);
+   std::vector<Int_t> ivalues(kNbranches);
+   for (Int_t i = 0; i < kNbranches; ++i) {
+      if (i % 2) tree->SetBranchAddress(Form("d%d", i), &dvalues[i]);
+      else       tree->SetBranchAddress(Form("i%d", i), &ivalues[i]);
+   }
+   Long64_t nwrong = tree->GetEntries() == kNentries ? 0 : 1;
+   for (Long64_t ev = 0; ev < tree->GetEntries(); ++ev) {
+      tree->GetEntry(ev);
+      for (Int_t i = 0; i < kNbranches; ++i) {
+         if (i % 2 ? dvalues[i] != 0.5 * ev + i : ivalues[i] != ev * kNbranches + i) ++nwrong;
+      }
+   }
+   delete f;
+   return nwrong;
+}
+
+int main()
+{
+   Int_t nerrors = CheckAllocate() + CheckRealloc() + CheckThreads();
+
+   WriteTree();
+   Long64_t maxcached = TBufferPool::GetMaxCachedBytes();
+   Long64_t nwrong = ReadTree(0);
+   if (nwrong) {
+      Error("testBufferPool", "without reuse of the buffers: %lld values read wrong", nwrong);
+      ++nerrors;
+   }
+   TBufferPool::ResetStats();
+   nwrong = ReadTree(maxcached);
+   if (nwrong) {
+      Error("testBufferPool", "with reuse of the buffers: %lld values read wrong", nwrong);
+      ++nerrors;
+   }
+   if (!TBufferPool::GetNhits()) {
+      Error("testBufferPool", "no buffer reused when reading the tree");
+      ++nerrors;
+   }
+   TBufferPool::SetMaxCachedBytes(maxcached);
+   gSystem->Unlink(kFileName);
+   return nerrors ? 1 : 0;
+}
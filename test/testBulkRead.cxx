@@ -0,0 +1,169 @@
+// @(#)root/test:$Id$
+
+// This program checks TBranch::GetBulkEntries, which copies the values of
+// all the entries of a basket to a user buffer in one go:
+//  - the values of a float, a double, an integer and a variable size array
+//    of floats read from a file in bulk must be the ones read by GetEntry;
+//  - for a tree in memory, the entries of the basket still being filled
+//    must be read up to the last entry filled, and the tree must still be
+//    filled and read correctly afterwards.
+//
+//  run with
+//     testBulkRead
+
+#include "TFile.h"
+#include "TTree.h"
+#include "TBranch.h"
+#include "TBufferFile.h"
+#include "TSystem.h"
+#include "TError.h"
+
+#include <vector>
+
+const Int_t kMaxTracks = 10;
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read all the values of branch, of type T, in bulk from entry first.
+
+template <typename T>
+static Bool_t ReadBulk(TBranch *branch, Long64_t first, std::vector<T> &values)
+{
+   TBufferFile buf(TBuffer::kWrite, 32000);
+   values.clear();
+   for (Long64_t entry = first; entry < branch->GetEntries(); ) {
+      Int_t n = branch->GetBulkEntries(entry, buf);
+      if (n <= 0) return kFALSE;
+      const T *v = (const T*)buf.Buffer();
+      values.insert(values.end(), v, v + buf.Length() / sizeof(T));
+      entry += n;
+   }
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Compare the values of the tree read entry by entry and in bulk.
+
+static Int_t CheckFile(const char *fname)
+{
+   TFile *file = TFile::Open(fname);
+   TTree *tree = 0;
+   if (file) file->GetObject("T", tree);
+   if (!tree) {
+      Error("testBulkRead", "can not read the tree from %s", fname);
+      delete file;
+      return 1;
+   }
+   std::vector<Float_t> x, px;
+   std::vector<Double_t> e;
+   std::vector<Int_t> n;
+   if (!ReadBulk(tree->GetBranch("x"), 0, x) || !ReadBulk(tree->GetBranch("e"), 0, e)
+       || !ReadBulk(tree->GetBranch("n"), 0, n) || !ReadBulk(tree->GetBranch("px"), 0, px)) {
+      Error("testBulkRead", "GetBulkEntries failed");
+      delete file;
+      return 1;
+   }
+
+   Float_t vx, vpx[kMaxTracks];
+   Double_t ve;
+   Int_t vn;
+   tree->SetBranchAddress("x", &vx);
+   tree->SetBranchAddress("e", &ve);
+   tree->SetBranchAddress("n", &vn);
+   tree->SetBranchAddress("px", vpx);
+   Long64_t nentries = tree->GetEntries();
+   Long64_t nwrong = 0;
+   size_t ipx = 0;
+   if (Long64_t(x.size()) != nentries || Long64_t(e.size()) != nentries || Long64_t(n.size()) != nentries) {
+      nwrong = nentries;
+   }
+   for (Long64_t entry = 0; !nwrong && entry < nentries; ++entry) {
+      tree->GetEntry(entry);
+      if (vx != x[entry] || ve != e[entry] || vn != n[entry] || ipx + vn > px.size()) {
+         ++nwrong;
+         break;
+      }
+      for (Int_t t = 0; t < vn; ++t, ++ipx) {
+         if (vpx[t] != px[ipx]) ++nwrong;
+      }
+   }
+   if (!nwrong && ipx != px.size()) ++nwrong;
+   if (nwrong) Error("testBulkRead", "the values read in bulk differ from the ones read by GetEntry");
+   delete file;
+   return nwrong ? 1 : 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read in bulk the basket being filled of a tree in memory.
+
+static Int_t CheckWriteBasket()
+{
+   Int_t nerrors = 0;
+   TTree tree("M", "Tree in memory");
+   tree.SetDirectory(0);
+   Int_t i;
+   tree.Branch("i", &i, "i/I", 1000);
+   for (i = 0; i < 1010; ++i) tree.Fill();
+
+   TBranch *branch = tree.GetBranch("i");
+   std::vector<Int_t> values;
+   for (Int_t step = 0; step < 2; ++step) {
+      // Read the whole tree, then only the entries filled since the last read.
+      Long64_t first = step ? 1010 : 0;
+      if (!ReadBulk(branch, first, values) || Long64_t(values.size()) != tree.GetEntries() - first) {
+         Error("testBulkRead", "step %d: the basket being filled is not read in bulk", step);
+         ++nerrors;
+      } else {
+         for (size_t k = 0; k < values.size(); ++k) {
+            if (values[k] != Int_t(first + k)) {
+               Error("testBulkRead", "step %d: wrong value for entry %lld", step, first + Long64_t(k));
+               ++nerrors;
+               break;
+            }
+         }
+      }
+      for (i = 1010; step == 0 && i < 1020; ++i) tree.Fill();
+   }
+
+   // The basket must still be usable for filling and reading entry by entry.
+   for (i = 1020; i < 1500; ++i) tree.Fill();
+   tree.SetBranchAddress("i", &i);
+   for (Long64_t entry = 0; entry < tree.GetEntries(); ++entry) {
+      tree.GetEntry(entry);
+      if (i != entry) {
+         Error("testBulkRead", "the tree is wrong after the bulk read, entry %lld", entry);
+         ++nerrors;
+         break;
+      }
+   }
+   tree.ResetBranchAddresses();
+   return nerrors;
+}
+
+int main()
+{
+   const char *fname = "testBulkRead.root";
+   {
+      TFile file(fname, "RECREATE");
+      TTree *tree = new TTree("T", "Tree for the bulk read test");
+      Float_t x;
+      Double_t e;
+      Int_t n;
+      Float_t px[kMaxTracks];
+      tree->Branch("x", &x, "x/F");
+      tree->Branch("e", &e, "e/D");
+      tree->Branch("n", &n, "n/I");
+      tree->Branch("px", px, "px[n]/F");
+      for (Long64_t entry = 0; entry < 200000; ++entry) {
+         x = 0.5f * entry;
+         e = 1e-3 * entry;
+         n = entry % (kMaxTracks + 1);
+         for (Int_t t = 0; t < n; ++t) px[t] = t - 0.125f * entry;
+         tree->Fill();
+      }
+      file.Write();
+   }
+
+   Int_t nerrors = CheckFile(fname) + CheckWriteBasket();
+   gSystem->Unlink(fname);
+   return nerrors ? 1 : 0;
+}
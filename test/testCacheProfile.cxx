@@ -0,0 +1,143 @@
+// @(#)root/test:$Id$
+
+// This program checks the TTreeCache learning profiles (see
+// TTreeCache::SaveProfile and TTreeCache::LoadProfile): a job reading a few
+// branches of a tree saves the profile learned by its cache, and a second
+// job importing this profile must cache the same branches from the first
+// entry, skipping the learning phase, with fewer read calls. Both jobs must
+// read back the values written.
+//
+//  run with
+//     testCacheProfile
+
+#include "TFile.h"
+#include "TTree.h"
+#include "TBranch.h"
+#include "TTreeCache.h"
+#include "TRandom3.h"
+#include "TString.h"
+#include "TSystem.h"
+#include "TError.h"
+
+const Int_t kNbranches = 60;   // Number of branches of the tree
+const Int_t kStride    = 6;    // One branch out of kStride is read
+
+struct TJob {
+   Int_t    fReadCalls;   // Number of read calls of the job
+   Int_t    fLearnReads;  // Reads done in the learning phase
+   Int_t    fSaved;       // Reads saved by the profile
+   Double_t fSum;         // Sum of the values read
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write nentries entries in fname and return the sum of the values of the
+/// branches read by the jobs.
+
+static Double_t WriteFile(const char *fname, Long64_t nentries)
+{
+   TRandom3 rnd(4357);
+   TFile file(fname, "RECREATE");
+   TTree *tree = new TTree("T", "Tree for the cache profile test");
+   Float_t values[kNbranches];
+   for (Int_t b = 0; b < kNbranches; ++b) {
+      tree->Branch(TString::Format("b%d", b), &values[b], TString::Format("b%d/F", b), 4000);
+   }
+   Double_t sum = 0;
+   for (Long64_t entry = 0; entry < nentries; ++entry) {
+      for (Int_t b = 0; b < kNbranches; ++b) values[b] = rnd.Gaus(0, 1);
+      for (Int_t b = 0; b < kNbranches; b += kStride) sum += values[b];
+      tree->Fill();
+   }
+   file.Write();
+   return sum;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read the selected branches of the tree in fname with a cache, importing
+/// the profile saved in profile if not 0, saving the profile learned in save
+/// if not 0. Return kFALSE if the tree or its cache can not be used.
+
+static Bool_t RunJob(const char *fname, const char *profile, const char *save, TJob &job)
+{
+   job.fReadCalls = job.fLearnReads = job.fSaved = 0;
+   job.fSum = 0;
+   TFile *file = TFile::Open(fname);
+   TTree *tree = 0;
+   if (file) file->GetObject("T", tree);
+   if (!tree) {
+      delete file;
+      return kFALSE;
+   }
+   tree->SetCacheSize(10000000);
+   TTreeCache *cache = dynamic_cast<TTreeCache*>(file->GetCacheRead(tree));
+   if (!cache) {
+      delete file;
+      return kFALSE;
+   }
+   cache->SetLearnPrefill(TTreeCache::kNoPrefill);
+   if (profile) cache->LoadProfile(profile);
+
+   Float_t values[kNbranches];
+   TBranch *branches[kNbranches];
+   Int_t nread = 0;
+   for (Int_t b = 0; b < kNbranches; b += kStride) {
+      tree->SetBranchAddress(TString::Format("b%d", b), &values[nread]);
+      branches[nread++] = tree->GetBranch(TString::Format("b%d", b));
+   }
+   Long64_t nentries = tree->GetEntries();
+   for (Long64_t entry = 0; entry < nentries; ++entry) {
+      tree->LoadTree(entry);
+      for (Int_t b = 0; b < nread; ++b) {
+         branches[b]->GetEntry(entry);
+         job.fSum += values[b];
+      }
+   }
+   job.fLearnReads = cache->GetLearnReads();
+   job.fSaved = cache->GetProfileReadsSaved();
+   if (save) cache->SaveProfile(save);
+   job.fReadCalls = file->GetReadCalls();
+   delete file;
+   return kTRUE;
+}
+
+int main()
+{
+   const char *fname = "testCacheProfile.root";
+   const char *pname = "testCacheProfile_profile.root";
+   Double_t written = WriteFile(fname, 50000);
+   gSystem->Unlink(pname);
+
+   Int_t nerrors = 0;
+   TJob learn, profile;
+   if (!RunJob(fname, 0, pname, learn) || !RunJob(fname, pname, 0, profile)) {
+      Error("testCacheProfile", "can not read the tree through a TTreeCache");
+      gSystem->Unlink(fname);
+      gSystem->Unlink(pname);
+      return 1;
+   }
+   if (learn.fSum != written || profile.fSum != written) {
+      Error("testCacheProfile", "wrong values read: sums %g and %g instead of %g", learn.fSum, profile.fSum, written);
+      ++nerrors;
+   }
+   if (gSystem->AccessPathName(pname)) {
+      Error("testCacheProfile", "the profile was not saved");
+      ++nerrors;
+   }
+   if (learn.fLearnReads == 0) {
+      Error("testCacheProfile", "no read in the learning phase without a profile");
+      ++nerrors;
+   }
+   if (profile.fLearnReads != 0 || profile.fSaved <= 0) {
+      Error("testCacheProfile", "the profile did not skip the learning phase (%d learn reads, %d saved)",
+            profile.fLearnReads, profile.fSaved);
+      ++nerrors;
+   }
+   if (profile.fReadCalls >= learn.fReadCalls) {
+      Error("testCacheProfile", "%d read calls with the profile, %d without", profile.fReadCalls, learn.fReadCalls);
+      ++nerrors;
+   }
+
+   gSystem->Unlink(fname);
+   gSystem->Unlink(pname);
+   return nerrors ? 1 : 0;
+}
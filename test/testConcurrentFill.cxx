@@ -0,0 +1,179 @@
+// @(#)root/test:$Id$
+
+// This program checks the filling of a single histogram by several threads
+// through a TH1ConcurrentFillManager, each thread filling its share of the
+// values through its own TH1ConcurrentFiller (with the default buffer size
+// and with a small one, flushed many times). A TH1D, a TH2D, a TH3D and a
+// TProfile filled concurrently must have the entries, contents, errors and
+// statistics of the same histograms filled serially with Fill: exactly
+// for unit weights, up to the rounding errors due to the order of the
+// additions otherwise.
+//
+//  run with
+//     testConcurrentFill
+
+#include "TH1.h"
+#include "TH2.h"
+#include "TH3.h"
+#include "TProfile.h"
+#include "TH1ConcurrentFill.h"
+#include "TRandom3.h"
+#include "TMath.h"
+#include "TError.h"
+
+#include <thread>
+#include <vector>
+
+const Int_t kNvalues  = 200000;
+const Int_t kNthreads = 4;
+
+struct TValues {
+   std::vector<Double_t> fX;   // Values along x
+   std::vector<Double_t> fY;   // Values along y
+   std::vector<Double_t> fZ;   // Values along z
+   std::vector<Double_t> fW;   // Weights
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return n gaussian values, and weights in [0.5,1.5) or 1 if not weighted.
+
+static TValues MakeValues(Int_t n, Bool_t weighted)
+{
+   TRandom3 rnd(4357);
+   TValues v;
+   v.fX.resize(n);
+   v.fY.resize(n);
+   v.fZ.resize(n);
+   v.fW.resize(n);
+   for (Int_t i = 0; i < n; ++i) {
+      rnd.Rannor(v.fX[i], v.fY[i]);
+      v.fZ[i] = rnd.Gaus(0, 1);
+      v.fW[i] = weighted ? 0.5 + rnd.Rndm() : 1.;
+   }
+   return v;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if a and b are equal, up to the rounding errors if not exact.
+
+static Bool_t Close(Double_t a, Double_t b, Bool_t exact)
+{
+   if (exact) return a == b;
+   return TMath::Abs(a - b) <= 1e-9 * TMath::Max(1., TMath::Max(TMath::Abs(a), TMath::Abs(b)));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if the two histograms have the same entries, contents,
+/// errors and statistics.
+
+static Bool_t Same(const TH1 *a, const TH1 *b, Bool_t exact)
+{
+   if (a->GetEntries() != b->GetEntries()) return kFALSE;
+   for (Int_t bin = 0; bin < a->GetNcells(); ++bin) {
+      if (!Close(a->GetBinContent(bin), b->GetBinContent(bin), exact)) return kFALSE;
+      if (!Close(a->GetBinError(bin), b->GetBinError(bin), exact)) return kFALSE;
+   }
+   Double_t sa[13] = { 0 }, sb[13] = { 0 };
+   a->GetStats(sa);
+   b->GetStats(sb);
+   for (Int_t i = 0; i < 13; ++i) {
+      // The sums of the statistics depend on the order of the additions.
+      if (!Close(sa[i], sb[i], kFALSE)) return kFALSE;
+   }
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill the values [first,last) in h with Fill, or through filler if not 0.
+
+static void FillValues(TH1 *h, TH1ConcurrentFiller *filler, const TValues &v, Int_t first, Int_t last)
+{
+   Int_t dim = h->GetDimension();
+   Bool_t profile = h->InheritsFrom(TProfile::Class());
+   for (Int_t i = first; i < last; ++i) {
+      if (dim == 3) {
+         if (filler) filler->Fill(v.fX[i], v.fY[i], v.fZ[i], v.fW[i]);
+         else        ((TH3*)h)->Fill(v.fX[i], v.fY[i], v.fZ[i], v.fW[i]);
+      } else if (dim == 2) {
+         if (filler) filler->Fill(v.fX[i], v.fY[i], v.fW[i]);
+         else        ((TH2*)h)->Fill(v.fX[i], v.fY[i], v.fW[i]);
+      } else if (profile) {
+         if (filler) filler->Fill(v.fX[i], v.fY[i], v.fW[i]);
+         else        ((TProfile*)h)->Fill(v.fX[i], v.fY[i], v.fW[i]);
+      } else {
+         if (filler) filler->Fill(v.fX[i], v.fW[i]);
+         else        h->Fill(v.fX[i], v.fW[i]);
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill h with the values shared among the threads, with fillers buffering
+/// size values; return the number of errors.
+
+static Int_t CheckFill(TH1 *h, const TH1 *ref, const TValues &v, Int_t size, Bool_t exact)
+{
+   TH1ConcurrentFillManager manager(*h);
+   Int_t n = v.fX.size();
+   std::vector<std::thread> threads;
+   for (Int_t t = 0; t < kNthreads; ++t) {
+      Int_t first = (Long64_t)n * t / kNthreads;
+      Int_t last = (Long64_t)n * (t + 1) / kNthreads;
+      threads.push_back(std::thread([&manager, h, &v, first, last, size]() {
+         TH1ConcurrentFiller filler(manager, size);
+         FillValues(h, &filler, v, first, last);
+      }));
+   }
+   for (Int_t t = 0; t < kNthreads; ++t) threads[t].join();
+
+   Int_t nerrors = 0;
+   if (!Same(ref, h, exact)) {
+      Error("testConcurrentFill", "%s%s, buffer of %d: the concurrent filling differs from the serial one",
+            h->ClassName(), exact ? "" : " with weights", size);
+      ++nerrors;
+   }
+   if (manager.GetNFlushes() < (n + size - 1) / size) {
+      Error("testConcurrentFill", "%s, buffer of %d: %lld batches filled", h->ClassName(), size,
+            manager.GetNFlushes());
+      ++nerrors;
+   }
+   return nerrors;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return a new histogram of kind k.
+
+static TH1 *MakeHist(Int_t k)
+{
+   switch (k) {
+      case 0:  return new TH1D("h1", "", 1000, -4, 4);
+      case 1:  return new TH2D("h2", "", 100, -4, 4, 100, -4, 4);
+      case 2:  return new TH3D("h3", "", 20, -4, 4, 20, -4, 4, 20, -4, 4);
+      default: return new TProfile("hp", "", 1000, -4, 4);
+   }
+}
+
+int main()
+{
+   TH1::AddDirectory(kFALSE);
+
+   Int_t nerrors = 0;
+   for (Int_t weighted = 0; weighted < 2; ++weighted) {
+      TValues v = MakeValues(kNvalues, weighted);
+      for (Int_t k = 0; k < 4; ++k) {
+         TH1 *ref = MakeHist(k);
+         FillValues(ref, 0, v, 0, kNvalues);
+         // The contents of a profile are means, the sums of unit weights
+         // are exact otherwise.
+         Bool_t exact = !weighted && k != 3;
+         Int_t sizes[2] = { TH1ConcurrentFiller::kDefaultSize, 7 };
+         for (Int_t s = 0; s < 2; ++s) {
+            TH1 *h = MakeHist(k);
+            nerrors += CheckFill(h, ref, v, sizes[s], exact);
+            delete h;
+         }
+         delete ref;
+      }
+   }
+   return nerrors ? 1 : 0;
+}
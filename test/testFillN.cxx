@@ -0,0 +1,174 @@
+// @(#)root/test:$Id$
+
+// This program checks the bulk filling of histograms (see TH1::FillN,
+// TH2::FillN and TH3::FillN), which finds the bins of a chunk of values at
+// once with TAxis::FindFixBins:
+//  - TAxis::FindFixBins must give the bins of TAxis::FindFixBin for fix and
+//    variable bins, including values on the bin edges, in the underflow
+//    and overflow and NaN;
+//  - 1-D, 2-D and 3-D histograms, with fix and with variable bins, with and
+//    without weights, filled with FillN must have the same contents, errors
+//    and statistics as the ones filled one entry at a time with Fill.
+//
+//  run with
+//     testFillN
+
+#include "TAxis.h"
+#include "TH1.h"
+#include "TH2.h"
+#include "TH3.h"
+#include "TRandom3.h"
+#include "TMath.h"
+#include "TError.h"
+
+#include <vector>
+
+const Int_t kNvalues = 10000;
+
+struct TValues {
+   std::vector<Double_t> fX;   // Values along x
+   std::vector<Double_t> fY;   // Values along y
+   std::vector<Double_t> fZ;   // Values along z
+   std::vector<Double_t> fW;   // Weights
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return n random values in [-0.05,1.05) and weights in [0.5,1.5).
+
+static TValues MakeValues(Int_t n)
+{
+   TRandom3 rnd(4357);
+   TValues v;
+   v.fX.resize(n);
+   v.fY.resize(n);
+   v.fZ.resize(n);
+   v.fW.resize(n);
+   for (Int_t i = 0; i < n; ++i) {
+      v.fX[i] = -0.05 + 1.1 * rnd.Rndm();
+      v.fY[i] = -0.05 + 1.1 * rnd.Rndm();
+      v.fZ[i] = -0.05 + 1.1 * rnd.Rndm();
+      v.fW[i] = 0.5 + rnd.Rndm();
+   }
+   return v;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the nbins+1 edges of variable bins in [0,1], narrower near 0.
+
+static std::vector<Double_t> MakeEdges(Int_t nbins)
+{
+   std::vector<Double_t> edges(nbins + 1);
+   for (Int_t i = 0; i <= nbins; ++i) edges[i] = (Double_t)(i * i) / (nbins * nbins);
+   return edges;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Compare the bins found by FindFixBins and FindFixBin for the values and
+/// the edges of axis; return the number of errors.
+
+static Int_t CheckAxis(const char *name, const TAxis &axis, const TValues &v)
+{
+   std::vector<Double_t> x(v.fX);
+   for (Int_t bin = 1; bin <= axis.GetNbins() + 1; ++bin) x.push_back(axis.GetBinLowEdge(bin));
+   x.push_back(-1e300);
+   x.push_back(1e300);
+   x.push_back(TMath::QuietNaN());
+   std::vector<Int_t> bins(x.size());
+   axis.FindFixBins(x.size(), &x[0], &bins[0]);
+   for (size_t i = 0; i < x.size(); ++i) {
+      if (bins[i] != axis.FindFixBin(x[i])) {
+         Error("testFillN", "%s: FindFixBins gives bin %d for %g instead of %d", name, bins[i], x[i],
+               axis.FindFixBin(x[i]));
+         return 1;
+      }
+   }
+   return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if the two histograms have the same contents, errors and
+/// statistics.
+
+static Bool_t Same(const TH1 *a, const TH1 *b)
+{
+   if (a->GetEntries() != b->GetEntries()) return kFALSE;
+   Int_t ncells = a->GetNcells();
+   for (Int_t bin = 0; bin < ncells; ++bin) {
+      if (a->GetBinContent(bin) != b->GetBinContent(bin)) return kFALSE;
+      if (a->GetBinError(bin) != b->GetBinError(bin)) return kFALSE;
+   }
+   Double_t sa[13] = { 0 }, sb[13] = { 0 };
+   a->GetStats(sa);
+   b->GetStats(sb);
+   for (Int_t i = 0; i < 13; ++i) {
+      if (sa[i] != sb[i]) return kFALSE;
+   }
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill hfill with Fill and hfilln with FillN, with the weights if
+/// weighted; return the number of errors.
+
+static Int_t CheckFill(const char *name, TH1 *hfill, TH1 *hfilln, const TValues &v, Bool_t weighted)
+{
+   Int_t n = v.fX.size();
+   const Double_t *x = &v.fX[0];
+   const Double_t *y = &v.fY[0];
+   const Double_t *z = &v.fZ[0];
+   const Double_t *w = weighted ? &v.fW[0] : 0;
+   Int_t dim = hfill->GetDimension();
+   if (dim == 1) {
+      TH1 *h = hfill;
+      if (w) for (Int_t i = 0; i < n; ++i) h->Fill(x[i], w[i]);
+      else   for (Int_t i = 0; i < n; ++i) h->Fill(x[i]);
+      hfilln->FillN(n, x, w);
+   } else if (dim == 2) {
+      TH2 *h = (TH2*)hfill;
+      if (w) for (Int_t i = 0; i < n; ++i) h->Fill(x[i], y[i], w[i]);
+      else   for (Int_t i = 0; i < n; ++i) h->Fill(x[i], y[i]);
+      ((TH2*)hfilln)->FillN(n, x, y, w);
+   } else {
+      TH3 *h = (TH3*)hfill;
+      if (w) for (Int_t i = 0; i < n; ++i) h->Fill(x[i], y[i], z[i], w[i]);
+      else   for (Int_t i = 0; i < n; ++i) h->Fill(x[i], y[i], z[i]);
+      ((TH3*)hfilln)->FillN(n, x, y, z, w);
+   }
+   Int_t nerrors = 0;
+   if (!Same(hfill, hfilln)) {
+      Error("testFillN", "%s%s: FillN differs from Fill", name, weighted ? ", weights" : "");
+      ++nerrors;
+   }
+   delete hfill;
+   delete hfilln;
+   return nerrors;
+}
+
+int main()
+{
+   TH1::AddDirectory(kFALSE);
+   TValues v = MakeValues(kNvalues);
+   std::vector<Double_t> e100 = MakeEdges(100);
+   std::vector<Double_t> e20 = MakeEdges(20);
+
+   Int_t nerrors = 0;
+   nerrors += CheckAxis("fix bins", TAxis(100, 0, 1), v);
+   nerrors += CheckAxis("variable bins", TAxis(100, &e100[0]), v);
+   nerrors += CheckAxis("variable bins", TAxis(20, &e20[0]), v);
+
+   for (Int_t weighted = 0; weighted < 2; ++weighted) {
+      nerrors += CheckFill("TH1D fix", new TH1D("a", "", 100, 0, 1), new TH1D("b", "", 100, 0, 1), v, weighted);
+      nerrors += CheckFill("TH1F fix", new TH1F("a", "", 100, 0, 1), new TH1F("b", "", 100, 0, 1), v, weighted);
+      nerrors += CheckFill("TH1D variable", new TH1D("a", "", 100, &e100[0]), new TH1D("b", "", 100, &e100[0]),
+                           v, weighted);
+      nerrors += CheckFill("TH2D fix", new TH2D("a", "", 100, 0, 1, 100, 0, 1),
+                           new TH2D("b", "", 100, 0, 1, 100, 0, 1), v, weighted);
+      nerrors += CheckFill("TH2F variable", new TH2F("a", "", 100, &e100[0], 100, &e100[0]),
+                           new TH2F("b", "", 100, &e100[0], 100, &e100[0]), v, weighted);
+      nerrors += CheckFill("TH3D fix", new TH3D("a", "", 20, 0, 1, 20, 0, 1, 20, 0, 1),
+                           new TH3D("b", "", 20, 0, 1, 20, 0, 1, 20, 0, 1), v, weighted);
+      nerrors += CheckFill("TH3F variable", new TH3F("a", "", 20, &e20[0], 20, &e20[0], 20, &e20[0]),
+                           new TH3F("b", "", 20, &e20[0], 20, &e20[0], 20, &e20[0]), v, weighted);
+   }
+   return nerrors ? 1 : 0;
+}
@@ -0,0 +1,218 @@
+// @(#)root/test:$Id$
+
+// This program checks the execution policies of ROOT::Fit::Fitter (see
+// ROOT::Fit::ExecutionPolicy):
+//  - an unbinned likelihood fit of a model re-implementing DoEvalBatch must
+//    give exactly the same result on batches of points (kVectorized) and on
+//    batches evaluated by 1, 2 or 4 threads (kMultiThread), and agree with
+//    the serial fit (kSerial) within a small fraction of the errors;
+//  - the chi2 and the Poisson likelihood of a histogram for a compiled TF1
+//    and for an interpreted TF1 must be the same with all the policies. The
+//    interpreted function is not thread safe and must be evaluated in a
+//    single thread when kMultiThread is requested, and its fits with
+//    kMultiThread and kVectorized must give the same result.
+//
+//  run with
+//     testFitPolicy
+
+#include "Fit/Fitter.h"
+#include "Fit/BinData.h"
+#include "Fit/UnBinData.h"
+#include "Fit/FitResult.h"
+#include "Fit/FitUtil.h"
+#include "Math/IParamFunction.h"
+#include "Math/WrappedMultiTF1.h"
+#include "HFitInterface.h"
+#include "TInterpreter.h"
+#include "TMethodCall.h"
+#include "TF1.h"
+#include "TH1D.h"
+#include "TRandom3.h"
+#include "TError.h"
+
+#include <cmath>
+#include <algorithm>
+
+const double kXmax = 10;
+const double kInvSqrt2Pi = 0.3989422804014327;
+
+////////////////////////////////////////////////////////////////////////////////
+/// Gaussian signal over an exponential background, normalized in [0,kXmax].
+/// The parameters are the signal fraction, the mean and the sigma of the
+/// Gaussian and the slope of the exponential.
+
+class GausExpPdf : public ROOT::Math::IParamMultiFunction {
+
+public:
+   GausExpPdf() { fParams[0] = 0.5; fParams[1] = 4.5; fParams[2] = 1.5; fParams[3] = 2; }
+
+   ROOT::Math::IMultiGenFunction *Clone() const
+   {
+      GausExpPdf *f = new GausExpPdf();
+      f->SetParameters(fParams);
+      return f;
+   }
+
+   unsigned int NDim() const { return 1; }
+   unsigned int NPar() const { return 4; }
+   const double *Parameters() const { return fParams; }
+   void SetParameters(const double *p) { std::copy(p, p + 4, fParams); }
+
+   static double ExpNorm(const double *p) { return 1. / (p[3] * (1 - std::exp(-kXmax / p[3]))); }
+
+   static double Pdf(double x, const double *p, double expNorm)
+   {
+      double t = (x - p[1]) / p[2];
+      return p[0] * kInvSqrt2Pi / p[2] * std::exp(-0.5 * t * t) + (1 - p[0]) * expNorm * std::exp(-x / p[3]);
+   }
+
+private:
+   double DoEvalPar(const double *x, const double *p) const { return Pdf(x[0], p, ExpNorm(p)); }
+
+   void DoEvalBatch(unsigned int n, const double * const *x, const double *p, double *f) const
+   {
+      double expNorm = ExpNorm(p);
+      for (unsigned int i = 0; i < n; ++i) f[i] = Pdf(x[i][0], p, expNorm);
+   }
+
+   double fParams[4];
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if the two fits have exactly the same result.
+
+static bool Same(const ROOT::Fit::FitResult &r1, const ROOT::Fit::FitResult &r2)
+{
+   if (r1.MinFcnValue() != r2.MinFcnValue()) return false;
+   for (unsigned int i = 0; i < r1.NPar(); ++i) {
+      if (r1.Parameter(i) != r2.Parameter(i)) return false;
+   }
+   return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fit the Gaussian over exponential model to an unbinned data set with all
+/// the policies; return the number of errors.
+
+static Int_t CheckUnbinned()
+{
+   const Int_t nevents = 100000;
+   ROOT::Fit::UnBinData data(nevents);
+   TRandom3 rnd(4357);
+   for (Int_t i = 0; i < nevents; ++i) {
+      double x = -1;
+      while (x < 0 || x > kXmax) x = (rnd.Rndm() < 0.3) ? rnd.Gaus(5, 1) : rnd.Exp(3);
+      data.Add(x);
+   }
+
+   const ROOT::Fit::ExecutionPolicy policies[] = { ROOT::Fit::kSerial, ROOT::Fit::kVectorized,
+      ROOT::Fit::kMultiThread, ROOT::Fit::kMultiThread, ROOT::Fit::kMultiThread };
+   const unsigned int nthreads[] = { 0, 0, 1, 2, 4 };
+   ROOT::Fit::FitResult results[5];
+   Int_t nerrors = 0;
+   for (Int_t i = 0; i < 5; ++i) {
+      GausExpPdf pdf;
+      ROOT::Fit::Fitter fitter;
+      fitter.SetFunction(pdf);
+      fitter.Config().ParSettings(0).SetLimits(0, 1);
+      fitter.Config().ParSettings(2).SetLimits(0.1, 5);
+      fitter.Config().ParSettings(3).SetLimits(0.5, 20);
+      fitter.SetExecutionPolicy(policies[i], nthreads[i]);
+      if (!fitter.Fit(data)) {
+         Error("testFitPolicy", "unbinned fit %d failed", i);
+         ++nerrors;
+      }
+      results[i] = fitter.Result();
+   }
+   for (Int_t i = 2; i < 5; ++i) {
+      if (!Same(results[1], results[i])) {
+         Error("testFitPolicy", "unbinned fit with %u threads differs from the vectorized fit", nthreads[i]);
+         ++nerrors;
+      }
+   }
+   for (unsigned int k = 0; k < results[0].NPar(); ++k) {
+      if (std::abs(results[0].Parameter(k) - results[1].Parameter(k)) > 1e-3 * results[0].Error(k)) {
+         Error("testFitPolicy", "parameter %u of the serial and vectorized unbinned fits differ", k);
+         ++nerrors;
+      }
+   }
+   return nerrors;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Evaluate the chi2 and the Poisson likelihood of the histogram data for f
+/// with all the policies and fit it with kVectorized and kMultiThread;
+/// return the number of errors.
+
+static Int_t CheckTF1(TF1 &f, bool threadSafe, const ROOT::Fit::BinData &data)
+{
+   Int_t nerrors = 0;
+   ROOT::Math::WrappedMultiTF1 wf(f, 1);
+   if (wf.IsThreadSafe() != threadSafe) {
+      Error("testFitPolicy", "%s: IsThreadSafe is %d", f.GetName(), wf.IsThreadSafe());
+      ++nerrors;
+   }
+
+   const double *p = f.GetParameters();
+   unsigned int npoints;
+   double chi2[3], logl[3];
+   const ROOT::Fit::ExecutionPolicy policies[] = { ROOT::Fit::kSerial, ROOT::Fit::kVectorized,
+      ROOT::Fit::kMultiThread };
+   for (Int_t i = 0; i < 3; ++i) {
+      chi2[i] = ROOT::Fit::FitUtil::EvaluateChi2(wf, data, p, npoints, policies[i], 4);
+      logl[i] = ROOT::Fit::FitUtil::EvaluatePoissonLogL(wf, data, p, 0, true, npoints, policies[i], 4);
+   }
+   if (chi2[2] != chi2[1] || logl[2] != logl[1]) {
+      Error("testFitPolicy", "%s: the threaded evaluation differs from the vectorized one", f.GetName());
+      ++nerrors;
+   }
+   if (std::abs(chi2[0] - chi2[1]) > 1e-10 * chi2[0] || std::abs(logl[0] - logl[1]) > 1e-10 * std::abs(logl[0])) {
+      Error("testFitPolicy", "%s: the vectorized evaluation differs from the serial one", f.GetName());
+      ++nerrors;
+   }
+
+   ROOT::Fit::FitResult results[2];
+   for (Int_t i = 0; i < 2; ++i) {
+      ROOT::Fit::Fitter fitter;
+      fitter.SetFunction(static_cast<const ROOT::Math::IParamMultiFunction &>(wf));
+      fitter.SetExecutionPolicy(policies[i + 1], 4);
+      if (!fitter.Fit(data)) {
+         Error("testFitPolicy", "%s: chi2 fit %d failed", f.GetName(), i);
+         ++nerrors;
+      }
+      results[i] = fitter.Result();
+   }
+   if (!Same(results[0], results[1])) {
+      Error("testFitPolicy", "%s: the threaded chi2 fit differs from the vectorized one", f.GetName());
+      ++nerrors;
+   }
+   return nerrors;
+}
+
+int main()
+{
+   Int_t nerrors = CheckUnbinned();
+
+   TH1D h("h", "Histogram for the fit policy test", 5000, -5, 5);
+   h.SetDirectory(0);
+   TRandom3 rnd(4357);
+   for (Int_t i = 0; i < 1000000; ++i) h.Fill(rnd.Gaus(0.5, 1.2));
+   ROOT::Fit::BinData data;
+   ROOT::Fit::FillData(data, &h);
+
+   TF1 fc("compiled", "[0]*exp(-0.5*((x-[1])/[2])^2)", -5, 5);
+   fc.SetParameters(700, 0, 1);
+   nerrors += CheckTF1(fc, true, data);
+
+   gInterpreter->Declare("double testFitPolicyGaus(double *x, double *p) {"
+                         "  double t = (x[0] - p[1]) / p[2]; return p[0] * exp(-0.5 * t * t); }");
+   TF1 fi("testFitPolicyGaus", -5, 5, 3);
+   if (!fi.GetMethodCall() || !fi.GetMethodCall()->IsValid()) {
+      Error("testFitPolicy", "can not create the interpreted function");
+      return 1;
+   }
+   fi.SetParameters(700, 0, 1);
+   nerrors += CheckTF1(fi, false, data);
+
+   return nerrors ? 1 : 0;
+}
@@ -0,0 +1,182 @@
+// @(#)root/test:$Id$
+
+// This program checks the key index of the directories read from a file
+// (see TDirectoryFile::SetKeyIndexThreshold), which creates only the TKeys
+// of the objects looked up. The keys found by GetKey, FindKey and Get with
+// the index, for random names, for several cycles and for missing names,
+// in the top directory and in a subdirectory, must be the ones found by a
+// linear scan of the list of keys read without the index; once the index
+// is dropped, the list of keys must be the same as without the index.
+//
+//  run with
+//     testKeyIndex
+
+#include "TFile.h"
+#include "TDirectoryFile.h"
+#include "TKey.h"
+#include "TNamed.h"
+#include "TList.h"
+#include "TRandom3.h"
+#include "TString.h"
+#include "TSystem.h"
+#include "TError.h"
+
+#include <string.h>
+#include <string>
+#include <vector>
+
+const char *kFileName = "testKeyIndex.root";
+const Int_t kNkeys    = 3000;
+const Int_t kNcycles  = 3;      // Number of cycles of one name out of ten
+const Int_t kNlookups = 2000;
+
+struct TKeyRecord {
+   std::string fName;     // Name of the key
+   Short_t     fCycle;    // Cycle of the key
+   Long64_t    fSeekKey;  // Position of the key in the file
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write nkeys TNamed objects in dir, one name out of ten with kNcycles
+/// cycles.
+
+static void WriteKeys(TDirectory *dir, Int_t nkeys)
+{
+   dir->cd();
+   for (Int_t i = 0; i < nkeys; ++i) {
+      Int_t ncycles = (i % 10 == 0) ? kNcycles : 1;
+      for (Int_t c = 1; c <= ncycles; ++c) {
+         TNamed obj(Form("obj_%d", i), Form("title %d cycle %d", i, c));
+         obj.Write();
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the records of the keys of dir, in the order of its list of keys.
+
+static std::vector<TKeyRecord> ListKeys(TDirectory *dir)
+{
+   std::vector<TKeyRecord> keys;
+   TIter next(dir->GetListOfKeys());
+   TKey *key;
+   while ((key = (TKey*) next())) {
+      TKeyRecord rec = { key->GetName(), key->GetCycle(), key->GetSeekKey() };
+      keys.push_back(rec);
+   }
+   return keys;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the index in keys of the key name with the highest cycle not
+/// greater than cycle (any cycle if 9999), -1 if none.
+
+static Int_t LinearScan(const std::vector<TKeyRecord> &keys, const char *name, Short_t cycle)
+{
+   Int_t found = -1;
+   for (size_t i = 0; i < keys.size(); ++i) {
+      if (keys[i].fName != name) continue;
+      if (cycle != 9999 && keys[i].fCycle > cycle) continue;
+      if (found < 0 || keys[i].fCycle > keys[found].fCycle) found = i;
+   }
+   return found;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Look up random keys in dir, read with the index, and compare them with
+/// the linear scan of ref; return the number of errors.
+
+static Int_t CheckLookups(const char *where, TDirectory *dir, const std::vector<TKeyRecord> &ref, Int_t nkeys)
+{
+   Int_t nerrors = 0;
+   if (dir->GetNkeys() != Int_t(ref.size())) {
+      Error("testKeyIndex", "%s: %d keys instead of %d", where, dir->GetNkeys(), Int_t(ref.size()));
+      ++nerrors;
+   }
+   TRandom3 rnd(4357);
+   const Short_t cycles[4] = { 9999, 1, 2, 5 };
+   Int_t nwrong = 0;
+   for (Int_t l = 0; l < kNlookups; ++l) {
+      // One name out of eight is missing.
+      Int_t i = rnd.Integer(nkeys * 8 / 7);
+      TString name = TString::Format("obj_%d", i);
+      Short_t cycle = cycles[rnd.Integer(4)];
+      Int_t expected = LinearScan(ref, name, cycle);
+
+      TKey *key = dir->GetKey(name, cycle);
+      TString namecycle = cycle == 9999 ? name : TString::Format("%s;%d", name.Data(), cycle);
+      TKey *found = dir->FindKey(namecycle);
+      if (expected < 0) {
+         if (key || found || dir->Get(namecycle)) ++nwrong;
+         continue;
+      }
+      if (!key || key != found || key->GetCycle() != ref[expected].fCycle
+          || key->GetSeekKey() != ref[expected].fSeekKey) {
+         ++nwrong;
+         continue;
+      }
+      TNamed *obj = (TNamed*) dir->Get(namecycle);
+      if (!obj || strcmp(obj->GetTitle(), Form("title %d cycle %d", i, ref[expected].fCycle))) ++nwrong;
+      delete obj;
+   }
+   if (nwrong) {
+      Error("testKeyIndex", "%s: %d lookups differ from the linear scan", where, nwrong);
+      ++nerrors;
+   }
+
+   // Dropping the index creates all the keys, in the order of the file.
+   std::vector<TKeyRecord> keys = ListKeys(dir);
+   Bool_t same = keys.size() == ref.size();
+   for (size_t k = 0; same && k < keys.size(); ++k) {
+      same = keys[k].fName == ref[k].fName && keys[k].fCycle == ref[k].fCycle && keys[k].fSeekKey == ref[k].fSeekKey;
+   }
+   if (!same) {
+      Error("testKeyIndex", "%s: the list of keys differs from the one read without the index", where);
+      ++nerrors;
+   }
+   return nerrors;
+}
+
+int main()
+{
+   {
+      TFile file(kFileName, "RECREATE");
+      TDirectory *sub = file.mkdir("sub");
+      WriteKeys(&file, kNkeys);
+      WriteKeys(sub, kNkeys / 2);
+      file.Write();
+   }
+
+   // The keys read without the index.
+   TDirectoryFile::SetKeyIndexThreshold(0);
+   TFile *file = TFile::Open(kFileName);
+   if (!file || file->IsZombie()) {
+      Error("testKeyIndex", "can not open %s", kFileName);
+      return 1;
+   }
+   std::vector<TKeyRecord> top = ListKeys(file);
+   std::vector<TKeyRecord> sub = ListKeys(file->GetDirectory("sub"));
+   delete file;
+
+   Int_t nerrors = 0;
+   TDirectoryFile::SetKeyIndexThreshold(100);
+   file = TFile::Open(kFileName);
+   if (!file || file->IsZombie()) {
+      Error("testKeyIndex", "can not open %s with the key index", kFileName);
+      ++nerrors;
+   } else {
+      TDirectory *dir = file->GetDirectory("sub");
+      if (!dir) {
+         Error("testKeyIndex", "can not read the subdirectory");
+         ++nerrors;
+      } else {
+         nerrors += CheckLookups("sub", dir, sub, kNkeys / 2);
+      }
+      nerrors += CheckLookups("top", file, top, kNkeys);
+   }
+   delete file;
+
+   TDirectoryFile::SetKeyIndexThreshold(0);
+   gSystem->Unlink(kFileName);
+   return nerrors ? 1 : 0;
+}
@@ -0,0 +1,110 @@
+// @(#)root/test:$Id$
+
+// This program checks the reading of local files opened with the option
+// "MMAP" of TFile, with which the keys and the baskets are unzipped straight
+// from the mapped pages and the uncompressed baskets are used in place.
+// A tree and a histogram are written compressed and uncompressed; both
+// must read back identical to what was written.
+//
+//  run with
+//     testReadMmap
+
+#include "TFile.h"
+#include "TTree.h"
+#include "TH1D.h"
+#include "TSystem.h"
+#include "TError.h"
+
+const Int_t kMaxTracks = 20;
+const Long64_t kEntries = 50000;
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write the tree and the histogram with the given compression level.
+
+static void WriteFile(const char *fname, Int_t compress)
+{
+   TFile file(fname, "RECREATE", "", compress);
+   TTree *tree = new TTree("T", "Tree for the memory mapped read test");
+   Int_t n;
+   Double_t px[kMaxTracks];
+   tree->Branch("n", &n, "n/I");
+   tree->Branch("px", px, "px[n]/D");
+   TH1D *h = new TH1D("h", "Histogram for the memory mapped read test", 100, 0, kEntries);
+   for (Long64_t entry = 0; entry < kEntries; ++entry) {
+      n = entry % (kMaxTracks + 1);
+      for (Int_t t = 0; t < n; ++t) px[t] = entry + 0.25 * t;
+      tree->Fill();
+      h->Fill(entry, n);
+   }
+   file.Write();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read back fname opened with the option MMAP; return the number of errors.
+
+static Int_t ReadFile(const char *fname)
+{
+   TFile *file = TFile::Open(fname, "MMAP");
+   if (!file || file->IsZombie()) {
+      Error("testReadMmap", "can not open %s", fname);
+      delete file;
+      return 1;
+   }
+   Int_t nerrors = 0;
+   if (!file->IsMapped()) {
+      Error("testReadMmap", "%s is not mapped", fname);
+      ++nerrors;
+   }
+
+   Double_t sumw = 0;
+   for (Long64_t entry = 0; entry < kEntries; ++entry) sumw += entry % (kMaxTracks + 1);
+   TH1D *h = 0;
+   file->GetObject("h", h);
+   if (!h || h->GetEntries() != kEntries || h->GetSumOfWeights() != sumw) {
+      Error("testReadMmap", "%s: the histogram read is wrong", fname);
+      ++nerrors;
+   }
+
+   TTree *tree = 0;
+   file->GetObject("T", tree);
+   if (!tree || tree->GetEntries() != kEntries) {
+      Error("testReadMmap", "%s: can not read the tree", fname);
+      delete file;
+      return nerrors + 1;
+   }
+   Int_t n;
+   Double_t px[kMaxTracks];
+   tree->SetBranchAddress("n", &n);
+   tree->SetBranchAddress("px", px);
+   Long64_t nwrong = 0;
+   for (Long64_t entry = 0; entry < kEntries; ++entry) {
+      tree->GetEntry(entry);
+      if (n != entry % (kMaxTracks + 1)) {
+         ++nwrong;
+         continue;
+      }
+      for (Int_t t = 0; t < n; ++t) {
+         if (px[t] != entry + 0.25 * t) ++nwrong;
+      }
+   }
+   if (nwrong) {
+      Error("testReadMmap", "%s: %lld values of the tree read wrong", fname, nwrong);
+      ++nerrors;
+   }
+   delete file;
+   return nerrors;
+}
+
+int main()
+{
+   const char *fzip = "testReadMmap_zip.root";
+   const char *fraw = "testReadMmap_raw.root";
+   WriteFile(fzip, 1);
+   WriteFile(fraw, 0);
+
+   Int_t nerrors = ReadFile(fzip) + ReadFile(fraw);
+
+   gSystem->Unlink(fzip);
+   gSystem->Unlink(fraw);
+   return nerrors ? 1 : 0;
+}
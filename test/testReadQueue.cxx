@@ -0,0 +1,148 @@
+// @(#)root/test:$Id$
+
+// This program checks the parallel positional reads of local files (see
+// TFile::SetReadQueueDepth): blocks read by TFile::ReadBuffers with several
+// requests in flight, including a block larger than a request and blocks
+// out of order, must be identical to the ones read one after the other,
+// and a tree read through the TTreeCache with parallel reads must give
+// back the values written.
+//
+//  run with
+//     testReadQueue
+
+#include "TFile.h"
+#include "TTree.h"
+#include "TTreePerfStats.h"
+#include "TRandom3.h"
+#include "TSystem.h"
+#include "TError.h"
+#include "TMath.h"
+
+#include <string.h>
+#include <vector>
+
+const Int_t kMaxTracks = 50;
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read the blocks pos/len of fname with the given queue depth into buf.
+
+static Bool_t ReadBlocks(const char *fname, Int_t depth, std::vector<Long64_t> &pos, std::vector<Int_t> &len,
+                         std::vector<char> &buf)
+{
+   TFile::SetReadQueueDepth(depth);
+   TFile *file = TFile::Open(fname);
+   if (!file || file->IsZombie()) {
+      delete file;
+      return kFALSE;
+   }
+   Long64_t size = 0;
+   for (size_t i = 0; i < len.size(); ++i) size += len[i];
+   buf.assign(size, 0);
+   Bool_t failed = file->ReadBuffers(&buf[0], &pos[0], &len[0], pos.size());
+   delete file;
+   return !failed;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read all the entries of fname through the TTreeCache with the given
+/// queue depth; return the number of values different from the ones
+/// written (generated again from the same seed), -1 in case of error.
+
+static Long64_t ReadTree(const char *fname, Int_t depth, Int_t &nvectors)
+{
+   TFile::SetReadQueueDepth(depth);
+   TFile *file = TFile::Open(fname);
+   TTree *tree = 0;
+   if (file) file->GetObject("T", tree);
+   if (!tree) {
+      delete file;
+      return -1;
+   }
+   Int_t n;
+   Float_t px[kMaxTracks];
+   tree->SetBranchAddress("n", &n);
+   tree->SetBranchAddress("px", px);
+   tree->SetCacheSize(1000000);
+   tree->AddBranchToCache("*", kTRUE);
+   TTreePerfStats ps("ioperf", tree);
+
+   TRandom3 rnd(4357);
+   Long64_t nwrong = 0;
+   for (Long64_t entry = 0; entry < tree->GetEntries(); ++entry) {
+      tree->GetEntry(entry);
+      Int_t nexp = rnd.Integer(kMaxTracks + 1);
+      if (n != nexp) {
+         ++nwrong;
+         continue;
+      }
+      for (Int_t t = 0; t < n; ++t) {
+         if (px[t] != Float_t(rnd.Gaus(0, 1))) ++nwrong;
+      }
+   }
+   nvectors = ps.GetReadVectors();
+   tree->SetPerfStats(0);
+   delete file;
+   return nwrong;
+}
+
+int main()
+{
+   const char *fname = "testReadQueue.root";
+   const Long64_t nentries = 100000;
+
+   {
+      TRandom3 rnd(4357);
+      TFile file(fname, "RECREATE");
+      TTree tree("T", "Tree for the read queue test");
+      Int_t n;
+      Float_t px[kMaxTracks];
+      tree.Branch("n", &n, "n/I");
+      tree.Branch("px", px, "px[n]/F");
+      for (Long64_t entry = 0; entry < nentries; ++entry) {
+         n = rnd.Integer(kMaxTracks + 1);
+         for (Int_t t = 0; t < n; ++t) px[t] = rnd.Gaus(0, 1);
+         tree.Fill();
+      }
+      file.Write();
+   }
+
+   Int_t nerrors = 0;
+
+   // A block of 3 MBytes, split in several requests, then small blocks in
+   // decreasing order and the last bytes of the file.
+   Long64_t fsize = 0;
+   gSystem->GetPathInfo(fname, (Long_t*)0, &fsize, (Long_t*)0, (Long_t*)0);
+   std::vector<Long64_t> pos;
+   std::vector<Int_t> len;
+   pos.push_back(100);
+   len.push_back(Int_t(TMath::Min(fsize - 200, Long64_t(3000000))));
+   for (Long64_t p = fsize / 2; p > 1000; p -= fsize / 7) {
+      pos.push_back(p);
+      len.push_back(777);
+   }
+   pos.push_back(fsize - 10);
+   len.push_back(10);
+   std::vector<char> serial, parallel;
+   if (!ReadBlocks(fname, 0, pos, len, serial) || !ReadBlocks(fname, 8, pos, len, parallel)) {
+      Error("testReadQueue", "ReadBuffers failed");
+      ++nerrors;
+   } else if (serial.size() != parallel.size() || memcmp(&serial[0], &parallel[0], serial.size())) {
+      Error("testReadQueue", "the blocks read in parallel differ from the ones read sequentially");
+      ++nerrors;
+   }
+
+   Int_t nvectors = 0;
+   Long64_t nwrong = ReadTree(fname, 8, nvectors);
+   if (nwrong) {
+      Error("testReadQueue", "reading the tree with parallel reads: %lld values wrong", nwrong);
+      ++nerrors;
+   }
+   if (!nvectors) {
+      Error("testReadQueue", "the tree was not read with parallel reads");
+      ++nerrors;
+   }
+
+   TFile::SetReadQueueDepth(0);
+   gSystem->Unlink(fname);
+   return nerrors ? 1 : 0;
+}
@@ -0,0 +1,165 @@
+// @(#)root/test:$Id$
+
+// This program checks the batch evaluation of the p.d.f.s on the columns of
+// a dataset (see RooAbsReal::getValBatch and RooFit::BatchMode). The model
+// is a Gaussian signal over an exponential background in x times a
+// polynomial in y, built with RooAddPdf and RooProdPdf:
+//  - the values of every p.d.f. of the model evaluated on batches of events
+//    must be the ones calculated event by event;
+//  - the likelihood must be the same with and without batch evaluation for
+//    several values of the parameters, also for a model whose mean depends
+//    on y, which is evaluated event by event;
+//  - the fits with and without batch evaluation must agree within a small
+//    fraction of the parameter errors.
+//
+//  run with
+//     testRooFitBatch
+
+#include "RooRealVar.h"
+#include "RooFormulaVar.h"
+#include "RooGaussian.h"
+#include "RooExponential.h"
+#include "RooPolynomial.h"
+#include "RooAddPdf.h"
+#include "RooProdPdf.h"
+#include "RooDataSet.h"
+#include "RooVectorDataStore.h"
+#include "RooFitResult.h"
+#include "RooGlobalFunc.h"
+#include "RooMsgService.h"
+#include "RooRandom.h"
+#include "TError.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace RooFit;
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if a and b agree within the relative precision eps.
+
+static Bool_t Equal(Double_t a, Double_t b, Double_t eps)
+{
+   return std::abs(a - b) <= eps * std::max(std::abs(a), std::abs(b));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Compare the likelihood of model for data with and without batch
+/// evaluation for several values of mean; return the number of errors.
+
+static Int_t CheckNLL(const char *name, RooAbsPdf &model, RooDataSet &data, RooRealVar &mean)
+{
+   RooAbsReal *nllEvent = model.createNLL(data, BatchMode(kFALSE));
+   RooAbsReal *nllBatch = model.createNLL(data, BatchMode(kTRUE));
+   Double_t mean0 = mean.getVal();
+   Int_t nerrors = 0;
+   for (Int_t i = 0; i < 5; ++i) {
+      mean.setVal(mean0 + 0.05 * i);
+      Double_t event = nllEvent->getVal();
+      Double_t batch = nllBatch->getVal();
+      if (!Equal(event, batch, 1e-9)) {
+         Error("testRooFitBatch", "%s: likelihood %.10g in batches instead of %.10g for mean %g", name, batch,
+               event, mean.getVal());
+         ++nerrors;
+      }
+   }
+   mean.setVal(mean0);
+   delete nllEvent;
+   delete nllBatch;
+   return nerrors;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Compare the values of pdf for all the events of data, evaluated on
+/// batches and event by event; pdf must be attached to data. Return the
+/// number of errors.
+
+static Int_t CheckValues(const RooAbsPdf &pdf, const RooDataSet &data)
+{
+   const RooVectorDataStore *store = dynamic_cast<const RooVectorDataStore*>(data.store());
+   if (!store) {
+      Error("testRooFitBatch", "the dataset is not stored in a RooVectorDataStore");
+      return 1;
+   }
+   const RooArgSet *normSet = data.get();
+   Int_t n = data.numEntries();
+   std::vector<Double_t> batch(n);
+   const Int_t kBatchSize = 1000;
+   for (Int_t first = 0; first < n; first += kBatchSize) {
+      pdf.getValBatch(&batch[first], first, std::min(kBatchSize, n - first), *store, normSet);
+   }
+   Int_t nwrong = 0;
+   for (Int_t i = 0; i < n; ++i) {
+      data.get(i);
+      if (!Equal(pdf.getVal(normSet), batch[i], 1e-12)) ++nwrong;
+   }
+   if (nwrong) Error("testRooFitBatch", "%s: %d of %d values wrong in batches", pdf.GetName(), nwrong, n);
+   return nwrong ? 1 : 0;
+}
+
+int main()
+{
+   RooMsgService::instance().setGlobalKillBelow(RooFit::WARNING);
+   RooRandom::randomGenerator()->SetSeed(4357);
+
+   RooRealVar x("x", "x", 0, 10);
+   RooRealVar y("y", "y", -1, 1);
+   RooRealVar mean("mean", "mean", 5, 0, 10);
+   RooRealVar sigma("sigma", "sigma", 1, 0.1, 5);
+   RooRealVar c("c", "c", -0.3, -2., 0.);
+   RooRealVar frac("frac", "frac", 0.3, 0, 1);
+   RooRealVar a1("a1", "a1", 0.3, -1, 1);
+   RooGaussian sig("sig", "signal", x, mean, sigma);
+   RooExponential bkg("bkg", "background", x, c);
+   RooAddPdf sum("sum", "signal + background", RooArgList(sig, bkg), RooArgList(frac));
+   RooPolynomial poly("poly", "polynomial in y", y, RooArgList(a1));
+   RooProdPdf model("model", "model", RooArgList(sum, poly));
+
+   // Same model with a mean depending on the observable y.
+   RooFormulaVar meany("meany", "mean + 0.2 * y", RooArgList(mean, y));
+   RooGaussian sigy("sigy", "signal with a mean depending on y", x, meany, sigma);
+   RooAddPdf sumy("sumy", "signal + background", RooArgList(sigy, bkg), RooArgList(frac));
+   RooProdPdf modely("modely", "model with a mean depending on y", RooArgList(sumy, poly));
+
+   RooDataSet *data = model.generate(RooArgSet(x, y), 20000);
+   RooArgSet params(mean, sigma, c, frac, a1);
+   mean.setVal(4.8);
+   sigma.setVal(1.2);
+   frac.setVal(0.35);
+   RooArgSet *init = (RooArgSet*)params.snapshot();
+
+   Int_t nerrors = CheckNLL("model", model, *data, mean) + CheckNLL("modely", modely, *data, mean);
+
+   RooFitResult *result[2];
+   for (Int_t batch = 0; batch < 2; ++batch) {
+      params = *init;
+      result[batch] = model.fitTo(*data, BatchMode(batch), Save(), PrintLevel(-1));
+      if (!result[batch] || result[batch]->status() != 0) {
+         Error("testRooFitBatch", "the fit %s batch evaluation failed", batch ? "with" : "without");
+         ++nerrors;
+      }
+   }
+   if (result[0] && result[1]) {
+      const RooArgList &p0 = result[0]->floatParsFinal();
+      const RooArgList &p1 = result[1]->floatParsFinal();
+      for (Int_t i = 0; i < p0.getSize(); ++i) {
+         const RooRealVar *v0 = (const RooRealVar*)p0.at(i);
+         const RooRealVar *v1 = (const RooRealVar*)p1.find(v0->GetName());
+         if (!v1 || std::abs(v0->getVal() - v1->getVal()) > 1e-3 * v0->getError()) {
+            Error("testRooFitBatch", "the fits with and without batch evaluation differ for %s", v0->GetName());
+            ++nerrors;
+         }
+      }
+   }
+
+   params = *init;
+   model.attachDataSet(*data);
+   RooAbsPdf *pdfs[] = { &sig, &bkg, &sum, &poly, &model };
+   for (Int_t i = 0; i < 5; ++i) nerrors += CheckValues(*pdfs[i], *data);
+
+   delete result[0];
+   delete result[1];
+   delete init;
+   delete data;
+   return nerrors ? 1 : 0;
+}
@@ -0,0 +1,162 @@
+// @(#)root/test:$Id$
+
+// This program checks the calculation of the likelihood in parallel threads
+// (see RooFit::NumThreads) against the calculation in one thread, for
+//  - an extended Gaussian signal over an exponential background, whose
+//    events are split in slices calculated in parallel;
+//  - a Gaussian signal over a background without analytical integral, whose
+//    normalization is a numeric integral calculated in each thread;
+//  - a simultaneous p.d.f. of three channels with this background, whose
+//    components are calculated in parallel.
+// The likelihood must be the same in 1, 2 and 4 threads for several values
+// of the parameters, the calculations must have been done in threads and
+// the fits in one and in four threads must agree within a small fraction of
+// the parameter errors.
+//
+//  run with
+//     testRooFitThreads
+
+#include "RooRealVar.h"
+#include "RooCategory.h"
+#include "RooGaussian.h"
+#include "RooExponential.h"
+#include "RooGenericPdf.h"
+#include "RooAddPdf.h"
+#include "RooSimultaneous.h"
+#include "RooDataSet.h"
+#include "RooFitResult.h"
+#include "RooAbsTestStatistic.h"
+#include "RooGlobalFunc.h"
+#include "RooMsgService.h"
+#include "RooRandom.h"
+#include "TError.h"
+
+#include <cmath>
+
+using namespace RooFit;
+
+////////////////////////////////////////////////////////////////////////////////
+/// Compare the likelihood of model for data calculated in 2 and 4 threads
+/// with the one calculated in one thread, for several values of par; then
+/// compare the fits in 1 and 4 threads. Return the number of errors.
+
+static Int_t CheckModel(const char *name, RooAbsPdf &model, RooDataSet &data, RooArgSet &params, RooRealVar &par)
+{
+   Int_t nerrors = 0;
+   RooArgSet *init = (RooArgSet*)params.snapshot();
+   RooAbsReal *nll1 = model.createNLL(data, NumThreads(1));
+   const Int_t nthreads[] = { 2, 4 };
+   for (Int_t t = 0; t < 2; ++t) {
+      RooAbsReal *nll = model.createNLL(data, NumThreads(nthreads[t]));
+      Double_t par0 = par.getVal();
+      for (Int_t i = 0; i < 5; ++i) {
+         par.setVal(par0 + 0.02 * i);
+         Double_t v1 = nll1->getVal();
+         Double_t v = nll->getVal();
+         if (std::abs(v - v1) > 1e-9 * std::abs(v1)) {
+            Error("testRooFitThreads", "%s: likelihood %.10g in %d threads instead of %.10g for %s = %g", name, v,
+                  nthreads[t], v1, par.GetName(), par.getVal());
+            ++nerrors;
+         }
+      }
+      par.setVal(par0);
+      RooAbsTestStatistic *stat = dynamic_cast<RooAbsTestStatistic*>(nll);
+      if (!stat || stat->numThreadCalls() == 0) {
+         Error("testRooFitThreads", "%s: the likelihood was not calculated in %d threads", name, nthreads[t]);
+         ++nerrors;
+      }
+      delete nll;
+   }
+   delete nll1;
+
+   RooFitResult *result[2];
+   for (Int_t t = 0; t < 2; ++t) {
+      params = *init;
+      result[t] = model.fitTo(data, NumThreads(t ? 4 : 1), Save(), PrintLevel(-1));
+      if (!result[t] || result[t]->status() != 0) {
+         Error("testRooFitThreads", "%s: the fit in %d threads failed", name, t ? 4 : 1);
+         ++nerrors;
+      }
+   }
+   if (result[0] && result[1]) {
+      const RooArgList &p0 = result[0]->floatParsFinal();
+      const RooArgList &p1 = result[1]->floatParsFinal();
+      for (Int_t i = 0; i < p0.getSize(); ++i) {
+         const RooRealVar *v0 = (const RooRealVar*)p0.at(i);
+         const RooRealVar *v1 = (const RooRealVar*)p1.find(v0->GetName());
+         if (!v1 || std::abs(v0->getVal() - v1->getVal()) > 1e-3 * v0->getError()) {
+            Error("testRooFitThreads", "%s: the fits in 1 and 4 threads differ for %s", name, v0->GetName());
+            ++nerrors;
+         }
+      }
+   }
+   delete result[0];
+   delete result[1];
+   params = *init;
+   delete init;
+   return nerrors;
+}
+
+int main()
+{
+   const Int_t nevents = 20000;
+   RooMsgService::instance().setGlobalKillBelow(RooFit::WARNING);
+   RooRandom::randomGenerator()->SetSeed(4357);
+
+   RooRealVar x("x", "x", 0, 10);
+   RooRealVar mean("mean", "mean", 5, 0, 10);
+   RooRealVar sigma("sigma", "sigma", 1, 0.1, 5);
+   RooGaussian sig("sig", "signal", x, mean, sigma);
+
+   // Extended Gaussian signal over an exponential background
+   RooRealVar c("c", "c", -0.3, -2., 0.);
+   RooRealVar nsig("nsig", "nsig", 0.3 * nevents, 0, 2 * nevents);
+   RooRealVar nbkg("nbkg", "nbkg", 0.7 * nevents, 0, 2 * nevents);
+   RooExponential bkg("bkg", "background", x, c);
+   RooAddPdf model("model", "signal + background", RooArgList(sig, bkg), RooArgList(nsig, nbkg));
+   RooDataSet *data = model.generate(x, nevents);
+   RooArgSet params(mean, sigma, c, nsig, nbkg);
+   mean.setVal(4.8);
+   sigma.setVal(1.2);
+   Int_t nerrors = CheckModel("extended", model, *data, params, sigma);
+
+   // Gaussian signal over a background normalized by a numeric integral
+   RooRealVar a("a", "a", 0.05, 0, 1);
+   RooGenericPdf num("num", "background without analytical integral", "exp(c*x)*(1+a*x*x)", RooArgList(x, c, a));
+   RooRealVar frac("frac", "frac", 0.3, 0, 1);
+   RooAddPdf numModel("numModel", "signal + background", RooArgList(sig, num), RooArgList(frac));
+   RooDataSet *numData = numModel.generate(x, nevents);
+   RooArgSet numParams(mean, sigma, c, a, frac);
+   mean.setVal(4.8);
+   a.setVal(0.06);
+   nerrors += CheckModel("numeric integral", numModel, *numData, numParams, a);
+
+   // Simultaneous p.d.f. of three channels with signals at different positions
+   // over the same background
+   RooCategory chan("chan", "channel");
+   chan.defineType("chan0");
+   chan.defineType("chan1");
+   chan.defineType("chan2");
+   RooRealVar mean1("mean1", "mean1", 2, 0, 10);
+   RooRealVar mean2("mean2", "mean2", 8, 0, 10);
+   RooGaussian sig1("sig1", "signal", x, mean1, sigma);
+   RooGaussian sig2("sig2", "signal", x, mean2, sigma);
+   RooAddPdf pdf1("pdf1", "signal + background", RooArgList(sig1, num), RooArgList(frac));
+   RooAddPdf pdf2("pdf2", "signal + background", RooArgList(sig2, num), RooArgList(frac));
+   RooSimultaneous sim("sim", "simultaneous p.d.f.", chan);
+   sim.addPdf(numModel, "chan0");
+   sim.addPdf(pdf1, "chan1");
+   sim.addPdf(pdf2, "chan2");
+   RooDataSet *data1 = pdf1.generate(x, nevents / 2);
+   RooDataSet *data2 = pdf2.generate(x, nevents / 2);
+   RooDataSet simData("simData", "simData", x, Index(chan), Import("chan0", *numData), Import("chan1", *data1),
+                      Import("chan2", *data2));
+   RooArgSet simParams(mean, mean1, mean2, sigma, c, a, frac);
+   nerrors += CheckModel("simultaneous", sim, simData, simParams, c);
+
+   delete data1;
+   delete data2;
+   delete numData;
+   delete data;
+   return nerrors ? 1 : 0;
+}
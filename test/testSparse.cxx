@@ -0,0 +1,181 @@
+// @(#)root/test:$Id$
+
+// This program checks the bin index, the batched filling and the parallel
+// merging of a 10-dimensional THnSparseD:
+//  - the histogram filled with THnSparse::FillN must have the bins,
+//    contents and errors of the one filled one entry at a time with Fill;
+//  - GetBin(coord, kFALSE) must find the filled bins, and only them, as a
+//    std::map of the bins filled;
+//  - the merging of several histograms with THnSparse::SetMergeThreads(4),
+//    whose partial sums are added in parallel threads, must give the
+//    contents of the sequential merging.
+//
+//  run with
+//     testSparse
+
+#include "THnSparse.h"
+#include "TAxis.h"
+#include "TList.h"
+#include "TRandom3.h"
+#include "TMath.h"
+#include "TError.h"
+
+#include <map>
+#include <vector>
+
+const Int_t kNdim     = 10;
+const Int_t kNbins    = 20;
+const Int_t kNentries = 50000;
+const Int_t kNhist    = 8;
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return a new empty histogram.
+
+static THnSparseD *MakeHist(const char *name)
+{
+   Int_t bins[kNdim];
+   Double_t xmin[kNdim];
+   Double_t xmax[kNdim];
+   for (Int_t d = 0; d < kNdim; ++d) {
+      bins[d] = kNbins;
+      xmin[d] = -4.;
+      xmax[d] = 4.;
+   }
+   THnSparseD *h = new THnSparseD(name, "", kNdim, bins, xmin, xmax);
+   h->Sumw2();
+   return h;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return n entries of kNdim gaussian values, seed picking the sample.
+
+static std::vector<Double_t> MakeValues(Int_t n, UInt_t seed)
+{
+   TRandom3 rnd(seed);
+   std::vector<Double_t> x((Long64_t)n * kNdim);
+   for (size_t i = 0; i < x.size(); ++i) x[i] = rnd.Gaus(0., 1.);
+   return x;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the bin coordinates of the values x along the axes of h.
+
+static std::vector<Int_t> BinCoords(const THnSparse *h, const Double_t *x)
+{
+   std::vector<Int_t> coord(kNdim);
+   for (Int_t d = 0; d < kNdim; ++d) coord[d] = h->GetAxis(d)->FindFixBin(x[d]);
+   return coord;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if the two histograms have the same bins, contents and
+/// errors, exactly or up to the rounding errors.
+
+static Bool_t Same(const THnSparse *a, const THnSparse *b, Bool_t exact)
+{
+   if (a->GetNbins() != b->GetNbins()) return kFALSE;
+   if (a->GetEntries() != b->GetEntries()) return kFALSE;
+   Int_t coord[kNdim];
+   for (Long64_t i = 0; i < a->GetNbins(); ++i) {
+      Double_t content = a->GetBinContent(i, coord);
+      Long64_t j = b->GetBin(coord);
+      if (j < 0) return kFALSE;
+      Double_t tolerance = exact ? 0. : 1e-9 * TMath::Max(1., TMath::Abs(content));
+      if (TMath::Abs(content - b->GetBinContent(j)) > tolerance) return kFALSE;
+      if (TMath::Abs(a->GetBinError2(i) - b->GetBinError2(j)) > tolerance) return kFALSE;
+   }
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Check FillN against Fill and GetBin against the bins filled; return the
+/// number of errors.
+
+static Int_t CheckFill()
+{
+   std::vector<Double_t> x = MakeValues(kNentries, 4357);
+   THnSparseD *hfill = MakeHist("hfill");
+   THnSparseD *hfilln = MakeHist("hfilln");
+   std::map<std::vector<Int_t>, Double_t> filled;
+   for (Int_t i = 0; i < kNentries; ++i) {
+      hfill->Fill(&x[(Long64_t)i * kNdim]);
+      filled[BinCoords(hfill, &x[(Long64_t)i * kNdim])] += 1.;
+   }
+   hfilln->FillN(kNentries, &x[0]);
+
+   Int_t nerrors = 0;
+   if (!Same(hfill, hfilln, kTRUE)) {
+      Error("testSparse", "FillN differs from Fill");
+      ++nerrors;
+   }
+   if (hfilln->GetNbins() != Long64_t(filled.size())) {
+      Error("testSparse", "%lld bins filled instead of %d", hfilln->GetNbins(), Int_t(filled.size()));
+      ++nerrors;
+   }
+   for (std::map<std::vector<Int_t>, Double_t>::const_iterator it = filled.begin(); it != filled.end(); ++it) {
+      Long64_t bin = hfilln->GetBin(&it->first[0], kFALSE);
+      if (bin < 0 || hfilln->GetBinContent(bin) != it->second) {
+         Error("testSparse", "GetBin does not find a filled bin");
+         ++nerrors;
+         break;
+      }
+   }
+   // Random bins, mostly empty.
+   TRandom3 rnd(4357);
+   Int_t nwrong = 0;
+   for (Int_t i = 0; i < kNentries; ++i) {
+      std::vector<Int_t> coord(kNdim);
+      for (Int_t d = 0; d < kNdim; ++d) coord[d] = rnd.Integer(kNbins + 2);
+      Bool_t isfilled = filled.find(coord) != filled.end();
+      if ((hfilln->GetBin(&coord[0], kFALSE) >= 0) != isfilled) ++nwrong;
+   }
+   if (nwrong) {
+      Error("testSparse", "GetBin is wrong for %d random bins", nwrong);
+      ++nerrors;
+   }
+   if (hfilln->GetNbins() != Long64_t(filled.size())) {
+      Error("testSparse", "GetBin(coord, kFALSE) created bins");
+      ++nerrors;
+   }
+   delete hfill;
+   delete hfilln;
+   return nerrors;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Merge the histograms sequentially and in 4 parallel parts; return the
+/// number of errors.
+
+static Int_t CheckMerge()
+{
+   TList list;
+   list.SetOwner();
+   for (Int_t k = 0; k < kNhist; ++k) {
+      THnSparseD *h = MakeHist(Form("h%d", k));
+      std::vector<Double_t> x = MakeValues(kNentries / kNhist, 4357 + k);
+      h->FillN(kNentries / kNhist, &x[0]);
+      list.Add(h);
+   }
+   THnSparseD *hserial = MakeHist("hserial");
+   THnSparseD *hparallel = MakeHist("hparallel");
+   THnSparse::SetMergeThreads(1);
+   hserial->Merge(&list);
+   THnSparse::SetMergeThreads(4);
+   hparallel->Merge(&list);
+   THnSparse::SetMergeThreads(1);
+
+   Int_t nerrors = 0;
+   if (!Same(hserial, hparallel, kFALSE)) {
+      Error("testSparse", "the parallel merging differs from the sequential one");
+      ++nerrors;
+   }
+   delete hserial;
+   delete hparallel;
+   return nerrors;
+}
+
+int main()
+{
+   Int_t nerrors = CheckFill() + CheckMerge();
+   return nerrors ? 1 : 0;
+}
@@ -0,0 +1,119 @@
+// @(#)root/test:$Id$
+
+// This program checks the optimizations of the action sequences used to
+// stream the objects (see TClass::SetStreamerActionsMode), selected for the
+// classes Event, EventHeader and Track of test/Event:
+//  - an event written with the bulk and the compiled actions must give the
+//    bytes written with one action per data member, and the event read
+//    back in each mode must be written again with the same bytes;
+//  - a buffer deriving from TBufferFile must not use the optimized actions,
+//    which call the TBufferFile functions directly: the functions it
+//    overrides must be called, and the bytes must still be the same.
+//
+//  run with
+//     testStreamerActions
+
+#include "TClass.h"
+#include "TBufferFile.h"
+#include "TRandom.h"
+#include "TVirtualStreamerInfo.h"
+#include "TError.h"
+
+#include "Event.h"
+
+#include <string.h>
+#include <vector>
+
+const char *kModeNames[] = { "standard", "bulk", "compiled" };
+
+// Buffer counting the calls to the functions streaming an integer.
+class TCountingBuffer : public TBufferFile {
+public:
+   Long64_t fNints;   // Number of integers read or written by ReadInt and WriteInt
+
+   TCountingBuffer(TBuffer::EMode mode) : TBufferFile(mode), fNints(0) {}
+   TCountingBuffer(TBuffer::EMode mode, Int_t bufsiz, void *buf)
+      : TBufferFile(mode, bufsiz, buf, kFALSE), fNints(0) {}
+   virtual void ReadInt(Int_t &i) { ++fNints; TBufferFile::ReadInt(i); }
+   virtual void WriteInt(Int_t i) { ++fNints; TBufferFile::WriteInt(i); }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Select the streamer actions mode of the classes of the Event tree.
+
+static void SetMode(Int_t mode)
+{
+   const char *classes[] = { "Event", "EventHeader", "Track" };
+   for (Int_t i = 0; i < 3; ++i) TClass::GetClass(classes[i])->SetStreamerActionsMode(mode);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write event in buf and return its bytes.
+
+static std::vector<char> Write(Event &event, TBufferFile &buf)
+{
+   event.Streamer(buf);
+   return std::vector<char>(buf.Buffer(), buf.Buffer() + buf.Length());
+}
+
+int main()
+{
+   gRandom->SetSeed(65539);
+   Event event;
+   event.Build(0, 50, 1);
+
+   Int_t nerrors = 0;
+   SetMode(TVirtualStreamerInfo::kStandardActions);
+   TBufferFile refbuf(TBuffer::kWrite);
+   std::vector<char> ref = Write(event, refbuf);
+
+   for (Int_t mode = TVirtualStreamerInfo::kStandardActions; mode <= TVirtualStreamerInfo::kCompiledActions; ++mode) {
+      SetMode(mode);
+      TBufferFile wbuf(TBuffer::kWrite);
+      if (Write(event, wbuf) != ref) {
+         Error("testStreamerActions", "%s actions: the bytes written differ", kModeNames[mode]);
+         ++nerrors;
+      }
+
+      std::vector<char> bytes(ref);
+      TBufferFile rbuf(TBuffer::kRead, bytes.size(), &bytes[0], kFALSE);
+      Event read;
+      read.Streamer(rbuf);
+      SetMode(TVirtualStreamerInfo::kStandardActions);
+      TBufferFile again(TBuffer::kWrite);
+      if (rbuf.Length() != Int_t(ref.size()) || Write(read, again) != ref) {
+         Error("testStreamerActions", "%s actions: the event read back differs", kModeNames[mode]);
+         ++nerrors;
+      }
+   }
+
+   // A derived buffer runs the actions of the members, whatever the mode.
+   SetMode(TVirtualStreamerInfo::kStandardActions);
+   TCountingBuffer countref(TBuffer::kWrite);
+   Write(event, countref);
+   if (!countref.fNints) {
+      Error("testStreamerActions", "WriteInt of the derived buffer is not called");
+      ++nerrors;
+   }
+   for (Int_t mode = TVirtualStreamerInfo::kBulkActions; mode <= TVirtualStreamerInfo::kCompiledActions; ++mode) {
+      SetMode(mode);
+      TCountingBuffer wbuf(TBuffer::kWrite);
+      if (Write(event, wbuf) != ref || wbuf.fNints != countref.fNints) {
+         Error("testStreamerActions", "%s actions: the derived buffer wrote %lld integers instead of %lld",
+               kModeNames[mode], wbuf.fNints, countref.fNints);
+         ++nerrors;
+      }
+      std::vector<char> bytes(ref);
+      TCountingBuffer rbuf(TBuffer::kRead, bytes.size(), &bytes[0]);
+      Event read;
+      read.Streamer(rbuf);
+      if (rbuf.fNints != countref.fNints) {
+         Error("testStreamerActions", "%s actions: the derived buffer read %lld integers instead of %lld",
+               kModeNames[mode], rbuf.fNints, countref.fNints);
+         ++nerrors;
+      }
+   }
+
+   SetMode(-1);
+   return nerrors ? 1 : 0;
+}
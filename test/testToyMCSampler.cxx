@@ -0,0 +1,98 @@
+// @(#)root/test:$Id$
+
+// This program checks the generation of the toys of RooStats::ToyMCSampler
+// in local processes (see ToyMCSampler::SetNWorkers). The model is a
+// Gaussian whose mean is the parameter of interest and whose width is a
+// nuisance parameter with a Gaussian prior; the test statistic is the
+// profile likelihood ratio:
+//  - with the same seed of the random generator, the toys generated by 1, 2
+//    and 4 processes must give exactly the same sampling distribution, in
+//    the same order, also when the tasks are run in several batches;
+//  - the sampling distribution must have one value per toy.
+//
+//  run with
+//     testToyMCSampler
+
+#include "RooRealVar.h"
+#include "RooGaussian.h"
+#include "RooGlobalFunc.h"
+#include "RooMsgService.h"
+#include "RooRandom.h"
+#include "RooStats/ToyMCSampler.h"
+#include "RooStats/ProfileLikelihoodTestStat.h"
+#include "RooStats/SamplingDistribution.h"
+#include "TError.h"
+
+#include <vector>
+
+const Int_t kToys = 120;
+const Int_t kToysPerTask = 3;
+
+////////////////////////////////////////////////////////////////////////////////
+/// Generate the sampling distribution of the test statistic for poi in
+/// nworkers processes, with the generator seeded from seed.
+
+static std::vector<Double_t> Generate(RooAbsPdf &pdf, RooAbsPdf &prior, RooRealVar &x, RooRealVar &poi,
+                                      RooRealVar &nuis, Int_t nworkers, UInt_t seed)
+{
+   RooStats::ProfileLikelihoodTestStat ts(pdf);
+   ts.SetOneSided(kTRUE);
+   RooStats::ToyMCSampler sampler(ts, kToys);
+   sampler.SetPdf(pdf);
+   sampler.SetObservables(RooArgSet(x));
+   sampler.SetParametersForTestStat(RooArgSet(poi));
+   sampler.SetNuisanceParameters(RooArgSet(nuis));
+   sampler.SetPriorNuisance(&prior);
+   sampler.SetNEventsPerToy(50);
+   sampler.SetNWorkers(nworkers, kToysPerTask);
+
+   RooRandom::randomGenerator()->SetSeed(seed);
+   RooArgSet point(poi, nuis);
+   RooStats::SamplingDistribution *dist = sampler.GetSamplingDistribution(point);
+   std::vector<Double_t> values;
+   if (dist) values = dist->GetSamplingDistribution();
+   delete dist;
+   return values;
+}
+
+int main()
+{
+   RooMsgService::instance().setGlobalKillBelow(RooFit::WARNING);
+
+   RooRealVar x("x", "x", -10, 10);
+   RooRealVar mu("mu", "mu", 1, -5, 5);
+   RooRealVar sigma("sigma", "sigma", 1, 0.2, 5);
+   RooGaussian pdf("pdf", "model", x, mu, sigma);
+   RooRealVar sigma0("sigma0", "sigma0", 1);
+   RooRealVar sigmaErr("sigmaErr", "sigmaErr", 0.1);
+   RooGaussian prior("prior", "prior of sigma", sigma, sigma0, sigmaErr);
+
+   Int_t nerrors = 0;
+   const Int_t nworkers[] = { 1, 2, 4 };
+   std::vector<Double_t> ref;
+   for (Int_t w = 0; w < 3; ++w) {
+      std::vector<Double_t> values = Generate(pdf, prior, x, mu, sigma, nworkers[w], 4357);
+      if (values.size() != (size_t)kToys) {
+         Error("testToyMCSampler", "%d values of the test statistic with %d processes instead of %d",
+               (Int_t)values.size(), nworkers[w], kToys);
+         ++nerrors;
+      } else if (w == 0) {
+         ref = values;
+      } else if (values != ref) {
+         Error("testToyMCSampler", "the sampling distributions with 1 and %d processes differ", nworkers[w]);
+         ++nerrors;
+      }
+   }
+
+   // the values must not all be the same, for the comparison to be meaningful
+   Int_t ndiff = 0;
+   for (size_t i = 1; i < ref.size(); ++i) {
+      if (ref[i] != ref[0]) ++ndiff;
+   }
+   if (!ref.empty() && !ndiff) {
+      Error("testToyMCSampler", "all the toys give the same test statistic %g", ref[0]);
+      ++nerrors;
+   }
+
+   return nerrors ? 1 : 0;
+}
@@ -0,0 +1,80 @@
+// @(#)root/test:$Id$
+
+// This program checks the parallel unzipping of the baskets by the
+// TTreeCacheUnzip (with the tasks of the default TTaskPool). The tree has
+// a compressed branch and a branch stored without compression, whose
+// baskets are left to the reading thread, and the unzip window is smaller
+// than a cluster so that the baskets are handed to the tasks while the
+// cluster is read. The values read must be the ones written.
+//
+//  run with
+//     testTreeCacheUnzip
+
+#include "TFile.h"
+#include "TTree.h"
+#include "TBranch.h"
+#include "TTreeCacheUnzip.h"
+#include "TTaskPool.h"
+#include "TSystem.h"
+#include "TError.h"
+
+int main()
+{
+   const char *fname = "testTreeCacheUnzip.root";
+   const Long64_t nentries = 100000;
+   const Int_t bufsize = 4000;
+
+   // Unzip with two tasks even on a single core machine.
+   TTaskPool::SetDefaultSize(2);
+
+   {
+      TFile file(fname, "RECREATE");
+      TTree tree("T", "Tree for the parallel unzipping test");
+      Int_t i;
+      Double_t x;
+      tree.Branch("i", &i, "i/I", bufsize);
+      TBranch *bx = tree.Branch("x", &x, "x/D", bufsize);
+      bx->SetCompressionLevel(0);
+      tree.SetAutoFlush(10000);
+      for (Long64_t entry = 0; entry < nentries; ++entry) {
+         i = Int_t(entry);
+         x = 0.5 * entry;
+         tree.Fill();
+      }
+      file.Write();
+   }
+
+   TTreeCacheUnzip::SetParallelUnzip(TTreeCacheUnzip::kForce);
+   TFile *file = TFile::Open(fname);
+   TTree *tree = 0;
+   if (file) file->GetObject("T", tree);
+   if (!tree) {
+      Error("testTreeCacheUnzip", "can not read the tree from %s", fname);
+      return 1;
+   }
+   tree->SetCacheSize(10000000);
+   TTreeCacheUnzip *cache = dynamic_cast<TTreeCacheUnzip*>(file->GetCacheRead(tree));
+   if (!cache) {
+      Error("testTreeCacheUnzip", "the tree is not read through a TTreeCacheUnzip");
+      delete file;
+      return 1;
+   }
+   cache->SetUnzipBufferSize(3 * bufsize);
+
+   Int_t i;
+   Double_t x;
+   tree->SetBranchAddress("i", &i);
+   tree->SetBranchAddress("x", &x);
+   Long64_t nwrong = 0;
+   for (Long64_t entry = 0; entry < nentries; ++entry) {
+      tree->GetEntry(entry);
+      if (i != entry || x != 0.5 * entry) ++nwrong;
+   }
+   Int_t nunzip = cache->GetNUnzip();
+   delete file;
+   gSystem->Unlink(fname);
+
+   if (nwrong) Error("testTreeCacheUnzip", "%lld of %lld entries read wrong", nwrong, nentries);
+   if (!nunzip) Error("testTreeCacheUnzip", "no basket was unzipped by the tasks");
+   return nwrong || !nunzip ? 1 : 0;
+}
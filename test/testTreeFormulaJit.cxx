@@ -0,0 +1,115 @@
+// @(#)root/test:$Id$
+
+// This program checks the formulas compiled by the interpreter (see
+// TTreeFormula::JitCompile and TTreeFormula::SetJitEnabled): TTree::Draw of
+// a few expressions, with scalars, a variable size array, the conditional
+// operator and the special variable Entry$, must select the same rows with
+// the same values whether the formulas are interpreted or compiled, and
+// the formulas must actually be compiled when enabled.
+//
+//  run with
+//     testTreeFormulaJit
+
+#include "TTree.h"
+#include "TTreeFormula.h"
+#include "TRandom3.h"
+#include "TMath.h"
+#include "TError.h"
+
+#include <vector>
+
+const Int_t kMaxTracks = 10;
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill a memory resident tree with nentries entries.
+
+static TTree *MakeTree(Long64_t nentries)
+{
+   TRandom3 rnd(4357);
+   TTree *tree = new TTree("T", "Tree for the formula compilation test");
+   tree->SetDirectory(0);
+   Float_t x, y, z;
+   Int_t n;
+   Float_t px[kMaxTracks];
+   tree->Branch("x", &x, "x/F");
+   tree->Branch("y", &y, "y/F");
+   tree->Branch("z", &z, "z/F");
+   tree->Branch("n", &n, "n/I");
+   tree->Branch("px", px, "px[n]/F");
+   for (Long64_t entry = 0; entry < nentries; ++entry) {
+      rnd.Rannor(x, y);
+      z = rnd.Exp(1);
+      n = rnd.Integer(kMaxTracks + 1);
+      for (Int_t t = 0; t < n; ++t) px[t] = rnd.Gaus(0, 1);
+      tree->Fill();
+   }
+   return tree;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Draw expression with selection, with or without compiling the formulas;
+/// return the number of rows selected, the values drawn and whether both
+/// formulas were compiled.
+
+static Long64_t Draw(TTree *tree, const char *expression, const char *selection, Bool_t jit,
+                     std::vector<Double_t> &values, Bool_t &compiled)
+{
+   TTreeFormula::SetJitEnabled(jit);
+   Long64_t rows = tree->Draw(expression, selection, "goff");
+   TTreeFormula *var = tree->GetVar1();
+   TTreeFormula *select = tree->GetSelect();
+   compiled = var && var->IsJitCompiled() && (!select || select->IsJitCompiled());
+   values.clear();
+   if (rows > 0 && tree->GetV1()) values.assign(tree->GetV1(), tree->GetV1() + rows);
+   TTreeFormula::SetJitEnabled(kFALSE);
+   return rows;
+}
+
+int main()
+{
+   TTree *tree = MakeTree(20000);
+   tree->SetEstimate(tree->GetEntries() * kMaxTracks);
+
+   const char *expressions[][2] = {
+      { "x*y+sqrt(z)",                 "n>2" },
+      { "sin(x)*cos(y)+exp(-z*z)",     "x>0||y>0" },
+      { "x>0 && y<1 ? x*x : y*y",      "" },
+      { "px*px+x",                     "px>0 && n<8" },
+      { "(Entry$%3)+log(z+1)*2.5",     "abs(x)<2" }
+   };
+   const Int_t nexpressions = sizeof(expressions) / sizeof(expressions[0]);
+
+   Int_t nerrors = 0;
+   for (Int_t e = 0; e < nexpressions; ++e) {
+      std::vector<Double_t> interpreted, compiled;
+      Bool_t isjit;
+      Long64_t nint = Draw(tree, expressions[e][0], expressions[e][1], kFALSE, interpreted, isjit);
+      if (nint <= 0 || isjit) {
+         Error("testTreeFormulaJit", "%s: wrong interpreted draw", expressions[e][0]);
+         ++nerrors;
+         continue;
+      }
+      Long64_t njit = Draw(tree, expressions[e][0], expressions[e][1], kTRUE, compiled, isjit);
+      if (!isjit) {
+         Error("testTreeFormulaJit", "%s: the formulas were not compiled", expressions[e][0]);
+         ++nerrors;
+      }
+      if (njit != nint || compiled.size() != interpreted.size()) {
+         Error("testTreeFormulaJit", "%s: %lld rows selected instead of %lld", expressions[e][0], njit, nint);
+         ++nerrors;
+         continue;
+      }
+      for (size_t i = 0; i < interpreted.size(); ++i) {
+         Double_t scale = TMath::Max(1., TMath::Abs(interpreted[i]));
+         if (TMath::Abs(interpreted[i] - compiled[i]) > 1e-12 * scale) {
+            Error("testTreeFormulaJit", "%s: row %d is %g instead of %g", expressions[e][0], Int_t(i), compiled[i],
+                  interpreted[i]);
+            ++nerrors;
+            break;
+         }
+      }
+   }
+
+   delete tree;
+   return nerrors ? 1 : 0;
+}
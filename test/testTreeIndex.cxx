@@ -0,0 +1,221 @@
+// @(#)root/test:$Id$
+
+// This program checks the lookups of a TTreeIndex built on the pair
+// run,event of a tree filled in random order against a linear scan of the
+// values filled: TTreeIndex::GetEntryNumberWithIndex,
+// TTreeIndex::GetEntryNumberWithBestIndex and the batched
+// TTreeIndex::GetEntryNumbersWithIndex, for random and for sorted keys,
+// one key out of eight not being in the index. The same lookups done
+// concurrently by several threads on the same index must give the same
+// entries, and the batched lookups of a TChainIndex must be its single
+// lookups.
+//
+//  run with
+//     testTreeIndex
+
+#include "TFile.h"
+#include "TTree.h"
+#include "TChain.h"
+#include "TTreeIndex.h"
+#include "TRandom3.h"
+#include "TString.h"
+#include "TSystem.h"
+#include "TError.h"
+
+#include <algorithm>
+#include <thread>
+#include <utility>
+#include <vector>
+
+const Long64_t kEventsPerRun = 100;
+const Long64_t kNruns        = 200;
+const Int_t    kNfiles       = 3;
+const Int_t    kNthreads     = 4;
+
+typedef std::pair<Long64_t, Long64_t> TRunEvent;
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill tree with the runs [first,first+nruns), their events in random
+/// order; append the keys filled to filled.
+
+static void FillRuns(TTree *tree, Long64_t first, Long64_t nruns, TRandom3 &rnd, std::vector<TRunEvent> &filled)
+{
+   Long64_t n = nruns * kEventsPerRun;
+   std::vector<Long64_t> order(n);
+   for (Long64_t i = 0; i < n; ++i) order[i] = i;
+   for (Long64_t i = n - 1; i > 0; --i) std::swap(order[i], order[rnd.Integer(i + 1)]);
+   Int_t run, event;
+   tree->Branch("run", &run, "run/I");
+   tree->Branch("event", &event, "event/I");
+   for (Long64_t i = 0; i < n; ++i) {
+      run = first + order[i] / kEventsPerRun;
+      event = order[i] % kEventsPerRun;
+      filled.push_back(TRunEvent(run, event));
+      tree->Fill();
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return nkeys random keys; one out of eight is not in the index. The keys
+/// are sorted if sorted is true.
+
+static std::vector<TRunEvent> MakeKeys(Long64_t nkeys, Bool_t sorted, TRandom3 &rnd)
+{
+   std::vector<TRunEvent> keys(nkeys);
+   for (Long64_t i = 0; i < nkeys; ++i) {
+      keys[i].first = 1 + rnd.Integer(kNruns);
+      keys[i].second = rnd.Integer(kEventsPerRun * 8 / 7);
+   }
+   if (sorted) std::sort(keys.begin(), keys.end());
+   return keys;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Look up key by a linear scan of the keys filled: return the entry of key
+/// (-1 if not filled) and set best to the entry of the greatest key lower
+/// or equal to key (-1 if none).
+
+static Long64_t LinearScan(const std::vector<TRunEvent> &filled, const TRunEvent &key, Long64_t &best)
+{
+   best = -1;
+   for (size_t entry = 0; entry < filled.size(); ++entry) {
+      if (filled[entry] == key) {
+         best = entry;
+         return entry;
+      }
+      if (filled[entry] < key && (best < 0 || filled[best] < filled[entry])) best = entry;
+   }
+   return -1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Look up the keys one at a time.
+
+static void LookupSingle(const TVirtualIndex *index, const std::vector<TRunEvent> &keys, std::vector<Long64_t> &entries)
+{
+   entries.resize(keys.size());
+   for (size_t i = 0; i < keys.size(); ++i) {
+      entries[i] = index->GetEntryNumberWithIndex(keys[i].first, keys[i].second);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Look up all the keys in one batch.
+
+static void LookupBatch(const TVirtualIndex *index, const std::vector<TRunEvent> &keys, std::vector<Long64_t> &entries)
+{
+   std::vector<Long64_t> major(keys.size()), minor(keys.size());
+   for (size_t i = 0; i < keys.size(); ++i) {
+      major[i] = keys[i].first;
+      minor[i] = keys[i].second;
+   }
+   entries.resize(keys.size());
+   index->GetEntryNumbersWithIndex(keys.size(), &major[0], &minor[0], &entries[0]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Check the lookups of keys in index against a linear scan of filled;
+/// return the number of errors.
+
+static Int_t CheckKeys(const char *name, const TTreeIndex *index, const std::vector<TRunEvent> &filled,
+                       const std::vector<TRunEvent> &keys)
+{
+   std::vector<Long64_t> ref(keys.size()), best(keys.size());
+   for (size_t i = 0; i < keys.size(); ++i) ref[i] = LinearScan(filled, keys[i], best[i]);
+
+   Int_t nerrors = 0;
+   std::vector<Long64_t> entries;
+   LookupSingle(index, keys, entries);
+   if (entries != ref) {
+      Error("testTreeIndex", "%s: GetEntryNumberWithIndex differs from the linear scan", name);
+      ++nerrors;
+   }
+   for (size_t i = 0; i < keys.size(); ++i) {
+      if (index->GetEntryNumberWithBestIndex(keys[i].first, keys[i].second) != best[i]) {
+         Error("testTreeIndex", "%s: GetEntryNumberWithBestIndex differs from the linear scan", name);
+         ++nerrors;
+         break;
+      }
+   }
+   LookupBatch(index, keys, entries);
+   if (entries != ref) {
+      Error("testTreeIndex", "%s: GetEntryNumbersWithIndex differs from the linear scan", name);
+      ++nerrors;
+   }
+
+   // The same lookups from several threads at once.
+   std::vector<std::vector<Long64_t> > results(2 * kNthreads);
+   std::vector<std::thread> threads;
+   for (Int_t t = 0; t < kNthreads; ++t) {
+      threads.emplace_back(LookupSingle, index, std::cref(keys), std::ref(results[2 * t]));
+      threads.emplace_back(LookupBatch, index, std::cref(keys), std::ref(results[2 * t + 1]));
+   }
+   for (size_t t = 0; t < threads.size(); ++t) threads[t].join();
+   for (size_t t = 0; t < results.size(); ++t) {
+      if (results[t] != ref) {
+         Error("testTreeIndex", "%s: the concurrent lookups differ from the linear scan", name);
+         ++nerrors;
+         break;
+      }
+   }
+   return nerrors;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Check the batched lookups of a chain index against its single lookups.
+
+static Int_t CheckChain(const std::vector<TRunEvent> &keys)
+{
+   TRandom3 rnd(4357);
+   std::vector<TRunEvent> filled;
+   TChain chain("T");
+   Long64_t runsPerFile = (kNruns + kNfiles - 1) / kNfiles;
+   for (Int_t f = 0; f < kNfiles; ++f) {
+      TString fname = TString::Format("testTreeIndex_%d.root", f);
+      TFile file(fname, "RECREATE");
+      TTree *tree = new TTree("T", "Tree for the index test");
+      FillRuns(tree, 1 + f * runsPerFile, runsPerFile, rnd, filled);
+      file.Write();
+      chain.Add(fname);
+   }
+   Int_t nerrors = 0;
+   if (chain.BuildIndex("run", "event") <= 0 || !chain.GetTreeIndex()) {
+      Error("testTreeIndex", "can not build the index of the chain");
+      ++nerrors;
+   } else {
+      std::vector<Long64_t> single, batch;
+      LookupSingle(chain.GetTreeIndex(), keys, single);
+      LookupBatch(chain.GetTreeIndex(), keys, batch);
+      if (single != batch) {
+         Error("testTreeIndex", "the batched lookups of the chain index differ from the single ones");
+         ++nerrors;
+      }
+   }
+   chain.Reset();
+   for (Int_t f = 0; f < kNfiles; ++f) gSystem->Unlink(TString::Format("testTreeIndex_%d.root", f));
+   return nerrors;
+}
+
+int main()
+{
+   TRandom3 rnd(4357);
+   std::vector<TRunEvent> filled;
+   TTree *tree = new TTree("T", "Tree for the index test");
+   tree->SetDirectory(0);
+   FillRuns(tree, 1, kNruns, rnd, filled);
+   tree->BuildIndex("run", "event");
+   TTreeIndex *index = dynamic_cast<TTreeIndex*>(tree->GetTreeIndex());
+   if (!index || index->GetN() != Long64_t(filled.size())) {
+      Error("testTreeIndex", "can not build the index");
+      delete tree;
+      return 1;
+   }
+
+   Int_t nerrors = 0;
+   nerrors += CheckKeys("random keys", index, filled, MakeKeys(2000, kFALSE, rnd));
+   nerrors += CheckKeys("sorted keys", index, filled, MakeKeys(2000, kTRUE, rnd));
+   nerrors += CheckChain(MakeKeys(2000, kFALSE, rnd));
+
+   delete tree;
+   return nerrors ? 1 : 0;
+}
@@ -0,0 +1,79 @@
+// @(#)root/test:$Id$
+
+// This program checks that TTreeProcessor processes every entry exactly
+// once: a tree with small clusters is written in two files, the entry
+// numbers are histogrammed in parallel on the threads of the TTaskPool
+// (one bin per entry) and every bin of the merged histogram must contain
+// exactly one entry.
+//
+//  run with
+//     testTreeProcessor
+
+#include "TFile.h"
+#include "TTree.h"
+#include "TH1D.h"
+#include "TSystem.h"
+#include "TError.h"
+#include "TTaskPool.h"
+#include "TTreeReader.h"
+#include "TTreeReaderValue.h"
+#include "TTreeProcessor.h"
+
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write the entries first to first+nentries-1 in fname, with clusters of
+/// 100 entries.
+
+static void WriteFile(const char *fname, Int_t first, Int_t nentries)
+{
+   TFile file(fname, "RECREATE");
+   TTree tree("T", "Tree for the TTreeProcessor test");
+   Int_t entry;
+   tree.Branch("entry", &entry, "entry/I");
+   tree.SetAutoFlush(100);
+   for (entry = first; entry < first + nentries; ++entry) tree.Fill();
+   file.Write();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill h with the entry numbers read by reader.
+
+static void FillEntries(TTreeReader &reader, TH1D &h)
+{
+   TTreeReaderValue<Int_t> entry(reader, "entry");
+   while (reader.Next()) h.Fill(*entry);
+}
+
+int main()
+{
+   const Int_t nentries = 5000;
+   TTaskPool::SetDefaultSize(4);
+
+   std::vector<std::string> fnames;
+   fnames.push_back("testTreeProcessor1.root");
+   fnames.push_back("testTreeProcessor2.root");
+   WriteFile(fnames[0].c_str(), 0, 2000);
+   WriteFile(fnames[1].c_str(), 2000, nentries - 2000);
+
+   TH1D model("entries", "Entry numbers", nentries, -0.5, nentries - 0.5);
+   model.SetDirectory(0);
+   TTreeProcessor processor("T", fnames);
+   TH1D *h = processor.Process(FillEntries, model);
+
+   Int_t nwrong = 0;
+   if (!h || h->GetEntries() != nentries) {
+      Error("testTreeProcessor", "%g entries processed instead of %d", h ? h->GetEntries() : 0., nentries);
+      ++nwrong;
+   }
+   for (Int_t bin = 0; h && bin <= nentries + 1; ++bin) {
+      Double_t expected = (bin == 0 || bin == nentries + 1) ? 0 : 1;
+      if (h->GetBinContent(bin) != expected) ++nwrong;
+   }
+   if (nwrong) Error("testTreeProcessor", "%d bins not filled exactly once", nwrong);
+
+   delete h;
+   for (size_t i = 0; i < fnames.size(); ++i) gSystem->Unlink(fnames[i].c_str());
+   return nwrong ? 1 : 0;
+}
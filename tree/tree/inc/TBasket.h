@@ -60,6 +60,7 @@ protected:
    TBuffer    *fCompressedBufferRef; //! Compressed buffer.
    Bool_t      fOwnsCompressedBuffer; //! Whether or not we own the compressed buffer.
    Int_t       fLastWriteBufferSize; //! Size of the buffer last time we wrote it to disk
+   TBuffer    *fMappedBufferRef; //! View on the data of a memory mapped file.
 
 public:
 
@@ -69,6 +70,7 @@ public:
    virtual ~TBasket();
 
    virtual void    AdjustSize(Int_t newsize);
+           Int_t   CommitWriteBuffer(TFile *file, Int_t nout, Short_t cycle);
    virtual void    DeleteEntryOffset();
    virtual Int_t   DropBuffers();
    TBranch        *GetBranch() const {return fBranch;}
@@ -81,6 +83,7 @@ public:
            Int_t   GetLast() const {return fLast;}
    virtual void    MoveEntries(Int_t dentries);
    virtual void    PrepareBasket(Long64_t /* entry */) {};
+           Int_t   PrepareWriteBuffer(TFile *file, Bool_t privateBuffer = kFALSE);
            Int_t   ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file);
            Int_t   ReadBasketBytes(Long64_t pos, TFile *file);
    virtual void    Reset();
@@ -91,6 +91,9 @@ protected:
    Int_t      *fBasketBytes;     //[fMaxBaskets] Length of baskets on file
    Long64_t   *fBasketEntry;     //[fMaxBaskets] Table of first entry in each basket
    Long64_t   *fBasketSeek;      //[fMaxBaskets] Addresses of baskets on file
+   Double_t   *fBasketMin;       //[fMaxBaskets] Smallest value of the leaf in each basket (see SetBasketStats)
+   Double_t   *fBasketMax;       //[fMaxBaskets] Largest value of the leaf in each basket
+   Long64_t   *fBasketNvalues;   //[fMaxBaskets] Number of values of the leaf in each basket, -1 if unknown
    TTree      *fTree;            //! Pointer to Tree header
    TBranch    *fMother;          //! Pointer to top-level parent branch in the tree.
    TBranch    *fParent;          //! Pointer to parent branch.
@@ -115,7 +118,10 @@ protected:
    void     SetSkipZip(Bool_t skip = kTRUE) { fSkipZip = skip; }
    void     Init(const char *name, const char *leaflist, Int_t compress);
 
+   void     CopyBasketStats(const TBranch *from, Int_t basket, Long64_t startEntry, Bool_t ondisk);
    TBasket *GetFreshBasket();
+   void     InitBasketStats(Int_t basket, Long64_t nvalues);
+   void     UpdateBasketStats();
    Int_t    WriteBasket(TBasket* basket, Int_t where);
 
    TString  GetRealFileName() const;
@@ -149,7 +155,9 @@ public:
            Long64_t *GetBasketEntry() const {return fBasketEntry;}
    virtual Long64_t  GetBasketSeek(Int_t basket) const;
    virtual Int_t     GetBasketSize() const {return fBasketSize;}
+           Bool_t    GetBasketStats(Int_t basket, Double_t &min, Double_t &max, Long64_t &nvalues) const;
    virtual TList    *GetBrowsables();
+           Int_t     GetBulkEntries(Long64_t entry, TBuffer &user_buf);
    virtual const char* GetClassName() const;
            Int_t     GetCompressionAlgorithm() const;
            Int_t     GetCompressionLevel() const;
@@ -185,6 +193,7 @@ public:
    virtual Bool_t    GetMakeClass() const;
    TBranch          *GetMother() const;
    TBranch          *GetSubBranch(const TBranch *br) const;
+           Bool_t    HasBasketStats() const {return fBasketNvalues != 0;}
    Bool_t            IsAutoDelete() const;
    Bool_t            IsFolder() const;
    virtual void      KeepCircular(Long64_t maxEntries);
@@ -200,6 +209,7 @@ public:
    virtual void      SetObject(void *objadd);
    virtual void      SetAutoDelete(Bool_t autodel=kTRUE);
    virtual void      SetBasketSize(Int_t buffsize);
+           Bool_t    SetBasketStats(Bool_t enable = kTRUE);
    virtual void      SetBufferAddress(TBuffer *entryBuffer);
    void              SetCompressionAlgorithm(Int_t algorithm=0);
    void              SetCompressionLevel(Int_t level=1);
@@ -216,10 +226,11 @@ public:
    virtual void      SetupAddresses();
    virtual void      UpdateAddress() {;}
    virtual void      UpdateFile();
+           Int_t     WritePendingBasket(TBasket *basket, Int_t where, Int_t nout);
 
    static  void      ResetCount();
 
-   ClassDef(TBranch,12);  //Branch descriptor
+   ClassDef(TBranch,13);  //Branch descriptor
 };
 
 //______________________________________________________________________________
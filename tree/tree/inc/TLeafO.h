@@ -49,6 +49,7 @@ public:
    virtual void    PrintValue(Int_t i=0) const;
    virtual void    ReadBasket(TBuffer &b);
    virtual void    ReadBasketExport(TBuffer &b, TClonesArray *list, Int_t n);
+   virtual Bool_t  ReadBasketFast(TBuffer &b, Long64_t n);
    virtual void    ReadValue(std::istream& s, Char_t delim = ' ');
    virtual void    SetAddress(void *add=0);
    virtual void    SetMaximum(Bool_t max) { fMaximum = max; }
@@ -94,6 +94,8 @@ class TVirtualPerfStats;
 class TTree : public TNamed, public TAttLine, public TAttFill, public TAttMarker {
 
 protected:
+   struct TPendingBaskets;            // Baskets being compressed in implicit multi-threading mode (see TTree.cxx)
+
    Long64_t       fEntries;           //  Number of entries
    Long64_t       fTotBytes;          //  Total number of bytes in all branches before compression
    Long64_t       fZipBytes;          //  Total number of bytes in all branches after compression
@@ -145,6 +147,8 @@ protected:
    TBuffer       *fTransientBuffer;   //! Pointer to the current transient buffer.
    Bool_t         fCacheDoAutoInit;   //! true if cache auto creation or resize check is needed
    Bool_t         fCacheUserSet;      //! true if the cache setting was explicitly given by user
+   Bool_t         fIMTEnabled;        //! true if the baskets are compressed by the task pool while filling
+   TPendingBaskets *fPendingBaskets;  //! Baskets handed to the task pool, in the order they must be written
 
    static Int_t     fgBranchStyle;      //  Old/New branch style
    static Long64_t  fgMaxTreeSize;      //  Maximum size of a file containg a Tree
@@ -155,6 +159,7 @@ private:
 
 protected:
    void             AddClone(TTree*);
+   void             DropPendingBaskets();
    virtual void     KeepCircular();
    virtual TBranch *BranchImp(const char* branchname, const char* classname, TClass* ptrClass, void* addobj, Int_t bufsize, Int_t splitlevel);
    virtual TBranch *BranchImp(const char* branchname, TClass* ptrClass, void* addobj, Int_t bufsize, Int_t splitlevel);
@@ -293,6 +298,7 @@ public:
    virtual TFriendElement *AddFriend(const char* treename, const char* filename = "");
    virtual TFriendElement *AddFriend(const char* treename, TFile* file);
    virtual TFriendElement *AddFriend(TTree* tree, const char* alias = "", Bool_t warn = kFALSE);
+           void            AddPendingBasket(TBranch *branch, TBasket *basket, Int_t where);
    virtual void            AddTotBytes(Int_t tot) { fTotBytes += tot; }
    virtual void            AddZipBytes(Int_t zip) { fZipBytes += zip; }
    virtual Long64_t        AutoSave(Option_t* option = "");
@@ -396,6 +402,7 @@ public:
    virtual TTree          *GetFriend(const char*) const;
    virtual const char     *GetFriendAlias(TTree*) const;
    TH1                    *GetHistogram() { return GetPlayer()->GetHistogram(); }
+           Bool_t          GetImplicitMT() const { return fIMTEnabled; }
    virtual Int_t          *GetIndex() { return &fIndex.fArray[0]; }
    virtual Double_t       *GetIndexValues() { return &fIndexValues.fArray[0]; }
    virtual TIterator      *GetIteratorOnAllLeaves(Bool_t dir = kIterForward);
@@ -499,6 +506,7 @@ public:
    virtual void            SetAutoSave(Long64_t autos = -300000000);
    virtual void            SetAutoFlush(Long64_t autof = -30000000);
    virtual void            SetBasketSize(const char* bname, Int_t buffsize = 16000);
+   virtual Int_t           SetBasketStats(const char* bname = "*", Bool_t enable = kTRUE);
 #if !defined(__CINT__)
    virtual Int_t           SetBranchAddress(const char *bname,void *add, TBranch **ptr = 0);
 #endif
@@ -535,6 +543,7 @@ public:
    virtual void            SetFileNumber(Int_t number = 0);
    virtual void            SetEventList(TEventList* list);
    virtual void            SetEntryList(TEntryList* list, Option_t *opt="");
+   virtual void            SetImplicitMT(Bool_t enabled = kTRUE);
    virtual void            SetMakeClass(Int_t make);
    virtual void            SetMaxEntryLoop(Long64_t maxev = kMaxEntries) { fMaxEntryLoop = maxev; } // *MENU*
    static  void            SetMaxTreeSize(Long64_t maxsize = 1900000000);
@@ -556,6 +565,7 @@ public:
    void                    UseCurrentStyle();
    virtual Int_t           Write(const char *name=0, Int_t option=0, Int_t bufsize=0);
    virtual Int_t           Write(const char *name=0, Int_t option=0, Int_t bufsize=0) const;
+           Int_t           WritePendingBaskets(Bool_t wait = kTRUE) const;
 
 
    ClassDef(TTree,19)  //Tree descriptor (the main ROOT I/O class)
@@ -61,6 +61,8 @@ protected:
    EPrefillType    fPrefillType; // Whether a prefilling is enabled (and if applicable which type)
    static  Int_t   fgLearnEntries; // number of entries used for learning mode
    Bool_t          fAutoCreated; //! true if cache was automatically created
+   Int_t           fNReadLearn;  //! Number of blocks read, not from the cache, in the learning phase
+   Int_t           fNReadSaved;  //! Estimated number of learning phase reads avoided by ImportProfile
 
 private:
    TTreeCache(const TTreeCache &);            //this class cannot be copied
@@ -79,25 +81,33 @@ public:
    virtual void         Enable() {fEnabled = kTRUE;}
    const TObjArray     *GetCachedBranches() const { return fBranches; }
    EPrefillType         GetConfiguredPrefillType() const;
+   const char          *GetConfiguredProfile() const;
    Double_t             GetEfficiency() const;
    Double_t             GetEfficiencyRel() const;
    virtual Int_t        GetEntryMin() const {return fEntryMin;}
    virtual Int_t        GetEntryMax() const {return fEntryMax;}
    static Int_t         GetLearnEntries();
    virtual EPrefillType GetLearnPrefill() const {return fPrefillType;}
+   Int_t                GetLearnReads() const {return fNReadLearn;}
+   Int_t                GetProfileReadsSaved() const {return fNReadSaved;}
    TTree               *GetTree() const {return fTree;}
    Bool_t               IsAutoCreated() const {return fAutoCreated;}
    virtual Bool_t       IsEnabled() const {return fEnabled;}
    virtual Bool_t       IsLearning() const {return fIsLearning;}
 
+   TList               *ExportProfile() const;
    virtual Bool_t       FillBuffer();
+   Int_t                ImportConfiguredProfile();
+   Int_t                ImportProfile(const TList *profile);
    virtual void         LearnPrefill();
+   Int_t                LoadProfile(const char *filename);
 
    virtual void         Print(Option_t *option="") const;
    virtual Int_t        ReadBuffer(char *buf, Long64_t pos, Int_t len);
    virtual Int_t        ReadBufferNormal(char *buf, Long64_t pos, Int_t len);
    virtual Int_t        ReadBufferPrefetch(char *buf, Long64_t pos, Int_t len);
    virtual void         ResetCache();
+   Int_t                SaveProfile(const char *filename) const;
    void                 SetAutoCreated(Bool_t val) {fAutoCreated = val;}
    virtual Int_t        SetBufferSize(Int_t buffersize);
    virtual void         SetEntryRange(Long64_t emin,   Long64_t emax);
@@ -29,14 +29,15 @@
 #include "TTreeCache.h"
 #endif
 
-#include <queue>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 
 class TTree;
 class TBranch;
-class TThread;
-class TCondition;
 class TBasket;
 class TMutex;
+class TTaskGroup;
 
 class TTreeCacheUnzip : public TTreeCache {
 public:
@@ -44,54 +45,63 @@ public:
    // enable, disable and force
    enum EParUnzipMode { kEnable, kDisable, kForce };
 
+   // Unzipping state of a basket of the cache
+   enum EUnzipState { kUntouched, kProgress, kFinished, kConsumed };
+
 protected:
 
    // Members for paral. managing
-   TThread    *fUnzipThread[10];
-   Bool_t      fActiveThread;          // Used to terminate gracefully the unzippers
-   TCondition *fUnzipStartCondition;   // Used to signal the threads to start.
-   TCondition *fUnzipDoneCondition;    // Used to wait for an unzip tour to finish. Gives the Async feel.
    Bool_t      fParallel;              // Indicate if we want to activate the parallelism (for this instance)
-   Bool_t      fAsyncReading;
-   TMutex     *fMutexList;             // Mutex to protect the various lists. Used by the condvars.
-   TMutex     *fIOMutex;
+   TMutex     *fMutexList;             // Mutex to protect the list of branches
+   TMutex     *fIOMutex;               // Mutex to serialize the reads through the underlying TFileCacheRead
+   TTaskGroup *fUnzipTasks;            //! Tasks unzipping the baskets of the current cluster
 
-   Int_t       fCycle;
    static TTreeCacheUnzip::EParUnzipMode fgParallel;  // Indicate if we want to activate the parallelism
 
-   Int_t       fLastReadPos;
-   Int_t       fBlocksToGo;
-
-   // Unzipping related members
+   // Unzipping related members, indexed like fSeekSort
    Int_t      *fUnzipLen;         //! [fNseek] Length of the unzipped buffers
-   char      **fUnzipChunks;      //! [fNseek] Individual unzipped chunks. Their summed size is kept under control.
-   Byte_t     *fUnzipStatus;      //! [fNSeek] For each blk, tells us if it's unzipped or pending
-   Long64_t    fTotalUnzipBytes;  //! The total sum of the currently unzipped blks
+   char      **fUnzipChunks;      //! [fNseek] Individual unzipped chunks, handed over to the baskets.
+   std::atomic<Byte_t> *fUnzipState; //! [fNseek] For each blk, tells us if it's untouched, in progress or unzipped
+   std::atomic<Bool_t>  fUnzipCancel; //! Set to tell the pending tasks that the cache content is going away
+   std::mutex           fUnzipDoneMutex; //! Protects the transitions to kFinished waited for by the reading thread
+   std::condition_variable fUnzipDone;   //! Signalled when a task finished unzipping a basket
+   Bool_t      fUnzipActive;      //! True if the baskets of the current cluster are unzipped by the tasks
+   Bool_t      fUnzipDirect;      //! True if the tasks can unzip directly from fBuffer
 
    Int_t       fNseekMax;         //!  fNseek can change so we need to know its max size
-   Long64_t    fUnzipBufferSize;  //!  Max Size for the ready unzipped blocks (default is 2*fBufferSize)
+   Int_t       fNextToUnzip;      //!  Index of the next basket to hand to the task pool
+   Long64_t    fUnzipBufferSize;  //!  Max size of the compressed baskets being unzipped ahead of the reading
+   Long64_t    fUnzipScheduled;   //!  Size of the compressed baskets handed to the pool and not yet consumed
 
    static Double_t fgRelBuffSize; // This is the percentage of the TTreeCacheUnzip that will be used
 
+   // Members used to measure the unzip latency of a cluster
+   Long64_t    fClusterEntry;     //! First entry of the cluster being unzipped
+   Int_t       fClusterBaskets;   //! Number of baskets in the cluster being unzipped
+   Double_t    fClusterStart;     //! Time stamp at which the unzipping of the cluster started
+   Double_t    fClusterStop;      //! Time stamp at which the last basket of the cluster was unzipped
+   std::atomic<Int_t>    fClusterToGo;      //! Number of baskets of the cluster not yet unzipped
+   std::atomic<Long64_t> fClusterUnzipTime; //! Time spent unzipping the baskets of the cluster (ns)
+   std::atomic<Bool_t>   fClusterDone;      //! Set once fClusterStop is valid
+   Bool_t      fClusterReported;  //! True if the cluster statistics have been reported
+   Int_t       fNClusters;        //! Number of clusters unzipped
+   Double_t    fClusterLatency;   //! Sum of the unzip latencies of the clusters
+
    // Members use to keep statistics
-   Int_t       fNUnzip;           //! number of blocks that were unzipped
+   std::atomic<Int_t> fNUnzip;    //! number of blocks that were unzipped by the tasks
    Int_t       fNFound;           //! number of blocks that were found in the cache
    Int_t       fNStalls;          //! number of hits which caused a stall
    Int_t       fNMissed;          //! number of blocks that were not found in the cache and were unzipped
 
-   std::queue<Int_t>       fActiveBlks; // The blocks which are active now
-
 private:
    TTreeCacheUnzip(const TTreeCacheUnzip &);            //this class cannot be copied
    TTreeCacheUnzip& operator=(const TTreeCacheUnzip &);
 
-   char *fCompBuffer;
-   Int_t fCompBufferSize;
-
    // Private methods
    void  Init();
-   Int_t StartThreadUnzip(Int_t nthreads);
-   Int_t StopThreadUnzip();
+   void  ReportClusterUnzip();
+   void  ScheduleUnzip();
+   void  UnzipBasket(Int_t loc, Bool_t intask);
 
 public:
    TTreeCacheUnzip();
@@ -102,20 +112,15 @@ public:
    Bool_t              FillBuffer();
    virtual Int_t       ReadBufferExt(char *buf, Long64_t pos, Int_t len, Int_t &loc);
    void                SetEntryRange(Long64_t emin,   Long64_t emax);
+   virtual void        SetFile(TFile *file, TFile::ECacheAction action=TFile::kDisconnect);
    virtual void        StopLearningPhase();
    void                UpdateBranches(TTree *tree);
 
-   // Methods related to the thread
+   // Methods related to the parallel unzipping
    static EParUnzipMode GetParallelUnzip();
    static Bool_t        IsParallelUnzip();
    static Int_t         SetParallelUnzip(TTreeCacheUnzip::EParUnzipMode option = TTreeCacheUnzip::kEnable);
 
-   Bool_t               IsActiveThread();
-   Bool_t               IsQueueEmpty();
-
-   void                 WaitUnzipStartSignal();
-   void                 SendUnzipStartSignal(Bool_t broadcast);
-
    // Unzipping related methods
    Int_t          GetRecordHeader(char *buf, Int_t maxbytes, Int_t &nbytes, Int_t &objlen, Int_t &keylen);
    virtual void   ResetCache();
@@ -124,17 +129,15 @@ public:
    void           SetUnzipBufferSize(Long64_t bufferSize);
    static void    SetUnzipRelBufferSize(Float_t relbufferSize);
    Int_t          UnzipBuffer(char **dest, char *src);
-   Int_t          UnzipCache(Int_t &startindex, Int_t &locbuffsz, char *&locbuff);
 
    // Methods to get stats
    Int_t  GetNUnzip() { return fNUnzip; }
    Int_t  GetNFound() { return fNFound; }
    Int_t  GetNMissed(){ return fNMissed; }
+   Int_t  GetNClusters() { return fNClusters; }
 
    void Print(Option_t* option = "") const;
 
-   // static members
-   static void* UnzipLoop(void *arg);
    ClassDef(TTreeCacheUnzip,0)  //Specialization of TTreeCache for parallel unzipping
 };
 
@@ -10,6 +10,7 @@
 
 #include "TBasket.h"
 #include "TBufferFile.h"
+#include "TBufferPool.h"
 #include "TTree.h"
 #include "TBranch.h"
 #include "TFile.h"
@@ -38,6 +39,51 @@ const UInt_t kDisplacementMask = 0xFF000000;  // In the streamer the two highest
 
 ClassImp(TBasket)
 
+namespace {
+   // Make the TTreePerfStats of a tree, if it has one, the perf stats of the
+   // calling thread (see gPerfStats) for the lifetime of the object, so that
+   // the reads done by TFile are accounted to the tree. gPerfStats is only
+   // touched when the tree has perf stats and it is restored on all the
+   // return paths.
+   class TTreePerfStatsGuard {
+   private:
+      TVirtualPerfStats *fSaved;    // perf stats to restore, if fSwapped
+      Bool_t             fSwapped;  // kTRUE if gPerfStats was replaced
+
+   public:
+      TTreePerfStatsGuard(TTree *tree) : fSaved(0), fSwapped(kFALSE) {
+         TVirtualPerfStats *perf = tree->GetPerfStats();
+         if (perf) {
+            fSaved = gPerfStats;
+            gPerfStats = perf;
+            fSwapped = kTRUE;
+         }
+      }
+      ~TTreePerfStatsGuard() {
+         if (fSwapped) gPerfStats = fSaved;
+      }
+   };
+
+   ////////////////////////////////////////////////////////////////////////////////
+   /// Create a buffer using a block of at least len bytes of the TBufferPool.
+
+   TBuffer *R__NewPooledBuffer(TBuffer::EMode mode, Int_t len)
+   {
+      char *block = TBufferPool::Allocate(len);
+      return new TBufferFile(mode, (Int_t)TBufferPool::GetCapacity(block), block, kFALSE, &TBufferPool::ReAllocChar);
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   /// Delete the buffer, giving its block back to the TBufferPool if it has one.
+
+   void R__DeleteBuffer(TBuffer *buffer)
+   {
+      if (!buffer) return;
+      TBufferPool::Detach(buffer);
+      delete buffer;
+   }
+}
+
 /** \class TBasket
 Manages buffers for branches of a Tree.
 
@@ -47,7 +93,7 @@ See picture in TTree.
 ////////////////////////////////////////////////////////////////////////////////
 /// Default contructor.
 
-TBasket::TBasket() : fCompressedBufferRef(0), fOwnsCompressedBuffer(kFALSE), fLastWriteBufferSize(0)
+TBasket::TBasket() : fCompressedBufferRef(0), fOwnsCompressedBuffer(kFALSE), fLastWriteBufferSize(0), fMappedBufferRef(0)
 {
    fDisplacement  = 0;
    fEntryOffset   = 0;
@@ -64,7 +110,7 @@ TBasket::TBasket() : fCompressedBufferRef(0), fOwnsCompressedBuffer(kFALSE), fLa
 ////////////////////////////////////////////////////////////////////////////////
 /// Constructor used during reading.
 
-TBasket::TBasket(TDirectory *motherDir) : TKey(motherDir),fCompressedBufferRef(0), fOwnsCompressedBuffer(kFALSE), fLastWriteBufferSize(0)
+TBasket::TBasket(TDirectory *motherDir) : TKey(motherDir),fCompressedBufferRef(0), fOwnsCompressedBuffer(kFALSE), fLastWriteBufferSize(0), fMappedBufferRef(0)
 {
    fDisplacement  = 0;
    fEntryOffset   = 0;
@@ -82,7 +128,7 @@ TBasket::TBasket(TDirectory *motherDir) : TKey(motherDir),fCompressedBufferRef(0
 /// Basket normal constructor, used during writing.
 
 TBasket::TBasket(const char *name, const char *title, TBranch *branch) :
-   TKey(branch->GetDirectory()),fCompressedBufferRef(0), fOwnsCompressedBuffer(kFALSE), fLastWriteBufferSize(0)
+   TKey(branch->GetDirectory()),fCompressedBufferRef(0), fOwnsCompressedBuffer(kFALSE), fLastWriteBufferSize(0), fMappedBufferRef(0)
 {
    SetName(name);
    SetTitle(title);
@@ -93,7 +139,7 @@ TBasket::TBasket(const char *name, const char *title, TBranch *branch) :
    fEntryOffset = 0;
    fDisplacement= 0;
    fBuffer      = 0;
-   fBufferRef   = new TBufferFile(TBuffer::kWrite, fBufferSize);
+   fBufferRef   = R__NewPooledBuffer(TBuffer::kWrite, fBufferSize);
    fVersion    += 1000;
    if (branch->GetDirectory()) {
       TFile *file = branch->GetFile();
@@ -105,7 +151,7 @@ TBasket::TBasket(const char *name, const char *title, TBranch *branch) :
       fCompressedBufferRef = branch->GetTree()->GetTransientBuffer(fBufferSize);
       fOwnsCompressedBuffer = kFALSE;
       if (!fCompressedBufferRef) {
-         fCompressedBufferRef = new TBufferFile(TBuffer::kRead, fBufferSize);
+         fCompressedBufferRef = R__NewPooledBuffer(TBuffer::kRead, fBufferSize);
          fOwnsCompressedBuffer = kTRUE;
       }
    }
@@ -130,16 +176,18 @@ TBasket::~TBasket()
 {
    if (fDisplacement) delete [] fDisplacement;
    if (fEntryOffset)  delete [] fEntryOffset;
-   if (fBufferRef) delete fBufferRef;
+   R__DeleteBuffer(fBufferRef);
    fBufferRef = 0;
    fBuffer = 0;
    fDisplacement= 0;
    fEntryOffset = 0;
    // Note we only delete the compressed buffer if we own it
    if (fCompressedBufferRef && fOwnsCompressedBuffer) {
-      delete fCompressedBufferRef;
+      R__DeleteBuffer(fCompressedBufferRef);
       fCompressedBufferRef = 0;
    }
+   delete fMappedBufferRef;
+   fMappedBufferRef = 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -194,8 +242,8 @@ Int_t TBasket::DropBuffers()
 
    if (fDisplacement) delete [] fDisplacement;
    if (fEntryOffset)  delete [] fEntryOffset;
-   if (fBufferRef)    delete fBufferRef;
-   if (fCompressedBufferRef && fOwnsCompressedBuffer) delete fCompressedBufferRef;
+   R__DeleteBuffer(fBufferRef);
+   if (fCompressedBufferRef && fOwnsCompressedBuffer) R__DeleteBuffer(fCompressedBufferRef);
    fBufferRef   = 0;
    fCompressedBufferRef = 0;
    fBuffer      = 0;
@@ -236,15 +284,14 @@ Int_t TBasket::LoadBasketBuffers(Long64_t pos, Int_t len, TFile *file, TTree *tr
       }
       fBufferRef->SetReadMode();
    } else {
-      fBufferRef = new TBufferFile(TBuffer::kRead, len);
+      fBufferRef = R__NewPooledBuffer(TBuffer::kRead, len);
    }
    fBufferRef->SetParent(file);
    char *buffer = fBufferRef->Buffer();
    file->Seek(pos);
    TFileCacheRead *pf = file->GetCacheRead(tree);
+   TTreePerfStatsGuard perfGuard(tree);
    if (pf) {
-      TVirtualPerfStats* temp = gPerfStats;
-      if (tree->GetPerfStats()) gPerfStats = tree->GetPerfStats();
       Int_t st = pf->ReadBuffer(buffer,pos,len);
       if (st < 0) {
          return 1;
@@ -263,17 +310,12 @@ Int_t TBasket::LoadBasketBuffers(Long64_t pos, Int_t len, TFile *file, TTree *tr
             return 1;
          }
       }
-      gPerfStats = temp;
       // fOffset might have been changed via TFileCacheRead::ReadBuffer(), reset it
       file->SetOffset(pos + len);
    } else {
-      TVirtualPerfStats* temp = gPerfStats;
-      if (tree->GetPerfStats() != 0) gPerfStats = tree->GetPerfStats();
       if (file->ReadBuffer(buffer,len)) {
-         gPerfStats = temp;
          return 1; //error while reading
       }
-      else gPerfStats = temp;
    }
 
    fBufferRef->SetReadMode();
@@ -355,15 +397,19 @@ Int_t TBasket::ReadBasketBuffersUncompressedCase()
 
 ////////////////////////////////////////////////////////////////////////////////
 /// We always create the TBuffer for the basket but it hold the buffer from the cache.
+/// If mustFree, the buffer is a block of the TBufferPool handed over to the
+/// basket, otherwise it stays owned by the cache.
 
 Int_t TBasket::ReadBasketBuffersUnzip(char* buffer, Int_t size, Bool_t mustFree, TFile* file)
 {
+   ReAllocCharFun_t reallocfunc = mustFree ? &TBufferPool::ReAllocChar : 0;
    if (fBufferRef) {
-      fBufferRef->SetBuffer(buffer, size, mustFree);
+      TBufferPool::Detach(fBufferRef);
+      fBufferRef->SetBuffer(buffer, size, kFALSE, reallocfunc);
       fBufferRef->SetReadMode();
       fBufferRef->Reset();
    } else {
-      fBufferRef = new TBufferFile(TBuffer::kRead, size, buffer, mustFree);
+      fBufferRef = new TBufferFile(TBuffer::kRead, size, buffer, kFALSE, reallocfunc);
    }
    fBufferRef->SetParent(file);
 
@@ -392,14 +438,18 @@ static inline TBuffer* R__InitializeReadBasketBuffer(TBuffer* bufferRef, Int_t l
    if (R__likely(bufferRef)) {
       bufferRef->SetReadMode();
       Int_t curBufferSize = bufferRef->BufferSize();
-      if (curBufferSize < len) {
+      if (R__unlikely(!bufferRef->TestBit(TBuffer::kIsOwner) && !TBufferPool::IsPooled(bufferRef))) {
+         // The buffer was a view on memory we do not own (the mapping of
+         // the file or a buffer of the cache); get our own.
+         TBufferPool::Attach(bufferRef, len);
+      } else if (curBufferSize < len) {
          // Experience shows that giving 5% "wiggle-room" decreases churn.
          bufferRef->Expand(Int_t(len*1.05));
       }
       bufferRef->Reset();
       result = bufferRef;
    } else {
-      result = new TBufferFile(TBuffer::kRead, len);
+      result = R__NewPooledBuffer(TBuffer::kRead, len);
    }
    result->SetParent(file);
    return result;
@@ -440,6 +490,7 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
 
    Bool_t oldCase;
    char *rawUncompressedBuffer, *rawCompressedBuffer;
+   char *mapped = 0;
    Int_t uncompressedBufferLen;
 
    // See if the cache has already unzipped the buffer for us.
@@ -447,7 +498,7 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
    if (pf) {
       Int_t res = -1;
       Bool_t free = kTRUE;
-      char *buffer;
+      char *buffer = 0;
       res = pf->GetUnzipBuffer(&buffer, pos, len, &free);
       if (R__unlikely(res >= 0)) {
          len = ReadBasketBuffersUnzip(buffer, res, free, file);
@@ -471,43 +522,55 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
    // and we will re-add the new size later on.
    fBranch->GetTree()->IncrementTotalBuffers(-fBufferSize);
 
-   // Initialize the buffer to hold the compressed data.
-   readBufferRef = R__InitializeReadBasketBuffer(readBufferRef, len, file);
-   if (!readBufferRef) {
-      Error("ReadBasketBuffers", "Unable to allocate buffer.");
-      return 1;
+   // With a memory mapped file, use the data in place.
+   if (file->IsMapped()) {
+      TTreePerfStatsGuard perfGuard(fBranch->GetTree());
+      mapped = file->ReadBufferMapped(pos, len);
    }
 
-   if (pf) {
-      TVirtualPerfStats* temp = gPerfStats;
-      if (fBranch->GetTree()->GetPerfStats() != 0) gPerfStats = fBranch->GetTree()->GetPerfStats();
-      Int_t st = pf->ReadBuffer(readBufferRef->Buffer(),pos,len);
-      if (st < 0) {
-         return 1;
-      } else if (st == 0) {
-         // Read directly from file, not from the cache
-         // If we are using a TTreeCache, disable reading from the default cache
-         // temporarily, to force reading directly from file
-         TTreeCache *fc = dynamic_cast<TTreeCache*>(file->GetCacheRead());
-         if (fc) fc->Disable();
-         Int_t ret = file->ReadBuffer(readBufferRef->Buffer(),pos,len);
-         if (fc) fc->Enable();
-         pf->AddNoCacheBytesRead(len);
-         pf->AddNoCacheReadCalls(1);
-         if (ret) {
-            return 1;
-         }
+   if (mapped) {
+      if (fMappedBufferRef) {
+         fMappedBufferRef->SetBuffer(mapped, len, kFALSE);
+         fMappedBufferRef->Reset();
+      } else {
+         fMappedBufferRef = new TBufferFile(TBuffer::kRead, len, mapped, kFALSE);
       }
-      gPerfStats = temp;
+      fMappedBufferRef->SetParent(file);
+      readBufferRef = fMappedBufferRef;
    } else {
-      // Read from the file and unstream the header information.
-      TVirtualPerfStats* temp = gPerfStats;
-      if (fBranch->GetTree()->GetPerfStats() != 0) gPerfStats = fBranch->GetTree()->GetPerfStats();
-      if (file->ReadBuffer(readBufferRef->Buffer(),pos,len)) {
-         gPerfStats = temp;
+      // Initialize the buffer to hold the compressed data.
+      readBufferRef = R__InitializeReadBasketBuffer(readBufferRef, len, file);
+      if (!readBufferRef) {
+         Error("ReadBasketBuffers", "Unable to allocate buffer.");
          return 1;
       }
-      else gPerfStats = temp;
+
+      if (pf) {
+         TTreePerfStatsGuard perfGuard(fBranch->GetTree());
+         Int_t st = pf->ReadBuffer(readBufferRef->Buffer(),pos,len);
+         if (st < 0) {
+            return 1;
+         } else if (st == 0) {
+            // Read directly from file, not from the cache
+            // If we are using a TTreeCache, disable reading from the default cache
+            // temporarily, to force reading directly from file
+            TTreeCache *fc = dynamic_cast<TTreeCache*>(file->GetCacheRead());
+            if (fc) fc->Disable();
+            Int_t ret = file->ReadBuffer(readBufferRef->Buffer(),pos,len);
+            if (fc) fc->Enable();
+            pf->AddNoCacheBytesRead(len);
+            pf->AddNoCacheReadCalls(1);
+            if (ret) {
+               return 1;
+            }
+         }
+      } else {
+         // Read from the file and unstream the header information.
+         TTreePerfStatsGuard perfGuard(fBranch->GetTree());
+         if (file->ReadBuffer(readBufferRef->Buffer(),pos,len)) {
+            return 1;
+         }
+      }
    }
    Streamer(*readBufferRef);
    if (IsZombie()) {
@@ -516,6 +579,22 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
 
    rawCompressedBuffer = readBufferRef->Buffer();
 
+   if (R__unlikely(mapped && fObjlen+fKeylen == fNbytes)) {
+      // The basket is not compressed: read the entries straight from the
+      // mapping, without copy.
+      if (fBufferRef) {
+         fBufferRef->SetReadMode();
+         TBufferPool::Detach(fBufferRef);
+         fBufferRef->SetBuffer(mapped, len, kFALSE);
+         fBufferRef->Reset();
+      } else {
+         fBufferRef = new TBufferFile(TBuffer::kRead, len, mapped, kFALSE);
+      }
+      fBufferRef->SetParent(file);
+      fBuffer = mapped;
+      goto AfterBuffer;
+   }
+
    // Are we done?
    if (R__unlikely(readBufferRef == fBufferRef)) // We expect most basket to be compressed.
    {
@@ -553,8 +632,10 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
       }
 
       // Optional monitor for zip time profiling.
+      TVirtualPerfStats *perf = fBranch->GetTree()->GetPerfStats();
+      if (!perf) perf = gPerfStats;
       Double_t start = 0;
-      if (R__unlikely(gPerfStats)) {
+      if (R__unlikely(perf)) {
          start = TTimeStamp();
       }
 
@@ -593,12 +674,9 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
          return 1;
       }
       len = fObjlen+fKeylen;
-      TVirtualPerfStats* temp = gPerfStats;
-      if (fBranch->GetTree()->GetPerfStats() != 0) gPerfStats = fBranch->GetTree()->GetPerfStats();
-      if (R__unlikely(gPerfStats)) {
-         gPerfStats->UnzipEvent(fBranch->GetTree(),pos,start,nintot,fObjlen);
+      if (R__unlikely(perf)) {
+         perf->UnzipEvent(fBranch->GetTree(),pos,start,nintot,fObjlen);
       }
-      gPerfStats = temp;
    } else {
       // Nothing is compressed - copy over wholesale.
       memcpy(rawUncompressedBuffer, rawCompressedBuffer, len);
@@ -795,7 +873,7 @@ void TBasket::Streamer(TBuffer &b)
          }
       }
       if (flag == 1 || flag > 10) {
-         fBufferRef = new TBufferFile(TBuffer::kRead,fBufferSize);
+         fBufferRef = R__NewPooledBuffer(TBuffer::kRead,fBufferSize);
          fBufferRef->SetParent(b.GetParent());
          char *buf  = fBufferRef->Buffer();
          if (v > 1) b.ReadFastArray(buf,fLast);
@@ -949,6 +1027,26 @@ Int_t TBasket::WriteBuffer()
       return nBytes>0 ? fKeylen+nout : -1;
    }
 
+   Int_t nout = PrepareWriteBuffer(file);
+   if (nout < 0) {
+      return -1;
+   }
+   return CommitWriteBuffer(file, nout, fBranch->GetWriteBasket());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Transfer the entry offsets at the end of the buffer and compress it:
+/// this is the first half of WriteBuffer, it does not touch the file.
+///
+/// As long as the basket is not accessed by another thread in the meantime,
+/// this can run concurrently with the filling of the tree. In that case
+/// privateBuffer must be set so that the basket compresses into a buffer
+/// it owns rather than into the transient buffer shared by the tree.
+/// The function returns the number of bytes of the (possibly compressed)
+/// payload or -1 if the compressed buffer could not be allocated.
+
+Int_t TBasket::PrepareWriteBuffer(TFile *file, Bool_t privateBuffer)
+{
    // Transfer fEntryOffset table at the end of fBuffer.
    fLast = fBufferRef->Length();
    if (fEntryOffset) {
@@ -970,13 +1068,15 @@ Int_t TBasket::WriteBuffer()
    lbuf       = fBufferRef->Length();
    fObjlen    = lbuf - fKeylen;
 
-   fHeaderOnly = kTRUE;
-   fCycle = fBranch->GetWriteBasket();
    Int_t cxlevel = fBranch->GetCompressionLevel();
    Int_t cxAlgorithm = fBranch->GetCompressionAlgorithm();
    if (cxlevel > 0) {
       Int_t nbuffers = 1 + (fObjlen - 1) / kMAXZIPBUF;
       Int_t buflen = fKeylen + fObjlen + 9 * nbuffers + 28; //add 28 bytes in case object is placed in a deleted gap
+      if (privateBuffer && !fOwnsCompressedBuffer) {
+         // Do not use (and resize) the buffer shared with the other baskets.
+         fCompressedBufferRef = 0;
+      }
       InitializeCompressedBuffer(buflen, file);
       if (!fCompressedBufferRef) {
          Warning("WriteBuffer", "Unable to allocate the compressed buffer");
@@ -998,41 +1098,49 @@ Int_t TBasket::WriteBuffer()
          // when the buffer contains random data, it may happen that the compressed
          // buffer is larger than the input. In this case, we write the original uncompressed buffer
          if (nout == 0 || nout >= fObjlen) {
-            nout = fObjlen;
             // We used to delete fBuffer here, we no longer want to since
             // the buffer (held by fCompressedBufferRef) might be re-used later.
             fBuffer = fBufferRef->Buffer();
-            Create(fObjlen,file);
-            fBufferRef->SetBufferOffset(0);
-
-            Streamer(*fBufferRef);         //write key itself again
-            if ((nout+fKeylen)>buflen) {
+            if ((fObjlen+fKeylen)>buflen) {
                Warning("WriteBuffer","Possible memory corruption due to compression algorithm, wrote %d bytes past the end of a block of %d bytes. fNbytes=%d, fObjLen=%d, fKeylen=%d",
-                  (nout+fKeylen-buflen),buflen,fNbytes,fObjlen,fKeylen);
+                  (fObjlen+fKeylen-buflen),buflen,fObjlen+fKeylen,fObjlen,fKeylen);
             }
-            goto WriteFile;
+            return fObjlen;
          }
          bufcur += nout;
          noutot += nout;
          objbuf += kMAXZIPBUF;
          nzip   += kMAXZIPBUF;
       }
-      nout = noutot;
-      Create(noutot,file);
-      fBufferRef->SetBufferOffset(0);
+      return noutot;
+   }
+   fBuffer = fBufferRef->Buffer();
+   return fObjlen;
+}
 
-      Streamer(*fBufferRef);         //write key itself again
-      memcpy(fBuffer,fBufferRef->Buffer(),fKeylen);
-   } else {
-      fBuffer = fBufferRef->Buffer();
-      Create(fObjlen,file);
-      fBufferRef->SetBufferOffset(0);
+////////////////////////////////////////////////////////////////////////////////
+/// Write the basket prepared by PrepareWriteBuffer: allocate its key in
+/// file, update the key header (with the given cycle number) and write
+/// header and payload (of nout bytes).
+/// This is the second half of WriteBuffer and must be called by the thread
+/// owning the file, in the order in which the baskets are to be laid out.
+///
+/// The function returns the number of bytes written or -1 in case of error.
 
-      Streamer(*fBufferRef);         //write key itself again
-      nout = fObjlen;
+Int_t TBasket::CommitWriteBuffer(TFile *file, Int_t nout, Short_t cycle)
+{
+   fMotherDir = file;
+   fCycle = cycle;
+   fHeaderOnly = kTRUE;
+   Create(nout,file);
+   fBufferRef->SetBufferOffset(0);
+
+   Streamer(*fBufferRef);         //write key itself again
+   if (fBuffer != fBufferRef->Buffer()) {
+      // The payload is in the compressed buffer, copy the key in front of it.
+      memcpy(fBuffer,fBufferRef->Buffer(),fKeylen);
    }
 
-WriteFile:
    Int_t nBytes = WriteFileKeepBuffer();
    fHeaderOnly = kFALSE;
    return nBytes>0 ? fKeylen+nout : -1;
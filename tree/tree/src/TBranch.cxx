@@ -105,6 +105,9 @@ TBranch::TBranch()
 , fBasketBytes(0)
 , fBasketEntry(0)
 , fBasketSeek(0)
+, fBasketMin(0)
+, fBasketMax(0)
+, fBasketNvalues(0)
 , fTree(0)
 , fMother(0)
 , fParent(0)
@@ -207,6 +210,9 @@ TBranch::TBranch(TTree *tree, const char* name, void* address, const char* leafl
 , fBasketBytes(0)
 , fBasketEntry(0)
 , fBasketSeek(0)
+, fBasketMin(0)
+, fBasketMax(0)
+, fBasketNvalues(0)
 , fTree(tree)
 , fMother(0)
 , fParent(0)
@@ -256,6 +262,9 @@ TBranch::TBranch(TBranch *parent, const char* name, void* address, const char* l
 , fBasketBytes(0)
 , fBasketEntry(0)
 , fBasketSeek(0)
+, fBasketMin(0)
+, fBasketMax(0)
+, fBasketNvalues(0)
 , fTree(parent ? parent->GetTree() : 0)
 , fMother(parent ? parent->GetMother() : 0)
 , fParent(parent)
@@ -424,6 +433,13 @@ TBranch::~TBranch()
    delete [] fBasketBytes;
    fBasketBytes = 0;
 
+   delete [] fBasketMin;
+   fBasketMin = 0;
+   delete [] fBasketMax;
+   fBasketMax = 0;
+   delete [] fBasketNvalues;
+   fBasketNvalues = 0;
+
    fBaskets.Delete();
    fNBaskets = 0;
    fCurrentBasket = 0;
@@ -517,10 +533,19 @@ void TBranch::AddBasket(TBasket& b, Bool_t ondisk, Long64_t startEntry)
             fBasketEntry[j] = fBasketEntry[j-1];
             fBasketBytes[j] = fBasketBytes[j-1];
             fBasketSeek[j]  = fBasketSeek[j-1];
+            if (fBasketNvalues) {
+               fBasketMin[j]     = fBasketMin[j-1];
+               fBasketMax[j]     = fBasketMax[j-1];
+               fBasketNvalues[j] = fBasketNvalues[j-1];
+            }
          }
       }
    }
    fBasketEntry[where] = startEntry;
+   if (fBasketNvalues) {
+      // The values of the basket are not known, see CopyBasketStats.
+      InitBasketStats(where, -1);
+   }
 
    if (ondisk) {
       fBasketBytes[where] = basket->GetNbytes();  // not for in mem
@@ -563,6 +588,24 @@ void TBranch::AddLastBasket(Long64_t startEntry)
    fBaskets.AddAtAndExpand(0,fWriteBasket);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Copy the statistics of the basket of the branch from, see SetBasketStats,
+/// to the basket of this branch starting at startEntry, just added by
+/// AddBasket with the same value of ondisk. The statistics stay unknown if
+/// from has none.
+
+void TBranch::CopyBasketStats(const TBranch *from, Int_t basket, Long64_t startEntry, Bool_t ondisk)
+{
+   if (!fBasketNvalues || !from->fBasketNvalues || basket > from->fWriteBasket) return;
+   // The basket is the last one, unless it was added out of order.
+   Int_t where = ondisk ? fWriteBasket - 1 : fWriteBasket;
+   while (where > 0 && fBasketEntry[where] != startEntry) --where;
+   if (where < 0 || fBasketEntry[where] != startEntry) return;
+   fBasketMin[where]     = from->fBasketMin[basket];
+   fBasketMax[where]     = from->fBasketMax[basket];
+   fBasketNvalues[where] = from->fBasketNvalues[basket];
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Browser interface.
 
@@ -699,6 +742,14 @@ void TBranch::ExpandBasketArrays()
                                                 newsize*sizeof(Long64_t),fMaxBaskets*sizeof(Long64_t));
    fBasketSeek   = (Long64_t*)TStorage::ReAlloc(fBasketSeek,
                                                 newsize*sizeof(Long64_t),fMaxBaskets*sizeof(Long64_t));
+   if (fBasketNvalues) {
+      fBasketMin     = (Double_t*)TStorage::ReAlloc(fBasketMin,
+                                                    newsize*sizeof(Double_t),fMaxBaskets*sizeof(Double_t));
+      fBasketMax     = (Double_t*)TStorage::ReAlloc(fBasketMax,
+                                                    newsize*sizeof(Double_t),fMaxBaskets*sizeof(Double_t));
+      fBasketNvalues = (Long64_t*)TStorage::ReAlloc(fBasketNvalues,
+                                                    newsize*sizeof(Long64_t),fMaxBaskets*sizeof(Long64_t));
+   }
 
    fMaxBaskets   = newsize;
 
@@ -708,6 +759,7 @@ void TBranch::ExpandBasketArrays()
       fBasketBytes[i] = 0;
       fBasketEntry[i] = 0;
       fBasketSeek[i]  = 0;
+      if (fBasketNvalues) InitBasketStats(i, 0);
    }
 }
 
@@ -750,12 +802,15 @@ Int_t TBranch::Fill()
 
    if (fEntryBuffer) {
       nbytes = FillEntryBuffer(basket,buf,lnew);
+      // The values copied from fEntryBuffer are not known.
+      if (fBasketNvalues) fBasketNvalues[fWriteBasket] = -1;
    } else {
       Int_t lold = buf->Length();
       basket->Update(lold);
       ++fEntries;
       ++fEntryNumber;
       (this->*fFillLeaves)(*buf);
+      if (fBasketNvalues) UpdateBasketStats();
       if (buf->GetMapCount()) {
          // The map is used.
          ResetBit(TBranch::kDoNotUseBufferMap);
@@ -1091,6 +1146,10 @@ TBasket* TBranch::GetBasket(Int_t basketnumber)
    TBasket *basket = (TBasket*)fBaskets.UncheckedAt(basketnumber);
    if (basket) return basket;
    if (basketnumber == fWriteBasket) return 0;
+   if (fBasketSeek[basketnumber] == 0 && fTree->GetImplicitMT()) {
+      // The basket might not be written yet, see WriteBasket.
+      fTree->WritePendingBaskets();
+   }
 
    // create/decode basket parameters from buffer
    TFile *file = GetFile(0);
@@ -1146,6 +1205,22 @@ Long64_t TBranch::GetBasketSeek(Int_t basketnumber) const
    return fBasketSeek[basketnumber];
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return in min, max and nvalues the smallest and largest value of the
+/// leaf in the basket and the number of values, see SetBasketStats.
+/// Return false if the branch has no statistics for this basket, e.g.
+/// because it was written before they were enabled or by an older version.
+
+Bool_t TBranch::GetBasketStats(Int_t basket, Double_t &min, Double_t &max, Long64_t &nvalues) const
+{
+   if (!fBasketNvalues || basket < 0 || basket > fWriteBasket || basket >= fMaxBaskets) return kFALSE;
+   if (fBasketNvalues[basket] < 0) return kFALSE;
+   min     = fBasketMin[basket];
+   max     = fBasketMax[basket];
+   nvalues = fBasketNvalues[basket];
+   return kTRUE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Returns (and, if 0, creates) browsable objects for this branch
 /// See TVirtualBranchBrowsable::FillListOfBrowsables.
@@ -1353,6 +1428,118 @@ Int_t TBranch::GetEntryExport(Long64_t entry, Int_t /*getall*/, TClonesArray* li
    return nbytes;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Read in one go the values of all the entries of the basket containing
+/// entry, from entry to the last entry of the basket, into user_buf.
+///
+/// The branch must be a TBranch with a single leaf of a simple type
+/// (TLeafB, TLeafS, TLeafI, TLeafL, TLeafF, TLeafD or TLeafO), which may
+/// be a fixed or variable size array. The values are stored one after the
+/// other from user_buf.Buffer(), in the byte order of the host, and
+/// user_buf.Length() is the number of bytes filled; the buffer is expanded
+/// if needed. For a variable size array, the number of values of each
+/// entry is given by the count leaf (see TLeaf::GetLeafCount), whose
+/// branch can itself be read with GetBulkEntries.
+///
+/// The content of the basket is copied with a single memcpy and converted
+/// by one loop over the whole array: there is no call per entry.
+/// The address set for the branch is not used and not updated.
+/// The entries of the basket still being filled (the last one of a tree
+/// being written) are read as well, up to the last entry filled so far,
+/// and the basket is left ready for the next fills.
+///
+/// Returns the number of entries read, 0 if entry is out of range and -1
+/// if the branch can not be read in bulk or in case of error.
+///
+/// ~~~{.cpp}
+///    TBufferFile buf(TBuffer::kWrite, 32000);
+///    TBranch *branch = tree->GetBranch("x");
+///    Long64_t entry = 0;
+///    Int_t n;
+///    while ((n = branch->GetBulkEntries(entry, buf)) > 0) {
+///       const Float_t *x = (const Float_t*)buf.Buffer();
+///       for (Int_t i = 0; i < n; ++i) sum += x[i];
+///       entry += n;
+///    }
+/// ~~~
+
+Int_t TBranch::GetBulkEntries(Long64_t entry, TBuffer &user_buf)
+{
+   if (IsA() != TBranch::Class() || fNleaves != 1) {
+      return -1;
+   }
+   if ((entry < fFirstEntry) || (entry >= fEntryNumber)) {
+      return 0;
+   }
+   fReadEntry = entry;
+
+   Long64_t first = fFirstBasketEntry;
+   if (entry < first || entry >= fNextBasketEntry) {
+      fReadBasket = TMath::BinarySearch(fWriteBasket + 1, fBasketEntry, entry);
+      if (fReadBasket < 0) {
+         fNextBasketEntry = -1;
+         Error("GetBulkEntries", "In the branch %s, no basket contains the entry %lld", GetName(), entry);
+         return -1;
+      }
+      if (fReadBasket == fWriteBasket) {
+         fNextBasketEntry = fEntryNumber;
+      } else {
+         fNextBasketEntry = fBasketEntry[fReadBasket+1];
+      }
+      first = fFirstBasketEntry = fBasketEntry[fReadBasket];
+   }
+   TBasket *basket = (TBasket*) fBaskets.UncheckedAt(fReadBasket);
+   if (!basket) {
+      basket = GetBasket(fReadBasket);
+      if (!basket) {
+         fCurrentBasket = 0;
+         fFirstBasketEntry = -1;
+         fNextBasketEntry = -1;
+         return -1;
+      }
+   }
+   fCurrentBasket = basket;
+   basket->PrepareBasket(entry);
+   TBuffer *buf = basket->GetBufferRef();
+   if (R__unlikely(!buf)) {
+      TFile *file = GetFile(0);
+      if (!file) return -1;
+      basket->ReadBasketBuffers(fBasketSeek[fReadBasket], fBasketBytes[fReadBasket], file);
+      buf = basket->GetBufferRef();
+      if (!buf) return -1;
+   }
+   if (R__unlikely(basket->GetDisplacement())) {
+      return -1;
+   }
+
+   // The values of consecutive entries are contiguous in the basket, up
+   // to the end of the data (the table of entry offsets, if any, follows).
+   // The basket still being filled is left in write mode: its data ends at
+   // the current position of its buffer, GetLast() is only valid once the
+   // basket has been switched to read mode (or read from the file).
+   Int_t last = buf->IsReading() ? basket->GetLast() : buf->Length();
+   Int_t *entryOffset = basket->GetEntryOffset();
+   Int_t begin = entryOffset ? entryOffset[entry-first]
+                             : basket->GetKeylen() + Int_t(entry-first) * basket->GetNevBufSize();
+   Int_t nbytes = last - begin;
+   Int_t nentries = basket->GetNevBuf() - Int_t(entry-first);
+   TLeaf *leaf = (TLeaf*) fLeaves.UncheckedAt(0);
+   if (nbytes < 0 || nentries <= 0 || leaf->GetLenType() <= 0 || nbytes % leaf->GetLenType()) {
+      return -1;
+   }
+
+   if (user_buf.BufferSize() < nbytes) {
+      user_buf.Expand(nbytes, kFALSE);
+   }
+   memcpy(user_buf.Buffer(), buf->Buffer() + begin, nbytes);
+   user_buf.SetBufferOffset(0);
+   if (!leaf->ReadBasketFast(user_buf, nbytes / leaf->GetLenType())) {
+      return -1;
+   }
+   user_buf.SetBufferOffset(nbytes);
+   return nentries;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Fill expectedClass and expectedType with information on the data type of the
 /// object/values contained in this branch (and thus the type of pointers
@@ -1382,6 +1569,10 @@ TFile* TBranch::GetFile(Int_t mode)
 {
    if (fDirectory) return fDirectory->GetFile();
 
+   // The branch is not redirected to another file: no need to look
+   // (under the global lock) in the list of files.
+   if (fFileName.Length() == 0) return 0;
+
    // check if a file with this name is in the list of Root files
    TFile *file = 0;
    {
@@ -1393,8 +1584,6 @@ TFile* TBranch::GetFile(Int_t mode)
       }
    }
 
-   if (fFileName.Length() == 0) return 0;
-
    TString bFileName( GetRealFileName() );
 
    // Open file (new file if mode = 1)
@@ -1646,6 +1835,17 @@ Long64_t TBranch::GetZipBytes(Option_t *option) const
    return zipbytes;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Set the statistics of the basket to nvalues values, 0 for a new basket
+/// and -1 for a basket whose values are not known.
+
+void TBranch::InitBasketStats(Int_t basket, Long64_t nvalues)
+{
+   fBasketMin[basket]     = 0;
+   fBasketMax[basket]     = 0;
+   fBasketNvalues[basket] = nvalues;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return kTRUE if an existing object in a TBranchObject must be deleted.
 
@@ -1899,6 +2099,22 @@ void TBranch::Refresh(TBranch* b)
       fBasketEntry[i] = b->fBasketEntry[i];
       fBasketSeek[i]  = b->fBasketSeek[i];
    }
+   delete [] fBasketMin;
+   delete [] fBasketMax;
+   delete [] fBasketNvalues;
+   fBasketMin = 0;
+   fBasketMax = 0;
+   fBasketNvalues = 0;
+   if (b->fBasketNvalues) {
+      fBasketMin     = new Double_t[fMaxBaskets];
+      fBasketMax     = new Double_t[fMaxBaskets];
+      fBasketNvalues = new Long64_t[fMaxBaskets];
+      for (i=0;i<fMaxBaskets;i++) {
+         fBasketMin[i]     = b->fBasketMin[i];
+         fBasketMax[i]     = b->fBasketMax[i];
+         fBasketNvalues[i] = b->fBasketNvalues[i];
+      }
+   }
    fBaskets.Delete();
    Int_t nbaskets = b->fBaskets.GetSize();
    fBaskets.Expand(nbaskets);
@@ -1951,6 +2167,12 @@ void TBranch::Reset(Option_t*)
       }
    }
 
+   if (fBasketNvalues) {
+      for (Int_t i = 0; i < fMaxBaskets; ++i) {
+         InitBasketStats(i, 0);
+      }
+   }
+
    fBaskets.Delete();
    fNBaskets = 0;
 }
@@ -1992,6 +2214,12 @@ void TBranch::ResetAfterMerge(TFileMergeInfo *)
       }
    }
 
+   if (fBasketNvalues) {
+      for (Int_t i = 0; i < fMaxBaskets; ++i) {
+         InitBasketStats(i, 0);
+      }
+   }
+
    TBasket *reusebasket = (TBasket*)fBaskets[fWriteBasket];
    if (reusebasket) {
       fBaskets[fWriteBasket] = 0;
@@ -2103,6 +2331,44 @@ void TBranch::SetBasketSize(Int_t buffsize)
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Record, if enable is true, the smallest and largest value of the leaf
+/// and the number of values in each basket filled from now on. These
+/// statistics are written with the branch; TTree::Draw and TTreeReader use
+/// them to skip the baskets whose values cannot pass a range cut on the
+/// leaf (see TBasketStatsCut). The baskets already filled are marked as
+/// unknown and are never skipped. If enable is false, the statistics
+/// are dropped.
+///
+/// The statistics are only supported for a TBranch with one numerical
+/// leaf (possibly an array); return false for the other branches.
+
+Bool_t TBranch::SetBasketStats(Bool_t enable)
+{
+   if (!enable) {
+      delete [] fBasketMin;
+      delete [] fBasketMax;
+      delete [] fBasketNvalues;
+      fBasketMin = 0;
+      fBasketMax = 0;
+      fBasketNvalues = 0;
+      return kTRUE;
+   }
+   if (fBasketNvalues) return kTRUE;
+   if (IsA() != TBranch::Class() || fLeaves.GetEntriesFast() != 1) return kFALSE;
+   TLeaf *leaf = (TLeaf*)fLeaves.UncheckedAt(0);
+   if (leaf->InheritsFrom(TLeafC::Class())) return kFALSE;
+
+   fBasketMin     = new Double_t[fMaxBaskets];
+   fBasketMax     = new Double_t[fMaxBaskets];
+   fBasketNvalues = new Long64_t[fMaxBaskets];
+   for (Int_t i = 0; i < fMaxBaskets; ++i) {
+      Bool_t filled = i < fWriteBasket || (i == fWriteBasket && fEntryNumber > fBasketEntry[i]);
+      InitBasketStats(i, filled ? -1 : 0);
+   }
+   return kTRUE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Set address of this branch directly from a TBuffer to avoid streaming.
 ///
@@ -2565,6 +2831,33 @@ Int_t TBranch::WriteBasket(TBasket* basket, Int_t where)
       fEntryOffsetLen = 2*nevbuf; // assume some fluctuations.
    }
 
+   if (fTree->GetImplicitMT() && where == fWriteBasket && basket->IsA() == TBasket::Class()
+       && !basket->GetBufferRef()->TestBit(TBufferFile::kNotDecompressed)) {
+      TFile *file = GetFile(1);
+      if (file && file->IsWritable()) {
+         // Hand the basket over to the tree: it is compressed by the task
+         // pool and written later, see WritePendingBasket. A new basket
+         // will be used for the next entries.
+         fBaskets[where] = 0;
+         --fNBaskets;
+         if (basket == fCurrentBasket) {
+            fCurrentBasket    = 0;
+            fFirstBasketEntry = -1;
+            fNextBasketEntry  = -1;
+         }
+         ++fWriteBasket;
+         if (fWriteBasket >= fMaxBaskets) {
+            ExpandBasketArrays();
+         }
+         fBasketEntry[fWriteBasket] = fEntryNumber;
+         if (fBasketNvalues) InitBasketStats(fWriteBasket, 0);
+         fTree->AddPendingBasket(this, basket, where);
+         return 0;
+      }
+   }
+   // Baskets handed over to the tree must reach the file first.
+   fTree->WritePendingBaskets();
+
    Int_t nout  = basket->WriteBuffer();    //  Write buffer
    fBasketBytes[where]  = basket->GetNbytes();
    fBasketSeek[where]   = basket->GetSeekKey();
@@ -2597,6 +2890,7 @@ Int_t TBranch::WriteBasket(TBasket* basket, Int_t where)
       }
       fBaskets.AddAtAndExpand(reusebasket,fWriteBasket);
       fBasketEntry[fWriteBasket] = fEntryNumber;
+      if (fBasketNvalues) InitBasketStats(fWriteBasket, 0);
    } else {
       --fNBaskets;
       fBaskets[where] = 0;
@@ -2612,6 +2906,43 @@ Int_t TBranch::WriteBasket(TBasket* basket, Int_t where)
    return nout;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Write the basket where, handed over to the tree by WriteBasket and
+/// compressed into nout bytes by the task pool, and update the branch
+/// bookkeeping as WriteBasket does. The basket is reused as write basket
+/// if the branch did not need a new one yet, otherwise it is deleted.
+/// This is called by TTree::WritePendingBaskets, in the order in which
+/// the baskets were handed over.
+///
+/// Return the number of bytes written or -1 in case of error.
+
+Int_t TBranch::WritePendingBasket(TBasket *basket, Int_t where, Int_t nout)
+{
+   if (nout >= 0) {
+      TFile *file = GetFile(1);
+      nout = file ? basket->CommitWriteBuffer(file, nout, where) : -1;
+   }
+   if (nout > 0) {
+      fBasketBytes[where]  = basket->GetNbytes();
+      fBasketSeek[where]   = basket->GetSeekKey();
+      Int_t addbytes = basket->GetObjlen() + basket->GetKeylen();
+      fZipBytes += nout;
+      fTotBytes += addbytes;
+      fTree->AddTotBytes(addbytes);
+      fTree->AddZipBytes(nout);
+   }
+
+   if (fWriteBasket >= fBaskets.GetSize() || !fBaskets.UncheckedAt(fWriteBasket)) {
+      basket->Reset();
+      ++fNBaskets;
+      fBaskets.AddAtAndExpand(basket,fWriteBasket);
+   } else {
+      basket->DropBuffers();
+      delete basket;
+   }
+   return nout;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ///set the first entry number (case of TBranchSTL)
 
@@ -2635,6 +2966,32 @@ void TBranch::SetupAddresses()
    // Nothing to do for regular branch, the TLeaf already did it.
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Add the values of the leaf just filled to the statistics of the write
+/// basket, see SetBasketStats.
+
+void TBranch::UpdateBasketStats()
+{
+   Long64_t &nvalues = fBasketNvalues[fWriteBasket];
+   if (nvalues < 0) return;
+   TLeaf *leaf = (TLeaf*)fLeaves.UncheckedAt(0);
+   Double_t &min = fBasketMin[fWriteBasket];
+   Double_t &max = fBasketMax[fWriteBasket];
+   Int_t len = leaf->GetLen();
+   for (Int_t i = 0; i < len; ++i) {
+      Double_t value = leaf->GetValue(i);
+      if (nvalues == 0) {
+         min = value;
+         max = value;
+      } else if (value < min) {
+         min = value;
+      } else if (value > max) {
+         max = value;
+      }
+      ++nvalues;
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Refresh the value of fDirectory (i.e. where this branch writes/reads its buffers)
 /// with the current value of fTree->GetCurrentFile unless this branch has been
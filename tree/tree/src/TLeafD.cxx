@@ -17,6 +17,7 @@ A TLeaf for a 64 bit floating point data type.
 #include "TBranch.h"
 #include "TClonesArray.h"
 #include "Riostream.h"
+#include "Bytes.h"
 
 ClassImp(TLeafD)
 
@@ -126,6 +127,16 @@ void TLeafD::ReadBasket(TBuffer &b)
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Convert in place the n values at the current position of b, copied in
+/// bulk from a basket by TBranch::GetBulkEntries, to the host byte order.
+
+Bool_t TLeafD::ReadBasketFast(TBuffer &b, Long64_t n)
+{
+   net2host((ULong64_t*)(b.Buffer() + b.Length()), n);
+   return kTRUE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Read leaf elements from Basket input buffer and export buffer to
 /// TClonesArray objects.
@@ -17,6 +17,7 @@ A TLeaf for an Integer data type.
 #include "TBranch.h"
 #include "TClonesArray.h"
 #include "Riostream.h"
+#include "Bytes.h"
 
 ClassImp(TLeafI)
 
@@ -163,6 +164,16 @@ void TLeafI::ReadBasket(TBuffer &b)
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Convert in place the n values at the current position of b, copied in
+/// bulk from a basket by TBranch::GetBulkEntries, to the host byte order.
+
+Bool_t TLeafI::ReadBasketFast(TBuffer &b, Long64_t n)
+{
+   net2host((UInt_t*)(b.Buffer() + b.Length()), n);
+   return kTRUE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Read leaf elements from Basket input buffer and export buffer to
 /// TClonesArray objects.
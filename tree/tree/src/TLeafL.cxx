@@ -17,6 +17,7 @@ A TLeaf for a 64 bit Integer data type.
 #include "TBranch.h"
 #include "TClonesArray.h"
 #include "Riostream.h"
+#include "Bytes.h"
 
 ClassImp(TLeafL)
 
@@ -174,6 +175,16 @@ void TLeafL::ReadBasket(TBuffer &b)
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Convert in place the n values at the current position of b, copied in
+/// bulk from a basket by TBranch::GetBulkEntries, to the host byte order.
+
+Bool_t TLeafL::ReadBasketFast(TBuffer &b, Long64_t n)
+{
+   net2host((ULong64_t*)(b.Buffer() + b.Length()), n);
+   return kTRUE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Read leaf elements from Basket input buffer and export buffer to
 /// TClonesArray objects.
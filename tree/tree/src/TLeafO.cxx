@@ -133,6 +133,15 @@ void TLeafO::ReadBasket(TBuffer &b)
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Values copied in bulk from a basket by TBranch::GetBulkEntries are
+/// single bytes: there is nothing to convert.
+
+Bool_t TLeafO::ReadBasketFast(TBuffer &, Long64_t)
+{
+   return kTRUE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Read leaf elements from Basket input buffer and export buffer to
 /// TClonesArray objects.
@@ -367,9 +367,15 @@ We encourage you to use TTree::AddFriend rather than adding a branch manually.
 #include "TBranchSTL.h"
 #include "TSchemaRuleSet.h"
 #include "TFileMergeInfo.h"
+#include "TTaskPool.h"
+#include "RZip.h"
 
+#include <atomic>
+#include <condition_variable>
 #include <cstddef>
+#include <deque>
 #include <fstream>
+#include <mutex>
 #include <sstream>
 #include <string>
 #include <stdio.h>
@@ -378,6 +384,49 @@ We encourage you to use TTree::AddFriend rather than adding a branch manually.
 Int_t    TTree::fgBranchStyle = 1;  // Use new TBranch style with TBranchElement.
 Long64_t TTree::fgMaxTreeSize = 100000000000LL;
 
+////////////////////////////////////////////////////////////////////////////////
+/// Baskets handed over by TBranch::WriteBasket when the implicit
+/// multi-threading is enabled, in the order in which the sequential code
+/// would have written them. Each basket is compressed by a task of the
+/// default TTaskPool and written by the filling thread once it is done
+/// and all the baskets before it are written (see WritePendingBaskets).
+
+struct TTree::TPendingBaskets {
+   struct TEntry {
+      TBranch            *fBranch;   // Branch owning the basket
+      TBasket            *fBasket;   // Basket to write
+      Int_t               fWhere;    // Index of the basket in the branch
+      Int_t               fNout;     // Result of TBasket::PrepareWriteBuffer
+      Int_t               fMaxBytes; // Upper bound of the number of bytes to write
+      std::atomic<Bool_t> fDone;     // Set by the task once fNout is known
+   };
+   std::deque<TEntry*> fQueue;       // Baskets in write order
+   Long64_t            fMaxBytes;    // Sum of the fMaxBytes of the queued baskets
+   std::mutex          fDoneMutex;   // Protects the transitions of fDone waited for by the filling thread
+   std::condition_variable fDoneCond; // Signalled when a task finished compressing a basket
+
+   TPendingBaskets() : fMaxBytes(0) {}
+
+   // Called by the task once the basket of entry is compressed. The
+   // notification is sent under the lock, so that the waiting thread cannot
+   // delete this object before the task is completely done with it.
+   void SetDone(TEntry *entry)
+   {
+      std::lock_guard<std::mutex> lock(fDoneMutex);
+      entry->fDone = kTRUE;
+      fDoneCond.notify_all();
+   }
+
+   // Help the pool with its queued tasks until the basket of entry is
+   // compressed, then sleep until the task compressing it is done.
+   void Wait(TEntry *entry)
+   {
+      while (!entry->fDone && TTaskPool::GetDefault().RunOne()) {}
+      std::unique_lock<std::mutex> lock(fDoneMutex);
+      fDoneCond.wait(lock, [entry]() { return entry->fDone.load(); });
+   }
+};
+
 ClassImp(TTree)
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -663,6 +712,8 @@ TTree::TTree()
 , fTransientBuffer(0)
 , fCacheDoAutoInit(kTRUE)
 , fCacheUserSet(kFALSE)
+, fIMTEnabled(kFALSE)
+, fPendingBaskets(0)
 {
    fMaxEntries = 1000000000;
    fMaxEntries *= 1000;
@@ -739,6 +790,8 @@ TTree::TTree(const char* name, const char* title, Int_t splitlevel /* = 99 */)
 , fTransientBuffer(0)
 , fCacheDoAutoInit(kTRUE)
 , fCacheUserSet(kFALSE)
+, fIMTEnabled(kFALSE)
+, fPendingBaskets(0)
 {
    // TAttLine state.
    SetLineColor(gStyle->GetHistLineColor());
@@ -784,6 +837,16 @@ TTree::TTree(const char* name, const char* title, Int_t splitlevel /* = 99 */)
 
 TTree::~TTree()
 {
+   if (fPendingBaskets) {
+      // The baskets still being compressed reference our branches. Like the
+      // baskets still in memory in the sequential mode, they are not written:
+      // the file may already be closed and no tree header would point to them.
+      DropPendingBaskets();
+      // A task that signalled an already written basket may still hold the lock.
+      { std::lock_guard<std::mutex> lock(fPendingBaskets->fDoneMutex); }
+      delete fPendingBaskets;
+      fPendingBaskets = 0;
+   }
    if (fDirectory) {
       // We are in a directory, which may possibly be a file.
       if (fDirectory->GetList()) {
@@ -1210,6 +1273,63 @@ TFriendElement* TTree::AddFriend(TTree* tree, const char* alias, Bool_t warn)
    return fe;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Discard the baskets handed over to the task pool in implicit
+/// multi-threading mode (see SetImplicitMT) without writing them, once
+/// their compression is finished. The baskets are written only by
+/// FlushBaskets (and thus AutoSave and Write) and while filling the tree.
+
+void TTree::DropPendingBaskets()
+{
+   if (!fPendingBaskets) return;
+   std::deque<TPendingBaskets::TEntry*> &queue = fPendingBaskets->fQueue;
+   while (!queue.empty()) {
+      TPendingBaskets::TEntry *entry = queue.front();
+      // The task still uses the basket until it is done.
+      fPendingBaskets->Wait(entry);
+      queue.pop_front();
+      entry->fBasket->DropBuffers();
+      delete entry->fBasket;
+      delete entry;
+   }
+   fPendingBaskets->fMaxBytes = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Take ownership of the full basket where of branch and compress it in
+/// the task pool; this is called by TBranch::WriteBasket when the implicit
+/// multi-threading is enabled. The basket is written to the file by
+/// WritePendingBaskets, called regularly while filling the tree.
+
+void TTree::AddPendingBasket(TBranch *branch, TBasket *basket, Int_t where)
+{
+   if (!fPendingBaskets) fPendingBaskets = new TPendingBaskets;
+
+   TPendingBaskets::TEntry *entry = new TPendingBaskets::TEntry;
+   entry->fBranch = branch;
+   entry->fBasket = basket;
+   entry->fWhere  = where;
+   entry->fNout   = -1;
+   entry->fDone   = kFALSE;
+   // The payload is never larger than the uncompressed buffer, to which
+   // the entry offsets (and displacements) are going to be appended.
+   Int_t noffsets = basket->GetEntryOffset() ? 2 * (basket->GetNevBuf() + 2) * sizeof(Int_t) : 0;
+   entry->fMaxBytes = basket->GetBufferRef()->Length() + noffsets;
+   if (entry->fMaxBytes > kMAXZIPBUF) {
+      // Compressed by blocks, each of them might end up slightly larger.
+      entry->fMaxBytes *= 2;
+   }
+   fPendingBaskets->fQueue.push_back(entry);
+   fPendingBaskets->fMaxBytes += entry->fMaxBytes;
+
+   TFile *file = branch->GetFile(1);
+   TPendingBaskets *pending = fPendingBaskets;
+   TTaskPool::GetDefault().Push([entry, file, pending]() {
+      entry->fNout = entry->fBasket->PrepareWriteBuffer(file, kTRUE);
+      pending->SetDone(entry);
+   });
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// AutoSave tree header every fAutoSave bytes.
 ///
@@ -4338,6 +4458,19 @@ Int_t TTree::Fill()
    if (fEntries > fMaxEntries) {
       KeepCircular();
    }
+   if (fPendingBaskets && !fPendingBaskets->fQueue.empty()) {
+      // Write the baskets compressed in the meantime. As long as the clusters
+      // are sized on the number of bytes written, wait for all of them if they
+      // might reach that size, so that the decision below is taken at the same
+      // entry as in the sequential case.
+      Long64_t maxZipBytes = fZipBytes + fPendingBaskets->fMaxBytes;
+      Bool_t wait = fFlushedBytes == 0 && ((fAutoFlush < 0 && maxZipBytes > -fAutoFlush) ||
+                                           (fAutoSave  < 0 && maxZipBytes > -fAutoSave));
+      if (WritePendingBaskets(wait) < 0) {
+         Error("Fill", "Failed writing the baskets of the tree %s, entry=%lld", GetName(), fEntries);
+         ++nerror;
+      }
+   }
    if (gDebug > 0) printf("TTree::Fill - A:  %d %lld %lld %lld %lld %lld %lld \n",
        nbytes, fEntries, fAutoFlush,fAutoSave,fZipBytes,fFlushedBytes,fSavedBytes);
 
@@ -4734,6 +4867,13 @@ Int_t TTree::FlushBaskets() const
          }
       }
    }
+   // In implicit multi-threading mode the baskets were only handed to the task pool.
+   Int_t nwrite = WritePendingBaskets();
+   if (nwrite<0) {
+      ++nerror;
+   } else {
+      nbytes += nwrite;
+   }
    if (nerror) {
       return -1;
    } else {
@@ -7178,6 +7318,7 @@ void TTree::RemoveFriend(TTree* oldFriend)
 
 void TTree::Reset(Option_t* option)
 {
+   WritePendingBaskets();
    fNotify        = 0;
    fEntries       = 0;
    fNClusterRange = 0;
@@ -7209,6 +7350,7 @@ void TTree::Reset(Option_t* option)
 
 void TTree::ResetAfterMerge(TFileMergeInfo *info)
 {
+   WritePendingBaskets();
    fEntries       = 0;
    fNClusterRange = 0;
    fTotBytes      = 0;
@@ -7485,6 +7627,46 @@ void TTree::SetBasketSize(const char* bname, Int_t buffsize)
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Record (or, if enable is false, stop recording) the smallest and largest
+/// value and the number of values in each basket of the branches matching
+/// bname, see TBranch::SetBasketStats. Call it after the branches are
+/// created and before the tree is filled. Only the branches with one
+/// numerical leaf are supported, the other branches matching bname are
+/// ignored.
+///
+/// - if bname="*", apply to all branches.
+/// - if bname="xxx*", apply to all branches with name starting with xxx
+///
+/// With these statistics, TTree::Draw and TTreeReader::SetBasketCut skip
+/// the baskets that cannot pass a range cut on the branches, for example
+///
+///     tree->SetBasketStats("pt");
+///     ...
+///     tree->Draw("eta", "pt > 50");
+///
+/// Return the number of branches changed.
+
+Int_t TTree::SetBasketStats(const char* bname, Bool_t enable)
+{
+   Int_t nleaves = fLeaves.GetEntriesFast();
+   TRegexp re(bname, kTRUE);
+   Int_t nb = 0;
+   for (Int_t i = 0; i < nleaves; i++)  {
+      TLeaf* leaf = (TLeaf*) fLeaves.UncheckedAt(i);
+      TBranch* branch = (TBranch*) leaf->GetBranch();
+      TString s = branch->GetName();
+      if (strcmp(bname, branch->GetName()) && (s.Index(re) == kNPOS)) {
+         continue;
+      }
+      if (branch->SetBasketStats(enable)) nb++;
+   }
+   if (!nb) {
+      Error("SetBasketStats", "no branch with one numerical leaf matches '%s'", bname);
+   }
+   return nb;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Change branch address, dealing with clone trees properly.
 /// See TTree::CheckBranchAddressType for the semantic of the return value.
@@ -7764,6 +7946,9 @@ void TTree::SetBranchStyle(Int_t style)
 /// - if cachesize = -1 (default) it is set to the AutoFlush value when writing
 ///    the Tree (default is 30 MBytes).
 ///
+/// A new cache imports the configured learning profile, if any (see
+/// TTreeCache::ImportConfiguredProfile).
+///
 /// Returns:
 /// - 0 size set, cache was created if possible
 /// - -1 on error
@@ -7900,6 +8085,7 @@ Int_t TTree::SetCacheSizeAux(Bool_t autocache /* = kTRUE */, Long64_t cacheSize
       pf = new TTreeCache(this, cacheSize);
 
    pf->SetAutoCreated(autocache);
+   pf->ImportConfiguredProfile();
 
    return 0;
 }
@@ -8219,6 +8405,38 @@ void TTree::SetFileNumber(Int_t number)
    fFileNumber = number;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Enable or disable the implicit multi-threading of Fill.
+///
+/// When enabled, the baskets that are full are no longer compressed and
+/// written by the thread calling Fill: they are handed to the tasks of the
+/// default TTaskPool (see TTaskPool::SetDefaultSize) which compress them
+/// in parallel, while the filling continues. The compressed baskets are
+/// then written by the filling thread, strictly in the order in which they
+/// would have been written sequentially, during the following calls to
+/// Fill and at the latest in FlushBaskets, AutoSave or Write. The layout
+/// of the file is hence the same as without multi-threading; only the
+/// time at which the tree switches to a new file when reaching
+/// TTree::GetMaxTreeSize may differ by a few baskets.
+///
+/// The memory used grows by the size of the baskets being compressed.
+/// While the size of the first cluster is determined by the number of
+/// compressed bytes (negative value of SetAutoFlush or SetAutoSave, which
+/// is the default), Fill waits for the compression of the pending baskets
+/// whenever they could make the tree reach that size.
+/// Disabling the implicit multi-threading writes all the pending baskets.
+///
+/// Baskets of a TTreeSQL or of a branch using SetSkipZip are always
+/// processed sequentially.
+
+void TTree::SetImplicitMT(Bool_t enabled)
+{
+   if (!enabled) {
+      WritePendingBaskets();
+   }
+   fIMTEnabled = enabled;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Set all the branches in this TTree to be in decomposed object mode
 /// (also known as MakeClass mode).
@@ -8640,6 +8858,8 @@ void TTree::Streamer(TBuffer& b)
       b.CheckByteCount(R__s, R__c, TTree::IsA());
       //====end of old versions
    } else {
+      // The branches must know where all their baskets are.
+      WritePendingBaskets();
       if (fBranchRef) {
          fBranchRef->Clear();
       }
@@ -8767,6 +8987,47 @@ Int_t TTree::Write(const char *name, Int_t option, Int_t bufsize)
    return ((const TTree*)this)->Write(name, option, bufsize);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Write to the file the baskets handed over to the task pool in implicit
+/// multi-threading mode (see SetImplicitMT) whose compression is finished,
+/// in the order in which they were handed over. If wait is true, wait for
+/// (and help with) the compression of all of them.
+///
+/// Return the number of bytes written or -1 in case of write error.
+
+Int_t TTree::WritePendingBaskets(Bool_t wait) const
+{
+   if (!fPendingBaskets) return 0;
+   Int_t nbytes = 0;
+   Int_t nerror = 0;
+   std::deque<TPendingBaskets::TEntry*> &queue = fPendingBaskets->fQueue;
+
+   // Do not let the uncompressed baskets pile up if the filling is
+   // faster than the compression.
+   const size_t maxPending = 4 * TTaskPool::GetDefault().GetPoolSize() + 16;
+   while (!queue.empty()) {
+      TPendingBaskets::TEntry *entry = queue.front();
+      if (!entry->fDone) {
+         if (!wait && queue.size() <= maxPending) break;
+         fPendingBaskets->Wait(entry);
+      }
+      queue.pop_front();
+      fPendingBaskets->fMaxBytes -= entry->fMaxBytes;
+      Int_t nwrite = entry->fBranch->WritePendingBasket(entry->fBasket, entry->fWhere, entry->fNout);
+      delete entry;
+      if (nwrite < 0) {
+         ++nerror;
+      } else {
+         nbytes += nwrite;
+      }
+   }
+   if (nerror) {
+      return -1;
+   } else {
+      return nbytes;
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// \class TTreeFriendLeafIter
 ///
@@ -211,6 +211,42 @@ branches that will be used very rarely.
        ... here you process your entry
     }
 ~~~
+### 4. with a learning profile
+
+The branches learned by a cache, its profile, can be saved at the end of
+a job and given to the caches of later jobs. These caches skip the
+learning phase: the baskets of the branches of the profile are prefetched
+from the first entry on, instead of being read one by one during the
+first fgLearnEntries entries of the job. Over a high latency network this
+saves one round-trip per branch (or the reading of the baskets of all the
+branches when the learning phase is prefilled).
+~~~ {.cpp}
+    // first job: learn as usual, then save the profile to a small file
+    TTree *T = (TTree*)f->Get("mytree");
+    T->SetCacheSize(cachesize);
+    ... event loop
+    TTreeCache *tc = (TTreeCache*)f->GetCacheRead(T);
+    tc->SaveProfile("mytree_profile.root");  //<<<
+
+    // later jobs on the same kind of files
+    T->SetCacheSize(cachesize);
+    TTreeCache *tc = (TTreeCache*)f->GetCacheRead(T);
+    tc->LoadProfile("mytree_profile.root");  //<<<
+    ... event loop
+~~~
+A cache created by TTree::SetCacheSize imports automatically the profile
+stored for the tree in the file given by the TTreeCache.Profile resource
+(or the ROOT_TTREECACHE_PROFILE environment variable) or, if there is
+none, the profile stored in the user info of the tree (see
+TTree::GetUserInfo), for example by the job writing the tree:
+~~~ {.cpp}
+    T->GetUserInfo()->Add(tc->ExportProfile());
+~~~
+Branches of the profile missing from the tree are ignored; branches read
+but not in the profile are read without the cache. The number of reads
+done in the learning phase and an estimate of the number of reads saved
+by the profile are shown by TTreeCache::Print.
+
 ## SPECIAL CASES WHERE TreeCache should not be activated
 
 When reading only a small fraction of all entries such that not all branch
@@ -244,6 +280,53 @@ Int_t TTreeCache::fgLearnEntries = 100;
 
 ClassImp(TTreeCache)
 
+namespace {
+
+// Name of the profile lists, and prefix of their keys in a profile file.
+const char *kProfileName = "TTreeCacheProfile";
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the name of the key of the profile of the tree treename.
+
+TString ProfileKeyName(const char *treename)
+{
+   return TString::Format("%s_%s", kProfileName, treename);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the number of baskets of branch holding entries in [first,last).
+
+Int_t CountBaskets(TBranch *branch, Long64_t first, Long64_t last)
+{
+   Int_t nbaskets = branch->GetWriteBasket();
+   Long64_t *entries = branch->GetBasketEntry();
+   Int_t n = 0;
+   for (Int_t i = 0; i < nbaskets; ++i) {
+      Long64_t end = i + 1 < nbaskets ? entries[i + 1] : branch->GetEntries();
+      if (entries[i] < last && end > first) ++n;
+   }
+   return n;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the profile of the tree treename saved in the file filename, or
+/// 0 if the file or the profile can not be read.
+
+TList *ReadProfile(const char *filename, const char *treename)
+{
+   TDirectory::TContext ctxt;
+   TFile *file = TFile::Open(filename, "READ");
+   TList *profile = 0;
+   if (file && !file->IsZombie()) {
+      file->GetObject(ProfileKeyName(treename), profile);
+      if (profile) profile->SetOwner(kTRUE);
+   }
+   delete file;
+   return profile;
+}
+
+} // unnamed namespace
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Default Constructor.
 
@@ -270,7 +353,9 @@ TTreeCache::TTreeCache() : TFileCacheRead(),
    fReadDirectionSet(kFALSE),
    fEnabled(kTRUE),
    fPrefillType(GetConfiguredPrefillType()),
-   fAutoCreated(kFALSE)
+   fAutoCreated(kFALSE),
+   fNReadLearn(0),
+   fNReadSaved(0)
 {
 }
 
@@ -300,7 +385,9 @@ TTreeCache::TTreeCache(TTree *tree, Int_t buffersize) : TFileCacheRead(tree->Get
    fReadDirectionSet(kFALSE),
    fEnabled(kTRUE),
    fPrefillType(GetConfiguredPrefillType()),
-   fAutoCreated(kFALSE)
+   fAutoCreated(kFALSE),
+   fNReadLearn(0),
+   fNReadSaved(0)
 {
    fEntryNext = fEntryMin + fgLearnEntries;
    Int_t nleaves = tree->GetListOfLeaves()->GetEntries();
@@ -611,6 +698,27 @@ Int_t TTreeCache::DropBranch(const char *bname, Bool_t subbranches /*= kFALSE*/)
    return res;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the profile of the cache: a new list, owned by the caller, of
+/// TObjString holding the names of the branches in the cache, or 0 if
+/// there is none. The list is named "TTreeCacheProfile".
+/// The profile can be given to ImportProfile, saved in a file (see
+/// SaveProfile) or added to the user info of the tree before writing it.
+
+TList *TTreeCache::ExportProfile() const
+{
+   if (!fBrNames || fBrNames->GetEntries() == 0) return 0;
+   TList *profile = new TList;
+   profile->SetName(kProfileName);
+   profile->SetOwner(kTRUE);
+   TIter next(fBrNames);
+   TObjString *os;
+   while ((os = (TObjString*)next())) {
+      profile->Add(new TObjString(os->GetName()));
+   }
+   return profile;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Fill the cache buffer with the branches in the cache.
 
@@ -933,6 +1041,21 @@ TTreeCache::EPrefillType TTreeCache::GetConfiguredPrefillType() const
    return static_cast<TTreeCache::EPrefillType>(s);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the name of the file holding the profiles to import in the
+/// automatically created caches, from the ROOT_TTREECACHE_PROFILE
+/// environment variable or the TTreeCache.Profile resource variable (an
+/// empty string if neither is set).
+
+const char *TTreeCache::GetConfiguredProfile() const
+{
+   const char *stcp = gSystem->Getenv("ROOT_TTREECACHE_PROFILE");
+   if (!stcp || !*stcp) {
+      stcp = gEnv->GetValue("TTreeCache.Profile", "");
+   }
+   return stcp;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Give the total efficiency of the cache... defined as the ratio
 /// of blocks found in the cache vs. the number of blocks prefetched
@@ -971,6 +1094,84 @@ Int_t TTreeCache::GetLearnEntries()
    return fgLearnEntries;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Import the configured profile (see GetConfiguredProfile) or, if there
+/// is none, the profile found in the user info of the tree.
+/// This is called by TTree::SetCacheSize when it creates a cache.
+/// Returns the value of ImportProfile, or 0 if there is no profile.
+
+Int_t TTreeCache::ImportConfiguredProfile()
+{
+   if (!fTree) return 0;
+   const char *filename = GetConfiguredProfile();
+   if (filename && *filename) {
+      TList *profile = ReadProfile(filename, fTree->GetName());
+      if (profile) {
+         Int_t res = ImportProfile(profile);
+         delete profile;
+         return res;
+      }
+   }
+   TList *profile = dynamic_cast<TList*>(fTree->GetUserInfo()->FindObject(kProfileName));
+   if (!profile) return 0;
+   return ImportProfile(profile);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Put in the cache the branches of profile (a list of objects named
+/// after the branches, see ExportProfile) and stop the learning phase,
+/// so that the cache is filled from the first entry on.
+/// The branches of the profile missing from the tree are ignored.
+/// Returns:
+///  - the number of branches of the profile put in the cache
+///  - -1 if the cache is not learning anymore or if profile is 0
+
+Int_t TTreeCache::ImportProfile(const TList *profile)
+{
+   if (!profile || !fTree || !fIsLearning) return -1;
+
+   // Without the profile, the learning phase would have read the baskets
+   // of these entries one by one, or all at once when prefilling.
+   Long64_t learnMax = fEntryMin + fgLearnEntries;
+   if (fEntryMax > 0 && learnMax > fEntryMax) learnMax = fEntryMax;
+   Int_t nadded = 0;
+   Int_t nbaskets = 0;
+   TIter next(profile);
+   TObject *obj;
+   while ((obj = next())) {
+      TBranch *branch = fTree->GetBranch(obj->GetName());
+      if (!branch || AddBranch(branch) < 0) {
+         if (gDebug > 0) Info("ImportProfile", "branch %s of the profile is not in the cache", obj->GetName());
+         continue;
+      }
+      nbaskets += CountBaskets(branch, fEntryMin, learnMax);
+      ++nadded;
+   }
+   if (!nadded) return 0;
+   fNReadSaved = (fPrefillType == kNoPrefill || !nbaskets) ? nbaskets : 1;
+   StopLearningPhase();
+   return nadded;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Import the profile of the tree saved in the file filename by
+/// SaveProfile.
+/// Returns the value of ImportProfile, or -1 if the file or the profile
+/// can not be read.
+
+Int_t TTreeCache::LoadProfile(const char *filename)
+{
+   if (!fTree) return -1;
+   TList *profile = ReadProfile(filename, fTree->GetName());
+   if (!profile) {
+      Error("LoadProfile", "cannot read the profile of the tree %s from %s", fTree->GetName(), filename);
+      return -1;
+   }
+   Int_t res = ImportProfile(profile);
+   delete profile;
+   return res;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Print cache statistics. Like:
 ///
@@ -980,6 +1181,8 @@ Int_t TTreeCache::GetLearnEntries()
 ///    Cache Efficiency ..................: 0.997372
 ///    Cache Efficiency Rel...............: 1.000000
 ///    Learn entries......................: 100
+///    Learning phase reads...............: 0
+///    Reads saved by the profile.........: 1093
 ///    Reading............................: 72761843 bytes in 7 transactions
 ///    Readahead..........................: 256000 bytes with overhead = 0 bytes
 ///    Average transaction................: 10394.549000 Kbytes
@@ -1001,6 +1204,8 @@ void TTreeCache::Print(Option_t *option) const
    printf("Cache Efficiency ..................: %f\n",GetEfficiency());
    printf("Cache Efficiency Rel...............: %f\n",GetEfficiencyRel());
    printf("Learn entries......................: %d\n",TTreeCache::GetLearnEntries());
+   printf("Learning phase reads...............: %d\n",fNReadLearn);
+   printf("Reads saved by the profile.........: %d\n",fNReadSaved);
    if ( opt.Contains("cachedbranches") ) {
       opt.ReplaceAll("cachedbranches","");
       printf("Cached branches....................:\n");
@@ -1037,6 +1242,7 @@ Int_t TTreeCache::ReadBufferNormal(char *buf, Long64_t pos, Int_t len){
       return res;
    }
    fNReadMiss++;
+   if (fIsLearning) fNReadLearn++;
 
    return 0;
 }
@@ -1065,6 +1271,7 @@ Int_t TTreeCache::ReadBufferPrefetch(char *buf, Long64_t pos, Int_t len){
       }
       FillBuffer();
       fNReadMiss++;
+      if (fIsLearning) fNReadLearn++;
       counter++;
       if (counter>1) {
         return 0;
@@ -1109,6 +1316,35 @@ void TTreeCache::ResetCache()
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Save the profile of the cache (see ExportProfile) in the file filename,
+/// created if needed, replacing the profile previously saved there for
+/// the same tree name. The profiles are stored under the key
+/// "TTreeCacheProfile_<tree name>".
+/// Returns:
+///  - 0 on success
+///  - -1 if there is no branch in the cache or on write error
+
+Int_t TTreeCache::SaveProfile(const char *filename) const
+{
+   TList *profile = ExportProfile();
+   if (!profile) {
+      Error("SaveProfile", "no branch in the cache of the tree %s", fTree ? fTree->GetName() : "");
+      return -1;
+   }
+   TDirectory::TContext ctxt;
+   TFile *file = TFile::Open(filename, "UPDATE");
+   Int_t nbytes = 0;
+   if (file && !file->IsZombie()) {
+      nbytes = file->WriteTObject(profile, ProfileKeyName(fTree->GetName()), "WriteDelete");
+   } else {
+      Error("SaveProfile", "cannot open the profile file %s", filename);
+   }
+   delete file;
+   delete profile;
+   return nbytes > 0 ? 0 : -1;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Change the underlying buffer size of the cache.
 /// If the change of size means some cache content is lost, or if the buffer
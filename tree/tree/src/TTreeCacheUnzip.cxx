@@ -19,41 +19,52 @@ Core TTree-related code borrowed from the previous version
 
 ## Parallel Unzipping
 
-TTreeCache has been specialised in order to let additional threads
-free to unzip in advance its content. In this implementation we
-support up to 10 threads, but right now it makes more sense to
-limit their number to 1-2
-
-The application reading data is carefully synchronized, in order to:
- - if the block it wants is not unzipped, it self-unzips it without
-   waiting
- - if the block is being unzipped in parallel, it waits only
+TTreeCache has been specialised in order to unzip its content in
+advance, in parallel. As soon as the baskets of a cluster have been
+transferred into the cache, one task per basket is handed to the
+work-stealing TTaskPool shared by the ROOT libraries
+(TTaskPool::GetDefault(), one worker per core by default), so that
+all the baskets of the cluster are unzipped concurrently.
+
+The application reading data is synchronized with the tasks, in order to:
+ - if the block it wants is not unzipped and no task started on it,
+   it self-unzips it without waiting
+ - if the block is being unzipped by a task, it waits only
    for that unzip to finish
- - if the block has already been unzipped, it takes it
+ - if the block has already been unzipped, it takes it: the unzipped
+   buffer is handed over to the TBasket, without any copy.
 
 This is supposed to cancel a part of the unzipping latency, at the
 expenses of cpu time.
 
-The default parameters are the same of the prev version, i.e. 20%
-of the TTreeCache cache size. To change it use
-TTreeCache::SetUnzipBufferSize(Long64_t bufferSize)
-where bufferSize must be passed in bytes.
+The amount of compressed data for which unzip tasks are outstanding
+is limited by default to the size of the TTreeCache (i.e. a whole
+cluster). To change it use
+TTreeCacheUnzip::SetUnzipBufferSize(Long64_t bufferSize)
+where bufferSize must be passed in bytes, or
+TTreeCacheUnzip::SetUnzipRelBufferSize(Float_t relbufferSize)
+to give it relative to the cache size.
+
+For each cluster the time between the start of the unzipping and the
+availability of its last basket (the cluster unzip latency) and the
+time spent unzipping its baskets are reported to the TTreePerfStats
+of the tree (or to gPerfStats) via TVirtualPerfStats::UnzipClusterEvent.
 */
 
 #include "TTreeCacheUnzip.h"
 #include "TChain.h"
 #include "TBranch.h"
+#include "TBufferPool.h"
 #include "TFile.h"
 #include "TEventList.h"
 #include "TVirtualMutex.h"
-#include "TThread.h"
-#include "TCondition.h"
+#include "TVirtualPerfStats.h"
+#include "TTaskPool.h"
+#include "TTimeStamp.h"
+#include "TMutex.h"
 #include "TMath.h"
 #include "Bytes.h"
 
-#include "TEnv.h"
-
-#define THREADCNT 2
 extern "C" void R__unzip(Int_t *nin, UChar_t *bufin, Int_t *lout, char *bufout, Int_t *nout);
 extern "C" int R__unzip_header(Int_t *nin, UChar_t *bufin, Int_t *lout);
 
@@ -62,30 +73,13 @@ TTreeCacheUnzip::EParUnzipMode TTreeCacheUnzip::fgParallel = TTreeCacheUnzip::kD
 // The unzip cache does not consume memory by itself, it just allocates in advance
 // mem blocks which are then picked as they are by the baskets.
 // Hence there is no good reason to limit it too much
-Double_t TTreeCacheUnzip::fgRelBuffSize = .5;
+Double_t TTreeCacheUnzip::fgRelBuffSize = 1.;
 
 ClassImp(TTreeCacheUnzip)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-TTreeCacheUnzip::TTreeCacheUnzip() : TTreeCache(),
-
-   fActiveThread(kFALSE),
-   fAsyncReading(kFALSE),
-   fCycle(0),
-   fLastReadPos(0),
-   fBlocksToGo(0),
-   fUnzipLen(0),
-   fUnzipChunks(0),
-   fUnzipStatus(0),
-   fTotalUnzipBytes(0),
-   fNseekMax(0),
-   fUnzipBufferSize(0),
-   fNUnzip(0),
-   fNFound(0),
-   fNStalls(0),
-   fNMissed(0)
-
+TTreeCacheUnzip::TTreeCacheUnzip() : TTreeCache()
 {
    // Default Constructor.
 
@@ -95,22 +89,7 @@ TTreeCacheUnzip::TTreeCacheUnzip() : TTreeCache(),
 ////////////////////////////////////////////////////////////////////////////////
 /// Constructor.
 
-TTreeCacheUnzip::TTreeCacheUnzip(TTree *tree, Int_t buffersize) : TTreeCache(tree,buffersize),
-   fActiveThread(kFALSE),
-   fAsyncReading(kFALSE),
-   fCycle(0),
-   fLastReadPos(0),
-   fBlocksToGo(0),
-   fUnzipLen(0),
-   fUnzipChunks(0),
-   fUnzipStatus(0),
-   fTotalUnzipBytes(0),
-   fNseekMax(0),
-   fUnzipBufferSize(0),
-   fNUnzip(0),
-   fNFound(0),
-   fNStalls(0),
-   fNMissed(0)
+TTreeCacheUnzip::TTreeCacheUnzip(TTree *tree, Int_t buffersize) : TTreeCache(tree,buffersize)
 {
    Init();
 }
@@ -122,44 +101,51 @@ void TTreeCacheUnzip::Init()
 {
    fMutexList        = new TMutex(kTRUE);
    fIOMutex          = new TMutex(kTRUE);
-
-   fUnzipStartCondition   = new TCondition(fMutexList);
-   fUnzipDoneCondition   = new TCondition(fMutexList);
-
-   fTotalUnzipBytes = 0;
-
-   fCompBuffer = new char[16384];
-   fCompBufferSize = 16384;
-
-   if (fgParallel == kDisable) {
-      fParallel = kFALSE;
-   }
-   else if(fgParallel == kEnable || fgParallel == kForce) {
-      SysInfo_t info;
-      gSystem->GetSysInfo(&info);
-
-      fUnzipBufferSize = Long64_t(fgRelBuffSize * GetBufferSize());
-
-      if(gDebug > 0)
-         Info("TTreeCacheUnzip", "Enabling Parallel Unzipping");
-
-      fParallel = kTRUE;
-
-      for (Int_t i = 0; i < 10; i++) fUnzipThread[i] = 0;
-
-      StartThreadUnzip(THREADCNT);
-
+   fUnzipTasks       = 0;
+
+   fUnzipLen         = 0;
+   fUnzipChunks      = 0;
+   fUnzipState       = 0;
+   fUnzipCancel      = kFALSE;
+   fUnzipActive      = kFALSE;
+   fUnzipDirect      = kFALSE;
+   fNseekMax         = 0;
+   fNextToUnzip      = 0;
+   fUnzipBufferSize  = 0;
+   fUnzipScheduled   = 0;
+
+   fClusterEntry     = -1;
+   fClusterBaskets   = 0;
+   fClusterStart     = 0;
+   fClusterStop      = 0;
+   fClusterToGo      = 0;
+   fClusterUnzipTime = 0;
+   fClusterDone      = kFALSE;
+   fClusterReported  = kTRUE;
+   fNClusters        = 0;
+   fClusterLatency   = 0;
+
+   fNUnzip           = 0;
+   fNFound           = 0;
+   fNStalls          = 0;
+   fNMissed          = 0;
+
+   fParallel = kFALSE;
+   if (fgParallel == kEnable || fgParallel == kForce) {
+      // kEnable only goes parallel if there is more than one core to unzip on.
+      if (fgParallel == kForce || TTaskPool::GetDefaultSize() > 1) {
+         fUnzipBufferSize = Long64_t(fgRelBuffSize * GetBufferSize());
+
+         if(gDebug > 0)
+            Info("TTreeCacheUnzip", "Enabling Parallel Unzipping");
+
+         fParallel = kTRUE;
+         fUnzipTasks = new TTaskGroup(TTaskPool::GetDefault());
+      }
    }
-   else {
+   else if (fgParallel != kDisable) {
       Warning("TTreeCacheUnzip", "Parallel Option unknown");
    }
-
-   // Check if asynchronous reading is supported by this TFile specialization
-   if (gEnv->GetValue("TFile.AsyncReading", 1)) {
-      if (fFile && !(fFile->ReadBufferAsync(0, 0)))
-         fAsyncReading = kTRUE;
-   }
-
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -167,20 +153,17 @@ void TTreeCacheUnzip::Init()
 
 TTreeCacheUnzip::~TTreeCacheUnzip()
 {
+   // The tree might be gone already, do not report the last cluster.
+   fClusterReported = kTRUE;
    ResetCache();
 
-   if (IsActiveThread())
-      StopThreadUnzip();
-
-   delete [] fUnzipLen;
-
-   delete fUnzipStartCondition;
-   delete fUnzipDoneCondition;
+   delete fUnzipTasks;
 
    delete fMutexList;
    delete fIOMutex;
 
-   delete [] fUnzipStatus;
+   delete [] fUnzipLen;
+   delete [] fUnzipState;
    delete [] fUnzipChunks;
 }
 
@@ -213,16 +196,18 @@ Int_t TTreeCacheUnzip::AddBranch(const char *branch, Bool_t subbranches /*= kFAL
 }
 
 ////////////////////////////////////////////////////////////////////////////////
+/// Fill the cache with the baskets of the cluster containing the current
+/// entry and, in parallel mode, start the tasks unzipping them.
 
 Bool_t TTreeCacheUnzip::FillBuffer()
 {
    if (fNbranches <= 0) return kFALSE;
+
+   TTree *tree = ((TBranch*)fBranches->UncheckedAt(0))->GetTree();
    {
       // Fill the cache buffer with the branches in the cache.
       R__LOCKGUARD(fMutexList);
-      fIsTransferred = kFALSE;
 
-      TTree *tree = ((TBranch*)fBranches->UncheckedAt(0))->GetTree();
       Long64_t entry = tree->GetReadEntry();
 
       // If the entry is in the range we previously prefetched, there is
@@ -231,6 +216,11 @@ Bool_t TTreeCacheUnzip::FillBuffer()
       // the end of the training phase).
       if (fEntryCurrent <= entry  && entry < fEntryNext) return kFALSE;
 
+      // The content of the cache is going to be replaced, the unzip
+      // tasks working on it must be stopped first.
+      ResetCache();
+      fIsTransferred = kFALSE;
+
       // Triggered by the user, not the learning phase
       if (entry == -1)  entry=0;
 
@@ -292,12 +282,58 @@ Bool_t TTreeCacheUnzip::FillBuffer()
          if (gDebug > 0) printf("Entry: %lld, registering baskets branch %s, fEntryNext=%lld, fNseek=%d, fNtot=%d\n",entry,((TBranch*)fBranches->UncheckedAt(i))->GetName(),fEntryNext,fNseek,fNtot);
       }
 
-      // Now fix the size of the status arrays
-      ResetCache();
-
       fIsLearning = kFALSE;
+   }
+
+   if (!fParallel || fEnablePrefetching || fNseek <= 0) return kTRUE;
 
+   // Sort the baskets and transfer them now: the unzip tasks work on the
+   // content of the cache.
+   {
+      R__LOCKGUARD(fIOMutex);
+      TVirtualPerfStats* temp = gPerfStats;
+      if (tree->GetPerfStats() != 0) gPerfStats = tree->GetPerfStats();
+      Int_t loc = -1;
+      TFileCacheRead::ReadBufferExt(0, fSeek[0], 0, loc);
+      gPerfStats = temp;
    }
+   if (!fIsSorted || !fIsTransferred) return kTRUE;
+
+   // Now fix the size of the status arrays, they are indexed like fSeekSort
+   if (fNseekMax < fNseek) {
+      if (gDebug > 0)
+         Info("FillBuffer", "Changing fNseekMax from:%d to:%d", fNseekMax, fNseek);
+
+      delete [] fUnzipState;
+      delete [] fUnzipLen;
+      delete [] fUnzipChunks;
+
+      fUnzipState  = new std::atomic<Byte_t>[fNseek];
+      fUnzipLen    = new Int_t[fNseek];
+      fUnzipChunks = new char *[fNseek];
+      for (Int_t i = 0; i < fNseek; i++) {
+         fUnzipState[i] = kUntouched;
+         fUnzipLen[i] = 0;
+         fUnzipChunks[i] = 0;
+      }
+
+      fNseekMax  = fNseek;
+   }
+
+   // With asynchronous reading the data does not end up in fBuffer and
+   // the tasks have to go through ReadBufferExt.
+   fUnzipDirect      = !TFileCacheRead::fAsyncReading;
+   fUnzipActive      = kTRUE;
+
+   fClusterEntry     = fEntryCurrent;
+   fClusterBaskets   = fNseek;
+   fClusterToGo      = fNseek;
+   fClusterUnzipTime = 0;
+   fClusterDone      = kFALSE;
+   fClusterReported  = kFALSE;
+   fClusterStart     = TTimeStamp();
+
+   ScheduleUnzip();
 
    return kTRUE;
 }
@@ -313,12 +349,14 @@ Int_t TTreeCacheUnzip::SetBufferSize(Int_t buffersize)
 {
    R__LOCKGUARD(fMutexList);
 
+   // The unzip tasks must not be working on the buffer when it is reallocated.
+   ResetCache();
+
    Int_t res = TTreeCache::SetBufferSize(buffersize);
    if (res < 0) {
       return res;
    }
    fUnzipBufferSize = Long64_t(fgRelBuffSize * GetBufferSize());
-   ResetCache();
    return 1;
 }
 
@@ -334,6 +372,17 @@ void TTreeCacheUnzip::SetEntryRange(Long64_t emin, Long64_t emax)
    TTreeCache::SetEntryRange(emin, emax);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Change the file to be cached, after stopping the unzipping of the
+/// content of the cache.
+
+void TTreeCacheUnzip::SetFile(TFile *file, TFile::ECacheAction action)
+{
+   ResetCache();
+
+   TTreeCache::SetFile(file, action);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// It's the same as TTreeCache::StopLearningPhase but we guarantee that
 /// we start the unzipping just after getting the buffers
@@ -382,62 +431,15 @@ Bool_t TTreeCacheUnzip::IsParallelUnzip()
    return kFALSE;
 }
 
-////////////////////////////////////////////////////////////////////////////////
-/// This indicates if the thread is active in this moment...
-/// this variable is very important because if we change it from true to
-/// false the thread will stop... ( see StopThreadTreeCacheUnzip() )
-
-Bool_t TTreeCacheUnzip::IsActiveThread()
-{
-   R__LOCKGUARD(fMutexList);
-
-   return fActiveThread;
-}
-
-////////////////////////////////////////////////////////////////////////////////
-/// It says if the queue is empty... useful to see if we have to process it.
-
-Bool_t TTreeCacheUnzip::IsQueueEmpty()
-{
-   R__LOCKGUARD(fMutexList);
-
-   if ( fIsLearning )
-      return kTRUE;
-
-   return kFALSE;
-}
-
-void TTreeCacheUnzip::WaitUnzipStartSignal()
-{
-   // Here the threads sleep waiting for some blocks to unzip
-
-   fUnzipStartCondition->TimedWaitRelative(2000);
-
-}
-
-////////////////////////////////////////////////////////////////////////////////
-/// This will send the signal corresponfing to the queue... normally used
-/// when we want to start processing the list of buffers.
-
-void TTreeCacheUnzip::SendUnzipStartSignal(Bool_t broadcast)
-{
-   if (gDebug > 0) Info("SendSignal", " fUnzipCondition->Signal()");
-
-   if (broadcast)
-      fUnzipStartCondition->Broadcast();
-   else
-      fUnzipStartCondition->Signal();
-}
-
 ////////////////////////////////////////////////////////////////////////////////
 /// Static function that (de)activates multithreading unzipping
 ///
 /// The possible options are:
-///  - kEnable _Enable_ it, which causes an automatic detection and launches the
-///    additional thread if the number of cores in the machine is greater than
-///    one
-///  - kDisable _Disable_ will not activate the additional thread.
-///  - kForce _Force_ will start the additional thread even if there is only one
+///  - kEnable _Enable_ it, which causes an automatic detection and unzips
+///    the baskets with the tasks of TTaskPool::GetDefault() if the number
+///    of cores in the machine is greater than one
+///  - kDisable _Disable_ will not activate the parallel unzipping.
+///  - kForce _Force_ will unzip in parallel even if there is only one
 ///    core. the default will be taken as kEnable.
 ///
 /// Returns 0 if there was an error, 1 otherwise.
@@ -451,137 +453,6 @@ Int_t TTreeCacheUnzip::SetParallelUnzip(TTreeCacheUnzip::EParUnzipMode option)
    return 0;
 }
 
-class TTreeCacheUnzipData {
-public:
-   TTreeCacheUnzip *fInstance;
-   Int_t            fCount;
-};
-
-////////////////////////////////////////////////////////////////////////////////
-/// The Thread is only a part of the TTreeCache but it is the part that
-/// waits for info in the queue and process it... unfortunatly, a Thread is
-/// not an object an we have to deal with it in the old C-Style way
-/// Returns 0 if the thread was initialized or 1 if it was already running
-
-Int_t TTreeCacheUnzip::StartThreadUnzip(Int_t nthreads)
-{
-   Int_t nt = nthreads;
-   if (nt > 10) nt = 10;
-
-   if (gDebug > 0)
-      Info("StartThreadUnzip", "Going to start %d threads.", nt);
-
-   for (Int_t i = 0; i < nt; i++) {
-      if (!fUnzipThread[i]) {
-         TString nm("UnzipLoop");
-         nm += i;
-
-         if (gDebug > 0)
-            Info("StartThreadUnzip", "Going to start thread '%s'", nm.Data());
-
-         TTreeCacheUnzipData *d = new TTreeCacheUnzipData;
-         d->fInstance = this;
-         d->fCount = i;
-
-         fUnzipThread[i] = new TThread(nm.Data(), UnzipLoop, (void*)d);
-         if (!fUnzipThread[i])
-            Error("TTreeCacheUnzip::StartThreadUnzip", " Unable to create new thread.");
-
-         fUnzipThread[i]->Run();
-
-         // There is at least one active thread
-         fActiveThread=kTRUE;
-
-      }
-   }
-
-   return (fActiveThread == kTRUE);
-}
-
-////////////////////////////////////////////////////////////////////////////////
-/// To stop the thread we only need to change the value of the variable
-/// fActiveThread to false and the loop will stop (of course, we will have)
-/// to do the cleaning after that.
-///
-/// Note: The syncronization part is important here or we will try to delete
-///       teh object while it's still processing the queue
-
-Int_t TTreeCacheUnzip::StopThreadUnzip()
-{
-   fActiveThread = kFALSE;
-
-   for (Int_t i = 0; i < 1; i++) {
-      if(fUnzipThread[i]){
-
-         SendUnzipStartSignal(kTRUE);
-
-         if (fUnzipThread[i]->Exists()) {
-            fUnzipThread[i]->Join();
-            delete fUnzipThread[i];
-         }
-      }
-
-   }
-
-   return 1;
-}
-
-////////////////////////////////////////////////////////////////////////////////
-/// This is a static function.
-///
-/// This is the call that will be executed in the Thread generated by
-/// StartThreadTreeCacheUnzip... what we want to do is to inflate the next
-/// series of buffers leaving them in the second cache.
-///
-/// Returns 0 when it finishes
-
-void* TTreeCacheUnzip::UnzipLoop(void *arg)
-{
-   TTreeCacheUnzipData *d = (TTreeCacheUnzipData *)arg;
-   TTreeCacheUnzip *unzipMng = d->fInstance;
-
-   TThread::SetCancelOn();
-   TThread::SetCancelDeferred();
-
-   Int_t thrnum = d->fCount;
-   Int_t startindex = thrnum;
-   Int_t locbuffsz = 16384;
-   char *locbuff = new char[16384];
-   Int_t res = 0;
-   Int_t myCycle = 0;
-
-   while( unzipMng->IsActiveThread() ) {
-      res = 1;
-
-      {
-         R__LOCKGUARD(unzipMng->fMutexList);
-         if (myCycle != unzipMng->fCycle) startindex = thrnum;
-         myCycle = unzipMng->fCycle;
-         if (unzipMng->fNseek) startindex = startindex % unzipMng->fNseek;
-         else startindex = -1;
-      }
-
-      if (startindex >= 0)
-         res = unzipMng->UnzipCache(startindex, locbuffsz, locbuff);
-
-      {
-         R__LOCKGUARD(unzipMng->fMutexList);
-
-         if(!unzipMng->IsActiveThread()) break;
-
-         if ((res == 1) || (!unzipMng->fIsTransferred)) {
-            unzipMng->WaitUnzipStartSignal();
-            startindex = unzipMng->fLastReadPos+3+thrnum;
-         }
-      }
-
-   }
-
-   delete d;
-   delete [] locbuff;
-   return (void *)0;
-}
-
 ////////////////////////////////////////////////////////////////////////////////
 //                                                                            //
 // From now on we have the methods concerning the unzipping part of the cache //
@@ -629,6 +500,7 @@ Int_t TTreeCacheUnzip::GetRecordHeader(char *buf, Int_t maxbytes, Int_t &nbytes,
    return nread;
 }
 
+
 ////////////////////////////////////////////////////////////////////////////////
 /// This will delete the list of buffers that are in the unzipping cache
 /// and will reset certain values in the cache.
@@ -637,281 +509,103 @@ Int_t TTreeCacheUnzip::GetRecordHeader(char *buf, Int_t maxbytes, Int_t &nbytes,
 /// Note: This method is completely different from TTreeCache::ResetCache(),
 /// in that method we were cleaning the prefetching buffer while here we
 /// delete the information about the unzipped buffers
+///
+/// The unzip tasks not yet started are cancelled and the ones running
+/// are waited for.
 
 void TTreeCacheUnzip::ResetCache()
 {
-   {
    R__LOCKGUARD(fMutexList);
 
    if (gDebug > 0)
-      Info("ResetCache", "Thread: %ld -- Resetting the cache. fNseek:%d fNSeekMax:%d fTotalUnzipBytes:%lld", TThread::SelfId(), fNseek, fNseekMax, fTotalUnzipBytes);
-
-   // Reset all the lists and wipe all the chunks
-   fCycle++;
-   for (Int_t i = 0; i < fNseekMax; i++) {
-      if (fUnzipLen) fUnzipLen[i] = 0;
-      if (fUnzipChunks) {
-         if (fUnzipChunks[i]) delete [] fUnzipChunks[i];
-         fUnzipChunks[i] = 0;
-      }
-      if (fUnzipStatus) fUnzipStatus[i] = 0;
+      Info("ResetCache", "Resetting the cache. fNseek:%d fNSeekMax:%d fUnzipScheduled:%lld", fNseek, fNseekMax, fUnzipScheduled);
 
+   if (fUnzipTasks) {
+      fUnzipCancel = kTRUE;
+      fUnzipTasks->Wait();
+      fUnzipCancel = kFALSE;
    }
 
-   while (fActiveBlks.size()) fActiveBlks.pop();
-
-   if(fNseekMax < fNseek){
-      if (gDebug > 0)
-         Info("ResetCache", "Changing fNseekMax from:%d to:%d", fNseekMax, fNseek);
-
-      Byte_t *aUnzipStatus = new Byte_t[fNseek];
-      memset(aUnzipStatus, 0, fNseek*sizeof(Byte_t));
-
-      Int_t *aUnzipLen = new Int_t[fNseek];
-      memset(aUnzipLen, 0, fNseek*sizeof(Int_t));
-
-      char **aUnzipChunks = new char *[fNseek];
-      memset(aUnzipChunks, 0, fNseek*sizeof(char *));
-
-      if (fUnzipStatus) delete [] fUnzipStatus;
-      if (fUnzipLen) delete [] fUnzipLen;
-      if (fUnzipChunks) delete [] fUnzipChunks;
-
-      fUnzipStatus  = aUnzipStatus;
-      fUnzipLen  = aUnzipLen;
-      fUnzipChunks = aUnzipChunks;
+   ReportClusterUnzip();
 
-      fNseekMax  = fNseek;
-   }
-
-   fLastReadPos = 0;
-   fTotalUnzipBytes = 0;
-   fBlocksToGo = fNseek;
+   // Reset all the lists and wipe all the chunks
+   for (Int_t i = 0; i < fNseekMax; i++) {
+      fUnzipLen[i] = 0;
+      TBufferPool::Release(fUnzipChunks[i]);
+      fUnzipChunks[i] = 0;
+      fUnzipState[i] = kUntouched;
    }
 
-   SendUnzipStartSignal(kTRUE);
-
+   fUnzipActive = kFALSE;
+   fNextToUnzip = 0;
+   fUnzipScheduled = 0;
+   fClusterReported = kTRUE;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// We try to read a buffer that has already been unzipped
-/// Returns -1 in case of read failure, 0 in case it's not in the
-/// cache and n>0 in case read from cache (number of bytes copied).
+/// We try to get a buffer that has already been unzipped.
+/// Returns -1 in case the basket is not handled by the unzipping cache
+/// (the caller then reads and unzips it by itself) and n>0 (the number of
+/// bytes of the unzipped buffer) in case of success.
 /// pos and len are the original values as were passed to ReadBuffer
 /// but instead we will return the inflated buffer.
-/// Note!! : If *buf == 0 we will allocate the buffer and it will be the
-/// responsability of the caller to free it... it is useful for example
-/// to pass it to the creator of TBuffer
+/// Note!! : The unzipped buffer is handed over to the caller, no copy
+/// is made: *buf is set to the buffer, a block of the TBufferPool, *free
+/// is set to kTRUE and it is the responsability of the caller to give it
+/// back with TBufferPool::Release... it is useful for example to pass it
+/// to a TBuffer (see TBufferPool::Adopt)
 
-Int_t TTreeCacheUnzip::GetUnzipBuffer(char **buf, Long64_t pos, Int_t len, Bool_t *free)
+Int_t TTreeCacheUnzip::GetUnzipBuffer(char **buf, Long64_t pos, Int_t /* len */, Bool_t *free)
 {
-   Int_t res = 0;
-   Int_t loc = -1;
-
-   {
-      R__LOCKGUARD(fMutexList);
-
-      // We go straight to TTreeCache/TfileCacheRead, in order to get the info we need
-      //  pointer to the original zipped chunk
-      //  its index in the original unsorted offsets lists
-      //
-      // Actually there are situations in which copying the buffer is not
-      // useful. But the choice is among doing once more a small memcpy or a binary search in a large array. I prefer the former.
-      // Also, here we prefer not to trigger the (re)population of the chunks in the TFileCacheRead. That is
-      // better to be done in the main thread.
-
-      // And now loc is the position of the chunk in the array of the sorted chunks
-      Int_t myCycle = fCycle;
-
-      if (fParallel && !fIsLearning) {
-
-         if(fNseekMax < fNseek){
-            if (gDebug > 0)
-               Info("GetUnzipBuffer", "Changing fNseekMax from:%d to:%d", fNseekMax, fNseek);
-
-            Byte_t *aUnzipStatus = new Byte_t[fNseek];
-            memset(aUnzipStatus, 0, fNseek*sizeof(Byte_t));
-
-            Int_t *aUnzipLen = new Int_t[fNseek];
-            memset(aUnzipLen, 0, fNseek*sizeof(Int_t));
+   if (!fParallel || fIsLearning) return -1;
 
-            char **aUnzipChunks = new char *[fNseek];
-            memset(aUnzipChunks, 0, fNseek*sizeof(char *));
-
-            for (Int_t i = 0; i < fNseekMax; i++) {
-               aUnzipStatus[i] = fUnzipStatus[i];
-               aUnzipLen[i] = fUnzipLen[i];
-               aUnzipChunks[i] = fUnzipChunks[i];
-            }
-
-            if (fUnzipStatus) delete [] fUnzipStatus;
-            if (fUnzipLen) delete [] fUnzipLen;
-            if (fUnzipChunks) delete [] fUnzipChunks;
-
-            fUnzipStatus  = aUnzipStatus;
-            fUnzipLen  = aUnzipLen;
-            fUnzipChunks = aUnzipChunks;
-
-            fNseekMax  = fNseek;
-         }
-
-         loc = (Int_t)TMath::BinarySearch(fNseek,fSeekSort,pos);
-         if ( (fCycle == myCycle) && (loc >= 0) && (loc < fNseek) && (pos == fSeekSort[loc]) ) {
-
-            // The buffer is, at minimum, in the file cache. We must know its index in the requests list
-            // In order to get its info
-            Int_t seekidx = fSeekIndex[loc];
-
-            fLastReadPos = seekidx;
-
-            do {
-
-               // If the block is ready we get it immediately.
-               // And also we don't have to alloc the blks. This is supposed to be
-               // the main thread of the app.
-               if ((fUnzipStatus[seekidx] == 2) && (fUnzipChunks[seekidx]) && (fUnzipLen[seekidx] > 0)) {
-
-                  //if (gDebug > 0)
-                  //   Info("GetUnzipBuffer", "++++++++++++++++++++ CacheHIT Block wanted: %d  len:%d req_len:%d fNseek:%d", seekidx, fUnzipLen[seekidx], len,  fNseek);
-
-                  if(!(*buf)) {
-                     *buf = fUnzipChunks[seekidx];
-                     fUnzipChunks[seekidx] = 0;
-                     fTotalUnzipBytes -= fUnzipLen[seekidx];
-                     SendUnzipStartSignal(kFALSE);
-                     *free = kTRUE;
-                  }
-                  else {
-                     memcpy(*buf, fUnzipChunks[seekidx], fUnzipLen[seekidx]);
-                     delete fUnzipChunks[seekidx];
-                     fTotalUnzipBytes -= fUnzipLen[seekidx];
-                     fUnzipChunks[seekidx] = 0;
-                     SendUnzipStartSignal(kFALSE);
-                     *free = kFALSE;
-                  }
-
-                  fNFound++;
-
-                  return fUnzipLen[seekidx];
-               }
-
-               // If the status of the unzipped chunk is pending
-               // we wait on the condvar, hoping that the next signal is the good one
-               if ( fUnzipStatus[seekidx] == 1 ) {
-                  //fMutexList->UnLock();
-                  fUnzipDoneCondition->TimedWaitRelative(200);
-                  //fMutexList->Lock();
-
-                  if ( myCycle != fCycle ) {
-                     if (gDebug > 0)
-                        Info("GetUnzipBuffer", "Sudden paging Break!!! IsActiveThread(): %d, fNseek: %d, fIsLearning:%d",
-                             IsActiveThread(), fNseek, fIsLearning);
-
-                     fLastReadPos = 0;
-
-                     seekidx = -1;
-                     break;
-                  }
-
-               }
-
-            } while ( fUnzipStatus[seekidx] == 1 );
-
-            //if (gDebug > 0)
-            //   Info("GetUnzipBuffer", "------- Block wanted: %d  status: %d len: %d chunk: %llx ", seekidx, fUnzipStatus[seekidx], fUnzipLen[seekidx], fUnzipChunks[seekidx]);
-
-            // Here the block is not pending. It could be done or aborted or not yet being processed.
-            if ( (seekidx >= 0) && (fUnzipStatus[seekidx] == 2) && (fUnzipChunks[seekidx]) && (fUnzipLen[seekidx] > 0) ) {
-
-               //if (gDebug > 0)
-               //   Info("GetUnzipBuffer", "++++++++++++++++++++ CacheLateHIT Block wanted: %d  len:%d fNseek:%d", seekidx, fUnzipLen[seekidx], fNseek);
-
-               if(!(*buf)) {
-                  *buf = fUnzipChunks[seekidx];
-                  fUnzipChunks[seekidx] = 0;
-                  fTotalUnzipBytes -= fUnzipLen[seekidx];
-                  SendUnzipStartSignal(kFALSE);
-                  *free = kTRUE;
-               }
-               else {
-                  memcpy(*buf, fUnzipChunks[seekidx], fUnzipLen[seekidx]);
-                  delete fUnzipChunks[seekidx];
-                  fTotalUnzipBytes -= fUnzipLen[seekidx];
-                  fUnzipChunks[seekidx] = 0;
-                  SendUnzipStartSignal(kFALSE);
-                  *free = kFALSE;
-               }
-
-               fNStalls++;
-
-               return fUnzipLen[seekidx];
-            }
-            else {
-               // This is a complete miss. We want to avoid the threads
-               // to try unzipping this block in the future.
-               fUnzipStatus[seekidx] = 2;
-               fUnzipChunks[seekidx] = 0;
-
-               if ((fTotalUnzipBytes < fUnzipBufferSize) && fBlocksToGo)
-                  SendUnzipStartSignal(kFALSE);
-
-               //if (gDebug > 0)
-               //   Info("GetUnzipBuffer", "++++++++++++++++++++ CacheMISS Block wanted: %d  len:%d fNseek:%d", seekidx, len, fNseek);
-            }
-
-         } else {
-            loc = -1;
-            //fLastReadPos = 0;
-            fIsTransferred = kFALSE;
-         }
-
-      } else {
-         // We need to reset it for new transferences...
-         //ResetCache();
-         //TFileCacheRead::Prefetch(0,0);
-      }
-
-   } // scope of the lock!
-
-   if (len > fCompBufferSize) {
-      delete [] fCompBuffer;
-      fCompBuffer = new char[len];
-      fCompBufferSize = len;
-   } else {
-      if (fCompBufferSize > len*4) {
-      delete [] fCompBuffer;
-      fCompBuffer = new char[len*2];
-      fCompBufferSize = len*2;
-      }
+   Int_t loc = -1;
+   if (fUnzipActive)
+      loc = (Int_t)TMath::BinarySearch(fNseek,fSeekSort,pos);
+   if (loc < 0 || pos != fSeekSort[loc]) {
+      // The basket is not in the current cluster: load the cluster of
+      // the entry being read.
+      if (!FillBuffer() || !fUnzipActive) return -1;
+      loc = (Int_t)TMath::BinarySearch(fNseek,fSeekSort,pos);
+      if (loc < 0 || pos != fSeekSort[loc]) return -1;
    }
 
-   {
-      R__LOCKGUARD(fIOMutex);
-      // Here we know that the async unzip of the wanted chunk
-      // was not done for some reason. We continue.
-
-      res = 0;
-      if (!ReadBufferExt(fCompBuffer, pos, len, loc)) {
-         //Info("GetUnzipBuffer", "++++++++++++++++++++ CacheMISS %d %d", loc, fNseek);
-         fFile->Seek(pos);
-         res = fFile->ReadBuffer(fCompBuffer, len);
-      }
-
-      if (res) res = -1;
-
-   } // scope of the lock!
+   Byte_t state = kUntouched;
+   if (fUnzipState[loc].compare_exchange_strong(state, (Byte_t)kProgress)) {
+      // No task started on this basket yet, unzip it right away.
+      UnzipBasket(loc, kFALSE);
+      if (fUnzipChunks[loc]) fNMissed++;
+   } else if (state == kProgress) {
+      // A task is unzipping it, wait only for this one.
+      std::unique_lock<std::mutex> lock(fUnzipDoneMutex);
+      fUnzipDone.wait(lock, [this, loc]() { return fUnzipState[loc] == kFinished; });
+      lock.unlock();
+      if (fUnzipChunks[loc]) fNStalls++;
+   } else if (state == kFinished) {
+      if (fUnzipChunks[loc]) fNFound++;
+   }
 
-   if (!res) {
-      res = UnzipBuffer(buf, fCompBuffer);
+   Int_t res = -1;
+   if (fUnzipChunks[loc]) {
+      *buf = fUnzipChunks[loc];
       *free = kTRUE;
+      res = fUnzipLen[loc];
+      fUnzipChunks[loc] = 0;
+      fUnzipLen[loc] = 0;
    }
-
-   if (!fIsLearning) {
-      fNMissed++;
+   // The slot is consumed, whether or not it holds an unzipped buffer (the
+   // basket may not be compressed or may have failed to unzip): release its
+   // share of the unzip-ahead window if it was handed to the pool.
+   if (fUnzipState[loc] != kConsumed) {
+      if (loc < fNextToUnzip) fUnzipScheduled -= fSeekSortLen[loc];
+      fUnzipState[loc] = kConsumed;
    }
 
-   return res;
+   // Keep the tasks busy and report the cluster once completely unzipped.
+   ScheduleUnzip();
+   ReportClusterUnzip();
 
+   return res;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -923,8 +617,8 @@ void TTreeCacheUnzip::SetUnzipRelBufferSize(Float_t relbufferSize)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// Sets the size for the unzipping cache... by default it should be
-/// two times the size of the prefetching cache
+/// Sets the maximum size of the compressed baskets being unzipped ahead
+/// of the reading... by default it is the size of the prefetching cache
 
 void TTreeCacheUnzip::SetUnzipBufferSize(Long64_t bufferSize)
 {
@@ -936,9 +630,9 @@ void TTreeCacheUnzip::SetUnzipBufferSize(Long64_t bufferSize)
 ////////////////////////////////////////////////////////////////////////////////
 /// Unzips a ROOT specific buffer... by reading the header at the beginning.
 /// returns the size of the inflated buffer or -1 if error
-/// Note!! : If *dest == 0 we will allocate the buffer and it will be the
-/// responsability of the caller to free it... it is useful for example
-/// to pass it to the creator of TBuffer
+/// Note!! : If *dest == 0 we will allocate the buffer from the TBufferPool
+/// and it will be the responsability of the caller to release it... it is
+/// useful for example to pass it to a TBuffer (see TBufferPool::Adopt)
 /// src is the original buffer with the record (header+compressed data)
 /// *dest is the inflated buffer (including the header)
 
@@ -962,7 +656,7 @@ Int_t TTreeCacheUnzip::UnzipBuffer(char **dest, char *src)
          return uzlen;
       }
       Int_t l = keylen+objlen;
-      *dest = new char[l];
+      *dest = TBufferPool::Allocate(l);
       alloc = kTRUE;
    }
    // Must unzip the buffer
@@ -1020,7 +714,7 @@ Int_t TTreeCacheUnzip::UnzipBuffer(char **dest, char *src)
          Error("UnzipBuffer", "nbytes = %d, keylen = %d, objlen = %d, noutot = %d, nout=%d, nin=%d, nbuf=%d",
                nbytes,keylen,objlen, noutot,nout,nin,nbuf);
          uzlen = -1;
-         if(alloc) delete [] *dest;
+         if(alloc) TBufferPool::Release(*dest);
          *dest = 0;
          return uzlen;
       }
@@ -1034,221 +728,138 @@ Int_t TTreeCacheUnzip::UnzipBuffer(char **dest, char *src)
    return uzlen;
 }
 
+
 ////////////////////////////////////////////////////////////////////////////////
-/// This inflates all the buffers in the cache.. passing the data to a new
-/// buffer that will only wait there to be read...
-/// We can not inflate all the buffers in the cache so we will try to do
-/// it until the cache gets full... there is a member called fUnzipBufferSize which will
-/// tell us the max size we can allocate for this cache.
-///
-/// note that we will  unzip in the order they were put into the cache not
-/// the order of the transference so it has to be read in that order or the
-/// pre-unzipping will be useless.
-///
-/// startindex is used as start index to check for blks to be unzipped
-///
-/// returns 0 in normal conditions or -1 if error, 1 if it would like to sleep
+/// Hand the next baskets of the cluster to the task pool, keeping the size
+/// of the compressed baskets unzipped ahead of the reading below
+/// fUnzipBufferSize (at least one basket is always in flight).
 ///
-/// This func is supposed to compete among an indefinite number of threads to get a chunk to inflate
-/// in order to accommodate multiple unzippers
-/// Since everything is so async, we cannot use a fixed buffer, we are forced to keep
-/// the individual chunks as separate blocks, whose summed size does not exceed the maximum
-/// allowed. The pointers are kept globally in the array fUnzipChunks
+/// The baskets are unzipped in the order of their position in the file,
+/// which is close to the order in which they are read.
 
-Int_t TTreeCacheUnzip::UnzipCache(Int_t &startindex, Int_t &locbuffsz, char *&locbuff)
+void TTreeCacheUnzip::ScheduleUnzip()
 {
-   Int_t myCycle;
-   const Int_t hlen=128;
-   Int_t objlen=0, keylen=0;
-   Int_t nbytes=0;
-   Int_t readbuf = 0;
-
-   Int_t idxtounzip = -1;
-   Long64_t rdoffs = 0;
-   Int_t rdlen = 0;
-   {
-      R__LOCKGUARD(fMutexList);
-
-      if (!IsActiveThread() || !fNseek || fIsLearning || !fIsTransferred) {
-         if (gDebug > 0)
-            Info("UnzipCache", "Sudden Break!!! IsActiveThread(): %d, fNseek: %d, fIsLearning:%d",
-                 IsActiveThread(), fNseek, fIsLearning);
-         return 1;
-      }
-
-      // To synchronize with the 'paging'
-      myCycle = fCycle;
-
-      // Try to look for a blk to unzip
-      idxtounzip = -1;
-      rdoffs = 0;
-      rdlen = 0;
-      if (fTotalUnzipBytes < fUnzipBufferSize) {
-
-         if (fBlocksToGo > 0) {
-            for (Int_t ii=0; ii < fNseek; ii++) {
-               Int_t reqi = (startindex+ii) % fNseek;
-               if (!fUnzipStatus[reqi] && (fSeekLen[reqi] > 256)   ) {
-                  // We found a chunk which is not unzipped nor pending
-                  fUnzipStatus[reqi] = 1; // Set it as pending
-                  idxtounzip = reqi;
-
-                  rdoffs = fSeek[idxtounzip];
-                  rdlen = fSeekLen[idxtounzip];
-                  break;
-               }
-            }
-            if (idxtounzip < 0) fBlocksToGo = 0;
-         }
-      }
-
-   } // lock scope
-
-   if (idxtounzip < 0) {
-      if (gDebug > 0)
-         Info("UnzipCache", "Nothing to do... startindex:%d fTotalUnzipBytes:%lld fUnzipBufferSize:%lld fNseek:%d",
-              startindex, fTotalUnzipBytes, fUnzipBufferSize, fNseek );
-      return 1;
+   if (!fUnzipActive) return;
+
+   while (fNextToUnzip < fNseek && (fUnzipScheduled < fUnzipBufferSize || fUnzipScheduled == 0)) {
+      Int_t loc = fNextToUnzip++;
+      // Already taken care of by the reading thread
+      if (fUnzipState[loc] != kUntouched) continue;
+      fUnzipScheduled += fSeekSortLen[loc];
+      fUnzipTasks->Run([this, loc]() { UnzipBasket(loc, kTRUE); });
    }
+}
 
-   // And here we have a new blk to unzip
-   startindex = idxtounzip+THREADCNT;
+////////////////////////////////////////////////////////////////////////////////
+/// Unzip the basket at index loc of the sorted list of baskets of the cache
+/// into a new buffer, stored in fUnzipChunks[loc].
+///
+/// When called from a task (intask is true) the basket is first claimed;
+/// nothing is done if the reading thread got to it first or if the
+/// content of the cache is going away. When called from the reading thread
+/// the basket must already be in the kProgress state.
+///
+/// Baskets which are not compressed are left to the reading thread
+/// (fUnzipChunks[loc] stays null).
 
-   if (!IsActiveThread() || !fNseek || fIsLearning ) {
-      if (gDebug > 0)
-         Info("UnzipCache", "Sudden Break!!! IsActiveThread(): %d, fNseek: %d, fIsLearning:%d",
-              IsActiveThread(), fNseek, fIsLearning);
-      return 1;
+void TTreeCacheUnzip::UnzipBasket(Int_t loc, Bool_t intask)
+{
+   if (intask) {
+      if (fUnzipCancel) return;
+      Byte_t state = kUntouched;
+      if (!fUnzipState[loc].compare_exchange_strong(state, (Byte_t)kProgress)) return;
    }
 
-   Int_t loc = -1;
-
-   // Prepare a static tmp buf of adequate size
-   if(locbuffsz < rdlen) {
-      if (locbuff) delete [] locbuff;
-      locbuffsz = rdlen;
-      locbuff = new char[locbuffsz];
-      //memset(locbuff, 0, locbuffsz);
-   } else
-      if(locbuffsz > rdlen*3) {
-         if (locbuff) delete [] locbuff;
-         locbuffsz = rdlen*2;
-         locbuff = new char[locbuffsz];
-         //memset(locbuff, 0, locbuffsz);
-      }
-
-      if (gDebug > 0)
-      Info("UnzipCache", "Going to unzip block %d", idxtounzip);
-
-      readbuf = ReadBufferExt(locbuff, rdoffs, rdlen, loc);
-
-   {
-      R__LOCKGUARD(fMutexList);
-
-      if ( (myCycle != fCycle) || !fIsTransferred )  {
-         if (gDebug > 0)
-            Info("UnzipCache", "Sudden paging Break!!! IsActiveThread(): %d, fNseek: %d, fIsLearning:%d",
-                 IsActiveThread(), fNseek, fIsLearning);
-
-         fUnzipStatus[idxtounzip] = 2; // Set it as not done
-         fUnzipChunks[idxtounzip] = 0;
-         fUnzipLen[idxtounzip] = 0;
-         fUnzipDoneCondition->Signal();
-
-         startindex = 0;
-         return 1;
-      }
+   Double_t start = TTimeStamp();
 
-      if (readbuf <= 0) {
-         fUnzipStatus[idxtounzip] = 2; // Set it as not done
-         fUnzipChunks[idxtounzip] = 0;
-         fUnzipLen[idxtounzip] = 0;
-         if (gDebug > 0)
-            Info("UnzipCache", "Block %d not done. rdoffs=%lld rdlen=%d readbuf=%d", idxtounzip, rdoffs, rdlen, readbuf);
-         return -1;
-      }
-
-      GetRecordHeader(locbuff, hlen, nbytes, objlen, keylen);
-
-      Int_t len = (objlen > nbytes-keylen)? keylen+objlen : nbytes;
-
-      // If the single unzipped chunk is really too big, reset it to not processable
-      // I.e. mark it as done but set the pointer to 0
-      // This block will be unzipped synchronously in the main thread
-      if (len > 4*fUnzipBufferSize) {
-
-         //if (gDebug > 0)
-            Info("UnzipCache", "Block %d is too big, skipping.", idxtounzip);
-
-         fUnzipStatus[idxtounzip] = 2; // Set it as done
-         fUnzipChunks[idxtounzip] = 0;
-         fUnzipLen[idxtounzip] = 0;
-
-         fUnzipDoneCondition->Signal();
-         return 0;
-      }
-
-   } // Scope of the lock
+   Int_t len = fSeekSortLen[loc];
+   char *src = 0;
+   char *locbuff = 0;
+   if (fUnzipDirect) {
+      src = &fBuffer[fSeekPos[loc]];
+   } else {
+      locbuff = TBufferPool::Allocate(len);
+      Int_t l = loc;
+      if (ReadBufferExt(locbuff, fSeekSort[loc], len, l) == 1) src = locbuff;
+   }
 
-   // Unzip it into a new blk
    char *ptr = 0;
    Int_t loclen = 0;
-
-   loclen = UnzipBuffer(&ptr, locbuff);
-
-   if ((loclen > 0) && (loclen == objlen+keylen)) {
-      R__LOCKGUARD(fMutexList);
-
-      if ( (myCycle != fCycle)  || !fIsTransferred) {
-         if (gDebug > 0)
-            Info("UnzipCache", "Sudden paging Break!!! IsActiveThread(): %d, fNseek: %d, fIsLearning:%d",
-                 IsActiveThread(), fNseek, fIsLearning);
-         delete [] ptr;
-
-         fUnzipStatus[idxtounzip] = 2; // Set it as not done
-         fUnzipChunks[idxtounzip] = 0;
-         fUnzipLen[idxtounzip] = 0;
-
-         startindex = 0;
-         fUnzipDoneCondition->Signal();
-         return 1;
+   if (src) {
+      const Int_t hlen=128;
+      Int_t nbytes=0, objlen=0, keylen=0;
+      GetRecordHeader(src, hlen, nbytes, objlen, keylen);
+      if (objlen > nbytes-keylen) {
+         loclen = UnzipBuffer(&ptr, src);
+         if (loclen != objlen+keylen) {
+            if (gDebug > 0)
+               Info("UnzipBasket", "Block %d not done. loclen:%d objlen:%d keylen:%d", loc, loclen, objlen, keylen);
+            TBufferPool::Release(ptr);
+            ptr = 0;
+            loclen = 0;
+         }
       }
+   }
+   TBufferPool::Release(locbuff);
 
-      fUnzipStatus[idxtounzip] = 2; // Set it as done
-      fUnzipChunks[idxtounzip] = ptr;
-      fUnzipLen[idxtounzip] = loclen;
-      fTotalUnzipBytes += loclen;
-
-      fActiveBlks.push(idxtounzip);
+   fUnzipChunks[loc] = ptr;
+   fUnzipLen[loc] = loclen;
+   if (intask && ptr) fNUnzip++;
 
-      if (gDebug > 0)
-         Info("UnzipCache", "reqi:%d, rdoffs:%lld, rdlen: %d, loclen:%d",
-              idxtounzip, rdoffs, rdlen, loclen);
+   Double_t stop = TTimeStamp();
+   fClusterUnzipTime += Long64_t(1e9*(stop-start));
 
-      fNUnzip++;
+   // Publishes the chunk to the reading thread, which may be waiting for it.
+   if (intask) {
+      {
+         std::lock_guard<std::mutex> lock(fUnzipDoneMutex);
+         fUnzipState[loc] = kFinished;
+      }
+      fUnzipDone.notify_all();
+   } else {
+      fUnzipState[loc] = kFinished;
    }
-   else {
-      R__LOCKGUARD(fMutexList);
-      Info("argh", "loclen:%d objlen:%d loc:%d readbuf:%d", loclen, objlen, loc, readbuf);
-      fUnzipStatus[idxtounzip] = 2; // Set it as done
-      fUnzipChunks[idxtounzip] = 0;
-      fUnzipLen[idxtounzip] = 0;
+
+   if (--fClusterToGo == 0) {
+      fClusterStop = stop;
+      fClusterDone = kTRUE;
    }
+}
 
-   fUnzipDoneCondition->Signal();
+////////////////////////////////////////////////////////////////////////////////
+/// Once all the baskets of the current cluster are unzipped, report its
+/// unzip latency to the TTreePerfStats of the tree (or to gPerfStats).
 
-   delete [] ptr;
-   return 0;
+void TTreeCacheUnzip::ReportClusterUnzip()
+{
+   if (fClusterReported || !fClusterDone) return;
+   fClusterReported = kTRUE;
+
+   Double_t latency = fClusterStop - fClusterStart;
+   fNClusters++;
+   fClusterLatency += latency;
+
+   if (fNbranches <= 0) return;
+   TTree *tree = ((TBranch*)fBranches->UncheckedAt(0))->GetTree();
+   TVirtualPerfStats *perfStats = tree->GetPerfStats() ? tree->GetPerfStats() : gPerfStats;
+   if (perfStats)
+      perfStats->UnzipClusterEvent(tree, fClusterEntry, fClusterBaskets, latency, 1e-9*fClusterUnzipTime);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Print cache statistics.
+
 void  TTreeCacheUnzip::Print(Option_t* option) const {
 
    printf("******TreeCacheUnzip statistics for file: %s ******\n",fFile->GetName());
    printf("Max allowed mem for pending buffers: %lld\n", fUnzipBufferSize);
-   printf("Number of blocks unzipped by threads: %d\n", fNUnzip);
+   printf("Number of blocks unzipped by tasks: %d\n", fNUnzip.load());
    printf("Number of hits: %d\n", fNFound);
    printf("Number of stalls: %d\n", fNStalls);
    printf("Number of misses: %d\n", fNMissed);
+   printf("Number of clusters unzipped: %d\n", fNClusters);
+   if (fNClusters)
+      printf("Mean cluster unzip latency: %.3f ms\n", 1e3*fClusterLatency/fNClusters);
 
    TTreeCache::Print(option);
 }
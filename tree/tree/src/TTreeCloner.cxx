@@ -209,6 +209,8 @@ void TTreeCloner::CloseOutWriteBaskets()
       TBranch *to = (TBranch*)fToBranches.UncheckedAt(i);
       to->FlushOneBasket(to->GetWriteBasket());
    }
+   // In implicit multi-threading mode the baskets might only be queued.
+   fToTree->WritePendingBaskets();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -508,6 +510,7 @@ void TTreeCloner::CopyMemoryBaskets()
          basket = (TBasket*)basket->Clone();
          basket->SetBranch(to);
          to->AddBasket(*basket, kFALSE, fToStartEntries+from->GetBasketEntry()[from->GetWriteBasket()]);
+         to->CopyBasketStats(from, from->GetWriteBasket(), fToStartEntries+from->GetBasketEntry()[from->GetWriteBasket()], kFALSE);
       } else {
          to->AddLastBasket(  fToStartEntries+from->GetBasketEntry()[from->GetWriteBasket()] );
       }
@@ -640,12 +643,14 @@ void TTreeCloner::WriteBaskets()
          basket->IncrementPidOffset(fPidOffset);
          basket->CopyTo(tofile);
          to->AddBasket(*basket,kTRUE,fToStartEntries + from->GetBasketEntry()[index]);
+         to->CopyBasketStats(from, index, fToStartEntries + from->GetBasketEntry()[index], kTRUE);
       } else {
          TBasket *frombasket = from->GetBasket( index );
          if (frombasket && frombasket->GetNevBuf()>0) {
             TBasket *tobasket = (TBasket*)frombasket->Clone();
             tobasket->SetBranch(to);
             to->AddBasket(*tobasket, kFALSE, fToStartEntries+from->GetBasketEntry()[index]);
+            to->CopyBasketStats(from, index, fToStartEntries+from->GetBasketEntry()[index], kFALSE);
             to->FlushOneBasket(to->GetWriteBasket());
          }
       }
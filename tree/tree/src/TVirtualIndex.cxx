@@ -31,3 +31,18 @@ TVirtualIndex::TVirtualIndex(): TNamed()
 TVirtualIndex::~TVirtualIndex()
 {
 }
+
+////////////////////////////////////////////////////////////////////////////////
+/// Look up n pairs of values: entries[i] is set to
+/// GetEntryNumberWithIndex(major[i], minor[i]). If minor is 0, the minor
+/// values are all 0.
+/// Derived classes may override this function to take advantage of the
+/// batch, in particular when the pairs are sorted (e.g. when joining two
+/// trees sorted by the same index).
+
+void TVirtualIndex::GetEntryNumbersWithIndex(Long64_t n, const Long64_t *major, const Long64_t *minor, Long64_t *entries) const
+{
+   for (Long64_t i = 0; i < n; ++i) {
+      entries[i] = GetEntryNumberWithIndex(major[i], minor ? minor[i] : 0);
+   }
+}
@@ -0,0 +1,77 @@
+// @(#)root/treeplayer:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2015, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TBasketStatsCut
+#define ROOT_TBasketStatsCut
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TBasketStatsCut                                                      //
+//                                                                      //
+// The range cuts of a selection, used to skip the entries whose        //
+// baskets hold no value passing them (see TBranch::SetBasketStats).    //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef ROOT_TObject
+#include "TObject.h"
+#endif
+
+#ifndef ROOT_TString
+#include "TString.h"
+#endif
+
+#include <vector>
+
+class TBranch;
+class TTree;
+
+class TBasketStatsCut : public TObject {
+
+private:
+   struct TRange {
+      TString   fName;          // Name of the leaf or branch
+      Double_t  fLow;           // Smallest value passing the cut
+      Double_t  fHigh;          // Largest value passing the cut
+      Bool_t    fLowIncluded;   // True if fLow passes the cut
+      Bool_t    fHighIncluded;  // True if fHigh passes the cut
+      TBranch  *fBranch;        // Branch of the leaf in fTree, 0 if it has no statistics
+   };
+
+   TString             fCut;         //  Selection
+   std::vector<TRange> fRanges;      //! Range cuts of the selection
+   TTree              *fTree;        //! Tree the branches of the ranges belong to
+   Long64_t            fChainOffset; //! Chain offset of fTree when the branches were found
+   Long64_t            fFirst;       //! First entry of the last decision
+   Long64_t            fLast;        //! Entry following the last decision
+   Bool_t              fSkip;        //! True if the entries in [fFirst,fLast) cannot pass the selection
+
+   TBasketStatsCut(const TBasketStatsCut&);            // not implemented
+   TBasketStatsCut& operator=(const TBasketStatsCut&); // not implemented
+
+   Bool_t   AddRange(const TString &term);
+   Bool_t   Decide(Long64_t entry);
+   Bool_t   Parse(const TString &cut);
+   void     SetTree(TTree *tree);
+
+public:
+   TBasketStatsCut(const char *cut = "");
+   virtual ~TBasketStatsCut();
+
+   const char *GetCut() const { return fCut.Data(); }
+   Long64_t    GetNextEntry(TTree *tree, Long64_t entry);
+   Int_t       GetNranges() const { return fRanges.size(); }
+   Bool_t      IsEmpty() const { return fRanges.empty(); }
+   Bool_t      Skip(TTree *tree, Long64_t entry);
+
+   ClassDef(TBasketStatsCut,0)  //Range cuts of a selection checked against the basket statistics
+};
+
+#endif
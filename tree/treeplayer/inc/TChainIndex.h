@@ -81,6 +81,7 @@ public:
    virtual Long64_t       GetEntryNumberFriend(const TTree *parent);
    virtual Long64_t       GetEntryNumberWithIndex(Long64_t major, Long64_t minor) const;
    virtual Long64_t       GetEntryNumberWithBestIndex(Long64_t major, Long64_t minor) const;
+   virtual void           GetEntryNumbersWithIndex(Long64_t n, const Long64_t *major, const Long64_t *minor, Long64_t *entries) const;
    const char            *GetMajorName()    const {return fMajorName.Data();}
    const char            *GetMinorName()    const {return fMinorName.Data();}
    virtual Long64_t       GetN()            const {return fEntries.size();}
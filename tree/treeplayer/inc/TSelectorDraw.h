@@ -25,6 +25,7 @@
 #include "TSelector.h"
 #endif
 
+class TBasketStatsCut;
 class TTreeFormula;
 class TTreeFormulaManager;
 class TH1;
@@ -38,6 +39,7 @@ protected:
    TTree         *fTree;           //  Pointer to current Tree
    TTreeFormula **fVar;            //![fDimension] Array of pointers to variables formula
    TTreeFormula  *fSelect;         //  Pointer to selection formula
+   TBasketStatsCut *fStatsCut;     //! Range cuts of the selection checked against the basket statistics
    TTreeFormulaManager *fManager;  //  Pointer to the formula manager
    TObject       *fTreeElist;      //  pointer to Tree Event list
    TEntryListArray *fTreeElistArray;   //!  pointer to Tree Event list array
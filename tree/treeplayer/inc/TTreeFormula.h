@@ -126,6 +126,9 @@ protected:
 
    LongDouble_t*        fConstLD;   // local version of fConsts able to store bigger numbers
 
+   void                     *fJitKernel;      //! Compiled version of the formula, see JitCompile.
+   Bool_t                    fJitShortCircuit;//! True if the compiled version may skip some of the branches.
+
    TTreeFormula(const char *name, const char *formula, TTree *tree, const std::vector<std::string>& aliases);
    void Init(const char *name, const char *formula);
    Bool_t      BranchHasMethod(TLeaf* leaf, TBranch* branch, const char* method,const char* params, Long64_t readentry) const;
@@ -156,6 +159,7 @@ protected:
    virtual Bool_t    StringToNumber(Int_t code);
 
    void              Convert(UInt_t fromVersion);
+   Bool_t            GenerateJitKernel(TString &body, Bool_t &shortCircuit) const;
 
 private:
    // Not implemented yet
@@ -177,6 +181,7 @@ public:
    virtual Long64_t       EvalInstance64(Int_t i=0, const char *stringStack[]=0) {return EvalInstance<Long64_t>(i, stringStack); }
    virtual LongDouble_t   EvalInstanceLD(Int_t i=0, const char *stringStack[]=0) {return EvalInstance<LongDouble_t>(i, stringStack); }
 
+   Double_t            EvalJitVariable(Int_t code, Int_t instance, Bool_t willLoad, Bool_t &outOfRange);
    virtual const char *EvalStringInstance(Int_t i=0);
    virtual void*       EvalObject(Int_t i=0);
    // EvalInstance should be const.  See comment on GetNdata()
@@ -193,12 +198,16 @@ public:
    //the mutable keyword.
    //NOTE: Also modify the code in PrintValue which current goes around this limitation :(
    virtual Bool_t      IsInteger(Bool_t fast=kTRUE) const;
+           Bool_t      IsJitCompiled() const { return fJitKernel != 0; }
+   static  Bool_t      IsJitEnabled();
            Bool_t      IsQuickLoad() const { return fQuickLoad; }
+           Bool_t      JitCompile();
    virtual Bool_t      IsString() const;
    virtual Bool_t      Notify() { UpdateFormulaLeaves(); return kTRUE; }
    virtual char       *PrintValue(Int_t mode=0) const;
    virtual char       *PrintValue(Int_t mode, Int_t instance, const char *decform = "9.9") const;
    virtual void        SetAxis(TAxis *axis=0);
+   static  void        SetJitEnabled(Bool_t enable = kTRUE);
            void        SetQuickLoad(Bool_t quick) { fQuickLoad = quick; }
    virtual void        SetTree(TTree *tree) {fTree = tree;}
    virtual void        ResetLoading();
@@ -32,6 +32,13 @@
 class TTreeIndex : public TVirtualIndex {
 
 protected:
+   // A value of the index and its position in the sorted arrays.
+   struct TLookupNode {
+      Long64_t fMajor;
+      Long64_t fMinor;
+      Long64_t fPos;
+   };
+
    TString        fMajorName;           // Index major name
    TString        fMinorName;           // Index minor name
    Long64_t       fN;                   // Number of entries
@@ -42,6 +49,10 @@ protected:
    TTreeFormula  *fMinorFormula;        //! Pointer to minor TreeFormula
    TTreeFormula  *fMajorFormulaParent;  //! Pointer to major TreeFormula in Parent tree (if any)
    TTreeFormula  *fMinorFormulaParent;  //! Pointer to minor TreeFormula in Parent tree (if any)
+   TLookupNode   *fLookup;              //! [fN+1] Sorted values in Eytzinger order (node 0 unused)
+
+   void           BuildLookup();
+   Long64_t       FindInLookup(Long64_t major, Long64_t minor) const;
 
 private:
    TTreeIndex(const TTreeIndex&);            // Not implemented.
@@ -53,10 +64,11 @@ public:
    virtual               ~TTreeIndex();
    virtual void           Append(const TVirtualIndex *,Bool_t delaySort = kFALSE);
    bool                   ConvertOldToNew();
-   Long64_t               FindValues(Long64_t major, Long64_t minor) const;
+   Long64_t               FindValues(Long64_t major, Long64_t minor, Long64_t *last = 0) const;
    virtual Long64_t       GetEntryNumberFriend(const TTree *parent);
    virtual Long64_t       GetEntryNumberWithIndex(Long64_t major, Long64_t minor) const;
    virtual Long64_t       GetEntryNumberWithBestIndex(Long64_t major, Long64_t minor) const;
+   virtual void           GetEntryNumbersWithIndex(Long64_t n, const Long64_t *major, const Long64_t *minor, Long64_t *entries) const;
    virtual Long64_t      *GetIndex()        const {return fIndex;}
    virtual Long64_t      *GetIndexValues()  const {return fIndexValues;}
    virtual Long64_t      *GetIndexValuesMinor()  const;
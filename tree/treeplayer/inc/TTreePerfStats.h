@@ -51,6 +51,17 @@ protected:
    Double_t      fCpuTime;       //Cpu time
    Double_t      fDiskTime;      //Time spent in pure raw disk IO
    Double_t      fUnzipTime;     //Time spent uncompressing the data.
+   Int_t         fUnzipClusters; //Number of clusters unzipped in parallel
+   Double_t      fUnzipLatency;  //Sum of the unzip latencies of the clusters unzipped in parallel
+   Double_t      fUnzipLatencyMax;//Largest unzip latency of a cluster unzipped in parallel
+   Int_t         fReadVectors;   //Number of vectored reads executed with parallel requests
+   Long64_t      fReadVectorBytes;//Number of bytes read by the vectored reads
+   Double_t      fReadVectorTime;//Real time spent in the vectored reads
+   Double_t      fReadQueueTime; //Sum of the durations of the requests of the vectored reads
+   Int_t         fReadQueueDepthMax;//Largest number of requests in flight
+   Int_t         fBasketsSkipped;//Number of baskets skipped thanks to their statistics (see TBasketStatsCut)
+   Long64_t      fBytesSkipped;  //Number of zipped bytes of the baskets skipped
+   Long64_t      fEntriesSkipped;//Number of entries skipped
    Double_t      fCompress;      //Tree compression factor
    TString       fName;          //name of this TTreePerfStats
    TString       fHostInfo;      //name of the host system, ROOT version and date
@@ -74,8 +85,11 @@ public:
    virtual void     Finish();
    virtual Long64_t GetBytesRead() const {return fBytesRead;}
    virtual Long64_t GetBytesReadExtra() const {return fBytesReadExtra;}
+   virtual Long64_t GetBytesSkipped() const {return fBytesSkipped;}
+   virtual Int_t    GetBasketsSkipped() const {return fBasketsSkipped;}
    virtual Double_t GetCpuTime()   const {return fCpuTime;}
    virtual Double_t GetDiskTime()  const {return fDiskTime;}
+   virtual Long64_t GetEntriesSkipped() const {return fEntriesSkipped;}
    TGraphErrors    *GetGraphIO()     {return fGraphIO;}
    TGraphErrors    *GetGraphTime()   {return fGraphTime;}
    const char      *GetHostInfo() const{return fHostInfo.Data();}
@@ -85,9 +99,18 @@ public:
    TPaveText       *GetPave()      {return fPave;}
    virtual Int_t    GetReadaheadSize() const {return fReadaheadSize;}
    virtual Int_t    GetReadCalls() const {return fReadCalls;}
+   virtual Double_t GetReadQueueDepth() const {return fReadVectorTime > 0 ? fReadQueueTime/fReadVectorTime : 0;}
+   virtual Int_t    GetReadQueueDepthMax() const {return fReadQueueDepthMax;}
+   virtual Double_t GetReadQueueTime() const {return fReadQueueTime;}
+   virtual Long64_t GetReadVectorBytes() const {return fReadVectorBytes;}
+   virtual Int_t    GetReadVectors() const {return fReadVectors;}
+   virtual Double_t GetReadVectorTime() const {return fReadVectorTime;}
    virtual Double_t GetRealTime()  const {return fRealTime;}
    TStopwatch      *GetStopwatch() const {return fWatch;}
    virtual Int_t    GetTreeCacheSize() const {return fTreeCacheSize;}
+   virtual Int_t    GetUnzipClusters() const {return fUnzipClusters;}
+   virtual Double_t GetUnzipLatency() const {return fUnzipLatency;}
+   virtual Double_t GetUnzipLatencyMax() const {return fUnzipLatencyMax;}
    virtual Double_t GetUnzipTime() const {return fUnzipTime; }
    virtual void     Paint(Option_t *chopt="");
    virtual void     Print(Option_t *option="") const;
@@ -98,15 +121,21 @@ public:
    virtual void     FileEvent(const char *, const char *, const char *, const char *, Bool_t) {}
    virtual void     FileOpenEvent(TFile *, const char *, Double_t) {}
    virtual void     FileReadEvent(TFile *file, Int_t len, Double_t start);
+   virtual void     FileReadVectorEvent(TFile *file, Int_t nrequests, Long64_t len, Double_t realtime, Double_t queuetime, Int_t maxdepth);
    virtual void     UnzipEvent(TObject *tree, Long64_t pos, Double_t start, Int_t complen, Int_t objlen);
+   virtual void     UnzipClusterEvent(TObject *tree, Long64_t entry, Int_t nbaskets, Double_t latency, Double_t unziptime);
+   virtual void     BasketSkipEvent(TObject *tree, Long64_t entry, Long64_t nentries, Int_t nbaskets, Long64_t bytes);
    virtual void     RateEvent(Double_t , Double_t , Long64_t , Long64_t) {}
 
    virtual void     SaveAs(const char *filename="",Option_t *option="") const;
    virtual void     SavePrimitive(std::ostream &out, Option_t *option = "");
    virtual void     SetBytesRead(Long64_t nbytes) {fBytesRead = nbytes;}
    virtual void     SetBytesReadExtra(Long64_t nbytes) {fBytesReadExtra = nbytes;}
+   virtual void     SetBytesSkipped(Long64_t nbytes) {fBytesSkipped = nbytes;}
+   virtual void     SetBasketsSkipped(Int_t nbaskets) {fBasketsSkipped = nbaskets;}
    virtual void     SetCompress(Double_t cx) {fCompress = cx;}
    virtual void     SetDiskTime(Double_t t) {fDiskTime = t;}
+   virtual void     SetEntriesSkipped(Long64_t nentries) {fEntriesSkipped = nentries;}
    virtual void     SetNumEvents(Long64_t) {}
    virtual void     SetCpuTime(Double_t cptime) {fCpuTime = cptime;}
    virtual void     SetGraphIO(TGraphErrors *gr) {fGraphIO = gr;}
@@ -116,12 +145,20 @@ public:
    virtual void     SetNleaves(Int_t nleaves) {fNleaves = nleaves;}
    virtual void     SetReadaheadSize(Int_t nbytes) {fReadaheadSize = nbytes;}
    virtual void     SetReadCalls(Int_t ncalls) {fReadCalls = ncalls;}
+   virtual void     SetReadQueueDepthMax(Int_t depth) {fReadQueueDepthMax = depth;}
+   virtual void     SetReadQueueTime(Double_t t) {fReadQueueTime = t;}
+   virtual void     SetReadVectorBytes(Long64_t nbytes) {fReadVectorBytes = nbytes;}
+   virtual void     SetReadVectors(Int_t nreads) {fReadVectors = nreads;}
+   virtual void     SetReadVectorTime(Double_t t) {fReadVectorTime = t;}
    virtual void     SetRealNorm(Double_t rnorm) {fRealNorm = rnorm;}
    virtual void     SetRealTime(Double_t rtime) {fRealTime = rtime;}
    virtual void     SetTreeCacheSize(Int_t nbytes) {fTreeCacheSize = nbytes;}
+   virtual void     SetUnzipClusters(Int_t nclusters) {fUnzipClusters = nclusters;}
+   virtual void     SetUnzipLatency(Double_t latency) {fUnzipLatency = latency;}
+   virtual void     SetUnzipLatencyMax(Double_t latency) {fUnzipLatencyMax = latency;}
    virtual void     SetUnzipTime(Double_t uztime) {fUnzipTime = uztime;}
 
-   ClassDef(TTreePerfStats,1)  // TTree I/O performance measurement
+   ClassDef(TTreePerfStats,4)  // TTree I/O performance measurement
 };
 
 #endif
@@ -0,0 +1,118 @@
+// @(#)root/treeplayer:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2015, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TTreeProcessor
+#define ROOT_TTreeProcessor
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TTreeProcessor                                                       //
+//                                                                      //
+// Process the entries of a tree or of a list of files in parallel,    //
+// on the threads of the TTaskPool. The entries are split on cluster   //
+// boundaries and each range is read through a TTreeReader working on  //
+// a TFile and TTree private to the thread.                             //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef ROOT_TTreeReader
+#include "TTreeReader.h"
+#endif
+#ifndef ROOT_TList
+#include "TList.h"
+#endif
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class TFile;
+class TTaskGroup;
+
+class TTreeProcessor {
+
+public:
+   typedef std::function<void(TTreeReader &)> ProcessFunc_t;
+
+private:
+   struct TTreeView {
+      std::string fFileName;  // Name of the file currently open
+      TFile      *fFile;      // File private to one thread
+      TTree      *fTree;      // Tree read from fFile
+
+      TTreeView() : fFile(0), fTree(0) {}
+   };
+
+   std::vector<std::string>  fTreeNames;   // Name of the tree in each file
+   std::vector<std::string>  fFileNames;   // Files to process
+   std::map<std::thread::id, TTreeView*> fViews;  // Tree currently open by each thread
+   std::mutex                fMutex;       // Protects fViews and the per-thread objects of Process
+
+   TTreeProcessor(const TTreeProcessor &);             // not implemented
+   TTreeProcessor &operator=(const TTreeProcessor &);  // not implemented
+
+   void    CloneObject(TObject *&obj, const TObject &model);
+   TTree  *GetTree(UInt_t ifile);
+   void    ProcessFile(UInt_t ifile, const ProcessFunc_t &func, TTaskGroup &group);
+   void    ProcessRange(UInt_t ifile, Long64_t first, Long64_t last, const ProcessFunc_t &func);
+   void    ReleaseTrees();
+
+public:
+   TTreeProcessor(const char *treename, const std::vector<std::string> &filenames);
+   TTreeProcessor(const char *treename, const char *filename);
+   TTreeProcessor(TTree &tree);
+   ~TTreeProcessor();
+
+   UInt_t  GetNFiles() const { return fFileNames.size(); }
+   void    Process(const ProcessFunc_t &func);
+   template <class T, class F> T *Process(F func, const T &model);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Process all the entries calling func(reader, obj), where obj is a clone
+/// of model private to the calling thread (for example a histogram to fill).
+/// Once all the entries are processed, the clones are merged with
+/// T::Merge; the result, owned by the caller, is returned.
+
+template <class T, class F>
+T *TTreeProcessor::Process(F func, const T &model)
+{
+   std::map<std::thread::id, TObject*> objects;
+   Process([this, &func, &model, &objects](TTreeReader &reader) {
+      TObject *obj = 0;
+      {
+         std::lock_guard<std::mutex> lock(fMutex);
+         TObject *&slot = objects[std::this_thread::get_id()];
+         if (!slot) CloneObject(slot, model);
+         obj = slot;
+      }
+      func(reader, *static_cast<T*>(obj));
+   });
+
+   T *result = 0;
+   TList others;
+   for (std::map<std::thread::id, TObject*>::iterator i = objects.begin(); i != objects.end(); ++i) {
+      if (!result) result = static_cast<T*>(i->second);
+      else others.Add(i->second);
+   }
+   if (!result) {
+      TObject *obj = 0;
+      CloneObject(obj, model);
+      return static_cast<T*>(obj);
+   }
+   if (others.GetSize()) result->Merge(&others);
+   others.Delete();
+   return result;
+}
+
+#endif
@@ -35,6 +35,7 @@
 #include <deque>
 #include <iterator>
 
+class TBasketStatsCut;
 class TDictionary;
 class TDirectory;
 class TFileCollection;
@@ -138,7 +139,10 @@ public:
    TTreeReader():
       fDirectory(0),
       fEntryStatus(kEntryNoTree),
-      fDirector(0)
+      fDirector(0),
+      fBeginEntry(0),
+      fEndEntry(-1),
+      fBasketCut(0)
    {}
 
    TTreeReader(TTree* tree);
@@ -153,9 +157,16 @@ public:
 
    Bool_t IsChain() const { return TestBit(kBitIsChain); }
 
-   Bool_t Next() { return SetEntry(GetCurrentEntry() + 1) == kEntryValid; }
+   Bool_t Next() {
+      // Load the next entry; the first call loads the beginning of the entry range.
+      Long64_t entry = (fEntryStatus == kEntryNotLoaded) ? fBeginEntry : GetCurrentEntry() + 1;
+      if (fBasketCut) entry = SkipEntries(entry);
+      return SetEntry(entry) == kEntryValid;
+   }
    EEntryStatus SetEntry(Long64_t entry) { return SetEntryBase(entry, kFALSE); }
    EEntryStatus SetLocalEntry(Long64_t entry) { return SetEntryBase(entry, kTRUE); }
+   void SetEntriesRange(Long64_t beginEntry, Long64_t endEntry);
+   void SetBasketCut(const char *cut);
 
    EEntryStatus GetEntryStatus() const { return fEntryStatus; }
 
@@ -164,8 +175,8 @@ public:
    Long64_t GetCurrentEntry() const;
 
    Iterator_t begin() {
-      // Return an iterator to the 0th TTree entry.
-      return Iterator_t(*this, 0);
+      // Return an iterator to the first entry of the range (by default the 0th TTree entry).
+      return Iterator_t(*this, fBeginEntry);
    }
    Iterator_t end() const { return Iterator_t(); }
 
@@ -179,6 +190,7 @@ protected:
    void DeregisterValueReader(ROOT::Internal::TTreeReaderValueBase* reader);
 
    EEntryStatus SetEntryBase(Long64_t entry, Bool_t local);
+   Long64_t SkipEntries(Long64_t entry);
 
 private:
 
@@ -192,6 +204,9 @@ private:
    ROOT::Internal::TBranchProxyDirector* fDirector; // proxying director, owned
    std::deque<ROOT::Internal::TTreeReaderValueBase*> fValues; // readers that use our director
    THashTable   fProxies; //attached ROOT::TNamedBranchProxies; owned
+   Long64_t fBeginEntry; // first entry read by Next() and begin()
+   Long64_t fEndEntry; // entry at which the reading stops (-1 for the end of the tree)
+   TBasketStatsCut* fBasketCut; // range cuts of the entries skipped by Next(), owned
 
    friend class ROOT::Internal::TTreeReaderValueBase;
    friend class ROOT::Internal::TTreeReaderArrayBase;
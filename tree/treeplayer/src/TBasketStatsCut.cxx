@@ -0,0 +1,276 @@
+// @(#)root/treeplayer:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2015, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+/** \class TBasketStatsCut
+The range cuts of a selection, checked against the statistics of the
+baskets to skip the entries that cannot pass the selection without
+reading them.
+
+When TBranch::SetBasketStats (or TTree::SetBasketStats) is called before a
+tree is filled, the smallest and largest value of the leaf and the number
+of values are stored for each basket of the branch. A TBasketStatsCut
+extracts from a selection the terms of its top level conjunction of the
+form `name op number` or `number op name`, where name is a leaf or branch
+of the tree and op one of `<`, `<=`, `>`, `>=` and `==`, for example
+
+~~~{.cpp}
+   TBasketStatsCut cut("pt > 50 && abs(eta) < 2.5 && nhits >= 4");
+~~~
+
+uses the ranges of pt and nhits and ignores the other term. An entry
+cannot pass the selection if the basket holding it, for one of these
+leaves, has no value in the range; all the entries of this basket are
+then skipped. For a leaf holding an array, the cut is assumed to pass if
+any value passes, as in TTree::Draw. A selection with a disjunction (`||`)
+or a conditional at its top level gives no range. The ranges on a leaf
+without statistics, e.g. in a file written before they were introduced,
+in a friend tree or of a split object, are ignored.
+
+TTree::Draw uses the selection this way, and TTreeReader::SetBasketCut
+does for the entries read by TTreeReader::Next. The entries and the bytes
+skipped are reported to gPerfStats (see TTreePerfStats).
+*/
+
+#include "TBasketStatsCut.h"
+#include "TBranch.h"
+#include "TLeaf.h"
+#include "TMath.h"
+#include "TTree.h"
+#include "TVirtualPerfStats.h"
+
+#include <ctype.h>
+#include <stdlib.h>
+
+ClassImp(TBasketStatsCut)
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if s is enclosed by a pair of matching parentheses.
+
+static Bool_t IsEnclosed(const TString &s)
+{
+   if (!s.BeginsWith("(") || !s.EndsWith(")")) return kFALSE;
+   Int_t depth = 0;
+   for (Ssiz_t i = 0; i < s.Length(); ++i) {
+      if (s[i] == '(') ++depth;
+      else if (s[i] == ')') --depth;
+      if (depth == 0 && i < s.Length() - 1) return kFALSE;
+   }
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if s is the name of a leaf or branch.
+
+static Bool_t IsName(const TString &s)
+{
+   if (s.IsNull() || !(isalpha(s[0]) || s[0] == '_')) return kFALSE;
+   for (Ssiz_t i = 1; i < s.Length(); ++i) {
+      if (!(isalnum(s[i]) || s[i] == '_' || s[i] == '.')) return kFALSE;
+   }
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if s is a finite number, returned in value.
+
+static Bool_t IsNumber(const TString &s, Double_t &value)
+{
+   if (s.IsNull()) return kFALSE;
+   char *end = 0;
+   value = strtod(s.Data(), &end);
+   return *end == 0 && TMath::Finite(value);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Create the range cuts of the selection cut.
+
+TBasketStatsCut::TBasketStatsCut(const char *cut) : fCut(cut), fTree(0), fChainOffset(0), fFirst(0), fLast(0), fSkip(kFALSE)
+{
+   Parse(fCut);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Destructor.
+
+TBasketStatsCut::~TBasketStatsCut()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add the range of the term `name op number` or `number op name`.
+/// Return false if the term has another form.
+
+Bool_t TBasketStatsCut::AddRange(const TString &term)
+{
+   Ssiz_t pos = term.First("<>=!");
+   if (pos == kNPOS || pos == 0) return kFALSE;
+   TString op = term(pos, 1);
+   if (pos + 1 < term.Length() && term[pos + 1] == '=') op += "=";
+   if (op != "<" && op != "<=" && op != ">" && op != ">=" && op != "==") return kFALSE;
+
+   TString left = TString(term(0, pos)).Strip(TString::kBoth);
+   TString right = TString(term(pos + op.Length(), term.Length())).Strip(TString::kBoth);
+   TRange range;
+   Double_t value;
+   if (IsName(left) && IsNumber(right, value)) {
+      range.fName = left;
+   } else if (IsNumber(left, value) && IsName(right)) {
+      range.fName = right;
+      // number < name is name > number.
+      if (op[0] == '<') op[0] = '>';
+      else if (op[0] == '>') op[0] = '<';
+   } else {
+      return kFALSE;
+   }
+   range.fLow = -TMath::Infinity();
+   range.fHigh = TMath::Infinity();
+   range.fLowIncluded = kTRUE;
+   range.fHighIncluded = kTRUE;
+   range.fBranch = 0;
+   if (op[0] != '<') {
+      range.fLow = value;
+      range.fLowIncluded = op != ">";
+   }
+   if (op[0] != '>') {
+      range.fHigh = value;
+      range.fHighIncluded = op != "<";
+   }
+   fRanges.push_back(range);
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Check the statistics of the baskets holding entry of the current tree.
+/// Return true if the entry cannot pass the selection. The decision holds
+/// for the entries in [fFirst,fLast).
+
+Bool_t TBasketStatsCut::Decide(Long64_t entry)
+{
+   if (entry >= fFirst && entry < fLast) return fSkip;
+
+   fFirst = entry;
+   fLast = TMath::Limits<Long64_t>::Max();
+   fSkip = kFALSE;
+   Long64_t skipped = entry;
+   Int_t nbaskets = 0;
+   Long64_t bytes = 0;
+   for (std::vector<TRange>::const_iterator r = fRanges.begin(); r != fRanges.end(); ++r) {
+      TBranch *branch = r->fBranch;
+      if (!branch) continue;
+      Int_t last = branch->GetWriteBasket();
+      Long64_t *entries = branch->GetBasketEntry();
+      Int_t basket = TMath::BinarySearch(last + 1, entries, entry);
+      if (basket < 0) continue;
+      while (basket < last && entries[basket + 1] <= entry) ++basket;
+      Long64_t end = basket < last ? entries[basket + 1] : branch->GetEntries();
+      if (end <= entry) continue;
+      if (end < fLast) fLast = end;
+
+      Double_t min, max;
+      Long64_t nvalues;
+      if (!branch->GetBasketStats(basket, min, max, nvalues)) continue;
+      if (nvalues == 0 ||
+          max < r->fLow || (max == r->fLow && !r->fLowIncluded) ||
+          min > r->fHigh || (min == r->fHigh && !r->fHighIncluded)) {
+         if (end > skipped) skipped = end;
+         ++nbaskets;
+         bytes += branch->GetBasketBytes()[basket];
+      }
+   }
+   if (skipped > entry) {
+      fSkip = kTRUE;
+      fLast = skipped;
+      if (gPerfStats) gPerfStats->BasketSkipEvent(fTree, entry, skipped - entry, nbaskets, bytes);
+   }
+   return fSkip;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the first entry of tree from entry on that may pass the selection,
+/// or the number of entries of tree if there is none.
+
+Long64_t TBasketStatsCut::GetNextEntry(TTree *tree, Long64_t entry)
+{
+   if (tree != fTree || tree->GetChainOffset() != fChainOffset) SetTree(tree);
+   Long64_t nentries = tree->GetEntries();
+   while (entry < nentries && Decide(entry)) entry = fLast;
+   return entry;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add the ranges of the top level conjunction of cut. Return false if
+/// cut is not a conjunction.
+
+Bool_t TBasketStatsCut::Parse(const TString &cut)
+{
+   TString expr = cut.Strip(TString::kBoth);
+   while (IsEnclosed(expr)) expr = TString(expr(1, expr.Length() - 2)).Strip(TString::kBoth);
+
+   std::vector<TString> terms;
+   Int_t depth = 0;
+   Ssiz_t start = 0;
+   for (Ssiz_t i = 0; i < expr.Length(); ++i) {
+      char c = expr[i];
+      if (c == '"' || c == '\'') return kFALSE;
+      if (c == '(' || c == '[') {
+         ++depth;
+      } else if (c == ')' || c == ']') {
+         --depth;
+      } else if (depth == 0) {
+         if (c == '?' || (c == '|' && i + 1 < expr.Length() && expr[i + 1] == '|')) return kFALSE;
+         if (c == '&' && i + 1 < expr.Length() && expr[i + 1] == '&') {
+            terms.push_back(expr(start, i - start));
+            start = i + 2;
+            ++i;
+         }
+      }
+   }
+   terms.push_back(expr(start, expr.Length() - start));
+
+   for (std::vector<TString>::iterator term = terms.begin(); term != terms.end(); ++term) {
+      TString t = term->Strip(TString::kBoth);
+      if (IsEnclosed(t)) Parse(t);
+      else AddRange(t);
+   }
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Find the branches of the ranges in tree. The ranges on an alias, on a
+/// leaf of a friend tree or on a branch without statistics are ignored.
+
+void TBasketStatsCut::SetTree(TTree *tree)
+{
+   fTree = tree;
+   fChainOffset = tree ? tree->GetChainOffset() : 0;
+   fFirst = 0;
+   fLast = 0;
+   fSkip = kFALSE;
+   for (std::vector<TRange>::iterator r = fRanges.begin(); r != fRanges.end(); ++r) {
+      r->fBranch = 0;
+      if (!tree || tree->GetAlias(r->fName)) continue;
+      TBranch *branch = tree->GetBranch(r->fName);
+      if (!branch) {
+         TLeaf *leaf = tree->GetLeaf(r->fName);
+         if (leaf) branch = leaf->GetBranch();
+      }
+      if (branch && branch->GetTree() == tree && branch->HasBasketStats()) r->fBranch = branch;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if entry of tree cannot pass the selection. The statistics
+/// are checked once per basket: this can be called for each entry.
+
+Bool_t TBasketStatsCut::Skip(TTree *tree, Long64_t entry)
+{
+   if (tree != fTree || tree->GetChainOffset() != fChainOffset) SetTree(tree);
+   return Decide(entry);
+}
@@ -208,20 +208,28 @@ std::pair<TVirtualIndex*, Int_t> TChainIndex::GetSubTreeIndex(Long64_t major, Lo
       return make_pair(static_cast<TVirtualIndex*>(0), 0);
    }
 
-   Int_t treeNo = fEntries.size() - 1;
-   for (unsigned int i = 0; i < fEntries.size() - 1; i++) {
-      if( indexValue < fEntries[i+1].GetMinIndexValPair() ) {
-         treeNo = i;
-         break;
+   // Find the last tree whose smallest value is not greater than indexValue.
+   Int_t first = 1;
+   Int_t last = fEntries.size();
+   while (first < last) {
+      Int_t mid = first + (last - first) / 2;
+      if( indexValue < fEntries[mid].GetMinIndexValPair() ) {
+         last = mid;
+      } else {
+         first = mid + 1;
       }
    }
+   Int_t treeNo = first - 1;
    // Double check we found the right range.
    if( indexValue > fEntries[treeNo].GetMaxIndexValPair() ) {
       return make_pair(static_cast<TVirtualIndex*>(0), 0);
    }
    TChain* chain = dynamic_cast<TChain*> (fTree);
    R__ASSERT(chain);
-   chain->LoadTree(chain->GetTreeOffset()[treeNo]);
+   // Consecutive lookups often fall in the same tree.
+   if (chain->GetTreeNumber() != treeNo || !chain->GetTree()) {
+      chain->LoadTree(chain->GetTreeOffset()[treeNo]);
+   }
    TVirtualIndex* index =  fTree->GetTree()->GetTreeIndex();
    if (index)
       return make_pair(static_cast<TVirtualIndex*>(index), treeNo);
@@ -303,6 +311,38 @@ Long64_t TChainIndex::GetEntryNumberWithBestIndex(Long64_t major, Long64_t minor
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Look up n pairs of values, see TVirtualIndex::GetEntryNumbersWithIndex.
+/// The consecutive pairs falling in the range of the same tree are given in
+/// one batch to the index of this tree.
+
+void TChainIndex::GetEntryNumbersWithIndex(Long64_t n, const Long64_t *major, const Long64_t *minor, Long64_t *entries) const
+{
+   TChain* chain = dynamic_cast<TChain*> (fTree);
+   R__ASSERT(chain);
+   Long64_t i = 0;
+   while (i < n) {
+      std::pair<TVirtualIndex*, Int_t> indexAndNumber = GetSubTreeIndex(major[i], minor ? minor[i] : 0);
+      if (!indexAndNumber.first) {
+         entries[i++] = -1;
+         continue;
+      }
+      const TChainIndexEntry &entry = fEntries[indexAndNumber.second];
+      Long64_t end = i + 1;
+      while (end < n) {
+         TChainIndexEntry::IndexValPair_t indexValue(major[end], minor ? minor[end] : 0);
+         if (indexValue < entry.GetMinIndexValPair() || indexValue > entry.GetMaxIndexValPair()) break;
+         ++end;
+      }
+      indexAndNumber.first->GetEntryNumbersWithIndex(end - i, major + i, minor ? minor + i : 0, entries + i);
+      ReleaseSubTreeIndex(indexAndNumber.first, indexAndNumber.second);
+      Long64_t offset = chain->GetTreeOffset()[indexAndNumber.second];
+      for (; i < end; ++i) {
+         if (entries[i] >= 0) entries[i] += offset;
+      }
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Returns the entry number with given index values.
 /// See TTreeIndex::GetEntryNumberWithIndex for details.
@@ -15,6 +15,7 @@ A specialized TSelector for TTree::Draw.
 
 #include "TSelectorDraw.h"
 #include "TROOT.h"
+#include "TBasketStatsCut.h"
 #include "TH2.h"
 #include "TH3.h"
 #include "TView.h"
@@ -61,6 +62,7 @@ TSelectorDraw::TSelectorDraw()
    fManager        = 0;
    fMultiplicity   = 0;
    fSelect         = 0;
+   fStatsCut       = 0;
    fSelectedRows   = 0;
    fDraw           = 0;
    fObject         = 0;
@@ -924,6 +926,7 @@ void TSelectorDraw::ClearFormula()
       fVar[i] = 0;
    }
    delete fSelect; fSelect = 0;
+   delete fStatsCut; fStatsCut = 0;
    fManager = 0;
    fMultiplicity = 0;
 }
@@ -969,6 +972,11 @@ Bool_t TSelectorDraw::CompileVariables(const char *varexp, const char *selection
          fSelect = 0;
          return kFALSE;
       }
+      fStatsCut = new TBasketStatsCut(selection);
+      if (fStatsCut->IsEmpty()) {
+         delete fStatsCut;
+         fStatsCut = 0;
+      }
    }
 
    // if varexp is empty, take first column by default
@@ -984,6 +992,8 @@ Bool_t TSelectorDraw::CompileVariables(const char *varexp, const char *selection
       if (fManager->GetMultiplicity() == -1) fTree->SetBit(TTree::kForceRead);
       if (fManager->GetMultiplicity() >= 1) fMultiplicity = fManager->GetMultiplicity();
 
+      if (fSelect && TTreeFormula::IsJitEnabled()) fSelect->JitCompile();
+
       return kTRUE;
    }
 
@@ -1007,6 +1017,12 @@ Bool_t TSelectorDraw::CompileVariables(const char *varexp, const char *selection
    if (fManager->GetMultiplicity() == -1) fTree->SetBit(TTree::kForceRead);
    if (fManager->GetMultiplicity() >= 1) fMultiplicity = fManager->GetMultiplicity();
 
+   // Replace the interpretation of the formulas by compiled code if requested.
+   if (TTreeFormula::IsJitEnabled()) {
+      if (fSelect) fSelect->JitCompile();
+      for (i = 0; i < ncols; ++i) fVar[i]->JitCompile();
+   }
+
    fDimension    = ncols;
 
    if (ncols == 1) {
@@ -1143,6 +1159,9 @@ Bool_t TSelectorDraw::Notify()
 
 void TSelectorDraw::ProcessFill(Long64_t entry)
 {
+   // Skip the entries whose baskets hold no value passing the selection.
+   if (fStatsCut && fStatsCut->Skip(fTree->GetTree(), entry)) return;
+
    if (fObjEval) {
       ProcessFillObject(entry);
       return;
@@ -1337,7 +1356,7 @@ void TSelectorDraw::TakeAction()
    //__________________________2-D histogram_______________________
    else if (fAction ==  2) {
       TH2 *h2 = (TH2*)fObject;
-      for (i = 0; i < fNfill; i++) h2->Fill(fVal[1][i], fVal[0][i], fW[i]);
+      h2->FillN(fNfill, fVal[1], fVal[0], fW);
    }
    //__________________________Profile histogram_______________________
    else if (fAction ==  4)((TProfile*)fObject)->FillN(fNfill, fVal[1], fVal[0], fW);
@@ -1386,14 +1405,14 @@ void TSelectorDraw::TakeAction()
          else                                                                pm->Draw(fOption.Data());
       }
       if (!h2->TestBit(kCanDelete)) {
-         for (i = 0; i < fNfill; i++) h2->Fill(fVal[1][i], fVal[0][i], fW[i]);
+         h2->FillN(fNfill, fVal[1], fVal[0], fW);
       }
    }
    //__________________________3D scatter plot_______________________
    else if (fAction ==  3) {
       TH3 *h3 = (TH3*)fObject;
       if (!h3->TestBit(kCanDelete)) {
-         for (i = 0; i < fNfill; i++) h3->Fill(fVal[2][i], fVal[1][i], fVal[0][i], fW[i]);
+         h3->FillN(fNfill, fVal[2], fVal[1], fVal[0], fW);
       }
    } else if (fAction == 13) {
       TPolyMarker3D *pm3d = new TPolyMarker3D(fNfill);
@@ -1406,7 +1425,7 @@ void TSelectorDraw::TakeAction()
       pm3d->Draw();
       TH3 *h3 = (TH3*)fObject;
       if (!h3->TestBit(kCanDelete)) {
-         for (i = 0; i < fNfill; i++) h3->Fill(fVal[2][i], fVal[1][i], fVal[0][i], fW[i]);
+         h3->FillN(fNfill, fVal[2], fVal[1], fVal[0], fW);
       }
    }
    //__________________________3D scatter plot (3rd variable = col)__
@@ -1555,7 +1574,7 @@ void TSelectorDraw::TakeEstimate()
          }
          THLimitsFinder::GetLimitsFinder()->FindGoodLimits(h2, fVmin[1], fVmax[1], fVmin[0], fVmax[0]);
       }
-      for (i = 0; i < fNfill; i++) h2->Fill(fVal[1][i], fVal[0][i], fW[i]);
+      h2->FillN(fNfill, fVal[1], fVal[0], fW);
    //__________________________Profile histogram_______________________
    } else if (fAction ==  4) {
       TProfile *hp = (TProfile*)fObject;
@@ -1642,7 +1661,7 @@ void TSelectorDraw::TakeEstimate()
          }
       }
       if (h2 && !h2->TestBit(kCanDelete)) {
-         for (i = 0; i < fNfill; i++) h2->Fill(fVal[1][i], fVal[0][i], fW[i]);
+         h2->FillN(fNfill, fVal[1], fVal[0], fW);
       }
    //__________________________3D scatter plot with option col_______________________
    } else if (fAction == 33) {
@@ -1698,7 +1717,7 @@ void TSelectorDraw::TakeEstimate()
          THLimitsFinder::GetLimitsFinder()->FindGoodLimits(h3, fVmin[2], fVmax[2], fVmin[1], fVmax[1], fVmin[0], fVmax[0]);
       }
       if (fAction == 3) {
-         for (i = 0; i < fNfill; i++) h3->Fill(fVal[2][i], fVal[1][i], fVal[0][i], fW[i]);
+         h3->FillN(fNfill, fVal[2], fVal[1], fVal[0], fW);
          return;
       }
       if (!strstr(fOption.Data(), "same") && !strstr(fOption.Data(), "goff")) {
@@ -1732,7 +1751,7 @@ void TSelectorDraw::TakeEstimate()
       }
       if (!fDraw && !strstr(fOption.Data(), "goff")) pm3d->Draw();
       if (!h3->TestBit(kCanDelete)) {
-         for (i = 0; i < fNfill; i++) h3->Fill(fVal[2][i], fVal[1][i], fVal[0][i], fW[i]);
+         h3->FillN(fNfill, fVal[2], fVal[1], fVal[0], fW);
       }
 
    //__________________________2D Profile Histogram__________________
@@ -45,6 +45,8 @@
 #include "TFormLeafInfoReference.h"
 
 #include "TEntryList.h"
+#include "TEnv.h"
+#include "TVirtualMutex.h"
 
 #include <ctype.h>
 #include <stdio.h>
@@ -52,6 +54,9 @@
 #include <stdlib.h>
 #include <typeinfo>
 #include <algorithm>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
 
 const Int_t kMaxLen     = 1024;
 
@@ -123,7 +128,7 @@ public:
 ////////////////////////////////////////////////////////////////////////////////
 
 TTreeFormula::TTreeFormula(): ROOT::v5::TFormula(), fQuickLoad(kFALSE), fNeedLoading(kTRUE),
-   fDidBooleanOptimization(kFALSE), fDimensionSetup(0)
+   fDidBooleanOptimization(kFALSE), fDimensionSetup(0), fJitKernel(0), fJitShortCircuit(kFALSE)
 
 {
    // Tree Formula default constructor
@@ -157,7 +162,7 @@ TTreeFormula::TTreeFormula(): ROOT::v5::TFormula(), fQuickLoad(kFALSE), fNeedLoa
 
 TTreeFormula::TTreeFormula(const char *name,const char *expression, TTree *tree)
    :ROOT::v5::TFormula(), fTree(tree), fQuickLoad(kFALSE), fNeedLoading(kTRUE),
-    fDidBooleanOptimization(kFALSE), fDimensionSetup(0)
+    fDidBooleanOptimization(kFALSE), fDimensionSetup(0), fJitKernel(0), fJitShortCircuit(kFALSE)
 {
    Init(name,expression);
 }
@@ -168,7 +173,8 @@ TTreeFormula::TTreeFormula(const char *name,const char *expression, TTree *tree)
 TTreeFormula::TTreeFormula(const char *name,const char *expression, TTree *tree,
                            const std::vector<std::string>& aliases)
    :ROOT::v5::TFormula(), fTree(tree), fQuickLoad(kFALSE), fNeedLoading(kTRUE),
-    fDidBooleanOptimization(kFALSE), fDimensionSetup(0), fAliasesUsed(aliases)
+    fDidBooleanOptimization(kFALSE), fDimensionSetup(0), fAliasesUsed(aliases), fJitKernel(0),
+    fJitShortCircuit(kFALSE)
 {
    Init(name,expression);
 }
@@ -3737,7 +3743,7 @@ const char* TTreeFormula::EvalStringInstance(Int_t instance)
       return bin-0.5;                                                                           \
    }
 
-#define TT_EVAL_INIT_LOOP                                                                       \
+#define TT_EVAL_LOAD_LOOP                                                                       \
    TLeaf *leaf = (TLeaf*)fLeaves.UncheckedAt(code);                                             \
                                                                                                 \
    /* Now let calculate what physical instance we really need.  */                              \
@@ -3762,7 +3768,10 @@ const char* TTreeFormula::EvalStringInstance(Int_t instance)
          Long64_t treeEntry = br->GetTree()->GetReadEntry();                                    \
          if (br->GetReadEntry() != treeEntry) br->GetEntry( treeEntry );                        \
       }                                                                                         \
-   }                                                                                            \
+   }
+
+#define TT_EVAL_INIT_LOOP                                                                       \
+   TT_EVAL_LOAD_LOOP;                                                                           \
    if (real_instance>=fNdata[code]) return 0;
 
 #define TREE_EVAL_INIT_LOOP                                                                     \
@@ -3881,6 +3890,22 @@ template <> Long64_t fmod_local(Long64_t x, Long64_t y) { return fmod((LongDoubl
 template<typename T> inline void SetMethodParam(TMethodCall *method, T p) { method->SetParam(p); }
 template<> void SetMethodParam(TMethodCall *method, LongDouble_t p) { method->SetParam((Double_t)p); }
 
+// Signature of the functions generated by TTreeFormula::JitCompile.
+typedef Double_t (*JitKernel_t)(TTreeFormula *form, Int_t instance, Bool_t willLoad, Bool_t &outOfRange);
+
+// The compiled kernels (0 if the compilation failed), indexed by their body.
+std::unordered_map<std::string, void*> &JitKernels()
+{
+   static std::unordered_map<std::string, void*> kernels;
+   return kernels;
+}
+
+Int_t &JitEnabled()
+{
+   static Int_t enabled = gEnv->GetValue("TTreeFormula.JitCompile", 0);
+   return enabled;
+}
+
 }
 
 template<typename T> inline T TTreeFormula::GetConstant(Int_t k) { return fConst[k]; }
@@ -3915,6 +3940,15 @@ T TTreeFormula::EvalInstance(Int_t instance, const char *stringStackArg[])
 // Note that the redundance and structure in this code is tailored to improve
 // efficiencies.
    if (TestBit(kMissingLeaf)) return 0;
+   if (fJitKernel && std::is_same<T, Double_t>::value && !stringStackArg) {
+      // Same loading protocol as the interpreted loop below; the kernel
+      // may skip branches, so the later instances check their loading.
+      const Bool_t willLoad = (instance==0 || fNeedLoading); fNeedLoading = kFALSE;
+      if (willLoad) fDidBooleanOptimization = fJitShortCircuit;
+      Bool_t outOfRange = kFALSE;
+      Double_t result = ((JitKernel_t)fJitKernel)(this, instance, willLoad, outOfRange);
+      return outOfRange ? 0 : (T)result;
+   }
    if (fNoper == 1 && fNcodes > 0) {
 
       switch (fLookupType[0]) {
@@ -4360,6 +4394,300 @@ template double TTreeFormula::EvalInstance<double> (int, char const**);
 template long double TTreeFormula::EvalInstance<long double> (int, char const**);
 template long long TTreeFormula::EvalInstance<long long> (int, char const**);
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the value of the tree variable code for the given instance, as
+/// the interpreted loop of EvalInstance does; used by the compiled kernels
+/// (see JitCompile). outOfRange is set if the instance does not exist, in
+/// which case the value of the formula is 0.
+
+Double_t TTreeFormula::EvalJitVariable(Int_t code, Int_t instance, Bool_t willLoad, Bool_t &outOfRange)
+{
+   switch (fLookupType[code]) {
+      case kIndexOfEntry:      return fTree->GetReadEntry();
+      case kIndexOfLocalEntry: return fTree->GetTree()->GetReadEntry();
+      case kEntries:           return fTree->GetEntries();
+      case kLength:            return fManager->fNdata;
+      case kIteration:         return instance;
+      case kDirect: {
+         TT_EVAL_LOAD_LOOP;
+         if (real_instance>=fNdata[code]) { outOfRange = kTRUE; return 0; }
+         return leaf->GetTypedValue<Double_t>(real_instance);
+      }
+      case kDataMember: {
+         TT_EVAL_LOAD_LOOP;
+         if (real_instance>=fNdata[code]) { outOfRange = kTRUE; return 0; }
+         return ((TFormLeafInfo*)fDataMembers.UncheckedAt(code))->GetTypedValue<Double_t>(leaf,real_instance);
+      }
+      case kTreeMember: {
+         const Int_t real_instance = GetRealInstance(instance,code);
+         if (real_instance>=fNdata[code]) { outOfRange = kTRUE; return 0; }
+         return ((TFormLeafInfo*)fDataMembers.UncheckedAt(code))->GetTypedValue<Double_t>((TLeaf*)0x0,real_instance);
+      }
+      case kEntryList: {
+         TEntryList *elist = (TEntryList*)fExternalCuts.At(code);
+         return elist->Contains(fTree->GetReadEntry());
+      }
+   }
+   return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Translate the operations of the formula into the parameter list and
+/// the body of a C++ function computing the same value as
+/// EvalInstance<Double_t>. Each slot of the stack of the interpreter
+/// becomes a local variable, the jumps (?: and the && and || shortcuts)
+/// become goto statements and the tree variables are read with
+/// EvalJitVariable. shortCircuit is set if some tree variables may be
+/// skipped.
+///
+/// Return kFALSE if the formula uses an operation which is not translated
+/// (strings, function calls, aliases, graphical cuts, ...).
+
+Bool_t TTreeFormula::GenerateJitKernel(TString &body, Bool_t &shortCircuit) const
+{
+   if (fNoper < 2 || fAxis) return kFALSE;
+
+   // The operation executed after a jump to 'target' is target+1, mark those.
+   std::vector<Bool_t> isTarget(fNoper + 1, kFALSE);
+   std::vector<Int_t> targetPos(fNoper + 1, -1);
+   shortCircuit = kFALSE;
+   for (Int_t i = 0; i < fNoper; ++i) {
+      const Int_t action = GetOper()[i] >> kTFOperShift;
+      const Int_t param = GetOper()[i] & kTFOperMask;
+      Int_t next = -1;
+      if (action == kJump || action == kJumpIf) next = param + 1;
+      else if (action == kBoolOptimize && (param % 10 == 1 || param % 10 == 2)) next = i + param / 10 + 1;
+      if (next == -1) continue;
+      if (next <= i || next > fNoper) return kFALSE;
+      isTarget[next] = kTRUE;
+      shortCircuit = kTRUE;
+   }
+
+   auto slot = [](Int_t k) { return TString::Format("s%d", k); };
+   TString code;
+   Int_t pos = 0;
+   Int_t maxpos = 1;
+   Bool_t reachable = kTRUE;
+   for (Int_t i = 0; i <= fNoper; ++i) {
+      if (isTarget[i]) {
+         if (!reachable) pos = targetPos[i];
+         else if (targetPos[i] != pos) return kFALSE;
+         code += TString::Format("L%d:\n", i);
+         reachable = kTRUE;
+      }
+      if (i == fNoper) break;
+      if (!reachable) return kFALSE;
+
+      const Int_t oper = GetOper()[i];
+      const Int_t action = oper >> kTFOperShift;
+      const Int_t param = oper & kTFOperMask;
+
+      // Operands of a unary (t) or binary (a, b) operation, pushed value (t).
+      Int_t nargs = 0;
+      switch (action) {
+         case kAdd: case kSubstract: case kMultiply: case kDivide: case kModulo:
+         case katan2: case kfmod: case kpow: case kmin: case kmax:
+         case kAnd: case kOr: case kEqual: case kNotEqual: case kLess: case kGreater:
+         case kLessThan: case kGreaterThan:
+         case kBitAnd: case kBitOr: case kLeftShift: case kRightShift:
+            nargs = 2; break;
+         case kcos: case ksin: case ktan: case kacos: case kasin: case katan:
+         case kcosh: case ksinh: case ktanh: case kacosh: case kasinh: case katanh:
+         case ksq: case ksqrt: case klog: case kexp: case klog10:
+         case kabs: case ksign: case kint: case kSignInv: case kNot:
+         case kJumpIf: case kBoolOptimize:
+            nargs = 1; break;
+      }
+      if (pos < nargs) return kFALSE;
+      if (nargs == 2) --pos;
+      const TString a = slot(pos-1);
+      const TString b = slot(pos);
+      const TString &t = a;
+
+      switch (action) {
+         case kEnd:         code += "   return s0;\n"; reachable = kFALSE; continue;
+         case kAdd:         code += TString::Format("   %s += %s;\n", a.Data(), b.Data()); continue;
+         case kSubstract:   code += TString::Format("   %s -= %s;\n", a.Data(), b.Data()); continue;
+         case kMultiply:    code += TString::Format("   %s *= %s;\n", a.Data(), b.Data()); continue;
+         case kDivide:      code += TString::Format("   if (%s == 0) %s = 0; else %s /= %s;\n", b.Data(), a.Data(), a.Data(), b.Data()); continue;
+         case kModulo:      code += TString::Format("   %s = Double_t(Long64_t(%s) %% Long64_t(%s));\n", a.Data(), a.Data(), b.Data()); continue;
+
+         case kcos:  code += TString::Format("   %s = TMath::Cos(%s);\n", t.Data(), t.Data()); continue;
+         case ksin:  code += TString::Format("   %s = TMath::Sin(%s);\n", t.Data(), t.Data()); continue;
+         case ktan:  code += TString::Format("   if (TMath::Cos(%s) == 0) %s = 0; else %s = TMath::Tan(%s);\n", t.Data(), t.Data(), t.Data(), t.Data()); continue;
+         case kacos: code += TString::Format("   if (TMath::Abs(%s) > 1) %s = 0; else %s = TMath::ACos(%s);\n", t.Data(), t.Data(), t.Data(), t.Data()); continue;
+         case kasin: code += TString::Format("   if (TMath::Abs(%s) > 1) %s = 0; else %s = TMath::ASin(%s);\n", t.Data(), t.Data(), t.Data(), t.Data()); continue;
+         case katan: code += TString::Format("   %s = TMath::ATan(%s);\n", t.Data(), t.Data()); continue;
+         case kcosh: code += TString::Format("   %s = TMath::CosH(%s);\n", t.Data(), t.Data()); continue;
+         case ksinh: code += TString::Format("   %s = TMath::SinH(%s);\n", t.Data(), t.Data()); continue;
+         case ktanh: code += TString::Format("   if (TMath::CosH(%s) == 0) %s = 0; else %s = TMath::TanH(%s);\n", t.Data(), t.Data(), t.Data(), t.Data()); continue;
+         case kacosh: code += TString::Format("   if (%s < 1) %s = 0; else %s = TMath::ACosH(%s);\n", t.Data(), t.Data(), t.Data(), t.Data()); continue;
+         case kasinh: code += TString::Format("   %s = TMath::ASinH(%s);\n", t.Data(), t.Data()); continue;
+         case katanh: code += TString::Format("   if (TMath::Abs(%s) > 1) %s = 0; else %s = TMath::ATanH(%s);\n", t.Data(), t.Data(), t.Data(), t.Data()); continue;
+         case katan2: code += TString::Format("   %s = TMath::ATan2(%s,%s);\n", a.Data(), a.Data(), b.Data()); continue;
+
+         case kfmod: code += TString::Format("   %s = fmod(%s,%s);\n", a.Data(), a.Data(), b.Data()); continue;
+         case kpow:  code += TString::Format("   %s = TMath::Power(%s,%s);\n", a.Data(), a.Data(), b.Data()); continue;
+         case ksq:   code += TString::Format("   %s = %s*%s;\n", t.Data(), t.Data(), t.Data()); continue;
+         case ksqrt: code += TString::Format("   %s = TMath::Sqrt(TMath::Abs(%s));\n", t.Data(), t.Data()); continue;
+         case kmin:  code += TString::Format("   %s = std::min(%s,%s);\n", a.Data(), a.Data(), b.Data()); continue;
+         case kmax:  code += TString::Format("   %s = std::max(%s,%s);\n", a.Data(), a.Data(), b.Data()); continue;
+
+         case klog:   code += TString::Format("   if (%s > 0) %s = TMath::Log(%s); else %s = 0;\n", t.Data(), t.Data(), t.Data(), t.Data()); continue;
+         case kexp:   code += TString::Format("   if (%s < -700) %s = 0; else if (%s > 700) %s = TMath::Exp(700); else %s = TMath::Exp(%s);\n",
+                                              t.Data(), t.Data(), t.Data(), t.Data(), t.Data(), t.Data()); continue;
+         case klog10: code += TString::Format("   if (%s > 0) %s = TMath::Log10(%s); else %s = 0;\n", t.Data(), t.Data(), t.Data(), t.Data()); continue;
+
+         case kabs:     code += TString::Format("   %s = TMath::Abs(%s);\n", t.Data(), t.Data()); continue;
+         case ksign:    code += TString::Format("   %s = (%s < 0) ? -1 : 1;\n", t.Data(), t.Data()); continue;
+         case kint:     code += TString::Format("   %s = Double_t(Long64_t(%s));\n", t.Data(), t.Data()); continue;
+         case kSignInv: code += TString::Format("   %s = -1 * %s;\n", t.Data(), t.Data()); continue;
+
+         case kAnd:         code += TString::Format("   %s = (%s != 0 && %s != 0) ? 1 : 0;\n", a.Data(), a.Data(), b.Data()); continue;
+         case kOr:          code += TString::Format("   %s = (%s != 0 || %s != 0) ? 1 : 0;\n", a.Data(), a.Data(), b.Data()); continue;
+         case kEqual:       code += TString::Format("   %s = (%s == %s) ? 1 : 0;\n", a.Data(), a.Data(), b.Data()); continue;
+         case kNotEqual:    code += TString::Format("   %s = (%s != %s) ? 1 : 0;\n", a.Data(), a.Data(), b.Data()); continue;
+         case kLess:        code += TString::Format("   %s = (%s <  %s) ? 1 : 0;\n", a.Data(), a.Data(), b.Data()); continue;
+         case kGreater:     code += TString::Format("   %s = (%s >  %s) ? 1 : 0;\n", a.Data(), a.Data(), b.Data()); continue;
+         case kLessThan:    code += TString::Format("   %s = (%s <= %s) ? 1 : 0;\n", a.Data(), a.Data(), b.Data()); continue;
+         case kGreaterThan: code += TString::Format("   %s = (%s >= %s) ? 1 : 0;\n", a.Data(), a.Data(), b.Data()); continue;
+         case kNot:         code += TString::Format("   %s = (%s != 0) ? 0 : 1;\n", t.Data(), t.Data()); continue;
+
+         case kBitAnd:     code += TString::Format("   %s = ((ULong64_t)%s) & ((ULong64_t)%s);\n", a.Data(), a.Data(), b.Data()); continue;
+         case kBitOr:      code += TString::Format("   %s = ((ULong64_t)%s) | ((ULong64_t)%s);\n", a.Data(), a.Data(), b.Data()); continue;
+         case kLeftShift:  code += TString::Format("   %s = ((ULong64_t)%s) << ((ULong64_t)%s);\n", a.Data(), a.Data(), b.Data()); continue;
+         case kRightShift: code += TString::Format("   %s = ((ULong64_t)%s) >> ((ULong64_t)%s);\n", a.Data(), a.Data(), b.Data()); continue;
+
+         case kJump: {
+            const Int_t next = param + 1;
+            if (targetPos[next] != -1 && targetPos[next] != pos) return kFALSE;
+            targetPos[next] = pos;
+            code += TString::Format("   goto L%d;\n", next);
+            reachable = kFALSE;
+            continue;
+         }
+         case kJumpIf: {
+            // The condition is popped whether or not the jump is taken.
+            const Int_t next = param + 1;
+            --pos;
+            if (targetPos[next] != -1 && targetPos[next] != pos) return kFALSE;
+            targetPos[next] = pos;
+            code += TString::Format("   if (!%s) goto L%d;\n", t.Data(), next);
+            continue;
+         }
+         case kBoolOptimize: {
+            const Int_t op = param % 10;
+            if (op != 1 && op != 2) continue;
+            const Int_t next = i + param / 10 + 1;
+            if (targetPos[next] != -1 && targetPos[next] != pos) return kFALSE;
+            targetPos[next] = pos;
+            if (op == 1) code += TString::Format("   if (!%s) { %s = 0; goto L%d; }\n", t.Data(), t.Data(), next);
+            else         code += TString::Format("   if (%s) { %s = 1; goto L%d; }\n", t.Data(), t.Data(), next);
+            continue;
+         }
+      }
+
+      // The operations pushing a value.
+      const TString p = slot(pos);
+      switch (action) {
+         case kConstant: {
+            const Double_t value = fConst[param];
+            if (!TMath::Finite(value)) return kFALSE;
+            code += TString::Format("   %s = %.17g;\n", p.Data(), value);
+            break;
+         }
+         case kpi:   code += TString::Format("   %s = TMath::ACos(-1);\n", p.Data()); break;
+         case krndm: code += TString::Format("   %s = gRandom->Rndm(1);\n", p.Data()); break;
+         case kDefinedVariable: {
+            switch (fLookupType[param]) {
+               case kIndexOfEntry: case kIndexOfLocalEntry: case kEntries: case kLength:
+               case kIteration: case kDirect: case kDataMember: case kTreeMember: case kEntryList:
+                  break;
+               default:
+                  return kFALSE;
+            }
+            code += TString::Format("   %s = form->EvalJitVariable(%d, instance, willLoad, outOfRange);\n", p.Data(), param);
+            break;
+         }
+         default:
+            return kFALSE;
+      }
+      ++pos;
+      if (pos > maxpos) maxpos = pos;
+   }
+   if (maxpos > kMAXFOUND) return kFALSE;
+
+   body = "(TTreeFormula *form, Int_t instance, Bool_t willLoad, Bool_t &outOfRange)\n{\n   Double_t s0 = 0";
+   for (Int_t k = 1; k < maxpos; ++k) body += TString::Format(", s%d = 0", k);
+   body += ";\n";
+   body += code;
+   body += "   return s0;\n}\n";
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Compile, through the interpreter, a C++ function computing the value of
+/// the formula; EvalInstance (in double precision) then calls it instead of
+/// interpreting the operations of the formula for each instance.
+/// The functions are cached by their code, so that the formulas with the
+/// same expression share the same compiled function.
+///
+/// Return kFALSE, and keep the interpreted evaluation, if the formula uses
+/// an operation that can not be compiled (strings, function calls, aliases,
+/// graphical cuts, ...), or if the compilation failed.
+///
+/// TTree::Draw and TTree::Scan compile their formulas when IsJitEnabled()
+/// is true, see SetJitEnabled.
+
+Bool_t TTreeFormula::JitCompile()
+{
+   if (fJitKernel) return kTRUE;
+   if (TestBit(kMissingLeaf) || !gInterpreter) return kFALSE;
+
+   TString body;
+   Bool_t shortCircuit = kFALSE;
+   if (!GenerateJitKernel(body, shortCircuit)) return kFALSE;
+
+   R__LOCKGUARD2(gROOTMutex);
+   std::unordered_map<std::string, void*> &kernels = JitKernels();
+   auto known = kernels.find(body.Data());
+   void *kernel = 0;
+   if (known != kernels.end()) {
+      kernel = known->second;
+   } else {
+      TString name = TString::Format("R__TTreeFormulaJit_%lu", (unsigned long)kernels.size());
+      TString declaration = "#include \"TTreeFormula.h\"\n#include \"TMath.h\"\n#include \"TRandom.h\"\n"
+                            "#include <math.h>\n#include <algorithm>\nDouble_t " + name + body;
+      if (gInterpreter->Declare(declaration)) {
+         kernel = (void*)gInterpreter->Calc(TString::Format("(long)&%s", name.Data()));
+      }
+      // Also remember the failures, not to try again.
+      kernels[body.Data()] = kernel;
+   }
+   fJitKernel = kernel;
+   fJitShortCircuit = shortCircuit;
+   return fJitKernel != 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if TTree::Draw and TTree::Scan compile their formulas (see
+/// JitCompile). The default is given by the resource TTreeFormula.JitCompile
+/// (0 by default).
+
+Bool_t TTreeFormula::IsJitEnabled()
+{
+   return JitEnabled() != 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Request (or not) TTree::Draw and TTree::Scan to compile their formulas,
+/// see JitCompile.
+
+void TTreeFormula::SetJitEnabled(Bool_t enable)
+{
+   JitEnabled() = enable;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return DataMember corresponding to code.
 ///
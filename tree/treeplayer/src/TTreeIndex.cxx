@@ -11,6 +11,14 @@
 
 /** \class TTreeIndex
 A Tree Index with majorname and minorname.
+
+The sorted values are also kept, with their position, in a lookup table
+in Eytzinger order: the children of the node k are the nodes 2k and 2k+1,
+so that the first levels of the search share a few cache lines and the
+nodes of the next levels can be prefetched while descending. Lookups of
+increasing values, like the ones done when joining two trees sorted by
+the same index, are resolved by looking first right after the previous
+value found.
 */
 
 #include "TTreeIndex.h"
@@ -39,6 +47,68 @@ struct IndexSortComparator {
   Long64_t *fValMajor, *fValMinor;
 };
 
+namespace {
+
+// Number of positions looked at after the previous value found, before
+// searching the lookup table.
+const Long64_t kSequentialWindow = 8;
+
+// Number of lookups descending the lookup table together.
+const Int_t kBatchSize = 8;
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if the pair amajor|aminor is lower than bmajor|bminor.
+
+inline Bool_t KeyLess(Long64_t amajor, Long64_t aminor, Long64_t bmajor, Long64_t bminor)
+{
+   return amajor < bmajor || (amajor == bmajor && aminor < bminor);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill the subtree of the node k of the Eytzinger table nodes with the
+/// sorted values from position pos on (in order traversal).
+
+template <typename Node>
+void FillEytzinger(Node *nodes, Long64_t n, Long64_t k, const Long64_t *major, const Long64_t *minor, Long64_t &pos)
+{
+   if (k > n) return;
+   FillEytzinger(nodes, n, 2 * k, major, minor, pos);
+   nodes[k].fMajor = major[pos];
+   nodes[k].fMinor = minor[pos];
+   nodes[k].fPos = pos;
+   ++pos;
+   FillEytzinger(nodes, n, 2 * k + 1, major, minor, pos);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the node of the lower bound from the node k past the leaves
+/// where the search ended: the last node where the search turned left,
+/// or 0 if it never did.
+
+inline Long64_t LowerBoundNode(Long64_t k)
+{
+#if defined(__GNUC__) || defined(__clang__)
+   return k >> (__builtin_ctzll(~(ULong64_t)k) + 1);
+#else
+   while (k & 1) k >>= 1;
+   return k >> 1;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Hint the processor that p will be read soon.
+
+inline void Prefetch(const void *p)
+{
+#if defined(__GNUC__) || defined(__clang__)
+   __builtin_prefetch(p);
+#else
+   (void)p;
+#endif
+}
+
+} // unnamed namespace
+
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Default constructor for TTreeIndex
@@ -54,6 +124,7 @@ TTreeIndex::TTreeIndex(): TVirtualIndex()
    fMinorFormula       = 0;
    fMajorFormulaParent = 0;
    fMinorFormulaParent = 0;
+   fLookup             = 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -132,6 +203,7 @@ TTreeIndex::TTreeIndex(const TTree *T, const char *majorname, const char *minorn
    fMinorFormula       = 0;
    fMajorFormulaParent = 0;
    fMinorFormulaParent = 0;
+   fLookup             = 0;
    fMajorName          = majorname;
    fMinorName          = minorname;
    if (!T) return;
@@ -191,6 +263,7 @@ TTreeIndex::TTreeIndex(const TTree *T, const char *majorname, const char *minorn
    delete [] tmp_major;
    delete [] tmp_minor;
    fTree->LoadTree(oldEntry);
+   BuildLookup();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -202,6 +275,7 @@ TTreeIndex::~TTreeIndex()
    delete [] fIndexValues;      fIndexValues = 0;
    delete [] fIndexValuesMinor;      fIndexValuesMinor = 0;
    delete [] fIndex;            fIndex = 0;
+   delete [] fLookup;           fLookup = 0;
    delete fMajorFormula;        fMajorFormula  = 0;
    delete fMinorFormula;        fMinorFormula  = 0;
    delete fMajorFormulaParent;  fMajorFormulaParent = 0;
@@ -285,9 +359,27 @@ void TTreeIndex::Append(const TVirtualIndex *add, Bool_t delaySort )
       delete [] addValues2;
       delete [] ind;
       delete [] conv;
+      BuildLookup();
+   } else {
+      // The values are not sorted anymore.
+      delete [] fLookup;
+      fLookup = 0;
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Build the lookup table from the sorted values.
+
+void TTreeIndex::BuildLookup()
+{
+   delete [] fLookup;
+   fLookup = 0;
+   if (fN <= 0 || !fIndexValues || !fIndexValuesMinor) return;
+   fLookup = new TLookupNode[fN + 1];
+   Long64_t pos = 0;
+   FillEytzinger(fLookup, fN, 1, fIndexValues, fIndexValuesMinor, pos);
+}
+
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -346,13 +438,51 @@ Long64_t TTreeIndex::GetEntryNumberFriend(const TTree *parent)
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the position of the lower bound of major|minor in the lookup
+/// table (fN if all the values are lower).
+
+Long64_t TTreeIndex::FindInLookup(Long64_t major, Long64_t minor) const
+{
+   Long64_t k = 1;
+   while (k <= fN) {
+      // The 16 nodes four levels below are contiguous.
+      Prefetch(fLookup + TMath::Min(16 * k, fN));
+      const TLookupNode &node = fLookup[k];
+      k = 2 * k + KeyLess(node.fMajor, node.fMinor, major, minor);
+   }
+   k = LowerBoundNode(k);
+   return k ? fLookup[k].fPos : fN;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// find position where major|minor values are in the IndexValues tables
 /// this is the index in IndexValues table, not entry# !
 /// use lower_bound STD algorithm.
+/// If last is not 0, it is the position of the previous value found (0 to
+/// start with): when the values looked up are increasing, the position is
+/// searched first right after it, and last is set to the position found.
+/// The cursor belongs to the caller so that concurrent lookups in the same
+/// index do not interfere.
 
-Long64_t TTreeIndex::FindValues(Long64_t major, Long64_t minor) const
+Long64_t TTreeIndex::FindValues(Long64_t major, Long64_t minor, Long64_t *last) const
 {
+   if (last && *last < fN && !KeyLess(major, minor, fIndexValues[*last], fIndexValuesMinor[*last])) {
+      Long64_t end = TMath::Min(fN, *last + kSequentialWindow);
+      for (Long64_t pos = *last; pos < end; ++pos) {
+         if (!KeyLess(fIndexValues[pos], fIndexValuesMinor[pos], major, minor)) {
+            *last = pos;
+            return pos;
+         }
+      }
+      if (end == fN) return fN;
+   }
+   if (fLookup) {
+      Long64_t pos = FindInLookup(major, minor);
+      if (last && pos < fN) *last = pos;
+      return pos;
+   }
+
    Long64_t mid, step, pos = 0, count = fN;
    // find lower bound using bisection
    while( count > 0 ) {
@@ -422,6 +552,62 @@ Long64_t TTreeIndex::GetEntryNumberWithIndex(Long64_t major, Long64_t minor) con
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Set entries[i] to GetEntryNumberWithIndex(major[i], minor[i]) for the n
+/// pairs (the minor values are all 0 if minor is 0).
+/// Sorted pairs, like the ones of a tree sorted by the same index, are
+/// looked up in one pass over the sorted values; otherwise the lookups are
+/// made kBatchSize at a time, descending the lookup table together so that
+/// their memory accesses overlap.
+
+void TTreeIndex::GetEntryNumbersWithIndex(Long64_t n, const Long64_t *major, const Long64_t *minor, Long64_t *entries) const
+{
+   Bool_t sorted = kTRUE;
+   for (Long64_t i = 1; i < n && sorted; ++i) {
+      sorted = !KeyLess(major[i], minor ? minor[i] : 0, major[i - 1], minor ? minor[i - 1] : 0);
+   }
+   if (!fLookup) {
+      TVirtualIndex::GetEntryNumbersWithIndex(n, major, minor, entries);
+      return;
+   }
+   if (sorted) {
+      Long64_t last = 0;
+      for (Long64_t i = 0; i < n; ++i) {
+         Long64_t min = minor ? minor[i] : 0;
+         Long64_t pos = FindValues(major[i], min, &last);
+         Bool_t found = pos < fN && fIndexValues[pos] == major[i] && fIndexValuesMinor[pos] == min;
+         entries[i] = found ? fIndex[pos] : -1;
+      }
+      return;
+   }
+
+   Long64_t k[kBatchSize];
+   for (Long64_t first = 0; first < n; first += kBatchSize) {
+      Int_t m = (Int_t)TMath::Min((Long64_t)kBatchSize, n - first);
+      const Long64_t *bmajor = major + first;
+      const Long64_t *bminor = minor ? minor + first : 0;
+      for (Int_t j = 0; j < m; ++j) k[j] = 1;
+      Bool_t more = kTRUE;
+      while (more) {
+         more = kFALSE;
+         for (Int_t j = 0; j < m; ++j) {
+            if (k[j] > fN) continue;
+            Prefetch(fLookup + TMath::Min(16 * k[j], fN));
+            const TLookupNode &node = fLookup[k[j]];
+            k[j] = 2 * k[j] + KeyLess(node.fMajor, node.fMinor, bmajor[j], bminor ? bminor[j] : 0);
+            more = kTRUE;
+         }
+      }
+      for (Int_t j = 0; j < m; ++j) {
+         Long64_t node = LowerBoundNode(k[j]);
+         Long64_t pos = node ? fLookup[node].fPos : fN;
+         Bool_t found = pos < fN && fIndexValues[pos] == bmajor[j]
+                        && fIndexValuesMinor[pos] == (bminor ? bminor[j] : 0);
+         entries[first + j] = found ? fIndex[pos] : -1;
+      }
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 Long64_t* TTreeIndex::GetIndexValuesMinor()  const
@@ -561,6 +747,7 @@ void TTreeIndex::Streamer(TBuffer &R__b)
       fIndex      = new Long64_t[fN];
       R__b.ReadFastArray(fIndex,fN);
       R__b.CheckByteCount(R__s, R__c, TTreeIndex::IsA());
+      BuildLookup();
    } else {
       R__c = R__b.WriteVersion(TTreeIndex::IsA(), kTRUE);
       TVirtualIndex::Streamer(R__b);
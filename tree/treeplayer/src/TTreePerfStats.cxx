@@ -62,11 +62,26 @@ The Draw or Print functions print the following information:
  -  CPU  Time = CPU Time in seconds
  -  Disk Time = Real Time spent in pure raw disk IO
  -  Disk IO   = Raw disk IO speed in MBytes/second
+ -  ReadQueue = Average and largest number of requests in flight during the
+                vectored reads of a local file executed in parallel (only shown
+                if TFile::SetReadQueueDepth enabled them)
+ -  ReadQueBW = Bandwidth achieved by these vectored reads in MBytes/second
  -  ReadUZRT  = Unzipped MBytes per RT second
  -  ReadUZCP  = Unipped MBytes per CP second
  -  ReadRT    = Zipped MBytes per RT second
  -  ReadCP    = Zipped MBytes per CP second
 
+With the option "unzip" the time spent uncompressing the data is also shown
+(UnzipTime) and, when the baskets are unzipped in parallel by TTreeCacheUnzip,
+the number of clusters unzipped in parallel (UnzipClus) and their mean and
+maximum unzip latency (UnzipLat), i.e. the real time between the start of
+the unzipping of a cluster and the availability of its last basket.
+
+When baskets are skipped because their statistics show that no entry can
+pass the selection (see TBranch::SetBasketStats and TBasketStatsCut), the
+number of zipped bytes not read, of baskets and of entries skipped are
+shown as well (Skipped).
+
  ### NOTE 1 :
 The ReadTotal value indicates the effective number of zipped bytes
 returned to the application. The physical number of bytes read
@@ -122,6 +137,17 @@ TTreePerfStats::TTreePerfStats() : TVirtualPerfStats()
    fCpuTime       = 0;
    fDiskTime      = 0;
    fUnzipTime     = 0;
+   fUnzipClusters = 0;
+   fUnzipLatency  = 0;
+   fUnzipLatencyMax = 0;
+   fReadVectors   = 0;
+   fReadVectorBytes = 0;
+   fReadVectorTime = 0;
+   fReadQueueTime = 0;
+   fReadQueueDepthMax = 0;
+   fBasketsSkipped = 0;
+   fBytesSkipped  = 0;
+   fEntriesSkipped = 0;
    fCompress      = 0;
    fRealTimeAxis  = 0;
    fHostInfoText  = 0;
@@ -158,6 +184,17 @@ TTreePerfStats::TTreePerfStats(const char *name, TTree *T) : TVirtualPerfStats()
    fCpuTime       = 0;
    fDiskTime      = 0;
    fUnzipTime     = 0;
+   fUnzipClusters = 0;
+   fUnzipLatency  = 0;
+   fUnzipLatencyMax = 0;
+   fReadVectors   = 0;
+   fReadVectorBytes = 0;
+   fReadVectorTime = 0;
+   fReadQueueTime = 0;
+   fReadQueueDepthMax = 0;
+   fBasketsSkipped = 0;
+   fBytesSkipped  = 0;
+   fEntriesSkipped = 0;
    fRealTimeAxis  = 0;
    fCompress      = (T->GetTotBytes()+0.00001)/T->GetZipBytes();
 
@@ -295,6 +332,27 @@ void TTreePerfStats::FileReadEvent(TFile *file, Int_t len, Double_t start)
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Record a vectored read of a local file executed with parallel requests
+/// by TFile::ReadBuffers (see TFile::SetReadQueueDepth).
+/// -  nrequests is the number of requests the read was split in
+/// -  len is the number of bytes read
+/// -  realtime is the real time spent in the read
+/// -  queuetime is the sum of the durations of the requests; divided by
+///    realtime it gives the average number of requests in flight
+/// -  maxdepth is the largest number of requests in flight
+
+void TTreePerfStats::FileReadVectorEvent(TFile *file, Int_t /* nrequests */, Long64_t len, Double_t realtime, Double_t queuetime, Int_t maxdepth)
+{
+   if (file == this->fFile){
+      fReadVectors++;
+      fReadVectorBytes += len;
+      fReadVectorTime += realtime;
+      fReadQueueTime += queuetime;
+      if (maxdepth > fReadQueueDepthMax) fReadQueueDepthMax = maxdepth;
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Record TTree unzip event.
 /// -  start is the TimeStamp before unzip
@@ -311,6 +369,40 @@ void TTreePerfStats::UnzipEvent(TObject * tree, Long64_t /* pos */, Double_t sta
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Record the parallel unzipping of a cluster by TTreeCacheUnzip.
+/// -  entry is the first entry of the cluster
+/// -  nbaskets is the number of baskets in the cluster
+/// -  latency is the real time between the start of the unzipping and
+///    the availability of the last basket of the cluster
+/// -  unziptime is the time spent unzipping the baskets, summed over the threads
+
+void TTreePerfStats::UnzipClusterEvent(TObject *tree, Long64_t /* entry */, Int_t /* nbaskets */, Double_t latency, Double_t unziptime)
+{
+   if (tree == this->fTree){
+      fUnzipTime += unziptime;
+      fUnzipClusters++;
+      fUnzipLatency += latency;
+      if (latency > fUnzipLatencyMax) fUnzipLatencyMax = latency;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Record the skipping of entries whose baskets cannot pass a selection.
+/// -  entry is the first entry skipped
+/// -  nentries is the number of entries skipped
+/// -  nbaskets is the number of baskets not read
+/// -  bytes is the number of zipped bytes of these baskets
+
+void TTreePerfStats::BasketSkipEvent(TObject *tree, Long64_t /* entry */, Long64_t nentries, Int_t nbaskets, Long64_t bytes)
+{
+   if (tree == this->fTree){
+      fBasketsSkipped += nbaskets;
+      fBytesSkipped += bytes;
+      fEntriesSkipped += nentries;
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// When the run is finished this function must be called
 /// to save the current parameters in the file and Tree in this object
@@ -406,6 +498,9 @@ void TTreePerfStats::Paint(Option_t *option)
          fPave->AddText(Form("UnzipTime = %7.3f s",fUnzipTime));
       }
       fPave->AddText(Form("Disk IO   = %7.3f MB/s",1e-6*fBytesRead/fDiskTime));
+      if (fBasketsSkipped) {
+         fPave->AddText(Form("Skipped   = %g MB",1e-6*fBytesSkipped));
+      }
       fPave->AddText(Form("ReadUZRT  = %7.3f MB/s",1e-6*fCompress*fBytesRead/fRealTime));
       fPave->AddText(Form("ReadUZCP  = %7.3f MB/s",1e-6*fCompress*fBytesRead/fCpuTime));
       fPave->AddText(Form("ReadRT    = %7.3f MB/s",1e-6*fBytesRead/fRealTime));
@@ -447,8 +542,19 @@ void TTreePerfStats::Print(Option_t * option) const
    if (unzip) {
       printf("Strm Time = %7.3f seconds\n",fCpuTime-fUnzipTime);
       printf("UnzipTime = %7.3f seconds\n",fUnzipTime);
+      if (fUnzipClusters) {
+         printf("UnzipClus = %d clusters unzipped in parallel\n",fUnzipClusters);
+         printf("UnzipLat  = %7.3f ms per cluster (max %7.3f ms)\n",1e3*fUnzipLatency/fUnzipClusters,1e3*fUnzipLatencyMax);
+      }
    }
    printf("Disk IO   = %7.3f MBytes/s\n",1e-6*fBytesRead/fDiskTime);
+   if (fBasketsSkipped) {
+      printf("Skipped   = %g MBytes in %d baskets, %lld entries\n",1e-6*fBytesSkipped,fBasketsSkipped,fEntriesSkipped);
+   }
+   if (fReadVectors) {
+      printf("ReadQueue = %7.3f requests in flight on average (max %d) in %d vectored reads\n",GetReadQueueDepth(),fReadQueueDepthMax,fReadVectors);
+      printf("ReadQueBW = %7.3f MBytes/s\n",1e-6*fReadVectorBytes/fReadVectorTime);
+   }
    printf("ReadUZRT  = %7.3f MBytes/s\n",1e-6*fCompress*fBytesRead/fRealTime);
    printf("ReadUZCP  = %7.3f MBytes/s\n",1e-6*fCompress*fBytesRead/fCpuTime);
    printf("ReadRT    = %7.3f MBytes/s\n",1e-6*fBytesRead/fRealTime);
@@ -495,6 +601,17 @@ void TTreePerfStats::SavePrimitive(std::ostream &out, Option_t *option /*= ""*/)
    out<<"   ps->SetCpuTime("<<fCpuTime<<");"<<std::endl;
    out<<"   ps->SetDiskTime("<<fDiskTime<<");"<<std::endl;
    out<<"   ps->SetUnzipTime("<<fUnzipTime<<");"<<std::endl;
+   out<<"   ps->SetUnzipClusters("<<fUnzipClusters<<");"<<std::endl;
+   out<<"   ps->SetUnzipLatency("<<fUnzipLatency<<");"<<std::endl;
+   out<<"   ps->SetUnzipLatencyMax("<<fUnzipLatencyMax<<");"<<std::endl;
+   out<<"   ps->SetReadVectors("<<fReadVectors<<");"<<std::endl;
+   out<<"   ps->SetReadVectorBytes("<<fReadVectorBytes<<");"<<std::endl;
+   out<<"   ps->SetReadVectorTime("<<fReadVectorTime<<");"<<std::endl;
+   out<<"   ps->SetReadQueueTime("<<fReadQueueTime<<");"<<std::endl;
+   out<<"   ps->SetReadQueueDepthMax("<<fReadQueueDepthMax<<");"<<std::endl;
+   out<<"   ps->SetBasketsSkipped("<<fBasketsSkipped<<");"<<std::endl;
+   out<<"   ps->SetBytesSkipped("<<fBytesSkipped<<");"<<std::endl;
+   out<<"   ps->SetEntriesSkipped("<<fEntriesSkipped<<");"<<std::endl;
    out<<"   ps->SetCompress("<<fCompress<<");"<<std::endl;
 
    Int_t i, npoints = fGraphIO->GetN();
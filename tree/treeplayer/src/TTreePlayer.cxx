@@ -2546,6 +2546,7 @@ Long64_t TTreePlayer::Scan(const char *varexp, const char *selection,
       select = new TTreeFormula("Selection",selection,fTree);
       if (!select) return -1;
       if (!select->GetNdim()) { delete select; return -1; }
+      if (TTreeFormula::IsJitEnabled()) select->JitCompile();
       fFormulaList->Add(select);
    }
 //*-*- if varexp is empty, take first 8 columns by default
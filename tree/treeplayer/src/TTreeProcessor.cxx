@@ -0,0 +1,228 @@
+// @(#)root/treeplayer:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2015, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+/** \class TTreeProcessor
+
+Process the entries of a tree, of a chain or of a list of files in
+parallel, using the threads of the default TTaskPool.
+
+Each file is split in ranges of entries starting and ending on
+cluster boundaries (see TTree::GetClusterIterator), so that the
+baskets read by one range are never needed by another one. Each range
+is processed by a task calling the user function with a TTreeReader
+restricted to the range (see TTreeReader::SetEntriesRange). The
+reader works on a TFile and a TTree opened by, and private to, the
+thread executing the task; they are reused for all the ranges of the
+same file that the thread processes. Hence all the threads share the
+memory of the process, but no I/O object is shared between threads.
+
+~~~{.cpp}
+   TTreeProcessor proc("events", filenames);
+   TH1F model("pt", "pt", 100, 0., 100.);
+   TH1F *pt = proc.Process([](TTreeReader &reader, TH1F &h) {
+      TTreeReaderValue<float> ptval(reader, "pt");
+      while (reader.Next()) h.Fill(*ptval);
+   }, model);
+~~~
+
+The function is called concurrently by several threads: besides the
+reader it is given, it must only use objects private to the calling
+thread. The second form of Process provides to each thread its own
+clone of a model object (for example a histogram) and merges them, with
+their Merge method, once all the entries are processed.
+The entry numbers seen through the reader are local to each file.
+
+The number of threads is the size of the default TTaskPool, see
+TTaskPool::SetDefaultSize.
+*/
+
+#include "TTreeProcessor.h"
+#include "TChain.h"
+#include "TChainElement.h"
+#include "TClass.h"
+#include "TFile.h"
+#include "TROOT.h"
+#include "TTaskPool.h"
+
+////////////////////////////////////////////////////////////////////////////////
+/// Process the tree treename in each of the files.
+
+TTreeProcessor::TTreeProcessor(const char *treename, const std::vector<std::string> &filenames)
+   : fTreeNames(filenames.size(), treename), fFileNames(filenames)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Process the tree treename of the file filename.
+
+TTreeProcessor::TTreeProcessor(const char *treename, const char *filename)
+   : fTreeNames(1, treename), fFileNames(1, filename)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Process the trees of the files of the chain or, if tree is not a
+/// TChain, the tree read from the file it belongs to.
+/// The tree itself is not used: each thread opens its own copy.
+
+TTreeProcessor::TTreeProcessor(TTree &tree)
+{
+   if (tree.InheritsFrom(TChain::Class())) {
+      TIter next(((TChain&)tree).GetListOfFiles());
+      while (TChainElement *element = (TChainElement*)next()) {
+         fTreeNames.push_back(element->GetName());
+         fFileNames.push_back(element->GetTitle());
+      }
+   } else if (TFile *file = tree.GetCurrentFile()) {
+      TDirectory *dir = tree.GetDirectory();
+      std::string name = tree.GetName();
+      if (dir && dir != file) {
+         // GetPath is "file.root:/dir/sub", keep the path inside the file.
+         std::string path = dir->GetPath();
+         std::string::size_type pos = path.find(":/");
+         if (pos != std::string::npos && pos + 2 < path.size())
+            name = path.substr(pos + 2) + "/" + name;
+      }
+      fTreeNames.push_back(name);
+      fFileNames.push_back(file->GetName());
+   } else {
+      ::Error("TTreeProcessor::TTreeProcessor", "The tree %s is not in a file, it can not be processed in parallel",
+              tree.GetName());
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Destructor.
+
+TTreeProcessor::~TTreeProcessor()
+{
+   ReleaseTrees();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Set obj to a clone of model, not attached to any directory.
+
+void TTreeProcessor::CloneObject(TObject *&obj, const TObject &model)
+{
+   obj = model.Clone();
+   ROOT::DirAutoAdd_t func = obj->IsA()->GetDirectoryAutoAdd();
+   if (func) func(obj, 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the tree of file ifile private to the calling thread, opening
+/// the file if the thread was working on another one.
+
+TTree *TTreeProcessor::GetTree(UInt_t ifile)
+{
+   TTreeView *view = 0;
+   {
+      std::lock_guard<std::mutex> lock(fMutex);
+      TTreeView *&slot = fViews[std::this_thread::get_id()];
+      if (!slot) slot = new TTreeView;
+      view = slot;
+   }
+   if (view->fFile && view->fFileName == fFileNames[ifile]) {
+      return view->fTree;
+   }
+
+   delete view->fFile;
+   view->fTree = 0;
+   view->fFileName = fFileNames[ifile];
+   view->fFile = TFile::Open(view->fFileName.c_str());
+   if (!view->fFile || view->fFile->IsZombie()) {
+      ::Error("TTreeProcessor::GetTree", "Can not open the file %s", view->fFileName.c_str());
+      delete view->fFile;
+      view->fFile = 0;
+      return 0;
+   }
+   view->fFile->GetObject(fTreeNames[ifile].c_str(), view->fTree);
+   if (!view->fTree) {
+      ::Error("TTreeProcessor::GetTree", "There is no tree %s in the file %s",
+              fTreeNames[ifile].c_str(), view->fFileName.c_str());
+   }
+   return view->fTree;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Call func on all the entries, in parallel. See the class description.
+
+void TTreeProcessor::Process(const ProcessFunc_t &func)
+{
+   // Make gDirectory and gFile thread local and protect the ROOT globals.
+   ROOT::EnableThreadSafety();
+
+   TTaskGroup group;
+   for (UInt_t i = 0; i < fFileNames.size(); ++i) {
+      group.Run([this, i, &func, &group]() { ProcessFile(i, func, group); });
+   }
+   group.Wait();
+   ReleaseTrees();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Split file ifile in ranges of clusters and submit one task per range.
+
+void TTreeProcessor::ProcessFile(UInt_t ifile, const ProcessFunc_t &func, TTaskGroup &group)
+{
+   TTree *tree = GetTree(ifile);
+   if (!tree) return;
+
+   // Aim at a few ranges per worker for each file, so that the load is
+   // balanced without paying for the setup of a reader too often.
+   Long64_t nentries = tree->GetEntries();
+   Long64_t minsize = nentries / (4 * TTaskPool::GetDefault().GetPoolSize()) + 1;
+
+   TTree::TClusterIterator clusters = tree->GetClusterIterator(0);
+   Long64_t first = clusters();
+   while (first < nentries) {
+      Long64_t last = clusters.GetNextEntry();
+      while (last - first < minsize && last < nentries && last > first) {
+         clusters();
+         Long64_t next = clusters.GetNextEntry();
+         if (next <= last) break;
+         last = next;
+      }
+      // Protect against a degenerate (empty) cluster estimate.
+      if (last > nentries || last <= first) last = nentries;
+      group.Run([this, ifile, first, last, &func]() { ProcessRange(ifile, first, last, func); });
+      if (last == nentries) break;
+      // Move the iterator to the cluster starting at last.
+      clusters();
+      first = last;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Call func on a reader restricted to the entries [first, last) of file ifile.
+
+void TTreeProcessor::ProcessRange(UInt_t ifile, Long64_t first, Long64_t last, const ProcessFunc_t &func)
+{
+   TTree *tree = GetTree(ifile);
+   if (!tree) return;
+
+   tree->SetCacheEntryRange(first, last);
+   TTreeReader reader(tree);
+   reader.SetEntriesRange(first, last);
+   func(reader);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Close the files opened by the threads.
+
+void TTreeProcessor::ReleaseTrees()
+{
+   std::lock_guard<std::mutex> lock(fMutex);
+   for (std::map<std::thread::id, TTreeView*>::iterator i = fViews.begin(); i != fViews.end(); ++i) {
+      delete i->second->fFile;
+      delete i->second;
+   }
+   fViews.clear();
+}
@@ -11,6 +11,7 @@
 
 #include "TTreeReader.h"
 
+#include "TBasketStatsCut.h"
 #include "TChain.h"
 #include "TDirectory.h"
 #include "TTreeReaderValue.h"
@@ -199,7 +200,10 @@ TTreeReader::TTreeReader(TTree* tree):
    fTree(tree),
    fDirectory(0),
    fEntryStatus(kEntryNotLoaded),
-   fDirector(0)
+   fDirector(0),
+   fBeginEntry(0),
+   fEndEntry(-1),
+   fBasketCut(0)
 {
    Initialize();
 }
@@ -213,7 +217,10 @@ TTreeReader::TTreeReader(const char* keyname, TDirectory* dir /*= NULL*/):
    fTree(0),
    fDirectory(dir),
    fEntryStatus(kEntryNotLoaded),
-   fDirector(0)
+   fDirector(0),
+   fBeginEntry(0),
+   fEndEntry(-1),
+   fBasketCut(0)
 {
    if (!fDirectory) fDirectory = gDirectory;
    fDirectory->GetObject(keyname, fTree);
@@ -230,6 +237,7 @@ TTreeReader::~TTreeReader()
       (*i)->MarkTreeReaderUnavailable();
    }
    delete fDirector;
+   delete fBasketCut;
    fProxies.SetOwner();
 }
 
@@ -269,6 +277,11 @@ TTreeReader::EEntryStatus TTreeReader::SetEntryBase(Long64_t entry, Bool_t local
       return fEntryStatus;
    }
 
+   if (!local && fEndEntry >= 0 && entry >= fEndEntry) {
+      fEntryStatus = kEntryNotFound;
+      return fEntryStatus;
+   }
+
    TTree* prevTree = fDirector->GetTree();
 
    Long64_t loadResult;
@@ -307,6 +320,63 @@ TTreeReader::EEntryStatus TTreeReader::SetEntryBase(Long64_t entry, Bool_t local
    return fEntryStatus;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the first entry from entry on that may pass the cut set by
+/// SetBasketCut. For chains, entry is the global entry number.
+
+Long64_t TTreeReader::SkipEntries(Long64_t entry)
+{
+   if (!fTree) return entry;
+   Int_t treeNumInChain = fTree->GetTreeNumber();
+   while (fEndEntry < 0 || entry < fEndEntry) {
+      Long64_t local = fTree->LoadTree(entry);
+      if (local < 0) break;
+      TTree *tree = fTree->GetTree();
+      Long64_t next = fBasketCut->GetNextEntry(tree, local);
+      entry += next - local;
+      if (next < tree->GetEntries()) break;
+   }
+   if (treeNumInChain != fTree->GetTreeNumber()) {
+      fDirector->SetTree(fTree->GetTree());
+   }
+   return entry;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Restrict the reading to the entries [beginEntry, endEntry): Next() and
+/// begin() start at beginEntry and the entries from endEntry on can not be
+/// loaded. An endEntry of -1 means up to the end of the tree (or chain).
+/// This is used by TTreeProcessor to hand a range of clusters to each task.
+
+void TTreeReader::SetEntriesRange(Long64_t beginEntry, Long64_t endEntry)
+{
+   fBeginEntry = beginEntry < 0 ? 0 : beginEntry;
+   fEndEntry = endEntry;
+   if (fTree) fEntryStatus = kEntryNotLoaded;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Let Next() skip the entries that cannot pass cut without reading them,
+/// using the statistics of the baskets of the branches it refers to (see
+/// TBranch::SetBasketStats and TBasketStatsCut). Only the terms of the form
+/// `name op number` of the top level conjunction of cut are used, e.g.
+/// "pt > 50 && nhits >= 4"; for an array, an entry may pass if any of its
+/// values passes. The entries returned by Next() must still be checked
+/// against the cut. An empty cut removes the skipping.
+
+void TTreeReader::SetBasketCut(const char *cut)
+{
+   delete fBasketCut;
+   fBasketCut = 0;
+   if (!cut || !cut[0]) return;
+   fBasketCut = new TBasketStatsCut(cut);
+   if (fBasketCut->IsEmpty()) {
+      Warning("SetBasketCut", "no range cut can be used in '%s'", cut);
+      delete fBasketCut;
+      fBasketCut = 0;
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Set (or update) the which tree to reader from. tree can be
 /// a TTree or a TChain.